@@ -16,6 +16,8 @@
 
 // solver
 #include "shared/SolverFactory.h"
+#include "shared/Ensemble.h"
+#include "shared/KernelTuner.h"
 
 #ifdef USE_MPI
 #include "utils/mpiUtils/GlobalMpiSession.h"
@@ -136,6 +138,33 @@ int main(int argc, char *argv[])
   HydroParams params = HydroParams();
   params.setup(configMap);
 
+  // kernel launch autotuning (option --retune ignores cached winners)
+  bool retune = false;
+  for (int iarg = 2; iarg < argc; ++iarg)
+    if (std::string(argv[iarg]) == "--retune")
+      retune = true;
+  KernelTuner::instance().init(configMap, params, retune);
+
+  // ensemble mode: many small simulations batched in this process
+  if (Ensemble::enabled(configMap))
+  {
+    {
+      Ensemble ensemble(configMap);
+
+      if (rank==0) std::cout << "Start ensemble computation ("
+                             << ensemble.nb_members() << " members)....\n";
+
+      ensemble.run();
+
+      ensemble.print_monitoring_info();
+      KernelTuner::instance().report();
+    }
+
+    Kokkos::finalize();
+
+    return EXIT_SUCCESS;
+  }
+
   // retrieve solver name from settings
   const std::string solver_name = configMap.getString("run", "solver_name", "Unknown");
 
@@ -179,6 +208,8 @@ int main(int argc, char *argv[])
 
   print_solver_monitoring_info(solver);
 
+  KernelTuner::instance().report();
+
   delete solver;
 
   Kokkos::finalize();
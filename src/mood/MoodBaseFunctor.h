@@ -4,7 +4,7 @@
 #include <type_traits>
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 
 #include "mood/Polynomial.h"
@@ -27,13 +27,13 @@ public:
   //! Decide at compile-time which data array to use
   using DataArray  = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
   
-  MoodBaseFunctor(HydroParams params,
+  MoodBaseFunctor(KernelParams params,
 		  typename MonomialMap<dim,degree>::MonomMap monomMap) :
     PolynomialEvaluator<dim,degree>(monomMap),
     params(params) {};
   virtual ~MoodBaseFunctor() {};
 
-  HydroParams params;
+  KernelParams params;
   const int nbvar = params.nbvar;
 
   /**
@@ -7,7 +7,7 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 
 #include "mood/mood_shared.h"
@@ -31,7 +31,7 @@ namespace mood {
 //   /**
 //    * Constructor for 2D/3D.
 //    */
-//   ComputeDtFunctor(HydroParams params,
+//   ComputeDtFunctor(KernelParams params,
 // 		   DataArray Udata) :
 //     MoodBaseFunctor<dim,degree>(params),
 //     Udata(Udata)
@@ -172,7 +172,7 @@ public:
   /**
    * Constructor for 2D
    */
-  ComputeDtFunctor2d(HydroParams params,
+  ComputeDtFunctor2d(KernelParams params,
 		     MonomMap    monomMap,
 		     DataArray   Udata) :
     MoodBaseFunctor<2,degree>(params,monomMap),
@@ -265,7 +265,7 @@ public:
   /**
    * Constructor for 3D.
    */
-  ComputeDtFunctor3d(HydroParams params,
+  ComputeDtFunctor3d(KernelParams params,
 		     MonomMap    monomMap,
 		     DataArray   Udata) :
     MoodBaseFunctor<3,degree>(params,monomMap),
@@ -2,7 +2,7 @@
 #define MOOD_FLUXES_FUNCTORS_H_
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 #include "shared/RiemannSolvers.h"
 
@@ -22,6 +22,9 @@ namespace mood {
  * - DataArray and HydroState are typedef'ed in MoodBaseFunctor
  * - FluxData_z may or may not be allocated (depending dim==2 or 3).
  *
+ * - when face_weights is allocated (coefficient-free mode), reconstructed
+ *   states are interpolated directly from Udata and polyCoefs is not read.
+ *
  * stencilId must be known at compile time, so that stencilSize is too.
  */
 template<int dim,
@@ -42,7 +45,7 @@ public:
   /**
    * Constructor for 2D/3D.
    */
-  ComputeFluxesFunctor(HydroParams      params,
+  ComputeFluxesFunctor(KernelParams     params,
 		       MonomMap         monomMap,
 		       DataArray        Udata,
 		       Kokkos::Array<DataArray,ncoefs> polyCoefs,
@@ -53,6 +56,7 @@ public:
 		       mood_matrix_pi_t mat_pi,
 		       QuadLoc_2d_t     QUAD_LOC_2D,
 		       QuadLoc_3d_t     QUAD_LOC_3D,
+		       mood_face_weights_t face_weights,
 		       real_t dtdx,
 		       real_t dtdy,
 		       real_t dtdz) :
@@ -66,6 +70,8 @@ public:
     mat_pi(mat_pi),
     QUAD_LOC_2D(QUAD_LOC_2D),
     QUAD_LOC_3D(QUAD_LOC_3D),
+    face_weights(face_weights),
+    coefficient_free(face_weights.extent(0) > 0),
     dtdx(dtdx),
     dtdy(dtdy),
     dtdz(dtdz)
@@ -126,6 +132,17 @@ public:
       // and all compute UL / UR states
       for (int ivar=0; ivar<nbvar; ++ivar) {
 	
+	if (coefficient_free) {
+
+	  // interpolate Udata at quadrature points with the face weights
+	  for (int iq = 0; iq<nbQuadPts; ++iq) {
+	    UL[iq][ivar] = this->interpolate(i-1,j,ivar,DIR_X,FACE_MAX,iq);
+	    UR[iq][ivar] = this->interpolate(i  ,j,ivar,DIR_X,FACE_MIN,iq);
+	  }
+	  continue;
+
+	}
+
 	// current cell
 	coefs_t coefs_c;
 	
@@ -177,8 +194,8 @@ public:
 	  // change UL into Udata from neighbor
 	  // change UR into Udata from current cell
 	  for (int ivar=0; ivar<nbvar; ++ivar) {
-	    UL[iq][ivar] = polyCoefs[0](i-1,j,ivar);
-	    UR[iq][ivar] = polyCoefs[0](i,j,ivar);
+	    UL[iq][ivar] = Udata(i-1,j,ivar);
+	    UR[iq][ivar] = Udata(i,j,ivar);
 	  }
 	}
 	  
@@ -236,6 +253,17 @@ public:
       // and all compute UL / UR states
       for (int ivar=0; ivar<nbvar; ++ivar) {
 	
+	if (coefficient_free) {
+
+	  // interpolate Udata at quadrature points with the face weights
+	  for (int iq = 0; iq<nbQuadPts; ++iq) {
+	    UL[iq][ivar] = this->interpolate(i  ,j-1,ivar,DIR_Y,FACE_MAX,iq);
+	    UR[iq][ivar] = this->interpolate(i  ,j  ,ivar,DIR_Y,FACE_MIN,iq);
+	  }
+	  continue;
+
+	}
+
 	// current cell
 	coefs_t coefs_c;
 	
@@ -285,8 +313,8 @@ public:
 	if ( this->isValid(UL[iq]) == 0 or this->isValid(UR[iq]) == 0 ) {
 	  // change UL into Udata from neighbor
 	  for (int ivar=0; ivar<nbvar; ++ivar) {
-	    UL[iq][ivar] = polyCoefs[0](i,j-1,ivar);
-	    UR[iq][ivar] = polyCoefs[0](i,j,ivar);
+	    UL[iq][ivar] = Udata(i,j-1,ivar);
+	    UR[iq][ivar] = Udata(i,j,ivar);
 	  }
 	}
 	
@@ -395,6 +423,17 @@ public:
       // and all compute UL / UR states
       for (int ivar=0; ivar<nbvar; ++ivar) {
 	
+	if (coefficient_free) {
+
+	  // interpolate Udata at quadrature points with the face weights
+	  for (int iq = 0; iq<nbQuadPts3d; ++iq) {
+	    UL[iq][ivar] = this->interpolate(i-1,j,k,ivar,DIR_X,FACE_MAX,iq);
+	    UR[iq][ivar] = this->interpolate(i  ,j,k,ivar,DIR_X,FACE_MIN,iq);
+	  }
+	  continue;
+
+	}
+
 	// current cell
 	coefs_t coefs_c;
 	
@@ -434,13 +473,13 @@ public:
 	if ( this->isValid(UL[iq]) == 0 ) {
 	  // change UL into Udata from neighbor
 	  for (int ivar=0; ivar<nbvar; ++ivar)
-	    UL[iq][ivar] = polyCoefs[0](i-1,j,k,ivar);
+	    UL[iq][ivar] = Udata(i-1,j,k,ivar);
 	}
 	  
 	if ( this->isValid(UR[iq]) == 0 ) {
 	  // change UR into Udata from current cell
 	  for (int ivar=0; ivar<nbvar; ++ivar)
-	    UR[iq][ivar] = polyCoefs[0](i,j,k,ivar);
+	    UR[iq][ivar] = Udata(i,j,k,ivar);
 	}
 	
       } // end check validity
@@ -504,6 +543,17 @@ public:
       // and all compute UL / UR states
       for (int ivar=0; ivar<nbvar; ++ivar) {
 	
+	if (coefficient_free) {
+
+	  // interpolate Udata at quadrature points with the face weights
+	  for (int iq = 0; iq<nbQuadPts3d; ++iq) {
+	    UL[iq][ivar] = this->interpolate(i  ,j-1,k,ivar,DIR_Y,FACE_MAX,iq);
+	    UR[iq][ivar] = this->interpolate(i  ,j  ,k,ivar,DIR_Y,FACE_MIN,iq);
+	  }
+	  continue;
+
+	}
+
 	// current cell
 	coefs_t coefs_c;
 	
@@ -543,13 +593,13 @@ public:
 	if ( this->isValid(UL[iq]) == 0 ) {
 	  // change UL into Udata from neighbor
 	  for (int ivar=0; ivar<nbvar; ++ivar)
-	    UL[iq][ivar] = polyCoefs[0](i,j-1,k,ivar);
+	    UL[iq][ivar] = Udata(i,j-1,k,ivar);
 	}
 	  
 	if ( this->isValid(UR[iq]) == 0 ) {
 	  // change UR into Udata from current cell
 	  for (int ivar=0; ivar<nbvar; ++ivar)
-	    UR[iq][ivar] = polyCoefs[0](i,j,k,ivar);
+	    UR[iq][ivar] = Udata(i,j,k,ivar);
 	}
 	
       } // end check validity
@@ -619,6 +669,17 @@ public:
       // and all compute UL / UR states
       for (int ivar=0; ivar<nbvar; ++ivar) {
 	
+	if (coefficient_free) {
+
+	  // interpolate Udata at quadrature points with the face weights
+	  for (int iq = 0; iq<nbQuadPts3d; ++iq) {
+	    UL[iq][ivar] = this->interpolate(i  ,j  ,k-1,ivar,DIR_Z,FACE_MAX,iq);
+	    UR[iq][ivar] = this->interpolate(i  ,j  ,k  ,ivar,DIR_Z,FACE_MIN,iq);
+	  }
+	  continue;
+
+	}
+
 	// current cell
 	coefs_t coefs_c;
 	
@@ -658,13 +719,13 @@ public:
 	if ( this->isValid(UL[iq]) == 0 ) {
 	  // change UL into Udata from neighbor
 	  for (int ivar=0; ivar<nbvar; ++ivar)
-	    UL[iq][ivar] = polyCoefs[0](i,j,k-1,ivar);
+	    UL[iq][ivar] = Udata(i,j,k-1,ivar);
 	}
 	  
 	if ( this->isValid(UR[iq]) == 0 ) {
 	  // change UR into Udata from current cell
 	  for (int ivar=0; ivar<nbvar; ++ivar)
-	    UR[iq][ivar] = polyCoefs[0](i,j,k,ivar);
+	    UR[iq][ivar] = Udata(i,j,k,ivar);
 	}
 	
       } // end check validity
@@ -720,6 +781,38 @@ public:
     
   }  // end functor 3d
   
+  /**
+   * Reconstructed value of variable ivar of cell (i,j) at quadrature point
+   * iq of face (dir,face), as a weighted sum of Udata over the stencil
+   * (coefficient-free mode, see face_weights).
+   */
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t interpolate(int i, int j,
+		     typename std::enable_if<dim_==2, int>::type ivar,
+		     int dir, int face, int iq) const
+  {
+    real_t result = 0;
+    for (int is=0; is<stencil_size; ++is)
+      result += face_weights(dir,face,iq,is) *
+	Udata(i+stencil.offsets(is,0), j+stencil.offsets(is,1), ivar);
+    return result;
+  }
+
+  //! 3d version of interpolate
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t interpolate(int i, int j, int k,
+		     typename std::enable_if<dim_==3, int>::type ivar,
+		     int dir, int face, int iq) const
+  {
+    real_t result = 0;
+    for (int is=0; is<stencil_size; ++is)
+      result += face_weights(dir,face,iq,is) *
+	Udata(i+stencil.offsets(is,0), j+stencil.offsets(is,1), k+stencil.offsets(is,2), ivar);
+    return result;
+  }
+
   DataArray                       Udata;
   Kokkos::Array<DataArray,ncoefs> polyCoefs;
   DataArray                       FluxData_x, FluxData_y, FluxData_z;
@@ -730,6 +823,11 @@ public:
   QuadLoc_3d_t     QUAD_LOC_3D;
   real_t           dtdx, dtdy, dtdz;
 
+  //! reconstruction weights at face quadrature points (empty when
+  //! polynomial coefficients are used)
+  mood_face_weights_t face_weights;
+  bool                coefficient_free;
+
   // get the number of cells in stencil
   static constexpr int stencil_size = STENCIL_SIZE[stencilId];
 
@@ -763,7 +861,7 @@ public:
   /**
    * Constructor for 2D/3D.
    */
-  RecomputeFluxesFunctor(HydroParams      params,
+  RecomputeFluxesFunctor(KernelParams     params,
 			 MonomMap         monomMap,
 			 DataArray        Udata,
 			 DataArray        Flags,
@@ -5,7 +5,7 @@
 #define MOOD_INIT_FUNCTORS_H_
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 
 // mood
@@ -37,7 +37,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::DataArray;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
   
-  InitImplodeFunctor(HydroParams params,
+  InitImplodeFunctor(KernelParams params,
 		     MonomMap    monomMap,
 		     DataArray   Udata) :
     MoodBaseFunctor<dim,degree>(params,monomMap), Udata(Udata)  {};
@@ -151,7 +151,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::DataArray;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
 
-  InitBlastFunctor(HydroParams params,
+  InitBlastFunctor(KernelParams params,
 		   MonomMap    monomMap,
 		   BlastParams bParams,
 		   DataArray   Udata) :
@@ -298,7 +298,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::HydroState;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
 
-  InitFourQuadrantFunctor(HydroParams params,
+  InitFourQuadrantFunctor(KernelParams params,
 			  MonomMap    monomMap,
 			  DataArray   Udata,
 			  HydroState2d U0,
@@ -458,7 +458,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::DataArray;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
   
-  InitKelvinHelmholtzFunctor(HydroParams params,
+  InitKelvinHelmholtzFunctor(KernelParams params,
 			     MonomMap    monomMap,
 			     KHParams    khParams,
 			     DataArray   Udata) :
@@ -703,7 +703,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::DataArray;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
   
-  InitWedgeFunctor(HydroParams params,
+  InitWedgeFunctor(KernelParams params,
 		   MonomMap    monomMap,
 		   WedgeParams wparams,
 		   DataArray   Udata) :
@@ -842,7 +842,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::DataArray;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
   
-  InitIsentropicVortexFunctor(HydroParams params,
+  InitIsentropicVortexFunctor(KernelParams params,
 			      MonomMap    monomMap,
 			      IsentropicVortexParams iparams,
 			      DataArray   Udata) :
@@ -2,7 +2,7 @@
 #define MOOD_POLYNOMIAL_RECONSTRUCTION_FUNCTORS_H_
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 #include "shared/RiemannSolvers.h"
 
@@ -63,7 +63,7 @@ public:
    * \param[in] stencil (array containing neighbor x,y,z coordinates)
    * \param[in] mat_pi pseudo-inverse of the geometric terms matrix.
    */
-  ComputeReconstructionPolynomialFunctor(HydroParams                     params,
+  ComputeReconstructionPolynomialFunctor(KernelParams                    params,
 					 MonomMap                        monomMap,
 					 DataArray                       Udata,
 					 Kokkos::Array<DataArray,ncoefs> polyCoefs,
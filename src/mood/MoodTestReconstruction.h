@@ -2,7 +2,7 @@
 #define MOOD_TEST_RECONSTRUCTION_H_
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 #include "shared/RiemannSolvers.h"
 
@@ -46,7 +46,7 @@ public:
 			    DataArray        RecState1,
 			    DataArray        RecState2,
 			    DataArray        RecState3,
-			    HydroParams      params,
+			    KernelParams     params,
 			    Stencil          stencil,
 			    mood_matrix_pi_t mat_pi,
 			    QuadLoc_2d_t     QUAD_LOC_2D) :
@@ -2,7 +2,7 @@
 #define MOOD_UPDATE_FUNCTORS_H_
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 
 #include "mood/MoodBaseFunctor.h"
@@ -28,7 +28,7 @@ public:
   //! Decide at compile-time which data array to use
   using DataArray  = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
 
-  UpdateFunctor(HydroParams params,
+  UpdateFunctor(KernelParams params,
 		DataArray UOld,
 		DataArray UNew,
 		DataArray FluxData_x,
@@ -164,7 +164,7 @@ public:
     
   } // end operator ()
   
-  HydroParams params;
+  KernelParams params;
   DataArray   UOld;
   DataArray   UNew;
   DataArray   FluxData_x;
@@ -192,7 +192,7 @@ public:
   //! Decide at compile-time which data array to use
   using DataArray  = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
 
-  UpdateFunctor_ssprk2(HydroParams params,
+  UpdateFunctor_ssprk2(KernelParams params,
 		       DataArray UOld,
 		       DataArray URK,
 		       DataArray UNew,
@@ -330,7 +330,7 @@ public:
     
   } // end operator ()
   
-  HydroParams params;
+  KernelParams params;
   DataArray   UOld;
   DataArray   URK;
   DataArray   UNew;
@@ -359,7 +359,7 @@ public:
   //! Decide at compile-time which data array to use
   using DataArray  = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
 
-  UpdateFunctor_weight(HydroParams params,
+  UpdateFunctor_weight(KernelParams params,
 		       DataArray UOld,
 		       DataArray URK,
 		       DataArray UNew,
@@ -505,7 +505,7 @@ public:
     
   } // end operator ()
   
-  HydroParams params;
+  KernelParams params;
   DataArray   UOld;
   DataArray   URK;
   DataArray   UNew;
@@ -537,7 +537,7 @@ public:
   using typename MoodBaseFunctor<dim,degree>::HydroState;
   using MonomMap = typename mood::MonomialMap<dim,degree>::MonomMap;
 
-  ComputeMoodFlagsUpdateFunctor(HydroParams params,
+  ComputeMoodFlagsUpdateFunctor(KernelParams params,
 				MonomMap    monomMap,
 				DataArray   Udata,
 				DataArray   Flags,
@@ -15,7 +15,9 @@
 #include "shared/SolverBase.h"
 #include "shared/HydroParams.h"
 #include "shared/kokkos_shared.h"
-#include "shared/BoundariesFunctors.h"
+#include "shared/FirstTouch.h"
+#include "shared/KernelTuner.h"
+#include "shared/DiagnosticsFunctors.h"
 #include "shared/BoundariesFunctorsWedge.h"
 #include "shared/problems/initRiemannConfig2d.h"
 
@@ -111,6 +113,16 @@ public:
   //! mood detection
   DataArray MoodFlags;
 
+  /**
+   * Phases of a time integration stage, used to declare the lifetime of
+   * the transient arrays allocated in m_workspace.
+   */
+  enum StepPhase {
+    PHASE_RECONSTRUCTION, //!< reconstruction polynomial coefficients
+    PHASE_FLUXES,         //!< fluxes computation
+    PHASE_FLAGS           //!< mood flags, fluxes recomputation and update
+  };
+
   /*
    * MOOD config
    */
@@ -125,6 +137,18 @@ public:
   mood_matrix_pi_t      geomMatrixPI_view;
   mood_matrix_pi_host_t geomMatrixPI_view_h;
 
+  /**
+   * Coefficient-free reconstruction ([mood] coefficient_free=true):
+   * reconstructed states at face quadrature points are linear in the
+   * stencil values, with weights only depending on geometry. They are
+   * precomputed once (face_weights), so that fluxes are computed directly
+   * from U and PolyCoefs is never allocated.
+   */
+  bool coefficient_free;
+
+  //! reconstruction weights at face quadrature points (coefficient-free mode)
+  mood_face_weights_t face_weights;
+
   //! Quadrature point location view
   QuadLoc_2d_t   QUAD_LOC_2D;
   QuadLoc_2d_h_t QUAD_LOC_2D_h;
@@ -144,6 +168,9 @@ public:
 
   //! initialize quadrature rules in 2d
   void init_quadrature_3d();
+
+  //! compute reconstruction weights at face quadrature points
+  void init_face_weights();
   
   //! compute time step inside an MPI process, at shared memory level.
   double compute_dt_local();
@@ -230,6 +257,8 @@ SolverHydroMood<dim,degree>::SolverHydroMood(HydroParams& params,
   stencil(stencilId),
   monomialMap(),
   geomMatrix(stencil_size-1,ncoefs-1),
+  coefficient_free(false),
+  face_weights(),
   forward_euler_enabled(true),
   ssprk2_enabled(false),
   ssprk3_enabled(false),
@@ -246,51 +275,61 @@ SolverHydroMood<dim,degree>::SolverHydroMood(HydroParams& params,
   
   int nbvar = params.nbvar;
 
+  coefficient_free = configMap.getBool("mood", "coefficient_free", false);
+
   long long int total_mem_size = 0;
+
+  // allocation and first touch time, reported below
+  Timer alloc_timer;
+  alloc_timer.start();
   
   /*
    * memory allocation (use sizes with ghosts included)
    */
   if (dim==2) {
 
-    U     = DataArray("U", isize, jsize, nbvar);
-    Uhost = Kokkos::create_mirror(U);
-    U2    = DataArray("U2",isize, jsize, nbvar);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize, jsize, nbvar);
+    U2    = allocate_first_touch<DataArray>("U2", nbCells, isize, jsize, nbvar);
     
-    Fluxes_x = DataArray("Fluxes_x", isize, jsize, nbvar);
-    Fluxes_y = DataArray("Fluxes_y", isize, jsize, nbvar);
-    MoodFlags = DataArray("MoodFlags", isize, jsize, 1);
-
-    // init polynomial coefficients array
-    for (int ip=0; ip<ncoefs; ++ip) {
-      std::string label = "PolyCoefs_" + std::to_string(ip);
-      PolyCoefs[ip] = DataArray(label, isize, jsize, nbvar);
+    m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_FLAGS, isize, jsize, nbvar);
+    m_workspace.declare("Fluxes_y", Fluxes_y, PHASE_FLUXES, PHASE_FLAGS, isize, jsize, nbvar);
+    m_workspace.declare("MoodFlags", MoodFlags, PHASE_FLAGS, PHASE_FLAGS, isize, jsize, 1);
+
+    // init polynomial coefficients array (not needed in coefficient-free mode)
+    if (!coefficient_free) {
+      for (int ip=0; ip<ncoefs; ++ip) {
+	std::string label = "PolyCoefs_" + std::to_string(ip);
+	m_workspace.declare(label, PolyCoefs[ip], PHASE_RECONSTRUCTION, PHASE_FLUXES, isize, jsize, nbvar);
+      }
     }
 
     total_mem_size += isize*jsize*nbvar*4 * sizeof(real_t);
     total_mem_size += isize*jsize * sizeof(real_t);
-    total_mem_size += isize*jsize*nbvar * ncoefs * sizeof(real_t);
+    if (!coefficient_free)
+      total_mem_size += isize*jsize*nbvar * ncoefs * sizeof(real_t);
       
   } else if (dim==3) {
 
-    U     = DataArray("U", isize, jsize, ksize, nbvar);
-    Uhost = Kokkos::create_mirror(U);
-    U2    = DataArray("U2",isize, jsize, ksize, nbvar);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize, jsize, ksize, nbvar);
+    U2    = allocate_first_touch<DataArray>("U2", nbCells, isize, jsize, ksize, nbvar);
     
-    Fluxes_x = DataArray("Fluxes_x", isize, jsize, ksize, nbvar);
-    Fluxes_y = DataArray("Fluxes_y", isize, jsize, ksize, nbvar);
-    Fluxes_z = DataArray("Fluxes_z", isize, jsize, ksize, nbvar);
-    MoodFlags = DataArray("MoodFlags", isize, jsize, ksize, 1);
-
-    // init polynomial coefficients array
-    for (int ip=0; ip<ncoefs; ++ip) {
-      std::string label = "PolyCoefs_" + std::to_string(ip);
-      PolyCoefs[ip] = DataArray(label, isize, jsize, ksize, nbvar);
+    m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_FLAGS, isize, jsize, ksize, nbvar);
+    m_workspace.declare("Fluxes_y", Fluxes_y, PHASE_FLUXES, PHASE_FLAGS, isize, jsize, ksize, nbvar);
+    m_workspace.declare("Fluxes_z", Fluxes_z, PHASE_FLUXES, PHASE_FLAGS, isize, jsize, ksize, nbvar);
+    m_workspace.declare("MoodFlags", MoodFlags, PHASE_FLAGS, PHASE_FLAGS, isize, jsize, ksize, 1);
+
+    // init polynomial coefficients array (not needed in coefficient-free mode)
+    if (!coefficient_free) {
+      for (int ip=0; ip<ncoefs; ++ip) {
+	std::string label = "PolyCoefs_" + std::to_string(ip);
+	m_workspace.declare(label, PolyCoefs[ip], PHASE_RECONSTRUCTION, PHASE_FLUXES, isize, jsize, ksize, nbvar);
+      }
     }
 
     total_mem_size += isize*jsize*ksize*nbvar*5 * sizeof(real_t);
     total_mem_size += isize*jsize*ksize * sizeof(real_t);
-    total_mem_size += isize*jsize*ksize*nbvar * ncoefs * sizeof(real_t);
+    if (!coefficient_free)
+      total_mem_size += isize*jsize*ksize*nbvar * ncoefs * sizeof(real_t);
 
   }
 
@@ -304,6 +343,9 @@ SolverHydroMood<dim,degree>::SolverHydroMood(HydroParams& params,
    */
   init_quadrature_2d();
   init_quadrature_3d();
+
+  if (coefficient_free)
+    init_face_weights();
   
   /*
    * Time integration
@@ -316,41 +358,62 @@ SolverHydroMood<dim,degree>::SolverHydroMood(HydroParams& params,
   if (ssprk2_enabled) {
 
     if (dim == 2) {
-      U_RK1 = DataArray("U_RK1",isize, jsize, nbvar);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, nbvar);
       total_mem_size += isize*jsize*nbvar * sizeof(real_t);
     } else if (dim == 3) {
-      U_RK1 = DataArray("U_RK1",isize, jsize, ksize, nbvar);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, ksize, nbvar);
       total_mem_size += isize*jsize*ksize*nbvar * sizeof(real_t);
     }
     
   } else if (ssprk3_enabled) {
 
     if (dim == 2) {
-      U_RK1 = DataArray("U_RK1",isize, jsize, nbvar);
-      U_RK2 = DataArray("U_RK2",isize, jsize, nbvar);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, nbvar);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, nbvar);
       total_mem_size += isize*jsize*nbvar * 2 * sizeof(real_t);
     } else if (dim == 3) {
-      U_RK1 = DataArray("U_RK1",isize, jsize, ksize, nbvar);
-      U_RK2 = DataArray("U_RK2",isize, jsize, ksize, nbvar);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, ksize, nbvar);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, ksize, nbvar);
       total_mem_size += isize*jsize*ksize*nbvar * 2 * sizeof(real_t);
     }
     
   } else if (ssprk54_enabled) {
 
     if (dim == 2) {
-      U_RK1 = DataArray("U_RK1",isize, jsize, nbvar);
-      U_RK2 = DataArray("U_RK2",isize, jsize, nbvar);
-      U_RK3 = DataArray("U_RK3",isize, jsize, nbvar);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, nbvar);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, nbvar);
+      U_RK3 = allocate_first_touch<DataArray>("U_RK3", nbCells, isize, jsize, nbvar);
       total_mem_size += isize*jsize*nbvar * 3 * sizeof(real_t);
     } else if (dim == 3) {
-      U_RK1 = DataArray("U_RK1",isize, jsize, ksize, nbvar);
-      U_RK2 = DataArray("U_RK2",isize, jsize, ksize, nbvar);
-      U_RK3 = DataArray("U_RK3",isize, jsize, ksize, nbvar);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, ksize, nbvar);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, ksize, nbvar);
+      U_RK3 = allocate_first_touch<DataArray>("U_RK3", nbCells, isize, jsize, ksize, nbvar);
       total_mem_size += isize*jsize*ksize*nbvar * 3 * sizeof(real_t);
     }
     
   }
 
+  // transient arrays: MoodFlags shares memory with polynomial coefficients
+  m_workspace.allocate(nbCells);
+
+  alloc_timer.stop();
+
+  /*
+   * ghost cells list: wedge (2D) has its own border conditions
+   */
+  if (dim==2 and !m_problem_name.compare("wedge")) {
+
+    ppkMHD::GhostFaces faces = ppkMHD::GhostFaces::from_params(params);
+
+    faces.set(FACE_XMIN, ppkMHD::GHOST_NEUMANN,   true);
+    faces.set(FACE_XMAX, ppkMHD::GHOST_NEUMANN);
+    faces.set(FACE_YMIN, ppkMHD::GHOST_DIRICHLET, true);
+    faces.set(FACE_YMAX, ppkMHD::GHOST_NEUMANN,   true);
+
+    m_boundary_engine.init(params, faces);
+
+  }
+
   /*
    * initialize hydro array at t=0
    */
@@ -395,6 +458,7 @@ SolverHydroMood<dim,degree>::SolverHydroMood(HydroParams& params,
   std::cout << "Mood polynomial coefficients : " << ncoefs << "\n";
   std::cout << "StencilId is " << StencilUtils::get_stencil_name(stencil.stencilId) << "\n";
   std::cout << "Number of quadrature points : " << QUADRATURE_NUM_POINTS[stencilId] << "\n";
+  std::cout << "Coefficient-free reconstruction : " << coefficient_free << "\n";
   std::cout << "Time integration is :\n";
   std::cout << "Forward Euler : " << forward_euler_enabled << "\n";
   std::cout << "SSPRK2        : " << ssprk2_enabled << "\n";
@@ -406,6 +470,9 @@ SolverHydroMood<dim,degree>::SolverHydroMood(HydroParams& params,
   params.print();
   std::cout << "##########################" << "\n";
   std::cout << "Memory requested : " << (total_mem_size / 1e6) << " MBytes\n"; 
+  std::cout << "Allocation + first touch : " << alloc_timer.elapsed() << " s ("
+            << Device().concurrency() << " " << Device::name() << " threads)\n";
+  m_workspace.print_info();
   std::cout << "##########################" << "\n";
 
   // initialize time step
@@ -712,6 +779,83 @@ void SolverHydroMood<dim,degree>::init_quadrature_3d()
 
 } // SolverHydroMood::init_quadrature_3d
 
+// =======================================================
+// =======================================================
+/**
+ * Reconstruction weights at face quadrature points.
+ *
+ * With coefs[0] = U_0 (stencil center) and
+ * coefs[m] = sum_k PI(m-1,k) (U_k - U_0) for m>0, the polynomial value at
+ * point p is sum_m coefs[m] mono_m(p), i.e.
+ *   sum_k W_k(p) U_k + (1 - sum_k W_k(p)) U_0
+ * with W_k(p) = sum_{m>0} mono_m(p) PI(m-1,k): a fixed linear combination
+ * of the stencil values, computed here once for all quadrature points.
+ *
+ * Must be called after init_mood and init_quadrature_2d/3d.
+ */
+template<int dim, int degree>
+void SolverHydroMood<dim,degree>::init_face_weights()
+{
+
+  const int nbQuadPts = QUADRATURE_NUM_POINTS[stencilId];
+  const int nbQuadPtsFace = dim==2 ? nbQuadPts : nbQuadPts*nbQuadPts;
+
+  const real_t dxyz[3] = {params.dx, params.dy, params.dz};
+
+  face_weights = mood_face_weights_t("face_weights", dim, 2, nbQuadPtsFace, stencil_size);
+  mood_face_weights_host_t face_weights_h = Kokkos::create_mirror_view(face_weights);
+
+  for (int dir=0; dir<dim; ++dir) {
+    for (int face=0; face<2; ++face) {
+      for (int iq=0; iq<nbQuadPtsFace; ++iq) {
+
+	// quadrature point, relative to the cell center
+	real_t p[3] = {0, 0, 0};
+	for (int d=0; d<dim; ++d)
+	  p[d] = (dim==2 ?
+		  QUAD_LOC_2D_h(nbQuadPts-1,dir,face,iq,d) :
+		  QUAD_LOC_3D_h(nbQuadPts-1,dir,face,iq,d)) * dxyz[d];
+
+	real_t sum = 0;
+	int ik = 0; // index of the stencil point among non-central ones
+	int is_center = 0;
+
+	for (int is=0; is<stencil_size; ++is) {
+
+	  const bool center =
+	    stencil.offsets_h(is,0) == 0 and
+	    stencil.offsets_h(is,1) == 0 and
+	    (dim==2 or stencil.offsets_h(is,2) == 0);
+
+	  if (center) {
+	    is_center = is;
+	    continue;
+	  }
+
+	  real_t w = 0;
+	  for (int icoef=1; icoef<ncoefs; ++icoef) {
+	    real_t mono = 1.0;
+	    for (int d=0; d<dim; ++d)
+	      mono *= pow(p[d], monomialMap.data_h(icoef,d));
+	    w += mono * geomMatrixPI_view_h(icoef-1,ik);
+	  }
+
+	  face_weights_h(dir,face,iq,is) = w;
+	  sum += w;
+	  ++ik;
+
+	} // end for is
+
+	face_weights_h(dir,face,iq,is_center) = 1.0 - sum;
+
+      } // end for iq
+    } // end for face
+  } // end for dir
+
+  Kokkos::deep_copy(face_weights, face_weights_h);
+
+} // SolverHydroMood::init_face_weights
+
 // =======================================================
 // =======================================================
 /**
@@ -739,9 +883,17 @@ double SolverHydroMood<dim,degree>::compute_dt_local()
 			      ComputeDtFunctor2d<degree>,
 			      ComputeDtFunctor3d<degree>>::type;
 
-  // call device functor
-  ComputeDtFunctor computeDtFunctor(params, monomialMap.data, Udata);
-  Kokkos::parallel_reduce(nbCells, computeDtFunctor, invDt);
+  // call device functor (fused with diagnostics when due)
+  ComputeDtFunctor computeDtFunctor(kernel_params, monomialMap.data, Udata);
+  if (m_diagnostics->is_due(m_iteration))
+    ComputeDiagnosticsFunctor<dim,ComputeDtFunctor>::apply(kernel_params, Udata,
+							    computeDtFunctor,
+							    false,
+							    nbCells,
+							    *m_diagnostics,
+							    invDt);
+  else
+    Kokkos::parallel_reduce("ComputeDtFunctor", nbCells, computeDtFunctor, invDt);
     
   dt = params.settings.cfl/invDt;
 
@@ -779,7 +931,9 @@ void SolverHydroMood<dim,degree>::next_iteration_impl()
   
   // compute new dt
   timers[TIMER_DT]->start();
+  Kokkos::Profiling::pushRegion("compute_dt");
   compute_dt();
+  Kokkos::Profiling::popRegion();
   timers[TIMER_DT]->stop();
   
   // perform one step integration
@@ -817,7 +971,9 @@ void SolverHydroMood<dim,degree>::time_integration_impl(DataArray data_in,
   
   // fill ghost cell in data_in
   timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
   make_boundaries(data_in);
+  Kokkos::Profiling::popRegion();
   timers[TIMER_BOUNDARIES]->stop();
     
   // copy data_in into data_out (not necessary)
@@ -826,6 +982,7 @@ void SolverHydroMood<dim,degree>::time_integration_impl(DataArray data_in,
   
   // start main computation
   timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
 
   if (ssprk2_enabled) {
     
@@ -845,6 +1002,7 @@ void SolverHydroMood<dim,degree>::time_integration_impl(DataArray data_in,
     
   }
   
+  Kokkos::Profiling::popRegion();
   timers[TIMER_NUM_SCHEME]->stop();
   
 } // SolverHydroMood::time_integration_impl
@@ -868,12 +1026,13 @@ void SolverHydroMood<dim,degree>::time_int_forward_euler(DataArray data_in,
   dtdy = dt / params.dy;
   dtdz = dt / params.dz;
 
+  m_workspace.begin_phase(PHASE_RECONSTRUCTION);
   // compute reconstruction polynomial coefficients
-  {
+  if (!coefficient_free) {
     
     ComputeReconstructionPolynomialFunctor<dim,degree,stencilId>
-      functor(params, monomialMap.data, data_in, PolyCoefs, stencil, geomMatrixPI_view);
-    Kokkos::parallel_for(nbCells,functor);
+      functor(kernel_params, monomialMap.data, data_in, PolyCoefs, stencil, geomMatrixPI_view);
+    ppkMHD::parallel_for_tuned("ComputeReconstructionPolynomialFunctor", nbCells,functor);
 
     // for (int icoef=0; icoef<ncoefs; ++icoef)
     //   save_data_debug(PolyCoefs[icoef], Uhost, m_times_saved-1, m_t, "poly"+std::to_string(icoef));
@@ -886,9 +1045,9 @@ void SolverHydroMood<dim,degree>::time_int_forward_euler(DataArray data_in,
 
   //     int nbvar = params.nbvar;
 
-  //     DataArray RecState1 = DataArray("RecState1", isize, jsize, nbvar);
-  //     DataArray RecState2 = DataArray("RecState2", isize, jsize, nbvar);
-  //     DataArray RecState3 = DataArray("RecState3", isize, jsize, nbvar);
+  //     DataArray RecState1 = allocate_first_touch<DataArray>("RecState1", nbCells, isize, jsize, nbvar);
+  //     DataArray RecState2 = allocate_first_touch<DataArray>("RecState2", nbCells, isize, jsize, nbvar);
+  //     DataArray RecState3 = allocate_first_touch<DataArray>("RecState3", nbCells, isize, jsize, nbvar);
 
   //     TestReconstructionFunctor<dim,degree,stencilId> functor(data_in, PolyCoefs,
   // 							      RecState1, RecState2, RecState3,
@@ -905,9 +1064,10 @@ void SolverHydroMood<dim,degree>::time_int_forward_euler(DataArray data_in,
   // }
   
  
+  m_workspace.begin_phase(PHASE_FLUXES);
   // compute fluxes
   {
-    ComputeFluxesFunctor<dim,degree, stencilId> functor(params, monomialMap.data,
+    ComputeFluxesFunctor<dim,degree, stencilId> functor(kernel_params, monomialMap.data,
 							data_in, PolyCoefs,
 							Fluxes_x,
 							Fluxes_y,
@@ -916,8 +1076,11 @@ void SolverHydroMood<dim,degree>::time_int_forward_euler(DataArray data_in,
 							geomMatrixPI_view,
 							QUAD_LOC_2D,
 							QUAD_LOC_3D,
+							face_weights,
 							dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ppkMHD::parallel_for_tuned("ComputeFluxesFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
 
     //save_data_debug(Fluxes_x, Uhost, m_times_saved, m_t, "flux_x");
     //save_data_debug(Fluxes_y, Uhost, m_times_saved, m_t, "flux_y");
@@ -925,27 +1088,28 @@ void SolverHydroMood<dim,degree>::time_int_forward_euler(DataArray data_in,
 
   //for (int iRecomp=0; iRecomp<5; ++iRecomp) {
   
+  m_workspace.begin_phase(PHASE_FLAGS);
   // flag cells for which fluxes will need to be recomputed
   // because attemp to update leads to physically invalid values
   // (negative density or pressure)
   {  
-    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(params, monomialMap.data,
+    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 						      data_in,
 						      MoodFlags,
 						      Fluxes_x,
 						      Fluxes_y,
 						      Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMoodFlagsUpdateFunctor", nbCells, functor);
     //save_data_debug(MoodFlags, Uhost, m_times_saved, m_t, "mood_flags");
   }
   
   // recompute fluxes arround flagged cells
   {
-    RecomputeFluxesFunctor<dim,degree> functor(params, monomialMap.data,
+    RecomputeFluxesFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					       data_in, MoodFlags,
 					       Fluxes_x, Fluxes_y, Fluxes_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("RecomputeFluxesFunctor", nbCells, functor);
     //save_data_debug(Fluxes_x, Uhost, m_times_saved, m_t, "flux_x_after");
     //save_data_debug(Fluxes_y, Uhost, m_times_saved, m_t, "flux_y_after");
   }
@@ -954,9 +1118,11 @@ void SolverHydroMood<dim,degree>::time_int_forward_euler(DataArray data_in,
 
   // actual update
   {
-    UpdateFunctor<dim> functor(params, data_in, data_out,
+    UpdateFunctor<dim> functor(kernel_params, data_in, data_out,
 			       Fluxes_x, Fluxes_y, Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("update");
+    Kokkos::parallel_for("UpdateFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
   }
     
 } // SolverHydroMood::time_int_forward_euler
@@ -1001,21 +1167,23 @@ void SolverHydroMood<dim,degree>::time_int_ssprk2(DataArray data_in,
   // ==============================================
   // first step : U_RK1 = U_n + dt * fluxes(U_n)
   // ==============================================
+  m_workspace.begin_phase(PHASE_RECONSTRUCTION);
   // compute reconstruction polynomial coefficients of data_in
-  {
+  if (!coefficient_free) {
     
     ComputeReconstructionPolynomialFunctor<dim,degree,stencilId>
-      functor(params, monomialMap.data, data_in, PolyCoefs, stencil, geomMatrixPI_view);
-    Kokkos::parallel_for(nbCells,functor);
+      functor(kernel_params, monomialMap.data, data_in, PolyCoefs, stencil, geomMatrixPI_view);
+    ppkMHD::parallel_for_tuned("ComputeReconstructionPolynomialFunctor", nbCells,functor);
 
     // for (int icoef=0; icoef<ncoefs; ++icoef)
     //   save_data_debug(PolyCoefs[icoef], Uhost, m_times_saved-1, m_t, "poly"+std::to_string(icoef));
 
   }
 
+  m_workspace.begin_phase(PHASE_FLUXES);
   // compute fluxes to update data_in
   {
-    ComputeFluxesFunctor<dim,degree, stencilId> functor(params, monomialMap.data,
+    ComputeFluxesFunctor<dim,degree, stencilId> functor(kernel_params, monomialMap.data,
 							data_in, PolyCoefs,
 							Fluxes_x,
 							Fluxes_y,
@@ -1024,43 +1192,49 @@ void SolverHydroMood<dim,degree>::time_int_ssprk2(DataArray data_in,
 							geomMatrixPI_view,
 							QUAD_LOC_2D,
 							QUAD_LOC_3D,
+							face_weights,
 							dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ppkMHD::parallel_for_tuned("ComputeFluxesFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
 
     //save_data_debug(Fluxes_x, Uhost, m_times_saved, m_t, "flux_x");
     //save_data_debug(Fluxes_y, Uhost, m_times_saved, m_t, "flux_y");
   }
 
+  m_workspace.begin_phase(PHASE_FLAGS);
   // flag cells for which fluxes will need to be recomputed
   // because attemp to update leads to physically invalid values
   // (negative density or pressure)
   {  
-    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(params, monomialMap.data,
+    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 						      data_in,
 						      MoodFlags,
 						      Fluxes_x,
 						      Fluxes_y,
 						      Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMoodFlagsUpdateFunctor", nbCells, functor);
     //save_data_debug(MoodFlags, Uhost, m_times_saved, m_t, "mood_flags");    
   }
   
   // recompute fluxes arround flagged cells
   {
-    RecomputeFluxesFunctor<dim,degree> functor(params, monomialMap.data,
+    RecomputeFluxesFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					       data_in, MoodFlags,
 					       Fluxes_x, Fluxes_y, Fluxes_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("RecomputeFluxesFunctor", nbCells, functor);
     //save_data_debug(Fluxes_x, Uhost, m_times_saved, m_t, "flux_x_after");
     //save_data_debug(Fluxes_y, Uhost, m_times_saved, m_t, "flux_y_after");
   }
 
   // update: U_RK1 = data_in + dt*fluxes
   {
-    UpdateFunctor<dim> functor(params, data_in, U_RK1,
+    UpdateFunctor<dim> functor(kernel_params, data_in, U_RK1,
 			       Fluxes_x, Fluxes_y, Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("update");
+    Kokkos::parallel_for("UpdateFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
   }
 
   make_boundaries(U_RK1);
@@ -1068,19 +1242,21 @@ void SolverHydroMood<dim,degree>::time_int_ssprk2(DataArray data_in,
   // ==================================================================
   // second step : U_{n+1} = 0.5 * (U_n + U_RK1 + dt * fluxes(U_RK1) )
   // ==================================================================
+  m_workspace.begin_phase(PHASE_RECONSTRUCTION);
   // compute reconstruction polynomial coefficients of U_RK1
-  {
+  if (!coefficient_free) {
     
     ComputeReconstructionPolynomialFunctor<dim,degree,stencilId>
-      functor(params, monomialMap.data, U_RK1, PolyCoefs, stencil, geomMatrixPI_view);
-    Kokkos::parallel_for(nbCells,functor);
+      functor(kernel_params, monomialMap.data, U_RK1, PolyCoefs, stencil, geomMatrixPI_view);
+    ppkMHD::parallel_for_tuned("ComputeReconstructionPolynomialFunctor", nbCells,functor);
 
   }
 
+  m_workspace.begin_phase(PHASE_FLUXES);
   // compute fluxes to update U_RK1
   {
 
-    ComputeFluxesFunctor<dim,degree, stencilId> functor(params, monomialMap.data,
+    ComputeFluxesFunctor<dim,degree, stencilId> functor(kernel_params, monomialMap.data,
 							U_RK1, PolyCoefs,
 							Fluxes_x,
 							Fluxes_y,
@@ -1089,38 +1265,44 @@ void SolverHydroMood<dim,degree>::time_int_ssprk2(DataArray data_in,
 							geomMatrixPI_view,
 							QUAD_LOC_2D,
 							QUAD_LOC_3D,
+							face_weights,
 							dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ppkMHD::parallel_for_tuned("ComputeFluxesFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
 
   }
 
+  m_workspace.begin_phase(PHASE_FLAGS);
   // flag cells for which fluxes will need to be recomputed
   // because attemp to update leads to physically invalid values
   // (negative density or pressure)
   {  
-    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(params, monomialMap.data,
+    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 						      U_RK1,
 						      MoodFlags,
 						      Fluxes_x,
 						      Fluxes_y,
 						      Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMoodFlagsUpdateFunctor", nbCells, functor);
   }
   
   // recompute fluxes arround flagged cells
   {
-    RecomputeFluxesFunctor<dim,degree> functor(params, monomialMap.data,
+    RecomputeFluxesFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					       U_RK1, MoodFlags,
 					       Fluxes_x, Fluxes_y, Fluxes_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("RecomputeFluxesFunctor", nbCells, functor);
   }
 
   // actual update
   {
-    UpdateFunctor_ssprk2<dim> functor(params, data_in, U_RK1, data_out,
+    UpdateFunctor_ssprk2<dim> functor(kernel_params, data_in, U_RK1, data_out,
 				      Fluxes_x, Fluxes_y, Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("update");
+    Kokkos::parallel_for("UpdateFunctor_ssprk2", nbCells, functor);
+    Kokkos::Profiling::popRegion();
   }  
   
 } // SolverHydroMood::time_int_ssprk2
@@ -1167,21 +1349,23 @@ void SolverHydroMood<dim,degree>::time_int_ssprk3(DataArray data_in,
   // ==============================================
   // first step : U_RK1 = U_n + dt * fluxes(U_n)
   // ==============================================
+  m_workspace.begin_phase(PHASE_RECONSTRUCTION);
   // compute reconstruction polynomial coefficients of data_in
-  {
+  if (!coefficient_free) {
     
     ComputeReconstructionPolynomialFunctor<dim,degree,stencilId>
-      functor(params, monomialMap.data, data_in, PolyCoefs, stencil, geomMatrixPI_view);
-    Kokkos::parallel_for(nbCells,functor);
+      functor(kernel_params, monomialMap.data, data_in, PolyCoefs, stencil, geomMatrixPI_view);
+    ppkMHD::parallel_for_tuned("ComputeReconstructionPolynomialFunctor", nbCells,functor);
 
     // for (int icoef=0; icoef<ncoefs; ++icoef)
     //   save_data_debug(PolyCoefs[icoef], Uhost, m_times_saved-1, m_t, "poly"+std::to_string(icoef));
 
   }
 
+  m_workspace.begin_phase(PHASE_FLUXES);
   // compute fluxes to update data_in
   {
-    ComputeFluxesFunctor<dim,degree, stencilId> functor(params, monomialMap.data,
+    ComputeFluxesFunctor<dim,degree, stencilId> functor(kernel_params, monomialMap.data,
 							data_in, PolyCoefs,
 							Fluxes_x,
 							Fluxes_y,
@@ -1190,43 +1374,49 @@ void SolverHydroMood<dim,degree>::time_int_ssprk3(DataArray data_in,
 							geomMatrixPI_view,
 							QUAD_LOC_2D,
 							QUAD_LOC_3D,
+							face_weights,
 							dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ppkMHD::parallel_for_tuned("ComputeFluxesFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
 
     //save_data_debug(Fluxes_x, Uhost, m_times_saved, m_t, "flux_x");
     //save_data_debug(Fluxes_y, Uhost, m_times_saved, m_t, "flux_y");
   }
 
+  m_workspace.begin_phase(PHASE_FLAGS);
   // flag cells for which fluxes will need to be recomputed
   // because attemp to update leads to physically invalid values
   // (negative density or pressure)
   {  
-    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(params, monomialMap.data,
+    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 						      data_in,
 						      MoodFlags,
 						      Fluxes_x,
 						      Fluxes_y,
 						      Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMoodFlagsUpdateFunctor", nbCells, functor);
     //save_data_debug(MoodFlags, Uhost, m_times_saved, m_t, "mood_flags");
   }
   
   // recompute fluxes arround flagged cells
   {
-    RecomputeFluxesFunctor<dim,degree> functor(params, monomialMap.data,
+    RecomputeFluxesFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					       data_in, MoodFlags,
 					       Fluxes_x, Fluxes_y, Fluxes_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("RecomputeFluxesFunctor", nbCells, functor);
     //save_data_debug(Fluxes_x, Uhost, m_times_saved, m_t, "flux_x_after");
     //save_data_debug(Fluxes_y, Uhost, m_times_saved, m_t, "flux_y_after");
   }
 
   // update: U_RK1 = data_in + dt*fluxes
   {
-    UpdateFunctor<dim> functor(params, data_in, U_RK1,
+    UpdateFunctor<dim> functor(kernel_params, data_in, U_RK1,
 			       Fluxes_x, Fluxes_y, Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("update");
+    Kokkos::parallel_for("UpdateFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
   }
 
   make_boundaries(U_RK1);
@@ -1234,19 +1424,21 @@ void SolverHydroMood<dim,degree>::time_int_ssprk3(DataArray data_in,
   // ========================================================================
   // second step : U_RK2 = 3/4 * U_n + 1/4 * U_RK1 + 1/4 * dt * fluxes(U_RK1)
   // ========================================================================
+  m_workspace.begin_phase(PHASE_RECONSTRUCTION);
   // compute reconstruction polynomial coefficients of U_RK1
-  {
+  if (!coefficient_free) {
     
     ComputeReconstructionPolynomialFunctor<dim,degree,stencilId>
-      functor(params, monomialMap.data, U_RK1, PolyCoefs, stencil, geomMatrixPI_view);
-    Kokkos::parallel_for(nbCells,functor);
+      functor(kernel_params, monomialMap.data, U_RK1, PolyCoefs, stencil, geomMatrixPI_view);
+    ppkMHD::parallel_for_tuned("ComputeReconstructionPolynomialFunctor", nbCells,functor);
 
   }
 
+  m_workspace.begin_phase(PHASE_FLUXES);
   // compute fluxes (U_RK1)
   {
     
-    ComputeFluxesFunctor<dim,degree, stencilId> functor(params, monomialMap.data,
+    ComputeFluxesFunctor<dim,degree, stencilId> functor(kernel_params, monomialMap.data,
 							U_RK1, PolyCoefs,
 							Fluxes_x,
 							Fluxes_y,
@@ -1255,40 +1447,46 @@ void SolverHydroMood<dim,degree>::time_int_ssprk3(DataArray data_in,
 							geomMatrixPI_view,
 							QUAD_LOC_2D,
 							QUAD_LOC_3D,
+							face_weights,
 							dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ppkMHD::parallel_for_tuned("ComputeFluxesFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
 
   }
 
+  m_workspace.begin_phase(PHASE_FLAGS);
   // flag cells for which fluxes will need to be recomputed
   // because attemp to update leads to physically invalid values
   // (negative density or pressure)
   {  
-    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(params, monomialMap.data,
+    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 						      U_RK1,
 						      MoodFlags,
 						      Fluxes_x,
 						      Fluxes_y,
 						      Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMoodFlagsUpdateFunctor", nbCells, functor);
   }
   
   // recompute fluxes arround flagged cells
   {
-    RecomputeFluxesFunctor<dim,degree> functor(params, monomialMap.data,
+    RecomputeFluxesFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					       U_RK1, MoodFlags,
 					       Fluxes_x, Fluxes_y, Fluxes_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("RecomputeFluxesFunctor", nbCells, functor);
   }
 
   // actual update
   // U_RK2 =  3/4 U_n + 1/4 U_RK1 + 1/4 * dt * Flux(U_RK1) 
   {
-    UpdateFunctor_weight<dim> functor(params, data_in, U_RK1, U_RK2,
+    UpdateFunctor_weight<dim> functor(kernel_params, data_in, U_RK1, U_RK2,
 				      Fluxes_x, Fluxes_y, Fluxes_z,
 				      0.75, 0.25, 0.25);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("update");
+    Kokkos::parallel_for("UpdateFunctor_weight", nbCells, functor);
+    Kokkos::Profiling::popRegion();
   }  
 
   make_boundaries(U_RK2);
@@ -1296,19 +1494,21 @@ void SolverHydroMood<dim,degree>::time_int_ssprk3(DataArray data_in,
   // ============================================================================
   // thrird step : U_{n+1} = 1/3 * U_n + 2/3 * U_RK2 + 2/3 * dt * fluxes(U_RK2)
   // ============================================================================
+  m_workspace.begin_phase(PHASE_RECONSTRUCTION);
   // compute reconstruction polynomial coefficients of U_RK2
-  {
+  if (!coefficient_free) {
     
     ComputeReconstructionPolynomialFunctor<dim,degree,stencilId>
-      functor(params, monomialMap.data, U_RK2, PolyCoefs, stencil, geomMatrixPI_view);
-    Kokkos::parallel_for(nbCells,functor);
+      functor(kernel_params, monomialMap.data, U_RK2, PolyCoefs, stencil, geomMatrixPI_view);
+    ppkMHD::parallel_for_tuned("ComputeReconstructionPolynomialFunctor", nbCells,functor);
 
   }
 
+  m_workspace.begin_phase(PHASE_FLUXES);
   // compute fluxes (U_RK2)
   {
     
-    ComputeFluxesFunctor<dim,degree, stencilId> functor(params, monomialMap.data,
+    ComputeFluxesFunctor<dim,degree, stencilId> functor(kernel_params, monomialMap.data,
 							U_RK2, PolyCoefs,
 							Fluxes_x,
 							Fluxes_y,
@@ -1317,40 +1517,46 @@ void SolverHydroMood<dim,degree>::time_int_ssprk3(DataArray data_in,
 							geomMatrixPI_view,
 							QUAD_LOC_2D,
 							QUAD_LOC_3D,
+							face_weights,
 							dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ppkMHD::parallel_for_tuned("ComputeFluxesFunctor", nbCells, functor);
+    Kokkos::Profiling::popRegion();
 
   }
 
+  m_workspace.begin_phase(PHASE_FLAGS);
   // flag cells for which fluxes will need to be recomputed
   // because attemp to update leads to physically invalid values
   // (negative density or pressure)
   {  
-    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(params, monomialMap.data,
+    ComputeMoodFlagsUpdateFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 						      U_RK2,
 						      MoodFlags,
 						      Fluxes_x,
 						      Fluxes_y,
 						      Fluxes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMoodFlagsUpdateFunctor", nbCells, functor);
   }
   
   // recompute fluxes arround flagged cells
   {
-    RecomputeFluxesFunctor<dim,degree> functor(params, monomialMap.data,
+    RecomputeFluxesFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					       U_RK2, MoodFlags,
 					       Fluxes_x, Fluxes_y, Fluxes_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("RecomputeFluxesFunctor", nbCells, functor);
   }
 
   // actual update
   // U_{n+1} =  1/3 U_n + 2/3 U_RK2 + 2/3 * dt * Flux(U_RK2) 
   {
-    UpdateFunctor_weight<dim> functor(params, data_in, U_RK2, data_out,
+    UpdateFunctor_weight<dim> functor(kernel_params, data_in, U_RK2, data_out,
 				      Fluxes_x, Fluxes_y, Fluxes_z,
 				      1.0/3, 2.0/3, 2.0/3);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::Profiling::pushRegion("update");
+    Kokkos::parallel_for("UpdateFunctor_weight", nbCells, functor);
+    Kokkos::Profiling::popRegion();
   }  
 
 } // SolverHydroMood::time_int_ssprk3
@@ -1407,54 +1613,21 @@ template<int dim, int degree>
 template<int dim_>
 void SolverHydroMood<dim,degree>::make_boundaries(typename std::enable_if<dim_==2,DataArray2d>::type Udata)
 {
-  
-  const int ghostWidth=params.ghostWidth;
-  int nbIter = ghostWidth*std::max(isize,jsize);
+
+  using ppkMHD::FillGhostCellsFunctor;
 
   // wedge has a different border condition
   if (!m_problem_name.compare("wedge")) {
 
     WedgeParams wparams(configMap, m_t);
 
-    // call device functor
-    {
-      MakeBoundariesFunctor2D_wedge<FACE_XMIN> functor(params, wparams, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
-    {
-      MakeBoundariesFunctor2D_wedge<FACE_XMAX> functor(params, wparams, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
-    
-    {
-      MakeBoundariesFunctor2D_wedge<FACE_YMIN> functor(params, wparams, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
-    {
-      MakeBoundariesFunctor2D_wedge<FACE_YMAX> functor(params, wparams, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
+    FillGhostCellsFunctor<2,WedgeInflow>::apply(kernel_params, m_boundary_engine, m_boundary_engine.all(),
+						Udata, false, WedgeInflow(wparams, false));
 
   } else {
 
-    // call device functor
-    {
-      MakeBoundariesFunctor2D<FACE_XMIN> functor(params, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
-    {
-      MakeBoundariesFunctor2D<FACE_XMAX> functor(params, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
-    
-    {
-      MakeBoundariesFunctor2D<FACE_YMIN> functor(params, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
-    {
-      MakeBoundariesFunctor2D<FACE_YMAX> functor(params, Udata);
-      Kokkos::parallel_for(nbIter, functor);
-    }
+    FillGhostCellsFunctor<2>::apply(kernel_params, m_boundary_engine, m_boundary_engine.all(),
+				    Udata, false);
 
   }
   
@@ -1465,39 +1638,8 @@ template<int dim_>
 void SolverHydroMood<dim,degree>::make_boundaries(typename std::enable_if<dim_==3,DataArray3d>::type Udata)
 {
 
-  const int ghostWidth=params.ghostWidth;
-  
-  int max_size = std::max(isize,jsize);
-  max_size = std::max(max_size,ksize);
-  int nbIter = ghostWidth * max_size * max_size;
-  
-  // call device functor
-  {
-    MakeBoundariesFunctor3D<FACE_XMIN> functor(params, Udata);
-    Kokkos::parallel_for(nbIter, functor);
-  }  
-  {
-    MakeBoundariesFunctor3D<FACE_XMAX> functor(params, Udata);
-    Kokkos::parallel_for(nbIter, functor);
-  }
-  
-  {
-    MakeBoundariesFunctor3D<FACE_YMIN> functor(params, Udata);
-    Kokkos::parallel_for(nbIter, functor);
-  }
-  {
-    MakeBoundariesFunctor3D<FACE_YMAX> functor(params, Udata);
-    Kokkos::parallel_for(nbIter, functor);
-  }
-  
-  {
-    MakeBoundariesFunctor3D<FACE_ZMIN> functor(params, Udata);
-    Kokkos::parallel_for(nbIter, functor);
-  }
-  {
-    MakeBoundariesFunctor3D<FACE_ZMAX> functor(params, Udata);
-    Kokkos::parallel_for(nbIter, functor);
-  }
+  ppkMHD::FillGhostCellsFunctor<3>::apply(kernel_params, m_boundary_engine, m_boundary_engine.all(),
+					  Udata, false);
 
 } // SolverHydroMood::make_boundaries
 
@@ -1511,8 +1653,8 @@ template<int dim, int degree>
 void SolverHydroMood<dim,degree>::init_implode(DataArray Udata)
 {
 
-  InitImplodeFunctor<dim,degree> functor(params, monomialMap.data, Udata);
-  Kokkos::parallel_for(nbCells, functor);
+  InitImplodeFunctor<dim,degree> functor(kernel_params, monomialMap.data, Udata);
+  Kokkos::parallel_for("InitImplodeFunctor", nbCells, functor);
   
 } // init_implode
 
@@ -1528,8 +1670,8 @@ void SolverHydroMood<dim,degree>::init_blast(DataArray Udata)
 
   BlastParams blastParams = BlastParams(configMap);
   
-  InitBlastFunctor<dim,degree> functor(params, monomialMap.data, blastParams, Udata);
-  Kokkos::parallel_for(nbCells, functor);
+  InitBlastFunctor<dim,degree> functor(kernel_params, monomialMap.data, blastParams, Udata);
+  Kokkos::parallel_for("InitBlastFunctor", nbCells, functor);
 
 } // SolverHydroMood::init_blast
 
@@ -1558,11 +1700,11 @@ void SolverHydroMood<dim,degree>::init_four_quadrant(DataArray Udata)
   ppkMHD::primToCons_2D(U2, params.settings.gamma0);
   ppkMHD::primToCons_2D(U3, params.settings.gamma0);
   
-  InitFourQuadrantFunctor<dim,degree> functor(params, monomialMap.data,
+  InitFourQuadrantFunctor<dim,degree> functor(kernel_params, monomialMap.data,
 					      Udata,
 					      U0, U1, U2, U3,
 					      xt, yt);
-  Kokkos::parallel_for(nbCells, functor);
+  Kokkos::parallel_for("InitFourQuadrantFunctor", nbCells, functor);
     
 } // init_four_quadrant
 
@@ -1578,11 +1720,11 @@ void SolverHydroMood<dim,degree>::init_kelvin_helmholtz(DataArray Udata)
 
   KHParams khParams = KHParams(configMap);
 
-  InitKelvinHelmholtzFunctor<dim,degree> functor(params,
+  InitKelvinHelmholtzFunctor<dim,degree> functor(kernel_params,
 						 monomialMap.data,
 						 khParams,
 						 Udata);
-  Kokkos::parallel_for(nbCells, functor);
+  Kokkos::parallel_for("InitKelvinHelmholtzFunctor", nbCells, functor);
 
 } // SolverHydroMood::init_kelvin_helmholtz
 
@@ -1598,8 +1740,8 @@ void SolverHydroMood<dim,degree>::init_wedge(DataArray Udata)
 
   WedgeParams wparams(configMap, 0.0);
   
-  InitWedgeFunctor<dim,degree> functor(params, monomialMap.data, wparams, Udata);
-  Kokkos::parallel_for(nbCells, functor);
+  InitWedgeFunctor<dim,degree> functor(kernel_params, monomialMap.data, wparams, Udata);
+  Kokkos::parallel_for("InitWedgeFunctor", nbCells, functor);
   
 } // init_wedge
 
@@ -1616,8 +1758,8 @@ void SolverHydroMood<dim,degree>::init_isentropic_vortex(DataArray Udata)
 
   IsentropicVortexParams iparams(configMap);
 
-  InitIsentropicVortexFunctor<dim,degree> functor(params, monomialMap.data, iparams, Udata);
-  Kokkos::parallel_for(nbCells, functor);
+  InitIsentropicVortexFunctor<dim,degree> functor(kernel_params, monomialMap.data, iparams, Udata);
+  Kokkos::parallel_for("InitIsentropicVortexFunctor", nbCells, functor);
   
 } // init_isentropic_vortex
 
@@ -1628,11 +1770,14 @@ void SolverHydroMood<dim,degree>::save_solution_impl()
 {
 
   timers[TIMER_IO]->start();
+  Kokkos::Profiling::pushRegion("io");
+  allocate_host_mirror(U, Uhost);
   if (m_iteration % 2 == 0)
     save_data(U,  Uhost, m_times_saved, m_t);
   else
     save_data(U2, Uhost, m_times_saved, m_t);
   
+  Kokkos::Profiling::popRegion();
   timers[TIMER_IO]->stop();
     
 } // SolverHydroMood::save_solution_impl()
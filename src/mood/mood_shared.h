@@ -11,6 +11,15 @@ using mood_matrix_pi_t = Kokkos::View<real_t**,Device>;
 //! data type for the mood pseudo-inverse matrix on HOST
 using mood_matrix_pi_host_t = mood_matrix_pi_t::HostMirror;
 
+/**
+ * data type for the reconstruction weights at face quadrature points:
+ * (direction, face, quadrature point, stencil point).
+ */
+using mood_face_weights_t = Kokkos::View<real_t****,Device>;
+
+//! data type for the reconstruction weights on HOST
+using mood_face_weights_host_t = mood_face_weights_t::HostMirror;
+
 } // namespace mood
 
 #endif // MOOD_SHARED_H_
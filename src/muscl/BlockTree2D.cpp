@@ -0,0 +1,337 @@
+#include <algorithm>
+
+#include "muscl/BlockTree2D.h"
+
+namespace ppkMHD { namespace muscl {
+
+// =======================================================
+// ==== CLASS BlockTree2D IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+BlockTree2D::BlockTree2D(int nbx, int nby, int max_level,
+			 bool periodic_x, bool periodic_y) :
+  m_nbx(nbx),
+  m_nby(nby),
+  m_max_level(max_level),
+  m_periodic_x(periodic_x),
+  m_periodic_y(periodic_y),
+  m_blocks(),
+  m_levels(),
+  m_nb_leaves(),
+  m_index()
+{
+
+  // start with a uniform level 0
+  std::vector<BlockKey> leaves;
+  for (int bj=0; bj<nby; ++bj)
+    for (int bi=0; bi<nbx; ++bi)
+      leaves.push_back(BlockKey{0, bi, bj});
+
+  build(leaves);
+
+} // BlockTree2D::BlockTree2D
+
+// =======================================================
+// =======================================================
+int BlockTree2D::nb_leaves() const
+{
+
+  int nb = 0;
+  for (int level=0; level<nb_levels(); ++level)
+    nb += m_nb_leaves[level];
+
+  return nb;
+
+} // BlockTree2D::nb_leaves
+
+// =======================================================
+// =======================================================
+uint64_t BlockTree2D::morton(int bi, int bj)
+{
+
+  uint64_t key = 0;
+  for (int bit=0; bit<32; ++bit) {
+    key |= ((uint64_t) ((bi >> bit) & 1)) << (2*bit);
+    key |= ((uint64_t) ((bj >> bit) & 1)) << (2*bit+1);
+  }
+
+  return key;
+
+} // BlockTree2D::morton
+
+// =======================================================
+// =======================================================
+std::vector<int> BlockTree2D::partition(int nb_parts) const
+{
+
+  // leaves along the Morton curve of the finest level
+  std::vector<int> leaf_ids;
+  for (int id=0; id<nb_blocks(); ++id)
+    if (m_blocks[id].is_leaf())
+      leaf_ids.push_back(id);
+
+  auto finest_key = [this](int id) -> uint64_t {
+    const BlockKey& key = m_blocks[id].key;
+    const int shift = m_max_level - key.level;
+    return morton(key.bi << shift, key.bj << shift);
+  };
+  std::sort(leaf_ids.begin(), leaf_ids.end(),
+	    [&finest_key](int a, int b) { return finest_key(a) < finest_key(b); });
+
+  std::vector<int> part(nb_blocks(), 0);
+
+  const long long nb = leaf_ids.size();
+  for (long long n=0; n<nb; ++n)
+    part[leaf_ids[n]] = (int) (n * nb_parts / nb);
+
+  // parents, from the finest level: part of their first child
+  for (int level=nb_levels()-1; level>=0; --level)
+    for (int id : m_levels[level])
+      if (!m_blocks[id].is_leaf())
+	part[id] = part[m_blocks[id].children[0]];
+
+  return part;
+
+} // BlockTree2D::partition
+
+// =======================================================
+// =======================================================
+bool BlockTree2D::wrap(int level, int& bi, int& bj) const
+{
+
+  const int nx = nbx(level);
+  const int ny = nby(level);
+
+  if (bi < 0 or bi >= nx) {
+    if (!m_periodic_x)
+      return false;
+    bi = ((bi % nx) + nx) % nx;
+  }
+
+  if (bj < 0 or bj >= ny) {
+    if (!m_periodic_y)
+      return false;
+    bj = ((bj % ny) + ny) % ny;
+  }
+
+  return true;
+
+} // BlockTree2D::wrap
+
+// =======================================================
+// =======================================================
+int BlockTree2D::find(int level, int bi, int bj) const
+{
+
+  if (level < 0 or !wrap(level, bi, bj))
+    return -1;
+
+  auto it = m_index.find(BlockKey{level, bi, bj});
+
+  return it == m_index.end() ? -1 : it->second;
+
+} // BlockTree2D::find
+
+// =======================================================
+// =======================================================
+void BlockTree2D::build(const std::vector<BlockKey>& leaves)
+{
+
+  // leaves and all their ancestors
+  std::map<BlockKey, int> keys;
+  for (BlockKey key : leaves) {
+    keys[key] = 1;
+    while (key.level > 0) {
+      key = BlockKey{key.level-1, key.bi >> 1, key.bj >> 1};
+      if (keys.count(key))
+	break;
+      keys[key] = 0;
+    }
+  }
+
+  m_blocks.clear();
+  m_index.clear();
+
+  // keys are sorted by level, so that parents are created first
+  for (const auto& it : keys) {
+    const BlockKey& key = it.first;
+
+    Block b;
+    b.key = key;
+    b.parent = -1;
+    b.children[0] = b.children[1] = b.children[2] = b.children[3] = -1;
+    b.slot = -1;
+
+    const int id = m_blocks.size();
+
+    if (key.level > 0) {
+      b.parent = m_index[BlockKey{key.level-1, key.bi >> 1, key.bj >> 1}];
+      const int q = (key.bi & 1) + 2 * (key.bj & 1);
+      m_blocks[b.parent].children[q] = id;
+    }
+
+    m_blocks.push_back(b);
+    m_index[key] = id;
+  }
+
+  // slots: leaves then parents of each level, along the Morton curve
+  int nb_levels = 0;
+  for (const Block& b : m_blocks)
+    nb_levels = std::max(nb_levels, b.key.level+1);
+
+  m_levels.assign(nb_levels, std::vector<int>());
+  m_nb_leaves.assign(nb_levels, 0);
+
+  for (int level=0; level<nb_levels; ++level) {
+
+    std::vector<int> leaf_ids, parent_ids;
+    for (int id=0; id<nb_blocks(); ++id) {
+      if (m_blocks[id].key.level != level)
+	continue;
+      if (m_blocks[id].is_leaf())
+	leaf_ids.push_back(id);
+      else
+	parent_ids.push_back(id);
+    }
+
+    auto morton_order = [this](int a, int b) {
+      return morton(m_blocks[a].key.bi, m_blocks[a].key.bj) <
+	morton(m_blocks[b].key.bi, m_blocks[b].key.bj);
+    };
+    std::sort(leaf_ids.begin(),   leaf_ids.end(),   morton_order);
+    std::sort(parent_ids.begin(), parent_ids.end(), morton_order);
+
+    std::vector<int>& ids = m_levels[level];
+    ids = leaf_ids;
+    ids.insert(ids.end(), parent_ids.begin(), parent_ids.end());
+
+    for (int s=0; s<(int) ids.size(); ++s)
+      m_blocks[ids[s]].slot = s;
+
+    m_nb_leaves[level] = leaf_ids.size();
+  }
+
+} // BlockTree2D::build
+
+// =======================================================
+// =======================================================
+bool BlockTree2D::adapt(std::vector<int>& flags)
+{
+
+  flags.resize(nb_blocks(), KEEP);
+
+  for (int id=0; id<nb_blocks(); ++id) {
+    const Block& b = m_blocks[id];
+    if (!b.is_leaf() or
+	(flags[id] == REFINE  and b.key.level == m_max_level) or
+	(flags[id] == COARSEN and b.key.level == 0))
+      flags[id] = KEEP;
+  }
+
+  /*
+   * 1. a refined leaf can't be next to a coarser leaf: refine the
+   * coarser one too, until nothing changes.
+   */
+  bool changed = true;
+  while (changed) {
+    changed = false;
+
+    for (int id=0; id<nb_blocks(); ++id) {
+      if (flags[id] != REFINE)
+	continue;
+
+      const BlockKey& key = m_blocks[id].key;
+
+      for (int dj=-1; dj<=1; ++dj) {
+	for (int di=-1; di<=1; ++di) {
+	  int ni = key.bi+di, nj = key.bj+dj;
+	  if (!wrap(key.level, ni, nj) or find(key.level, ni, nj) >= 0)
+	    continue;
+
+	  // covered by a coarser leaf
+	  const int c = find(key.level-1, ni >> 1, nj >> 1);
+	  if (c >= 0 and flags[c] != REFINE) {
+	    flags[c] = REFINE;
+	    changed = true;
+	  }
+	}
+      }
+    }
+  }
+
+  /*
+   * 2. siblings are merged when all of them agree, and when none of
+   * their neighbors is (or will be) finer.
+   */
+  std::vector<bool> coarsen(nb_blocks(), false);
+  bool coarsened = false;
+
+  for (int p=0; p<nb_blocks(); ++p) {
+    const Block& parent = m_blocks[p];
+    if (parent.is_leaf())
+      continue;
+
+    bool ok = true;
+    for (int q=0; q<4 and ok; ++q) {
+      const int c = parent.children[q];
+      ok = m_blocks[c].is_leaf() and flags[c] == COARSEN;
+    }
+
+    for (int q=0; q<4 and ok; ++q) {
+      const BlockKey& key = m_blocks[parent.children[q]].key;
+
+      for (int dj=-1; dj<=1 and ok; ++dj) {
+	for (int di=-1; di<=1 and ok; ++di) {
+	  const int n = find(key.level, key.bi+di, key.bj+dj);
+	  if (n >= 0 and (!m_blocks[n].is_leaf() or flags[n] == REFINE))
+	    ok = false;
+	}
+      }
+    }
+
+    coarsen[p] = ok;
+    coarsened = coarsened or ok;
+  }
+
+  /*
+   * 3. new set of leaves
+   */
+  std::vector<BlockKey> leaves;
+  bool refined = false;
+
+  for (int id=0; id<nb_blocks(); ++id) {
+    const Block& b = m_blocks[id];
+
+    if (coarsen[id]) {
+      leaves.push_back(b.key);
+      continue;
+    }
+
+    if (!b.is_leaf() or (b.parent >= 0 and coarsen[b.parent]))
+      continue;
+
+    if (flags[id] == REFINE) {
+      refined = true;
+      for (int q=0; q<4; ++q)
+	leaves.push_back(BlockKey{b.key.level+1,
+	      2*b.key.bi + (q & 1),
+	      2*b.key.bj + (q >> 1)});
+    } else {
+      leaves.push_back(b.key);
+    }
+  }
+
+  if (!refined and !coarsened)
+    return false;
+
+  build(leaves);
+
+  return true;
+
+} // BlockTree2D::adapt
+
+} // namespace muscl
+
+} // namespace ppkMHD
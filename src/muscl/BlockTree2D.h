@@ -0,0 +1,159 @@
+/**
+ * \file BlockTree2D.h
+ * \brief Host-side quadtree of fixed-size blocks used by the adaptive
+ * mesh refinement MUSCL solver (see SolverHydroMusclAMR2D.h).
+ */
+#ifndef BLOCK_TREE_2D_H_
+#define BLOCK_TREE_2D_H_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace ppkMHD { namespace muscl {
+
+/**
+ * Location of a block: refinement level and block coordinates at that
+ * level (level l has nbx*2^l x nby*2^l possible blocks).
+ */
+struct BlockKey
+{
+  int level;
+  int bi, bj;
+
+  bool operator<(const BlockKey& other) const
+  {
+    if (level != other.level) return level < other.level;
+    if (bi != other.bi)       return bi < other.bi;
+    return bj < other.bj;
+  }
+}; // struct BlockKey
+
+/**
+ * A block of the tree.
+ *
+ * Children are numbered qx + 2*qy, with (qx,qy) the quadrant in the
+ * parent block.
+ */
+struct Block
+{
+  BlockKey key;
+  int parent;      //!< block id of the parent, -1 on level 0
+  int children[4]; //!< block ids of the children, -1 for a leaf
+  int slot;        //!< position in the data pool of its level
+
+  bool is_leaf() const { return children[0] < 0; }
+}; // struct Block
+
+/**
+ * Quadtree of blocks over a nbx x nby array of level 0 blocks.
+ *
+ * Every block (leaf or not) has data: leaves are the blocks actually
+ * updated, the others hold the average of their children.
+ *
+ * The tree is always 2:1 balanced: two leaves sharing a face or a corner
+ * (periodic borders included) differ by at most one level.
+ *
+ * Blocks of a level are stored in a data pool in the following order
+ * (slot): leaves first, then parents; each group follows the Morton
+ * (Z-order) space-filling curve, so that neighbor blocks are close in
+ * memory.
+ */
+class BlockTree2D
+{
+
+public:
+  BlockTree2D(int nbx, int nby, int max_level,
+	      bool periodic_x, bool periodic_y);
+
+  //! flags used by adapt
+  enum {
+    COARSEN = -1,
+    KEEP    =  0,
+    REFINE  =  1
+  };
+
+  int nb_blocks() const { return m_blocks.size(); }
+  const Block& block(int id) const { return m_blocks[id]; }
+
+  //! finest level in use + 1
+  int nb_levels() const { return m_levels.size(); }
+
+  //! number of leaves / blocks on a level
+  int nb_leaves(int level) const { return m_nb_leaves[level]; }
+  int nb_slots(int level) const { return m_levels[level].size(); }
+
+  //! total number of leaves
+  int nb_leaves() const;
+
+  //! block ids of a level, in slot order
+  const std::vector<int>& level_blocks(int level) const { return m_levels[level]; }
+
+  //! number of blocks along x / y on a level
+  int nbx(int level) const { return m_nbx << level; }
+  int nby(int level) const { return m_nby << level; }
+
+  int max_level() const { return m_max_level; }
+
+  /**
+   * Apply periodicity to block coordinates.
+   * \return false when the location is outside of a non periodic border
+   */
+  bool wrap(int level, int& bi, int& bj) const;
+
+  /**
+   * Block at a given location (periodicity is applied).
+   * \return block id, -1 when outside the domain or not refined that far
+   */
+  int find(int level, int bi, int bj) const;
+
+  /**
+   * Refine / coarsen leaves according to flags (one per block id, only
+   * read on leaves). Flags are modified to keep the tree 2:1 balanced:
+   * extra refinements are added, and coarsening is only done when the 4
+   * siblings agree and no finer neighbor prevents it.
+   *
+   * Block ids and slots are re-assigned when something changed.
+   *
+   * \return true if the tree changed
+   */
+  bool adapt(std::vector<int>& flags);
+
+  //! Morton key of block coordinates
+  static uint64_t morton(int bi, int bj);
+
+  /**
+   * Split blocks in nb_parts parts along the Morton curve: leaves,
+   * ordered by the Morton key of their corner on the finest level, are
+   * dealt in contiguous ranges of (almost) equal size; a parent goes with
+   * its first child (quadrant 0), i.e. with the first leaf of its
+   * subtree.
+   *
+   * \return part of each block id
+   */
+  std::vector<int> partition(int nb_parts) const;
+
+private:
+  //! rebuild blocks from a set of leaves (ancestors are created)
+  void build(const std::vector<BlockKey>& leaves);
+
+  int  m_nbx, m_nby;
+  int  m_max_level;
+  bool m_periodic_x, m_periodic_y;
+
+  std::vector<Block> m_blocks;
+
+  //! block ids of each level, in slot order
+  std::vector<std::vector<int> > m_levels;
+  std::vector<int> m_nb_leaves;
+
+  //! location -> block id
+  std::map<BlockKey, int> m_index;
+
+}; // class BlockTree2D
+
+} // namespace muscl
+
+} // namespace ppkMHD
+
+#endif // BLOCK_TREE_2D_H_
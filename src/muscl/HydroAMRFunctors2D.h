@@ -0,0 +1,873 @@
+/**
+ * \file HydroAMRFunctors2D.h
+ * \brief Device functors managing the block data pools of the adaptive
+ * mesh refinement MUSCL solver (see SolverHydroMusclAMR2D.h).
+ *
+ * All blocks of a level are stacked along Y in a single DataArray2d
+ * (the pool): block in slot s covers rows [s*Bj, (s+1)*Bj), ghost cells
+ * included. The regular MUSCL functors can then process all blocks of a
+ * level in a single launch.
+ */
+#ifndef HYDRO_AMR_FUNCTORS_2D_H_
+#define HYDRO_AMR_FUNCTORS_2D_H_
+
+#include "shared/kokkos_shared.h"
+#include "muscl/HydroBaseFunctor2D.h"
+
+namespace ppkMHD { namespace muscl {
+
+//! integer tables (one line per block or per task)
+using AMRTable = Kokkos::View<int**, Device>;
+
+//! one value per block
+using AMRBlockArray = Kokkos::View<real_t*, Device>;
+
+//! whole blocks one after the other (MPI exchange buffers)
+using AMRBuffer = Kokkos::View<real_storage_t*, Device>;
+
+/**
+ * How the ghost cells of a block in a given direction are filled.
+ */
+enum AMRNeighborType {
+  AMR_NB_SAME     = 0, //!< copy from a block of the same level
+  AMR_NB_COARSE   = 1, //!< interpolate from a block of the coarser level
+  AMR_NB_BOUNDARY = 2  //!< physical border condition
+};
+
+/**
+ * Geometry of a level pool, as seen by device functors.
+ *
+ * Interior cells of a block are i in [gw,gw+bx), j in [gw,gw+by).
+ */
+struct AMRLevelInfo
+{
+  int bx, by;   //!< interior block sizes
+  int gw;       //!< ghost width
+  int Bi, Bj;   //!< block sizes with ghosts
+  int nbx, nby; //!< number of blocks along x / y covering the domain
+  int nb_slots; //!< number of blocks in the pool
+}; // struct AMRLevelInfo
+
+/**
+ * minmod slope limiter.
+ */
+KOKKOS_INLINE_FUNCTION
+real_t amr_minmod(real_t a, real_t b)
+{
+  if (a*b <= 0)
+    return 0;
+  return FABS(a) < FABS(b) ? a : b;
+}
+
+/**
+ * Conservative linear interpolation (minmod limited slopes) of coarse
+ * cell (i,j) at offset (sx,sy) (in coarse cell units, i.e. +/- 1/4 for
+ * the 4 fine cells).
+ */
+KOKKOS_INLINE_FUNCTION
+real_t amr_prolong(const DataArray2d& Uc, int i, int j, int ivar,
+		   real_t sx, real_t sy)
+{
+  const real_t u = Uc(i,j,ivar);
+  const real_t dux = amr_minmod(Uc(i+1,j,ivar)-u, u-Uc(i-1,j,ivar));
+  const real_t duy = amr_minmod(Uc(i,j+1,ivar)-u, u-Uc(i,j-1,ivar));
+
+  return u + sx*dux + sy*duy;
+}
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRFillGhostsFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Fill ghost cells of all blocks of a level from the neighbor blocks:
+   * copy from blocks of the same level, conservative interpolation from
+   * blocks of the coarser level (which ghost cells must be up to date).
+   *
+   * Ghost cells outside of a non periodic border are left untouched (see
+   * AMRPhysicalBoundariesFunctor2D).
+   *
+   * \param[in,out] Udata level pool
+   * \param[in] Ucoarse coarser level pool (unused on level 0)
+   * \param[in] neighbor neighbor block slot, for each of the 9 directions
+   * (di+1)+3*(dj+1)
+   * \param[in] neighbor_type see AMRNeighborType
+   * \param[in] coords block coordinates of each slot
+   * \param[in] coords_coarse block coordinates of coarser level slots
+   */
+  AMRFillGhostsFunctor2D(KernelParams params,
+			 AMRLevelInfo info,
+			 DataArray2d  Udata,
+			 DataArray2d  Ucoarse,
+			 AMRTable     neighbor,
+			 AMRTable     neighbor_type,
+			 AMRTable     coords,
+			 AMRTable     coords_coarse) :
+    HydroBaseFunctor2D(params), info(info),
+    Udata(Udata), Ucoarse(Ucoarse),
+    neighbor(neighbor), neighbor_type(neighbor_type),
+    coords(coords), coords_coarse(coords_coarse) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Udata,
+		    DataArray2d  Ucoarse,
+		    AMRTable     neighbor,
+		    AMRTable     neighbor_type,
+		    AMRTable     coords,
+		    AMRTable     coords_coarse)
+  {
+    int nbCells = info.Bi * info.Bj * info.nb_slots;
+    AMRFillGhostsFunctor2D functor(params, info, Udata, Ucoarse,
+				   neighbor, neighbor_type,
+				   coords, coords_coarse);
+    Kokkos::parallel_for("AMRFillGhostsFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int by = info.by;
+    const int Bj = info.Bj;
+
+    int i, jj;
+    index2coord(index, i, jj, info.Bi, Bj*info.nb_slots);
+
+    const int slot = jj / Bj;
+    const int j = jj - slot*Bj;
+
+    const int di = i < gw ? -1 : (i >= gw+bx ? 1 : 0);
+    const int dj = j < gw ? -1 : (j >= gw+by ? 1 : 0);
+
+    if (di == 0 and dj == 0)
+      return;
+
+    const int dir = (di+1) + 3*(dj+1);
+    const int n = neighbor(slot,dir);
+
+    if (neighbor_type(slot,dir) == AMR_NB_SAME) {
+
+      const int i0 = i - di*bx;
+      const int j0 = n*Bj + j - dj*by;
+
+      for (int ivar=0; ivar<nbvar; ++ivar)
+	Udata(i,jj,ivar) = Udata(i0,j0,ivar);
+
+    } else if (neighbor_type(slot,dir) == AMR_NB_COARSE) {
+
+      // cell location on this level (periodic borders are wrapped)
+      const int nx = info.nbx*bx;
+      const int ny = info.nby*by;
+      const int gi = (coords(slot,0)*bx + i-gw + nx) % nx;
+      const int gj = (coords(slot,1)*by + j-gw + ny) % ny;
+
+      // coarse cell containing it
+      const int ic = (gi >> 1) - coords_coarse(n,0)*bx + gw;
+      const int jc = (gj >> 1) - coords_coarse(n,1)*by + gw + n*Bj;
+
+      const real_t sx = (gi & 1) ? 0.25 : -0.25;
+      const real_t sy = (gj & 1) ? 0.25 : -0.25;
+
+      for (int ivar=0; ivar<nbvar; ++ivar)
+	Udata(i,jj,ivar) = amr_prolong(Ucoarse, ic, jc, ivar, sx, sy);
+
+    }
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Udata;
+  DataArray2d  Ucoarse;
+  AMRTable     neighbor;
+  AMRTable     neighbor_type;
+  AMRTable     coords;
+  AMRTable     coords_coarse;
+
+}; // AMRFillGhostsFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRPhysicalBoundariesFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Fill ghost cells of blocks located outside of a non periodic border
+   * (reflecting or absorbing, same conventions as
+   * FillGhostCellsFunctor).
+   *
+   * Must be called after AMRFillGhostsFunctor2D: corner ghost cells
+   * outside along a single direction are mirrored onto ghost cells
+   * filled from a neighbor block.
+   */
+  AMRPhysicalBoundariesFunctor2D(KernelParams params,
+				 AMRLevelInfo info,
+				 DataArray2d  Udata,
+				 AMRTable     coords) :
+    HydroBaseFunctor2D(params), info(info),
+    Udata(Udata), coords(coords) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Udata,
+		    AMRTable     coords)
+  {
+    int nbCells = info.Bi * info.Bj * info.nb_slots;
+    AMRPhysicalBoundariesFunctor2D functor(params, info, Udata, coords);
+    Kokkos::parallel_for("AMRPhysicalBoundariesFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int by = info.by;
+    const int Bj = info.Bj;
+
+    int i, jj;
+    index2coord(index, i, jj, info.Bi, Bj*info.nb_slots);
+
+    const int slot = jj / Bj;
+    const int j = jj - slot*Bj;
+
+    int i0 = i, j0 = j;
+    real_t sign_u = 1.0, sign_v = 1.0;
+    bool outside = false;
+
+    if (i < gw and coords(slot,0) == 0 and
+	params.boundary_type_xmin != BC_PERIODIC) {
+      outside = true;
+      if (params.boundary_type_xmin == BC_DIRICHLET) {
+	i0 = 2*gw-1-i;
+	sign_u = -1.0;
+      } else {
+	i0 = gw;
+      }
+    }
+
+    if (i >= gw+bx and coords(slot,0) == info.nbx-1 and
+	params.boundary_type_xmax != BC_PERIODIC) {
+      outside = true;
+      if (params.boundary_type_xmax == BC_DIRICHLET) {
+	i0 = 2*bx+2*gw-1-i;
+	sign_u = -1.0;
+      } else {
+	i0 = bx+gw-1;
+      }
+    }
+
+    if (j < gw and coords(slot,1) == 0 and
+	params.boundary_type_ymin != BC_PERIODIC) {
+      outside = true;
+      if (params.boundary_type_ymin == BC_DIRICHLET) {
+	j0 = 2*gw-1-j;
+	sign_v = -1.0;
+      } else {
+	j0 = gw;
+      }
+    }
+
+    if (j >= gw+by and coords(slot,1) == info.nby-1 and
+	params.boundary_type_ymax != BC_PERIODIC) {
+      outside = true;
+      if (params.boundary_type_ymax == BC_DIRICHLET) {
+	j0 = 2*by+2*gw-1-j;
+	sign_v = -1.0;
+      } else {
+	j0 = by+gw-1;
+      }
+    }
+
+    if (!outside)
+      return;
+
+    j0 += slot*Bj;
+
+    for (int ivar=0; ivar<nbvar; ++ivar) {
+      real_t sign = ivar==IU ? sign_u : (ivar==IV ? sign_v : 1.0);
+      Udata(i,jj,ivar) = Udata(i0,j0,ivar)*sign;
+    }
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Udata;
+  AMRTable     coords;
+
+}; // AMRPhysicalBoundariesFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRRestrictFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Average fine blocks into their parent (the parents of a level owned
+   * by the process, stored after its leaves and remote leaf copies).
+   *
+   * \param[out] Ucoarse parent level pool
+   * \param[in] Ufine children level pool
+   * \param[in] children children slots of each parent slot
+   * \param[in] first_parent slot of the first parent
+   * \param[in] nb_parents number of parents
+   */
+  AMRRestrictFunctor2D(KernelParams params,
+		       AMRLevelInfo info,
+		       DataArray2d  Ucoarse,
+		       DataArray2d  Ufine,
+		       AMRTable     children,
+		       int          first_parent) :
+    HydroBaseFunctor2D(params), info(info),
+    Ucoarse(Ucoarse), Ufine(Ufine),
+    children(children), first_parent(first_parent) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Ucoarse,
+		    DataArray2d  Ufine,
+		    AMRTable     children,
+		    int          first_parent,
+		    int          nb_parents)
+  {
+    int nbCells = info.bx * info.by * nb_parents;
+    AMRRestrictFunctor2D functor(params, info, Ucoarse, Ufine,
+				 children, first_parent);
+    Kokkos::parallel_for("AMRRestrictFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int by = info.by;
+    const int Bj = info.Bj;
+
+    const int slot = first_parent + index / (bx*by);
+    const int r    = index % (bx*by);
+    const int i    = gw + r % bx;
+    const int j    = gw + r / bx;
+
+    const int qx = (i-gw) >= bx/2 ? 1 : 0;
+    const int qy = (j-gw) >= by/2 ? 1 : 0;
+    const int child = children(slot, qx + 2*qy);
+
+    const int fi = gw + 2*(i-gw-qx*bx/2);
+    const int fj = gw + 2*(j-gw-qy*by/2) + child*Bj;
+
+    for (int ivar=0; ivar<nbvar; ++ivar)
+      Ucoarse(i,j+slot*Bj,ivar) = 0.25 * (Ufine(fi  ,fj  ,ivar) +
+					   Ufine(fi+1,fj  ,ivar) +
+					   Ufine(fi  ,fj+1,ivar) +
+					   Ufine(fi+1,fj+1,ivar));
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Ucoarse;
+  DataArray2d  Ufine;
+  AMRTable     children;
+  int          first_parent;
+
+}; // AMRRestrictFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRProlongFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Initialize newly created blocks by conservative interpolation of
+   * their parent (which ghost cells must be up to date).
+   *
+   * \param[out] Ufine level pool of the new blocks
+   * \param[in] Ucoarse parent level pool
+   * \param[in] tasks one line per new block: slot, parent slot, quadrant
+   */
+  AMRProlongFunctor2D(KernelParams params,
+		      AMRLevelInfo info,
+		      DataArray2d  Ufine,
+		      DataArray2d  Ucoarse,
+		      AMRTable     tasks) :
+    HydroBaseFunctor2D(params), info(info),
+    Ufine(Ufine), Ucoarse(Ucoarse), tasks(tasks) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Ufine,
+		    DataArray2d  Ucoarse,
+		    AMRTable     tasks)
+  {
+    int nbCells = info.bx * info.by * tasks.extent(0);
+    AMRProlongFunctor2D functor(params, info, Ufine, Ucoarse, tasks);
+    Kokkos::parallel_for("AMRProlongFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int by = info.by;
+    const int Bj = info.Bj;
+
+    const int task = index / (bx*by);
+    const int r    = index % (bx*by);
+    const int i    = gw + r % bx;
+    const int j    = gw + r / bx;
+
+    const int slot   = tasks(task,0);
+    const int parent = tasks(task,1);
+    const int qx     = tasks(task,2) & 1;
+    const int qy     = tasks(task,2) >> 1;
+
+    const int ic = gw + qx*bx/2 + (i-gw)/2;
+    const int jc = gw + qy*by/2 + (j-gw)/2 + parent*Bj;
+
+    const real_t sx = ((i-gw) & 1) ? 0.25 : -0.25;
+    const real_t sy = ((j-gw) & 1) ? 0.25 : -0.25;
+
+    for (int ivar=0; ivar<nbvar; ++ivar)
+      Ufine(i,j+slot*Bj,ivar) = amr_prolong(Ucoarse, ic, jc, ivar, sx, sy);
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Ufine;
+  DataArray2d  Ucoarse;
+  AMRTable     tasks;
+
+}; // AMRProlongFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRCopyBlocksFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Copy whole blocks (ghost cells included) from a pool to another.
+   *
+   * \param[out] Udst destination pool
+   * \param[in] Usrc source pool
+   * \param[in] tasks one line per block: destination slot, source slot
+   */
+  AMRCopyBlocksFunctor2D(KernelParams params,
+			 AMRLevelInfo info,
+			 DataArray2d  Udst,
+			 DataArray2d  Usrc,
+			 AMRTable     tasks) :
+    HydroBaseFunctor2D(params), info(info),
+    Udst(Udst), Usrc(Usrc), tasks(tasks) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Udst,
+		    DataArray2d  Usrc,
+		    AMRTable     tasks)
+  {
+    int nbCells = info.Bi * info.Bj * tasks.extent(0);
+    AMRCopyBlocksFunctor2D functor(params, info, Udst, Usrc, tasks);
+    Kokkos::parallel_for("AMRCopyBlocksFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int Bi = info.Bi;
+    const int Bj = info.Bj;
+
+    const int task = index / (Bi*Bj);
+    const int r    = index % (Bi*Bj);
+    const int i    = r % Bi;
+    const int j    = r / Bi;
+
+    const int jdst = j + tasks(task,0)*Bj;
+    const int jsrc = j + tasks(task,1)*Bj;
+
+    for (int ivar=0; ivar<nbvar; ++ivar)
+      Udst(i,jdst,ivar) = Usrc(i,jsrc,ivar);
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Udst;
+  DataArray2d  Usrc;
+  AMRTable     tasks;
+
+}; // AMRCopyBlocksFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRPackBlocksFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Copy whole blocks (ghost cells included) of a pool into a buffer,
+   * one after the other (Bi*Bj*nbvar values each), or back (unpack), for
+   * MPI exchanges.
+   *
+   * \param[in,out] Upool level pool
+   * \param[in,out] buffer packed blocks
+   * \param[in] slots one line per packed block: slot in the pool
+   * \param[in] unpack copy from the buffer into the pool
+   */
+  AMRPackBlocksFunctor2D(KernelParams params,
+			 AMRLevelInfo info,
+			 DataArray2d  Upool,
+			 AMRBuffer    buffer,
+			 AMRTable     slots,
+			 bool         unpack) :
+    HydroBaseFunctor2D(params), info(info),
+    Upool(Upool), buffer(buffer), slots(slots), unpack(unpack) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Upool,
+		    AMRBuffer    buffer,
+		    AMRTable     slots,
+		    bool         unpack)
+  {
+    int nbCells = info.Bi * info.Bj * slots.extent(0);
+    AMRPackBlocksFunctor2D functor(params, info, Upool, buffer, slots, unpack);
+    Kokkos::parallel_for("AMRPackBlocksFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int Bi = info.Bi;
+    const int Bj = info.Bj;
+
+    const int block = index / (Bi*Bj);
+    const int r     = index % (Bi*Bj);
+    const int i     = r % Bi;
+    const int j     = r / Bi + slots(block,0)*Bj;
+
+    const int offset = block*Bi*Bj*nbvar + r;
+
+    for (int ivar=0; ivar<nbvar; ++ivar) {
+      if (unpack)
+	Upool(i,j,ivar) = buffer(offset + ivar*Bi*Bj);
+      else
+	buffer(offset + ivar*Bi*Bj) = Upool(i,j,ivar);
+    }
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Upool;
+  AMRBuffer    buffer;
+  AMRTable     slots;
+  bool         unpack;
+
+}; // AMRPackBlocksFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRFluxCorrectionFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Conservative flux correction at coarse/fine faces: fluxes of a coarse
+   * leaf through a face shared with finer leaves are replaced by the
+   * average of the fine fluxes.
+   *
+   * Fluxes are stored multiplied by dt/dx of their level (see
+   * ComputeAndStoreFluxesFunctor2D), hence the factor 1/4 for 2 fine
+   * faces.
+   *
+   * \param[in] tasks one line per coarse face: coarse slot, face
+   * (FACE_XMIN, ...), fine slots of the 2 children along the face
+   */
+  AMRFluxCorrectionFunctor2D(KernelParams params,
+			     AMRLevelInfo info,
+			     DataArray2d  Fluxes_x,
+			     DataArray2d  Fluxes_y,
+			     DataArray2d  FineFluxes_x,
+			     DataArray2d  FineFluxes_y,
+			     AMRTable     tasks) :
+    HydroBaseFunctor2D(params), info(info),
+    Fluxes_x(Fluxes_x), Fluxes_y(Fluxes_y),
+    FineFluxes_x(FineFluxes_x), FineFluxes_y(FineFluxes_y),
+    tasks(tasks) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Fluxes_x,
+		    DataArray2d  Fluxes_y,
+		    DataArray2d  FineFluxes_x,
+		    DataArray2d  FineFluxes_y,
+		    AMRTable     tasks)
+  {
+    int nbFaces = (info.bx > info.by ? info.bx : info.by) * tasks.extent(0);
+    AMRFluxCorrectionFunctor2D functor(params, info,
+				       Fluxes_x, Fluxes_y,
+				       FineFluxes_x, FineFluxes_y,
+				       tasks);
+    Kokkos::parallel_for("AMRFluxCorrectionFunctor2D", nbFaces, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int by = info.by;
+    const int Bj = info.Bj;
+    const int length = bx > by ? bx : by;
+
+    const int task = index / length;
+    const int t    = index % length;
+
+    const int slot = tasks(task,0);
+    const int face = tasks(task,1);
+
+    if (face == FACE_XMIN or face == FACE_XMAX) {
+
+      if (t >= by)
+	return;
+
+      const int half  = by/2;
+      const int child = t < half ? tasks(task,2) : tasks(task,3);
+      const int tf    = t < half ? t : t-half;
+
+      const int i  = face == FACE_XMIN ? gw : gw+bx;
+      const int fi = face == FACE_XMIN ? gw+bx : gw;
+      const int j  = gw + t + slot*Bj;
+      const int fj = gw + 2*tf + child*Bj;
+
+      for (int ivar=0; ivar<nbvar; ++ivar)
+	Fluxes_x(i,j,ivar) = 0.25 * (FineFluxes_x(fi,fj  ,ivar) +
+				     FineFluxes_x(fi,fj+1,ivar));
+
+    } else {
+
+      if (t >= bx)
+	return;
+
+      const int half  = bx/2;
+      const int child = t < half ? tasks(task,2) : tasks(task,3);
+      const int tf    = t < half ? t : t-half;
+
+      const int i  = gw + t;
+      const int fi = gw + 2*tf;
+      const int j  = (face == FACE_YMIN ? gw : gw+by) + slot*Bj;
+      const int fj = (face == FACE_YMIN ? gw+by : gw) + child*Bj;
+
+      for (int ivar=0; ivar<nbvar; ++ivar)
+	Fluxes_y(i,j,ivar) = 0.25 * (FineFluxes_y(fi  ,fj,ivar) +
+				     FineFluxes_y(fi+1,fj,ivar));
+
+    }
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Fluxes_x;
+  DataArray2d  Fluxes_y;
+  DataArray2d  FineFluxes_x;
+  DataArray2d  FineFluxes_y;
+  AMRTable     tasks;
+
+}; // AMRFluxCorrectionFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRRefineIndicatorFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  using team_policy_t = Kokkos::TeamPolicy<Device>;
+  using team_member_t = team_policy_t::member_type;
+
+  /**
+   * Refinement indicator of each leaf block: maximum over the block of
+   * the relative variation of density (or pressure) between the two
+   * neighbors of a cell, |w(i+1)-w(i-1)| / (|w(i+1)|+|w(i-1)|).
+   *
+   * One team per block.
+   *
+   * \param[in] Udata level pool (ghost cells up to date)
+   * \param[out] indicator value for each leaf slot
+   * \param[in] use_pressure use pressure instead of density
+   */
+  AMRRefineIndicatorFunctor2D(KernelParams  params,
+			      AMRLevelInfo  info,
+			      DataArray2d   Udata,
+			      AMRBlockArray indicator,
+			      bool          use_pressure) :
+    HydroBaseFunctor2D(params), info(info),
+    Udata(Udata), indicator(indicator), use_pressure(use_pressure) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams  params,
+		    AMRLevelInfo  info,
+		    DataArray2d   Udata,
+		    AMRBlockArray indicator,
+		    bool          use_pressure,
+		    int           nb_leaves)
+  {
+    AMRRefineIndicatorFunctor2D functor(params, info, Udata,
+					indicator, use_pressure);
+    Kokkos::parallel_for("AMRRefineIndicatorFunctor2D",
+			 team_policy_t(nb_leaves, Kokkos::AUTO), functor);
+  }
+
+  //! density or pressure in a cell
+  KOKKOS_INLINE_FUNCTION
+  real_t value(int i, int j) const
+  {
+    if (!use_pressure)
+      return Udata(i,j,ID);
+
+    HydroState uLoc, qLoc;
+    real_t c;
+
+    uLoc[ID] = Udata(i,j,ID);
+    uLoc[IP] = Udata(i,j,IP);
+    uLoc[IU] = Udata(i,j,IU);
+    uLoc[IV] = Udata(i,j,IV);
+
+    computePrimitives(uLoc, &c, qLoc);
+
+    return qLoc[IP];
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member_t& team) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int Bj = info.Bj;
+
+    const int slot = team.league_rank();
+
+    real_t result = 0;
+
+    Kokkos::parallel_reduce(Kokkos::TeamThreadRange(team, bx*info.by),
+			    [&](const int& r, real_t& lmax) {
+      const int i = gw + r % bx;
+      const int j = gw + r / bx + slot*Bj;
+
+      const real_t wxp = value(i+1,j  );
+      const real_t wxm = value(i-1,j  );
+      const real_t wyp = value(i  ,j+1);
+      const real_t wym = value(i  ,j-1);
+
+      const real_t ex = FABS(wxp-wxm) / (FABS(wxp)+FABS(wxm)+1e-30);
+      const real_t ey = FABS(wyp-wym) / (FABS(wyp)+FABS(wym)+1e-30);
+
+      lmax = FMAX(lmax, FMAX(ex,ey));
+    }, Kokkos::Max<real_t>(result));
+
+    Kokkos::single(Kokkos::PerTeam(team), [&]() {
+      indicator(slot) = result;
+    });
+
+  } // operator ()
+
+  AMRLevelInfo  info;
+  DataArray2d   Udata;
+  AMRBlockArray indicator;
+  bool          use_pressure;
+
+}; // AMRRefineIndicatorFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+class AMRGatherFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  /**
+   * Copy level 0 blocks (which hold the average of the finer levels) into
+   * a regular array of the base grid, for outputs. With MPI, the array is
+   * the sub-domain of the current process, whose first block is (bi0,bj0);
+   * blocks outside of it are skipped.
+   *
+   * \param[out] Udata regular array (params sizes)
+   * \param[in] Upool level 0 pool
+   * \param[in] coords block coordinates of each slot
+   * \param[in] bi0 block coordinates of the sub-domain origin
+   * \param[in] bj0 block coordinates of the sub-domain origin
+   */
+  AMRGatherFunctor2D(KernelParams params,
+		     AMRLevelInfo info,
+		     DataArray2d  Udata,
+		     DataArray2d  Upool,
+		     AMRTable     coords,
+		     int          bi0,
+		     int          bj0) :
+    HydroBaseFunctor2D(params), info(info),
+    Udata(Udata), Upool(Upool), coords(coords), bi0(bi0), bj0(bj0) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    AMRLevelInfo info,
+		    DataArray2d  Udata,
+		    DataArray2d  Upool,
+		    AMRTable     coords,
+		    int          bi0,
+		    int          bj0)
+  {
+    int nbCells = info.bx * info.by * info.nb_slots;
+    AMRGatherFunctor2D functor(params, info, Udata, Upool, coords, bi0, bj0);
+    Kokkos::parallel_for("AMRGatherFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int gw = info.gw;
+    const int bx = info.bx;
+    const int by = info.by;
+
+    const int slot = index / (bx*by);
+    const int r    = index % (bx*by);
+    const int li   = r % bx;
+    const int lj   = r / bx;
+
+    const int bi = coords(slot,0) - bi0;
+    const int bj = coords(slot,1) - bj0;
+
+    if (bi < 0 or bi*bx >= params.nx or bj < 0 or bj*by >= params.ny)
+      return;
+
+    const int i = gw + bi*bx + li;
+    const int j = gw + bj*by + lj;
+
+    for (int ivar=0; ivar<nbvar; ++ivar)
+      Udata(i,j,ivar) = Upool(gw+li, gw+lj+slot*info.Bj, ivar);
+
+  } // operator ()
+
+  AMRLevelInfo info;
+  DataArray2d  Udata;
+  DataArray2d  Upool;
+  AMRTable     coords;
+  int          bi0, bj0;
+
+}; // AMRGatherFunctor2D
+
+} // namespace muscl
+
+} // namespace ppkMHD
+
+#endif // HYDRO_AMR_FUNCTORS_2D_H_
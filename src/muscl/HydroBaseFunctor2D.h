@@ -3,8 +3,9 @@
 
 #include "shared/kokkos_shared.h"
 
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
+#include "shared/EquationOfState.h"
 
 namespace ppkMHD { namespace muscl {
 
@@ -20,10 +21,10 @@ public:
   using HydroState = HydroState2d;
   using DataArray  = DataArray2d;
   
-  HydroBaseFunctor2D(HydroParams params) : params(params) {};
+  HydroBaseFunctor2D(KernelParams params) : params(params) {};
   virtual ~HydroBaseFunctor2D() {};
 
-  HydroParams params;
+  KernelParams params;
   const int nbvar = params.nbvar;
   
   // utility routines used in various computational kernels
@@ -46,6 +47,8 @@ public:
    * of state : \f$ eint=\frac{p}{\rho (\gamma-1)} \f$
    * Recall that \f$ \gamma \f$ is equal to the ratio of specific heats
    *  \f$ \left[ c_p/c_v \right] \f$.
+   * A tabulated EOS is used instead when enabled (see
+   * shared/EquationOfState.h).
    * 
    * @param[in]  rho  density
    * @param[in]  eint internal energy
@@ -58,12 +61,9 @@ public:
 	   real_t* p,
 	   real_t* c) const
   {
-    real_t gamma0 = params.settings.gamma0;
-    real_t smallp = params.settings.smallp;
-    
-    *p = FMAX((gamma0 - ONE_F) * rho * eint, rho * smallp);
-    *c = SQRT(gamma0 * (*p) / rho);
-    
+
+    eos_compute(params.settings, rho, eint, *p, *c);
+
   } // eos
   
   /**
@@ -78,9 +78,7 @@ public:
 			 real_t* c,
 			 HydroState& q) const
   {
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
-    real_t smallp = params.settings.smallp;
     
     real_t d, p, ux, uy;
     
@@ -92,8 +90,7 @@ public:
     real_t e = u[IP] / d - eken;
     
     // compute pressure and speed of sound
-    p = fmax((gamma0 - 1.0) * d * e, d * smallp);
-    *c = sqrt(gamma0 * (p) / d);
+    eos_compute(params.settings, d, e, p, *c);
     
     q[ID] = d;
     q[IP] = p;
@@ -129,7 +126,6 @@ public:
 			HydroState& qp_y) const
   {
     
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
     
     // first compute slopes
@@ -151,6 +147,7 @@ public:
     // Cell centered values
     real_t r =  q[ID];
     real_t p =  q[IP];
+    real_t rhoc2 = eos_rho_c2(params.settings, r, p);
     real_t u =  q[IU];
     real_t v =  q[IV];
       
@@ -167,7 +164,7 @@ public:
       
     // source terms (with transverse derivatives)
     real_t sr0 = -u*drx-v*dry - (dux+dvy)*r;
-    real_t sp0 = -u*dpx-v*dpy - (dux+dvy)*gamma0*p;
+    real_t sp0 = -u*dpx-v*dpy - (dux+dvy)*rhoc2;
     real_t su0 = -u*dux-v*duy - (dpx    )/r;
     real_t sv0 = -u*dvx-v*dvy - (dpy    )/r;
       
@@ -224,12 +221,12 @@ public:
 				  HydroState& qface) const
   {
   
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
 
     // Cell centered values
     real_t r =  q[ID];
     real_t p =  q[IP];
+    real_t rhoc2 = eos_rho_c2(params.settings, r, p);
     real_t u =  q[IU];
     real_t v =  q[IV];
   
@@ -246,7 +243,7 @@ public:
   
     // source terms (with transverse derivatives)
     real_t sr0 = -u*drx-v*dry - (dux+dvy)*r;
-    real_t sp0 = -u*dpx-v*dpy - (dux+dvy)*gamma0*p;
+    real_t sp0 = -u*dpx-v*dpy - (dux+dvy)*rhoc2;
     real_t su0 = -u*dux-v*duy - (dpx    )/r;
     real_t sv0 = -u*dvx-v*dvy - (dpy    )/r;
   
@@ -316,13 +313,13 @@ public:
 			      HydroState& qp_y) const
   {
   
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
     real_t smallp = params.settings.smallp;
 
     // Cell centered values
     real_t r = q[ID];
     real_t p = q[IP];
+    real_t rhoc2 = eos_rho_c2(params.settings, r, p);
     real_t u = q[IU];
     real_t v = q[IV];
 
@@ -346,7 +343,7 @@ public:
       sr0 = (-u*drx-dux*r)       *dtdx + (-v*dry-dvy*r)       *dtdy;
       su0 = (-u*dux-dpx/r)       *dtdx + (-v*duy      )       *dtdy;
       sv0 = (-u*dvx      )       *dtdx + (-v*dvy-dpy/r)       *dtdy;
-      sp0 = (-u*dpx-dux*gamma0*p)*dtdx + (-v*dpy-dvy*gamma0*p)*dtdy;    
+      sp0 = (-u*dpx-dux*rhoc2)*dtdx + (-v*dpy-dvy*rhoc2)*dtdy;    
     } // end cartesian
 
     // Update in time the  primitive variables
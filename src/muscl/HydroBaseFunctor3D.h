@@ -3,8 +3,9 @@
 
 #include "shared/kokkos_shared.h"
 
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
+#include "shared/EquationOfState.h"
 
 namespace ppkMHD { namespace muscl {
 
@@ -20,10 +21,10 @@ public:
   using HydroState = HydroState3d;
   using DataArray  = DataArray3d;
   
-HydroBaseFunctor3D(HydroParams params) : params(params) {};
+HydroBaseFunctor3D(KernelParams params) : params(params) {};
   virtual ~HydroBaseFunctor3D() {};
 
-  HydroParams params;
+  KernelParams params;
   const int nbvar = params.nbvar;
   
   // utility routines used in various computational kernels
@@ -46,6 +47,8 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
    * of state : \f$ eint=\frac{p}{\rho (\gamma-1)} \f$
    * Recall that \f$ \gamma \f$ is equal to the ratio of specific heats
    *  \f$ \left[ c_p/c_v \right] \f$.
+   * A tabulated EOS is used instead when enabled (see
+   * shared/EquationOfState.h).
    * 
    * @param[in]  rho  density
    * @param[in]  eint internal energy
@@ -58,12 +61,9 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
 	   real_t* p,
 	   real_t* c) const
   {
-    real_t gamma0 = params.settings.gamma0;
-    real_t smallp = params.settings.smallp;
-    
-    *p = FMAX((gamma0 - ONE_F) * rho * eint, rho * smallp);
-    *c = SQRT(gamma0 * (*p) / rho);
-    
+
+    eos_compute(params.settings, rho, eint, *p, *c);
+
   } // eos
   
   /**
@@ -78,9 +78,7 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
 			 real_t* c,
 			 HydroState& q) const
   {
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
-    real_t smallp = params.settings.smallp;
     
     real_t d, p, ux, uy, uz;
     
@@ -93,8 +91,7 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
     real_t e = u[IP] / d - eken;
     
     // compute pressure and speed of sound
-    p = fmax((gamma0 - 1.0) * d * e, d * smallp);
-    *c = sqrt(gamma0 * (p) / d);
+    eos_compute(params.settings, d, e, p, *c);
     
     q[ID] = d;
     q[IP] = p;
@@ -135,7 +132,6 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
 			HydroState& qp_z) const
   {
     
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
     
     // first compute slopes
@@ -167,6 +163,7 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
     // Cell centered values
     real_t r =  q[ID];
     real_t p =  q[IP];
+    real_t rhoc2 = eos_rho_c2(params.settings, r, p);
     real_t u =  q[IU];
     real_t v =  q[IV];
     real_t w =  q[IW];
@@ -195,7 +192,7 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
     real_t su0 = (-u*dux-dpx/r)*dtdx + (-v*duy      )*dtdy + (-w*duz      )*dtdz; 
     real_t sv0 = (-u*dvx      )*dtdx + (-v*dvy-dpy/r)*dtdy + (-w*dvz      )*dtdz;
     real_t sw0 = (-u*dwx      )*dtdx + (-v*dwy      )*dtdy + (-w*dwz-dpz/r)*dtdz; 
-    real_t sp0 = (-u*dpx-dux*gamma0*p)*dtdx + (-v*dpy-dvy*gamma0*p)*dtdy + (-w*dpz-dwz*gamma0*p)*dtdz;
+    real_t sp0 = (-u*dpx-dux*rhoc2)*dtdx + (-v*dpy-dvy*rhoc2)*dtdy + (-w*dpz-dwz*rhoc2)*dtdz;
        
     // Right state at left interface
     qp_x[ID] = r - HALF_F*drx + sr0*HALF_F;
@@ -275,12 +272,12 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
 				  HydroState& qface) const
   {
   
-    real_t gamma0 = params.settings.gamma0;
     real_t smallr = params.settings.smallr;
 
     // Cell centered values
     real_t r =  q[ID];
     real_t p =  q[IP];
+    real_t rhoc2 = eos_rho_c2(params.settings, r, p);
     real_t u =  q[IU];
     real_t v =  q[IV];
     real_t w =  q[IW];
@@ -306,7 +303,7 @@ HydroBaseFunctor3D(HydroParams params) : params(params) {};
   
     // source terms (with transverse derivatives)
     real_t sr0 = -u*drx-v*dry-w*drz - (dux+dvy+dwz)*r;
-    real_t sp0 = -u*dpx-v*dpy-w*dpz - (dux+dvy+dwz)*gamma0*p;
+    real_t sp0 = -u*dpx-v*dpy-w*dpz - (dux+dvy+dwz)*rhoc2;
     real_t su0 = -u*dux-v*duy-w*duz - (dpx        )/r;
     real_t sv0 = -u*dvx-v*dvy-w*dvz - (dpy        )/r;
     real_t sw0 = -u*dwx-v*dwy-w*dwz - (dpz        )/r;
@@ -32,19 +32,19 @@ namespace ppkMHD { namespace muscl {
 class InitImplodeFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  InitImplodeFunctor2D(HydroParams params,
+  InitImplodeFunctor2D(KernelParams params,
 		       ImplodeParams iparams,
 		       DataArray2d Udata) :
     HydroBaseFunctor2D(params), iparams(iparams), Udata(Udata)  {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     ImplodeParams iparams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitImplodeFunctor2D functor(params, iparams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitImplodeFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -125,19 +125,19 @@ public:
 class InitBlastFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  InitBlastFunctor2D(HydroParams params,
+  InitBlastFunctor2D(KernelParams params,
 		     BlastParams bParams,
 		     DataArray2d Udata) :
     HydroBaseFunctor2D(params), bParams(bParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    BlastParams bParams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitBlastFunctor2D functor(params, bParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitBlastFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -211,7 +211,7 @@ public:
 class InitKelvinHelmholtzFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  InitKelvinHelmholtzFunctor2D(HydroParams params,
+  InitKelvinHelmholtzFunctor2D(KernelParams params,
 			       KHParams khParams,
 			       DataArray2d Udata) :
     HydroBaseFunctor2D(params),
@@ -220,13 +220,13 @@ public:
     rand_pool(khParams.seed) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    KHParams    khParams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitKelvinHelmholtzFunctor2D functor(params, khParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitKelvinHelmholtzFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -350,7 +350,7 @@ public:
 class InitGreshoVortexFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  InitGreshoVortexFunctor2D(HydroParams params,
+  InitGreshoVortexFunctor2D(KernelParams params,
 			    GreshoParams gvParams,
 			    DataArray2d Udata) :
     HydroBaseFunctor2D(params),
@@ -358,13 +358,13 @@ public:
     Udata(Udata) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams  params,
+  static void apply(KernelParams params,
 		    GreshoParams gvParams,
                     DataArray2d  Udata,
 		    int          nbCells)
   {
     InitGreshoVortexFunctor2D functor(params, gvParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitGreshoVortexFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -453,7 +453,7 @@ public:
 class InitFourQuadrantFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  InitFourQuadrantFunctor2D(HydroParams params,
+  InitFourQuadrantFunctor2D(KernelParams params,
 			    DataArray2d Udata,
 			    int configNumber,
 			    HydroState U0,
@@ -467,7 +467,7 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    int configNumber,
 		    HydroState U0,
@@ -480,7 +480,7 @@ public:
   {
     InitFourQuadrantFunctor2D functor(params, Udata, configNumber,
 				      U0, U1, U2, U3, xt, yt);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFourQuadrantFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -557,19 +557,19 @@ public:
 class InitIsentropicVortexFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  InitIsentropicVortexFunctor2D(HydroParams params,
+  InitIsentropicVortexFunctor2D(KernelParams params,
 				IsentropicVortexParams iparams,
 				DataArray2d Udata) :
     HydroBaseFunctor2D(params), iparams(iparams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    IsentropicVortexParams iparams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitIsentropicVortexFunctor2D functor(params, iparams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitIsentropicVortexFunctor2D", nbCells, functor);
   }
   
   KOKKOS_INLINE_FUNCTION
@@ -656,25 +656,22 @@ public:
 class RayleighTaylorInstabilityFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  RayleighTaylorInstabilityFunctor2D(HydroParams params,
+  RayleighTaylorInstabilityFunctor2D(KernelParams params,
 				     RayleighTaylorInstabilityParams rtiparams,
-				     DataArray2d Udata,
-				     VectorField2d gravity) :
+				     DataArray2d Udata) :
     HydroBaseFunctor2D(params),
     rtiparams(rtiparams),
-    Udata(Udata),
-    gravity(gravity)
+    Udata(Udata)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    RayleighTaylorInstabilityParams rtiparams,
-                    DataArray2d Udata,
-		    VectorField2d gravity)
+                    DataArray2d Udata)
   {
     uint64_t nbCells = params.isize * params.jsize;
-    RayleighTaylorInstabilityFunctor2D functor(params, rtiparams, Udata, gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    RayleighTaylorInstabilityFunctor2D functor(params, rtiparams, Udata);
+    Kokkos::parallel_for("RayleighTaylorInstabilityFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -761,16 +758,11 @@ public:
     // -dP/dz + rho*g = 0
     // P = P0 + rho g z
     Udata(i,j,IE) = (P0 + Udata(i,j,ID)*(gravity_x*x + gravity_y*y))/(gamma0-1.0);
-
-    // init gravity field
-    gravity(i,j,IX) = gravity_x;
-    gravity(i,j,IY) = gravity_y;
     
   } // end operator ()
 
   RayleighTaylorInstabilityParams rtiparams;
   DataArray2d Udata;
-  VectorField2d gravity;
   
 }; // class RayleighTaylorInstabilityFunctor2D
 
@@ -783,25 +775,22 @@ public:
 class RisingBubbleFunctor2D : public HydroBaseFunctor2D {
 
 public:
-  RisingBubbleFunctor2D(HydroParams params,
+  RisingBubbleFunctor2D(KernelParams params,
 			RisingBubbleParams rbparams,
-			DataArray2d Udata,
-			VectorField2d gravity) :
+			DataArray2d Udata) :
     HydroBaseFunctor2D(params),
     rbparams(rbparams),
-    Udata(Udata),
-    gravity(gravity)
+    Udata(Udata)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    RisingBubbleParams rbparams,
-                    DataArray2d Udata,
-		    VectorField2d gravity)
+                    DataArray2d Udata)
   {
     uint64_t nbCells = params.isize * params.jsize;
-    RisingBubbleFunctor2D functor(params, rbparams, Udata, gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    RisingBubbleFunctor2D functor(params, rbparams, Udata);
+    Kokkos::parallel_for("RisingBubbleFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -877,16 +866,11 @@ public:
     // -dP/dz + rho*g = 0
     // P = P0 + rho g z
     Udata(i,j,IE) = (P0 + Udata(i,j,ID)*(gravity_x*x + gravity_y*y))/(gamma0-1.0);
-
-    // init gravity field
-    gravity(i,j,IX) = gravity_x;
-    gravity(i,j,IY) = gravity_y;
     
   } // end operator ()
 
   RisingBubbleParams rbparams;
   DataArray2d Udata;
-  VectorField2d gravity;
   
 }; // class RisingBubbleFunctor2D
 
@@ -896,28 +880,25 @@ public:
 class InitDiskFunctor2D : public HydroBaseFunctor2D {
   
 public:
-  InitDiskFunctor2D(HydroParams        params,
+  InitDiskFunctor2D(KernelParams       params,
 		    DiskParams         dparams,
 		    PointSourceGravity grav,
-		    DataArray2d        Udata,
-		    VectorField2d      gravity) :
+		    DataArray2d        Udata) :
     HydroBaseFunctor2D(params),
     dparams(dparams),
     grav(grav),
-    Udata(Udata),
-    gravity(gravity)
+    Udata(Udata)
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams        params,
+  static void apply(KernelParams       params,
 		    DiskParams         dparams,
                     PointSourceGravity grav,
-                    DataArray2d        Udata,
-		    VectorField2d      gravity)
+                    DataArray2d        Udata)
   {
     uint64_t nbCells = params.isize * params.jsize;
-    InitDiskFunctor2D functor(params, dparams, grav, Udata, gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    InitDiskFunctor2D functor(params, dparams, grav, Udata);
+    Kokkos::parallel_for("InitDiskFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -966,14 +947,6 @@ public:
     
     const real_t GM = grav.GM;
 
-    // init gravity field components
-    {
-      real_t gx, gy, gz;
-      grav.eval(x,y,0,gx,gy,gz);
-      gravity(i,j,IX) = gx;
-      gravity(i,j,IY) = gy;
-    }
-
     {
       const real_t eps = grav.eps;
       
@@ -1041,9 +1014,60 @@ public:
   DiskParams         dparams;
   PointSourceGravity grav;
   DataArray2d        Udata;
-  VectorField2d      gravity;
 
 }; // InitDiskFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Initial conditions are written with the ideal gas law (gamma0); when a
+ * tabulated EOS is active, convert the total energy so that the pressure
+ * of the initial condition is the one obtained through the table.
+ *
+ * The pressure is recovered as (gamma0-1) * (E - kinetic energy), then
+ * E = eos_internal_energy(rho,p) + kinetic energy.
+ */
+class InitEosEnergyFunctor2D : public HydroBaseFunctor2D {
+
+public:
+  InitEosEnergyFunctor2D(KernelParams params,
+			 DataArray2d Udata) :
+    HydroBaseFunctor2D(params), Udata(Udata)  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+                    DataArray2d Udata,
+		    int         nbCells)
+  {
+    InitEosEnergyFunctor2D functor(params, Udata);
+    Kokkos::parallel_for("InitEosEnergyFunctor2D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+
+    const real_t gamma0 = params.settings.gamma0;
+
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+
+    const real_t rho = Udata(i,j,ID);
+    const real_t ekin = 0.5 * (Udata(i,j,IU)*Udata(i,j,IU) +
+			       Udata(i,j,IV)*Udata(i,j,IV)) / rho;
+    const real_t p = (gamma0-1.0) * (Udata(i,j,IE) - ekin);
+
+    Udata(i,j,IE) = eos_internal_energy(params.settings, rho, p) + ekin;
+
+  } // end operator ()
+
+  DataArray2d Udata;
+
+}; // InitEosEnergyFunctor2D
   
 } // namespace muscl
 
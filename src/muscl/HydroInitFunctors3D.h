@@ -27,17 +27,17 @@ namespace ppkMHD { namespace muscl {
 class InitFakeFunctor3D : public HydroBaseFunctor3D {
   
 public:
-  InitFakeFunctor3D(HydroParams params,
+  InitFakeFunctor3D(KernelParams params,
 		    DataArray3d Udata) :
     HydroBaseFunctor3D(params), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitFakeFunctor3D functor(params, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFakeFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -70,19 +70,19 @@ public:
 class InitImplodeFunctor3D : public HydroBaseFunctor3D {
   
 public:
-  InitImplodeFunctor3D(HydroParams params,
+  InitImplodeFunctor3D(KernelParams params,
 		       ImplodeParams iparams,
 		       DataArray3d Udata) :
     HydroBaseFunctor3D(params), iparams(iparams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     ImplodeParams iparams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitImplodeFunctor3D functor(params, iparams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitImplodeFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -175,19 +175,19 @@ public:
 class InitBlastFunctor3D : public HydroBaseFunctor3D {
 
 public:
-  InitBlastFunctor3D(HydroParams params,
+  InitBlastFunctor3D(KernelParams params,
 		     BlastParams bParams,
 		     DataArray3d Udata) :
     HydroBaseFunctor3D(params), bParams(bParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    BlastParams bParams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitBlastFunctor3D functor(params, bParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitBlastFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -274,7 +274,7 @@ public:
 class InitKelvinHelmholtzFunctor3D : public HydroBaseFunctor3D {
 
 public:
-  InitKelvinHelmholtzFunctor3D(HydroParams params,
+  InitKelvinHelmholtzFunctor3D(KernelParams params,
 			       KHParams khParams,
 			       DataArray3d Udata) :
     HydroBaseFunctor3D(params),
@@ -284,13 +284,13 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    KHParams    khParams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitKelvinHelmholtzFunctor3D functor(params, khParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitKelvinHelmholtzFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -438,7 +438,7 @@ public:
 class InitGreshoVortexFunctor3D : public HydroBaseFunctor3D {
 
 public:
-  InitGreshoVortexFunctor3D(HydroParams params,
+  InitGreshoVortexFunctor3D(KernelParams params,
 			    GreshoParams gvParams,
 			    DataArray3d Udata) :
     HydroBaseFunctor3D(params),
@@ -447,13 +447,13 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams  params,
+  static void apply(KernelParams params,
 		    GreshoParams gvParams,
                     DataArray3d  Udata,
 		    int          nbCells)
   {
     InitGreshoVortexFunctor3D functor(params, gvParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitGreshoVortexFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -561,25 +561,22 @@ public:
 class RayleighTaylorInstabilityFunctor3D : public HydroBaseFunctor3D {
 
 public:
-  RayleighTaylorInstabilityFunctor3D(HydroParams params,
+  RayleighTaylorInstabilityFunctor3D(KernelParams params,
 				     RayleighTaylorInstabilityParams rtiparams,
-				     DataArray3d Udata,
-				     VectorField3d gravity) :
+				     DataArray3d Udata) :
     HydroBaseFunctor3D(params),
     rtiparams(rtiparams),
-    Udata(Udata),
-    gravity(gravity)
+    Udata(Udata)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    RayleighTaylorInstabilityParams rtiparams,
-                    DataArray3d Udata,
-		    VectorField3d gravity)
+                    DataArray3d Udata)
   {
     uint64_t nbCells = params.isize * params.jsize * params.ksize;
-    RayleighTaylorInstabilityFunctor3D functor(params, rtiparams, Udata, gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    RayleighTaylorInstabilityFunctor3D functor(params, rtiparams, Udata);
+    Kokkos::parallel_for("RayleighTaylorInstabilityFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -676,17 +673,11 @@ public:
     Udata(i,j,k,IE) = (P0 + Udata(i,j,k,ID)*(gravity_x*x +
 					     gravity_y*y +
 					     gravity_z*z))/(gamma0-1);
-
-    // init gravity field
-    gravity(i,j,k,IX) = gravity_x;
-    gravity(i,j,k,IY) = gravity_y;
-    gravity(i,j,k,IZ) = gravity_z;
     
   } // end operator ()
 
   RayleighTaylorInstabilityParams rtiparams;
   DataArray3d Udata;
-  VectorField3d gravity;
   
 }; // class RayleighTaylorInstabilityFunctor3D
 
@@ -699,25 +690,22 @@ public:
 class RisingBubbleFunctor3D : public HydroBaseFunctor3D {
 
 public:
-  RisingBubbleFunctor3D(HydroParams params,
+  RisingBubbleFunctor3D(KernelParams params,
 			RisingBubbleParams rbparams,
-			DataArray3d Udata,
-			VectorField3d gravity) :
+			DataArray3d Udata) :
     HydroBaseFunctor3D(params),
     rbparams(rbparams),
-    Udata(Udata),
-    gravity(gravity)
+    Udata(Udata)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    RisingBubbleParams rbparams,
-                    DataArray3d Udata,
-		    VectorField3d gravity)
+                    DataArray3d Udata)
   {
     uint64_t nbCells = params.isize * params.jsize * params.ksize;
-    RisingBubbleFunctor3D functor(params, rbparams, Udata, gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    RisingBubbleFunctor3D functor(params, rbparams, Udata);
+    Kokkos::parallel_for("RisingBubbleFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -802,17 +790,11 @@ public:
     // -dP/dz + rho*g = 0
     // P = P0 + rho g z
     Udata(i,j,k,IE) = (P0 + Udata(i,j,k,ID)*(gravity_x*x + gravity_y*y + gravity_z*z))/(gamma0-1.0);
-
-    // init gravity field
-    gravity(i,j,k,IX) = gravity_x;
-    gravity(i,j,k,IY) = gravity_y;
-    gravity(i,j,k,IZ) = gravity_z;
     
   } // end operator ()
 
   RisingBubbleParams rbparams;
   DataArray3d Udata;
-  VectorField3d gravity;
   
 }; // class RisingBubbleFunctor3D
 
@@ -822,28 +804,25 @@ public:
 class InitDiskFunctor3D : public HydroBaseFunctor3D {
   
 public:
-  InitDiskFunctor3D(HydroParams        params,
+  InitDiskFunctor3D(KernelParams       params,
 		    DiskParams         dparams,
 		    PointSourceGravity grav,
-		    DataArray3d        Udata,
-		    VectorField3d      gravity) :
+		    DataArray3d        Udata) :
     HydroBaseFunctor3D(params),
     dparams(dparams),
     grav(grav),
-    Udata(Udata),
-    gravity(gravity)
+    Udata(Udata)
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams        params,
+  static void apply(KernelParams       params,
 		    DiskParams         dparams,
                     PointSourceGravity grav,
-                    DataArray3d        Udata,
-		    VectorField3d      gravity)
+                    DataArray3d        Udata)
   {
     uint64_t nbCells = params.isize * params.jsize * params.ksize;
-    InitDiskFunctor3D functor(params, dparams, grav, Udata, gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    InitDiskFunctor3D functor(params, dparams, grav, Udata);
+    Kokkos::parallel_for("InitDiskFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -900,15 +879,6 @@ public:
     
     const real_t GM = grav.GM;
 
-    // init gravity field components
-    {
-      real_t gx, gy, gz;
-      grav.eval(x,y,z,gx,gy,gz);
-      gravity(i,j,k,IX) = gx;
-      gravity(i,j,k,IY) = gy;
-      gravity(i,j,k,IZ) = gz;
-    }
-
     {
       const real_t eps = grav.eps;
       
@@ -977,10 +947,63 @@ public:
   DiskParams         dparams;
   PointSourceGravity grav;
   DataArray3d        Udata;
-  VectorField3d      gravity;
 
 }; // InitDiskFunctor3D
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Initial conditions are written with the ideal gas law (gamma0); when a
+ * tabulated EOS is active, convert the total energy so that the pressure
+ * of the initial condition is the one obtained through the table.
+ *
+ * The pressure is recovered as (gamma0-1) * (E - kinetic energy), then
+ * E = eos_internal_energy(rho,p) + kinetic energy.
+ */
+class InitEosEnergyFunctor3D : public HydroBaseFunctor3D {
+
+public:
+  InitEosEnergyFunctor3D(KernelParams params,
+			 DataArray3d Udata) :
+    HydroBaseFunctor3D(params), Udata(Udata)  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+                    DataArray3d Udata,
+		    int         nbCells)
+  {
+    InitEosEnergyFunctor3D functor(params, Udata);
+    Kokkos::parallel_for("InitEosEnergyFunctor3D", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+
+    const real_t gamma0 = params.settings.gamma0;
+
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    const real_t rho = Udata(i,j,k,ID);
+    const real_t ekin = 0.5 * (Udata(i,j,k,IU)*Udata(i,j,k,IU) +
+			       Udata(i,j,k,IV)*Udata(i,j,k,IV) +
+			       Udata(i,j,k,IW)*Udata(i,j,k,IW)) / rho;
+    const real_t p = (gamma0-1.0) * (Udata(i,j,k,IE) - ekin);
+
+    Udata(i,j,k,IE) = eos_internal_energy(params.settings, rho, p) + ekin;
+
+  } // end operator ()
+
+  DataArray3d Udata;
+
+}; // InitEosEnergyFunctor3D
+
 } // namespace  muscl
 
 } // namespace ppkMHD
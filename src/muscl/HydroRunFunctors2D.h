@@ -7,8 +7,10 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "HydroBaseFunctor2D.h"
 #include "shared/RiemannSolvers.h"
+#include "shared/GravityField.h"
 
 namespace ppkMHD { namespace muscl {
 
@@ -25,19 +27,19 @@ public:
    * \param[in] params
    * \param[in] Udata
    */
-  ComputeDtFunctor2D(HydroParams params,
+  ComputeDtFunctor2D(KernelParams params,
 		     DataArray2d Udata) :
     HydroBaseFunctor2D(params),
     Udata(Udata)  {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    int nbCells,
                     real_t& invDt)
   {
     ComputeDtFunctor2D functor(params, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDtFunctor2D", nbCells, functor, invDt);
   }
 
   // Tell each thread how to initialize its reduction result.
@@ -130,10 +132,10 @@ public:
    * \param[in] params
    * \param[in] Udata
    */
-  ComputeDtGravityFunctor2D(HydroParams   params,
-			    real_t        cfl,
-			    VectorField2d gravity,
-			    DataArray2d   Udata) :
+  ComputeDtGravityFunctor2D(KernelParams   params,
+			    real_t         cfl,
+			    GravityField2d gravity,
+			    DataArray2d    Udata) :
     HydroBaseFunctor2D(params),
     cfl(cfl),
     gravity(gravity),
@@ -141,15 +143,15 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams   params,
-		    real_t        cfl,
-		    VectorField2d gravity,
-                    DataArray2d   Udata,
-		    int           nbCells,
-                    real_t&       invDt)
+  static void apply(KernelParams   params,
+		    real_t         cfl,
+		    GravityField2d gravity,
+                    DataArray2d    Udata,
+		    int            nbCells,
+                    real_t&        invDt)
   {
     ComputeDtGravityFunctor2D functor(params, cfl, gravity, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDtGravityFunctor2D", nbCells, functor, invDt);
   }
 
   // Tell each thread how to initialize its reduction result.
@@ -237,7 +239,7 @@ public:
   } // join
 
   real_t cfl;
-  VectorField2d gravity;
+  GravityField2d gravity;
   DataArray2d Udata;
   
 }; // ComputeDtGravityFunctor2D
@@ -256,19 +258,19 @@ public:
    * \param[in] Udata conservative variables
    * \param[out] Qdata primitive variables
    */
-  ConvertToPrimitivesFunctor2D(HydroParams params,
+  ConvertToPrimitivesFunctor2D(KernelParams params,
 			       DataArray2d Udata,
 			       DataArray2d Qdata) :
     HydroBaseFunctor2D(params), Udata(Udata), Qdata(Qdata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
                     DataArray2d Qdata)
   {
     int nbCells = params.isize * params.jsize;
     ConvertToPrimitivesFunctor2D functor(params, Udata, Qdata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ConvertToPrimitivesFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -329,7 +331,7 @@ public:
    * \param[in] Qp_x primitive variables reconstructed on face +X
    * \param[in] Qp_y primitive variables reconstructed on face +Y
    */
-  ComputeFluxesAndUpdateFunctor2D(HydroParams params,
+  ComputeFluxesAndUpdateFunctor2D(KernelParams params,
 				  DataArray2d Udata,
 				  DataArray2d Qm_x,
 				  DataArray2d Qm_y,
@@ -443,7 +445,7 @@ public:
    * \param[out] Qp_x primitive variables reconstructed at center face +X
    * \param[out] Qp_y primitive variables reconstructed at center face +Y
    */
-  ComputeTraceFunctor2D(HydroParams params,
+  ComputeTraceFunctor2D(KernelParams params,
 			DataArray2d Qdata,
 			DataArray2d Qm_x,
 			DataArray2d Qm_y,
@@ -574,13 +576,13 @@ public:
    * \param[in] gravity_enabled boolean value to activate static gravity
    * \param[in] gravity is a vector field 
    */
-  ComputeAndStoreFluxesFunctor2D(HydroParams params,
+  ComputeAndStoreFluxesFunctor2D(KernelParams params,
 				 DataArray2d Qdata,
 				 DataArray2d FluxData_x,
 				 DataArray2d FluxData_y,		       
 				 real_t dt,
 				 bool gravity_enabled,
-				 VectorField2d gravity) :
+				 GravityField2d gravity) :
     HydroBaseFunctor2D(params),
     Qdata(Qdata),
     FluxData_x(FluxData_x),
@@ -593,13 +595,13 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Qdata,
 		    DataArray2d FluxData_x,
 		    DataArray2d FluxData_y,		       
 		    real_t dt,
 		    bool gravity_enabled,
-		    VectorField2d gravity)
+		    GravityField2d gravity)
   {
     int nbCells = params.isize * params.jsize;
     ComputeAndStoreFluxesFunctor2D functor(params, Qdata,
@@ -607,7 +609,7 @@ public:
 					   dt,
 					   gravity_enabled,
 					   gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeAndStoreFluxesFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -833,7 +835,7 @@ public:
   DataArray2d FluxData_y;
   real_t dt, dtdx, dtdy;
   bool gravity_enabled;
-  VectorField2d gravity;
+  GravityField2d gravity;
 
   
 }; // ComputeAndStoreFluxesFunctor2D
@@ -854,7 +856,7 @@ public:
    * \param[in] FluxData_x flux coming from the left neighbor along X
    * \param[in] FluxData_y flux coming from the left neighbor along Y
    */
-  UpdateFunctor2D(HydroParams params,
+  UpdateFunctor2D(KernelParams params,
 		  DataArray2d Udata,
 		  DataArray2d FluxData_x,
 		  DataArray2d FluxData_y) :
@@ -864,14 +866,14 @@ public:
     FluxData_y(FluxData_y) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    DataArray2d FluxData_x,
 		    DataArray2d FluxData_y)
   {
     int nbCells = params.isize * params.jsize;
     UpdateFunctor2D functor(params, Udata, FluxData_x, FluxData_y);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -933,7 +935,7 @@ public:
    * \param[in] FluxData flux coming from the left neighbor along direction dir
    *
    */
-  UpdateDirFunctor2D(HydroParams params,
+  UpdateDirFunctor2D(KernelParams params,
 		     DataArray2d Udata,
 		     DataArray2d FluxData) :
     HydroBaseFunctor2D(params),
@@ -941,13 +943,13 @@ public:
     FluxData(FluxData) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    DataArray2d FluxData)
   {
     int nbCells = params.isize * params.jsize;
     UpdateDirFunctor2D<dir> functor(params, Udata, FluxData);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateDirFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -1013,7 +1015,7 @@ public:
    * \param[out] Slopes_x limited slopes along direction X
    * \param[out] Slopes_y limited slopes along direction Y
    */
-  ComputeSlopesFunctor2D(HydroParams params,
+  ComputeSlopesFunctor2D(KernelParams params,
 			 DataArray2d Qdata,
 			 DataArray2d Slopes_x,
 			 DataArray2d Slopes_y) :
@@ -1021,14 +1023,14 @@ public:
     Slopes_x(Slopes_x), Slopes_y(Slopes_y) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Qdata,
 		    DataArray2d Slopes_x,
 		    DataArray2d Slopes_y)
   {
     int nbCells = params.isize * params.jsize;
     ComputeSlopesFunctor2D functor(params, Qdata, Slopes_x, Slopes_y);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeSlopesFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -1127,14 +1129,14 @@ public:
    *
    * \tparam dir direction along which fluxes are computed.
    */
-  ComputeTraceAndFluxes_Functor2D(HydroParams params,
+  ComputeTraceAndFluxes_Functor2D(KernelParams params,
 				  DataArray2d Qdata,
 				  DataArray2d Slopes_x,
 				  DataArray2d Slopes_y,
 				  DataArray2d Fluxes,
 				  real_t    dt,
 				  bool gravity_enabled,
-				  VectorField2d gravity) :
+				  GravityField2d gravity) :
     HydroBaseFunctor2D(params), Qdata(Qdata),
     Slopes_x(Slopes_x), Slopes_y(Slopes_y),
     Fluxes(Fluxes),
@@ -1145,14 +1147,14 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Qdata,
 		    DataArray2d Slopes_x,
 		    DataArray2d Slopes_y,  
 		    DataArray2d Fluxes,
-		    real_t        dt,
-		    bool          gravity_enabled,
-		    VectorField2d gravity)
+		    real_t         dt,
+		    bool           gravity_enabled,
+		    GravityField2d gravity)
   {
     int nbCells = params.isize * params.jsize;
     ComputeTraceAndFluxes_Functor2D<dir> functor(params, Qdata,
@@ -1161,7 +1163,7 @@ public:
 						 dt,
 						 gravity_enabled,
 						 gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeTraceAndFluxes_Functor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -1341,7 +1343,7 @@ public:
   DataArray2d Fluxes;
   real_t dt, dtdx, dtdy;
   bool gravity_enabled;
-  VectorField2d gravity;
+  GravityField2d gravity;
   
 }; // ComputeTraceAndFluxes_Functor2D
 
@@ -1360,10 +1362,10 @@ public:
    * \param[in,out] Udata_out conservative variables at t(n+1)
    * \param[in] gravity is a vector field
    */
-  GravitySourceTermFunctor2D(HydroParams params,
+  GravitySourceTermFunctor2D(KernelParams params,
 			     DataArray2d Udata_in,
 			     DataArray2d Udata_out,
-			     VectorField2d gravity,
+			     GravityField2d gravity,
 			     real_t dt) :
     HydroBaseFunctor2D(params),
     Udata_in(Udata_in),
@@ -1373,15 +1375,15 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata_in,
                     DataArray2d Udata_out,
-		    VectorField2d gravity,
+		    GravityField2d gravity,
 		    real_t dt)
   {
     int nbCells = params.isize * params.jsize;
     GravitySourceTermFunctor2D functor(params, Udata_in, Udata_out, gravity, dt);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("GravitySourceTermFunctor2D", nbCells, functor);
   }
   
   KOKKOS_INLINE_FUNCTION
@@ -1423,7 +1425,7 @@ public:
   } // end operator ()
   
   DataArray2d Udata_in, Udata_out;
-  VectorField2d gravity;
+  GravityField2d gravity;
   real_t dt;
   
 }; // GravitySourceTermFunctor2D
@@ -7,8 +7,10 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "HydroBaseFunctor3D.h"
 #include "shared/RiemannSolvers.h"
+#include "shared/GravityField.h"
 
 namespace ppkMHD { namespace muscl {
 
@@ -25,19 +27,19 @@ public:
    * \param[in] params
    * \param[in] Udata
    */
-  ComputeDtFunctor3D(HydroParams params,
+  ComputeDtFunctor3D(KernelParams params,
 		     DataArray3d Udata) :
     HydroBaseFunctor3D(params),
     Udata(Udata)  {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    int nbCells,
                     real_t& invDt)
   {
     ComputeDtFunctor3D functor(params, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDtFunctor3D", nbCells, functor, invDt);
   }
 
   // Tell each thread how to initialize its reduction result.
@@ -134,10 +136,10 @@ public:
    * \param[in] params
    * \param[in] Udata
    */
-  ComputeDtGravityFunctor3D(HydroParams   params,
-			    real_t        cfl,
-			    VectorField3d gravity,
-			    DataArray3d   Udata) :
+  ComputeDtGravityFunctor3D(KernelParams   params,
+			    real_t         cfl,
+			    GravityField3d gravity,
+			    DataArray3d    Udata) :
     HydroBaseFunctor3D(params),
     cfl(cfl),
     gravity(gravity),
@@ -145,15 +147,15 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams   params,
-		    real_t        cfl,
-		    VectorField3d gravity,
-                    DataArray3d   Udata,
-		    int           nbCells,
-                    real_t&       invDt)
+  static void apply(KernelParams   params,
+		    real_t         cfl,
+		    GravityField3d gravity,
+                    DataArray3d    Udata,
+		    int            nbCells,
+                    real_t&        invDt)
   {
     ComputeDtGravityFunctor3D functor(params, cfl, gravity, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDtGravityFunctor3D", nbCells, functor, invDt);
   }
 
   // Tell each thread how to initialize its reduction result.
@@ -250,7 +252,7 @@ public:
   } // join
 
   real_t cfl;
-  VectorField3d gravity;
+  GravityField3d gravity;
   DataArray3d Udata;
   
 }; // ComputeDtGravityFunctor3D
@@ -269,19 +271,19 @@ public:
    * \param[in] Udata conservative variables
    * \param[out] Qdata primitive variables
    */
-  ConvertToPrimitivesFunctor3D(HydroParams params,
+  ConvertToPrimitivesFunctor3D(KernelParams params,
 			       DataArray3d Udata,
 			       DataArray3d Qdata) :
     HydroBaseFunctor3D(params), Udata(Udata), Qdata(Qdata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
                     DataArray3d Qdata)
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     ConvertToPrimitivesFunctor3D functor(params, Udata, Qdata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ConvertToPrimitivesFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -350,14 +352,14 @@ public:
    * \param[in] gravity_enabled boolean value to activate static gravity
    * \param[in] gravity is a vector field 
    */
-  ComputeAndStoreFluxesFunctor3D(HydroParams params,
+  ComputeAndStoreFluxesFunctor3D(KernelParams params,
 				 DataArray3d Qdata,
 				 DataArray3d FluxData_x,
 				 DataArray3d FluxData_y,
 				 DataArray3d FluxData_z,
 				 real_t dt,
 				 bool gravity_enabled,
-				 VectorField3d gravity) :
+				 GravityField3d gravity) :
     HydroBaseFunctor3D(params),
     Qdata(Qdata),
     FluxData_x(FluxData_x),
@@ -372,14 +374,14 @@ public:
  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Qdata,
 		    DataArray3d FluxData_x,
 		    DataArray3d FluxData_y,
 		    DataArray3d FluxData_z,
 		    real_t dt,
 		    bool gravity_enabled,
-		    VectorField3d gravity)
+		    GravityField3d gravity)
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     ComputeAndStoreFluxesFunctor3D functor(params, Qdata,
@@ -387,7 +389,7 @@ public:
 					   dt,
 					   gravity_enabled,
 					   gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeAndStoreFluxesFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -775,7 +777,7 @@ public:
   DataArray3d FluxData_z;
   real_t dt, dtdx, dtdy, dtdz;
   bool gravity_enabled;
-  VectorField3d gravity;
+  GravityField3d gravity;
   
 }; // ComputeAndStoreFluxesFunctor3D
   
@@ -796,7 +798,7 @@ public:
    * \param[in] FluxData_y flux coming from the left neighbor along Y
    * \param[in] FluxData_z flux coming from the left neighbor along Z
    */
-  UpdateFunctor3D(HydroParams params,
+  UpdateFunctor3D(KernelParams params,
 		  DataArray3d Udata,
 		  DataArray3d FluxData_x,
 		  DataArray3d FluxData_y,
@@ -808,7 +810,7 @@ public:
     FluxData_z(FluxData_z) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    DataArray3d FluxData_x,
 		    DataArray3d FluxData_y,
@@ -816,7 +818,7 @@ public:
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     UpdateFunctor3D functor(params, Udata, FluxData_x, FluxData_y, FluxData_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -897,7 +899,7 @@ public:
    * \param[in] FluxData flux coming from the left neighbor along direction dir
    *
    */
-  UpdateDirFunctor3D(HydroParams params,
+  UpdateDirFunctor3D(KernelParams params,
 		     DataArray3d Udata,
 		     DataArray3d FluxData) :
     HydroBaseFunctor3D(params),
@@ -905,13 +907,13 @@ public:
     FluxData(FluxData) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    DataArray3d FluxData)
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     UpdateDirFunctor3D<dir> functor(params, Udata, FluxData);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateDirFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -998,7 +1000,7 @@ public:
    * \param[out] Slopes_y limited slopes along direction Y
    * \param[out] Slopes_z limited slopes along direction Z
    */
-  ComputeSlopesFunctor3D(HydroParams params,
+  ComputeSlopesFunctor3D(KernelParams params,
 			 DataArray3d Qdata,
 			 DataArray3d Slopes_x,
 			 DataArray3d Slopes_y,
@@ -1007,7 +1009,7 @@ public:
     Slopes_x(Slopes_x), Slopes_y(Slopes_y), Slopes_z(Slopes_z) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Qdata,
 		    DataArray3d Slopes_x,
 		    DataArray3d Slopes_y,
@@ -1015,7 +1017,7 @@ public:
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     ComputeSlopesFunctor3D functor(params, Qdata, Slopes_x, Slopes_y, Slopes_z);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeSlopesFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -1145,7 +1147,7 @@ public:
    *
    * \tparam dir direction along which fluxes are computed.
    */
-  ComputeTraceAndFluxes_Functor3D(HydroParams params,
+  ComputeTraceAndFluxes_Functor3D(KernelParams params,
 				  DataArray3d Qdata,
 				  DataArray3d Slopes_x,
 				  DataArray3d Slopes_y,
@@ -1153,7 +1155,7 @@ public:
 				  DataArray3d Fluxes,
 				  real_t    dt,
 				  bool gravity_enabled,
-				  VectorField3d gravity) :
+				  GravityField3d gravity) :
     HydroBaseFunctor3D(params), Qdata(Qdata),
     Slopes_x(Slopes_x), Slopes_y(Slopes_y), Slopes_z(Slopes_z),
     Fluxes(Fluxes),
@@ -1164,15 +1166,15 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Qdata,
 		    DataArray3d Slopes_x,
 		    DataArray3d Slopes_y,
 		    DataArray3d Slopes_z,
 		    DataArray3d Fluxes,
-		    real_t        dt,
-		    bool          gravity_enabled,
-		    VectorField3d gravity)
+		    real_t         dt,
+		    bool           gravity_enabled,
+		    GravityField3d gravity)
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     ComputeTraceAndFluxes_Functor3D<dir> functor(params, Qdata,
@@ -1181,7 +1183,7 @@ public:
 						 dt,
 						 gravity_enabled,
 						 gravity);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeTraceAndFluxes_Functor3D", nbCells, functor);
   }
   
   KOKKOS_INLINE_FUNCTION
@@ -1465,7 +1467,7 @@ public:
   DataArray3d Fluxes;
   real_t dt, dtdx, dtdy, dtdz;
   bool gravity_enabled;
-  VectorField3d gravity;
+  GravityField3d gravity;
   
 }; // ComputeTraceAndFluxes_Functor3D
 
@@ -1483,10 +1485,10 @@ public:
    * \param[in,out] Udata_out conservative variables at t(n+1)
    * \param[in] gravity is a vector field
    */
-  GravitySourceTermFunctor3D(HydroParams params,
+  GravitySourceTermFunctor3D(KernelParams params,
 			     DataArray3d Udata_in,
 			     DataArray3d Udata_out,
-			     VectorField3d gravity,
+			     GravityField3d gravity,
 			     real_t dt) :
     HydroBaseFunctor3D(params),
     Udata_in(Udata_in),
@@ -1496,15 +1498,15 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata_in,
                     DataArray3d Udata_out,
-		    VectorField3d gravity,
+		    GravityField3d gravity,
 		    real_t dt)
   {
     int nbCells = params.isize * params.jsize * params.ksize;
     GravitySourceTermFunctor3D functor(params, Udata_in, Udata_out, gravity, dt);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("GravitySourceTermFunctor3D", nbCells, functor);
   }
   
   KOKKOS_INLINE_FUNCTION
@@ -1552,7 +1554,7 @@ public:
   } // end operator ()
   
   DataArray3d Udata_in, Udata_out;
-  VectorField3d gravity;
+  GravityField3d gravity;
   real_t dt;
   
 }; // GravitySourceTermFunctor3D
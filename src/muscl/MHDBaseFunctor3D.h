@@ -3,7 +3,7 @@
 
 #include "shared/kokkos_shared.h"
 
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 
 namespace ppkMHD { namespace muscl {
@@ -20,10 +20,10 @@ public:
   using HydroState = MHDState;
   using DataArray  = DataArray3d;
 
-  MHDBaseFunctor3D(HydroParams params) : params(params) {};
+  MHDBaseFunctor3D(KernelParams params) : params(params) {};
   virtual ~MHDBaseFunctor3D() {};
 
-  HydroParams params;
+  KernelParams params;
   const int nbvar = params.nbvar;
 
   // utility routines used in various computational kernels
@@ -33,19 +33,19 @@ namespace ppkMHD { namespace muscl {
 class InitImplodeFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
-  InitImplodeFunctor2D_MHD(HydroParams params,
+  InitImplodeFunctor2D_MHD(KernelParams params,
 			   ImplodeParams iparams,
                DataArray2d Udata) :
     MHDBaseFunctor2D(params), iparams(iparams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     ImplodeParams iparams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitImplodeFunctor2D_MHD functor(params, iparams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitImplodeFunctor2D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -142,19 +142,19 @@ public:
 class InitBlastFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
-  InitBlastFunctor2D_MHD(HydroParams params,
+  InitBlastFunctor2D_MHD(KernelParams params,
 			 BlastParams bParams,
 			 DataArray2d Udata) :
     MHDBaseFunctor2D(params), bParams(bParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    BlastParams bParams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitBlastFunctor2D_MHD functor(params, bParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitBlastFunctor2D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -251,13 +251,13 @@ private:
 
   
 public:
-  InitOrszagTangFunctor2D(HydroParams params,
+  InitOrszagTangFunctor2D(KernelParams params,
 			  OrszagTangParams otParams,
                           DataArray2d Udata) :
     MHDBaseFunctor2D(params), otParams(otParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     OrszagTangParams otParams,
                     DataArray2d Udata,
 		    int         nbCells)
@@ -265,10 +265,10 @@ public:
     InitOrszagTangFunctor2D functor(params, otParams, Udata);
 
     functor.phase = INIT_ALL_VAR_BUT_ENERGY;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitOrszagTangFunctor2D", nbCells, functor);
 
     functor.phase = INIT_ENERGY;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitOrszagTangFunctor2D", nbCells, functor);
     
   }
 
@@ -398,7 +398,7 @@ class InitKelvinHelmholtzFunctor2D_MHD : public MHDBaseFunctor2D {
 private:
   
 public:
-  InitKelvinHelmholtzFunctor2D_MHD(HydroParams params,
+  InitKelvinHelmholtzFunctor2D_MHD(KernelParams params,
 				   KHParams    khParams,
 				   DataArray2d Udata) :
     MHDBaseFunctor2D(params),
@@ -407,13 +407,13 @@ public:
     rand_pool(khParams.seed) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    KHParams    khParams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitKelvinHelmholtzFunctor2D_MHD functor(params, khParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);    
+    Kokkos::parallel_for("InitKelvinHelmholtzFunctor2D_MHD", nbCells, functor);    
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -599,19 +599,19 @@ public:
 class InitRotorFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
-  InitRotorFunctor2D_MHD(HydroParams params,
+  InitRotorFunctor2D_MHD(KernelParams params,
 			 RotorParams rParams,
 			 DataArray2d Udata) :
     MHDBaseFunctor2D(params), rParams(rParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    RotorParams rParams,
                     DataArray2d Udata,
 		    int         nbCells)
   {
     InitRotorFunctor2D_MHD functor(params, rParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitRotorFunctor2D_MHD", nbCells, functor);
   }
   
   KOKKOS_INLINE_FUNCTION
@@ -735,7 +735,7 @@ public:
   struct TagInitCond {};
   struct TagInitEnergy {};
 
-  InitFieldLoopFunctor2D_MHD(HydroParams     params,
+  InitFieldLoopFunctor2D_MHD(KernelParams    params,
 			     FieldLoopParams flParams,
 			     DataArray2d     Udata,
 			     int             nbCells) :
@@ -747,7 +747,7 @@ public:
   };
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    FieldLoopParams flParams,
                     DataArray2d Udata,
 		    int         nbCells)
@@ -755,13 +755,13 @@ public:
     InitFieldLoopFunctor2D_MHD functor(params, flParams, Udata, nbCells);
 
     functor.phase = COMPUTE_VECTOR_POTENTIAL;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFieldLoopFunctor2D_MHD", nbCells, functor);
 
     functor.phase = DO_INIT_CONDITION;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFieldLoopFunctor2D_MHD", nbCells, functor);
 
     functor.phase = DO_INIT_ENERGY;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFieldLoopFunctor2D_MHD", nbCells, functor);
 
   } // apply
   
@@ -950,7 +950,7 @@ class InitWaveFunctor2D_MHD : public MHDBaseFunctor2D {
   
 public:
   
-  InitWaveFunctor2D_MHD(HydroParams params,
+  InitWaveFunctor2D_MHD(KernelParams params,
 			WaveParams wParams,
 			DataArray2d Udata) :
     MHDBaseFunctor2D(params),
@@ -959,7 +959,7 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    WaveParams wParams,
 		    DataArray2d Udata,
 		    int         nbCells)
@@ -967,7 +967,7 @@ public:
     
     InitWaveFunctor2D_MHD functor(params, wParams, Udata);
     
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitWaveFunctor2D_MHD", nbCells, functor);
     
   }
 
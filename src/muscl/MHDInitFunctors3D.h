@@ -31,19 +31,19 @@ namespace ppkMHD { namespace muscl {
 class InitImplodeFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
-  InitImplodeFunctor3D_MHD(HydroParams params,
+  InitImplodeFunctor3D_MHD(KernelParams params,
 			   ImplodeParams iparams,
                DataArray3d Udata) :
     MHDBaseFunctor3D(params), iparams(iparams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     ImplodeParams iparams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitImplodeFunctor3D_MHD functor(params, iparams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitImplodeFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -152,19 +152,19 @@ public:
 class InitBlastFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
-  InitBlastFunctor3D_MHD(HydroParams params,
+  InitBlastFunctor3D_MHD(KernelParams params,
 			 BlastParams bParams,
 			 DataArray3d Udata) :
     MHDBaseFunctor3D(params), bParams(bParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    BlastParams bParams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitBlastFunctor3D_MHD functor(params, bParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitBlastFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -270,13 +270,13 @@ private:
   };
 
 public:
-  InitOrszagTangFunctor3D(HydroParams params,
+  InitOrszagTangFunctor3D(KernelParams params,
 			  OrszagTangParams otParams,
                           DataArray3d Udata) :
     MHDBaseFunctor3D(params), otParams(otParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     OrszagTangParams otParams,
                     DataArray3d Udata,
 		    int         nbCells)
@@ -284,10 +284,10 @@ public:
     InitOrszagTangFunctor3D functor(params, otParams, Udata);
 
     functor.phase = INIT_ALL_VAR_BUT_ENERGY;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitOrszagTangFunctor3D", nbCells, functor);
 
     functor.phase = INIT_ENERGY;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitOrszagTangFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -420,7 +420,7 @@ public:
 class InitKelvinHelmholtzFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
-  InitKelvinHelmholtzFunctor3D_MHD(HydroParams params,
+  InitKelvinHelmholtzFunctor3D_MHD(KernelParams params,
 				   KHParams khParams,
 				   DataArray3d Udata) :
     MHDBaseFunctor3D(params),
@@ -430,13 +430,13 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    KHParams    khParams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitKelvinHelmholtzFunctor3D_MHD functor(params, khParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitKelvinHelmholtzFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -635,19 +635,19 @@ public:
 class InitRotorFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
-  InitRotorFunctor3D_MHD(HydroParams params,
+  InitRotorFunctor3D_MHD(KernelParams params,
 			 RotorParams rParams,
 			 DataArray3d Udata) :
     MHDBaseFunctor3D(params), rParams(rParams), Udata(Udata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    RotorParams rParams,
                     DataArray3d Udata,
 		    int         nbCells)
   {
     InitRotorFunctor3D_MHD functor(params, rParams, Udata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitRotorFunctor3D_MHD", nbCells, functor);
   }
   
   KOKKOS_INLINE_FUNCTION
@@ -777,7 +777,7 @@ public:
   struct TagInitCond {};
   struct TagInitEnergy {};
 
-  InitFieldLoopFunctor3D_MHD(HydroParams     params,
+  InitFieldLoopFunctor3D_MHD(KernelParams    params,
 			     FieldLoopParams flParams,
 			     DataArray3d     Udata,
 			     int             nbCells) :
@@ -789,7 +789,7 @@ public:
   };
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    FieldLoopParams flParams,
                     DataArray3d Udata,
 		    int         nbCells)
@@ -797,13 +797,13 @@ public:
     InitFieldLoopFunctor3D_MHD functor(params, flParams, Udata, nbCells);
 
     functor.phase = COMPUTE_VECTOR_POTENTIAL;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFieldLoopFunctor3D_MHD", nbCells, functor);
 
     functor.phase = DO_INIT_CONDITION;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFieldLoopFunctor3D_MHD", nbCells, functor);
 
     functor.phase = DO_INIT_ENERGY;
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("InitFieldLoopFunctor3D_MHD", nbCells, functor);
 
   } // apply
   
@@ -1036,7 +1036,7 @@ private:
   };
 
 public:
-  InitWaveFunctor3D_MHD(HydroParams params,
+  InitWaveFunctor3D_MHD(KernelParams params,
 			WaveParams wParams,
 			 DataArray3d Udata,
        int         nbCells) :
@@ -1045,18 +1045,18 @@ public:
     A = DataArrayVector3("A", params.isize, params.jsize,params.ksize);
 
     phase = COMPUTE_VECTOR_POTENTIAL;
-    Kokkos::parallel_for(nbCells, *this);
+    Kokkos::parallel_for("InitWaveFunctor3D_MHD", nbCells, *this);
 
     phase = COMPUTE_FACE_CENTERED_B;
-    Kokkos::parallel_for(nbCells, *this);
+    Kokkos::parallel_for("InitWaveFunctor3D_MHD", nbCells, *this);
 
     phase = DO_INIT_CONDITION;
-    Kokkos::parallel_for(nbCells, *this);
+    Kokkos::parallel_for("InitWaveFunctor3D_MHD", nbCells, *this);
       
       };
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    WaveParams wParams,
                     DataArray3d Udata,
 		    int         nbCells)
@@ -7,6 +7,7 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "MHDBaseFunctor2D.h"
 #include "shared/RiemannSolvers_MHD.h"
 
@@ -23,18 +24,18 @@ class ComputeDtFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
   
-  ComputeDtFunctor2D_MHD(HydroParams params,
+  ComputeDtFunctor2D_MHD(KernelParams params,
 			 DataArray2d Qdata) :
     MHDBaseFunctor2D(params),
     Qdata(Qdata)  {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    int nbCells,
                     real_t& invDt) {
     ComputeDtFunctor2D_MHD functor(params, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDtFunctor2D_MHD", nbCells, functor, invDt);
   }
 
   // Tell each thread how to initialize its reduction result.
@@ -118,18 +119,18 @@ class ConvertToPrimitivesFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
 
-  ConvertToPrimitivesFunctor2D_MHD(HydroParams params,
+  ConvertToPrimitivesFunctor2D_MHD(KernelParams params,
 				   DataArray2d Udata,
 				   DataArray2d Qdata) :
     MHDBaseFunctor2D(params), Udata(Udata), Qdata(Qdata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
                     DataArray2d Qdata,
 		    int nbCells) {
     ConvertToPrimitivesFunctor2D_MHD functor(params, Udata, Qdata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ConvertToPrimitivesFunctor2D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -196,7 +197,7 @@ class ComputeFluxesAndStoreFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
 
-  ComputeFluxesAndStoreFunctor2D_MHD(HydroParams params,
+  ComputeFluxesAndStoreFunctor2D_MHD(KernelParams params,
 				     DataArray2d Qm_x,
 				     DataArray2d Qm_y,
 				     DataArray2d Qp_x,
@@ -212,7 +213,7 @@ public:
     dtdx(dtdx), dtdy(dtdy) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Qm_x,
                     DataArray2d Qm_y,
                     DataArray2d Qp_x,
@@ -228,7 +229,7 @@ public:
 					       Qp_x, Qp_y,
 					       Flux_x, Flux_y,
 					       dtdx, dtdy);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeFluxesAndStoreFunctor2D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -293,7 +294,7 @@ class ComputeEmfAndStoreFunctor2D : public MHDBaseFunctor2D {
 
 public:
 
-  ComputeEmfAndStoreFunctor2D(HydroParams params,
+  ComputeEmfAndStoreFunctor2D(KernelParams params,
 			      DataArray2d QEdge_RT,
 			      DataArray2d QEdge_RB,
 			      DataArray2d QEdge_LT,
@@ -308,7 +309,7 @@ public:
     dtdx(dtdx), dtdy(dtdy) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    DataArray2d QEdge_RT,
 		    DataArray2d QEdge_RB,
 		    DataArray2d QEdge_LT,
@@ -322,7 +323,7 @@ public:
 					QEdge_RT, QEdge_RB, QEdge_LT, QEdge_LB,
 					Emf,
 					dtdx, dtdy);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeEmfAndStoreFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -372,7 +373,7 @@ class ComputeTraceFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
 
-  ComputeTraceFunctor2D_MHD(HydroParams params,
+  ComputeTraceFunctor2D_MHD(KernelParams params,
 			    DataArray2d Udata,
 			    DataArray2d Qdata,
 			    DataArray2d Qm_x,
@@ -394,7 +395,7 @@ public:
     dtdx(dtdx), dtdy(dtdy) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    DataArray2d Udata,
 		    DataArray2d Qdata,
 		    DataArray2d Qm_x,
@@ -414,7 +415,7 @@ public:
 				      Qp_x, Qp_y,
 				      QEdge_RT, QEdge_RB, QEdge_LT, QEdge_LB,
 				      dtdx, dtdy);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeTraceFunctor2D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -488,7 +489,7 @@ class UpdateFunctor2D_MHD : public MHDBaseFunctor2D {
 
 public:
 
-  UpdateFunctor2D_MHD(HydroParams params,
+  UpdateFunctor2D_MHD(KernelParams params,
 		      DataArray2d Udata,
 		      DataArray2d FluxData_x,
 		      DataArray2d FluxData_y,
@@ -502,7 +503,7 @@ public:
     dtdy(dtdy) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    DataArray2d FluxData_x,
 		    DataArray2d FluxData_y,
@@ -511,7 +512,7 @@ public:
 		    int         nbCells)
   {
     UpdateFunctor2D_MHD functor(params, Udata, FluxData_x, FluxData_y, dtdx, dtdy);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateFunctor2D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -594,7 +595,7 @@ class UpdateEmfFunctor2D : public MHDBaseFunctor2D {
 
 public:
 
-  UpdateEmfFunctor2D(HydroParams params,
+  UpdateEmfFunctor2D(KernelParams params,
 		     DataArray2d Udata,
 		     DataArrayScalar Emf,
 		     real_t dtdx,
@@ -606,7 +607,7 @@ public:
     dtdy(dtdy){};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray2d Udata,
 		    DataArrayScalar Emf,
 		    real_t      dtdx,
@@ -615,7 +616,7 @@ public:
   {
     UpdateEmfFunctor2D functor(params, Udata, Emf,
 			       dtdx, dtdy);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateEmfFunctor2D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -651,23 +652,98 @@ public:
 /*************************************************/
 /*************************************************/
 /*************************************************/
+/**
+ * Base class for the low memory (implementationVersion 1) functors.
+ *
+ * Riemann states (qm, qp and qEdge) are not stored in global memory, they
+ * are recomputed on the fly from Q and the face-centered magnetic field
+ * each time a face or an edge needs them.
+ */
+class MHDTraceBaseFunctor2D : public MHDBaseFunctor2D {
+
+public:
+
+  MHDTraceBaseFunctor2D(KernelParams params,
+			DataArray2d Udata,
+			DataArray2d Qdata,
+			real_t dtdx,
+			real_t dtdy) :
+    MHDBaseFunctor2D(params),
+    Udata(Udata), Qdata(Qdata),
+    dtdx(dtdx), dtdy(dtdy) {};
+
+  /**
+   * Compute the trace of cell (i,j); same as ComputeTraceFunctor2D_MHD,
+   * but results are returned instead of stored.
+   */
+  KOKKOS_INLINE_FUNCTION
+  void compute_trace(int i, int j,
+		     MHDState (&qm)[2],
+		     MHDState (&qp)[2],
+		     MHDState (&qEdge)[4]) const
+  {
+    MHDState qNb[3][3];
+    BField  bfNb[4][4];
+    real_t c = 0.0;
+    
+    for (int di=0; di<3; di++)
+      for (int dj=0; dj<3; dj++) {
+	get_state(Qdata, i+di-1, j+dj-1, qNb[di][dj]);
+      }
+    
+    for (int di=0; di<4; di++)
+      for (int dj=0; dj<4; dj++) {
+	get_magField(Udata, i+di-1, j+dj-1, bfNb[di][dj]);
+      }
+    
+    trace_unsplit_mhd_2d(qNb, bfNb, c, dtdx, dtdy, 0.0, qm, qp, qEdge);
+    
+  } // compute_trace
+
+  DataArray2d Udata, Qdata;
+  real_t dtdx, dtdy;
+
+}; // MHDTraceBaseFunctor2D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Compute traces on the fly and fluxes along direction dir
+ * (implementationVersion 1).
+ *
+ * Fluxes are stored (raw, not multiplied by dt) in a single array shared
+ * by all directions, see UpdateDirFunctor2D_MHD.
+ */
 template <Direction dir>
-class ComputeTraceAndFluxes_Functor2D_MHD : public MHDBaseFunctor2D {
+class ComputeTraceAndFluxes_Functor2D_MHD : public MHDTraceBaseFunctor2D {
   
 public:
   
-  ComputeTraceAndFluxes_Functor2D_MHD(HydroParams params,
+  ComputeTraceAndFluxes_Functor2D_MHD(KernelParams params,
+				      DataArray2d Udata,
 				      DataArray2d Qdata,
-				      DataArray2d Slopes_x,
-				      DataArray2d Slopes_y,
 				      DataArray2d Fluxes,
 				      real_t    dtdx,
 				      real_t    dtdy) :
-    MHDBaseFunctor2D(params), Qdata(Qdata),
-    Slopes_x(Slopes_x), Slopes_y(Slopes_y),
-    Fluxes(Fluxes),
-    dtdx(dtdx), dtdy(dtdy) {};
+    MHDTraceBaseFunctor2D(params, Udata, Qdata, dtdx, dtdy),
+    Fluxes(Fluxes) {};
   
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    DataArray2d Udata,
+		    DataArray2d Qdata,
+		    DataArray2d Fluxes,
+		    real_t      dtdx,
+		    real_t      dtdy,
+		    int         nbCells)
+  {
+    ComputeTraceAndFluxes_Functor2D_MHD<dir> functor(params, Udata, Qdata,
+						     Fluxes,
+						     dtdx, dtdy);
+    ppkMHD::parallel_for_tuned("ComputeTraceAndFluxes_Functor2D_MHD", nbCells, functor);
+  }
+
   KOKKOS_INLINE_FUNCTION
   void operator()(const int& index) const
   {
@@ -678,141 +754,238 @@ public:
     int i,j;
     index2coord(index,i,j,isize,jsize);
     
-    if(j >= ghostWidth && j <= jsize-ghostWidth  &&
-       i >= ghostWidth && i <= isize-ghostWidth ) {
-
-	// local primitive variables
-	MHDState qLoc; // local primitive variables
-
-	// local primitive variables in neighbor cell
-	MHDState qLocNeighbor;
-
-	// Local slopes and neighbor slopes
-	MHDState dqX;
-	MHDState dqY;
-	MHDState dqX_neighbor;
-	MHDState dqY_neighbor;
-
-	// Local variables for Riemann problems solving
-	MHDState qleft;
-	MHDState qright;
-	//MHDState qgdnv;
-	MHDState flux;
-
-	//
-	// compute reconstructed states at left interface along X
-	//
-	qLoc[ID] = Qdata   (i,j, ID);
-	dqX[ID]  = Slopes_x(i,j, ID);
-	dqY[ID]  = Slopes_y(i,j, ID);
-	
-	qLoc[IP] = Qdata   (i,j, IP);
-	dqX[IP]  = Slopes_x(i,j, IP);
-	dqY[IP]  = Slopes_y(i,j, IP);
-	
-	qLoc[IU] = Qdata   (i,j, IU);
-	dqX[IU]  = Slopes_x(i,j, IU);
-	dqY[IU]  = Slopes_y(i,j, IU);
-	
-	qLoc[IV] = Qdata   (i,j, IV);
-	dqX[IV]  = Slopes_x(i,j, IV);
-	dqY[IV]  = Slopes_y(i,j, IV);
-
-	if (dir == XDIR) {
-
-	  // left interface : right state
-	  trace_unsplit_2d_along_dir(qLoc,
-				     dqX, dqY,
-				     dtdx, dtdy, FACE_XMIN, qright);
-	  
-	  qLocNeighbor[ID] = Qdata   (i-1,j, ID);
-	  dqX_neighbor[ID] = Slopes_x(i-1,j, ID);
-	  dqY_neighbor[ID] = Slopes_y(i-1,j, ID);
-	  
-	  qLocNeighbor[IP] = Qdata   (i-1,j, IP);
-	  dqX_neighbor[IP] = Slopes_x(i-1,j, IP);
-	  dqY_neighbor[IP] = Slopes_y(i-1,j, IP);
-	  
-	  qLocNeighbor[IU] = Qdata   (i-1,j, IU);
-	  dqX_neighbor[IU] = Slopes_x(i-1,j, IU);
-	  dqY_neighbor[IU] = Slopes_y(i-1,j, IU);
-	  
-	  qLocNeighbor[IV] = Qdata   (i-1,j, IV);
-	  dqX_neighbor[IV] = Slopes_x(i-1,j, IV);
-	  dqY_neighbor[IV] = Slopes_y(i-1,j, IV);
-	  
-	  // left interface : left state
-	  trace_unsplit_2d_along_dir(qLocNeighbor,
-				     dqX_neighbor,dqY_neighbor,
-				     dtdx, dtdy, FACE_XMAX, qleft);
-	  
-	  // Solve Riemann problem at X-interfaces and compute X-fluxes
-	  riemann_mhd(qleft,qright,flux,params);
-
-	  //
-	  // store fluxes
-	  //	
-	  Fluxes(i,j , ID) =  flux[ID]*dtdx;
-	  Fluxes(i,j , IP) =  flux[IP]*dtdx;
-	  Fluxes(i,j , IU) =  flux[IU]*dtdx;
-	  Fluxes(i,j , IV) =  flux[IV]*dtdx;
-
-	} else if (dir == YDIR) {
-
-	  // left interface : right state
-	  trace_unsplit_2d_along_dir(qLoc,
-				     dqX, dqY,
-				     dtdx, dtdy, FACE_YMIN, qright);
-	  
-	  qLocNeighbor[ID] = Qdata   (i,j-1, ID);
-	  dqX_neighbor[ID] = Slopes_x(i,j-1, ID);
-	  dqY_neighbor[ID] = Slopes_y(i,j-1, ID);
-	  
-	  qLocNeighbor[IP] = Qdata   (i,j-1, IP);
-	  dqX_neighbor[IP] = Slopes_x(i,j-1, IP);
-	  dqY_neighbor[IP] = Slopes_y(i,j-1, IP);
-	  
-	  qLocNeighbor[IU] = Qdata   (i,j-1, IU);
-	  dqX_neighbor[IU] = Slopes_x(i,j-1, IU);
-	  dqY_neighbor[IU] = Slopes_y(i,j-1, IU);
-	  
-	  qLocNeighbor[IV] = Qdata   (i,j-1, IV);
-	  dqX_neighbor[IV] = Slopes_x(i,j-1, IV);
-	  dqY_neighbor[IV] = Slopes_y(i,j-1, IV);
-	  
-	  // left interface : left state
-	  trace_unsplit_2d_along_dir(qLocNeighbor,
-				     dqX_neighbor,dqY_neighbor,
-				     dtdx, dtdy, FACE_YMAX, qleft);
-	  
-	  // Solve Riemann problem at Y-interfaces and compute Y-fluxes
-	  swapValues(&(qleft[IU]) ,&(qleft[IV]) );
-	  swapValues(&(qright[IU]),&(qright[IV]));
-	  riemann_mhd(qleft,qright,flux,params);
-	  
-	  //
-	  // update hydro array
-	  //	  
-	  Fluxes(i,j , ID) =  flux[ID]*dtdy;
-	  Fluxes(i,j , IP) =  flux[IP]*dtdy;
-	  Fluxes(i,j , IU) =  flux[IV]*dtdy; // IU/IV swapped
-	  Fluxes(i,j , IV) =  flux[IU]*dtdy; // IU/IV swapped
+    if(j >= ghostWidth && j < jsize - ghostWidth+1 &&
+       i >= ghostWidth && i < isize - ghostWidth+1) {
 
-	}
-	      
+      MHDState qm[2];
+      MHDState qp[2];
+      MHDState qEdge[4];
+      
+      MHDState qleft, qright;
+      MHDState flux;
+      
+      if (dir == XDIR) {
+
+	// left state: trace of left neighbor
+	compute_trace(i-1,j  , qm, qp, qEdge);
+	qleft = qm[0];
+
+	// right state: trace of current cell
+	compute_trace(i  ,j  , qm, qp, qEdge);
+	qright = qp[0];
+
+	// Solve Riemann problem at X-interfaces and compute X-fluxes
+	riemann_mhd(qleft,qright,flux,params);
+
+      } else if (dir == YDIR) {
+
+	compute_trace(i  ,j-1, qm, qp, qEdge);
+	qleft = qm[1];
+	swapValues(&(qleft[IU]) ,&(qleft[IV]) );
+	swapValues(&(qleft[IBX]) ,&(qleft[IBY]) );
+
+	compute_trace(i  ,j  , qm, qp, qEdge);
+	qright = qp[1];
+	swapValues(&(qright[IU]) ,&(qright[IV]) );
+	swapValues(&(qright[IBX]) ,&(qright[IBY]) );
+
+	// Solve Riemann problem at Y-interfaces and compute Y-fluxes
+	riemann_mhd(qleft,qright,flux,params);
+
+      }
+
+      // store fluxes
+      set_state(Fluxes, i  , j  , flux);
+      
     } // end if
     
   } // end operator ()
   
-  DataArray2d Qdata;
-  DataArray2d Slopes_x, Slopes_y;
   DataArray2d Fluxes;
-  real_t dtdx, dtdy;
   
 }; // ComputeTraceAndFluxes_Functor2D_MHD
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Compute traces on the fly and emf (implementationVersion 1).
+ *
+ * Same as ComputeEmfAndStoreFunctor2D, but the 4 edge states are recomputed
+ * from the 4 cells sharing the edge instead of being read from the QEdge
+ * arrays.
+ */
+class ComputeTraceAndEmf_Functor2D_MHD : public MHDTraceBaseFunctor2D {
+
+public:
+
+  ComputeTraceAndEmf_Functor2D_MHD(KernelParams params,
+				   DataArray2d Udata,
+				   DataArray2d Qdata,
+				   DataArrayScalar Emf,
+				   real_t dtdx,
+				   real_t dtdy) :
+    MHDTraceBaseFunctor2D(params, Udata, Qdata, dtdx, dtdy),
+    Emf(Emf) {};
+  
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    DataArray2d Udata,
+		    DataArray2d Qdata,
+		    DataArrayScalar Emf,
+		    real_t      dtdx,
+		    real_t      dtdy,
+		    int         nbCells)
+  {
+    ComputeTraceAndEmf_Functor2D_MHD functor(params, Udata, Qdata,
+					     Emf,
+					     dtdx, dtdy);
+    ppkMHD::parallel_for_tuned("ComputeTraceAndEmf_Functor2D_MHD", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ghostWidth = params.ghostWidth;
+    
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+    
+    if(j >= ghostWidth && j < jsize - ghostWidth+1 &&
+       i >= ghostWidth && i < isize - ghostWidth+1) {
+
+      MHDState qm[2];
+      MHDState qp[2];
+      MHDState qEdge[4];
+
+      // in 2D, we only need to compute emfZ
+      MHDState qEdge_emfZ[4];
+
+      compute_trace(i-1,j-1, qm, qp, qEdge);
+      qEdge_emfZ[IRT] = qEdge[IRT];
+
+      compute_trace(i-1,j  , qm, qp, qEdge);
+      qEdge_emfZ[IRB] = qEdge[IRB];
+
+      compute_trace(i  ,j-1, qm, qp, qEdge);
+      qEdge_emfZ[ILT] = qEdge[ILT];
+
+      compute_trace(i  ,j  , qm, qp, qEdge);
+      qEdge_emfZ[ILB] = qEdge[ILB];
+
+      // actually compute emfZ
+      Emf(i,j) = compute_emf<EMFZ>(qEdge_emfZ,params);
+      
+    }
+  }
+
+  DataArrayScalar Emf;
+
+}; // ComputeTraceAndEmf_Functor2D_MHD
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Hydro update (and Bz, which is not handled by the emf in 2D) using the
+ * fluxes along direction dir (implementationVersion 1).
+ */
+template <Direction dir>
+class UpdateDirFunctor2D_MHD : public MHDBaseFunctor2D {
+
+public:
+
+  UpdateDirFunctor2D_MHD(KernelParams params,
+			 DataArray2d Udata,
+			 DataArray2d FluxData,
+			 real_t dtdir) :
+    MHDBaseFunctor2D(params),
+    Udata(Udata), 
+    FluxData(FluxData),
+    dtdir(dtdir) {};
+  
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+                    DataArray2d Udata,
+		    DataArray2d FluxData,
+		    real_t      dtdir,
+		    int         nbCells)
+  {
+    UpdateDirFunctor2D_MHD<dir> functor(params, Udata, FluxData, dtdir);
+    Kokkos::parallel_for("UpdateDirFunctor2D_MHD", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ghostWidth = params.ghostWidth;
+    
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+
+    if(j >= ghostWidth && j < jsize-ghostWidth  &&
+       i >= ghostWidth && i < isize-ghostWidth ) {
+
+      MHDState udata;
+      MHDState flux;
+      get_state(Udata, i,j, udata);
+
+      if (dir == XDIR) {
+
+	get_state(FluxData, i  ,j  , flux);
+	udata[ID]  +=  flux[ID]*dtdir;
+	udata[IP]  +=  flux[IP]*dtdir;
+	udata[IU]  +=  flux[IU]*dtdir;
+	udata[IV]  +=  flux[IV]*dtdir;
+	udata[IW]  +=  flux[IW]*dtdir;
+	udata[IBZ] +=  flux[IBZ]*dtdir;
+	
+	get_state(FluxData, i+1,j  , flux);
+	udata[ID]  -=  flux[ID]*dtdir;
+	udata[IP]  -=  flux[IP]*dtdir;
+	udata[IU]  -=  flux[IU]*dtdir;
+	udata[IV]  -=  flux[IV]*dtdir;
+	udata[IW]  -=  flux[IW]*dtdir;
+	udata[IBZ] -=  flux[IBZ]*dtdir;
+
+      } else if (dir == YDIR) {
+
+	get_state(FluxData, i  ,j  , flux);
+	udata[ID]  +=  flux[ID]*dtdir;
+	udata[IP]  +=  flux[IP]*dtdir;
+	udata[IU]  +=  flux[IV]*dtdir; //
+	udata[IV]  +=  flux[IU]*dtdir; //
+	udata[IW]  +=  flux[IW]*dtdir;
+	udata[IBZ] +=  flux[IBZ]*dtdir;
+	
+	get_state(FluxData, i  ,j+1, flux);
+	udata[ID]  -=  flux[ID]*dtdir;
+	udata[IP]  -=  flux[IP]*dtdir;
+	udata[IU]  -=  flux[IV]*dtdir; //
+	udata[IV]  -=  flux[IU]*dtdir; //
+	udata[IW]  -=  flux[IW]*dtdir;
+	udata[IBZ] -=  flux[IBZ]*dtdir;
+
+      }
+
+      // write back result in Udata
+      set_state(Udata, i,j, udata);
+      
+    } // end if
+    
+  } // end operator ()
+  
+  DataArray2d Udata;
+  DataArray2d FluxData;
+  real_t dtdir;
+  
+}; // UpdateDirFunctor2D_MHD
+
 } // namespace muscl
 } // namespace ppkMHD
 
 #endif // MHD_RUN_FUNCTORS_2D_H_
-
@@ -7,6 +7,7 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "MHDBaseFunctor3D.h"
 #include "shared/RiemannSolvers_MHD.h"
 
@@ -23,18 +24,18 @@ class ComputeDtFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
   
-  ComputeDtFunctor3D_MHD(HydroParams params,
+  ComputeDtFunctor3D_MHD(KernelParams params,
 			 DataArray3d Qdata) :
     MHDBaseFunctor3D(params),
     Qdata(Qdata)  {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    int nbCells,
                     real_t& invDt) {
     ComputeDtFunctor3D_MHD functor(params, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDtFunctor3D_MHD", nbCells, functor, invDt);
   }
 
   // Tell each thread how to initialize its reduction result.
@@ -122,18 +123,18 @@ class ConvertToPrimitivesFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
 
-  ConvertToPrimitivesFunctor3D_MHD(HydroParams params,
+  ConvertToPrimitivesFunctor3D_MHD(KernelParams params,
 				   DataArray3d Udata,
 				   DataArray3d Qdata) :
     MHDBaseFunctor3D(params), Udata(Udata), Qdata(Qdata)  {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
                     DataArray3d Qdata,
 		    int nbCells) {
     ConvertToPrimitivesFunctor3D_MHD functor(params, Udata, Qdata);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ConvertToPrimitivesFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -202,7 +203,7 @@ class ComputeElecFieldFunctor3D : public MHDBaseFunctor3D {
 
 public:
 
-  ComputeElecFieldFunctor3D(HydroParams params,
+  ComputeElecFieldFunctor3D(KernelParams params,
 			    DataArray3d Udata,
 			    DataArray3d Qdata,
 			    DataArrayVector3 ElecField) :
@@ -210,13 +211,13 @@ public:
     Udata(Udata), Qdata(Qdata), ElecField(ElecField) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
                     DataArray3d Qdata,
 		    DataArrayVector3 ElecField,
 		    int nbCells) {
     ComputeElecFieldFunctor3D functor(params, Udata, Qdata, ElecField);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeElecFieldFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -309,7 +310,7 @@ class ComputeMagSlopesFunctor3D : public MHDBaseFunctor3D {
 
 public:
 
-  ComputeMagSlopesFunctor3D(HydroParams      params,
+  ComputeMagSlopesFunctor3D(KernelParams     params,
 			    DataArray3d      Udata,
 			    DataArrayVector3 DeltaA,
 			    DataArrayVector3 DeltaB,
@@ -318,14 +319,14 @@ public:
     DeltaA(DeltaA), DeltaB(DeltaB), DeltaC(DeltaC) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams      params,
+  static void apply(KernelParams     params,
                     DataArray3d      Udata,
 		    DataArrayVector3 DeltaA,
 		    DataArrayVector3 DeltaB,
 		    DataArrayVector3 DeltaC,
 		    int nbCells) {
     ComputeMagSlopesFunctor3D functor(params, Udata, DeltaA, DeltaB, DeltaC);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("ComputeMagSlopesFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -402,7 +403,7 @@ class ComputeTraceFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
 
-  ComputeTraceFunctor3D_MHD(HydroParams params,
+  ComputeTraceFunctor3D_MHD(KernelParams params,
 			    DataArray3d Udata,
 			    DataArray3d Qdata,
 			    DataArrayVector3 DeltaA,
@@ -441,7 +442,7 @@ public:
     dtdx(dtdx), dtdy(dtdy), dtdz(dtdz) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    DataArray3d Udata,
 		    DataArray3d Qdata,
 		    DataArrayVector3 DeltaA,
@@ -479,7 +480,7 @@ public:
 				      QEdge_RT2, QEdge_RB2, QEdge_LT2, QEdge_LB2,
 				      QEdge_RT3, QEdge_RB3, QEdge_LT3, QEdge_LB3,
 				      dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeTraceFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -679,7 +680,7 @@ class ComputeFluxesAndStoreFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
 
-  ComputeFluxesAndStoreFunctor3D_MHD(HydroParams params,
+  ComputeFluxesAndStoreFunctor3D_MHD(KernelParams params,
 				     DataArray3d Qm_x,
 				     DataArray3d Qm_y,
 				     DataArray3d Qm_z,
@@ -699,7 +700,7 @@ public:
     dtdx(dtdx), dtdy(dtdy), dtdz(dtdz) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Qm_x,
                     DataArray3d Qm_y,
                     DataArray3d Qm_z,
@@ -719,7 +720,7 @@ public:
 					       Qp_x, Qp_y, Qp_z,
 					       Flux_x, Flux_y, Flux_z,
 					       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeFluxesAndStoreFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -804,7 +805,7 @@ class ComputeEmfAndStoreFunctor3D : public MHDBaseFunctor3D {
   
 public:
   
-  ComputeEmfAndStoreFunctor3D(HydroParams params,
+  ComputeEmfAndStoreFunctor3D(KernelParams params,
 			      DataArray3d QEdge_RT,
 			      DataArray3d QEdge_RB,
 			      DataArray3d QEdge_LT,
@@ -829,7 +830,7 @@ public:
     dtdx(dtdx), dtdy(dtdy), dtdz(dtdz) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
 		    DataArray3d QEdge_RT,
 		    DataArray3d QEdge_RB,
 		    DataArray3d QEdge_LT,
@@ -854,7 +855,7 @@ public:
 					QEdge_RT3, QEdge_RB3, QEdge_LT3, QEdge_LB3,
 					Emf,
 					dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeEmfAndStoreFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -923,7 +924,7 @@ class UpdateFunctor3D_MHD : public MHDBaseFunctor3D {
 
 public:
 
-  UpdateFunctor3D_MHD(HydroParams params,
+  UpdateFunctor3D_MHD(KernelParams params,
 		      DataArray3d Udata,
 		      DataArray3d FluxData_x,
 		      DataArray3d FluxData_y,
@@ -941,7 +942,7 @@ public:
     dtdz(dtdz) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    DataArray3d FluxData_x,
 		    DataArray3d FluxData_y,
@@ -954,7 +955,7 @@ public:
     UpdateFunctor3D_MHD functor(params, Udata,
 				FluxData_x, FluxData_y, FluxData_z,
 				dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateFunctor3D_MHD", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -1007,11 +1008,11 @@ public:
       udata[IW]  -=  flux[IW]*dtdy;
 
       get_state(FluxData_z, i  ,j  ,k  , flux);
-      udata[ID]  +=  flux[ID]*dtdy;
-      udata[IP]  +=  flux[IP]*dtdy;
-      udata[IU]  +=  flux[IW]*dtdy; //
-      udata[IV]  +=  flux[IV]*dtdy;
-      udata[IW]  +=  flux[IU]*dtdy; //
+      udata[ID]  +=  flux[ID]*dtdz;
+      udata[IP]  +=  flux[IP]*dtdz;
+      udata[IU]  +=  flux[IW]*dtdz; //
+      udata[IV]  +=  flux[IV]*dtdz;
+      udata[IW]  +=  flux[IU]*dtdz; //
 
       get_state(FluxData_z, i  ,j  ,k+1, flux);
       udata[ID]  -=  flux[ID]*dtdz;
@@ -1040,7 +1041,7 @@ class UpdateEmfFunctor3D : public MHDBaseFunctor3D {
 
 public:
 
-  UpdateEmfFunctor3D(HydroParams params,
+  UpdateEmfFunctor3D(KernelParams params,
 		     DataArray3d Udata,
 		     DataArrayVector3 Emf,
 		     real_t dtdx,
@@ -1054,7 +1055,7 @@ public:
     dtdz(dtdz) {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams params,
+  static void apply(KernelParams params,
                     DataArray3d Udata,
 		    DataArrayVector3 Emf,
 		    real_t      dtdx,
@@ -1064,7 +1065,7 @@ public:
   {
     UpdateEmfFunctor3D functor(params, Udata, Emf,
 			       dtdx, dtdy, dtdz);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("UpdateEmfFunctor3D", nbCells, functor);
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -1122,6 +1123,897 @@ public:
 
 }; // UpdateEmfFunctor3D
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Fused version of ComputeFluxesAndStoreFunctor3D_MHD,
+ * ComputeEmfAndStoreFunctor3D, UpdateFunctor3D_MHD and UpdateEmfFunctor3D.
+ *
+ * The domain is split into tiles of TILE_X x TILE_Y x TILE_Z cells, one
+ * tile per team. Each team first computes the face fluxes (hydro components
+ * only) and edge emfs of its tile into team scratch memory, so that each
+ * face / edge shared by two neighbor cells of the tile is computed once,
+ * then applies both the hydro and the induction updates on Udata.
+ *
+ * Fluxes_x/y/z and Emf arrays are not used anymore.
+ *
+ * Face fluxes and emfs are only evaluated in the same index range as in
+ * the non-fused functors (zero outside), so that results are identical.
+ */
+class ComputeFluxesEmfAndUpdateFunctor3D_MHD : public MHDBaseFunctor3D {
+
+public:
+
+  using team_policy_t  = Kokkos::TeamPolicy<Device>;
+  using team_member_t  = team_policy_t::member_type;
+  using scratch_view_t = Kokkos::View<real_t*,
+				      Device::scratch_memory_space,
+				      Kokkos::MemoryTraits<Kokkos::Unmanaged> >;
+
+  //! tile sizes and number of stored flux components (ID,IP,IU,IV,IW)
+  enum {
+    TILE_X = 8,
+    TILE_Y = 4,
+    TILE_Z = 4,
+    NB_FLUX = 5
+  };
+
+  ComputeFluxesEmfAndUpdateFunctor3D_MHD(KernelParams params,
+					 DataArray3d Udata,
+					 DataArray3d Qm_x,
+					 DataArray3d Qm_y,
+					 DataArray3d Qm_z,
+					 DataArray3d Qp_x,
+					 DataArray3d Qp_y,
+					 DataArray3d Qp_z,
+					 DataArray3d QEdge_RT,
+					 DataArray3d QEdge_RB,
+					 DataArray3d QEdge_LT,
+					 DataArray3d QEdge_LB,
+					 DataArray3d QEdge_RT2,
+					 DataArray3d QEdge_RB2,
+					 DataArray3d QEdge_LT2,
+					 DataArray3d QEdge_LB2,
+					 DataArray3d QEdge_RT3,
+					 DataArray3d QEdge_RB3,
+					 DataArray3d QEdge_LT3,
+					 DataArray3d QEdge_LB3,
+					 real_t dtdx,
+					 real_t dtdy,
+					 real_t dtdz) :
+    MHDBaseFunctor3D(params),
+    Udata(Udata),
+    Qm_x(Qm_x), Qm_y(Qm_y), Qm_z(Qm_z),
+    Qp_x(Qp_x), Qp_y(Qp_y), Qp_z(Qp_z),
+    QEdge_RT (QEdge_RT),  QEdge_RB (QEdge_RB),  QEdge_LT (QEdge_LT),  QEdge_LB (QEdge_LB),
+    QEdge_RT2(QEdge_RT2), QEdge_RB2(QEdge_RB2), QEdge_LT2(QEdge_LT2), QEdge_LB2(QEdge_LB2),
+    QEdge_RT3(QEdge_RT3), QEdge_RB3(QEdge_RB3), QEdge_LT3(QEdge_LT3), QEdge_LB3(QEdge_LB3),
+    dtdx(dtdx), dtdy(dtdy), dtdz(dtdz)
+  {
+    // cells to update are in range [ghostWidth, size-ghostWidth]
+    // (upper bound included, for the induction update)
+    const int ghostWidth = params.ghostWidth;
+    ntx = (params.isize - 2*ghostWidth + 1 + TILE_X - 1) / TILE_X;
+    nty = (params.jsize - 2*ghostWidth + 1 + TILE_Y - 1) / TILE_Y;
+    ntz = (params.ksize - 2*ghostWidth + 1 + TILE_Z - 1) / TILE_Z;
+  };
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    DataArray3d Udata,
+		    DataArray3d Qm_x,
+		    DataArray3d Qm_y,
+		    DataArray3d Qm_z,
+		    DataArray3d Qp_x,
+		    DataArray3d Qp_y,
+		    DataArray3d Qp_z,
+		    DataArray3d QEdge_RT,
+		    DataArray3d QEdge_RB,
+		    DataArray3d QEdge_LT,
+		    DataArray3d QEdge_LB,
+		    DataArray3d QEdge_RT2,
+		    DataArray3d QEdge_RB2,
+		    DataArray3d QEdge_LT2,
+		    DataArray3d QEdge_LB2,
+		    DataArray3d QEdge_RT3,
+		    DataArray3d QEdge_RB3,
+		    DataArray3d QEdge_LT3,
+		    DataArray3d QEdge_LB3,
+		    real_t dtdx,
+		    real_t dtdy,
+		    real_t dtdz)
+  {
+    ComputeFluxesEmfAndUpdateFunctor3D_MHD functor(params, Udata,
+						   Qm_x, Qm_y, Qm_z,
+						   Qp_x, Qp_y, Qp_z,
+						   QEdge_RT , QEdge_RB , QEdge_LT , QEdge_LB ,
+						   QEdge_RT2, QEdge_RB2, QEdge_LT2, QEdge_LB2,
+						   QEdge_RT3, QEdge_RB3, QEdge_LT3, QEdge_LB3,
+						   dtdx, dtdy, dtdz);
+
+    // one team per tile, team size chosen by the autotuner
+    ppkMHD::parallel_for_tuned_team("ComputeFluxesEmfAndUpdateFunctor3D_MHD",
+                                    functor.ntx*functor.nty*functor.ntz,
+                                    scratch_size(),
+                                    functor);
+  }
+
+  //! number of faces / edges stored in scratch memory
+  KOKKOS_INLINE_FUNCTION
+  static int nb_faces_x() { return (TILE_X+1)*TILE_Y*TILE_Z; }
+  KOKKOS_INLINE_FUNCTION
+  static int nb_faces_y() { return TILE_X*(TILE_Y+1)*TILE_Z; }
+  KOKKOS_INLINE_FUNCTION
+  static int nb_faces_z() { return TILE_X*TILE_Y*(TILE_Z+1); }
+  KOKKOS_INLINE_FUNCTION
+  static int nb_edges_z() { return (TILE_X+1)*(TILE_Y+1)*TILE_Z; }
+  KOKKOS_INLINE_FUNCTION
+  static int nb_edges_y() { return (TILE_X+1)*TILE_Y*(TILE_Z+1); }
+  KOKKOS_INLINE_FUNCTION
+  static int nb_edges_x() { return TILE_X*(TILE_Y+1)*(TILE_Z+1); }
+
+  //! team scratch memory size in bytes
+  static size_t scratch_size()
+  {
+    return
+      scratch_view_t::shmem_size(nb_faces_x()*NB_FLUX) +
+      scratch_view_t::shmem_size(nb_faces_y()*NB_FLUX) +
+      scratch_view_t::shmem_size(nb_faces_z()*NB_FLUX) +
+      scratch_view_t::shmem_size(nb_edges_z()) +
+      scratch_view_t::shmem_size(nb_edges_y()) +
+      scratch_view_t::shmem_size(nb_edges_x());
+  }
+
+  //! is (i,j,k) inside the range where fluxes / emfs are evaluated ?
+  KOKKOS_INLINE_FUNCTION
+  bool is_valid(int i, int j, int k) const
+  {
+    const int ghostWidth = params.ghostWidth;
+    return
+      k >= ghostWidth && k < params.ksize - ghostWidth+1 &&
+      j >= ghostWidth && j < params.jsize - ghostWidth+1 &&
+      i >= ghostWidth && i < params.isize - ghostWidth+1;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const team_member_t& team) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+    const int ghostWidth = params.ghostWidth;
+
+    // first cell of current tile
+    const int itile = team.league_rank();
+    const int i0 = ghostWidth + TILE_X * ( itile % ntx );
+    const int j0 = ghostWidth + TILE_Y * ( (itile / ntx) % nty );
+    const int k0 = ghostWidth + TILE_Z * ( itile / (ntx*nty) );
+
+    scratch_view_t fx (team.team_scratch(0), nb_faces_x()*NB_FLUX);
+    scratch_view_t fy (team.team_scratch(0), nb_faces_y()*NB_FLUX);
+    scratch_view_t fz (team.team_scratch(0), nb_faces_z()*NB_FLUX);
+    scratch_view_t emfz(team.team_scratch(0), nb_edges_z());
+    scratch_view_t emfy(team.team_scratch(0), nb_edges_y());
+    scratch_view_t emfx(team.team_scratch(0), nb_edges_x());
+
+    /*
+     * 1. face fluxes
+     */
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, nb_faces_x()),
+			 [&](const int& n) {
+      const int li = n % (TILE_X+1);
+      const int lj = (n / (TILE_X+1)) % TILE_Y;
+      const int lk = n / ((TILE_X+1)*TILE_Y);
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      MHDState flux = {};
+      if (is_valid(i,j,k)) {
+	MHDState qleft, qright;
+	get_state(Qm_x, i-1,j  ,k, qleft);
+	get_state(Qp_x, i  ,j  ,k, qright);
+	riemann_mhd(qleft,qright,flux,params);
+      }
+      for (int ivar=0; ivar<NB_FLUX; ++ivar)
+	fx(n*NB_FLUX+ivar) = flux[ivar];
+    });
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, nb_faces_y()),
+			 [&](const int& n) {
+      const int li = n % TILE_X;
+      const int lj = (n / TILE_X) % (TILE_Y+1);
+      const int lk = n / (TILE_X*(TILE_Y+1));
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      MHDState flux = {};
+      if (is_valid(i,j,k)) {
+	MHDState qleft, qright;
+	get_state(Qm_y, i,j-1,k, qleft);
+	swapValues(&(qleft[IU])  ,&(qleft[IV]) );
+	swapValues(&(qleft[IBX]) ,&(qleft[IBY]) );
+
+	get_state(Qp_y, i,j,k, qright);
+	swapValues(&(qright[IU])  ,&(qright[IV]) );
+	swapValues(&(qright[IBX]) ,&(qright[IBY]) );
+
+	riemann_mhd(qleft,qright,flux,params);
+      }
+      for (int ivar=0; ivar<NB_FLUX; ++ivar)
+	fy(n*NB_FLUX+ivar) = flux[ivar];
+    });
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, nb_faces_z()),
+			 [&](const int& n) {
+      const int li = n % TILE_X;
+      const int lj = (n / TILE_X) % TILE_Y;
+      const int lk = n / (TILE_X*TILE_Y);
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      MHDState flux = {};
+      if (is_valid(i,j,k)) {
+	MHDState qleft, qright;
+	get_state(Qm_z, i,j,k-1, qleft);
+	swapValues(&(qleft[IU])  ,&(qleft[IW]) );
+	swapValues(&(qleft[IBX]) ,&(qleft[IBZ]) );
+
+	get_state(Qp_z, i,j,k, qright);
+	swapValues(&(qright[IU])  ,&(qright[IW]) );
+	swapValues(&(qright[IBX]) ,&(qright[IBZ]) );
+
+	riemann_mhd(qleft,qright,flux,params);
+      }
+      for (int ivar=0; ivar<NB_FLUX; ++ivar)
+	fz(n*NB_FLUX+ivar) = flux[ivar];
+    });
+
+    /*
+     * 2. edge emfs
+     */
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, nb_edges_z()),
+			 [&](const int& n) {
+      const int li = n % (TILE_X+1);
+      const int lj = (n / (TILE_X+1)) % (TILE_Y+1);
+      const int lk = n / ((TILE_X+1)*(TILE_Y+1));
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      real_t emf = 0;
+      if (is_valid(i,j,k)) {
+	MHDState qEdge_emf[4];
+	get_state(QEdge_RT3, i-1,j-1,k  , qEdge_emf[IRT]);
+	get_state(QEdge_RB3, i-1,j  ,k  , qEdge_emf[IRB]);
+	get_state(QEdge_LT3, i  ,j-1,k  , qEdge_emf[ILT]);
+	get_state(QEdge_LB3, i  ,j  ,k  , qEdge_emf[ILB]);
+	emf = compute_emf<EMFZ>(qEdge_emf,params);
+      }
+      emfz(n) = emf;
+    });
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, nb_edges_y()),
+			 [&](const int& n) {
+      const int li = n % (TILE_X+1);
+      const int lj = (n / (TILE_X+1)) % TILE_Y;
+      const int lk = n / ((TILE_X+1)*TILE_Y);
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      real_t emf = 0;
+      if (is_valid(i,j,k)) {
+	// take care that RB and LT are swapped !!!
+	MHDState qEdge_emf[4];
+	get_state(QEdge_RT2, i-1,j  ,k-1, qEdge_emf[IRT]);
+	get_state(QEdge_LT2, i  ,j  ,k-1, qEdge_emf[IRB]);
+	get_state(QEdge_RB2, i-1,j  ,k  , qEdge_emf[ILT]);
+	get_state(QEdge_LB2, i  ,j  ,k  , qEdge_emf[ILB]);
+	emf = compute_emf<EMFY>(qEdge_emf,params);
+      }
+      emfy(n) = emf;
+    });
+
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, nb_edges_x()),
+			 [&](const int& n) {
+      const int li = n % TILE_X;
+      const int lj = (n / TILE_X) % (TILE_Y+1);
+      const int lk = n / (TILE_X*(TILE_Y+1));
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      real_t emf = 0;
+      if (is_valid(i,j,k)) {
+	MHDState qEdge_emf[4];
+	get_state(QEdge_RT, i  ,j-1,k-1, qEdge_emf[IRT]);
+	get_state(QEdge_RB, i  ,j-1,k  , qEdge_emf[IRB]);
+	get_state(QEdge_LT, i  ,j  ,k-1, qEdge_emf[ILT]);
+	get_state(QEdge_LB, i  ,j  ,k  , qEdge_emf[ILB]);
+	emf = compute_emf<EMFX>(qEdge_emf,params);
+      }
+      emfx(n) = emf;
+    });
+
+    team.team_barrier();
+
+    /*
+     * 3. hydro and induction update
+     */
+    Kokkos::parallel_for(Kokkos::TeamThreadRange(team, TILE_X*TILE_Y*TILE_Z),
+			 [&](const int& n) {
+      const int li = n % TILE_X;
+      const int lj = (n / TILE_X) % TILE_Y;
+      const int lk = n / (TILE_X*TILE_Y);
+      const int i = i0+li, j = j0+lj, k = k0+lk;
+
+      if (!is_valid(i,j,k))
+	return;
+
+      // scratch indexes of the faces / edges around current cell
+      const int ifx  = li + (TILE_X+1)*(lj + TILE_Y    *lk);
+      const int ify  = li + TILE_X    *(lj + (TILE_Y+1)*lk);
+      const int ifz  = li + TILE_X    *(lj + TILE_Y    *lk);
+      const int iez  = li + (TILE_X+1)*(lj + (TILE_Y+1)*lk);
+      const int iey  = li + (TILE_X+1)*(lj + TILE_Y    *lk);
+      const int iex  = li + TILE_X    *(lj + (TILE_Y+1)*lk);
+
+      // offsets to the next face / edge along each direction
+      const int dfx_x = 1;
+      const int dfy_y = TILE_X;
+      const int dfz_z = TILE_X*TILE_Y;
+      const int dez_x = 1, dez_y = TILE_X+1;
+      const int dey_x = 1, dey_z = (TILE_X+1)*TILE_Y;
+      const int dex_y = TILE_X, dex_z = TILE_X*(TILE_Y+1);
+
+      MHDState udata;
+      get_state(Udata, i,j,k, udata);
+
+      // hydro update (interior cells only)
+      if(k < ksize-ghostWidth &&
+	 j < jsize-ghostWidth &&
+	 i < isize-ghostWidth) {
+
+	const int l0 = ifx*NB_FLUX, l1 = (ifx+dfx_x)*NB_FLUX;
+	udata[ID]  += ( fx(l0+ID) - fx(l1+ID) )*dtdx;
+	udata[IP]  += ( fx(l0+IP) - fx(l1+IP) )*dtdx;
+	udata[IU]  += ( fx(l0+IU) - fx(l1+IU) )*dtdx;
+	udata[IV]  += ( fx(l0+IV) - fx(l1+IV) )*dtdx;
+	udata[IW]  += ( fx(l0+IW) - fx(l1+IW) )*dtdx;
+
+	const int m0 = ify*NB_FLUX, m1 = (ify+dfy_y)*NB_FLUX;
+	udata[ID]  += ( fy(m0+ID) - fy(m1+ID) )*dtdy;
+	udata[IP]  += ( fy(m0+IP) - fy(m1+IP) )*dtdy;
+	udata[IU]  += ( fy(m0+IV) - fy(m1+IV) )*dtdy; //
+	udata[IV]  += ( fy(m0+IU) - fy(m1+IU) )*dtdy; //
+	udata[IW]  += ( fy(m0+IW) - fy(m1+IW) )*dtdy;
+
+	const int n0 = ifz*NB_FLUX, n1 = (ifz+dfz_z)*NB_FLUX;
+	udata[ID]  += ( fz(n0+ID) - fz(n1+ID) )*dtdz;
+	udata[IP]  += ( fz(n0+IP) - fz(n1+IP) )*dtdz;
+	udata[IU]  += ( fz(n0+IW) - fz(n1+IW) )*dtdz; //
+	udata[IV]  += ( fz(n0+IV) - fz(n1+IV) )*dtdz;
+	udata[IW]  += ( fz(n0+IU) - fz(n1+IU) )*dtdz; //
+
+      }
+
+      // induction update
+      if (k<ksize-ghostWidth) {
+	udata[IBX] += ( emfz(iez+dez_y) - emfz(iez) ) * dtdy;
+	udata[IBY] -= ( emfz(iez+dez_x) - emfz(iez) ) * dtdx;
+      }
+
+      // update BX
+      udata[IBX] -= ( emfy(iey+dey_z) - emfy(iey) ) * dtdz;
+
+      // update BY
+      udata[IBY] += ( emfx(iex+dex_z) - emfx(iex) ) * dtdz;
+
+      // update BZ
+      udata[IBZ] += ( emfy(iey+dey_x) - emfy(iey) ) * dtdx;
+      udata[IBZ] -= ( emfx(iex+dex_y) - emfx(iex) ) * dtdy;
+
+      set_state(Udata, i,j,k, udata);
+    });
+
+  } // operator()
+
+  DataArray3d Udata;
+  DataArray3d Qm_x, Qm_y, Qm_z;
+  DataArray3d Qp_x, Qp_y, Qp_z;
+  DataArray3d QEdge_RT,  QEdge_RB,  QEdge_LT,  QEdge_LB;
+  DataArray3d QEdge_RT2, QEdge_RB2, QEdge_LT2, QEdge_LB2;
+  DataArray3d QEdge_RT3, QEdge_RB3, QEdge_LT3, QEdge_LB3;
+  real_t dtdx, dtdy, dtdz;
+
+  //! number of tiles along each direction
+  int ntx, nty, ntz;
+
+}; // ComputeFluxesEmfAndUpdateFunctor3D_MHD
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Base class for the low memory (implementationVersion 1) functors.
+ *
+ * Riemann states (qm, qp and the 12 qEdge states) are not stored in global
+ * memory, they are recomputed on the fly each time a face or an edge needs
+ * them, from Q, the face-centered magnetic field, the electric field and
+ * the transverse magnetic slopes.
+ */
+class MHDTraceBaseFunctor3D : public MHDBaseFunctor3D {
+
+public:
+
+  MHDTraceBaseFunctor3D(KernelParams params,
+			DataArray3d Udata,
+			DataArray3d Qdata,
+			DataArrayVector3 DeltaA,
+			DataArrayVector3 DeltaB,
+			DataArrayVector3 DeltaC,
+			DataArrayVector3 ElecField,
+			real_t dtdx,
+			real_t dtdy,
+			real_t dtdz) :
+    MHDBaseFunctor3D(params),
+    Udata(Udata), Qdata(Qdata),
+    DeltaA(DeltaA), DeltaB(DeltaB), DeltaC(DeltaC), ElecField(ElecField),
+    dtdx(dtdx), dtdy(dtdy), dtdz(dtdz) {};
+
+  /**
+   * Compute the trace of cell (i,j,k); same as ComputeTraceFunctor3D_MHD,
+   * but results are returned instead of stored.
+   */
+  KOKKOS_INLINE_FUNCTION
+  void compute_trace(int i, int j, int k,
+		     MHDState (&qm)[THREE_D],
+		     MHDState (&qp)[THREE_D],
+		     MHDState (&qEdge)[4][3]) const
+  {
+    const int ghostWidth = params.ghostWidth;
+    
+    MHDState q;
+    MHDState qPlusX, qMinusX, qPlusY, qMinusY, qPlusZ, qMinusZ;
+    MHDState dq[3];
+    
+    real_t bfNb[6];
+    real_t dbf[12];
+    
+    real_t elecFields[3][2][2];
+    // alias to electric field components
+    real_t (&Ex)[2][2] = elecFields[IX];
+    real_t (&Ey)[2][2] = elecFields[IY];
+    real_t (&Ez)[2][2] = elecFields[IZ];
+    
+    real_t xPos = params.xmin + params.dx/2 + (i-ghostWidth)*params.dx;
+    
+    // get primitive variables state vector
+    get_state(Qdata, i  ,j  ,k  , q      );
+    get_state(Qdata, i+1,j  ,k  , qPlusX );
+    get_state(Qdata, i-1,j  ,k  , qMinusX);
+    get_state(Qdata, i  ,j+1,k  , qPlusY );
+    get_state(Qdata, i  ,j-1,k  , qMinusY);
+    get_state(Qdata, i  ,j  ,k+1, qPlusZ );
+    get_state(Qdata, i  ,j  ,k-1, qMinusZ);
+    
+    // get hydro slopes dq
+    slope_unsplit_hydro_3d(q, 
+			   qPlusX, qMinusX, 
+			   qPlusY, qMinusY, 
+			   qPlusZ, qMinusZ,
+			   dq);
+    
+    // get face-centered magnetic components
+    bfNb[0] = Udata(i  ,j  ,k  , IA);
+    bfNb[1] = Udata(i+1,j  ,k  , IA);
+    bfNb[2] = Udata(i  ,j  ,k  , IB);
+    bfNb[3] = Udata(i  ,j+1,k  , IB);
+    bfNb[4] = Udata(i  ,j  ,k  , IC);
+    bfNb[5] = Udata(i  ,j  ,k+1, IC);
+    
+    // get dbf (transverse magnetic slopes)
+    dbf[0]  = DeltaA(i  ,j  ,k  , IY);
+    dbf[1]  = DeltaA(i  ,j  ,k  , IZ);
+    dbf[2]  = DeltaB(i  ,j  ,k  , IX);
+    dbf[3]  = DeltaB(i  ,j  ,k  , IZ);
+    dbf[4]  = DeltaC(i  ,j  ,k  , IX);
+    dbf[5]  = DeltaC(i  ,j  ,k  , IY);
+    
+    dbf[6]  = DeltaA(i+1,j  ,k  , IY);
+    dbf[7]  = DeltaA(i+1,j  ,k  , IZ);
+    dbf[8]  = DeltaB(i  ,j+1,k  , IX);
+    dbf[9]  = DeltaB(i  ,j+1,k  , IZ);
+    dbf[10] = DeltaC(i  ,j  ,k+1, IX);
+    dbf[11] = DeltaC(i  ,j  ,k+1, IY);
+    
+    // get electric field components
+    Ex[0][0] = ElecField(i  ,j  ,k  , IX);
+    Ex[0][1] = ElecField(i  ,j  ,k+1, IX);
+    Ex[1][0] = ElecField(i  ,j+1,k  , IX);
+    Ex[1][1] = ElecField(i  ,j+1,k+1, IX);
+    
+    Ey[0][0] = ElecField(i  ,j  ,k  , IY);
+    Ey[0][1] = ElecField(i  ,j  ,k+1, IY);
+    Ey[1][0] = ElecField(i+1,j  ,k  , IY);
+    Ey[1][1] = ElecField(i+1,j  ,k+1, IY);
+    
+    Ez[0][0] = ElecField(i  ,j  ,k  , IZ);
+    Ez[0][1] = ElecField(i  ,j+1,k  , IZ);
+    Ez[1][0] = ElecField(i+1,j  ,k  , IZ);
+    Ez[1][1] = ElecField(i+1,j+1,k  , IZ);
+    
+    // compute qm, qp and qEdge
+    trace_unsplit_mhd_3d_simpler(q, dq, bfNb, dbf, elecFields, 
+				 dtdx, dtdy, dtdz, xPos,
+				 qm, qp, qEdge);
+    
+  } // compute_trace
+
+  DataArray3d Udata, Qdata;
+  DataArrayVector3 DeltaA, DeltaB, DeltaC, ElecField;
+  real_t dtdx, dtdy, dtdz;
+
+}; // MHDTraceBaseFunctor3D
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Compute traces on the fly and fluxes along direction dir
+ * (implementationVersion 1).
+ *
+ * Fluxes are stored (raw, not multiplied by dt) in a single array shared
+ * by all directions, see UpdateDirFunctor3D_MHD.
+ */
+template <Direction dir>
+class ComputeTraceAndFluxes_Functor3D_MHD : public MHDTraceBaseFunctor3D {
+
+public:
+
+  ComputeTraceAndFluxes_Functor3D_MHD(KernelParams params,
+				      DataArray3d Udata,
+				      DataArray3d Qdata,
+				      DataArrayVector3 DeltaA,
+				      DataArrayVector3 DeltaB,
+				      DataArrayVector3 DeltaC,
+				      DataArrayVector3 ElecField,
+				      DataArray3d Fluxes,
+				      real_t dtdx,
+				      real_t dtdy,
+				      real_t dtdz) :
+    MHDTraceBaseFunctor3D(params, Udata, Qdata,
+			  DeltaA, DeltaB, DeltaC, ElecField,
+			  dtdx, dtdy, dtdz),
+    Fluxes(Fluxes) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    DataArray3d Udata,
+		    DataArray3d Qdata,
+		    DataArrayVector3 DeltaA,
+		    DataArrayVector3 DeltaB,
+		    DataArrayVector3 DeltaC,
+		    DataArrayVector3 ElecField,
+		    DataArray3d Fluxes,
+		    real_t dtdx,
+		    real_t dtdy,
+		    real_t dtdz,
+		    int    nbCells)
+  {
+    ComputeTraceAndFluxes_Functor3D_MHD<dir> functor(params, Udata, Qdata,
+						     DeltaA, DeltaB, DeltaC,
+						     ElecField,
+						     Fluxes,
+						     dtdx, dtdy, dtdz);
+    ppkMHD::parallel_for_tuned("ComputeTraceAndFluxes_Functor3D_MHD", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+    const int ghostWidth = params.ghostWidth;
+    
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+    
+    if(k >= ghostWidth && k < ksize - ghostWidth+1 &&
+       j >= ghostWidth && j < jsize - ghostWidth+1 &&
+       i >= ghostWidth && i < isize - ghostWidth+1) {
+
+      MHDState qm[THREE_D];
+      MHDState qp[THREE_D];
+      MHDState qEdge[4][3];
+
+      MHDState qleft, qright;
+      MHDState flux;
+
+      if (dir == XDIR) {
+
+	// left state: trace of left neighbor
+	compute_trace(i-1,j  ,k  , qm, qp, qEdge);
+	qleft = qm[0];
+
+	// right state: trace of current cell
+	compute_trace(i  ,j  ,k  , qm, qp, qEdge);
+	qright = qp[0];
+
+	// Solve Riemann problem at X-interfaces and compute X-fluxes
+	riemann_mhd(qleft,qright,flux,params);
+
+      } else if (dir == YDIR) {
+
+	compute_trace(i  ,j-1,k  , qm, qp, qEdge);
+	qleft = qm[1];
+	swapValues(&(qleft[IU])  ,&(qleft[IV]) );
+	swapValues(&(qleft[IBX]) ,&(qleft[IBY]) );
+
+	compute_trace(i  ,j  ,k  , qm, qp, qEdge);
+	qright = qp[1];
+	swapValues(&(qright[IU])  ,&(qright[IV]) );
+	swapValues(&(qright[IBX]) ,&(qright[IBY]) );
+
+	// Solve Riemann problem at Y-interfaces and compute Y-fluxes
+	riemann_mhd(qleft,qright,flux,params);
+
+      } else if (dir == ZDIR) {
+
+	compute_trace(i  ,j  ,k-1, qm, qp, qEdge);
+	qleft = qm[2];
+	swapValues(&(qleft[IU])  ,&(qleft[IW]) );
+	swapValues(&(qleft[IBX]) ,&(qleft[IBZ]) );
+
+	compute_trace(i  ,j  ,k  , qm, qp, qEdge);
+	qright = qp[2];
+	swapValues(&(qright[IU])  ,&(qright[IW]) );
+	swapValues(&(qright[IBX]) ,&(qright[IBZ]) );
+
+	// Solve Riemann problem at Z-interfaces and compute Z-fluxes
+	riemann_mhd(qleft,qright,flux,params);
+
+      }
+
+      // store fluxes
+      set_state(Fluxes, i,j,k, flux);
+
+    }
+    
+  } // operator ()
+
+  DataArray3d Fluxes;
+  
+}; // ComputeTraceAndFluxes_Functor3D_MHD
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Compute traces on the fly and emf (implementationVersion 1).
+ *
+ * Same as ComputeEmfAndStoreFunctor3D, but the edge states are recomputed
+ * instead of being read from the 12 QEdge arrays. The 3 emf components at
+ * (i,j,k) need the traces of 7 cells: (i,j,k), its 3 face neighbors on the
+ * left and its 3 edge neighbors on the left.
+ */
+class ComputeTraceAndEmf_Functor3D_MHD : public MHDTraceBaseFunctor3D {
+
+public:
+
+  ComputeTraceAndEmf_Functor3D_MHD(KernelParams params,
+				   DataArray3d Udata,
+				   DataArray3d Qdata,
+				   DataArrayVector3 DeltaA,
+				   DataArrayVector3 DeltaB,
+				   DataArrayVector3 DeltaC,
+				   DataArrayVector3 ElecField,
+				   DataArrayVector3 Emf,
+				   real_t dtdx,
+				   real_t dtdy,
+				   real_t dtdz) :
+    MHDTraceBaseFunctor3D(params, Udata, Qdata,
+			  DeltaA, DeltaB, DeltaC, ElecField,
+			  dtdx, dtdy, dtdz),
+    Emf(Emf) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    DataArray3d Udata,
+		    DataArray3d Qdata,
+		    DataArrayVector3 DeltaA,
+		    DataArrayVector3 DeltaB,
+		    DataArrayVector3 DeltaC,
+		    DataArrayVector3 ElecField,
+		    DataArrayVector3 Emf,
+		    real_t dtdx,
+		    real_t dtdy,
+		    real_t dtdz,
+		    int    nbCells)
+  {
+    ComputeTraceAndEmf_Functor3D_MHD functor(params, Udata, Qdata,
+					     DeltaA, DeltaB, DeltaC,
+					     ElecField,
+					     Emf,
+					     dtdx, dtdy, dtdz);
+    ppkMHD::parallel_for_tuned("ComputeTraceAndEmf_Functor3D_MHD", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+    const int ghostWidth = params.ghostWidth;
+    
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+    
+    if(k >= ghostWidth && k < ksize - ghostWidth+1 &&
+       j >= ghostWidth && j < jsize - ghostWidth+1 &&
+       i >= ghostWidth && i < isize - ghostWidth+1) {
+
+      MHDState qm[THREE_D];
+      MHDState qp[THREE_D];
+      MHDState qEdge[4][3];
+
+      // edge states for each emf component, same ordering as in
+      // ComputeEmfAndStoreFunctor3D (take care that RB and LT are
+      // swapped for emfY)
+      MHDState qEdge_emfZ[4];
+      MHDState qEdge_emfY[4];
+      MHDState qEdge_emfX[4];
+
+      compute_trace(i  ,j  ,k  , qm, qp, qEdge);
+      qEdge_emfZ[ILB] = qEdge[ILB][2];
+      qEdge_emfY[ILB] = qEdge[ILB][1];
+      qEdge_emfX[ILB] = qEdge[ILB][0];
+
+      compute_trace(i-1,j  ,k  , qm, qp, qEdge);
+      qEdge_emfZ[IRB] = qEdge[IRB][2];
+      qEdge_emfY[ILT] = qEdge[IRB][1];
+
+      compute_trace(i  ,j-1,k  , qm, qp, qEdge);
+      qEdge_emfZ[ILT] = qEdge[ILT][2];
+      qEdge_emfX[IRB] = qEdge[IRB][0];
+
+      compute_trace(i  ,j  ,k-1, qm, qp, qEdge);
+      qEdge_emfY[IRB] = qEdge[ILT][1];
+      qEdge_emfX[ILT] = qEdge[ILT][0];
+
+      compute_trace(i-1,j-1,k  , qm, qp, qEdge);
+      qEdge_emfZ[IRT] = qEdge[IRT][2];
+
+      compute_trace(i-1,j  ,k-1, qm, qp, qEdge);
+      qEdge_emfY[IRT] = qEdge[IRT][1];
+
+      compute_trace(i  ,j-1,k-1, qm, qp, qEdge);
+      qEdge_emfX[IRT] = qEdge[IRT][0];
+
+      Emf(i,j,k,I_EMFZ) = compute_emf<EMFZ>(qEdge_emfZ,params);
+      Emf(i,j,k,I_EMFY) = compute_emf<EMFY>(qEdge_emfY,params);
+      Emf(i,j,k,I_EMFX) = compute_emf<EMFX>(qEdge_emfX,params);
+
+    }
+  } // operator ()
+
+  DataArrayVector3 Emf;
+
+}; // ComputeTraceAndEmf_Functor3D_MHD
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Hydro update using the fluxes along direction dir
+ * (implementationVersion 1).
+ */
+template <Direction dir>
+class UpdateDirFunctor3D_MHD : public MHDBaseFunctor3D {
+
+public:
+
+  UpdateDirFunctor3D_MHD(KernelParams params,
+			 DataArray3d Udata,
+			 DataArray3d FluxData,
+			 real_t dtdir) :
+    MHDBaseFunctor3D(params),
+    Udata(Udata), 
+    FluxData(FluxData),
+    dtdir(dtdir) {};
+  
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+                    DataArray3d Udata,
+		    DataArray3d FluxData,
+		    real_t      dtdir,
+		    int         nbCells)
+  {
+    UpdateDirFunctor3D_MHD<dir> functor(params, Udata, FluxData, dtdir);
+    Kokkos::parallel_for("UpdateDirFunctor3D_MHD", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+    const int ghostWidth = params.ghostWidth;
+    
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    if(k >= ghostWidth && k < ksize-ghostWidth  &&
+       j >= ghostWidth && j < jsize-ghostWidth  &&
+       i >= ghostWidth && i < isize-ghostWidth ) {
+
+      MHDState udata;
+      MHDState flux;
+      get_state(Udata, i,j,k, udata);
+
+      if (dir == XDIR) {
+
+	get_state(FluxData, i  ,j  ,k  , flux);
+	udata[ID]  +=  flux[ID]*dtdir;
+	udata[IP]  +=  flux[IP]*dtdir;
+	udata[IU]  +=  flux[IU]*dtdir;
+	udata[IV]  +=  flux[IV]*dtdir;
+	udata[IW]  +=  flux[IW]*dtdir;
+	
+	get_state(FluxData, i+1,j  ,k  , flux);
+	udata[ID]  -=  flux[ID]*dtdir;
+	udata[IP]  -=  flux[IP]*dtdir;
+	udata[IU]  -=  flux[IU]*dtdir;
+	udata[IV]  -=  flux[IV]*dtdir;
+	udata[IW]  -=  flux[IW]*dtdir;
+
+      } else if (dir == YDIR) {
+
+	get_state(FluxData, i  ,j  ,k  , flux);
+	udata[ID]  +=  flux[ID]*dtdir;
+	udata[IP]  +=  flux[IP]*dtdir;
+	udata[IU]  +=  flux[IV]*dtdir; //
+	udata[IV]  +=  flux[IU]*dtdir; //
+	udata[IW]  +=  flux[IW]*dtdir;
+	
+	get_state(FluxData, i  ,j+1,k  , flux);
+	udata[ID]  -=  flux[ID]*dtdir;
+	udata[IP]  -=  flux[IP]*dtdir;
+	udata[IU]  -=  flux[IV]*dtdir; //
+	udata[IV]  -=  flux[IU]*dtdir; //
+	udata[IW]  -=  flux[IW]*dtdir;
+
+      } else if (dir == ZDIR) {
+
+	get_state(FluxData, i  ,j  ,k  , flux);
+	udata[ID]  +=  flux[ID]*dtdir;
+	udata[IP]  +=  flux[IP]*dtdir;
+	udata[IU]  +=  flux[IW]*dtdir; //
+	udata[IV]  +=  flux[IV]*dtdir;
+	udata[IW]  +=  flux[IU]*dtdir; //
+	
+	get_state(FluxData, i  ,j  ,k+1, flux);
+	udata[ID]  -=  flux[ID]*dtdir;
+	udata[IP]  -=  flux[IP]*dtdir;
+	udata[IU]  -=  flux[IW]*dtdir; //
+	udata[IV]  -=  flux[IV]*dtdir;
+	udata[IW]  -=  flux[IU]*dtdir; //
+
+      }
+
+      // write back hydro variables only, face-centered magnetic field
+      // is updated by UpdateEmfFunctor3D
+      Udata(i,j,k, ID) = udata[ID];
+      Udata(i,j,k, IP) = udata[IP];
+      Udata(i,j,k, IU) = udata[IU];
+      Udata(i,j,k, IV) = udata[IV];
+      Udata(i,j,k, IW) = udata[IW];
+      
+    } // end if
+    
+  } // end operator ()
+  
+  DataArray3d Udata;
+  DataArray3d FluxData;
+  real_t dtdir;
+  
+}; // UpdateDirFunctor3D_MHD
+
 } // namespace muscl
 
 } // namespace ppkMHD
@@ -80,7 +80,7 @@ void SolverHydroMuscl<2>::init_four_quadrant(DataArray Udata)
   primToCons_2D(U2, params.settings.gamma0);
   primToCons_2D(U3, params.settings.gamma0);
 
-  InitFourQuadrantFunctor2D::apply(params, Udata, configNumber,
+  InitFourQuadrantFunctor2D::apply(kernel_params, Udata, configNumber,
 				   U0, U1, U2, U3,
 				   xt, yt, nbCells);
   
@@ -94,7 +94,7 @@ void SolverHydroMuscl<2>::init_isentropic_vortex(DataArray Udata)
   
   IsentropicVortexParams iparams(configMap);
   
-  InitIsentropicVortexFunctor2D::apply(params, iparams, Udata, nbCells);
+  InitIsentropicVortexFunctor2D::apply(kernel_params, iparams, Udata, nbCells);
   
 } // SolverHydroMuscl<2>::init_isentropic_vortex
 
@@ -142,15 +142,15 @@ void SolverHydroMuscl<2>::init(DataArray Udata)
       
     } else if ( !m_problem_name.compare("rayleigh_taylor") ) {
       
-      init_rayleigh_taylor(Udata,gravity);
+      init_rayleigh_taylor(Udata);
       
     } else if ( !m_problem_name.compare("rising_bubble") ) {
       
-      init_rising_bubble(Udata,gravity);
+      init_rising_bubble(Udata);
       
     } else if ( !m_problem_name.compare("disk") ) {
       
-      init_disk(Udata,gravity);
+      init_disk(Udata);
       
     } else {
       
@@ -162,6 +162,10 @@ void SolverHydroMuscl<2>::init(DataArray Udata)
       
     }
 
+    // initial conditions are written with gamma0
+    if (params.settings.eos.data)
+      init_eos_energy(Udata);
+
   } // end regular initialization
 
 } // SolverHydroMuscl::init / 2d
@@ -202,15 +206,15 @@ void SolverHydroMuscl<3>::init(DataArray Udata)
       
     } else if ( !m_problem_name.compare("rayleigh_taylor") ) {
       
-      init_rayleigh_taylor(Udata,gravity);
+      init_rayleigh_taylor(Udata);
       
     } else if ( !m_problem_name.compare("rising_bubble") ) {
       
-      init_rising_bubble(Udata,gravity);
+      init_rising_bubble(Udata);
       
     } else if ( !m_problem_name.compare("disk") ) {
       
-      init_disk(Udata,gravity);
+      init_disk(Udata);
       
     } else {
       
@@ -222,6 +226,10 @@ void SolverHydroMuscl<3>::init(DataArray Udata)
       
     }
 
+    // initial conditions are written with gamma0
+    if (params.settings.eos.data)
+      init_eos_energy(Udata);
+
   } // end regular initialization
 
 } // SolverHydroMuscl<3>::init
@@ -239,7 +247,9 @@ void SolverHydroMuscl<2>::godunov_unsplit_impl(DataArray data_in,
   
   // fill ghost cell in data_in
   timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
   make_boundaries(data_in);
+  Kokkos::Profiling::popRegion();
   timers[TIMER_BOUNDARIES]->stop();
     
   // copy data_in into data_out (not necessary)
@@ -248,37 +258,46 @@ void SolverHydroMuscl<2>::godunov_unsplit_impl(DataArray data_in,
   
   // start main computation
   timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
 
   // convert conservative variable into primitives ones for the entire domain
+  m_workspace.begin_phase(PHASE_PRIMITIVES);
   convertToPrimitives(data_in);
 
   if (params.implementationVersion == 0) {
     
     // compute fluxes (if gravity_enabled is false, the last parameter is not used)
-    ComputeAndStoreFluxesFunctor2D::apply(params, Q,
+    m_workspace.begin_phase(PHASE_FLUXES);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ComputeAndStoreFluxesFunctor2D::apply(kernel_params, Q,
 					  Fluxes_x, Fluxes_y,
 					  dt,
 					  m_gravity_enabled,
 					  gravity);
+    Kokkos::Profiling::popRegion();
     
     // actual update
-    UpdateFunctor2D::apply(params, data_out,
+    Kokkos::Profiling::pushRegion("update");
+    UpdateFunctor2D::apply(kernel_params, data_out,
 			   Fluxes_x, Fluxes_y);
+    Kokkos::Profiling::popRegion();
 
     // gravity source term
     if (m_gravity_enabled) {
-      GravitySourceTermFunctor2D::apply(params, data_in, data_out, gravity, dt);
+      GravitySourceTermFunctor2D::apply(kernel_params, data_in, data_out, gravity, dt);
     }
 
     
   } else if (params.implementationVersion == 1) {
 
     // call device functor to compute slopes
-    ComputeSlopesFunctor2D::apply(params, Q,
+    m_workspace.begin_phase(PHASE_SLOPES);
+    ComputeSlopesFunctor2D::apply(kernel_params, Q,
 				  Slopes_x, Slopes_y);
 
     // now trace along X axis
-    ComputeTraceAndFluxes_Functor2D<XDIR>::apply(params, Q,
+    m_workspace.begin_phase(PHASE_FLUXES);
+    ComputeTraceAndFluxes_Functor2D<XDIR>::apply(kernel_params, Q,
 						 Slopes_x, Slopes_y,
 						 Fluxes_x,
 						 dt,
@@ -286,10 +305,10 @@ void SolverHydroMuscl<2>::godunov_unsplit_impl(DataArray data_in,
 						 gravity);
     
     // and update along X axis
-    UpdateDirFunctor2D<XDIR>::apply(params, data_out, Fluxes_x);
+    UpdateDirFunctor2D<XDIR>::apply(kernel_params, data_out, Fluxes_x);
     
     // now trace along Y axis
-    ComputeTraceAndFluxes_Functor2D<YDIR>::apply(params, Q,
+    ComputeTraceAndFluxes_Functor2D<YDIR>::apply(kernel_params, Q,
 						 Slopes_x, Slopes_y,
 						 Fluxes_y,
 						 dt,
@@ -297,15 +316,16 @@ void SolverHydroMuscl<2>::godunov_unsplit_impl(DataArray data_in,
 						 gravity);
     
     // and update along Y axis
-    UpdateDirFunctor2D<YDIR>::apply(params, data_out, Fluxes_y);
+    UpdateDirFunctor2D<YDIR>::apply(kernel_params, data_out, Fluxes_y);
     
     // gravity source term
     if (m_gravity_enabled) {
-      GravitySourceTermFunctor2D::apply(params, data_in, data_out, gravity, dt);
+      GravitySourceTermFunctor2D::apply(kernel_params, data_in, data_out, gravity, dt);
     }
 
   } // end params.implementationVersion == 1
   
+  Kokkos::Profiling::popRegion();
   timers[TIMER_NUM_SCHEME]->stop();
   
 } // SolverHydroMuscl2D::godunov_unsplit_impl
@@ -323,7 +343,9 @@ void SolverHydroMuscl<3>::godunov_unsplit_impl(DataArray data_in,
 
   // fill ghost cell in data_in
   timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
   make_boundaries(data_in);
+  Kokkos::Profiling::popRegion();
   timers[TIMER_BOUNDARIES]->stop();
     
   // copy data_in into data_out (not necessary)
@@ -332,69 +354,79 @@ void SolverHydroMuscl<3>::godunov_unsplit_impl(DataArray data_in,
   
   // start main computation
   timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
 
   // convert conservative variable into primitives ones for the entire domain
+  m_workspace.begin_phase(PHASE_PRIMITIVES);
   convertToPrimitives(data_in);
 
   if (params.implementationVersion == 0) {
     
     // compute fluxes
-    ComputeAndStoreFluxesFunctor3D::apply(params, Q,
+    m_workspace.begin_phase(PHASE_FLUXES);
+    Kokkos::Profiling::pushRegion("fluxes");
+    ComputeAndStoreFluxesFunctor3D::apply(kernel_params, Q,
 					  Fluxes_x, Fluxes_y, Fluxes_z,
 					  dt,
 					  m_gravity_enabled,
 					  gravity);
+    Kokkos::Profiling::popRegion();
 
     // actual update
-    UpdateFunctor3D::apply(params, data_out,
+    Kokkos::Profiling::pushRegion("update");
+    UpdateFunctor3D::apply(kernel_params, data_out,
 			   Fluxes_x, Fluxes_y, Fluxes_z);
+    Kokkos::Profiling::popRegion();
 
     // gravity source term
     if (m_gravity_enabled) {
-      GravitySourceTermFunctor3D::apply(params, data_in, data_out, gravity, dt);
+      GravitySourceTermFunctor3D::apply(kernel_params, data_in, data_out, gravity, dt);
     }
 
     
   } else if (params.implementationVersion == 1) {
 
     // call device functor to compute slopes
-    ComputeSlopesFunctor3D::apply(params, Q,
+    m_workspace.begin_phase(PHASE_SLOPES);
+    ComputeSlopesFunctor3D::apply(kernel_params, Q,
 				  Slopes_x, Slopes_y, Slopes_z);
 
     // now trace along X axis
-    ComputeTraceAndFluxes_Functor3D<XDIR>::apply(params, Q,
+    m_workspace.begin_phase(PHASE_FLUXES);
+    ComputeTraceAndFluxes_Functor3D<XDIR>::apply(kernel_params, Q,
 						 Slopes_x, Slopes_y, Slopes_z,
 						 Fluxes_x,
 						 dt, m_gravity_enabled, gravity);
     
     // and update along X axis
-    UpdateDirFunctor3D<XDIR>::apply(params, data_out, Fluxes_x);
+    UpdateDirFunctor3D<XDIR>::apply(kernel_params, data_out, Fluxes_x);
 
     // now trace along Y axis
-    ComputeTraceAndFluxes_Functor3D<YDIR>::apply(params, Q,
+    ComputeTraceAndFluxes_Functor3D<YDIR>::apply(kernel_params, Q,
 						 Slopes_x, Slopes_y, Slopes_z,
 						 Fluxes_y,
 						 dt, m_gravity_enabled, gravity);
     
     // and update along Y axis
-    UpdateDirFunctor3D<YDIR>::apply(params, data_out, Fluxes_y);
+    UpdateDirFunctor3D<YDIR>::apply(kernel_params, data_out, Fluxes_y);
 
     // now trace along Z axis
-    ComputeTraceAndFluxes_Functor3D<ZDIR>::apply(params, Q,
+    ComputeTraceAndFluxes_Functor3D<ZDIR>::apply(kernel_params, Q,
 						 Slopes_x, Slopes_y, Slopes_z,
 						 Fluxes_z,
 						 dt, m_gravity_enabled, gravity);
     
     // and update along Z axis
-    UpdateDirFunctor3D<ZDIR>::apply(params, data_out, Fluxes_z);
+    UpdateDirFunctor3D<ZDIR>::apply(kernel_params, data_out, Fluxes_z);
 
     // gravity source term
     if (m_gravity_enabled) {
-      GravitySourceTermFunctor3D::apply(params, data_in, data_out, gravity, dt);
+      GravitySourceTermFunctor3D::apply(kernel_params, data_in, data_out, gravity, dt);
     }
 
   } // end params.implementationVersion == 1
   
+  Kokkos::Profiling::popRegion();
   timers[TIMER_NUM_SCHEME]->stop();
 
 } // SolverHydroMuscl<3>::godunov_unsplit_impl
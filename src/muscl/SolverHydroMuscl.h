@@ -17,7 +17,12 @@
 #include "shared/SolverBase.h"
 #include "shared/HydroParams.h"
 #include "shared/kokkos_shared.h"
+#include "shared/FirstTouch.h"
 #include "shared/problems/initRiemannConfig2d.h"
+#include "shared/PoissonMultigrid.h"
+#include "shared/DiagnosticsFunctors.h"
+#include "utils/io/IO_Products.h"
+#include "shared/Analysis.h"
 
 // the actual computational functors called in HydroRun
 #include "muscl/HydroRunFunctors2D.h"
@@ -28,7 +33,6 @@
 #include "muscl/HydroInitFunctors3D.h"
 
 // border conditions functors
-#include "shared/BoundariesFunctors.h"
 
 // for IO
 #include <utils/io/IO_ReadWrite.h>
@@ -78,6 +82,17 @@ public:
   DataArray     U2;    /*!< hydrodynamics conservative variables arrays */
   DataArray     Q;     /*!< hydrodynamics primitive    variables array  */
 
+  /**
+   * Time step phases, used to declare the lifetime of the transient
+   * arrays (Q, slopes, fluxes) allocated in m_workspace.
+   */
+  enum StepPhase {
+    PHASE_PRIMITIVES, //!< conservative to primitive variables
+    PHASE_SLOPES,     //!< slopes (implementation 1)
+    PHASE_FLUXES,     //!< fluxes (and directional updates, implementation 1)
+    PHASE_UPDATE      //!< update with stored fluxes (implementation 0)
+  };
+
   /* implementation 0 */
   DataArray Fluxes_x; /*!< implementation 0 */
   DataArray Fluxes_y; /*!< implementation 0 */
@@ -89,8 +104,11 @@ public:
   DataArray Slopes_z; /*!< implementation 1 only */
 
 
-  /* Gravity field */
-  VectorField gravity;
+  /* Gravity field (analytic fields are not stored, see GravityField) */
+  GravityField<dim> gravity;
+
+  //! Poisson solver (self-gravity only)
+  std::shared_ptr<PoissonMultigrid<dim> > poisson_solver;
   
   //riemann_solver_t riemann_solver_fn; /*!< riemann solver function pointer */
 
@@ -108,9 +126,18 @@ public:
   void init_gresho_vortex(DataArray Udata); // 2d and 3d
   void init_four_quadrant(DataArray Udata); // 2d only
   void init_isentropic_vortex(DataArray Udata); // 2d only
-  void init_rayleigh_taylor(DataArray Udata, VectorField gravity); // 2d and 3d
-  void init_rising_bubble(DataArray Udata, VectorField gravity); // 2d and 3d
-  void init_disk(DataArray Udata, VectorField gravity); // 2d and 3d
+  void init_rayleigh_taylor(DataArray Udata); // 2d and 3d
+  void init_rising_bubble(DataArray Udata); // 2d and 3d
+  void init_disk(DataArray Udata); // 2d and 3d
+
+  //! total energy of the initial condition through the tabulated EOS
+  void init_eos_energy(DataArray Udata);
+
+  //! setup gravity field provider (depends on problem)
+  void init_gravity();
+
+  //! solve Poisson equation and update (stored) gravity field
+  void compute_self_gravity(DataArray Udata);
 
   //! init restart (load data from file)
   void init_restart(DataArray Udata);
@@ -180,91 +207,107 @@ SolverHydroMuscl<dim>::SolverHydroMuscl(HydroParams& params,
  
   long long int total_mem_size = 0;
 
+  // allocation and first touch time, reported below
+  Timer alloc_timer;
+  alloc_timer.start();
+
   /*
    * memory allocation (use sizes with ghosts included).
    *
+   * Arrays are allocated without initialization, then first touched in
+   * parallel (see FirstTouch.h).
+   *
    * Note that Uhost is not just a view to U, Uhost will be used
-   * to save data from multiple other device array.
-   * That's why we didn't use create_mirror_view to initialize Uhost.
+   * to save data from multiple other device array. It is only
+   * allocated on first output or restart (see allocate_host_mirror).
    */
   if (dim==2) {
 
-    U     = DataArray("U", isize, jsize, nbvar);
-    Uhost = Kokkos::create_mirror(U);
-    U2    = DataArray("U2",isize, jsize, nbvar);
-    Q     = DataArray("Q", isize, jsize, nbvar);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize, jsize, nbvar);
+    U2    = allocate_first_touch<DataArray>("U2", nbCells, isize, jsize, nbvar);
+    m_workspace.declare("Q", Q, PHASE_PRIMITIVES, PHASE_FLUXES, isize, jsize, nbvar);
 
-    total_mem_size += isize*jsize*nbvar * sizeof(real_t) * 3;// 1+1+1 for U+U2+Q
+    total_mem_size += isize*jsize*nbvar * sizeof(real_storage_t) * 3;// 1+1+1 for U+U2+Q
     
     if (params.implementationVersion == 0) {
       
-      Fluxes_x = DataArray("Fluxes_x", isize, jsize, nbvar);
-      Fluxes_y = DataArray("Fluxes_y", isize, jsize, nbvar);
+      m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_UPDATE, isize, jsize, nbvar);
+      m_workspace.declare("Fluxes_y", Fluxes_y, PHASE_FLUXES, PHASE_UPDATE, isize, jsize, nbvar);
       
-      total_mem_size += isize*jsize*nbvar * sizeof(real_t) * 2;// 1+1 for Fluxes_x+Fluxes_y
+      total_mem_size += isize*jsize*nbvar * sizeof(real_storage_t) * 2;// 1+1 for Fluxes_x+Fluxes_y
 
     } else if (params.implementationVersion == 1) {
       
-      Slopes_x = DataArray("Slope_x", isize, jsize, nbvar);
-      Slopes_y = DataArray("Slope_y", isize, jsize, nbvar);
+      m_workspace.declare("Slope_x", Slopes_x, PHASE_SLOPES, PHASE_FLUXES, isize, jsize, nbvar);
+      m_workspace.declare("Slope_y", Slopes_y, PHASE_SLOPES, PHASE_FLUXES, isize, jsize, nbvar);
       
-      // direction splitting (only need one flux array)
-      Fluxes_x = DataArray("Fluxes_x", isize, jsize, nbvar);
-      Fluxes_y = Fluxes_x;
+      // direction splitting (only need one flux array, updates are done
+      // direction by direction during PHASE_FLUXES)
+      m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_FLUXES, isize, jsize, nbvar);
       
-      total_mem_size += isize*jsize*nbvar * sizeof(real_t) * 3;// 1+1+1 for Slopes_x+Slopes_y+Fluxes_x
+      total_mem_size += isize*jsize*nbvar * sizeof(real_storage_t) * 3;// 1+1+1 for Slopes_x+Slopes_y+Fluxes_x
 
     } 
 
-    if (m_gravity_enabled) {
-      gravity = VectorField("gravity field",isize,jsize);
-      total_mem_size += isize*jsize*2;
-    }
-
   } else {
 
-    U     = DataArray("U", isize,jsize,ksize, nbvar);
-    Uhost = Kokkos::create_mirror(U);
-    U2    = DataArray("U2",isize,jsize,ksize, nbvar);
-    Q     = DataArray("Q", isize,jsize,ksize, nbvar);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize,jsize,ksize, nbvar);
+    U2    = allocate_first_touch<DataArray>("U2", nbCells, isize,jsize,ksize, nbvar);
+    m_workspace.declare("Q", Q, PHASE_PRIMITIVES, PHASE_FLUXES, isize,jsize,ksize, nbvar);
     
-    total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_t)*3;// 1+1+1=3 for U+U2+Q
+    total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_storage_t)*3;// 1+1+1=3 for U+U2+Q
 
     if (params.implementationVersion == 0) {
       
-      Fluxes_x = DataArray("Fluxes_x", isize,jsize,ksize, nbvar);
-      Fluxes_y = DataArray("Fluxes_y", isize,jsize,ksize, nbvar);
-      Fluxes_z = DataArray("Fluxes_z", isize,jsize,ksize, nbvar);
+      m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_UPDATE, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Fluxes_y", Fluxes_y, PHASE_FLUXES, PHASE_UPDATE, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Fluxes_z", Fluxes_z, PHASE_FLUXES, PHASE_UPDATE, isize,jsize,ksize, nbvar);
       
-      total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_t)*3;// 1+1+1=3 Fluxes
+      total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_storage_t)*3;// 1+1+1=3 Fluxes
 
     } else if (params.implementationVersion == 1) {
       
-      Slopes_x = DataArray("Slope_x", isize,jsize,ksize, nbvar);
-      Slopes_y = DataArray("Slope_y", isize,jsize,ksize, nbvar);
-      Slopes_z = DataArray("Slope_z", isize,jsize,ksize, nbvar);
+      m_workspace.declare("Slope_x", Slopes_x, PHASE_SLOPES, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Slope_y", Slopes_y, PHASE_SLOPES, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Slope_z", Slopes_z, PHASE_SLOPES, PHASE_FLUXES, isize,jsize,ksize, nbvar);
       
-      // direction splitting (only need one flux array)
-      Fluxes_x = DataArray("Fluxes_x", isize,jsize,ksize, nbvar);
-      Fluxes_y = Fluxes_x;
-      Fluxes_z = Fluxes_x;
+      // direction splitting (only need one flux array, updates are done
+      // direction by direction during PHASE_FLUXES)
+      m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_FLUXES, isize,jsize,ksize, nbvar);
       
-      total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_t)*4;// 1+1+1+1=4 Slopes
-    }
-    
-    if (m_gravity_enabled) {
-      gravity = VectorField("gravity field",isize,jsize,ksize);
-      total_mem_size += isize*jsize*ksize*3;
+      total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_storage_t)*4;// 1+1+1+1=4 Slopes
     }
 
   } // dim == 2 / 3
+
+  // transient arrays (Q, slopes, fluxes)
+  m_workspace.allocate(nbCells);
+
+  if (params.implementationVersion == 1) {
+    Fluxes_y = Fluxes_x;
+    Fluxes_z = Fluxes_x;
+  }
+
+  // gravity field (only allocated when it can't be evaluated inline)
+  if (m_gravity_enabled) {
+    init_gravity();
+    total_mem_size += gravity.memory_size();
+  }
   
+  alloc_timer.stop();
+
   // perform init condition
   init(U);
   
   // initialize boundaries
   make_boundaries(U);
 
+  // gravity field of the initial condition
+  if (m_self_gravity_enabled) {
+    compute_self_gravity(U);
+    total_mem_size += poisson_solver->memory_size();
+  }
+
   // copy U into U2
   Kokkos::deep_copy(U2,U);
   
@@ -286,6 +329,9 @@ SolverHydroMuscl<dim>::SolverHydroMuscl(HydroParams& params,
     params.print();
     std::cout << "##########################" << "\n";
     std::cout << "Memory requested : " << (total_mem_size / 1e6) << " MBytes\n"; 
+    std::cout << "Allocation + first touch : " << alloc_timer.elapsed() << " s ("
+              << Device().concurrency() << " " << Device::name() << " threads)\n";
+    m_workspace.print_info();
     std::cout << "##########################" << "\n";
   }
 
@@ -339,10 +385,31 @@ void SolverHydroMuscl<dim>::init_implode(DataArray Udata)
 			      InitImplodeFunctor3D>::type;
 
   // perform init
-  InitImplodeFunctor::apply(params, iparams, Udata, nbCells);
+  InitImplodeFunctor::apply(kernel_params, iparams, Udata, nbCells);
 
 } // SolverHydroMuscl::init_implode
 
+// =======================================================
+// =======================================================
+/**
+ * Initial conditions are defined with the ideal gas law (gamma0): when
+ * a tabulated EOS is active, recompute the total energy so that the
+ * initial pressure is obtained through the table.
+ */
+template<int dim>
+void SolverHydroMuscl<dim>::init_eos_energy(DataArray Udata)
+{
+
+  // alias to actual device functor
+  using InitEosEnergyFunctor =
+    typename std::conditional<dim==2,
+			      InitEosEnergyFunctor2D,
+			      InitEosEnergyFunctor3D>::type;
+
+  InitEosEnergyFunctor::apply(kernel_params, Udata, nbCells);
+
+} // SolverHydroMuscl::init_eos_energy
+
 // =======================================================
 // =======================================================
 /**
@@ -362,7 +429,7 @@ void SolverHydroMuscl<dim>::init_blast(DataArray Udata)
 			      InitBlastFunctor3D>::type;
 
   // perform init
-  InitBlastFunctor::apply(params, blastParams, Udata, nbCells);
+  InitBlastFunctor::apply(kernel_params, blastParams, Udata, nbCells);
 
 } // SolverHydroMuscl::init_blast
 
@@ -391,7 +458,7 @@ void SolverHydroMuscl<dim>::init_kelvin_helmholtz(DataArray Udata)
 			      InitKelvinHelmholtzFunctor3D>::type;
 
   // perform init
-  InitKelvinHelmholtzFunctor::apply(params, khParams, Udata, nbCells);
+  InitKelvinHelmholtzFunctor::apply(kernel_params, khParams, Udata, nbCells);
 
 } // SolverHydroMuscl::init_kelvin_helmholtz
 
@@ -418,7 +485,7 @@ void SolverHydroMuscl<dim>::init_gresho_vortex(DataArray Udata)
 			      InitGreshoVortexFunctor3D>::type;
 
   // perform init
-  InitGreshoVortexFunctor::apply(params, gvParams, Udata, nbCells);
+  InitGreshoVortexFunctor::apply(kernel_params, gvParams, Udata, nbCells);
 
 } // SolverHydroMuscl<dim>::init_gresho_vortex
 
@@ -474,8 +541,7 @@ void SolverHydroMuscl<2>::init_isentropic_vortex(DataArray Udata);
  *
  */
 template<int dim>
-void SolverHydroMuscl<dim>::init_rayleigh_taylor(DataArray Udata,
-						 VectorField gravity)
+void SolverHydroMuscl<dim>::init_rayleigh_taylor(DataArray Udata)
 {
   
   RayleighTaylorInstabilityParams rtiParams =
@@ -488,7 +554,7 @@ void SolverHydroMuscl<dim>::init_rayleigh_taylor(DataArray Udata,
   			      RayleighTaylorInstabilityFunctor3D>::type;
   
   // perform init
-  RTIFunctor::apply(params, rtiParams, Udata, gravity);
+  RTIFunctor::apply(kernel_params, rtiParams, Udata);
   
 } // SolverHydroMuscl::init_rayleigh_taylor
 
@@ -499,8 +565,7 @@ void SolverHydroMuscl<dim>::init_rayleigh_taylor(DataArray Udata,
  *
  */
 template<int dim>
-void SolverHydroMuscl<dim>::init_rising_bubble(DataArray Udata,
-					       VectorField gravity)
+void SolverHydroMuscl<dim>::init_rising_bubble(DataArray Udata)
 {
   
   RisingBubbleParams rbParams =
@@ -513,7 +578,7 @@ void SolverHydroMuscl<dim>::init_rising_bubble(DataArray Udata,
   			      RisingBubbleFunctor3D>::type;
   
   // perform init
-  RBFunctor::apply(params, rbParams, Udata, gravity);
+  RBFunctor::apply(kernel_params, rbParams, Udata);
   
 } // SolverHydroMuscl::init_rising_bubble
 
@@ -524,8 +589,7 @@ void SolverHydroMuscl<dim>::init_rising_bubble(DataArray Udata,
  *
  */
 template<int dim>
-void SolverHydroMuscl<dim>::init_disk(DataArray Udata,
-				      VectorField gravity)
+void SolverHydroMuscl<dim>::init_disk(DataArray Udata)
 {
   
   DiskParams dParams = DiskParams(configMap);
@@ -538,10 +602,132 @@ void SolverHydroMuscl<dim>::init_disk(DataArray Udata,
     			      InitDiskFunctor3D>::type;
   
   // perform init
-  InitDiskFunctor::apply(params, dParams, pgrav, Udata, gravity);
+  InitDiskFunctor::apply(kernel_params, dParams, pgrav, Udata);
   
 } // SolverHydroMuscl::init_disk
 
+// =======================================================
+// =======================================================
+/**
+ * Setup gravity field.
+ *
+ * Uniform and point source fields are evaluated on the fly inside
+ * kernels, no memory is allocated for them.
+ *
+ * A single gravity source is used:
+ * - problems rayleigh_taylor and rising_bubble: uniform field,
+ * - problem disk: point source located relative to the disk center,
+ * - [gravity] self=true: field computed by the Poisson solver,
+ * - [gravity] point=true, other problems: point source of section
+ *   [gravity] (this field used to be left at zero for problems other
+ *   than disk).
+ * Settings asking for two different sources (self-gravity along with a
+ * problem gravity or a point source, point source with a uniform field
+ * problem) abort the run.
+ */
+template<int dim>
+void SolverHydroMuscl<dim>::init_gravity()
+{
+
+  const bool uniform_problem =
+    !m_problem_name.compare("rayleigh_taylor") or
+    !m_problem_name.compare("rising_bubble");
+  const bool disk_problem = !m_problem_name.compare("disk");
+
+  const bool conflict =
+    (m_self_gravity_enabled and
+     (uniform_problem or disk_problem or m_point_gravity_enabled)) or
+    (m_point_gravity_enabled and uniform_problem);
+
+  if (conflict) {
+    int myRank=0;
+#ifdef USE_MPI
+    myRank = params.myRank;
+#endif // USE_MPI
+    if (myRank==0)
+      std::cerr << "SolverHydroMuscl: conflicting gravity settings (problem "
+		<< m_problem_name
+		<< (m_self_gravity_enabled ? ", [gravity] self=true" : "")
+		<< (m_point_gravity_enabled ? ", [gravity] point=true" : "")
+		<< "), only one gravity source can be used\n";
+    exit(EXIT_FAILURE);
+  }
+
+  if ( !m_problem_name.compare("rayleigh_taylor") ) {
+
+    RayleighTaylorInstabilityParams rtiParams =
+      RayleighTaylorInstabilityParams(configMap);
+
+    gravity = GravityField<dim>::uniform(rtiParams.gx,
+					 rtiParams.gy,
+					 rtiParams.gz);
+
+  } else if ( !m_problem_name.compare("rising_bubble") ) {
+
+    RisingBubbleParams rbParams = RisingBubbleParams(configMap);
+
+    gravity = GravityField<dim>::uniform(rbParams.gx,
+					 rbParams.gy,
+					 rbParams.gz);
+
+  } else if ( !m_problem_name.compare("disk") ) {
+
+    // point source location is given relative to disk center
+    DiskParams dParams = DiskParams(configMap);
+    PointSourceGravity pgrav = PointSourceGravity(configMap);
+    pgrav.xs += dParams.xc;
+    pgrav.ys += dParams.yc;
+    if (dim==3)
+      pgrav.zs += dParams.zc;
+
+    gravity = GravityField<dim>::point_source(params, pgrav);
+
+  } else if (m_self_gravity_enabled) {
+
+    // field is computed by the Poisson solver at each time step
+    VectorField field;
+    if (dim==2)
+      field = allocate_first_touch<VectorField>("gravity field", nbCells, isize,jsize);
+    else
+      field = allocate_first_touch<VectorField>("gravity field", nbCells, isize,jsize,ksize);
+    gravity = GravityField<dim>::stored(field);
+
+    poisson_solver = std::make_shared<PoissonMultigrid<dim> >(params, configMap);
+
+  } else if (m_point_gravity_enabled) {
+
+    PointSourceGravity pgrav = PointSourceGravity(configMap);
+    gravity = GravityField<dim>::point_source(params, pgrav);
+
+  } else {
+
+    // no analytic expression available: zero field
+    gravity = GravityField<dim>();
+
+  }
+
+} // SolverHydroMuscl::init_gravity
+
+// =======================================================
+// =======================================================
+/**
+ * Self-gravity: solve Poisson equation with the density of Udata,
+ * gravity field is stored in array gravity.
+ */
+template<int dim>
+void SolverHydroMuscl<dim>::compute_self_gravity(DataArray Udata)
+{
+
+  timers[TIMER_GRAVITY]->start();
+  Kokkos::Profiling::pushRegion("gravity");
+
+  poisson_solver->solve(Udata, gravity.field);
+
+  Kokkos::Profiling::popRegion();
+  timers[TIMER_GRAVITY]->stop();
+
+} // SolverHydroMuscl::compute_self_gravity
+
 // =======================================================
 // =======================================================
 template<int dim>
@@ -558,6 +744,7 @@ void SolverHydroMuscl<dim>::init_restart(DataArray Udata)
 
   // whether or not we are upscaling input data is handled inside "load_data"
   // m_times_saved are read from file
+  allocate_host_mirror(Udata, Uhost);
   reader->load_data(Udata, Uhost, m_times_saved, m_t);
 
   // increment to avoid overriding last output (?)
@@ -642,13 +829,24 @@ double SolverHydroMuscl<dim>::compute_dt_local()
       				ComputeDtGravityFunctor2D,
       				ComputeDtGravityFunctor3D>::type;
     
-    // call device functor
-    ComputeDtFunctor::apply(params,
-			    params.settings.cfl,
-			    gravity,
-			    Udata,
-			    nbCells,
-			    invDt);
+    // call device functor (fused with diagnostics when due)
+    if (m_diagnostics->is_due(m_iteration))
+      ComputeDiagnosticsFunctor<dim,ComputeDtFunctor>::apply(kernel_params, Udata,
+							      ComputeDtFunctor(kernel_params,
+									       params.settings.cfl,
+									       gravity,
+									       Udata),
+							      params.mhdEnabled,
+							      nbCells,
+							      *m_diagnostics,
+							      invDt);
+    else
+      ComputeDtFunctor::apply(kernel_params,
+			      params.settings.cfl,
+			      gravity,
+			      Udata,
+			      nbCells,
+			      invDt);
     
   } else {
 
@@ -660,8 +858,16 @@ double SolverHydroMuscl<dim>::compute_dt_local()
 				ComputeDtFunctor2D,
 				ComputeDtFunctor3D>::type;
     
-    // call device functor
-    ComputeDtFunctor::apply(params, Udata, nbCells, invDt);
+    // call device functor (fused with diagnostics when due)
+    if (m_diagnostics->is_due(m_iteration))
+      ComputeDiagnosticsFunctor<dim,ComputeDtFunctor>::apply(kernel_params, Udata,
+							      ComputeDtFunctor(kernel_params, Udata),
+							      params.mhdEnabled,
+							      nbCells,
+							      *m_diagnostics,
+							      invDt);
+    else
+      ComputeDtFunctor::apply(kernel_params, Udata, nbCells, invDt);
     
   }
   
@@ -686,6 +892,10 @@ void SolverHydroMuscl<dim>::next_iteration_impl()
   if (m_iteration % m_nlog == 0) {
     if (myRank==0) {
       printf("time step=%7d (dt=% 10.8f t=% 10.8f)\n",m_iteration,m_dt, m_t);
+      if (m_self_gravity_enabled)
+	printf("    poisson solver: %2d V-cycles (residual=% 10.3e)\n",
+	       poisson_solver->get_nb_cycles(),
+	       poisson_solver->get_residual());
     }
   }
   
@@ -702,11 +912,30 @@ void SolverHydroMuscl<dim>::next_iteration_impl()
       save_solution();
       
     } // end output
+
+    // reduced-volume outputs (slices, subvolumes)
+    if ( m_io_products->enabled() ) {
+      timers[TIMER_IO]->start();
+      Kokkos::Profiling::pushRegion("io");
+      m_io_products->save(m_iteration % 2 == 0 ? U : U2, m_iteration, m_t);
+      Kokkos::Profiling::popRegion();
+      timers[TIMER_IO]->stop();
+    }
   } // end enable output
+
+  // in-situ analysis plugins
+  if ( m_analysis->enabled() )
+    m_analysis->run(m_iteration % 2 == 0 ? U : U2, m_iteration, m_t);
   
+  // update self-gravity field with current density
+  if (m_self_gravity_enabled)
+    compute_self_gravity(m_iteration % 2 == 0 ? U : U2);
+
   // compute new dt
   timers[TIMER_DT]->start();
+  Kokkos::Profiling::pushRegion("compute_dt");
   compute_dt();
+  Kokkos::Profiling::popRegion();
   timers[TIMER_DT]->stop();
   
   // perform one step integration
@@ -774,7 +1003,7 @@ void SolverHydroMuscl<dim>::convertToPrimitives(DataArray Udata)
 			      ConvertToPrimitivesFunctor3D>::type;
 
   // call device functor
-  ConvertToPrimitivesFunctor::apply(params, Udata, Q);
+  ConvertToPrimitivesFunctor::apply(kernel_params, Udata, Q);
   
 } // SolverHydroMuscl::convertToPrimitives
 
@@ -785,11 +1014,14 @@ void SolverHydroMuscl<dim>::save_solution_impl()
 {
 
   timers[TIMER_IO]->start();
+  Kokkos::Profiling::pushRegion("io");
+  allocate_host_mirror(U, Uhost);
   if (m_iteration % 2 == 0)
     save_data(U,  Uhost, m_times_saved, m_t);
   else
     save_data(U2, Uhost, m_times_saved, m_t);
   
+  Kokkos::Profiling::popRegion();
   timers[TIMER_IO]->stop();
     
 } // SolverHydroMuscl::save_solution_impl()
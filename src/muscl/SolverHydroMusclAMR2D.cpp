@@ -0,0 +1,1161 @@
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <array>
+#include <map>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#include "muscl/SolverHydroMusclAMR2D.h"
+#include "shared/HydroParams.h"
+#include "shared/FirstTouch.h"
+#include "shared/utils.h" // for UNUSED
+
+// the actual computational functors called on block pools
+#include "muscl/HydroRunFunctors2D.h"
+
+// Init conditions functors
+#include "muscl/HydroInitFunctors2D.h"
+#include "shared/problems/initRiemannConfig2d.h"
+#include "shared/problems/BlastParams.h"
+#include "shared/problems/GreshoParams.h"
+#include "shared/problems/IsentropicVortexParams.h"
+
+namespace ppkMHD { namespace muscl {
+
+// =======================================================
+// =======================================================
+/**
+ * Copy a host list of tasks into a device table.
+ */
+template<size_t N>
+static AMRTable make_table(const std::string& label,
+			   const std::vector<std::array<int,N> >& tasks)
+{
+
+  AMRTable table(label, tasks.size(), N);
+  AMRTable::HostMirror table_host = Kokkos::create_mirror_view(table);
+
+  for (size_t t=0; t<tasks.size(); ++t)
+    for (size_t n=0; n<N; ++n)
+      table_host(t,n) = tasks[t][n];
+
+  Kokkos::deep_copy(table, table_host);
+
+  return table;
+
+} // make_table
+
+// =======================================================
+// =======================================================
+/**
+ * Block exchange from lists of slots (send[r]: slots sent to process r,
+ * recv[r]: slots received from process r), block_size values per block.
+ */
+static void make_exchange(SolverHydroMusclAMR2D::Exchange& ex,
+			  const std::vector<std::vector<int> >& send,
+			  const std::vector<std::vector<int> >& recv,
+			  int block_size)
+{
+
+  const int nProcs = send.size();
+
+  std::vector<std::array<int,1> > send_slots, recv_slots;
+
+  ex.send_counts.assign(nProcs, 0);
+  ex.send_displs.assign(nProcs, 0);
+  ex.recv_counts.assign(nProcs, 0);
+  ex.recv_displs.assign(nProcs, 0);
+
+  for (int r=0; r<nProcs; ++r) {
+
+    ex.send_displs[r] = send_slots.size() * block_size;
+    ex.send_counts[r] = send[r].size() * block_size;
+    for (int slot : send[r])
+      send_slots.push_back({slot});
+
+    ex.recv_displs[r] = recv_slots.size() * block_size;
+    ex.recv_counts[r] = recv[r].size() * block_size;
+    for (int slot : recv[r])
+      recv_slots.push_back({slot});
+
+  }
+
+  ex.send_slots  = make_table("send_slots", send_slots);
+  ex.recv_slots  = make_table("recv_slots", recv_slots);
+  ex.send_buffer = AMRBuffer("send_buffer", send_slots.size() * block_size);
+  ex.recv_buffer = AMRBuffer("recv_buffer", recv_slots.size() * block_size);
+
+} // make_exchange
+
+// =======================================================
+// =======================================================
+//! is rank in a sorted list of processes ?
+static bool holds(const std::vector<int>& ranks, int rank)
+{
+
+  return std::binary_search(ranks.begin(), ranks.end(), rank);
+
+} // holds
+
+// face -> (di,dj), and children of the neighbor along the face (see
+// AMRFluxCorrectionFunctor2D)
+static const int face_di[4] = {-1, 1,  0, 0};
+static const int face_dj[4] = { 0, 0, -1, 1};
+static const int face_children[4][2] = { {1,3}, {0,2}, {2,3}, {0,1} };
+
+// =======================================================
+// ==== CLASS SolverHydroMusclAMR2D IMPL =================
+// =======================================================
+
+// =======================================================
+// =======================================================
+SolverHydroMusclAMR2D::SolverHydroMusclAMR2D(HydroParams& params,
+					     ConfigMap& configMap) :
+  SolverBase(params, configMap),
+  tree(), levels(), U(), Uhost(),
+  m_owner(), m_holders(), m_output_holders(), m_slot(),
+  m_output_exchange(), m_bi0(0), m_bj0(0)
+{
+
+  solver_type = SOLVER_MUSCL_HANCOCK;
+
+  m_nDofsPerCell = 1;
+
+  m_block_size         = configMap.getInteger("amr", "block_size", 16);
+  m_max_level          = configMap.getInteger("amr", "max_level", 2);
+  m_regrid_interval    = configMap.getInteger("amr", "regrid_interval", 4);
+  m_refine_threshold   = configMap.getFloat("amr", "refine_threshold", 0.1);
+  m_derefine_threshold = configMap.getFloat("amr", "derefine_threshold", 0.025);
+  m_refine_pressure    =
+    !configMap.getString("amr", "refine_variable", "density").compare("pressure");
+
+  int myRank=0;
+  int mx=1, my=1;
+#ifdef USE_MPI
+  myRank = params.myRank;
+  mx = params.mx;
+  my = params.my;
+#endif // USE_MPI
+
+  if (m_block_size < 2*params.ghostWidth or m_block_size % 2 != 0 or
+      params.nx % m_block_size != 0 or params.ny % m_block_size != 0) {
+    std::cerr << "SolverHydroMusclAMR2D: [amr] block_size must be even, "
+	      << "at least " << 2*params.ghostWidth << ", and divide nx and ny\n";
+    exit(EXIT_FAILURE);
+  }
+
+#ifdef USE_MPI
+  // level 0 blocks of the sub-domain of this process (outputs)
+  m_bi0 = params.myMpiPos[IX] * (params.nx / m_block_size);
+  m_bj0 = params.myMpiPos[IY] * (params.ny / m_block_size);
+#endif // USE_MPI
+
+  if (m_gravity_enabled) {
+    if (myRank==0)
+      std::cerr << "SolverHydroMusclAMR2D: gravity is not supported\n";
+    exit(EXIT_FAILURE);
+  }
+
+  // the tree covers the whole domain
+  tree = std::make_shared<BlockTree2D>(mx * params.nx / m_block_size,
+				       my * params.ny / m_block_size,
+				       m_max_level,
+				       params.boundary_type_xmin == BC_PERIODIC,
+				       params.boundary_type_ymin == BC_PERIODIC);
+
+  // level 0 grid, for outputs only
+  U = allocate_first_touch<DataArray2d>("U", params.isize*params.jsize,
+					params.isize, params.jsize, params.nbvar);
+
+  allocate_levels();
+  build_tables();
+
+  /*
+   * initial refinement: evaluate the initial condition on the current
+   * blocks, refine where needed and start again
+   */
+  for (int pass=0; pass<m_max_level; ++pass) {
+
+    init_blocks();
+    restrict_levels();
+    fill_ghosts();
+
+    std::vector<int> flags = compute_flags(false);
+    if (!tree->adapt(flags))
+      break;
+
+    allocate_levels();
+    build_tables();
+
+  }
+
+  init_blocks();
+  restrict_levels();
+  fill_ghosts();
+
+  // compute initialize time step
+  compute_dt();
+
+  if (myRank==0) {
+    std::cout << "##########################" << "\n";
+    std::cout << "Solver is " << m_solver_name << "\n";
+    std::cout << "Problem (init condition) is " << m_problem_name << "\n";
+    std::cout << "##########################" << "\n";
+
+    // print parameters on screen
+    params.print();
+    std::cout << "##########################" << "\n";
+    std::cout << "AMR blocks of " << m_block_size << "x" << m_block_size
+	      << " cells, max level " << m_max_level << "\n";
+    for (int level=0; level<tree->nb_levels(); ++level)
+      std::cout << "  level " << level << " : "
+		<< tree->nb_leaves(level) << " leaves, "
+		<< tree->nb_slots(level) << " blocks\n";
+    std::cout << "Leaf cells : "
+	      << (long long int) tree->nb_leaves() * m_block_size * m_block_size
+	      << " (uniform grid at max level : "
+	      << ((long long int) mx*params.nx*my*params.ny << (2*m_max_level)) << ")\n";
+    std::cout << "##########################" << "\n";
+  }
+
+} // SolverHydroMusclAMR2D::SolverHydroMusclAMR2D
+
+// =======================================================
+// =======================================================
+SolverHydroMusclAMR2D::~SolverHydroMusclAMR2D()
+{
+
+} // SolverHydroMusclAMR2D::~SolverHydroMusclAMR2D
+
+// =======================================================
+// =======================================================
+AMRLevelInfo SolverHydroMusclAMR2D::level_info(int level) const
+{
+
+  AMRLevelInfo info;
+
+  info.bx       = m_block_size;
+  info.by       = m_block_size;
+  info.gw       = params.ghostWidth;
+  info.Bi       = m_block_size + 2*params.ghostWidth;
+  info.Bj       = m_block_size + 2*params.ghostWidth;
+  info.nbx      = tree->nbx(level);
+  info.nby      = tree->nby(level);
+  info.nb_slots = levels[level].nb_slots;
+
+  return info;
+
+} // SolverHydroMusclAMR2D::level_info
+
+// =======================================================
+// =======================================================
+/**
+ * The regular kernels see the first nb_blocks blocks of a level pool as
+ * a single (tall) grid.
+ */
+KernelParams SolverHydroMusclAMR2D::level_params(int level, int nb_blocks) const
+{
+
+  const AMRLevelInfo info = level_info(level);
+
+  KernelParams kparams(kernel_params);
+
+  kparams.nx    = info.bx;
+  kparams.ny    = info.by;
+  kparams.isize = info.Bi;
+  kparams.jsize = info.Bj * nb_blocks;
+  kparams.imin  = 0;
+  kparams.imax  = kparams.isize-1;
+  kparams.jmin  = 0;
+  kparams.jmax  = kparams.jsize-1;
+  kparams.dx    = params.dx / (1 << level);
+  kparams.dy    = params.dy / (1 << level);
+
+#ifdef USE_MPI
+  // block origins are global (see init_blocks)
+  kparams.myMpiPos[IX] = 0;
+  kparams.myMpiPos[IY] = 0;
+  kparams.myMpiPos[IZ] = 0;
+#endif // USE_MPI
+
+  return kparams;
+
+} // SolverHydroMusclAMR2D::level_params
+
+// =======================================================
+// =======================================================
+/**
+ * Blocks are split between MPI processes along the Morton curve (see
+ * BlockTree2D::partition). Besides the blocks it owns, a process holds
+ * copies of the remote blocks read by its own blocks:
+ * - same level and coarser neighbors (ghost cells),
+ * - children (restriction) and parent (prolongation at regrid),
+ * - finer leaves across a face of an owned leaf (flux correction, their
+ *   fluxes are computed from the copy),
+ * and, for outputs only, of the level 0 blocks of its sub-domain.
+ *
+ * Every process computes the same owners and holders for all blocks, so
+ * that both sides of an exchange agree on what is sent.
+ */
+void SolverHydroMusclAMR2D::distribute()
+{
+
+  int myRank=0;
+  int nProcs=1;
+#ifdef USE_MPI
+  myRank = params.myRank;
+  nProcs = params.nProcs;
+#endif // USE_MPI
+
+  const int nb_blocks = tree->nb_blocks();
+
+  m_owner = tree->partition(nProcs);
+  m_holders.assign(nb_blocks, std::vector<int>());
+  m_output_holders.assign(nb_blocks, std::vector<int>());
+
+  // remote leaves whose fluxes are computed by this process
+  std::vector<bool> flux_copy(nb_blocks, false);
+
+  auto need = [this](int rank, int id) {
+    if (id >= 0 and m_owner[id] != rank)
+      m_holders[id].push_back(rank);
+  };
+
+  for (int id=0; id<nb_blocks; ++id) {
+
+    const Block& b = tree->block(id);
+    const int rank  = m_owner[id];
+    const int level = b.key.level;
+
+    for (int dj=-1; dj<=1; ++dj) {
+      for (int di=-1; di<=1; ++di) {
+	int ni = b.key.bi+di, nj = b.key.bj+dj;
+	if ((di == 0 and dj == 0) or !tree->wrap(level, ni, nj))
+	  continue;
+	const int n = tree->find(level, ni, nj);
+	need(rank, n >= 0 ? n : tree->find(level-1, ni >> 1, nj >> 1));
+      }
+    }
+
+    if (b.is_leaf()) {
+      for (int face=0; face<4; ++face) {
+	const int n = tree->find(level, b.key.bi+face_di[face], b.key.bj+face_dj[face]);
+	if (n < 0 or tree->block(n).is_leaf())
+	  continue;
+	for (int c=0; c<2; ++c) {
+	  const int child = tree->block(n).children[face_children[face][c]];
+	  need(rank, child);
+	  if (rank == myRank and m_owner[child] != myRank)
+	    flux_copy[child] = true;
+	}
+      }
+    } else {
+      for (int q=0; q<4; ++q)
+	need(rank, b.children[q]);
+    }
+
+    need(rank, b.parent);
+
+#ifdef USE_MPI
+    // level 0 blocks are written by the process of their sub-domain
+    if (level == 0) {
+      const int coords[2] = {b.key.bi / (params.nx / m_block_size),
+			     b.key.bj / (params.ny / m_block_size)};
+      const int rank_out = params.communicator->getCartRank(coords);
+      if (rank_out != rank)
+	m_output_holders[id].push_back(rank_out);
+    }
+#endif // USE_MPI
+
+  }
+
+  for (auto& ranks : m_holders) {
+    std::sort(ranks.begin(), ranks.end());
+    ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+  }
+
+  // pools of this process: owned leaves, remote leaves for fluxes, owned
+  // parents, other copies
+  m_slot.assign(nb_blocks, -1);
+  levels.resize(tree->nb_levels());
+
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    Level& lev = levels[level];
+    const std::vector<int>& ids = tree->level_blocks(level);
+
+    lev.ids.clear();
+
+    for (int id : ids)
+      if (m_owner[id] == myRank and tree->block(id).is_leaf())
+	lev.ids.push_back(id);
+    lev.nb_leaves = lev.ids.size();
+
+    for (int id : ids)
+      if (flux_copy[id])
+	lev.ids.push_back(id);
+    lev.nb_fluxes = lev.ids.size();
+
+    for (int id : ids)
+      if (m_owner[id] == myRank and !tree->block(id).is_leaf())
+	lev.ids.push_back(id);
+    lev.nb_parents = lev.ids.size() - lev.nb_fluxes;
+
+    for (int id : ids)
+      if (!flux_copy[id] and
+	  (holds(m_holders[id], myRank) or holds(m_output_holders[id], myRank)))
+	lev.ids.push_back(id);
+    lev.nb_slots = lev.ids.size();
+
+    for (int slot=0; slot<lev.nb_slots; ++slot)
+      m_slot[lev.ids[slot]] = slot;
+
+  }
+
+} // SolverHydroMusclAMR2D::distribute
+
+// =======================================================
+// =======================================================
+void SolverHydroMusclAMR2D::allocate_levels()
+{
+
+  const int nbvar = params.nbvar;
+  const int Bi = m_block_size + 2*params.ghostWidth;
+  const int Bj = m_block_size + 2*params.ghostWidth;
+
+  distribute();
+
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    Level& lev = levels[level];
+
+    const int nrows = Bj * lev.nb_slots;
+    lev.U = allocate_first_touch<DataArray2d>("U_level", Bi*nrows, Bi, nrows, nbvar);
+
+    // transient arrays only cover leaves whose fluxes are computed
+    const int nrows_leaves = Bj * std::max(lev.nb_fluxes, 1);
+    lev.Q        = DataArray2d("Q_level",        Bi, nrows_leaves, nbvar);
+    lev.Fluxes_x = DataArray2d("Fluxes_x_level", Bi, nrows_leaves, nbvar);
+    lev.Fluxes_y = DataArray2d("Fluxes_y_level", Bi, nrows_leaves, nbvar);
+
+  }
+
+  // per process on average (performance counters multiply by the number
+  // of processes)
+  int nProcs=1;
+#ifdef USE_MPI
+  nProcs = params.nProcs;
+#endif // USE_MPI
+  m_nCells = (long long int) tree->nb_leaves() * m_block_size * m_block_size / nProcs;
+
+} // SolverHydroMusclAMR2D::allocate_levels
+
+// =======================================================
+// =======================================================
+/**
+ * Tables only describe the blocks owned by this process: neighbors of
+ * copies of remote blocks are left as physical borders (their ghost
+ * cells come with the copy).
+ */
+void SolverHydroMusclAMR2D::build_tables()
+{
+
+  int myRank=0;
+  int nProcs=1;
+#ifdef USE_MPI
+  myRank = params.myRank;
+  nProcs = params.nProcs;
+#endif // USE_MPI
+
+  const AMRLevelInfo info0 = level_info(0);
+  const int block_size = info0.Bi * info0.Bj * params.nbvar;
+
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    Level& lev = levels[level];
+
+    std::vector<std::array<int,2> > coords;
+    std::vector<std::array<int,9> > neighbor, neighbor_type;
+    std::vector<std::array<int,4> > children, corrections;
+
+    for (int slot=0; slot<lev.nb_slots; ++slot) {
+
+      const int id = lev.ids[slot];
+      const Block& b = tree->block(id);
+      const int bi = b.key.bi;
+      const int bj = b.key.bj;
+      const bool owned = m_owner[id] == myRank;
+
+      coords.push_back({bi, bj});
+
+      std::array<int,9> n_slot, n_type;
+      for (int dj=-1; dj<=1; ++dj) {
+	for (int di=-1; di<=1; ++di) {
+	  const int dir = (di+1) + 3*(dj+1);
+
+	  int ni = bi+di, nj = bj+dj;
+	  const int n = tree->find(level, ni, nj);
+	  const int c = tree->find(level-1, ni >> 1, nj >> 1);
+
+	  if ((di == 0 and dj == 0) or !owned or !tree->wrap(level, ni, nj)) {
+	    n_type[dir] = AMR_NB_BOUNDARY;
+	    n_slot[dir] = -1;
+	  } else if (n >= 0) {
+	    n_type[dir] = AMR_NB_SAME;
+	    n_slot[dir] = m_slot[n];
+	  } else {
+	    // 2:1 balance: covered by a leaf of the coarser level
+	    n_type[dir] = AMR_NB_COARSE;
+	    n_slot[dir] = m_slot[c];
+	  }
+	}
+      }
+      neighbor.push_back(n_slot);
+      neighbor_type.push_back(n_type);
+
+      std::array<int,4> c_slot;
+      for (int q=0; q<4; ++q)
+	c_slot[q] = (b.is_leaf() or !owned) ? -1 : m_slot[b.children[q]];
+      children.push_back(c_slot);
+
+      // faces of an owned leaf shared with finer leaves
+      if (b.is_leaf() and owned) {
+	for (int face=0; face<4; ++face) {
+	  const int n = tree->find(level, bi+face_di[face], bj+face_dj[face]);
+	  if (n < 0 or tree->block(n).is_leaf())
+	    continue;
+
+	  const Block& nb = tree->block(n);
+	  corrections.push_back({slot, face,
+		m_slot[nb.children[face_children[face][0]]],
+		m_slot[nb.children[face_children[face][1]]]});
+	}
+      }
+
+    } // end for slot
+
+    lev.coords        = make_table("coords",        coords);
+    lev.neighbor      = make_table("neighbor",      neighbor);
+    lev.neighbor_type = make_table("neighbor_type", neighbor_type);
+    lev.children      = make_table("children",      children);
+    lev.corrections   = make_table("corrections",   corrections);
+
+    // copies of remote blocks, in the same (tree) order on both sides
+    std::vector<std::vector<int> > send(nProcs), recv(nProcs);
+    for (int id : tree->level_blocks(level)) {
+      if (m_owner[id] == myRank) {
+	for (int rank : m_holders[id])
+	  send[rank].push_back(m_slot[id]);
+      } else if (holds(m_holders[id], myRank)) {
+	recv[m_owner[id]].push_back(m_slot[id]);
+      }
+    }
+    make_exchange(lev.exchange, send, recv, block_size);
+
+  } // end for level
+
+  // level 0 blocks for outputs
+  std::vector<std::vector<int> > send(nProcs), recv(nProcs);
+  for (int id : tree->level_blocks(0)) {
+    if (m_owner[id] == myRank) {
+      for (int rank : m_output_holders[id])
+	send[rank].push_back(m_slot[id]);
+    } else if (holds(m_output_holders[id], myRank)) {
+      recv[m_owner[id]].push_back(m_slot[id]);
+    }
+  }
+  make_exchange(m_output_exchange, send, recv, block_size);
+
+} // SolverHydroMusclAMR2D::build_tables
+
+// =======================================================
+// =======================================================
+/**
+ * Collective: every process must call it, on the same level, even with
+ * nothing to exchange. Usrc and Udst may be the same pool.
+ */
+void SolverHydroMusclAMR2D::exchange(Exchange& ex,
+				     DataArray2d Usrc,
+				     DataArray2d Udst,
+				     int level)
+{
+
+#ifdef USE_MPI
+  const AMRLevelInfo info = level_info(level);
+
+  AMRPackBlocksFunctor2D::apply(kernel_params, info, Usrc,
+				ex.send_buffer, ex.send_slots, false);
+  Kokkos::fence();
+
+  params.communicator->allToAllv(ex.send_buffer.data(), ex.send_counts.data(),
+				 ex.send_displs.data(), params.data_type,
+				 ex.recv_buffer.data(), ex.recv_counts.data(),
+				 ex.recv_displs.data(), params.data_type);
+
+  AMRPackBlocksFunctor2D::apply(kernel_params, info, Udst,
+				ex.recv_buffer, ex.recv_slots, true);
+#else
+  UNUSED(ex);
+  UNUSED(Usrc);
+  UNUSED(Udst);
+  UNUSED(level);
+#endif // USE_MPI
+
+} // SolverHydroMusclAMR2D::exchange
+
+// =======================================================
+// =======================================================
+/**
+ * The initial condition functors are called block by block, on a
+ * temporary array, with a KernelParams whose origin is the block corner.
+ */
+void SolverHydroMusclAMR2D::init_blocks()
+{
+
+  const AMRLevelInfo info0 = level_info(0);
+  const int Bi = info0.Bi;
+  const int Bj = info0.Bj;
+
+  DataArray2d Ublock("Ublock", Bi, Bj, params.nbvar);
+
+  std::string problem = m_problem_name;
+  if (problem.compare("blast") and problem.compare("four_quadrant") and
+      problem.compare("gresho_vortex") and problem.compare("isentropic_vortex")) {
+    std::cout << "Problem : " << m_problem_name
+	      << " is not recognized / implemented with AMR."
+	      << std::endl;
+    std::cout <<  "Use default - blast" << std::endl;
+    problem = "blast";
+  }
+
+  BlastParams            blastParams(configMap);
+  GreshoParams           gvParams(configMap);
+  IsentropicVortexParams ivParams(configMap);
+
+  int configNumber = configMap.getInteger("riemann2d","config_number",0);
+  real_t xt = configMap.getFloat("riemann2d","x",0.8);
+  real_t yt = configMap.getFloat("riemann2d","y",0.8);
+
+  HydroState2d U0, U1, U2, U3;
+  if (!problem.compare("four_quadrant")) {
+    getRiemannConfig2d(configNumber, U0, U1, U2, U3);
+    primToCons_2D(U0, params.settings.gamma0);
+    primToCons_2D(U1, params.settings.gamma0);
+    primToCons_2D(U2, params.settings.gamma0);
+    primToCons_2D(U3, params.settings.gamma0);
+  }
+
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    const std::vector<int>& ids = levels[level].ids;
+
+    // copies of remote blocks too, no exchange needed
+    for (int slot=0; slot<levels[level].nb_slots; ++slot) {
+
+      const Block& b = tree->block(ids[slot]);
+
+      KernelParams kparams = level_params(level, 1);
+      kparams.xmin = params.xmin + b.key.bi * m_block_size * kparams.dx;
+      kparams.ymin = params.ymin + b.key.bj * m_block_size * kparams.dy;
+
+      if ( !problem.compare("blast") ) {
+	InitBlastFunctor2D::apply(kparams, blastParams, Ublock, Bi*Bj);
+      } else if ( !problem.compare("four_quadrant") ) {
+	InitFourQuadrantFunctor2D::apply(kparams, Ublock, configNumber,
+					 U0, U1, U2, U3,
+					 xt, yt, Bi*Bj);
+      } else if ( !problem.compare("gresho_vortex") ) {
+	InitGreshoVortexFunctor2D::apply(kparams, gvParams, Ublock, Bi*Bj);
+      } else {
+	InitIsentropicVortexFunctor2D::apply(kparams, ivParams, Ublock, Bi*Bj);
+      }
+
+      // initial conditions are written with gamma0
+      if (params.settings.eos.data)
+	InitEosEnergyFunctor2D::apply(kparams, Ublock, Bi*Bj);
+
+      Kokkos::deep_copy(Kokkos::subview(levels[level].U,
+					Kokkos::ALL(),
+					std::make_pair(slot*Bj, (slot+1)*Bj),
+					Kokkos::ALL()),
+			Ublock);
+    }
+
+  }
+
+} // SolverHydroMusclAMR2D::init_blocks
+
+// =======================================================
+// =======================================================
+/**
+ * Children are exchanged before being averaged, so that copies of all
+ * levels but level 0 are up to date on return (see fill_ghosts).
+ */
+void SolverHydroMusclAMR2D::restrict_levels()
+{
+
+  for (int level=tree->nb_levels()-2; level>=0; --level) {
+
+    Level& fine = levels[level+1];
+    exchange(fine.exchange, fine.U, fine.U, level+1);
+
+    const Level& lev = levels[level];
+
+    if (lev.nb_parents > 0)
+      AMRRestrictFunctor2D::apply(level_params(level, lev.nb_slots),
+				  level_info(level),
+				  lev.U, fine.U,
+				  lev.children,
+				  lev.nb_fluxes, lev.nb_parents);
+  }
+
+} // SolverHydroMusclAMR2D::restrict_levels
+
+// =======================================================
+// =======================================================
+/**
+ * Block interiors must be up to date (copies included). Copies get their
+ * ghost cells from their owner once a level is filled.
+ */
+void SolverHydroMusclAMR2D::fill_ghosts()
+{
+
+  timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
+
+  exchange(levels[0].exchange, levels[0].U, levels[0].U, 0);
+
+  // coarse levels first, their ghost cells are used for interpolation
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    Level& lev          = levels[level];
+    const Level& coarse = levels[level > 0 ? level-1 : 0];
+
+    const KernelParams kparams = level_params(level, lev.nb_slots);
+    const AMRLevelInfo info    = level_info(level);
+
+    AMRFillGhostsFunctor2D::apply(kparams, info,
+				  lev.U, coarse.U,
+				  lev.neighbor, lev.neighbor_type,
+				  lev.coords, coarse.coords);
+
+    AMRPhysicalBoundariesFunctor2D::apply(kparams, info, lev.U, lev.coords);
+
+    exchange(lev.exchange, lev.U, lev.U, level);
+
+  }
+
+  Kokkos::Profiling::popRegion();
+  timers[TIMER_BOUNDARIES]->stop();
+
+} // SolverHydroMusclAMR2D::fill_ghosts
+
+// =======================================================
+// =======================================================
+std::vector<int> SolverHydroMusclAMR2D::compute_flags(bool coarsening)
+{
+
+  std::vector<int> flags(tree->nb_blocks(), BlockTree2D::KEEP);
+
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    const Level& lev = levels[level];
+    if (lev.nb_leaves == 0)
+      continue;
+
+    AMRBlockArray indicator("indicator", lev.nb_leaves);
+    AMRRefineIndicatorFunctor2D::apply(level_params(level, lev.nb_leaves),
+				       level_info(level),
+				       lev.U, indicator,
+				       m_refine_pressure,
+				       lev.nb_leaves);
+
+    AMRBlockArray::HostMirror indicator_host = Kokkos::create_mirror_view(indicator);
+    Kokkos::deep_copy(indicator_host, indicator);
+
+    for (int slot=0; slot<lev.nb_leaves; ++slot) {
+      if (indicator_host(slot) > m_refine_threshold)
+	flags[lev.ids[slot]] = BlockTree2D::REFINE;
+      else if (coarsening and indicator_host(slot) < m_derefine_threshold)
+	flags[lev.ids[slot]] = BlockTree2D::COARSEN;
+    }
+
+  }
+
+#ifdef USE_MPI
+  // each leaf is flagged by its owner only (KEEP is 0)
+  std::vector<int> flags_local(flags);
+  params.communicator->allReduce(flags_local.data(), flags.data(),
+				 (int) flags.size(),
+				 hydroSimu::MpiComm::INT, hydroSimu::MpiComm::SUM);
+#endif // USE_MPI
+
+  return flags;
+
+} // SolverHydroMusclAMR2D::compute_flags
+
+// =======================================================
+// =======================================================
+/**
+ * Blocks which still exist are copied, new blocks are interpolated from
+ * their parent (ghost cells of the old pools are up to date). Coarsened
+ * blocks already hold the average of their former children.
+ *
+ * With MPI, blocks are distributed again: the former owner of a block
+ * sends it to the processes which need it now and did not hold an up to
+ * date copy before (new owner, new copies of the scheme).
+ */
+void SolverHydroMusclAMR2D::regrid()
+{
+
+  timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("regrid");
+
+  int myRank=0;
+  int nProcs=1;
+#ifdef USE_MPI
+  myRank = params.myRank;
+  nProcs = params.nProcs;
+#endif // USE_MPI
+
+  // location of blocks before adapting the tree
+  struct OldBlock {
+    int owner;
+    std::vector<int> ranks; //!< owner and up to date copies, sorted
+    int slot;               //!< slot on this process, -1 if not held
+  };
+
+  std::map<BlockKey, OldBlock> old_blocks;
+  for (int id=0; id<tree->nb_blocks(); ++id) {
+    OldBlock old;
+    old.owner = m_owner[id];
+    old.ranks = m_holders[id];
+    old.ranks.insert(std::upper_bound(old.ranks.begin(), old.ranks.end(), old.owner),
+		     old.owner);
+    old.slot  = holds(old.ranks, myRank) ? m_slot[id] : -1;
+    old_blocks[tree->block(id).key] = old;
+  }
+
+  std::vector<Level> old_levels = levels;
+
+  std::vector<int> flags = compute_flags(true);
+
+  if (tree->adapt(flags)) {
+
+    allocate_levels();
+    build_tables();
+
+    const AMRLevelInfo info0 = level_info(0);
+    const int block_size = info0.Bi * info0.Bj * params.nbvar;
+
+    std::vector<std::vector<std::array<int,3> > > prolong_tasks(tree->nb_levels());
+
+    for (int level=0; level<tree->nb_levels(); ++level) {
+
+      Level& lev = levels[level];
+      const DataArray2d Uold = level < (int) old_levels.size() ?
+	old_levels[level].U : DataArray2d();
+
+      std::vector<std::array<int,2> > copy_tasks;
+      std::vector<std::vector<int> > send(nProcs), recv(nProcs);
+
+      for (int id : tree->level_blocks(level)) {
+
+	const Block& b = tree->block(id);
+
+	auto it = old_blocks.find(b.key);
+	if (it == old_blocks.end()) {
+	  if (m_owner[id] == myRank) {
+	    const int q = (b.key.bi & 1) + 2 * (b.key.bj & 1);
+	    prolong_tasks[level].push_back({m_slot[id], m_slot[b.parent], q});
+	  }
+	  continue;
+	}
+
+	const OldBlock& old = it->second;
+
+	// processes which need the block now
+	std::vector<int> ranks = m_holders[id];
+	ranks.insert(std::upper_bound(ranks.begin(), ranks.end(), m_owner[id]),
+		     m_owner[id]);
+
+	for (int rank : ranks) {
+	  if (holds(old.ranks, rank))
+	    continue;
+	  if (old.owner == myRank)
+	    send[rank].push_back(old.slot);
+	  if (rank == myRank)
+	    recv[old.owner].push_back(m_slot[id]);
+	}
+
+	if (old.slot >= 0 and m_slot[id] >= 0)
+	  copy_tasks.push_back({m_slot[id], old.slot});
+
+      }
+
+      if (!copy_tasks.empty())
+	AMRCopyBlocksFunctor2D::apply(level_params(level, lev.nb_slots),
+				      level_info(level),
+				      lev.U, Uold,
+				      make_table("copy_tasks", copy_tasks));
+
+      Exchange migration;
+      make_exchange(migration, send, recv, block_size);
+      exchange(migration, Uold, lev.U, level);
+
+    }
+
+    // parents are all copied by now
+    for (int level=1; level<tree->nb_levels(); ++level)
+      if (!prolong_tasks[level].empty())
+	AMRProlongFunctor2D::apply(level_params(level, levels[level].nb_slots),
+				   level_info(level),
+				   levels[level].U, levels[level-1].U,
+				   make_table("prolong_tasks", prolong_tasks[level]));
+
+    // copies of new blocks
+    restrict_levels();
+
+    Kokkos::Profiling::popRegion();
+    timers[TIMER_NUM_SCHEME]->stop();
+
+    fill_ghosts();
+
+  } else {
+
+    Kokkos::Profiling::popRegion();
+    timers[TIMER_NUM_SCHEME]->stop();
+
+  }
+
+} // SolverHydroMusclAMR2D::regrid
+
+// =======================================================
+// =======================================================
+/**
+ * Compute time step satisfying CFL condition, on the leaves of all
+ * levels.
+ *
+ * \return dt time step
+ */
+double SolverHydroMusclAMR2D::compute_dt_local()
+{
+
+  real_t invDt = ZERO_F;
+
+  for (int level=0; level<tree->nb_levels(); ++level) {
+
+    const Level& lev = levels[level];
+    if (lev.nb_leaves == 0)
+      continue;
+
+    const KernelParams kparams = level_params(level, lev.nb_leaves);
+
+    real_t invDt_level = ZERO_F;
+    ComputeDtFunctor2D::apply(kparams, lev.U,
+			      kparams.isize*kparams.jsize,
+			      invDt_level);
+
+    invDt = FMAX(invDt, invDt_level);
+
+  }
+
+  return params.settings.cfl/invDt;
+
+} // SolverHydroMusclAMR2D::compute_dt_local
+
+// =======================================================
+// =======================================================
+void SolverHydroMusclAMR2D::next_iteration_impl()
+{
+
+  int myRank=0;
+
+#ifdef USE_MPI
+  myRank = params.myRank;
+#endif // USE_MPI
+
+  if (m_iteration % m_nlog == 0) {
+    if (myRank==0) {
+      printf("time step=%7d (dt=% 10.8f t=% 10.8f)\n",m_iteration,m_dt, m_t);
+      printf("    amr: %d leaves, %d levels, %lld cells\n",
+	     tree->nb_leaves(), tree->nb_levels(),
+	     (long long int) tree->nb_leaves() * m_block_size * m_block_size);
+    }
+  }
+
+  // output
+  if (params.enableOutput) {
+    if ( should_save_solution() ) {
+
+      if (myRank==0) {
+	std::cout << "Output results at time t=" << m_t
+		  << " step " << m_iteration
+		  << " dt=" << m_dt << std::endl;
+      }
+
+      save_solution();
+
+    } // end output
+  } // end enable output
+
+  // compute new dt
+  timers[TIMER_DT]->start();
+  Kokkos::Profiling::pushRegion("compute_dt");
+  compute_dt();
+  Kokkos::Profiling::popRegion();
+  timers[TIMER_DT]->stop();
+
+  // perform one step integration
+  godunov_unsplit(m_dt);
+
+  // adapt the mesh
+  if (m_regrid_interval > 0 and (m_iteration+1) % m_regrid_interval == 0)
+    regrid();
+
+} // SolverHydroMusclAMR2D::next_iteration_impl
+
+// =======================================================
+// =======================================================
+void SolverHydroMusclAMR2D::godunov_unsplit(real_t dt)
+{
+
+  const int nb_levels = tree->nb_levels();
+
+  timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
+
+  // fluxes of all leaves, and of remote leaves across coarse / fine
+  // faces
+  Kokkos::Profiling::pushRegion("fluxes");
+  for (int level=0; level<nb_levels; ++level) {
+
+    Level& lev = levels[level];
+    if (lev.nb_fluxes == 0)
+      continue;
+
+    const KernelParams kparams = level_params(level, lev.nb_fluxes);
+
+    ConvertToPrimitivesFunctor2D::apply(kparams, lev.U, lev.Q);
+    ComputeAndStoreFluxesFunctor2D::apply(kparams, lev.Q,
+					  lev.Fluxes_x, lev.Fluxes_y,
+					  dt,
+					  false,
+					  GravityField2d());
+  }
+  Kokkos::Profiling::popRegion();
+
+  // coarse fluxes at coarse / fine faces
+  for (int level=0; level<nb_levels-1; ++level) {
+
+    Level& lev = levels[level];
+    if (lev.corrections.extent(0) == 0)
+      continue;
+
+    AMRFluxCorrectionFunctor2D::apply(level_params(level, lev.nb_fluxes),
+				      level_info(level),
+				      lev.Fluxes_x, lev.Fluxes_y,
+				      levels[level+1].Fluxes_x,
+				      levels[level+1].Fluxes_y,
+				      lev.corrections);
+  }
+
+  // actual update
+  Kokkos::Profiling::pushRegion("update");
+  for (int level=0; level<nb_levels; ++level) {
+
+    Level& lev = levels[level];
+    if (lev.nb_leaves == 0)
+      continue;
+
+    UpdateFunctor2D::apply(level_params(level, lev.nb_leaves), lev.U,
+			   lev.Fluxes_x, lev.Fluxes_y);
+  }
+  Kokkos::Profiling::popRegion();
+
+  restrict_levels();
+
+  Kokkos::Profiling::popRegion();
+  timers[TIMER_NUM_SCHEME]->stop();
+
+  // the update also modified ghost cells between stacked blocks
+  fill_ghosts();
+
+} // SolverHydroMusclAMR2D::godunov_unsplit
+
+// =======================================================
+// =======================================================
+void SolverHydroMusclAMR2D::save_solution_impl()
+{
+
+  timers[TIMER_IO]->start();
+  Kokkos::Profiling::pushRegion("io");
+
+  // level 0 blocks hold the average of finer levels, each process
+  // gathers those of its sub-domain
+  exchange(m_output_exchange, levels[0].U, levels[0].U, 0);
+  AMRGatherFunctor2D::apply(kernel_params, level_info(0), U,
+			    levels[0].U, levels[0].coords,
+			    m_bi0, m_bj0);
+
+  allocate_host_mirror(U, Uhost);
+  save_data(U, Uhost, m_times_saved, m_t);
+
+  save_blocks();
+
+  Kokkos::Profiling::popRegion();
+  timers[TIMER_IO]->stop();
+
+} // SolverHydroMusclAMR2D::save_solution_impl
+
+// =======================================================
+// =======================================================
+/**
+ * One line per leaf block: level, xmin, ymin, xmax, ymax, owner (MPI
+ * process). Written by process 0 only (every process knows the tree).
+ */
+void SolverHydroMusclAMR2D::save_blocks()
+{
+
+#ifdef USE_MPI
+  if (params.myRank != 0)
+    return;
+#endif // USE_MPI
+
+  const std::string outputDir    = configMap.getString("output", "outputDir", "./");
+  const std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+
+  std::ostringstream outNum;
+  outNum.width(7);
+  outNum.fill('0');
+  outNum << m_times_saved;
+
+  const std::string filename = outputDir+"/"+outputPrefix+"_blocks_"+outNum.str()+".txt";
+
+  std::ofstream out(filename.c_str());
+  out << "# time " << m_t << "\n";
+  out << "# level xmin ymin xmax ymax owner\n";
+
+  for (int id=0; id<tree->nb_blocks(); ++id) {
+
+    const Block& b = tree->block(id);
+    if (!b.is_leaf())
+      continue;
+
+    const real_t dx = params.dx * m_block_size / (1 << b.key.level);
+    const real_t dy = params.dy * m_block_size / (1 << b.key.level);
+
+    out << b.key.level << " "
+	<< params.xmin + b.key.bi*dx << " " << params.ymin + b.key.bj*dy << " "
+	<< params.xmin + (b.key.bi+1)*dx << " " << params.ymin + (b.key.bj+1)*dy << " "
+	<< m_owner[id] << "\n";
+  }
+
+} // SolverHydroMusclAMR2D::save_blocks
+
+} // namespace muscl
+
+} // namespace ppkMHD
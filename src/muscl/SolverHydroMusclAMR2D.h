@@ -0,0 +1,241 @@
+/**
+ * Class SolverHydroMusclAMR2D implementation.
+ *
+ * Hydrodynamics (Euler) with MUSCL-Hancock scheme on a 2D block-structured
+ * adaptive mesh.
+ */
+#ifndef SOLVER_HYDRO_MUSCL_AMR_2D_H_
+#define SOLVER_HYDRO_MUSCL_AMR_2D_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// shared
+#include "shared/SolverBase.h"
+#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
+#include "shared/kokkos_shared.h"
+
+// block tree and block pools functors
+#include "muscl/BlockTree2D.h"
+#include "muscl/HydroAMRFunctors2D.h"
+
+namespace ppkMHD { namespace muscl {
+
+/**
+ * MUSCL-Hancock solver on a block-structured adaptive mesh (2D).
+ *
+ * The domain is covered by a quadtree of fixed-size blocks (see
+ * BlockTree2D); each block has bx x by cells plus ghost cells. Blocks of a
+ * level are stacked in a single pool array, so that the regular kernels
+ * (ConvertToPrimitivesFunctor2D, ComputeAndStoreFluxesFunctor2D,
+ * UpdateFunctor2D, ComputeDtFunctor2D) process all leaves of a level in
+ * one launch, with a KernelParams describing the pool.
+ *
+ * A time step:
+ * - fluxes of all leaves, level by level,
+ * - flux correction: a coarse face shared with finer leaves gets the
+ *   average of the fine fluxes (conservation),
+ * - update of all leaves,
+ * - restriction: parents get the average of their children,
+ * - ghost cells, from coarse to fine levels: copy from same level
+ *   neighbors, conservative interpolation from coarser neighbors, then
+ *   physical borders.
+ *
+ * All levels use the same time step (no sub-cycling).
+ *
+ * With MPI, the tree is known by every process, but blocks are
+ * distributed along the Morton space-filling curve (see
+ * BlockTree2D::partition, leaves in equal shares). A process updates
+ * the leaves it owns and restricts the parents it owns; it also holds
+ * copies of the remote blocks they read (neighbors, coarser neighbors,
+ * children, parent, finer leaves across coarse/fine faces), refreshed by
+ * whole block exchanges between processes (see exchange): after the
+ * update and restriction of a level, and after its ghost cells are
+ * filled. Fluxes of the finer remote leaves are recomputed from their
+ * copies for the flux correction. The distribution is recomputed at each
+ * regrid, blocks moving to their new owner.
+ *
+ * Every regrid_interval steps, leaves are refined or coarsened according
+ * to the relative variation of density (or pressure) inside them. New
+ * blocks are initialized by conservative interpolation (minmod limited)
+ * of their parent. At start, refinement is iterated on the initial
+ * condition, evaluated at each level resolution.
+ *
+ * Parameters read in section [amr]:
+ * - block_size: interior cells per block along each direction
+ *   (default 16, must divide nx and ny, and be even)
+ * - max_level: maximum refinement level (default 2, level 0 is the
+ *   nx x ny grid)
+ * - regrid_interval: steps between two regrids (default 4)
+ * - refine_variable: density or pressure (default density)
+ * - refine_threshold: refine a leaf above this value (default 0.1)
+ * - derefine_threshold: coarsen 4 siblings below this value (default 0.025)
+ *
+ * Outputs are written on the level 0 grid (average of the finer levels),
+ * each MPI process writing its cartesian sub-domain (usual mx, my
+ * topology, which only matters for outputs), along with a text file
+ * listing leaf blocks (level, bounding box and owner process).
+ *
+ * Limitations:
+ * - 2D only, hydrodynamics only (no MHD),
+ * - no sub-cycling in time (see above),
+ * - no gravity (the run aborts when it is enabled),
+ * - initial conditions available are blast, four_quadrant, gresho_vortex
+ *   and isentropic_vortex.
+ */
+class SolverHydroMusclAMR2D : public ppkMHD::SolverBase
+{
+
+public:
+
+  SolverHydroMusclAMR2D(HydroParams& params, ConfigMap& configMap);
+  virtual ~SolverHydroMusclAMR2D();
+
+  /**
+   * Static creation method called by the solver factory.
+   */
+  static SolverBase* create(HydroParams& params, ConfigMap& configMap)
+  {
+    SolverHydroMusclAMR2D* solver = new SolverHydroMusclAMR2D(params, configMap);
+
+    return solver;
+  }
+
+  //! MPI exchange of whole blocks between level pools (see exchange)
+  struct Exchange
+  {
+    AMRTable  send_slots; /*!< blocks sent, grouped by destination */
+    AMRTable  recv_slots; /*!< blocks received, grouped by source */
+    AMRBuffer send_buffer;
+    AMRBuffer recv_buffer;
+
+    /* per process, in values */
+    std::vector<int> send_counts;
+    std::vector<int> send_displs;
+    std::vector<int> recv_counts;
+    std::vector<int> recv_displs;
+  };
+
+  //! data of a refinement level, as held by this MPI process
+  struct Level
+  {
+    int nb_leaves;  /*!< owned leaves, slots [0,nb_leaves) */
+    int nb_fluxes;  /*!< leaves whose fluxes are computed, slots
+		      [0,nb_fluxes): owned leaves, then copies of remote
+		      leaves across a face of a coarser owned leaf */
+    int nb_parents; /*!< owned parents, following slots */
+    int nb_slots;   /*!< all of the above, then other remote copies */
+
+    std::vector<int> ids; /*!< block id of each slot */
+
+    DataArray2d U;        /*!< conservative variables (all blocks) */
+    DataArray2d Q;        /*!< primitive variables (nb_fluxes leaves) */
+    DataArray2d Fluxes_x; /*!< fluxes (nb_fluxes leaves) */
+    DataArray2d Fluxes_y; /*!< fluxes (nb_fluxes leaves) */
+
+    AMRTable coords;        /*!< block coordinates of each slot */
+    AMRTable neighbor;      /*!< neighbor slot in the 9 directions */
+    AMRTable neighbor_type; /*!< see AMRNeighborType */
+    AMRTable children;      /*!< children slots on the next level */
+    AMRTable corrections;   /*!< coarse/fine faces of leaves */
+
+    Exchange exchange;      /*!< refresh of the remote copies */
+  };
+
+  //! block tree
+  std::shared_ptr<BlockTree2D> tree;
+
+  //! refinement levels
+  std::vector<Level> levels;
+
+  DataArray2d     U;     /*!< level 0 grid, used for outputs */
+  DataArray2dHost Uhost; /*!< U mirror on host memory space */
+
+  /*
+   * methods
+   */
+
+  //! compute time step inside an MPI process, at shared memory level.
+  double compute_dt_local();
+
+  //! perform 1 time step (time integration).
+  void next_iteration_impl();
+
+  //! numerical scheme
+  void godunov_unsplit(real_t dt);
+
+  //! refine / coarsen leaves
+  void regrid();
+
+  // output
+  void save_solution_impl();
+
+private:
+
+  //! geometry of a level pool
+  AMRLevelInfo level_info(int level) const;
+
+  //! kernel parameters of the first nb_blocks blocks of a level pool
+  KernelParams level_params(int level, int nb_blocks) const;
+
+  //! owner of each block, blocks held by this process and their slots
+  void distribute();
+
+  //! allocate level arrays for the current tree
+  void allocate_levels();
+
+  //! build device tables (neighbors, children, ...) for the current tree
+  void build_tables();
+
+  //! send blocks of Usrc, receive blocks of Udst (pools of a level)
+  void exchange(Exchange& ex, DataArray2d Usrc, DataArray2d Udst, int level);
+
+  //! initial condition on all blocks
+  void init_blocks();
+
+  //! parents get the average of their children
+  void restrict_levels();
+
+  //! fill ghost cells of all blocks
+  void fill_ghosts();
+
+  //! refinement flags of leaves (one per block id)
+  std::vector<int> compute_flags(bool coarsening);
+
+  //! write leaf blocks list
+  void save_blocks();
+
+  //! MPI process owning each block id
+  std::vector<int> m_owner;
+
+  //! other processes holding a copy of each block id, for the scheme
+  std::vector<std::vector<int> > m_holders;
+
+  //! other processes holding a copy of each block id, for outputs
+  std::vector<std::vector<int> > m_output_holders;
+
+  //! slot of each block id in the pools of this process, -1 if not held
+  std::vector<int> m_slot;
+
+  //! level 0 blocks of the sub-domain of this process, for outputs
+  Exchange m_output_exchange;
+
+  //! level 0 block coordinates of the sub-domain origin
+  int m_bi0, m_bj0;
+
+  int m_block_size;
+  int m_max_level;
+  int m_regrid_interval;
+  bool m_refine_pressure;
+  real_t m_refine_threshold;
+  real_t m_derefine_threshold;
+
+}; // class SolverHydroMusclAMR2D
+
+} // namespace muscl
+
+} // namespace ppkMHD
+
+#endif // SOLVER_HYDRO_MUSCL_AMR_2D_H_
@@ -68,7 +68,7 @@ void SolverMHDMuscl<3>::computeElectricField(DataArray Udata)
 {
 
   // call device functor
-  ComputeElecFieldFunctor3D::apply(params, Udata, Q, ElecField, nbCells);
+  ComputeElecFieldFunctor3D::apply(kernel_params, Udata, Q, ElecField, nbCells);
   
 } // SolverMHDMuscl<3>::computeElectricField
 
@@ -83,7 +83,7 @@ void SolverMHDMuscl<3>::computeMagSlopes(DataArray Udata)
 {
 
   // call device functor
-  ComputeMagSlopesFunctor3D::apply(params, Udata, DeltaA, DeltaB, DeltaC, nbCells);
+  ComputeMagSlopesFunctor3D::apply(kernel_params, Udata, DeltaA, DeltaB, DeltaC, nbCells);
   
 } // SolverMHDMuscl3D::computeMagSlopes
 
@@ -105,7 +105,7 @@ void SolverMHDMuscl<2>::computeTrace(DataArray Udata, real_t dt)
   dtdy = dt / params.dy;
 
   // call device functor
-  ComputeTraceFunctor2D_MHD::apply(params, Udata, Q,
+  ComputeTraceFunctor2D_MHD::apply(kernel_params, Udata, Q,
 				   Qm_x, Qm_y,
 				   Qp_x, Qp_y,
 				   QEdge_RT, QEdge_RB,
@@ -134,7 +134,7 @@ void SolverMHDMuscl<3>::computeTrace(DataArray Udata, real_t dt)
   dtdz = dt / params.dz;
 
   // call device functor
-  ComputeTraceFunctor3D_MHD::apply(params, Udata, Q,
+  ComputeTraceFunctor3D_MHD::apply(kernel_params, Udata, Q,
 				   DeltaA, DeltaB, DeltaC, ElecField,
 				   Qm_x, Qm_y, Qm_z,
 				   Qp_x, Qp_y, Qp_z,
@@ -159,12 +159,14 @@ void SolverMHDMuscl<2>::computeFluxesAndStore(real_t dt)
   real_t dtdy = dt / params.dy;
 
   // call device functor
-  ComputeFluxesAndStoreFunctor2D_MHD::apply(params,
+  Kokkos::Profiling::pushRegion("fluxes");
+  ComputeFluxesAndStoreFunctor2D_MHD::apply(kernel_params,
 					    Qm_x, Qm_y,
 					    Qp_x, Qp_y,
 					    Fluxes_x, Fluxes_y,
 					    dtdx, dtdy,
 					    nbCells);
+  Kokkos::Profiling::popRegion();
   
 } // SolverMHDMuscl<2>::computeFluxesAndStore
 
@@ -182,12 +184,14 @@ void SolverMHDMuscl<3>::computeFluxesAndStore(real_t dt)
   real_t dtdz = dt / params.dz;
 
   // call device functor
-  ComputeFluxesAndStoreFunctor3D_MHD::apply(params,
+  Kokkos::Profiling::pushRegion("fluxes");
+  ComputeFluxesAndStoreFunctor3D_MHD::apply(kernel_params,
 					    Qm_x, Qm_y, Qm_z,
 					    Qp_x, Qp_y, Qp_z,
 					    Fluxes_x, Fluxes_y, Fluxes_z,
 					    dtdx, dtdy, dtdz,
 					    nbCells);
+  Kokkos::Profiling::popRegion();
   
 } // SolverMHDMuscl<3>::computeFluxesAndStore
 
@@ -204,11 +208,13 @@ void SolverMHDMuscl<2>::computeEmfAndStore(real_t dt)
   real_t dtdy = dt / params.dy;
 
   // call device functor
-  ComputeEmfAndStoreFunctor2D::apply(params,
+  Kokkos::Profiling::pushRegion("emf");
+  ComputeEmfAndStoreFunctor2D::apply(kernel_params,
 				     QEdge_RT, QEdge_RB,
 				     QEdge_LT, QEdge_LB,
 				     Emf1,
 				     dtdx, dtdy, nbCells);
+  Kokkos::Profiling::popRegion();
   
 } // SolverMHSMuscl<2>::computeEmfAndStore
 
@@ -226,15 +232,60 @@ void SolverMHDMuscl<3>::computeEmfAndStore(real_t dt)
   real_t dtdz = dt / params.dz;
 
   // call device functor
-  ComputeEmfAndStoreFunctor3D::apply(params,
+  Kokkos::Profiling::pushRegion("emf");
+  ComputeEmfAndStoreFunctor3D::apply(kernel_params,
 				     QEdge_RT,  QEdge_RB,  QEdge_LT,  QEdge_LB,
 				     QEdge_RT2, QEdge_RB2, QEdge_LT2, QEdge_LB2,
 				     QEdge_RT3, QEdge_RB3, QEdge_LT3, QEdge_LB3,
 				     Emf,
 				     dtdx, dtdy, dtdz, nbCells);
+  Kokkos::Profiling::popRegion();
   
 } // SolverMHDMuscl<3>::computeEmfAndStore
 
+// =======================================================
+// =======================================================
+// //////////////////////////////////////////////////////////////////
+// Compute fluxes and EMF, and perform update in a single kernel
+// //////////////////////////////////////////////////////////////////
+template<>
+void SolverMHDMuscl<2>::computeFluxesEmfAndUpdate(DataArray Udata,
+						  real_t dt)
+{
+
+  // not available in 2d (see fused_update_enabled)
+  UNUSED(Udata);
+  UNUSED(dt);
+
+} // SolverMHDMuscl<2>::computeFluxesEmfAndUpdate
+
+// =======================================================
+// =======================================================
+// //////////////////////////////////////////////////////////////////
+// Compute fluxes and EMF, and perform update in a single kernel
+// //////////////////////////////////////////////////////////////////
+template<>
+void SolverMHDMuscl<3>::computeFluxesEmfAndUpdate(DataArray Udata,
+						  real_t dt)
+{
+
+  real_t dtdx = dt / params.dx;
+  real_t dtdy = dt / params.dy;
+  real_t dtdz = dt / params.dz;
+
+  // call device functor
+  Kokkos::Profiling::pushRegion("fluxes_emf_update");
+  ComputeFluxesEmfAndUpdateFunctor3D_MHD::apply(kernel_params, Udata,
+						Qm_x, Qm_y, Qm_z,
+						Qp_x, Qp_y, Qp_z,
+						QEdge_RT,  QEdge_RB,  QEdge_LT,  QEdge_LB,
+						QEdge_RT2, QEdge_RB2, QEdge_LT2, QEdge_LB2,
+						QEdge_RT3, QEdge_RB3, QEdge_LT3, QEdge_LB3,
+						dtdx, dtdy, dtdz);
+  Kokkos::Profiling::popRegion();
+
+} // SolverMHDMuscl<3>::computeFluxesEmfAndUpdate
+
 // =======================================================
 // =======================================================
 // ///////////////////////////////////////////
@@ -254,7 +305,9 @@ void SolverMHDMuscl<2>::godunov_unsplit_impl(DataArray data_in,
 
   // fill ghost cell in data_in
   timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
   make_boundaries(data_in);
+  Kokkos::Profiling::popRegion();
   timers[TIMER_BOUNDARIES]->stop();
     
   // copy data_in into data_out (not necessary)
@@ -263,33 +316,74 @@ void SolverMHDMuscl<2>::godunov_unsplit_impl(DataArray data_in,
   
   // start main computation
   timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
 
   // convert conservative variable into primitives ones for the entire domain
+  m_workspace.begin_phase(PHASE_PRIMITIVES);
   convertToPrimitives(data_in);
 
   if (params.implementationVersion == 0) {
     
     // trace computation: fill arrays qm_x, qm_y, qp_x, qp_y
+    m_workspace.begin_phase(PHASE_TRACE);
     computeTrace(data_in, dt);
 
     // Compute flux via Riemann solver and update (time integration)
+    m_workspace.begin_phase(PHASE_FLUXES);
     computeFluxesAndStore(dt);
 
     // Compute Emf
+    m_workspace.begin_phase(PHASE_EMF);
     computeEmfAndStore(dt);
     
+    Kokkos::Profiling::pushRegion("update");
+
     // actual update with fluxes
-    UpdateFunctor2D_MHD::apply(params, data_out,
+    UpdateFunctor2D_MHD::apply(kernel_params, data_out,
 			       Fluxes_x, Fluxes_y,
 			       dtdx, dtdy,
 			       nbCells);
     
     // actual update with emf
-    UpdateEmfFunctor2D::apply(params, data_out,
+    UpdateEmfFunctor2D::apply(kernel_params, data_out,
 			      Emf1, dtdx, dtdy,
 			      nbCells);
+
+    Kokkos::Profiling::popRegion();
     
-  }
+  } else if (params.implementationVersion == 1) {
+
+    // trace and fluxes along X axis, then update
+    m_workspace.begin_phase(PHASE_FLUXES);
+    ComputeTraceAndFluxes_Functor2D_MHD<XDIR>::apply(kernel_params, data_in, Q,
+						     Fluxes_x,
+						     dtdx, dtdy,
+						     nbCells);
+    UpdateDirFunctor2D_MHD<XDIR>::apply(kernel_params, data_out, Fluxes_x,
+					dtdx, nbCells);
+
+    // trace and fluxes along Y axis, then update
+    ComputeTraceAndFluxes_Functor2D_MHD<YDIR>::apply(kernel_params, data_in, Q,
+						     Fluxes_x,
+						     dtdx, dtdy,
+						     nbCells);
+    UpdateDirFunctor2D_MHD<YDIR>::apply(kernel_params, data_out, Fluxes_x,
+					dtdy, nbCells);
+
+    // trace and emf
+    m_workspace.begin_phase(PHASE_EMF);
+    ComputeTraceAndEmf_Functor2D_MHD::apply(kernel_params, data_in, Q,
+					    Emf1,
+					    dtdx, dtdy,
+					    nbCells);
+
+    // actual update with emf
+    UpdateEmfFunctor2D::apply(kernel_params, data_out,
+			      Emf1, dtdx, dtdy,
+			      nbCells);
+
+  } // end params.implementationVersion == 1
+  Kokkos::Profiling::popRegion();
   timers[TIMER_NUM_SCHEME]->stop();
 
 } // SolverMHDMuscl2D::godunov_unsplit_impl
@@ -315,7 +409,9 @@ void SolverMHDMuscl<3>::godunov_unsplit_impl(DataArray data_in,
 
   // fill ghost cell in data_in
   timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
   make_boundaries(data_in);
+  Kokkos::Profiling::popRegion();
   timers[TIMER_BOUNDARIES]->stop();
     
   // copy data_in into data_out (not necessary)
@@ -324,39 +420,114 @@ void SolverMHDMuscl<3>::godunov_unsplit_impl(DataArray data_in,
   
   // start main computation
   timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
 
   // convert conservative variable into primitives ones for the entire domain
+  m_workspace.begin_phase(PHASE_PRIMITIVES);
   convertToPrimitives(data_in);
 
   if (params.implementationVersion == 0) {
 
     // compute electric field
+    m_workspace.begin_phase(PHASE_ELEC_FIELD);
     computeElectricField(data_in);
 
     // compute magnetic slopes
     computeMagSlopes(data_in);
     
     // trace computation: fill arrays qm_x, qm_y, qm_z, qp_x, qp_y, qp_z
+    m_workspace.begin_phase(PHASE_TRACE);
     computeTrace(data_in, dt);
 
-    // Compute flux via Riemann solver and update (time integration)
-    computeFluxesAndStore(dt);
-
-    // Compute Emf
-    computeEmfAndStore(dt);
+    if (fused_update_enabled) {
+
+      // fluxes, emf and update in a single kernel
+      m_workspace.begin_phase(PHASE_FLUXES);
+      computeFluxesEmfAndUpdate(data_out, dt);
+
+    } else {
+
+      // Compute flux via Riemann solver and update (time integration)
+      m_workspace.begin_phase(PHASE_FLUXES);
+      computeFluxesAndStore(dt);
+      
+      // Compute Emf
+      m_workspace.begin_phase(PHASE_EMF);
+      computeEmfAndStore(dt);
+      
+      Kokkos::Profiling::pushRegion("update");
+
+      // actual update with fluxes
+      UpdateFunctor3D_MHD::apply(kernel_params, data_out,
+				 Fluxes_x, Fluxes_y, Fluxes_z,
+				 dtdx, dtdy, dtdz,
+				 nbCells);
+      
+      // actual update with emf
+      UpdateEmfFunctor3D::apply(kernel_params, data_out,
+				Emf, dtdx, dtdy, dtdz,
+				nbCells);
+
+      Kokkos::Profiling::popRegion();
+
+    }
     
-    // actual update with fluxes
-    UpdateFunctor3D_MHD::apply(params, data_out,
-			       Fluxes_x, Fluxes_y, Fluxes_z,
-			       dtdx, dtdy, dtdz,
-			       nbCells);
+  } else if (params.implementationVersion == 1) {
+
+    // compute electric field
+    m_workspace.begin_phase(PHASE_ELEC_FIELD);
+    computeElectricField(data_in);
+
+    // compute magnetic slopes
+    computeMagSlopes(data_in);
+
+    // trace and fluxes along X axis, then update
+    m_workspace.begin_phase(PHASE_FLUXES);
+    ComputeTraceAndFluxes_Functor3D_MHD<XDIR>::apply(kernel_params, data_in, Q,
+						     DeltaA, DeltaB, DeltaC,
+						     ElecField,
+						     Fluxes_x,
+						     dtdx, dtdy, dtdz,
+						     nbCells);
+    UpdateDirFunctor3D_MHD<XDIR>::apply(kernel_params, data_out, Fluxes_x,
+					dtdx, nbCells);
+
+    // trace and fluxes along Y axis, then update
+    ComputeTraceAndFluxes_Functor3D_MHD<YDIR>::apply(kernel_params, data_in, Q,
+						     DeltaA, DeltaB, DeltaC,
+						     ElecField,
+						     Fluxes_x,
+						     dtdx, dtdy, dtdz,
+						     nbCells);
+    UpdateDirFunctor3D_MHD<YDIR>::apply(kernel_params, data_out, Fluxes_x,
+					dtdy, nbCells);
+
+    // trace and fluxes along Z axis, then update
+    ComputeTraceAndFluxes_Functor3D_MHD<ZDIR>::apply(kernel_params, data_in, Q,
+						     DeltaA, DeltaB, DeltaC,
+						     ElecField,
+						     Fluxes_x,
+						     dtdx, dtdy, dtdz,
+						     nbCells);
+    UpdateDirFunctor3D_MHD<ZDIR>::apply(kernel_params, data_out, Fluxes_x,
+					dtdz, nbCells);
+
+    // trace and emf
+    m_workspace.begin_phase(PHASE_EMF);
+    ComputeTraceAndEmf_Functor3D_MHD::apply(kernel_params, data_in, Q,
+					    DeltaA, DeltaB, DeltaC,
+					    ElecField,
+					    Emf,
+					    dtdx, dtdy, dtdz,
+					    nbCells);
 
     // actual update with emf
-    UpdateEmfFunctor3D::apply(params, data_out,
+    UpdateEmfFunctor3D::apply(kernel_params, data_out,
 			      Emf, dtdx, dtdy, dtdz,
 			      nbCells);
-    
-  }
+
+  } // end params.implementationVersion == 1
+  Kokkos::Profiling::popRegion();
   timers[TIMER_NUM_SCHEME]->stop();
 
 } // SolverMHDMuscl<3>::godunov_unsplit_impl
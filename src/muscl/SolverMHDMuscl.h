@@ -17,7 +17,11 @@
 #include "shared/SolverBase.h"
 #include "shared/HydroParams.h"
 #include "shared/kokkos_shared.h"
+#include "shared/FirstTouch.h"
 #include "shared/problems/initRiemannConfig2d.h"
+#include "shared/DiagnosticsFunctors.h"
+#include "utils/io/IO_Products.h"
+#include "shared/Analysis.h"
 
 // the actual computational functors called in HydroRun
 #include "muscl/MHDRunFunctors2D.h"
@@ -28,7 +32,6 @@
 #include "muscl/MHDInitFunctors3D.h"
 
 // border conditions functors
-#include "shared/BoundariesFunctors.h"
 
 // for IO
 #include <utils/io/IO_ReadWrite.h>
@@ -43,6 +46,14 @@ namespace ppkMHD { namespace muscl {
 
 /**
  * Main magnehydrodynamics data structure for 2D/3D MUSCL-Hancock scheme.
+ *
+ * Two implementations are available (parameter implementationVersion):
+ * - 0 : Riemann states (qm, qp, qEdge) are computed once per cell and
+ *       stored, fluxes and emf are stored for all directions.
+ * - 1 : low memory, directionally split; Riemann states are recomputed on
+ *       the fly for each face / edge, the flux array is shared by all
+ *       directions. Magnetic field is still updated from the edge emf
+ *       (constrained transport), so that div B is preserved.
  */
 template<int dim>
 class SolverMHDMuscl : public ppkMHD::SolverBase
@@ -74,6 +85,20 @@ public:
   DataArray     U2;    /*!< hydrodynamics conservative variables arrays */
   DataArray     Q;     /*!< hydrodynamics primitive    variables array  */
 
+  /**
+   * Time step phases, used to declare the lifetime of the transient
+   * arrays allocated in m_workspace.
+   */
+  enum StepPhase {
+    PHASE_PRIMITIVES, //!< conservative to primitive variables
+    PHASE_ELEC_FIELD, //!< electric field and magnetic slopes (3D)
+    PHASE_TRACE,      //!< Riemann states (implementation 0)
+    PHASE_FLUXES,     //!< fluxes (and directional updates, implementation 1)
+    PHASE_EMF,        //!< electromotive forces
+    PHASE_UPDATE,     //!< update with stored fluxes (implementation 0)
+    PHASE_UPDATE_EMF  //!< update with stored emf
+  };
+
   DataArray Qm_x; /*!< hydrodynamics Riemann states array implementation 2 */
   DataArray Qm_y; /*!< hydrodynamics Riemann states array */
   DataArray Qm_z; /*!< hydrodynamics Riemann states array */
@@ -156,11 +181,17 @@ public:
   void computeFluxesAndStore(real_t dt);
   void computeEmfAndStore(real_t dt);
 
+  //! 3d only: fused face fluxes / emf / update (no Fluxes / Emf arrays)
+  void computeFluxesEmfAndUpdate(DataArray Udata, real_t dt);
+
   // output
   void save_solution_impl();
   
   int isize, jsize, ksize;
   int nbCells;
+
+  //! use fused flux / emf / update kernel (3d only)
+  bool fused_update_enabled;
   
 }; // class SolverMHDMuscl
 
@@ -190,13 +221,19 @@ SolverMHDMuscl<dim>::SolverMHDMuscl(HydroParams& params,
   isize(params.isize),
   jsize(params.jsize),
   ksize(params.ksize),
-  nbCells(params.isize*params.jsize)
+  nbCells(params.isize*params.jsize),
+  fused_update_enabled(false)
 {
 
   solver_type = SOLVER_MUSCL_HANCOCK;
 
   if (dim==3)
     nbCells = params.isize*params.jsize*params.ksize;
+
+  // fused flux / emf / update kernel (3d only), see
+  // ComputeFluxesEmfAndUpdateFunctor3D_MHD
+  if (dim==3 && params.implementationVersion == 0)
+    fused_update_enabled = configMap.getBool("OTHER", "mhd_fused_update", false);
   
   m_nCells = nbCells;
   m_nDofsPerCell = 1;
@@ -205,99 +242,156 @@ SolverMHDMuscl<dim>::SolverMHDMuscl(HydroParams& params,
  
   long long int total_mem_size = 0;
 
+  // allocation and first touch time, reported below
+  Timer alloc_timer;
+  alloc_timer.start();
+
   /*
    * memory allocation (use sizes with ghosts included).
    *
+   * Arrays are allocated without initialization, then first touched in
+   * parallel (see FirstTouch.h).
+   *
    * Note that Uhost is not just a view to U, Uhost will be used
-   * to save data from multiple other device array.
-   * That's why we didn't use create_mirror_view to initialize Uhost.
+   * to save data from multiple other device array. It is only
+   * allocated on first output or restart (see allocate_host_mirror).
+   *
+   * Transient arrays are handed out by m_workspace, with their lifetime
+   * (see StepPhase): primitive variables are needed until the last trace
+   * computation, edge states until the emf computation (or the fused
+   * update).
    */
+  const int q_last     = params.implementationVersion == 0 ? PHASE_TRACE : PHASE_EMF;
+  const int qedge_last = fused_update_enabled ? PHASE_FLUXES : PHASE_EMF;
+
   if (dim==2) {
 
-    U     = DataArray("U", isize, jsize, nbvar);
-    Uhost = Kokkos::create_mirror(U);
-    U2    = DataArray("U2",isize, jsize, nbvar);
-    Q     = DataArray("Q", isize, jsize, nbvar);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize, jsize, nbvar);
+    U2    = allocate_first_touch<DataArray>("U2", nbCells, isize, jsize, nbvar);
+    m_workspace.declare("Q", Q, PHASE_PRIMITIVES, q_last, isize, jsize, nbvar);
 
-    total_mem_size += isize*jsize*nbvar * sizeof(real_t) * 3;// 1+1+1 for U+U2+Q
+    total_mem_size += isize*jsize*nbvar * sizeof(real_storage_t) * 3;// 1+1+1 for U+U2+Q
     
     if (params.implementationVersion == 0) {
       
-      Qm_x = DataArray("Qm_x", isize,jsize, nbvar);
-      Qm_y = DataArray("Qm_y", isize,jsize, nbvar);
-      Qp_x = DataArray("Qp_x", isize,jsize, nbvar);
-      Qp_y = DataArray("Qp_y", isize,jsize, nbvar);
+      m_workspace.declare("Qm_x", Qm_x, PHASE_TRACE, PHASE_FLUXES, isize,jsize, nbvar);
+      m_workspace.declare("Qm_y", Qm_y, PHASE_TRACE, PHASE_FLUXES, isize,jsize, nbvar);
+      m_workspace.declare("Qp_x", Qp_x, PHASE_TRACE, PHASE_FLUXES, isize,jsize, nbvar);
+      m_workspace.declare("Qp_y", Qp_y, PHASE_TRACE, PHASE_FLUXES, isize,jsize, nbvar);
       
-      QEdge_RT = DataArray("QEdge_RT", isize,jsize, nbvar);
-      QEdge_RB = DataArray("QEdge_RB", isize,jsize, nbvar);
-      QEdge_LT = DataArray("QEdge_LT", isize,jsize, nbvar);
-      QEdge_LB = DataArray("QEdge_LB", isize,jsize, nbvar);
+      m_workspace.declare("QEdge_RT", QEdge_RT, PHASE_TRACE, qedge_last, isize,jsize, nbvar);
+      m_workspace.declare("QEdge_RB", QEdge_RB, PHASE_TRACE, qedge_last, isize,jsize, nbvar);
+      m_workspace.declare("QEdge_LT", QEdge_LT, PHASE_TRACE, qedge_last, isize,jsize, nbvar);
+      m_workspace.declare("QEdge_LB", QEdge_LB, PHASE_TRACE, qedge_last, isize,jsize, nbvar);
       
-      Fluxes_x = DataArray("Fluxes_x", isize,jsize, nbvar);
-      Fluxes_y = DataArray("Fluxes_y", isize,jsize, nbvar);
+      m_workspace.declare("Fluxes_x", Fluxes_x, PHASE_FLUXES, PHASE_UPDATE, isize,jsize, nbvar);
+      m_workspace.declare("Fluxes_y", Fluxes_y, PHASE_FLUXES, PHASE_UPDATE, isize,jsize, nbvar);
       
-      Emf1 = DataArrayScalar("Emf", isize,jsize);
+      m_workspace.declare("Emf", Emf1, PHASE_EMF, PHASE_UPDATE_EMF, isize,jsize);
       
       total_mem_size +=
-	isize*jsize* nbvar * sizeof(real_t) * 10 +
+	isize*jsize* nbvar * sizeof(real_storage_t) * 10 +
 	isize*jsize*     1 * sizeof(real_t);
       
+    } else if (params.implementationVersion == 1) {
+
+      // Riemann states are recomputed on the fly, only one flux array
+      // shared by all directions
+      m_workspace.declare("Fluxes", Fluxes_x, PHASE_FLUXES, PHASE_FLUXES, isize,jsize, nbvar);
+
+      m_workspace.declare("Emf", Emf1, PHASE_EMF, PHASE_UPDATE_EMF, isize,jsize);
+      
+      total_mem_size +=
+	isize*jsize* nbvar * sizeof(real_storage_t) * 1 +
+	isize*jsize*     1 * sizeof(real_t);
+
     }
 
   } else {
 
-    U     = DataArray("U", isize,jsize,ksize, nbvar);
-    Uhost = Kokkos::create_mirror(U);
-    U2    = DataArray("U2",isize,jsize,ksize, nbvar);
-    Q     = DataArray("Q", isize,jsize,ksize, nbvar);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize,jsize,ksize, nbvar);
+    U2    = allocate_first_touch<DataArray>("U2", nbCells, isize,jsize,ksize, nbvar);
+    m_workspace.declare("Q", Q, PHASE_PRIMITIVES, q_last, isize,jsize,ksize, nbvar);
     
-    total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_t)*3;// 1+1+1=3 for U+U2+Q
+    total_mem_size += isize*jsize*ksize*nbvar*sizeof(real_storage_t)*3;// 1+1+1=3 for U+U2+Q
 
     if (params.implementationVersion == 0) {
       
-      Qm_x = DataArray("Qm_x", isize,jsize,ksize, nbvar);
-      Qm_y = DataArray("Qm_y", isize,jsize,ksize, nbvar);
-      Qm_z = DataArray("Qm_z", isize,jsize,ksize, nbvar);
-      
-      Qp_x = DataArray("Qp_x", isize,jsize,ksize, nbvar);
-      Qp_y = DataArray("Qp_y", isize,jsize,ksize, nbvar);
-      Qp_z = DataArray("Qp_z", isize,jsize,ksize, nbvar);
-      
-      QEdge_RT  = DataArray("QEdge_RT", isize,jsize,ksize, nbvar);
-      QEdge_RB  = DataArray("QEdge_RB", isize,jsize,ksize, nbvar);
-      QEdge_LT  = DataArray("QEdge_LT", isize,jsize,ksize, nbvar);
-      QEdge_LB  = DataArray("QEdge_LB", isize,jsize,ksize, nbvar);
-      
-      QEdge_RT2 = DataArray("QEdge_RT2", isize,jsize,ksize, nbvar);
-      QEdge_RB2 = DataArray("QEdge_RB2", isize,jsize,ksize, nbvar);
-      QEdge_LT2 = DataArray("QEdge_LT2", isize,jsize,ksize, nbvar);
-      QEdge_LB2 = DataArray("QEdge_LB2", isize,jsize,ksize, nbvar);
-      
-      QEdge_RT3 = DataArray("QEdge_RT3", isize,jsize,ksize, nbvar);
-      QEdge_RB3 = DataArray("QEdge_RB3", isize,jsize,ksize, nbvar);
-      QEdge_LT3 = DataArray("QEdge_LT3", isize,jsize,ksize, nbvar);
-      QEdge_LB3 = DataArray("QEdge_LB3", isize,jsize,ksize, nbvar);
+      m_workspace.declare("Qm_x", Qm_x, PHASE_TRACE, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Qm_y", Qm_y, PHASE_TRACE, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Qm_z", Qm_z, PHASE_TRACE, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      
+      m_workspace.declare("Qp_x", Qp_x, PHASE_TRACE, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Qp_y", Qp_y, PHASE_TRACE, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      m_workspace.declare("Qp_z", Qp_z, PHASE_TRACE, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+      
+      m_workspace.declare("QEdge_RT",  QEdge_RT, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_RB",  QEdge_RB, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_LT",  QEdge_LT, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_LB",  QEdge_LB, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      
+      m_workspace.declare("QEdge_RT2", QEdge_RT2, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_RB2", QEdge_RB2, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_LT2", QEdge_LT2, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_LB2", QEdge_LB2, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      
+      m_workspace.declare("QEdge_RT3", QEdge_RT3, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_RB3", QEdge_RB3, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_LT3", QEdge_LT3, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      m_workspace.declare("QEdge_LB3", QEdge_LB3, PHASE_TRACE, qedge_last, isize,jsize,ksize, nbvar);
+      
+      // fluxes and emf are not stored when using the fused kernel
+      if (!fused_update_enabled) {
+
+	m_workspace.declare("Fluxes_x",  Fluxes_x, PHASE_FLUXES, PHASE_UPDATE, isize,jsize,ksize, nbvar);
+	m_workspace.declare("Fluxes_y",  Fluxes_y, PHASE_FLUXES, PHASE_UPDATE, isize,jsize,ksize, nbvar);
+	m_workspace.declare("Fluxes_z",  Fluxes_z, PHASE_FLUXES, PHASE_UPDATE, isize,jsize,ksize, nbvar);
+	
+	m_workspace.declare("Emf",       Emf, PHASE_EMF, PHASE_UPDATE_EMF, isize,jsize,ksize);
+
+	total_mem_size +=
+	  isize*jsize*ksize*nbvar*sizeof(real_storage_t)*3 +
+	  isize*jsize*ksize*    3*sizeof(real_t)*1;
+	
+      }
       
-      Fluxes_x  = DataArray("Fluxes_x", isize,jsize,ksize, nbvar);
-      Fluxes_y  = DataArray("Fluxes_y", isize,jsize,ksize, nbvar);
-      Fluxes_z  = DataArray("Fluxes_z", isize,jsize,ksize, nbvar);
+      m_workspace.declare("ElecField", ElecField, PHASE_ELEC_FIELD, PHASE_TRACE, isize,jsize,ksize);
       
-      Emf       = DataArrayVector3("Emf", isize,jsize,ksize);
+      m_workspace.declare("DeltaA",    DeltaA, PHASE_ELEC_FIELD, PHASE_TRACE, isize,jsize,ksize);
+      m_workspace.declare("DeltaB",    DeltaB, PHASE_ELEC_FIELD, PHASE_TRACE, isize,jsize,ksize);
+      m_workspace.declare("DeltaC",    DeltaC, PHASE_ELEC_FIELD, PHASE_TRACE, isize,jsize,ksize);
       
-      ElecField = DataArrayVector3("ElecField", isize,jsize,ksize); 
+      total_mem_size +=
+	isize*jsize*ksize*nbvar*sizeof(real_storage_t)*18 +
+	isize*jsize*ksize*    3*sizeof(real_t)*4;
       
-      DeltaA    = DataArrayVector3("DeltaA", isize,jsize,ksize);
-      DeltaB    = DataArrayVector3("DeltaB", isize,jsize,ksize);
-      DeltaC    = DataArrayVector3("DeltaC", isize,jsize,ksize);
+    } else if (params.implementationVersion == 1) {
+
+      // Riemann states are recomputed on the fly, only one flux array
+      // shared by all directions
+      m_workspace.declare("Fluxes",  Fluxes_x, PHASE_FLUXES, PHASE_FLUXES, isize,jsize,ksize, nbvar);
+
+      m_workspace.declare("Emf",       Emf, PHASE_EMF, PHASE_UPDATE_EMF, isize,jsize,ksize);
+
+      m_workspace.declare("ElecField", ElecField, PHASE_ELEC_FIELD, PHASE_EMF, isize,jsize,ksize);
       
+      m_workspace.declare("DeltaA",    DeltaA, PHASE_ELEC_FIELD, PHASE_EMF, isize,jsize,ksize);
+      m_workspace.declare("DeltaB",    DeltaB, PHASE_ELEC_FIELD, PHASE_EMF, isize,jsize,ksize);
+      m_workspace.declare("DeltaC",    DeltaC, PHASE_ELEC_FIELD, PHASE_EMF, isize,jsize,ksize);
+
       total_mem_size +=
-	isize*jsize*ksize*nbvar*sizeof(real_t)*21 +
+	isize*jsize*ksize*nbvar*sizeof(real_storage_t)*1 +
 	isize*jsize*ksize*    3*sizeof(real_t)*5;
-      
+
     }
 
   } // dim == 2 / 3
+
+  // transient arrays (primitive variables, Riemann states, fluxes, emf)
+  m_workspace.allocate(nbCells);
   
+  alloc_timer.stop();
+
   // perform init condition
   init(U);
   
@@ -325,6 +419,9 @@ SolverMHDMuscl<dim>::SolverMHDMuscl(HydroParams& params,
     params.print();
     std::cout << "##########################" << "\n";
     std::cout << "Memory requested : " << (total_mem_size / 1e6) << " MBytes\n"; 
+    std::cout << "Allocation + first touch : " << alloc_timer.elapsed() << " s ("
+              << Device().concurrency() << " " << Device::name() << " threads)\n";
+    m_workspace.print_info();
     std::cout << "##########################" << "\n";
   }
   
@@ -376,7 +473,7 @@ void SolverMHDMuscl<dim>::init_blast(DataArray Udata)
 			      InitBlastFunctor3D_MHD>::type;
 
   // perform init
-  InitBlastFunctor::apply(params, blastParams, Udata, nbCells);
+  InitBlastFunctor::apply(kernel_params, blastParams, Udata, nbCells);
 
 } // SolverMHDMuscl::init_blast
 
@@ -398,7 +495,7 @@ void SolverMHDMuscl<dim>::init_orszag_tang(DataArray Udata)
 			      InitOrszagTangFunctor2D,
 			      InitOrszagTangFunctor3D>::type;
   
-  InitOrszagTangFunctor::apply(params, otParams, Udata, nbCells);
+  InitOrszagTangFunctor::apply(kernel_params, otParams, Udata, nbCells);
   
 } // init_orszag_tang
 
@@ -427,7 +524,7 @@ void SolverMHDMuscl<dim>::init_kelvin_helmholtz(DataArray Udata)
 			      InitKelvinHelmholtzFunctor3D_MHD>::type;
 
   // perform init
-  InitKelvinHelmholtzFunctor::apply(params, khParams, Udata, nbCells);
+  InitKelvinHelmholtzFunctor::apply(kernel_params, khParams, Udata, nbCells);
   
 } // init_kelvin_helmholtz
 
@@ -450,7 +547,7 @@ void SolverMHDMuscl<dim>::init_implode(DataArray Udata)
 			      InitImplodeFunctor3D_MHD>::type;
 
   // perform init
-  InitImplodeFunctor::apply(params, implodeParams, Udata, nbCells);
+  InitImplodeFunctor::apply(kernel_params, implodeParams, Udata, nbCells);
 
 } // SolverMHDMuscl::init_implode
 
@@ -473,7 +570,7 @@ void SolverMHDMuscl<dim>::init_rotor(DataArray Udata)
 			      InitRotorFunctor3D_MHD>::type;
 
   // perform init
-  InitRotorFunctor::apply(params, rotorParams, Udata, nbCells);
+  InitRotorFunctor::apply(kernel_params, rotorParams, Udata, nbCells);
 
 } // SolverMHDMuscl::init_rotor
 
@@ -496,7 +593,7 @@ void SolverMHDMuscl<dim>::init_field_loop(DataArray Udata)
 			      InitFieldLoopFunctor3D_MHD>::type;
 
   // perform init
-  InitFieldLoopFunctor::apply(params, flParams, Udata, nbCells);
+  InitFieldLoopFunctor::apply(kernel_params, flParams, Udata, nbCells);
 
 } // SolverMHDMuscl::init_field_loop
 
@@ -518,7 +615,7 @@ void SolverMHDMuscl<dim>::init_wave(DataArray Udata)
 			      InitWaveFunctor3D_MHD>::type;
 
   // perform init
-  InitWaveFunctor::apply(params, wParams, Udata, nbCells);
+  InitWaveFunctor::apply(kernel_params, wParams, Udata, nbCells);
 
 } // SolverMHDMuscl::init_wave
 
@@ -538,6 +635,7 @@ void SolverMHDMuscl<dim>::init_restart(DataArray Udata)
 
   // whether or not we are upscaling input data is handled inside "load_data"
   // m_times_saved are read from file
+  allocate_host_mirror(Udata, Uhost);
   reader->load_data(Udata, Uhost, m_times_saved, m_t);
 
   // increment to avoid overriding last output (?)
@@ -643,8 +741,16 @@ double SolverMHDMuscl<dim>::compute_dt_local()
 			      ComputeDtFunctor2D_MHD,
 			      ComputeDtFunctor3D_MHD>::type;
 
-  // call device functor
-  ComputeDtFunctor::apply(params, Udata, nbCells, invDt);
+  // call device functor (fused with diagnostics when due)
+  if (m_diagnostics->is_due(m_iteration))
+    ComputeDiagnosticsFunctor<dim,ComputeDtFunctor>::apply(kernel_params, Udata,
+							    ComputeDtFunctor(kernel_params, Udata),
+							    params.mhdEnabled,
+							    nbCells,
+							    *m_diagnostics,
+							    invDt);
+  else
+    ComputeDtFunctor::apply(kernel_params, Udata, nbCells, invDt);
     
   dt = params.settings.cfl/invDt;
 
@@ -683,11 +789,26 @@ void SolverMHDMuscl<dim>::next_iteration_impl()
       save_solution();
       
     } // end output
+
+    // reduced-volume outputs (slices, subvolumes)
+    if ( m_io_products->enabled() ) {
+      timers[TIMER_IO]->start();
+      Kokkos::Profiling::pushRegion("io");
+      m_io_products->save(m_iteration % 2 == 0 ? U : U2, m_iteration, m_t);
+      Kokkos::Profiling::popRegion();
+      timers[TIMER_IO]->stop();
+    }
   } // end enable output
+
+  // in-situ analysis plugins
+  if ( m_analysis->enabled() )
+    m_analysis->run(m_iteration % 2 == 0 ? U : U2, m_iteration, m_t);
   
   // compute new dt
   timers[TIMER_DT]->start();
+  Kokkos::Profiling::pushRegion("compute_dt");
   compute_dt();
+  Kokkos::Profiling::popRegion();
   timers[TIMER_DT]->stop();
   
   // perform one step integration
@@ -756,7 +877,7 @@ void SolverMHDMuscl<dim>::convertToPrimitives(DataArray Udata)
 			      ConvertToPrimitivesFunctor3D_MHD>::type;
 
   // call device functor
-  ConvertToPrimitivesFunctor::apply(params, Udata, Q, nbCells);
+  ConvertToPrimitivesFunctor::apply(kernel_params, Udata, Q, nbCells);
   
 } // SolverMHDMuscl::convertToPrimitives
 
@@ -799,11 +920,14 @@ void SolverMHDMuscl<dim>::save_solution_impl()
 {
 
   timers[TIMER_IO]->start();
+  Kokkos::Profiling::pushRegion("io");
+  allocate_host_mirror(U, Uhost);
   if (m_iteration % 2 == 0)
     save_data(U,  Uhost, m_times_saved, m_t);
   else
     save_data(U2, Uhost, m_times_saved, m_t);
   
+  Kokkos::Profiling::popRegion();
   timers[TIMER_IO]->stop();
     
 } // SolverMHDMuscl::save_solution_impl()
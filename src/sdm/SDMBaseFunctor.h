@@ -4,7 +4,7 @@
 #include <type_traits>
 
 #include "shared/kokkos_shared.h"
-#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "shared/HydroState.h"
 
 #include "sdm/SDM_Geometry.h"
@@ -12,6 +12,12 @@
 namespace sdm
 {
 
+//! per cell flag (0 or 1), used to mark troubled cells
+using CellFlags = Kokkos::View<int*, Device>;
+
+//! compacted list of cell (flat) indexes
+using CellList  = Kokkos::View<int*, Device>;
+
 /**
  * SDM base functor, this is not a functor, but a base class to derive an actual
  * Kokkos functor.
@@ -30,7 +36,7 @@ public:
   using solution_values_t = Kokkos::Array<real_t, N>;
   using flux_values_t     = Kokkos::Array<real_t, N+1>;
 
-  SDMBaseFunctor(HydroParams params,
+  SDMBaseFunctor(KernelParams params,
                  SDM_Geometry<dim,N> sdm_geom) :
     params(params),
     sdm_geom(sdm_geom) {};
@@ -78,7 +84,7 @@ public:
     W_Z  = static_cast<int>(std::conditional<dim==2,gradientV_IDS_2d,gradientV_IDS_3d>::type::W_Z)
   };
 
-  HydroParams params;
+  KernelParams params;
   SDM_Geometry<dim,N> sdm_geom;
 
   /**
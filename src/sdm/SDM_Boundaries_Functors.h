@@ -1,8 +1,9 @@
 #ifndef SDM_BOUNDARIES_FUNCTORS_H_
 #define SDM_BOUNDARIES_FUNCTORS_H_
 
-#include "shared/HydroParams.h"    // for HydroParams
+#include "shared/KernelParams.h"    // for KernelParams
 #include "shared/kokkos_shared.h"  // for Data arrays
+#include "shared/BoundaryEngine.h" // for BoundaryEngine, NoInflow
 
 namespace sdm
 {
@@ -33,20 +34,20 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  MakeBoundariesFunctor_SDM(HydroParams           params,
+  MakeBoundariesFunctor_SDM(KernelParams          params,
                             SDM_Geometry<dim,N>   sdm_geom,
                             DataArray             Udata) :
     SDMBaseFunctor<dim,N>(params,sdm_geom),
     Udata(Udata) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     int                 nbIter)
   {
     MakeBoundariesFunctor_SDM<dim,N,faceId> functor(params, sdm_geom, Udata);
-    Kokkos::parallel_for(nbIter, functor);
+    Kokkos::parallel_for("MakeBoundariesFunctor_SDM", nbIter, functor);
   }
 
   // ================================================
@@ -731,6 +732,224 @@ public:
 
 }; // MakeBoundariesFunctor_SDM
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Fill all the ghost cells of an SDM data array listed in a
+ * ppkMHD::BoundaryEngine (see ppkMHD::FillGhostCellsFunctor for the
+ * cell-centered version).
+ *
+ * Same walk through ghost directions, done Dof by Dof: reflecting and
+ * GHOST_NEUMANN_MIRROR directions also mirror the Dof index along that
+ * direction (idx <-> N-1-idx), and the inflow policy is given the position
+ * of the solution point.
+ *
+ * \tparam Inflow inflow policy (ppkMHD::NoInflow, WedgeInflow, JetInflow)
+ */
+template <int dim, int N, class Inflow = ppkMHD::NoInflow>
+class FillGhostCellsFunctor_SDM  : public SDMBaseFunctor<dim,N>
+{
+
+public:
+  using typename SDMBaseFunctor<dim,N>::DataArray;
+
+  using BoundaryEngine = ppkMHD::BoundaryEngine;
+  using GhostFaces     = ppkMHD::GhostFaces;
+
+  static constexpr auto dofMap = DofMap<dim,N>;
+
+  FillGhostCellsFunctor_SDM(KernelParams             params,
+                            SDM_Geometry<dim,N>      sdm_geom,
+                            BoundaryEngine::CellList cells,
+                            GhostFaces               faces,
+                            DataArray                Udata,
+                            Inflow                   inflow) :
+    SDMBaseFunctor<dim,N>(params,sdm_geom),
+    cells(cells), faces(faces), Udata(Udata), inflow(inflow) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams          params,
+                    SDM_Geometry<dim,N>   sdm_geom,
+                    const BoundaryEngine& engine,
+                    BoundaryEngine::Range range,
+                    DataArray             Udata,
+                    Inflow                inflow = Inflow())
+  {
+    if (range.first == range.second)
+      return;
+
+    FillGhostCellsFunctor_SDM<dim,N,Inflow> functor(params, sdm_geom,
+                                                    engine.cells, engine.faces,
+                                                    Udata, inflow);
+    Kokkos::parallel_for("FillGhostCellsFunctor_SDM",
+                         Kokkos::RangePolicy<>(range.first, range.second),
+                         functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ghostWidth = this->params.ghostWidth;
+    const int nbvar = this->params.nbvar;
+
+    const int n[3] = {this->params.nx, this->params.ny, this->params.nz};
+
+    const int entry = cells(index);
+    const int face  = entry & 7;
+    int cell = entry >> 3;
+
+    // ghost cell coordinates
+    int g[3];
+    g[IX] = cell % isize; cell /= isize;
+    g[IY] = cell % jsize;
+    g[IZ] = cell / jsize;
+
+    const int Nz = dim==3 ? N : 1;
+
+    for (int idz=0; idz<Nz; ++idz)
+    {
+      for (int idy=0; idy<N; ++idy)
+      {
+        for (int idx=0; idx<N; ++idx)
+        {
+
+          // source cell and Dof
+          int c[3] = {g[IX], g[IY], g[IZ]};
+          int d[3] = {idx, idy, idz};
+
+          int reflected = 0;
+          bool is_imposed = false;
+          real_t q[5] = {0, 0, 0, 0, 0};
+
+          for (int dir = face/2; dir >= 0; --dir)
+          {
+            int f;
+            if (c[dir] < ghostWidth)
+              f = 2*dir;
+            else if (c[dir] >= n[dir]+ghostWidth)
+              f = 2*dir+1;
+            else
+              continue;
+
+            if (faces.inflow[f])
+            {
+              real_t x[3];
+              position(c, d, x);
+              if (inflow.imposed(f, x, q))
+              {
+                is_imposed = true;
+                break;
+              }
+            }
+
+            const int type = faces.type[f];
+
+            if (type == ppkMHD::GHOST_EXCHANGED)
+              break;
+
+            if (type == ppkMHD::GHOST_DIRICHLET)
+              reflected |= 1 << dir;
+
+            // mirror DoFs d <-> N-1-d
+            if (type == ppkMHD::GHOST_DIRICHLET or
+                type == ppkMHD::GHOST_NEUMANN_MIRROR)
+              d[dir] = N-1-d[dir];
+
+            c[dir] = ppkMHD::ghost_source(type, f==2*dir, c[dir], n[dir], ghostWidth);
+          }
+
+          for (int iVar=0; iVar<nbvar; iVar++)
+          {
+            real_t sign = 1.0;
+            for (int dir=0; dir<dim; ++dir)
+              if ( ((reflected >> dir) & 1) and iVar==IU+dir )
+                sign = -sign;
+
+            const real_t value = is_imposed ?
+              q[iVar] :
+              get(c, dofMap(d[IX],d[IY],d[IZ],iVar));
+
+            set(g, dofMap(idx,idy,idz,iVar), value*sign);
+          }
+
+        } // end for idx
+      } // end for idy
+    } // end for idz
+
+  } // operator ()
+
+  //! solution point position (global, i.e. with MPI offset)
+  KOKKOS_INLINE_FUNCTION
+  void position(const int c[3], const int d[3], real_t x[3]) const
+  {
+    const int ghostWidth = this->params.ghostWidth;
+
+#ifdef USE_MPI
+    const int i_mpi = this->params.myMpiPos[IX];
+    const int j_mpi = this->params.myMpiPos[IY];
+    const int k_mpi = dim==3 ? this->params.myMpiPos[IZ] : 0;
+#else
+    const int i_mpi = 0;
+    const int j_mpi = 0;
+    const int k_mpi = 0;
+#endif
+
+    const real_t dx = this->params.dx;
+    const real_t dy = this->params.dy;
+    const real_t dz = this->params.dz;
+
+    x[IX] = this->params.xmin + (c[IX]+this->params.nx*i_mpi-ghostWidth)*dx;
+    x[IY] = this->params.ymin + (c[IY]+this->params.ny*j_mpi-ghostWidth)*dy;
+    x[IZ] = this->params.zmin + (c[IZ]+this->params.nz*k_mpi-ghostWidth)*dz;
+
+    x[IX] += this->sdm_geom.solution_pts_1d(d[IX]) * dx;
+    x[IY] += this->sdm_geom.solution_pts_1d(d[IY]) * dy;
+    if (dim==3)
+      x[IZ] += this->sdm_geom.solution_pts_1d(d[IZ]) * dz;
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(const int c[3], int dof,
+             typename std::enable_if<dim_==2, int>::type = 0) const
+  {
+    return Udata(c[IX], c[IY], dof);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(const int c[3], int dof,
+             typename std::enable_if<dim_==3, int>::type = 0) const
+  {
+    return Udata(c[IX], c[IY], c[IZ], dof);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void set(const int c[3], int dof, real_t value,
+           typename std::enable_if<dim_==2, int>::type = 0) const
+  {
+    Udata(c[IX], c[IY], dof) = value;
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void set(const int c[3], int dof, real_t value,
+           typename std::enable_if<dim_==3, int>::type = 0) const
+  {
+    Udata(c[IX], c[IY], c[IZ], dof) = value;
+  }
+
+  BoundaryEngine::CellList cells;
+  GhostFaces               faces;
+  DataArray                Udata;
+  Inflow                   inflow;
+
+}; // FillGhostCellsFunctor_SDM
+
 } // namespace sdm
 
 #endif // SDM_BOUNDARIES_FUNCTORS_H_
@@ -1,7 +1,7 @@
 #ifndef SDM_BOUNDARIES_FUNCTORS_JET_H_
 #define SDM_BOUNDARIES_FUNCTORS_JET_H_
 
-#include "shared/HydroParams.h"    // for HydroParams
+#include "shared/KernelParams.h"    // for KernelParams
 #include "shared/kokkos_shared.h"  // for Data arrays
 #include "shared/problems/JetParams.h"    // for Jet border condition
 
@@ -32,7 +32,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  MakeBoundariesFunctor_SDM_Jet(HydroParams         params,
+  MakeBoundariesFunctor_SDM_Jet(KernelParams        params,
                                 SDM_Geometry<dim,N> sdm_geom,
                                 JetParams           jparams,
                                 DataArray           Udata) :
@@ -41,14 +41,14 @@ public:
     Udata(Udata) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     JetParams           jparams,
                     DataArray           Udata,
                     int                 nbIter)
   {
     MakeBoundariesFunctor_SDM_Jet<dim,N,faceId> functor(params, sdm_geom, jparams, Udata);
-    Kokkos::parallel_for(nbIter, functor);
+    Kokkos::parallel_for("MakeBoundariesFunctor_SDM_Jet", nbIter, functor);
   }
 
   // ================================================
@@ -587,6 +587,69 @@ public:
 
 }; // MakeBoundariesFunctor_SDM_Jet
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Jet inflow policy for FillGhostCellsFunctor_SDM: on face xmin, jet state
+ * inside the jet section (a band in 2D, a disk in 3D), bulk state
+ * elsewhere. Other faces are outflow (face fill type).
+ */
+template<int dim>
+struct JetInflow
+{
+
+  JetInflow(JetParams jparams) : jparams(jparams) {};
+
+  KOKKOS_INLINE_FUNCTION
+  bool imposed(int face, const real_t x[3], real_t q[5]) const
+  {
+    if (face != FACE_XMIN)
+      return false;
+
+    const real_t pos_jet   = jparams.pos_jet;
+    const real_t width_jet = jparams.width_jet;
+
+    bool in_jet;
+    if (dim==2)
+    {
+      in_jet =
+        x[IY] > pos_jet - 0.5*width_jet and
+        x[IY] < pos_jet + 0.5*width_jet;
+    }
+    else
+    {
+      const real_t radius2 =
+        (x[IY]-pos_jet)*(x[IY]-pos_jet) +
+        (x[IZ]-pos_jet)*(x[IZ]-pos_jet) ;
+
+      in_jet = radius2 < 0.25*width_jet*width_jet;
+    }
+
+    if (in_jet)
+    {
+      q[ID] = jparams.rho1;
+      q[IE] = jparams.e_tot1;
+      q[IU] = jparams.rho_u1;
+      q[IV] = jparams.rho_v1;
+      q[IW] = jparams.rho_w1;
+    }
+    else
+    {
+      q[ID] = jparams.rho2;
+      q[IE] = jparams.e_tot2;
+      q[IU] = jparams.rho_u2;
+      q[IV] = jparams.rho_v2;
+      q[IW] = jparams.rho_w2;
+    }
+
+    return true;
+  }
+
+  JetParams jparams;
+
+}; // struct JetInflow
+
 } // namespace sdm
 
 #endif // SDM_BOUNDARIES_FUNCTORS_JET_H_
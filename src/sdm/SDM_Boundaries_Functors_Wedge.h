@@ -1,7 +1,7 @@
 #ifndef SDM_BOUNDARIES_FUNCTORS_WEDGE_H_
 #define SDM_BOUNDARIES_FUNCTORS_WEDGE_H_
 
-#include "shared/HydroParams.h"    // for HydroParams
+#include "shared/KernelParams.h"    // for KernelParams
 #include "shared/kokkos_shared.h"  // for Data arrays
 #include "shared/problems/WedgeParams.h"    // for Wedge border condition
 
@@ -29,7 +29,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  MakeBoundariesFunctor_SDM_Wedge(HydroParams           params,
+  MakeBoundariesFunctor_SDM_Wedge(KernelParams          params,
                                   SDM_Geometry<dim,N>   sdm_geom,
                                   WedgeParams           wparams,
                                   DataArray             Udata) :
@@ -38,14 +38,14 @@ public:
     Udata(Udata) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     WedgeParams         wparams,
                     DataArray           Udata,
                     int                 nbIter)
   {
     MakeBoundariesFunctor_SDM_Wedge<dim,N,faceId> functor(params, sdm_geom, wparams, Udata);
-    Kokkos::parallel_for(nbIter, functor);
+    Kokkos::parallel_for("MakeBoundariesFunctor_SDM_Wedge", nbIter, functor);
   }
 
   // ================================================
@@ -47,7 +47,7 @@ public:
   /**
    * \param[in] varId identify which variable to reduce (ID, IE, IU, ...)
    */
-  Compute_Error_Functor_2d(HydroParams         params,
+  Compute_Error_Functor_2d(KernelParams        params,
                            SDM_Geometry<2,N>   sdm_geom,
                            DataArray           Udata1,
                            DataArray           Udata2,
@@ -59,7 +59,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static double apply(HydroParams       params,
+  static double apply(KernelParams      params,
                       SDM_Geometry<2,N> sdm_geom,
                       DataArray         Udata1,
                       DataArray         Udata2,
@@ -70,12 +70,12 @@ public:
     real_t error = 0;
     Compute_Error_Functor_2d<N,norm> functor(params, sdm_geom,
         Udata1, Udata2, varId);
-    Kokkos::parallel_reduce(nbCells, functor, error);
+    Kokkos::parallel_reduce("Compute_Error_Functor_2d", nbCells, functor, error);
     return error;
   }
 
   //! dummy trick
-  static double apply(HydroParams       params,
+  static double apply(KernelParams      params,
                       SDM_Geometry<3,N> sdm_geom,
                       DataArray3d       Udata1,
                       DataArray3d       Udata2,
@@ -185,7 +185,7 @@ public:
   /**
    * \param[in] varId identify which variable to reduce (ID, IE, IU, ...)
    */
-  Compute_Error_Functor_3d(HydroParams         params,
+  Compute_Error_Functor_3d(KernelParams        params,
                            SDM_Geometry<3,N>   sdm_geom,
                            DataArray           Udata1,
                            DataArray           Udata2,
@@ -197,7 +197,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static double apply(HydroParams       params,
+  static double apply(KernelParams      params,
                       SDM_Geometry<3,N> sdm_geom,
                       DataArray         Udata1,
                       DataArray         Udata2,
@@ -208,12 +208,12 @@ public:
     real_t error = 0;
     Compute_Error_Functor_3d<N,norm> functor(params, sdm_geom,
         Udata1, Udata2, varId);
-    Kokkos::parallel_reduce(nbCells, functor, error);
+    Kokkos::parallel_reduce("Compute_Error_Functor_3d", nbCells, functor, error);
     return error;
   }
 
   //! dummy trick
-  static double apply(HydroParams       params,
+  static double apply(KernelParams      params,
                       SDM_Geometry<2,N> sdm_geom,
                       DataArray2d       Udata1,
                       DataArray2d       Udata2,
@@ -34,7 +34,7 @@ namespace sdm
 //   //! intra-cell degrees of freedom mapping at solution points
 //   static constexpr auto dofMap = DofMap<dim,N>;
 
-//   ComputeDt_Functor(HydroParams         params,
+//   ComputeDt_Functor(KernelParams        params,
 // 		    SDM_Geometry<dim,N> sdm_geom,
 // 		    ppkMHD::EulerEquations<dim> euler,
 // 		    DataArray           Udata) :
@@ -218,7 +218,7 @@ public:
   //! intra-cell degrees of freedom mapping at solution points
   static constexpr auto dofMap = DofMap<2,N>;
 
-  ComputeDt_Functor_2d(HydroParams         params,
+  ComputeDt_Functor_2d(KernelParams        params,
                        SDM_Geometry<2,N> sdm_geom,
                        ppkMHD::EulerEquations<2> euler,
                        DataArray           Udata) :
@@ -228,7 +228,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static real_t apply(HydroParams               params,
+  static real_t apply(KernelParams              params,
                       SDM_Geometry<2,N>         sdm_geom,
                       ppkMHD::EulerEquations<2> euler,
                       DataArray                 Udata)
@@ -237,7 +237,7 @@ public:
 
     real_t invDt = 0;
     ComputeDt_Functor_2d<N> functor(params, sdm_geom, euler, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDt_Functor_2d", nbCells, functor, invDt);
     return invDt;
   }
 
@@ -356,7 +356,7 @@ public:
   //! intra-cell degrees of freedom mapping at solution points
   static constexpr auto dofMap = DofMap<3,N>;
 
-  ComputeDt_Functor_3d(HydroParams         params,
+  ComputeDt_Functor_3d(KernelParams        params,
                        SDM_Geometry<3,N> sdm_geom,
                        ppkMHD::EulerEquations<3> euler,
                        DataArray           Udata) :
@@ -366,7 +366,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static real_t apply(HydroParams               params,
+  static real_t apply(KernelParams              params,
                       SDM_Geometry<3,N>         sdm_geom,
                       ppkMHD::EulerEquations<3> euler,
                       DataArray                 Udata)
@@ -375,7 +375,7 @@ public:
 
     real_t invDt = 0;
     ComputeDt_Functor_3d<N> functor(params, sdm_geom, euler, Udata);
-    Kokkos::parallel_reduce(nbCells, functor, invDt);
+    Kokkos::parallel_reduce("ComputeDt_Functor_3d", nbCells, functor, invDt);
     return invDt;
   }
 
@@ -485,6 +485,168 @@ public:
 
 }; // class ComputeDt_Functor_3d
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Compute the explicit time-step constraint of the parabolic terms
+ * (viscosity mu and thermal diffusivity kappa), i.e. returns
+ *
+ *   max over solution points of 2 * nu * (1/dx^2 + 1/dy^2 [+ 1/dz^2])
+ *
+ * where nu = max(mu/rho, kappa) is the largest diffusion coefficient and
+ * dx, dy, dz are divided by N, as in the CFL constraint.
+ *
+ * Used to choose the number of stages of the RKL2 super-time-stepping
+ * scheme, or to limit the time step when viscous terms are integrated
+ * together with the hyperbolic ones.
+ */
+template<int dim, int N>
+class ComputeDtViscous_Functor : public SDMBaseFunctor<dim,N>
+{
+
+public:
+  using typename SDMBaseFunctor<dim,N>::DataArray;
+
+  //! intra-cell degrees of freedom mapping at solution points
+  static constexpr auto dofMap = DofMap<dim,N>;
+
+  ComputeDtViscous_Functor(KernelParams        params,
+                           SDM_Geometry<dim,N> sdm_geom,
+                           DataArray           Udata) :
+    SDMBaseFunctor<dim,N>(params,sdm_geom),
+    Udata(Udata)
+  {};
+
+  // static method which does it all: create and execute functor
+  static real_t apply(KernelParams        params,
+                      SDM_Geometry<dim,N> sdm_geom,
+                      DataArray           Udata)
+  {
+    int64_t nbCells = (dim==2) ?
+                      params.isize * params.jsize :
+                      params.isize * params.jsize * params.ksize;
+
+    real_t invDt = 0;
+    ComputeDtViscous_Functor<dim,N> functor(params, sdm_geom, Udata);
+    Kokkos::parallel_reduce("ComputeDtViscous_Functor", nbCells, functor, invDt);
+    return invDt;
+  }
+
+  // Tell each thread how to initialize its reduction result.
+  KOKKOS_INLINE_FUNCTION
+  void init (real_t& dst) const
+  {
+    // inverse time steps are non-negative
+    dst = 0;
+  } // init
+
+  //! functor for 2d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index,
+                  real_t &invDt) const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ghostWidth = this->params.ghostWidth;
+
+    const real_t mu    = this->params.settings.mu;
+    const real_t kappa = this->params.settings.kappa;
+
+    const real_t dx = this->params.dx/N;
+    const real_t dy = this->params.dy/N;
+
+    const real_t inv_dx2 = 1/(dx*dx) + 1/(dy*dy);
+
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+
+    if(j >= ghostWidth && j < jsize - ghostWidth &&
+        i >= ghostWidth && i < isize - ghostWidth)
+    {
+
+      for (int idy=0; idy<N; ++idy)
+      {
+        for (int idx=0; idx<N; ++idx)
+        {
+
+          const real_t rho = Udata(i,j, dofMap(idx,idy,0,ID));
+          const real_t nu  = FMAX(mu/rho, kappa);
+
+          invDt = FMAX(invDt, 2*nu*inv_dx2);
+
+        } // end for idx
+      } // end for idy
+
+    } // end guard - ghostcells
+
+  } // end operator () - 2d
+
+  //! functor for 3d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index,
+                  real_t &invDt) const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ksize = this->params.ksize;
+    const int ghostWidth = this->params.ghostWidth;
+
+    const real_t mu    = this->params.settings.mu;
+    const real_t kappa = this->params.settings.kappa;
+
+    const real_t dx = this->params.dx/N;
+    const real_t dy = this->params.dy/N;
+    const real_t dz = this->params.dz/N;
+
+    const real_t inv_dx2 = 1/(dx*dx) + 1/(dy*dy) + 1/(dz*dz);
+
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    if(k >= ghostWidth && k < ksize - ghostWidth &&
+        j >= ghostWidth && j < jsize - ghostWidth &&
+        i >= ghostWidth && i < isize - ghostWidth)
+    {
+
+      for (int idz=0; idz<N; ++idz)
+      {
+        for (int idy=0; idy<N; ++idy)
+        {
+          for (int idx=0; idx<N; ++idx)
+          {
+
+            const real_t rho = Udata(i,j,k, dofMap(idx,idy,idz,ID));
+            const real_t nu  = FMAX(mu/rho, kappa);
+
+            invDt = FMAX(invDt, 2*nu*inv_dx2);
+
+          } // end for idx
+        } // end for idy
+      } // end for idz
+
+    } // end guard - ghostcells
+
+  } // end operator () - 3d
+
+  // "Join" intermediate results from different threads.
+  KOKKOS_INLINE_FUNCTION
+  void join (volatile real_t& dst,
+             const volatile real_t& src) const
+  {
+    // max reduce
+    if (dst < src)
+    {
+      dst = src;
+    }
+  } // join
+
+  DataArray Udata;
+
+}; // class ComputeDtViscous_Functor
+
 } // namespace sdm
 
 #endif // SDM_DT_FUNCTOR_H_
@@ -7,6 +7,7 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "sdm/SDMBaseFunctor.h"
 
 #include "sdm/SDM_Geometry.h"
@@ -38,7 +39,7 @@ public:
 
   static constexpr auto dofMapF = DofMapFlux<dim,N,dir>;
 
-  ComputeFluxAtFluxPoints_Functor(HydroParams                 params,
+  ComputeFluxAtFluxPoints_Functor(KernelParams                params,
                                   SDM_Geometry<dim,N>         sdm_geom,
                                   ppkMHD::EulerEquations<dim> euler,
                                   DataArray                   UdataFlux) :
@@ -48,7 +49,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     ppkMHD::EulerEquations<dim> euler,
                     DataArray           UdataFlux)
@@ -59,7 +60,7 @@ public:
 
     ComputeFluxAtFluxPoints_Functor functor(params, sdm_geom,
                                             euler, UdataFlux);
-    Kokkos::parallel_for("ComputeFluxAtFluxPoints_Functor", nbCells, functor);
+    ppkMHD::parallel_for_tuned("ComputeFluxAtFluxPoints_Functor", nbCells, functor);
   }
 
   // ================================================
@@ -63,7 +63,7 @@ public:
    * \param[in] Umax maximum values of conservative variables in neighborhood
    * \param[in,out] UdataFlux is only modified at end-points (reconstructed conservative variables).
    */
-  Compute_Reconstructed_state_with_Limiter_Functor(HydroParams         params,
+  Compute_Reconstructed_state_with_Limiter_Functor(KernelParams        params,
       SDM_Geometry<dim,N> sdm_geom,
       ppkMHD::EulerEquations<dim> euler,
       DataArray   Udata,
@@ -81,7 +81,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     ppkMHD::EulerEquations<dim> euler,
                     DataArray           Udata,
@@ -96,7 +96,7 @@ public:
         Uaverage,
         Umin, Umax,
         UdataFlux);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("Compute_Reconstructed_state_with_Limiter_Functor", nbCells, functor);
   }
 
   // ================================================
@@ -789,7 +789,7 @@ public:
 //    * \param[in,out] UdataFlux will only be accessed in read/write at cell border (end points).
 //    *
 //    */
-//   ComputeFluxAtEndPoints_Functor(HydroParams                 params,
+//   ComputeFluxAtEndPoints_Functor(KernelParams                params,
 // 				 SDM_Geometry<dim,N>         sdm_geom,
 // 				 ppkMHD::EulerEquations<dim> euler,
 // 				 DataArray                   UdataFlux) :
@@ -7,6 +7,7 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "sdm/SDMBaseFunctor.h"
 
 #include "sdm/SDM_Geometry.h"
@@ -44,7 +45,7 @@ public:
   static constexpr auto dofMapS = DofMap<dim,N>;
   static constexpr auto dofMapF = DofMapFlux<dim,N,dir>;
 
-  Interpolate_At_FluxPoints_Functor(HydroParams         params,
+  Interpolate_At_FluxPoints_Functor(KernelParams        params,
                                     SDM_Geometry<dim,N> sdm_geom,
                                     DataArray           UdataSol,
                                     DataArray           UdataFlux) :
@@ -54,7 +55,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataSol,
                     DataArray           UdataFlux)
@@ -65,7 +66,7 @@ public:
 
     Interpolate_At_FluxPoints_Functor functor(params, sdm_geom,
         UdataSol, UdataFlux);
-    Kokkos::parallel_for("Interpolate_At_FluxPoints_Functor", nbCells, functor);
+    ppkMHD::parallel_for_tuned("Interpolate_At_FluxPoints_Functor", nbCells, functor);
   }
 
   // =========================================================
@@ -383,7 +384,7 @@ public:
   static constexpr auto dofMapS = DofMap<dim,N>;
   static constexpr auto dofMapF = DofMapFlux<dim,N,dir>;
 
-  Interpolate_At_SolutionPoints_Functor(HydroParams         params,
+  Interpolate_At_SolutionPoints_Functor(KernelParams        params,
                                         SDM_Geometry<dim,N> sdm_geom,
                                         DataArray           UdataFlux,
                                         DataArray           UdataSol) :
@@ -393,7 +394,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataFlux,
                     DataArray           UdataSol)
@@ -404,7 +405,7 @@ public:
 
     Interpolate_At_SolutionPoints_Functor functor(params, sdm_geom,
         UdataFlux, UdataSol);
-    Kokkos::parallel_for("Interpolate_At_SolutionPoints_Functor",nbCells, functor);
+    ppkMHD::parallel_for_tuned("Interpolate_At_SolutionPoints_Functor", nbCells, functor);
   }
 
   // =========================================================
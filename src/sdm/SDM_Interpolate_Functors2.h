@@ -7,6 +7,7 @@
 #endif // __CUDA_ARCH__
 
 #include "shared/kokkos_shared.h"
+#include "shared/KernelTuner.h"
 #include "sdm/SDMBaseFunctor.h"
 
 #include "sdm/SDM_Geometry.h"
@@ -41,7 +42,7 @@ public:
   static constexpr auto dofMapS = DofMap<dim,N>;
   static constexpr auto dofMapF = DofMapFlux<dim,N,dir>;
 
-  Interpolate_At_FluxPoints_Functor(HydroParams         params,
+  Interpolate_At_FluxPoints_Functor(KernelParams        params,
                                     SDM_Geometry<dim,N> sdm_geom,
                                     DataArray           UdataSol,
                                     DataArray           UdataFlux) :
@@ -51,7 +52,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataSol,
                     DataArray           UdataFlux,
@@ -59,7 +60,7 @@ public:
   {
     Interpolate_At_FluxPoints_Functor_v2 functor(params, sdm_geom,
         UdataSol, UdataFlux);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("Interpolate_At_FluxPoints_Functor_v2", nbCells, functor);
   }
 
   // =========================================================
@@ -368,7 +369,7 @@ public:
   static constexpr auto dofMapS = DofMap<dim,N>;
   static constexpr auto dofMapF = DofMapFlux<dim,N,dir>;
 
-  Interpolate_At_SolutionPoints_Functor(HydroParams         params,
+  Interpolate_At_SolutionPoints_Functor(KernelParams        params,
                                         SDM_Geometry<dim,N> sdm_geom,
                                         DataArray           UdataFlux,
                                         DataArray           UdataSol) :
@@ -378,7 +379,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataFlux,
                     DataArray           UdataSol,
@@ -386,7 +387,7 @@ public:
   {
     Interpolate_At_SolutionPoints_Functor_v2 functor(params, sdm_geom,
         UdataFlux, UdataSol);
-    Kokkos::parallel_for(nbCells, functor);
+    ppkMHD::parallel_for_tuned("Interpolate_At_SolutionPoints_Functor_v2", nbCells, functor);
   }
 
   // =========================================================
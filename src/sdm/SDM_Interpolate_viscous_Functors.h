@@ -60,7 +60,7 @@ public:
    *
    * This means UdataFlux should have been allocated with a number of fields of at leat "dim".
    */
-  Interpolate_velocities_Sol2Flux_Functor(HydroParams         params,
+  Interpolate_velocities_Sol2Flux_Functor(KernelParams        params,
                                           SDM_Geometry<dim,N> sdm_geom,
                                           DataArray           UdataSol,
                                           DataArray           UdataFlux) :
@@ -70,7 +70,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataSol,
                     DataArray           UdataFlux)
@@ -393,7 +393,7 @@ public:
    * \param[in] sdm_geom
    * \param[in,out] UdataFlux a flux array
    */
-  Average_component_at_cell_borders_Functor(HydroParams         params,
+  Average_component_at_cell_borders_Functor(KernelParams        params,
       SDM_Geometry<dim,N> sdm_geom,
       DataArray           UdataFlux,
       int                 nbvar,
@@ -405,7 +405,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataFlux)
   {
@@ -693,7 +693,7 @@ public:
    * \param[out] UdataSol velocity gradient along dir at solution points
    *
    */
-  Interp_grad_velocity_at_SolutionPoints_Functor(HydroParams         params,
+  Interp_grad_velocity_at_SolutionPoints_Functor(KernelParams        params,
       SDM_Geometry<dim,N> sdm_geom,
       DataArray           UdataFlux,
       DataArray           UdataSol) :
@@ -703,7 +703,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataFlux,
                     DataArray           UdataSol)
@@ -1019,7 +1019,7 @@ public:
    *
    * This means UdataFlux should have been allocated like FUgrad (see class SolverHydroSDM).
    */
-  Interpolate_velocity_gradients_Sol2Flux_Functor(HydroParams         params,
+  Interpolate_velocity_gradients_Sol2Flux_Functor(KernelParams        params,
       SDM_Geometry<dim,N> sdm_geom,
       DataArray           UdataSol,
       DataArray           UdataFlux) :
@@ -1029,7 +1029,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataSol,
                     DataArray           UdataFlux)
@@ -36,7 +36,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  Average_Conservative_Variables_Functor(HydroParams         params,
+  Average_Conservative_Variables_Functor(KernelParams        params,
                                          SDM_Geometry<dim,N> sdm_geom,
                                          DataArray           Udata,
                                          DataArray           Uaverage) :
@@ -46,7 +46,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     DataArray           Uaverage)
@@ -220,7 +220,7 @@ public:
    * \param[out] Umin of Uaverage over stencil
    * \param[out] Umax of Uaverage over stencil
    */
-  MinMax_Conservative_Variables_Functor(HydroParams         params,
+  MinMax_Conservative_Variables_Functor(KernelParams        params,
                                         SDM_Geometry<dim,N> sdm_geom,
                                         DataArray           Uaverage,
                                         DataArray           Umin,
@@ -234,7 +234,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Uaverage,
                     DataArray           Umin,
@@ -413,17 +413,19 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  Average_Gradient_Functor(HydroParams         params,
+  Average_Gradient_Functor(KernelParams        params,
                            SDM_Geometry<dim,N> sdm_geom,
                            DataArray           Udata,
-                           DataArray           Uaverage) :
+                           DataArray           Uaverage,
+                           CellList            cellList = CellList()) :
     SDMBaseFunctor<dim,N>(params,sdm_geom),
     Udata(Udata),
-    Uaverage(Uaverage)
+    Uaverage(Uaverage),
+    cellList(cellList)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     DataArray           Uaverage)
@@ -437,6 +439,19 @@ public:
     Kokkos::parallel_for("Average_Gradient_Functor", nbCells, functor);
   }
 
+  //! same as above, restricted to the first nbCells cells of cellList
+  static void apply(KernelParams        params,
+                    SDM_Geometry<dim,N> sdm_geom,
+                    DataArray           Udata,
+                    DataArray           Uaverage,
+                    CellList            cellList,
+                    int                 nbCells)
+  {
+    Average_Gradient_Functor functor(params, sdm_geom,
+                                     Udata, Uaverage, cellList);
+    Kokkos::parallel_for("Average_Gradient_Functor", nbCells, functor);
+  }
+
   // ================================================
   //
   // 2D version.
@@ -445,8 +460,11 @@ public:
   //! functor for 2d
   template<int dim_ = dim>
   KOKKOS_INLINE_FUNCTION
-  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  void operator()(const typename std::enable_if<dim_==2, int>::type& iCell) const
   {
+
+    // cell index (either all cells, or read from a troubled cells list)
+    const int index = cellList.extent(0) > 0 ? cellList(iCell) : iCell;
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
 
@@ -590,9 +608,12 @@ public:
   //! functor for 3d
   template<int dim_ = dim>
   KOKKOS_INLINE_FUNCTION
-  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  void operator()(const typename std::enable_if<dim_==3, int>::type& iCell) const
   {
 
+    // cell index (either all cells, or read from a troubled cells list)
+    const int index = cellList.extent(0) > 0 ? cellList(iCell) : iCell;
+
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
     const int ksize = this->params.ksize;
@@ -807,6 +828,7 @@ public:
 
   DataArray Udata;
   DataArray Uaverage;
+  CellList  cellList;
 
 }; // class Average_Gradient_Functor
 
@@ -837,7 +859,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  Apply_limiter_Functor(HydroParams         params,
+  Apply_limiter_Functor(KernelParams        params,
                         SDM_Geometry<dim,N> sdm_geom,
                         ppkMHD::EulerEquations<dim> euler,
                         DataArray           Udata,
@@ -845,7 +867,8 @@ public:
                         DataArray           Ugradx,
                         DataArray           Ugrady,
                         DataArray           Ugradz,
-                        const real_t        Mdx2) :
+                        const real_t        Mdx2,
+                        CellList            cellList = CellList()) :
     SDMBaseFunctor<dim,N>(params,sdm_geom),
     euler(euler),
     Udata(Udata),
@@ -853,11 +876,12 @@ public:
     Ugradx(Ugradx),
     Ugrady(Ugrady),
     Ugradz(Ugradz),
-    Mdx2(Mdx2)
+    Mdx2(Mdx2),
+    cellList(cellList)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     ppkMHD::EulerEquations<dim> euler,
                     DataArray           Udata,
@@ -877,6 +901,26 @@ public:
     Kokkos::parallel_for("Apply_limiter_Functor", nbCells, functor);
   }
 
+  //! same as above, restricted to the first nbCells cells of cellList
+  static void apply(KernelParams        params,
+                    SDM_Geometry<dim,N> sdm_geom,
+                    ppkMHD::EulerEquations<dim> euler,
+                    DataArray           Udata,
+                    DataArray           Uaverage,
+                    DataArray           Ugradx,
+                    DataArray           Ugrady,
+                    DataArray           Ugradz,
+                    const real_t        Mdx2,
+                    CellList            cellList,
+                    int                 nbCells)
+  {
+    Apply_limiter_Functor functor(params, sdm_geom, euler,
+                                  Udata, Uaverage,
+                                  Ugradx, Ugrady, Ugradz, Mdx2,
+                                  cellList);
+    Kokkos::parallel_for("Apply_limiter_Functor", nbCells, functor);
+  }
+
   /**
    * TVB version of minmod limiter. If Mdx2=0 then it is TVD limiter.
    */
@@ -908,8 +952,11 @@ public:
   //! functor for 2d
   template<int dim_ = dim>
   KOKKOS_INLINE_FUNCTION
-  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  void operator()(const typename std::enable_if<dim_==2, int>::type& iCell) const
   {
+
+    // cell index (either all cells, or read from a troubled cells list)
+    const int index = cellList.extent(0) > 0 ? cellList(iCell) : iCell;
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
 
@@ -1041,9 +1088,12 @@ public:
   //! functor for 3d
   template<int dim_ = dim>
   KOKKOS_INLINE_FUNCTION
-  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  void operator()(const typename std::enable_if<dim_==3, int>::type& iCell) const
   {
 
+    // cell index (either all cells, or read from a troubled cells list)
+    const int index = cellList.extent(0) > 0 ? cellList(iCell) : iCell;
+
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
     const int ksize = this->params.ksize;
@@ -1203,6 +1253,7 @@ public:
   DataArray Ugrady;
   DataArray Ugradz;
   real_t    Mdx2;
+  CellList  cellList;
 
 }; // class Apply_limiter_Functor
 
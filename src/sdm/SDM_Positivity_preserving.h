@@ -66,7 +66,7 @@ public:
    * \param[in,out] UdataFlux contains conservative variables at flux points
    * \params[in] Uaverage contains cell volume averaged conservative variables.
    */
-  Apply_positivity_Functor(HydroParams         params,
+  Apply_positivity_Functor(KernelParams        params,
                            SDM_Geometry<dim,N> sdm_geom,
                            DataArray           UdataSol,
                            DataArray           UdataFlux,
@@ -78,7 +78,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataSol,
                     DataArray           UdataFlux,
@@ -964,17 +964,19 @@ public:
    * \param[in,out] UdataSol contains conservative variables at solution points
    * \params[in] Uaverage contains cell volume averaged conservative variables.
    */
-  Apply_positivity_Functor_v2(HydroParams         params,
+  Apply_positivity_Functor_v2(KernelParams        params,
                               SDM_Geometry<dim,N> sdm_geom,
                               DataArray           UdataSol,
-                              DataArray           Uaverage) :
+                              DataArray           Uaverage,
+                              CellList            cellList = CellList()) :
     SDMBaseFunctor<dim,N>(params,sdm_geom),
     UdataSol(UdataSol),
-    Uaverage(Uaverage)
+    Uaverage(Uaverage),
+    cellList(cellList)
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           UdataSol,
                     DataArray           Uaverage)
@@ -988,6 +990,19 @@ public:
     Kokkos::parallel_for("Apply_positivity_Functor_v2", nbCells, functor);
   }
 
+  //! same as above, restricted to the first nbCells cells of cellList
+  static void apply(KernelParams        params,
+                    SDM_Geometry<dim,N> sdm_geom,
+                    DataArray           UdataSol,
+                    DataArray           Uaverage,
+                    CellList            cellList,
+                    int                 nbCells)
+  {
+    Apply_positivity_Functor_v2 functor(params, sdm_geom,
+                                        UdataSol, Uaverage, cellList);
+    Kokkos::parallel_for("Apply_positivity_Functor_v2", nbCells, functor);
+  }
+
   // =========================================================
   /*
    * 2D version.
@@ -996,9 +1011,12 @@ public:
   //! functor for 2d
   template<int dim_ = dim>
   KOKKOS_INLINE_FUNCTION
-  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  void operator()(const typename std::enable_if<dim_==2, int>::type& iCell) const
   {
 
+    // cell index (either all cells, or read from a troubled cells list)
+    const int index = cellList.extent(0) > 0 ? cellList(iCell) : iCell;
+
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
 
@@ -1332,9 +1350,12 @@ public:
   //! functor for 3d
   template<int dim_ = dim>
   KOKKOS_INLINE_FUNCTION
-  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  void operator()(const typename std::enable_if<dim_==3, int>::type& iCell) const
   {
 
+    // cell index (either all cells, or read from a troubled cells list)
+    const int index = cellList.extent(0) > 0 ? cellList(iCell) : iCell;
+
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
     const int ksize = this->params.ksize;
@@ -1836,6 +1857,7 @@ public:
   DataArray UdataSol;
   DataArray UdataFlux;
   DataArray Uaverage;
+  CellList  cellList;
 
 }; // class Apply_positivity_Functor_v2
 
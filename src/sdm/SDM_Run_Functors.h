@@ -32,7 +32,7 @@ public:
   static constexpr auto dofMap  = DofMap<dim,N>;
   static constexpr auto dofMapF = DofMapFlux<dim,N,IX>;
 
-  SDM_Erase_Functor(HydroParams         params,
+  SDM_Erase_Functor(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     bool                isFlux) :
@@ -42,7 +42,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     bool                isFlux)
@@ -201,7 +201,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  SDM_Update_Functor(HydroParams         params,
+  SDM_Update_Functor(KernelParams        params,
                      SDM_Geometry<dim,N> sdm_geom,
                      DataArray           Udata,
                      DataArray           mdUdt,
@@ -213,7 +213,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     DataArray           mdUdt,
@@ -324,7 +324,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  SDM_Update_sspRK2_Functor(HydroParams         params,
+  SDM_Update_sspRK2_Functor(KernelParams        params,
                             SDM_Geometry<dim,N> sdm_geom,
                             DataArray           Udata,
                             DataArray           URK,
@@ -338,7 +338,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     DataArray           URK,
@@ -484,7 +484,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  SDM_Update_RK_Functor(HydroParams         params,
+  SDM_Update_RK_Functor(KernelParams        params,
                         SDM_Geometry<dim,N> sdm_geom,
                         DataArray           Uout,
                         DataArray           U_0,
@@ -502,7 +502,7 @@ public:
   {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Uout,
                     DataArray           U_0,
@@ -658,6 +658,176 @@ public:
 
 }; // SDM_Update_RK_Functor
 
+// =======================================================================
+// =======================================================================
+/**
+ * Perform a stage of the RKL2 super-time-stepping scheme, of the type
+ * U_out = c0 * U_0 + c1 * U_1 + c2 * U_2 + c3 * dt * D_0 + c4 * dt * D_1.
+ *
+ * U_0 is the state at the beginning of the super-step, U_1 and U_2 the
+ * states of the two previous stages, D_0 and D_1 are fluxes divergence
+ * arrays (operator evaluated at U_0 and U_1).
+ *
+ * \tparam dim dimension (2 or 3).
+ * \tparam N SDM order
+ */
+template<int dim, int N>
+class SDM_Update_RKL2_Functor : public SDMBaseFunctor<dim,N>
+{
+
+public:
+  using typename SDMBaseFunctor<dim,N>::DataArray;
+
+  using coefs_t = Kokkos::Array<real_t,5>;
+
+  static constexpr auto dofMap = DofMap<dim,N>;
+
+  SDM_Update_RKL2_Functor(KernelParams        params,
+                          SDM_Geometry<dim,N> sdm_geom,
+                          DataArray           Uout,
+                          DataArray           U_0,
+                          DataArray           U_1,
+                          DataArray           U_2,
+                          DataArray           D_0,
+                          DataArray           D_1,
+                          coefs_t             coefs,
+                          real_t              dt) :
+    SDMBaseFunctor<dim,N>(params,sdm_geom),
+    Uout(Uout),
+    U_0(U_0),
+    U_1(U_1),
+    U_2(U_2),
+    D_0(D_0),
+    D_1(D_1),
+    coefs(coefs),
+    dt(dt)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams        params,
+                    SDM_Geometry<dim,N> sdm_geom,
+                    DataArray           Uout,
+                    DataArray           U_0,
+                    DataArray           U_1,
+                    DataArray           U_2,
+                    DataArray           D_0,
+                    DataArray           D_1,
+                    coefs_t             coefs,
+                    real_t              dt)
+  {
+    int64_t nbCells = (dim==2) ?
+                      params.isize * params.jsize :
+                      params.isize * params.jsize * params.ksize;
+
+    SDM_Update_RKL2_Functor functor(params, sdm_geom,
+                                    Uout, U_0, U_1, U_2, D_0, D_1, coefs, dt);
+    Kokkos::parallel_for("SDM_Update_RKL2_Functor",nbCells, functor);
+  }
+
+  //! functor for 2d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index)  const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ghostWidth = this->params.ghostWidth;
+    const int nbvar = this->params.nbvar;
+
+    const real_t c3dt = coefs[3]*dt;
+    const real_t c4dt = coefs[4]*dt;
+
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+
+    if(j >= ghostWidth && j < jsize-ghostWidth  &&
+        i >= ghostWidth && i < isize-ghostWidth )
+    {
+
+      for (int ivar=0; ivar<nbvar; ++ivar)
+      {
+        for (int idy=0; idy<N; ++idy)
+        {
+          for (int idx=0; idx<N; ++idx)
+          {
+
+            const int l = dofMap(idx,idy,0,ivar);
+
+            Uout(i,j,l) =
+              coefs[0] * U_0(i,j,l) +
+              coefs[1] * U_1(i,j,l) +
+              coefs[2] * U_2(i,j,l) +
+              c3dt     * D_0(i,j,l) +
+              c4dt     * D_1(i,j,l);
+
+          } // for idx
+        } // for idy
+      } // for ivar
+
+    } // end if guard
+
+  } // end operator ()
+
+  //! functor for 3d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index)  const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ksize = this->params.ksize;
+    const int ghostWidth = this->params.ghostWidth;
+    const int nbvar = this->params.nbvar;
+
+    const real_t c3dt = coefs[3]*dt;
+    const real_t c4dt = coefs[4]*dt;
+
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    if(k >= ghostWidth && k < ksize-ghostWidth  &&
+        j >= ghostWidth && j < jsize-ghostWidth  &&
+        i >= ghostWidth && i < isize-ghostWidth )
+    {
+
+      for (int ivar=0; ivar<nbvar; ++ivar)
+      {
+        for (int idz=0; idz<N; ++idz)
+        {
+          for (int idy=0; idy<N; ++idy)
+          {
+            for (int idx=0; idx<N; ++idx)
+            {
+
+              const int l = dofMap(idx,idy,idz,ivar);
+
+              Uout(i,j,k,l) =
+                coefs[0] * U_0(i,j,k,l) +
+                coefs[1] * U_1(i,j,k,l) +
+                coefs[2] * U_2(i,j,k,l) +
+                c3dt     * D_0(i,j,k,l) +
+                c4dt     * D_1(i,j,k,l);
+
+            } // for idx
+          } // for idy
+        } // for idz
+      } // for ivar
+
+    } // end if guard
+
+  } // end operator ()
+
+  DataArray Uout;
+  DataArray U_0;
+  DataArray U_1;
+  DataArray U_2;
+  DataArray D_0;
+  DataArray D_1;
+  coefs_t   coefs;
+  real_t    dt;
+
+}; // SDM_Update_RKL2_Functor
+
 } // namespace sdm
 
 #endif // SDM_RUN_FUNCTORS_H_
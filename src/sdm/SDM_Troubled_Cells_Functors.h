@@ -0,0 +1,735 @@
+#ifndef SDM_TROUBLED_CELLS_FUNCTORS_H_
+#define SDM_TROUBLED_CELLS_FUNCTORS_H_
+
+#include <limits> // for std::numeric_limits
+#ifdef __CUDA_ARCH__
+#include <math_constants.h> // for cuda math constants, e.g. CUDART_INF
+#endif // __CUDA_ARCH__
+
+#include "shared/kokkos_shared.h"
+#include "sdm/SDMBaseFunctor.h"
+
+#include "sdm/SDM_Geometry.h"
+#include "sdm/sdm_shared.h" // for DofMap
+
+namespace sdm
+{
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Troubled cell indicator for the limiter.
+ *
+ * A cell is marked as troubled when one of the two following tests
+ * fires:
+ * - TVB extremum: for at least one conservative variable, the variation
+ *   of the solution points values inside the cell is larger than the TVB
+ *   parameter Mdx2 (below that threshold, the modified minmod of
+ *   Apply_limiter_Functor leaves the cell unchanged), and the solution
+ *   points values leave the range of the cell-averaged values of the
+ *   current cell and its face neighbors (local extremum);
+ * - KXRCF jump (Krivodonova et al., Appl. Numer. Math. 48, 2004): for
+ *   density or energy, the mean jump of the solution across one of the
+ *   cell faces, |u_in - u_out| averaged over the face flux points, is
+ *   larger than h^(N/2) |u_average| (h: smallest cell size). The jump is
+ *   O(h^N) in smooth regions and O(1) at a discontinuity, so this catches
+ *   steep monotone profiles that have no local extremum. All faces are
+ *   tested, not only inflow ones.
+ *
+ * Marks are then dilated by one cell (Dilate_Troubled_Cells_Functor), so
+ * that the neighbors of a marked cell, whose minmod arguments involve
+ * the marked cell average, are processed too.
+ *
+ * In smooth regions very few cells are marked, so that the limiter
+ * (Average_Gradient_Functor + Apply_limiter_Functor) only runs on a
+ * small list of cells. The indicator is not an exact superset of the
+ * cells a sweep over all cells would limit (the limiter works on
+ * characteristic variables and the cell-averaged gradient), but the
+ * cells it can miss are cells where neither a discontinuity nor an
+ * extremum is detected, where the limiter would only clip a smooth
+ * slope.
+ *
+ * Uaverage must be up to date.
+ */
+template<int dim, int N>
+class Limiter_Troubled_Cells_Functor : public SDMBaseFunctor<dim,N>
+{
+
+public:
+  using typename SDMBaseFunctor<dim,N>::DataArray;
+  using typename SDMBaseFunctor<dim,N>::solution_values_t;
+
+  static constexpr auto dofMap = DofMap<dim,N>;
+
+  Limiter_Troubled_Cells_Functor(KernelParams        params,
+                                 SDM_Geometry<dim,N> sdm_geom,
+                                 DataArray           Udata,
+                                 DataArray           Uaverage,
+                                 CellFlags           flags,
+                                 const real_t        Mdx2) :
+    SDMBaseFunctor<dim,N>(params,sdm_geom),
+    Udata(Udata),
+    Uaverage(Uaverage),
+    flags(flags),
+    Mdx2(Mdx2)
+  {
+    // KXRCF scaling h^(N/2)
+    real_t h = fmin(params.dx, params.dy);
+    if (dim == 3)
+      h = fmin(h, params.dz);
+    kxrcf_scale = pow(h, 0.5*N);
+  };
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams        params,
+                    SDM_Geometry<dim,N> sdm_geom,
+                    DataArray           Udata,
+                    DataArray           Uaverage,
+                    CellFlags           flags,
+                    const real_t        Mdx2)
+  {
+    int64_t nbCells = dim == 2 ?
+                      params.isize * params.jsize :
+                      params.isize * params.jsize * params.ksize;
+
+    Limiter_Troubled_Cells_Functor functor(params, sdm_geom,
+                                           Udata, Uaverage,
+                                           flags, Mdx2);
+    Kokkos::parallel_for("Limiter_Troubled_Cells_Functor", nbCells, functor);
+  }
+
+  /**
+   * Value of variable ivar of cell (i,j) at a face flux point: line l
+   * along direction dir, flux point side (0 : left face, N : right face).
+   */
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t face_value(typename std::enable_if<dim_==2, int>::type i, int j,
+                    int dir, int l, int side, int ivar) const
+  {
+    solution_values_t sol;
+    for (int n=0; n<N; ++n)
+      sol[n] = dir==IX ?
+        Udata(i,j,dofMap(n,l,0,ivar)) :
+        Udata(i,j,dofMap(l,n,0,ivar));
+    return this->sol2flux(sol, side);
+  }
+
+  //! same as above in 3d, line (l1,l2) along direction dir
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t face_value(typename std::enable_if<dim_==3, int>::type i, int j, int k,
+                    int dir, int l1, int l2, int side, int ivar) const
+  {
+    solution_values_t sol;
+    for (int n=0; n<N; ++n)
+      sol[n] =
+        dir==IX ? Udata(i,j,k,dofMap(n,l1,l2,ivar)) :
+        dir==IY ? Udata(i,j,k,dofMap(l1,n,l2,ivar)) :
+                  Udata(i,j,k,dofMap(l1,l2,n,ivar));
+    return this->sol2flux(sol, side);
+  }
+
+  // ================================================
+  //
+  // 2D version.
+  //
+  // ================================================
+  //! functor for 2d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+
+    const int nbvar = this->params.nbvar;
+
+    // local cell index
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+
+    // the limiter is never applied on the outer layer of cells
+    if (i==0 or i==isize-1 or
+        j==0 or j==jsize-1 )
+    {
+      flags(index) = 0;
+      return;
+    }
+
+    int troubled = 0;
+
+    for (int ivar = 0; ivar<nbvar; ++ivar)
+    {
+
+      // min / max of cell-averaged values in the neighborhood
+      real_t umin = Uaverage(i,j,ivar);
+      real_t umax = umin;
+
+      umin = fmin(umin, Uaverage(i-1,j  ,ivar));
+      umin = fmin(umin, Uaverage(i+1,j  ,ivar));
+      umin = fmin(umin, Uaverage(i  ,j-1,ivar));
+      umin = fmin(umin, Uaverage(i  ,j+1,ivar));
+
+      umax = fmax(umax, Uaverage(i-1,j  ,ivar));
+      umax = fmax(umax, Uaverage(i+1,j  ,ivar));
+      umax = fmax(umax, Uaverage(i  ,j-1,ivar));
+      umax = fmax(umax, Uaverage(i  ,j+1,ivar));
+
+      // min / max over solution points
+      real_t smin = Udata(i,j,dofMap(0,0,0,ivar));
+      real_t smax = smin;
+
+      for (int idy=0; idy<N; ++idy)
+      {
+        for (int idx=0; idx<N; ++idx)
+        {
+          const real_t u = Udata(i,j,dofMap(idx,idy,0,ivar));
+          smin = fmin(smin, u);
+          smax = fmax(smax, u);
+        } // end for idx
+      } // end for idy
+
+      if ( smax - smin >= Mdx2 and (smax > umax or smin < umin) )
+        troubled = 1;
+
+    } // end for ivar
+
+    // KXRCF jump indicator (density and energy), largest mean jump over
+    // the 4 faces
+    const int kxrcf_vars[2] = {ID, IE};
+
+    for (int v = 0; v < 2 and !troubled; ++v)
+    {
+
+      const int ivar = kxrcf_vars[v];
+
+      real_t jump[4] = {0, 0, 0, 0};
+
+      for (int l=0; l<N; ++l)
+      {
+        jump[0] += fabs(face_value(i,j,IX,l,0,ivar) - face_value(i-1,j,IX,l,N,ivar));
+        jump[1] += fabs(face_value(i,j,IX,l,N,ivar) - face_value(i+1,j,IX,l,0,ivar));
+        jump[2] += fabs(face_value(i,j,IY,l,0,ivar) - face_value(i,j-1,IY,l,N,ivar));
+        jump[3] += fabs(face_value(i,j,IY,l,N,ivar) - face_value(i,j+1,IY,l,0,ivar));
+      }
+
+      const real_t threshold = N * kxrcf_scale * fabs(Uaverage(i,j,ivar));
+
+      for (int f=0; f<4; ++f)
+        if (jump[f] > threshold)
+          troubled = 1;
+
+    } // end for ivar
+
+    flags(index) = troubled;
+
+  } // operator () - 2d
+
+  // ================================================
+  //
+  // 3D version.
+  //
+  // ================================================
+  //! functor for 3d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  {
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ksize = this->params.ksize;
+
+    const int nbvar = this->params.nbvar;
+
+    // local cell index
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    // the limiter is never applied on the outer layer of cells
+    if (i==0 or i==isize-1 or
+        j==0 or j==jsize-1 or
+        k==0 or k==ksize-1 )
+    {
+      flags(index) = 0;
+      return;
+    }
+
+    int troubled = 0;
+
+    for (int ivar = 0; ivar<nbvar; ++ivar)
+    {
+
+      // min / max of cell-averaged values in the neighborhood
+      real_t umin = Uaverage(i,j,k,ivar);
+      real_t umax = umin;
+
+      umin = fmin(umin, Uaverage(i-1,j  ,k  ,ivar));
+      umin = fmin(umin, Uaverage(i+1,j  ,k  ,ivar));
+      umin = fmin(umin, Uaverage(i  ,j-1,k  ,ivar));
+      umin = fmin(umin, Uaverage(i  ,j+1,k  ,ivar));
+      umin = fmin(umin, Uaverage(i  ,j  ,k-1,ivar));
+      umin = fmin(umin, Uaverage(i  ,j  ,k+1,ivar));
+
+      umax = fmax(umax, Uaverage(i-1,j  ,k  ,ivar));
+      umax = fmax(umax, Uaverage(i+1,j  ,k  ,ivar));
+      umax = fmax(umax, Uaverage(i  ,j-1,k  ,ivar));
+      umax = fmax(umax, Uaverage(i  ,j+1,k  ,ivar));
+      umax = fmax(umax, Uaverage(i  ,j  ,k-1,ivar));
+      umax = fmax(umax, Uaverage(i  ,j  ,k+1,ivar));
+
+      // min / max over solution points
+      real_t smin = Udata(i,j,k,dofMap(0,0,0,ivar));
+      real_t smax = smin;
+
+      for (int idz=0; idz<N; ++idz)
+      {
+        for (int idy=0; idy<N; ++idy)
+        {
+          for (int idx=0; idx<N; ++idx)
+          {
+            const real_t u = Udata(i,j,k,dofMap(idx,idy,idz,ivar));
+            smin = fmin(smin, u);
+            smax = fmax(smax, u);
+          } // end for idx
+        } // end for idy
+      } // end for idz
+
+      if ( smax - smin >= Mdx2 and (smax > umax or smin < umin) )
+        troubled = 1;
+
+    } // end for ivar
+
+    // KXRCF jump indicator (density and energy), largest mean jump over
+    // the 6 faces
+    const int kxrcf_vars[2] = {ID, IE};
+
+    for (int v = 0; v < 2 and !troubled; ++v)
+    {
+
+      const int ivar = kxrcf_vars[v];
+
+      real_t jump[6] = {0, 0, 0, 0, 0, 0};
+
+      for (int l2=0; l2<N; ++l2)
+      {
+        for (int l1=0; l1<N; ++l1)
+        {
+          jump[0] += fabs(face_value(i,j,k,IX,l1,l2,0,ivar) - face_value(i-1,j,k,IX,l1,l2,N,ivar));
+          jump[1] += fabs(face_value(i,j,k,IX,l1,l2,N,ivar) - face_value(i+1,j,k,IX,l1,l2,0,ivar));
+          jump[2] += fabs(face_value(i,j,k,IY,l1,l2,0,ivar) - face_value(i,j-1,k,IY,l1,l2,N,ivar));
+          jump[3] += fabs(face_value(i,j,k,IY,l1,l2,N,ivar) - face_value(i,j+1,k,IY,l1,l2,0,ivar));
+          jump[4] += fabs(face_value(i,j,k,IZ,l1,l2,0,ivar) - face_value(i,j,k-1,IZ,l1,l2,N,ivar));
+          jump[5] += fabs(face_value(i,j,k,IZ,l1,l2,N,ivar) - face_value(i,j,k+1,IZ,l1,l2,0,ivar));
+        } // end for l1
+      } // end for l2
+
+      const real_t threshold = N * N * kxrcf_scale * fabs(Uaverage(i,j,k,ivar));
+
+      for (int f=0; f<6; ++f)
+        if (jump[f] > threshold)
+          troubled = 1;
+
+    } // end for ivar
+
+    flags(index) = troubled;
+
+  } // operator () - 3d
+
+  DataArray Udata;
+  DataArray Uaverage;
+  CellFlags flags;
+  const real_t Mdx2;
+
+  //! h^(N/2), KXRCF jump scaling
+  real_t kxrcf_scale;
+
+}; // class Limiter_Troubled_Cells_Functor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Troubled cell indicator for the positivity preserving procedure.
+ *
+ * A cell is marked when the density interpolated at one of its flux
+ * points is small enough to trigger the density correction (theta1 < 1)
+ * or when the pressure at one of its flux points is below the threshold
+ * used in Apply_positivity_Functor_v2. The test is the same as the one
+ * performed by Apply_positivity_Functor_v2, without the computation of
+ * the correction itself, so that cells not marked would have been left
+ * unchanged.
+ *
+ * Uaverage must be up to date.
+ */
+template<int dim, int N>
+class Positivity_Troubled_Cells_Functor : public SDMBaseFunctor<dim,N>
+{
+
+public:
+  using typename SDMBaseFunctor<dim,N>::DataArray;
+  using typename SDMBaseFunctor<dim,N>::solution_values_t;
+  using typename SDMBaseFunctor<dim,N>::flux_values_t;
+
+  static constexpr auto dofMapS = DofMap<dim,N>;
+
+  Positivity_Troubled_Cells_Functor(KernelParams        params,
+                                    SDM_Geometry<dim,N> sdm_geom,
+                                    DataArray           UdataSol,
+                                    DataArray           Uaverage,
+                                    CellFlags           flags) :
+    SDMBaseFunctor<dim,N>(params,sdm_geom),
+    UdataSol(UdataSol),
+    Uaverage(Uaverage),
+    flags(flags)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams        params,
+                    SDM_Geometry<dim,N> sdm_geom,
+                    DataArray           UdataSol,
+                    DataArray           Uaverage,
+                    CellFlags           flags)
+  {
+    int64_t nbCells = dim == 2 ?
+                      params.isize * params.jsize :
+                      params.isize * params.jsize * params.ksize;
+
+    Positivity_Troubled_Cells_Functor functor(params, sdm_geom,
+                                              UdataSol, Uaverage,
+                                              flags);
+    Kokkos::parallel_for("Positivity_Troubled_Cells_Functor", nbCells, functor);
+  }
+
+  /**
+   * Is a cell troubled, given its average density and the min density /
+   * pressure over its flux points ?
+   */
+  KOKKOS_INLINE_FUNCTION
+  int is_troubled(real_t rho_ave, real_t rho_min, real_t p_min) const
+  {
+    const real_t eps1 = this->params.settings.smallr;
+    const real_t ratio = (rho_ave - eps1)/(rho_ave - rho_min) + 1e-13;
+
+    return (ratio < 1.0 or p_min < 1e-12) ? 1 : 0;
+
+  } // is_troubled
+
+  // =========================================================
+  /*
+   * 2D version.
+   */
+  // =========================================================
+  //! functor for 2d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  {
+
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+
+    const real_t gamma0 = this->params.settings.gamma0;
+
+    // local cell index
+    int i,j;
+    index2coord(index,i,j,isize,jsize);
+
+    real_t rho_min, p_min;
+#ifdef __CUDA_ARCH__
+    rho_min = CUDART_INF; // something big
+#else
+    rho_min = std::numeric_limits<real_t>::max();
+#endif
+    p_min = rho_min;
+
+    solution_values_t sol;
+    flux_values_t     flux_id;
+    flux_values_t     flux_ie;
+    flux_values_t     flux_iu;
+    flux_values_t     flux_iv;
+
+    // dir=0 : lines along X, dir=1 : lines along Y
+    for (int dir=0; dir<2; ++dir)
+    {
+      for (int l=0; l<N; ++l)
+      {
+
+        for (int n=0; n<N; ++n)
+          sol[n] = dir==0 ?
+            UdataSol(i,j, dofMapS(n,l,0,ID)) :
+            UdataSol(i,j, dofMapS(l,n,0,ID));
+        this->sol2flux_vector(sol, flux_id);
+
+        for (int n=0; n<N; ++n)
+          sol[n] = dir==0 ?
+            UdataSol(i,j, dofMapS(n,l,0,IE)) :
+            UdataSol(i,j, dofMapS(l,n,0,IE));
+        this->sol2flux_vector(sol, flux_ie);
+
+        for (int n=0; n<N; ++n)
+          sol[n] = dir==0 ?
+            UdataSol(i,j, dofMapS(n,l,0,IU)) :
+            UdataSol(i,j, dofMapS(l,n,0,IU));
+        this->sol2flux_vector(sol, flux_iu);
+
+        for (int n=0; n<N; ++n)
+          sol[n] = dir==0 ?
+            UdataSol(i,j, dofMapS(n,l,0,IV)) :
+            UdataSol(i,j, dofMapS(l,n,0,IV));
+        this->sol2flux_vector(sol, flux_iv);
+
+        for (int n=0; n<N+1; ++n)
+        {
+          const real_t rho  = flux_id[n];
+          const real_t rhou = flux_iu[n];
+          const real_t rhov = flux_iv[n];
+          const real_t E    = flux_ie[n];
+          const real_t pressure = (gamma0-1)*(E-0.5*(rhou*rhou+rhov*rhov)/rho);
+
+          rho_min = rho_min < rho      ? rho_min : rho;
+          p_min   = p_min   < pressure ? p_min   : pressure;
+        }
+
+      } // end for l
+    } // end for dir
+
+    flags(index) = is_troubled(Uaverage(i,j,ID), rho_min, p_min);
+
+  } // end operator() - 2d
+
+  // =========================================================
+  /*
+   * 3D version.
+   */
+  // =========================================================
+  //! functor for 3d
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  {
+
+    const int isize = this->params.isize;
+    const int jsize = this->params.jsize;
+    const int ksize = this->params.ksize;
+
+    const real_t gamma0 = this->params.settings.gamma0;
+
+    // local cell index
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    real_t rho_min, p_min;
+#ifdef __CUDA_ARCH__
+    rho_min = CUDART_INF; // something big
+#else
+    rho_min = std::numeric_limits<real_t>::max();
+#endif
+    p_min = rho_min;
+
+    solution_values_t sol;
+    flux_values_t     flux_id;
+    flux_values_t     flux_ie;
+    flux_values_t     flux_iu;
+    flux_values_t     flux_iv;
+    flux_values_t     flux_iw;
+
+    // dir=0 : lines along X, dir=1 : lines along Y, dir=2 : lines along Z
+    for (int dir=0; dir<3; ++dir)
+    {
+      for (int l2=0; l2<N; ++l2)
+      {
+        for (int l1=0; l1<N; ++l1)
+        {
+
+          // dof index along the line, for each variable
+          int dof[N];
+          for (int n=0; n<N; ++n)
+            dof[n] =
+              dir==0 ? dofMapS(n,l1,l2,0) :
+              dir==1 ? dofMapS(l1,n,l2,0) :
+                       dofMapS(l1,l2,n,0);
+
+          // offset between two variables
+          const int nvOffset = N*N*N;
+
+          for (int n=0; n<N; ++n)
+            sol[n] = UdataSol(i,j,k, dof[n] + ID*nvOffset);
+          this->sol2flux_vector(sol, flux_id);
+
+          for (int n=0; n<N; ++n)
+            sol[n] = UdataSol(i,j,k, dof[n] + IE*nvOffset);
+          this->sol2flux_vector(sol, flux_ie);
+
+          for (int n=0; n<N; ++n)
+            sol[n] = UdataSol(i,j,k, dof[n] + IU*nvOffset);
+          this->sol2flux_vector(sol, flux_iu);
+
+          for (int n=0; n<N; ++n)
+            sol[n] = UdataSol(i,j,k, dof[n] + IV*nvOffset);
+          this->sol2flux_vector(sol, flux_iv);
+
+          for (int n=0; n<N; ++n)
+            sol[n] = UdataSol(i,j,k, dof[n] + IW*nvOffset);
+          this->sol2flux_vector(sol, flux_iw);
+
+          for (int n=0; n<N+1; ++n)
+          {
+            const real_t rho  = flux_id[n];
+            const real_t rhou = flux_iu[n];
+            const real_t rhov = flux_iv[n];
+            const real_t rhow = flux_iw[n];
+            const real_t E    = flux_ie[n];
+            const real_t pressure =
+              (gamma0-1)*(E-0.5*(rhou*rhou+rhov*rhov+rhow*rhow)/rho);
+
+            rho_min = rho_min < rho      ? rho_min : rho;
+            p_min   = p_min   < pressure ? p_min   : pressure;
+          }
+
+        } // end for l1
+      } // end for l2
+    } // end for dir
+
+    flags(index) = is_troubled(Uaverage(i,j,k,ID), rho_min, p_min);
+
+  } // end operator() - 3d
+
+  DataArray UdataSol;
+  DataArray Uaverage;
+  CellFlags flags;
+
+}; // class Positivity_Troubled_Cells_Functor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Dilation of troubled cells marks by one cell: a cell is flagged in
+ * flags_out when it, or one of its face neighbors, is flagged in
+ * flags_in. The outer layer of cells is never flagged.
+ */
+template<int dim>
+class Dilate_Troubled_Cells_Functor
+{
+
+public:
+  Dilate_Troubled_Cells_Functor(KernelParams params,
+                                CellFlags    flags_in,
+                                CellFlags    flags_out) :
+    params(params),
+    flags_in(flags_in),
+    flags_out(flags_out)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+                    CellFlags    flags_in,
+                    CellFlags    flags_out)
+  {
+    Dilate_Troubled_Cells_Functor functor(params, flags_in, flags_out);
+    Kokkos::parallel_for("Dilate_Troubled_Cells_Functor", flags_in.extent(0), functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = dim == 3 ? params.ksize : 1;
+
+    int i,j,k=0;
+    if (dim==2)
+      index2coord(index,i,j,isize,jsize);
+    else
+      index2coord(index,i,j,k,isize,jsize,ksize);
+
+    if (i==0 or i==isize-1 or
+        j==0 or j==jsize-1 or
+        (dim==3 and (k==0 or k==ksize-1)) )
+    {
+      flags_out(index) = 0;
+      return;
+    }
+
+    int flag = flags_in(index);
+
+    if (dim==2)
+    {
+      flag |= flags_in(coord2index(i-1,j  ,isize,jsize));
+      flag |= flags_in(coord2index(i+1,j  ,isize,jsize));
+      flag |= flags_in(coord2index(i  ,j-1,isize,jsize));
+      flag |= flags_in(coord2index(i  ,j+1,isize,jsize));
+    }
+    else
+    {
+      flag |= flags_in(coord2index(i-1,j  ,k  ,isize,jsize,ksize));
+      flag |= flags_in(coord2index(i+1,j  ,k  ,isize,jsize,ksize));
+      flag |= flags_in(coord2index(i  ,j-1,k  ,isize,jsize,ksize));
+      flag |= flags_in(coord2index(i  ,j+1,k  ,isize,jsize,ksize));
+      flag |= flags_in(coord2index(i  ,j  ,k-1,isize,jsize,ksize));
+      flag |= flags_in(coord2index(i  ,j  ,k+1,isize,jsize,ksize));
+    }
+
+    flags_out(index) = flag;
+  }
+
+  KernelParams params;
+  CellFlags    flags_in;
+  CellFlags    flags_out;
+
+}; // class Dilate_Troubled_Cells_Functor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Build the compacted list of flagged cells (stream compaction through
+ * a parallel prefix sum).
+ *
+ * Flat cell indexes are stored in increasing order in list, the number
+ * of flagged cells is returned by apply.
+ */
+class Compact_Troubled_Cells_Functor
+{
+
+public:
+  Compact_Troubled_Cells_Functor(CellFlags flags,
+                                 CellList  list) :
+    flags(flags),
+    list(list)
+  {};
+
+  // static method which does it all: create and execute functor
+  static int apply(CellFlags flags,
+                   CellList  list)
+  {
+    int nbTroubled = 0;
+
+    Compact_Troubled_Cells_Functor functor(flags, list);
+    Kokkos::parallel_scan("Compact_Troubled_Cells_Functor",
+                          flags.extent(0), functor, nbTroubled);
+
+    return nbTroubled;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index, int& update, const bool& final) const
+  {
+    if (flags(index))
+    {
+      if (final)
+        list(update) = index;
+      update++;
+    }
+  }
+
+  CellFlags flags;
+  CellList  list;
+
+}; // class Compact_Troubled_Cells_Functor
+
+} // namespace sdm
+
+#endif // SDM_TROUBLED_CELLS_FUNCTORS_H_
@@ -75,7 +75,7 @@ public:
    * \param[out] UdataFlux array of viscous fluxes at flux points
    *
    */
-  ComputeViscousFluxAtFluxPoints_Functor(HydroParams                 params,
+  ComputeViscousFluxAtFluxPoints_Functor(KernelParams                params,
                                          SDM_Geometry<dim,N>         sdm_geom,
                                          ppkMHD::EulerEquations<dim> euler,
                                          DataArray                   FUgrad,
@@ -15,9 +15,10 @@
 #include "shared/SolverBase.h"
 #include "shared/HydroParams.h"
 #include "shared/kokkos_shared.h"
+#include "shared/FirstTouch.h"
+#include "shared/KernelTuner.h"
 #include "shared/mpiBorderUtils.h"
-//#include "shared/BoundariesFunctors.h"
-//#include "shared/BoundariesFunctorsWedge.h"
+#include "shared/BoundariesFunctorsWedge.h" // for WedgeInflow
 #include "shared/problems/initRiemannConfig2d.h"
 #include "shared/EulerEquations.h"
 
@@ -41,6 +42,7 @@
 #include "sdm/SDM_Boundaries_Functors_Jet.h"
 #include "sdm/SDM_Limiter_Functors.h"
 #include "sdm/SDM_Positivity_preserving.h"
+#include "sdm/SDM_Troubled_Cells_Functors.h"
 
 // for IO
 #include "utils/io/IO_ReadWrite_SDM.h"
@@ -113,6 +115,15 @@ namespace sdm
  * limiter_characteristics_enabled=true
  * in the sdm section of the ini parameter file.
  *
+ * With troubled_cells_enabled=true (default), steps 1 (gradient) to 5
+ * and the positivity preserving procedure are only performed on troubled
+ * cells: a cheap indicator marks cells (see SDM_Troubled_Cells_Functors.h),
+ * which are gathered in a compacted list before the heavy kernels are
+ * launched on that list only. The positivity indicator is exact; the
+ * limiter indicator (TVB extremum or KXRCF face jump, dilated by one
+ * cell) is not an exact superset of the cells a sweep over all cells
+ * would limit. Set troubled_cells_enabled=false to sweep all cells.
+ *
  * If viscous terms computation is enabled, we need
  * - Ugrax_v, Ugrady_v (and Ugradz_v) allocated;
  *   these arrays are used to store velocity gradients at soluton points.
@@ -121,6 +132,13 @@ namespace sdm
  *
  * If thermal_diffusivity_terms_enabled, temperature gradients need to be stored.
  *
+ * Viscous (and thermal diffusivity) terms are integrated with the
+ * hyperbolic ones by default, in which case the time step is limited by
+ * their explicit stability constraint (dt ~ dx^2 / nu). With
+ * rkl2_enabled=true (sdm section), they are split from the hyperbolic
+ * part (Strang splitting) and integrated with the RKL2 super-time-stepping
+ * scheme, so that the time step is only limited by the CFL condition.
+ *
  */
 template<int dim, int N>
 class SolverHydroSDM : public ppkMHD::SolverBase
@@ -181,6 +199,14 @@ public:
   DataArray     Ugrady; /*! used if limiting is enabled, cell-averaged gradient, y component */
   DataArray     Ugradz; /*! used if limiting is enabled, cell-averaged gradient, z component */
 
+  /*
+   * troubled cells (limiter / positivity preserving are only applied
+   * on a compacted list of cells)
+   */
+  CellFlags     troubled_flags; /*! per cell troubled flag */
+  CellFlags     troubled_marks; /*! limiter indicator marks, before dilation */
+  CellList      troubled_list;  /*! compacted list of troubled cells */
+
   /*
    * viscous terms specific array
    */
@@ -193,10 +219,27 @@ public:
   //! Runge-Kutta temporary array (will be allocated only if necessary)
   DataArray     U_RK1, U_RK2, U_RK3, U_RK4;
 
+  //! RKL2 super-time-stepping temporary arrays (allocated only if necessary):
+  //! two stages and the viscous fluxes divergence at the first stage
+  DataArray     U_STS1, U_STS2, U_STS_fdiv0;
+
   //! fluxes : intermediate array containing fluxes, used in
   //! compute_fluxes_divergence_per_dir
   DataArray Fluxes;
 
+  /**
+   * Phases of the flux divergence computation, used to declare the
+   * lifetime of the transient arrays allocated in m_workspace.
+   */
+  enum StepPhase {
+    PHASE_PRE_STEP,           //!< cell averages
+    PHASE_LIMITING,           //!< limiter (cell-averaged gradients)
+    PHASE_POSITIVITY,         //!< positivity preserving
+    PHASE_INVISCID,           //!< inviscid fluxes
+    PHASE_VELOCITY_GRADIENTS, //!< velocity gradients at solution points
+    PHASE_VISCOUS             //!< viscous fluxes
+  };
+
   /*
    * Override base class method to initialize IO writer object
    */
@@ -218,6 +261,9 @@ public:
   //! compute time step inside an MPI process, at shared memory level.
   double compute_dt_local();
 
+  //! explicit time step constraint of the viscous terms, inside an MPI process
+  double compute_dt_viscous_local();
+
   //! perform 1 time step (time integration).
   void next_iteration_impl();
 
@@ -295,10 +341,21 @@ public:
                         DataArray Udata_fdiv,
                         real_t dt);
 
+  //! compute viscous fluxes divergence only (velocity gradients + viscous
+  //! fluxes); Udata_fdiv is erased first
+  void compute_viscous_fluxes_divergence(DataArray Udata,
+                                         DataArray Udata_fdiv,
+                                         real_t    dt);
+
+  //! integrate viscous terms only over dt, using RKL2 super-time-stepping
+  void time_int_rkl2_viscous(DataArray Udata,
+                             DataArray Udata_fdiv,
+                             real_t dt);
+
   //! erase a solution data array
   void erase(DataArray data, bool isFlux=false);
 
-  //! avoid override the base class make_boundary method
+  //! fill the ghost cells of a single face
   template<FaceIdType faceId>
   void make_boundary_sdm(DataArray  Udata,
                          bool       mhd_enabled);
@@ -313,6 +370,9 @@ public:
   void make_boundary_sdm_jet(DataArray   Udata,
                              JetParams   jparams);
 
+  //! fill the ghost cells of range (see BoundaryEngine), all border conditions at once
+  void fill_ghost_cells(DataArray Udata, ppkMHD::BoundaryEngine::Range range);
+
   //! main boundaries routine (this is were serial / mpi switch happens)
   void make_boundaries(DataArray Udata);
 
@@ -359,9 +419,23 @@ public:
   //! positivity preserving (density + pressure)
   bool positivity_enabled;
 
+  //! only apply limiter / positivity preserving on troubled cells
+  bool troubled_cells_enabled;
+
+  //! number of troubled cells found during last call to
+  //! apply_limiting / apply_positivity_preserving
+  int nb_troubled_limiter;
+  int nb_troubled_positivity;
+
   //! viscous terms
   bool viscous_terms_enabled;
 
+  //! integrate viscous terms separately, with RKL2 super-time-stepping
+  bool rkl2_enabled;
+
+  //! number of RKL2 stages used in the last super-step
+  int rkl2_nb_stages;
+
   //! thermal diffusivity terms : kappa * rho * cp * gradient(T)
   bool thermal_diffusivity_terms_enabled;
 
@@ -394,7 +468,12 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
   limiter_enabled(false),
   limiter_characteristics_enabled(false),
   positivity_enabled(false),
+  troubled_cells_enabled(false),
+  nb_troubled_limiter(0),
+  nb_troubled_positivity(0),
   viscous_terms_enabled(false),
+  rkl2_enabled(false),
+  rkl2_nb_stages(0),
   thermal_diffusivity_terms_enabled(false),
   isize(params.isize),
   jsize(params.jsize),
@@ -419,6 +498,10 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
 
   long long int total_mem_size = 0;
 
+  // allocation and first touch time, reported below
+  Timer alloc_timer;
+  alloc_timer.start();
+
   // clear variables_names map -- hydro only, for now (MHD later)
   m_variables_names.clear();
   m_variables_names[ID] = "rho";
@@ -447,11 +530,10 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
   if (dim==2)
   {
 
-    U     = DataArray("U", isize, jsize, nb_dof);
-    Uhost = Kokkos::create_mirror(U);
-    Uaux  = DataArray("Uaux",isize, jsize, nb_dof);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize, jsize, nb_dof);
+    Uaux  = allocate_first_touch<DataArray>("Uaux", nbCells, isize, jsize, nb_dof);
 
-    Fluxes = DataArray("Fluxes", isize, jsize, nb_dof_flux);
+    m_workspace.declare("Fluxes", Fluxes, PHASE_INVISCID, PHASE_VISCOUS, isize, jsize, nb_dof_flux);
 
     total_mem_size += isize*jsize*nb_dof      * sizeof(real_t); // U
     total_mem_size += isize*jsize*nb_dof      * sizeof(real_t); // Uaux
@@ -461,11 +543,10 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
   else if (dim==3)
   {
 
-    U     = DataArray("U", isize, jsize, ksize, nb_dof);
-    Uhost = Kokkos::create_mirror(U);
-    Uaux  = DataArray("Uaux",isize, jsize, ksize, nb_dof);
+    U     = allocate_first_touch<DataArray>("U", nbCells, isize, jsize, ksize, nb_dof);
+    Uaux  = allocate_first_touch<DataArray>("Uaux", nbCells, isize, jsize, ksize, nb_dof);
 
-    Fluxes = DataArray("Fluxes", isize, jsize, ksize, nb_dof_flux);
+    m_workspace.declare("Fluxes", Fluxes, PHASE_INVISCID, PHASE_VISCOUS, isize, jsize, ksize, nb_dof_flux);
 
     total_mem_size += isize*jsize*ksize*nb_dof      * sizeof(real_t); // U
     total_mem_size += isize*jsize*ksize*nb_dof      * sizeof(real_t); // Uaux
@@ -490,17 +571,40 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
   // rescale dt to make time order "match" space order ?
   rescale_dt_enabled    = configMap.getBool("sdm", "rescale_dt_enabled", false);
 
+  // viscous terms integrated apart, with super-time-stepping ?
+  rkl2_enabled = viscous_terms_enabled and configMap.getBool("sdm", "rkl2_enabled", false);
+
+  if (rkl2_enabled)
+  {
+
+    if (dim == 2)
+    {
+      U_STS1      = allocate_first_touch<DataArray>("U_STS1", nbCells, isize, jsize, nb_dof);
+      U_STS2      = allocate_first_touch<DataArray>("U_STS2", nbCells, isize, jsize, nb_dof);
+      U_STS_fdiv0 = allocate_first_touch<DataArray>("U_STS_fdiv0", nbCells, isize, jsize, nb_dof);
+      total_mem_size += isize*jsize*nb_dof * 3 * sizeof(real_t);
+    }
+    else if (dim == 3)
+    {
+      U_STS1      = allocate_first_touch<DataArray>("U_STS1", nbCells, isize, jsize, ksize, nb_dof);
+      U_STS2      = allocate_first_touch<DataArray>("U_STS2", nbCells, isize, jsize, ksize, nb_dof);
+      U_STS_fdiv0 = allocate_first_touch<DataArray>("U_STS_fdiv0", nbCells, isize, jsize, ksize, nb_dof);
+      total_mem_size += isize*jsize*ksize*nb_dof * 3 * sizeof(real_t);
+    }
+
+  }
+
   if (ssprk2_enabled)
   {
 
     if (dim == 2)
     {
-      U_RK1 = DataArray("U_RK1",isize, jsize, nb_dof);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, nb_dof);
       total_mem_size += isize*jsize*nb_dof * sizeof(real_t);
     }
     else if (dim == 3)
     {
-      U_RK1 = DataArray("U_RK1",isize, jsize, ksize, nb_dof);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, ksize, nb_dof);
       total_mem_size += isize*jsize*ksize*nb_dof * sizeof(real_t);
     }
 
@@ -510,14 +614,14 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
 
     if (dim == 2)
     {
-      U_RK1 = DataArray("U_RK1",isize, jsize, nb_dof);
-      U_RK2 = DataArray("U_RK2",isize, jsize, nb_dof);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, nb_dof);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, nb_dof);
       total_mem_size += isize*jsize*nb_dof * 2 * sizeof(real_t);
     }
     else if (dim == 3)
     {
-      U_RK1 = DataArray("U_RK1",isize, jsize, ksize, nb_dof);
-      U_RK2 = DataArray("U_RK2",isize, jsize, ksize, nb_dof);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, ksize, nb_dof);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, ksize, nb_dof);
       total_mem_size += isize*jsize*ksize*nb_dof * 2 * sizeof(real_t);
     }
 
@@ -527,18 +631,18 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
 
     if (dim == 2)
     {
-      U_RK1 = DataArray("U_RK1",isize, jsize, nb_dof);
-      U_RK2 = DataArray("U_RK2",isize, jsize, nb_dof);
-      U_RK3 = DataArray("U_RK3",isize, jsize, nb_dof);
-      U_RK4 = DataArray("U_RK4",isize, jsize, nb_dof);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, nb_dof);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, nb_dof);
+      U_RK3 = allocate_first_touch<DataArray>("U_RK3", nbCells, isize, jsize, nb_dof);
+      U_RK4 = allocate_first_touch<DataArray>("U_RK4", nbCells, isize, jsize, nb_dof);
       total_mem_size += isize*jsize*nb_dof * 4 * sizeof(real_t);
     }
     else if (dim == 3)
     {
-      U_RK1 = DataArray("U_RK1",isize, jsize, ksize, nb_dof);
-      U_RK2 = DataArray("U_RK2",isize, jsize, ksize, nb_dof);
-      U_RK3 = DataArray("U_RK3",isize, jsize, ksize, nb_dof);
-      U_RK4 = DataArray("U_RK4",isize, jsize, ksize, nb_dof);
+      U_RK1 = allocate_first_touch<DataArray>("U_RK1", nbCells, isize, jsize, ksize, nb_dof);
+      U_RK2 = allocate_first_touch<DataArray>("U_RK2", nbCells, isize, jsize, ksize, nb_dof);
+      U_RK3 = allocate_first_touch<DataArray>("U_RK3", nbCells, isize, jsize, ksize, nb_dof);
+      U_RK4 = allocate_first_touch<DataArray>("U_RK4", nbCells, isize, jsize, ksize, nb_dof);
       total_mem_size += isize*jsize*ksize*nb_dof * 4 * sizeof(real_t);
     }
 
@@ -563,15 +667,15 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
     // memory allocation to store velocity gradients at solution points
     if (dim==2)
     {
-      Ugradx_v   = DataArray("Ugradx_v",isize,jsize,nb_components);
-      Ugrady_v   = DataArray("Ugrady_v",isize,jsize,nb_components);
+      m_workspace.declare("Ugradx_v", Ugradx_v, PHASE_VELOCITY_GRADIENTS, PHASE_VISCOUS, isize,jsize,nb_components);
+      m_workspace.declare("Ugrady_v", Ugrady_v, PHASE_VELOCITY_GRADIENTS, PHASE_VISCOUS, isize,jsize,nb_components);
       total_mem_size += isize*jsize*nb_components * 2 * sizeof(real_t);
     }
     else if (dim==3)
     {
-      Ugradx_v   = DataArray("Ugradx_v",isize,jsize,ksize,nb_components);
-      Ugrady_v   = DataArray("Ugrady_v",isize,jsize,ksize,nb_components);
-      Ugradz_v   = DataArray("Ugradz_v",isize,jsize,ksize,nb_components);
+      m_workspace.declare("Ugradx_v", Ugradx_v, PHASE_VELOCITY_GRADIENTS, PHASE_VISCOUS, isize,jsize,ksize,nb_components);
+      m_workspace.declare("Ugrady_v", Ugrady_v, PHASE_VELOCITY_GRADIENTS, PHASE_VISCOUS, isize,jsize,ksize,nb_components);
+      m_workspace.declare("Ugradz_v", Ugradz_v, PHASE_VELOCITY_GRADIENTS, PHASE_VISCOUS, isize,jsize,ksize,nb_components);
       total_mem_size += isize*jsize*ksize*nb_components * 3 * sizeof(real_t);
     }
 
@@ -583,9 +687,9 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
 
     // memory allocation for FUgrad
     if (dim==2)
-      FUgrad = DataArray("FUgrad", isize, jsize,        nb_flux_pts*nb_components_FUgrad);
+      m_workspace.declare("FUgrad", FUgrad, PHASE_VISCOUS, PHASE_VISCOUS, isize, jsize,        nb_flux_pts*nb_components_FUgrad);
     else
-      FUgrad = DataArray("FUgrad", isize, jsize, ksize, nb_flux_pts*nb_components_FUgrad);
+      m_workspace.declare("FUgrad", FUgrad, PHASE_VISCOUS, PHASE_VISCOUS, isize, jsize, ksize, nb_flux_pts*nb_components_FUgrad);
 
   }
 
@@ -603,15 +707,15 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
     // memory allocation to store cell-averaged gradient components
     if (dim==2)
     {
-      Ugradx   = DataArray("Ugradx",isize,jsize,params.nbvar);
-      Ugrady   = DataArray("Ugrady",isize,jsize,params.nbvar);
+      m_workspace.declare("Ugradx", Ugradx, PHASE_LIMITING, PHASE_LIMITING, isize,jsize,params.nbvar);
+      m_workspace.declare("Ugrady", Ugrady, PHASE_LIMITING, PHASE_LIMITING, isize,jsize,params.nbvar);
       total_mem_size += isize*jsize*params.nbvar * 2 * sizeof(real_t);
     }
     else if (dim==3)
     {
-      Ugradx   = DataArray("Ugradx",isize,jsize,ksize,params.nbvar);
-      Ugrady   = DataArray("Ugrady",isize,jsize,ksize,params.nbvar);
-      Ugradz   = DataArray("Ugradz",isize,jsize,ksize,params.nbvar);
+      m_workspace.declare("Ugradx", Ugradx, PHASE_LIMITING, PHASE_LIMITING, isize,jsize,ksize,params.nbvar);
+      m_workspace.declare("Ugrady", Ugrady, PHASE_LIMITING, PHASE_LIMITING, isize,jsize,ksize,params.nbvar);
+      m_workspace.declare("Ugradz", Ugradz, PHASE_LIMITING, PHASE_LIMITING, isize,jsize,ksize,params.nbvar);
       total_mem_size += isize*jsize*ksize*params.nbvar * 3 * sizeof(real_t);
     }
 
@@ -631,17 +735,75 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
 
     if (dim==2)
     {
-      Uaverage = DataArray("Uaverage",isize,jsize,params.nbvar);
+      m_workspace.declare("Uaverage", Uaverage, PHASE_PRE_STEP, PHASE_POSITIVITY, isize,jsize,params.nbvar);
       total_mem_size += isize*jsize*params.nbvar * 1 * sizeof(real_t);
     }
     else if (dim==3)
     {
-      Uaverage = DataArray("Uaverage",isize,jsize,ksize,params.nbvar);
+      m_workspace.declare("Uaverage", Uaverage, PHASE_PRE_STEP, PHASE_POSITIVITY, isize,jsize,ksize,params.nbvar);
       total_mem_size += isize*jsize*ksize*params.nbvar * 1 * sizeof(real_t);
     }
 
   }
 
+  /*
+   * troubled cells : flags and compacted list (shared by limiter
+   * and positivity preserving)
+   */
+  troubled_cells_enabled = configMap.getBool("sdm", "troubled_cells_enabled", true);
+
+  if ( (positivity_enabled or limiter_enabled) and troubled_cells_enabled)
+  {
+
+    troubled_flags = CellFlags("troubled_flags", nbCells);
+    troubled_list  = CellList ("troubled_list",  nbCells);
+    total_mem_size += nbCells * 2 * sizeof(int);
+
+    if (limiter_enabled)
+    {
+      troubled_marks = CellFlags("troubled_marks", nbCells);
+      total_mem_size += nbCells * sizeof(int);
+    }
+
+  }
+
+  /*
+   * transient arrays (fluxes, gradients, cell averages): arrays which
+   * are not used in the same phase of compute_fluxes_divergence share
+   * memory, see Workspace.h
+   */
+  m_workspace.allocate(nbCells);
+
+  alloc_timer.stop();
+
+  /*
+   * ghost cells list: wedge (2D) and jet have their own border conditions
+   */
+  {
+    using namespace ppkMHD;
+
+    GhostFaces faces = GhostFaces::from_params(params);
+
+    if (dim==2 and !m_problem_name.compare("wedge"))
+    {
+      faces.set(FACE_XMIN, GHOST_NEUMANN,        true);
+      faces.set(FACE_XMAX, GHOST_NEUMANN_MIRROR);
+      faces.set(FACE_YMIN, GHOST_DIRICHLET,      true);
+      faces.set(FACE_YMAX, GHOST_NEUMANN,        true);
+    }
+    else if (!m_problem_name.compare("jet"))
+    {
+      faces.set(FACE_XMIN, GHOST_NEUMANN, true);
+      faces.set(FACE_XMAX, dim==2 ? GHOST_NEUMANN_MIRROR : GHOST_NEUMANN);
+      faces.set(FACE_YMIN, GHOST_NEUMANN);
+      faces.set(FACE_YMAX, GHOST_NEUMANN);
+      faces.set(FACE_ZMIN, GHOST_NEUMANN);
+      faces.set(FACE_ZMAX, GHOST_NEUMANN);
+    }
+
+    m_boundary_engine.init(params, faces);
+  }
+
   /*
    * initialize hydro array at t=0
    */
@@ -782,12 +944,16 @@ SolverHydroSDM<dim,N>::SolverHydroSDM(HydroParams& params,
     std::cout << "SSPRK2        : " << ssprk2_enabled << "\n";
     std::cout << "SSPRK3        : " << ssprk3_enabled << "\n";
     std::cout << "SSPRK54       : " << ssprk54_enabled << "\n";
+    std::cout << "RKL2 (viscous): " << rkl2_enabled << "\n";
     std::cout << "##########################" << "\n";
 
     // print parameters on screen
     params.print();
     std::cout << "##########################" << "\n";
     std::cout << "Memory requested : " << (total_mem_size / 1e6) << " MBytes\n";
+    std::cout << "Allocation + first touch : " << alloc_timer.elapsed() << " s ("
+              << Device().concurrency() << " " << Device::name() << " threads)\n";
+    m_workspace.print_info();
     std::cout << "##########################" << "\n";
   }
 
@@ -879,7 +1045,7 @@ double SolverHydroSDM<dim,N>::compute_dt_local()
     ComputeDt_Functor_3d<N>>::type;
 
   // call device functor
-  invDt = ComputeDtFunctor::apply(params, sdm_geom, euler, Udata);
+  invDt = ComputeDtFunctor::apply(kernel_params, sdm_geom, euler, Udata);
 
   dt = params.settings.cfl/invDt;
 
@@ -887,10 +1053,36 @@ double SolverHydroSDM<dim,N>::compute_dt_local()
   if (rescale_dt_enabled and N >= 2 and (ssprk3_enabled or ssprk54_enabled))
     dt = pow(dt, (N+1.0)/3.0);
 
+  // viscous terms integrated together with the hyperbolic ones must
+  // satisfy their own explicit constraint
+  if (viscous_terms_enabled and !rkl2_enabled)
+    dt = FMIN(dt, (real_t) compute_dt_viscous_local());
+
   return dt;
 
 } // SolverHydroSDM::compute_dt_local
 
+// =======================================================
+// =======================================================
+/**
+ * Compute the explicit (forward Euler) time step constraint of the
+ * viscous and thermal diffusivity terms.
+ *
+ * \return dt time step (local to current MPI process)
+ */
+template<int dim, int N>
+double SolverHydroSDM<dim,N>::compute_dt_viscous_local()
+{
+
+  real_t invDt = ComputeDtViscous_Functor<dim,N>::apply(kernel_params, sdm_geom, U);
+
+  if (invDt <= 0)
+    return m_tEnd;
+
+  return params.settings.cfl/invDt;
+
+} // SolverHydroSDM::compute_dt_viscous_local
+
 // =======================================================
 // =======================================================
 template<int dim, int N>
@@ -901,12 +1093,33 @@ void SolverHydroSDM<dim,N>::next_iteration_impl()
 #ifdef USE_MPI
   myRank = params.myRank;
 #endif // USE_MPI
+
+  // number of troubled cells (last Runge-Kutta stage of previous time step)
+  int nb_troubled[2] = {nb_troubled_limiter, nb_troubled_positivity};
+  const bool log_troubled = troubled_cells_enabled and
+                            (limiter_enabled or positivity_enabled) and
+                            m_iteration > 0;
+#ifdef USE_MPI
+  if (log_troubled and m_iteration % params.nlog == 0)
+  {
+    int nb_troubled_local[2] = {nb_troubled[0], nb_troubled[1]};
+    params.communicator->allReduce(nb_troubled_local, nb_troubled, 2,
+                                   hydroSimu::MpiComm::INT,
+                                   hydroSimu::MpiComm::SUM);
+  }
+#endif // USE_MPI
+
   if (myRank==0)
   {
     if (m_iteration % params.nlog == 0)
     {
       //printf("time step=%7d (dt=% 10.8f t=% 10.8f)\n",m_iteration,m_dt, m_t);
       printf("time   step=%7d (dt=% 10.8g t=% 10.8f)\n",m_iteration,m_dt, m_t);
+      if (log_troubled)
+        printf("troubled cells : limiter=%d positivity=%d\n",
+               nb_troubled[0], nb_troubled[1]);
+      if (rkl2_enabled and m_iteration > 0)
+        printf("RKL2 stages    : %d\n", rkl2_nb_stages);
     }
   }
 
@@ -925,7 +1138,9 @@ void SolverHydroSDM<dim,N>::next_iteration_impl()
 
   // compute new dt
   timers[TIMER_DT]->start();
+  Kokkos::Profiling::pushRegion("compute_dt");
   compute_dt();
+  Kokkos::Profiling::popRegion();
   timers[TIMER_DT]->stop();
 
   // perform one step integration
@@ -959,11 +1174,22 @@ void SolverHydroSDM<dim,N>::time_integration_impl(DataArray Udata,
 
   // fill ghost cell in Udata
   timers[TIMER_BOUNDARIES]->start();
+  Kokkos::Profiling::pushRegion("boundaries");
   make_boundaries(Udata);
+  Kokkos::Profiling::popRegion();
   timers[TIMER_BOUNDARIES]->stop();
 
   // start main computation
   timers[TIMER_NUM_SCHEME]->start();
+  Kokkos::Profiling::pushRegion("num_scheme");
+
+  // Strang splitting: viscous terms over dt/2, hyperbolic terms over dt,
+  // viscous terms over dt/2
+  if (rkl2_enabled)
+  {
+    time_int_rkl2_viscous(Udata, Udata_fdiv, dt/2);
+    make_boundaries(Udata);
+  }
 
   if (ssprk2_enabled)
   {
@@ -990,6 +1216,13 @@ void SolverHydroSDM<dim,N>::time_integration_impl(DataArray Udata,
 
   }
 
+  if (rkl2_enabled)
+  {
+    make_boundaries(Udata);
+    time_int_rkl2_viscous(Udata, Udata_fdiv, dt/2);
+  }
+
+  Kokkos::Profiling::popRegion();
   timers[TIMER_NUM_SCHEME]->stop();
 
 } // SolverHydroSDM::time_integration_impl
@@ -1006,7 +1239,7 @@ void SolverHydroSDM<dim,N>::apply_pre_step_computation(DataArray Udata)
   {
 
     // compute Uaverage
-    Average_Conservative_Variables_Functor<dim,N>::apply(params,
+    Average_Conservative_Variables_Functor<dim,N>::apply(kernel_params,
         sdm_geom,
         Udata,
         Uaverage);
@@ -1023,10 +1256,38 @@ void SolverHydroSDM<dim,N>::apply_positivity_preserving(DataArray Udata)
 
   if (positivity_enabled)
   {
-    Apply_positivity_Functor_v2<dim,N>::apply(params,
-        sdm_geom,
-        Udata,
-        Uaverage);
+
+    if (troubled_cells_enabled)
+    {
+
+      // mark cells where density or pressure needs to be fixed
+      Positivity_Troubled_Cells_Functor<dim,N>::apply(kernel_params,
+          sdm_geom,
+          Udata,
+          Uaverage,
+          troubled_flags);
+
+      nb_troubled_positivity =
+        Compact_Troubled_Cells_Functor::apply(troubled_flags, troubled_list);
+
+      Apply_positivity_Functor_v2<dim,N>::apply(kernel_params,
+          sdm_geom,
+          Udata,
+          Uaverage,
+          troubled_list,
+          nb_troubled_positivity);
+
+    }
+    else
+    {
+
+      Apply_positivity_Functor_v2<dim,N>::apply(kernel_params,
+          sdm_geom,
+          Udata,
+          Uaverage);
+
+    }
+
   }
 
 } // SolverHydroSDM<dim,N>::apply_positivity_preserving
@@ -1041,7 +1302,7 @@ void SolverHydroSDM<dim,N>::apply_limiting(DataArray Udata)
   // cell average values
   // if (limiter_enabled) {
   //   // compute Umin / Umax
-  //   MinMax_Conservative_Variables_Functor<dim,N>::apply(params,
+  //   MinMax_Conservative_Variables_Functor<dim,N>::apply(kernel_params,
   //                                                       sdm_geom,
   //                                                       Uaverage,
   //                                                       Umin,
@@ -1049,24 +1310,86 @@ void SolverHydroSDM<dim,N>::apply_limiting(DataArray Udata)
   //                                                       0);
   // }
 
-  if (limiter_enabled)
+  if (limiter_enabled and troubled_cells_enabled)
+  {
+
+    // retrieve parameter M_TVB (used in the modified minmod routine)
+    real_t M_TVB = configMap.getFloat("sdm","M_TVB",40);
+    const real_t Mdx2 = M_TVB;
+
+    // we assume here that Uaverage has been computed in routine apply_pre_step_computation
+    // mark cells that may need limiting, dilate the marks by one cell,
+    // and build their list
+    Limiter_Troubled_Cells_Functor<dim,N>::apply(kernel_params,
+        sdm_geom,
+        Udata,
+        Uaverage,
+        troubled_marks,
+        Mdx2);
+
+    Dilate_Troubled_Cells_Functor<dim>::apply(kernel_params,
+        troubled_marks,
+        troubled_flags);
+
+    nb_troubled_limiter =
+      Compact_Troubled_Cells_Functor::apply(troubled_flags, troubled_list);
+
+    // cell-average gradient components and limiting, troubled cells only
+    Average_Gradient_Functor<dim,N,IX>::apply(kernel_params,
+        sdm_geom,
+        Udata,
+        Ugradx,
+        troubled_list,
+        nb_troubled_limiter);
+
+    Average_Gradient_Functor<dim,N,IY>::apply(kernel_params,
+        sdm_geom,
+        Udata,
+        Ugrady,
+        troubled_list,
+        nb_troubled_limiter);
+
+    if (dim == 3)
+    {
+      Average_Gradient_Functor<dim,N,IZ>::apply(kernel_params,
+          sdm_geom,
+          Udata,
+          Ugradz,
+          troubled_list,
+          nb_troubled_limiter);
+    }
+
+    Apply_limiter_Functor<dim,N>::apply(kernel_params,
+                                        sdm_geom,
+                                        euler,
+                                        Udata,
+                                        Uaverage,
+                                        Ugradx,
+                                        Ugrady,
+                                        Ugradz,
+                                        Mdx2,
+                                        troubled_list,
+                                        nb_troubled_limiter);
+
+  }
+  else if (limiter_enabled)
   {
 
     // we assume here that Uaverage has been computed in routine apply_pre_step_computation
     // we just need to compute cell-average gradient component.
-    Average_Gradient_Functor<dim,N,IX>::apply(params,
+    Average_Gradient_Functor<dim,N,IX>::apply(kernel_params,
         sdm_geom,
         Udata,
         Ugradx);
 
-    Average_Gradient_Functor<dim,N,IY>::apply(params,
+    Average_Gradient_Functor<dim,N,IY>::apply(kernel_params,
         sdm_geom,
         Udata,
         Ugrady);
 
     if (dim == 3)
     {
-      Average_Gradient_Functor<dim,N,IZ>::apply(params,
+      Average_Gradient_Functor<dim,N,IZ>::apply(kernel_params,
           sdm_geom,
           Udata,
           Ugradz);
@@ -1078,7 +1401,7 @@ void SolverHydroSDM<dim,N>::apply_limiting(DataArray Udata)
     //const real_t Mdx2 = M_TVB * dx * dx;
     const real_t Mdx2 = M_TVB;
 
-    Apply_limiter_Functor<dim,N>::apply(params,
+    Apply_limiter_Functor<dim,N>::apply(kernel_params,
                                         sdm_geom,
                                         euler,
                                         Udata,
@@ -1108,19 +1431,19 @@ void SolverHydroSDM<dim,N>::compute_invicid_fluxes_divergence_per_dir(DataArray
     return;
 
   // 1. interpolate conservative variables from solution points to flux points
-  Interpolate_At_FluxPoints_Functor<dim,N,dir>::apply(params,
+  Interpolate_At_FluxPoints_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       Udata,
       Fluxes);
 
   // 2. inplace computation of fluxes along direction <dir> at flux points
-  ComputeFluxAtFluxPoints_Functor<dim,N,dir>::apply(params,
+  ComputeFluxAtFluxPoints_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       euler,
       Fluxes);
 
   // 3. compute derivative and accumulate in Udata_fdiv
-  Interpolate_At_SolutionPoints_Functor<dim,N,dir>::apply(params,
+  Interpolate_At_SolutionPoints_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       Fluxes,
       Udata_fdiv);
@@ -1146,29 +1469,29 @@ void SolverHydroSDM<dim,N>::compute_viscous_fluxes_divergence_per_dir(DataArray
   // 1. interpolate all velocity components from solution to
   //    flux points in the given direction
   //    this will fill components IGU, IGV, IGW of FUgrad
-  Interpolate_velocities_Sol2Flux_Functor<dim,N,dir>::apply(params,
+  Interpolate_velocities_Sol2Flux_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       Udata,
       FUgrad);
 
   // 2. average velocity at cell borders
-  Average_component_at_cell_borders_Functor<dim,N,dir>::apply(params,
+  Average_component_at_cell_borders_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       FUgrad);
 
   // 3.1. interpolate velocity gradients-x from solution points to flux points
   Interpolate_velocity_gradients_Sol2Flux_Functor<dim,N,dir,IX>
-  ::apply(params, sdm_geom, Ugradx_v, FUgrad);
+  ::apply(kernel_params, sdm_geom, Ugradx_v, FUgrad);
 
   // 3.2. interpolate velocity gradients-y from solution points to flux points
   Interpolate_velocity_gradients_Sol2Flux_Functor<dim,N,dir,IY>
-  ::apply(params, sdm_geom, Ugrady_v, FUgrad);
+  ::apply(kernel_params, sdm_geom, Ugrady_v, FUgrad);
 
   // 3.3. interpolate velocity gradients-z from solution points to flux points
   if (dim==3)
   {
     Interpolate_velocity_gradients_Sol2Flux_Functor<dim,N,dir,IZ>
-    ::apply(params, sdm_geom, Ugradz_v, FUgrad);
+    ::apply(kernel_params, sdm_geom, Ugradz_v, FUgrad);
   }
 
   // 4. average velocity gradients at cell border
@@ -1198,24 +1521,24 @@ void SolverHydroSDM<dim,N>::compute_viscous_fluxes_divergence_per_dir(DataArray
       var_index[8] = (int) VarIndexGrad3d::IGWZ;
     }
 
-    Average_component_at_cell_borders_Functor<dim,N,dir> functor(params,
+    Average_component_at_cell_borders_Functor<dim,N,dir> functor(kernel_params,
         sdm_geom,
         FUgrad,
         nvar_to_average,
         var_index);
-    Kokkos::parallel_for(nbCells, functor);
+    Kokkos::parallel_for("Average_component_at_cell_borders_Functor", nbCells, functor);
   }
 
   // 5.1 Now one can compute viscous fluxes at flux points
   {
-    ComputeViscousFluxAtFluxPoints_Functor<dim,N,dir> functor(params, sdm_geom, euler, FUgrad, Fluxes);
-    Kokkos::parallel_for(nbCells, functor);
+    ComputeViscousFluxAtFluxPoints_Functor<dim,N,dir> functor(kernel_params, sdm_geom, euler, FUgrad, Fluxes);
+    ppkMHD::parallel_for_tuned("ComputeViscousFluxAtFluxPoints_Functor", nbCells, functor);
   }
 
   // 5.2 Finally compute derivative and accumulate (with negative sign) in Udata_fdiv
   {
-    Interpolate_At_SolutionPoints_Functor<dim,N,dir,INTERPOLATE_DERIVATIVE_NEGATIVE> functor(params, sdm_geom, FUgrad, Udata_fdiv);
-    Kokkos::parallel_for(nbCells, functor);
+    Interpolate_At_SolutionPoints_Functor<dim,N,dir,INTERPOLATE_DERIVATIVE_NEGATIVE> functor(kernel_params, sdm_geom, FUgrad, Udata_fdiv);
+    ppkMHD::parallel_for_tuned("Interpolate_At_SolutionPoints_Functor", nbCells, functor);
   }
 
 } // SolverHydroSDM<dim,N>::compute_viscous_fluxes_divergence_per_dir
@@ -1238,20 +1561,20 @@ void SolverHydroSDM<dim,N>::compute_velocity_gradients(DataArray Udata, DataArra
   //
 
   // 1. interpolate velocity from solution points to flux points
-  Interpolate_velocities_Sol2Flux_Functor<dim,N,dir>::apply(params,
+  Interpolate_velocities_Sol2Flux_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       Udata,
       Fluxes);
 
   // 2. average velocity at cell borders
-  Average_component_at_cell_borders_Functor<dim,N,dir>::apply(params,
+  Average_component_at_cell_borders_Functor<dim,N,dir>::apply(kernel_params,
       sdm_geom,
       Fluxes);
 
   // 3. compute derivative along direction <dir> at solution points
   //    using derivative of Lagrange polynomial
   Interp_grad_velocity_at_SolutionPoints_Functor<dim,N,dir>
-  ::apply(params, sdm_geom, Fluxes, Ugrad);
+  ::apply(kernel_params, sdm_geom, Fluxes, Ugrad);
 
 } // SolverHydroSDM<dim,N>::compute_velocity_gradients
 
@@ -1279,30 +1602,40 @@ void SolverHydroSDM<dim,N>::compute_fluxes_divergence(DataArray Udata,
   //  3. compute viscous flux + source terms
   //  4. evaluate flux derivatives at solution points and accumulate in Udata_fdiv
 
+  Kokkos::Profiling::pushRegion("fluxes");
+
   // erase Udata_fdiv
   erase(Udata_fdiv);
 
+  m_workspace.begin_phase(PHASE_PRE_STEP);
   apply_pre_step_computation(Udata);
 
+  m_workspace.begin_phase(PHASE_LIMITING);
   apply_limiting(Udata);
 
+  m_workspace.begin_phase(PHASE_POSITIVITY);
   apply_positivity_preserving(Udata);
 
+  m_workspace.begin_phase(PHASE_INVISCID);
   compute_invicid_fluxes_divergence_per_dir<IX>(Udata, Udata_fdiv, dt);
   compute_invicid_fluxes_divergence_per_dir<IY>(Udata, Udata_fdiv, dt);
   compute_invicid_fluxes_divergence_per_dir<IZ>(Udata, Udata_fdiv, dt);
 
-  if (viscous_terms_enabled)
+  if (viscous_terms_enabled and !rkl2_enabled)
   {
+    m_workspace.begin_phase(PHASE_VELOCITY_GRADIENTS);
     compute_velocity_gradients<IX>(Udata, Ugradx_v); // results are stored in Ugradx_v
     compute_velocity_gradients<IY>(Udata, Ugrady_v); // results are stored in Ugrady_v
     compute_velocity_gradients<IZ>(Udata, Ugradz_v); // results are stored in Ugradz_v
 
+    m_workspace.begin_phase(PHASE_VISCOUS);
     compute_viscous_fluxes_divergence_per_dir<IX>(Udata, Udata_fdiv, dt);
     compute_viscous_fluxes_divergence_per_dir<IY>(Udata, Udata_fdiv, dt);
     compute_viscous_fluxes_divergence_per_dir<IZ>(Udata, Udata_fdiv, dt);
   }
 
+  Kokkos::Profiling::popRegion();
+
 } // SolverHydroSDM<dim,N>::compute_fluxes_divergence
 
 // =======================================================
@@ -1323,7 +1656,9 @@ void SolverHydroSDM<dim,N>::time_int_forward_euler(DataArray Udata,
   // translated into Udata = 1.0*Udata + 0.0*Udata - dt * Udata_fdiv
   {
     coefs_t coefs = {1.0, 0.0, -1.0};
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, Udata, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, Udata, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
 } // SolverHydroSDM::time_int_forward_euler
@@ -1363,7 +1698,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk2(DataArray Udata,
   // perform actual time update : U_RK1 = 1.0 * U_{n} + 0.0 * U_{n} - dt * Udata_fdiv
   {
     coefs_t coefs = {1.0, 0.0, -1.0};
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK1, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK1, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ================================================================
@@ -1375,7 +1712,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk2(DataArray Udata,
 
   {
     coefs_t coefs= {0.5, 0.5, -0.5};
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, Udata, Udata, U_RK1, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, Udata, Udata, U_RK1, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
 } // SolverHydroSDM::time_int_ssprk2
@@ -1417,7 +1756,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk3(DataArray Udata,
   // perform : U_RK1 = 1.0 * U_{n} + 0.0 * U_{n} - dt * Udata_fdiv
   {
     coefs_t coefs = {1.0, 0.0, -1.0};
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK1, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK1, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ==============================================================
@@ -1428,7 +1769,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk3(DataArray Udata,
   compute_fluxes_divergence(U_RK1, Udata_fdiv, dt);
   {
     coefs_t coefs = {0.75, 0.25, -0.25};
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK2, Udata, U_RK1, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK2, Udata, U_RK1, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ================================================================
@@ -1439,7 +1782,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk3(DataArray Udata,
   compute_fluxes_divergence(U_RK2, Udata_fdiv, dt);
   {
     coefs_t coefs = {1.0/3, 2.0/3, -2.0/3};
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, Udata, Udata, U_RK2, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, Udata, Udata, U_RK2, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
 } // SolverHydroSDM::time_int_ssprk3
@@ -1502,7 +1847,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk54(DataArray Udata,
                            rk54_coef[0][1],
                            rk54_coef[0][2]
                           };
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK1, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK1, Udata, Udata, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ===============================================
@@ -1519,7 +1866,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk54(DataArray Udata,
                            rk54_coef[1][1],
                            rk54_coef[1][2]
                           };
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK2, Udata, U_RK1, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK2, Udata, U_RK1, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ===============================================
@@ -1536,7 +1885,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk54(DataArray Udata,
                            rk54_coef[2][1],
                            rk54_coef[2][2]
                           };
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK3, Udata, U_RK2, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK3, Udata, U_RK2, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ===============================================
@@ -1553,7 +1904,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk54(DataArray Udata,
                            rk54_coef[3][1],
                            rk54_coef[3][2]
                           };
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, U_RK4, Udata, U_RK3, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, U_RK4, Udata, U_RK3, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   // ===============================================
@@ -1564,7 +1917,9 @@ void SolverHydroSDM<dim,N>::time_int_ssprk54(DataArray Udata,
                            rk54_coef[4][1],
                            rk54_coef[4][2]
                           };
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, Udata, U_RK2, U_RK3, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, Udata, U_RK2, U_RK3, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
 
@@ -1578,20 +1933,161 @@ void SolverHydroSDM<dim,N>::time_int_ssprk54(DataArray Udata,
                            rk54_coef[5][1],
                            rk54_coef[5][2]
                           };
-    SDM_Update_RK_Functor<dim,N>::apply(params, sdm_geom, Udata, Udata, U_RK4, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RK_Functor<dim,N>::apply(kernel_params, sdm_geom, Udata, Udata, U_RK4, Udata_fdiv, coefs, dt);
+    Kokkos::Profiling::popRegion();
   }
 
   //std::cout << "SSP-RK54 is currently partially implemented\n";
 
 } // SolverHydroSDM::time_int_ssprk54
 
+// =======================================================
+// =======================================================
+template<int dim, int N>
+void SolverHydroSDM<dim,N>::compute_viscous_fluxes_divergence(DataArray Udata,
+    DataArray Udata_fdiv,
+    real_t dt)
+{
+
+  Kokkos::Profiling::pushRegion("viscous_fluxes");
+
+  // erase Udata_fdiv
+  erase(Udata_fdiv);
+
+  m_workspace.begin_phase(PHASE_VELOCITY_GRADIENTS);
+  compute_velocity_gradients<IX>(Udata, Ugradx_v);
+  compute_velocity_gradients<IY>(Udata, Ugrady_v);
+  compute_velocity_gradients<IZ>(Udata, Ugradz_v);
+
+  m_workspace.begin_phase(PHASE_VISCOUS);
+  compute_viscous_fluxes_divergence_per_dir<IX>(Udata, Udata_fdiv, dt);
+  compute_viscous_fluxes_divergence_per_dir<IY>(Udata, Udata_fdiv, dt);
+  compute_viscous_fluxes_divergence_per_dir<IZ>(Udata, Udata_fdiv, dt);
+
+  Kokkos::Profiling::popRegion();
+
+} // SolverHydroSDM<dim,N>::compute_viscous_fluxes_divergence
+
+// =======================================================
+// =======================================================
+// ///////////////////////////////////////////
+// RKL2 super-time-stepping (viscous terms)
+// ///////////////////////////////////////////
+/**
+ * Runge-Kutta-Legendre super-time-stepping, 2nd order, for the viscous
+ * (parabolic) terms only.
+ *
+ * See C.D. Meyer, D.S. Balsara, T.D. Aslam, "A stabilized Runge-Kutta-
+ * Legendre method for explicit super-time-stepping of parabolic and mixed
+ * equations", Journal of Computational Physics, 257, 594-626 (2014).
+ *
+ * A super-step of s stages is stable for
+ * dt <= dt_FE * (s^2 + s - 2) / 4
+ * where dt_FE is the forward Euler (explicit) viscous time step, so the
+ * number of operator evaluations grows like sqrt(dt/dt_FE) instead of
+ * dt/dt_FE.
+ *
+ * Stages are stored in U_STS1 / U_STS2, the operator evaluated at the
+ * beginning of the super-step in U_STS_fdiv0; the last stage is written
+ * in Udata.
+ */
+template<int dim, int N>
+void SolverHydroSDM<dim,N>::time_int_rkl2_viscous(DataArray Udata,
+    DataArray Udata_fdiv,
+    real_t dt)
+{
+
+  using coefs5_t = typename SDM_Update_RKL2_Functor<dim,N>::coefs_t;
+
+  // explicit viscous time step (global)
+  double dt_fe = compute_dt_viscous_local();
+#ifdef USE_MPI
+  {
+    double dt_fe_local = dt_fe;
+    params.communicator->allReduce(&dt_fe_local, &dt_fe, 1,
+                                   hydroSimu::MpiComm::DOUBLE,
+                                   hydroSimu::MpiComm::MIN);
+  }
+#endif // USE_MPI
+
+  // number of stages
+  int s = (int) ceil( 0.5 * (sqrt(9.0 + 16.0 * dt / dt_fe) - 1.0) );
+  if (s < 2)
+    s = 2;
+  rkl2_nb_stages = s;
+
+  // b_j coefficients (b_0 = b_1 = b_2)
+  auto b = [](int j) -> double
+  {
+    if (j < 2)
+      j = 2;
+    return (j*j + j - 2.0) / (2.0*j*(j+1));
+  };
+
+  const double w1 = 4.0 / (s*s + s - 2.0);
+
+  // ===============================================
+  // stage 1 : Y_1 = Y_0 - mu_1 * dt * div_fluxes(Y_0)
+  // ===============================================
+  compute_viscous_fluxes_divergence(Udata, U_STS_fdiv0, dt);
+
+  {
+    const coefs5_t coefs = {1.0, 0.0, 0.0, -b(1)*w1, 0.0};
+    Kokkos::Profiling::pushRegion("update");
+    SDM_Update_RKL2_Functor<dim,N>::apply(kernel_params, sdm_geom, U_STS1,
+                                          Udata, Udata, Udata,
+                                          U_STS_fdiv0, U_STS_fdiv0,
+                                          coefs, dt);
+    Kokkos::Profiling::popRegion();
+  }
+
+  // ===============================================
+  // stages j=2..s :
+  // Y_j = mu_j Y_{j-1} + nu_j Y_{j-2} + (1-mu_j-nu_j) Y_0
+  //       - mu_j w1 dt div_fluxes(Y_{j-1})
+  //       + a_{j-1} mu_j w1 dt div_fluxes(Y_0)
+  // ===============================================
+  DataArray Yjm2 = Udata;
+  DataArray Yjm1 = U_STS1;
+
+  for (int j=2; j<=s; ++j)
+  {
+
+    const double mu  = (2.0*j-1)/j * b(j)/b(j-1);
+    const double nu  = -(j-1.0)/j  * b(j)/b(j-2);
+    const double a   = 1.0 - b(j-1);
+
+    // Y_j may overwrite Y_{j-2} (point-wise update), except Y_0
+    DataArray Yj = (j == s) ? Udata : ((j == 2) ? U_STS2 : Yjm2);
+
+    make_boundaries(Yjm1);
+    compute_viscous_fluxes_divergence(Yjm1, Udata_fdiv, dt);
+
+    {
+      const coefs5_t coefs = {1.0-mu-nu, mu, nu, a*mu*w1, -mu*w1};
+      Kokkos::Profiling::pushRegion("update");
+      SDM_Update_RKL2_Functor<dim,N>::apply(kernel_params, sdm_geom, Yj,
+                                            Udata, Yjm1, Yjm2,
+                                            U_STS_fdiv0, Udata_fdiv,
+                                            coefs, dt);
+      Kokkos::Profiling::popRegion();
+    }
+
+    Yjm2 = Yjm1;
+    Yjm1 = Yj;
+
+  } // end for j
+
+} // SolverHydroSDM::time_int_rkl2_viscous
+
 // =======================================================
 // =======================================================
 template<int dim, int N>
 void SolverHydroSDM<dim,N>::erase(DataArray data, bool isFlux)
 {
 
-  SDM_Erase_Functor<dim,N>::apply(params, sdm_geom, data, isFlux);
+  SDM_Erase_Functor<dim,N>::apply(kernel_params, sdm_geom, data, isFlux);
 
 } // SolverHydroSDM<dim,N>::erase
 
@@ -1615,7 +2111,7 @@ void SolverHydroSDM<dim,N>::make_boundary_sdm(DataArray   Udata,
     nbIter = ghostWidth * max_size * max_size;
   }
 
-  MakeBoundariesFunctor_SDM<dim,N,faceId>::apply(params, sdm_geom, Udata, nbIter);
+  MakeBoundariesFunctor_SDM<dim,N,faceId>::apply(kernel_params, sdm_geom, Udata, nbIter);
 
 } // SolverHydroSDM<dim,N>::make_boundary_sdm
 
@@ -1637,7 +2133,7 @@ void SolverHydroSDM<dim,N>::make_boundary_sdm_wedge(DataArray   Udata,
     nbIter = ghostWidth * max_size * max_size;
   }
 
-  MakeBoundariesFunctor_SDM_Wedge<dim,N,faceId>::apply(params, sdm_geom, wparams, Udata, nbIter);
+  MakeBoundariesFunctor_SDM_Wedge<dim,N,faceId>::apply(kernel_params, sdm_geom, wparams, Udata, nbIter);
 
 } // SolverHydroSDM<dim,N>::make_boundary_sdm_wedge
 
@@ -1659,10 +2155,49 @@ void SolverHydroSDM<dim,N>::make_boundary_sdm_jet(DataArray   Udata,
     nbIter = ghostWidth * max_size * max_size;
   }
 
-  MakeBoundariesFunctor_SDM_Jet<dim,N,faceId>::apply(params, sdm_geom, jparams, Udata, nbIter);
+  MakeBoundariesFunctor_SDM_Jet<dim,N,faceId>::apply(kernel_params, sdm_geom, jparams, Udata, nbIter);
 
 } // SolverHydroSDM<dim,N>::make_boundary_sdm_jet
 
+// =======================================================
+// =======================================================
+template<int dim, int N>
+void SolverHydroSDM<dim,N>::fill_ghost_cells(DataArray Udata,
+                                             ppkMHD::BoundaryEngine::Range range)
+{
+
+  // wedge and jet impose states on some faces
+  if (dim==2 and !m_problem_name.compare("wedge"))
+  {
+
+    WedgeParams wparams(configMap, m_t);
+
+    FillGhostCellsFunctor_SDM<dim,N,WedgeInflow>::apply(kernel_params, sdm_geom,
+                                                        m_boundary_engine, range,
+                                                        Udata, WedgeInflow(wparams, true));
+
+  }
+  else if (!m_problem_name.compare("jet"))
+  {
+
+    JetParams jparams(configMap);
+
+    FillGhostCellsFunctor_SDM<dim,N,JetInflow<dim>>::apply(kernel_params, sdm_geom,
+                                                           m_boundary_engine, range,
+                                                           Udata, JetInflow<dim>(jparams));
+
+  }
+  else
+  {
+
+    FillGhostCellsFunctor_SDM<dim,N>::apply(kernel_params, sdm_geom,
+                                            m_boundary_engine, range,
+                                            Udata);
+
+  }
+
+} // SolverHydroSDM<dim,N>::fill_ghost_cells
+
 // =======================================================
 // =======================================================
 // //////////////////////////////////////////////////
@@ -1694,60 +2229,9 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_serial(DataArray Udata,
     bool mhd_enabled)
 {
 
-  /*
-   * deal with special cases
-   */
-
-  // wedge has a different border condition
-  if (dim==2 and !m_problem_name.compare("wedge"))
-  {
-
-    WedgeParams wparams(configMap, m_t);
-
-    make_boundary_sdm_wedge<FACE_XMIN>(Udata, wparams);
-    make_boundary_sdm_wedge<FACE_XMAX>(Udata, wparams);
-    make_boundary_sdm_wedge<FACE_YMIN>(Udata, wparams);
-    make_boundary_sdm_wedge<FACE_YMAX>(Udata, wparams);
-
-  }
-  else if (!m_problem_name.compare("jet"))
-  {
-
-    JetParams jparams(configMap);
-
-    make_boundary_sdm_jet<FACE_XMIN>(Udata, jparams);
-    make_boundary_sdm_jet<FACE_XMAX>(Udata, jparams);
-    make_boundary_sdm_jet<FACE_YMIN>(Udata, jparams);
-    make_boundary_sdm_jet<FACE_YMAX>(Udata, jparams);
-
-    if (dim==3)
-    {
-      make_boundary_sdm_jet<FACE_ZMIN>(Udata, jparams);
-      make_boundary_sdm_jet<FACE_ZMAX>(Udata, jparams);
-    }
-
-  }
-  else
-  {
-
-    /*
-     * General case
-     */
-
-    make_boundary_sdm<FACE_XMIN>(Udata, mhd_enabled);
-    make_boundary_sdm<FACE_XMAX>(Udata, mhd_enabled);
-    make_boundary_sdm<FACE_YMIN>(Udata, mhd_enabled);
-    make_boundary_sdm<FACE_YMAX>(Udata, mhd_enabled);
-
-    if (dim==3)
-    {
-
-      make_boundary_sdm<FACE_ZMIN>(Udata, mhd_enabled);
-      make_boundary_sdm<FACE_ZMAX>(Udata, mhd_enabled);
-
-    }
+  UNUSED(mhd_enabled);
 
-  }
+  fill_ghost_cells(Udata, m_boundary_engine.all());
 
 } // SolverHydroSDM<dim,N>::make_boundaries_sdm_serial
 
@@ -1761,6 +2245,8 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_mpi(DataArray Udata,
 
   using namespace hydroSimu;
 
+  UNUSED(mhd_enabled);
+
   // for each direction:
   // 1. copy boundary to MPI buffer
   // 2. send/recv buffer
@@ -1780,20 +2266,15 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_mpi(DataArray Udata,
     {
       copy_boundaries_back(Udata, XMIN);
     }
-    else
-    {
-      make_boundary_sdm<FACE_XMIN>(Udata, mhd_enabled);
-    }
 
     if (params.neighborsBC[X_MAX] == BC_COPY ||
         params.neighborsBC[X_MAX] == BC_PERIODIC)
     {
       copy_boundaries_back(Udata, XMAX);
     }
-    else
-    {
-      make_boundary_sdm<FACE_XMAX>(Udata, mhd_enabled);
-    }
+
+    // faces of this direction filled by border conditions
+    fill_ghost_cells(Udata, m_boundary_engine.direction(IX));
 
     params.communicator->synchronize();
 
@@ -1808,20 +2289,15 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_mpi(DataArray Udata,
     {
       copy_boundaries_back(Udata, YMIN);
     }
-    else
-    {
-      make_boundary_sdm<FACE_YMIN>(Udata, mhd_enabled);
-    }
 
     if (params.neighborsBC[Y_MAX] == BC_COPY ||
         params.neighborsBC[Y_MAX] == BC_PERIODIC)
     {
       copy_boundaries_back(Udata, YMAX);
     }
-    else
-    {
-      make_boundary_sdm<FACE_YMAX>(Udata, mhd_enabled);
-    }
+
+    // faces of this direction filled by border conditions
+    fill_ghost_cells(Udata, m_boundary_engine.direction(IY));
 
     params.communicator->synchronize();
 
@@ -1840,20 +2316,15 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_mpi(DataArray Udata,
     {
       copy_boundaries_back(Udata, XMIN);
     }
-    else
-    {
-      make_boundary_sdm<FACE_XMIN>(Udata, mhd_enabled);
-    }
 
     if (params.neighborsBC[X_MAX] == BC_COPY ||
         params.neighborsBC[X_MAX] == BC_PERIODIC)
     {
       copy_boundaries_back(Udata, XMAX);
     }
-    else
-    {
-      make_boundary_sdm<FACE_XMAX>(Udata, mhd_enabled);
-    }
+
+    // faces of this direction filled by border conditions
+    fill_ghost_cells(Udata, m_boundary_engine.direction(IX));
 
     params.communicator->synchronize();
 
@@ -1868,20 +2339,15 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_mpi(DataArray Udata,
     {
       copy_boundaries_back(Udata, YMIN);
     }
-    else
-    {
-      make_boundary_sdm<FACE_YMIN>(Udata, mhd_enabled);
-    }
 
     if (params.neighborsBC[Y_MAX] == BC_COPY ||
         params.neighborsBC[Y_MAX] == BC_PERIODIC)
     {
       copy_boundaries_back(Udata, YMAX);
     }
-    else
-    {
-      make_boundary_sdm<FACE_YMAX>(Udata, mhd_enabled);
-    }
+
+    // faces of this direction filled by border conditions
+    fill_ghost_cells(Udata, m_boundary_engine.direction(IY));
 
     params.communicator->synchronize();
 
@@ -1896,20 +2362,15 @@ void SolverHydroSDM<dim,N>::make_boundaries_sdm_mpi(DataArray Udata,
     {
       copy_boundaries_back(Udata, ZMIN);
     }
-    else
-    {
-      make_boundary_sdm<FACE_ZMIN>(Udata, mhd_enabled);
-    }
 
     if (params.neighborsBC[Z_MAX] == BC_COPY ||
         params.neighborsBC[Z_MAX] == BC_PERIODIC)
     {
       copy_boundaries_back(Udata, ZMAX);
     }
-    else
-    {
-      make_boundary_sdm<FACE_ZMAX>(Udata, mhd_enabled);
-    }
+
+    // faces of this direction filled by border conditions
+    fill_ghost_cells(Udata, m_boundary_engine.direction(IZ));
 
     params.communicator->synchronize();
 
@@ -1931,7 +2392,7 @@ template<int dim, int N>
 void SolverHydroSDM<dim,N>::init_sod(DataArray Udata)
 {
 
-  InitSodFunctor<dim,N>::apply(params, sdm_geom, Udata);
+  InitSodFunctor<dim,N>::apply(kernel_params, sdm_geom, Udata);
 
 } // init_sod
 
@@ -1947,7 +2408,7 @@ void SolverHydroSDM<dim,N>::init_implode(DataArray Udata)
 
   ImplodeParams iParams = ImplodeParams(configMap);
 
-  InitImplodeFunctor<dim,N>::apply(params, sdm_geom, iParams, Udata);
+  InitImplodeFunctor<dim,N>::apply(kernel_params, sdm_geom, iParams, Udata);
 } // init_implode
 
 // =======================================================
@@ -1962,7 +2423,7 @@ void SolverHydroSDM<dim,N>::init_blast(DataArray Udata)
 
   BlastParams blastParams = BlastParams(configMap);
 
-  InitBlastFunctor<dim,N>::apply(params, sdm_geom, blastParams, Udata);
+  InitBlastFunctor<dim,N>::apply(kernel_params, sdm_geom, blastParams, Udata);
 
 } // SolverHydroSDM::init_blast
 
@@ -1991,7 +2452,7 @@ void SolverHydroSDM<dim,N>::init_four_quadrant(DataArray Udata)
   ppkMHD::primToCons_2D(U2, params.settings.gamma0);
   ppkMHD::primToCons_2D(U3, params.settings.gamma0);
 
-  InitFourQuadrantFunctor<dim,N>::apply(params, sdm_geom,
+  InitFourQuadrantFunctor<dim,N>::apply(kernel_params, sdm_geom,
                                         Udata,
                                         U0, U1, U2, U3,
                                         xt, yt);
@@ -2010,7 +2471,7 @@ void SolverHydroSDM<dim,N>::init_kelvin_helmholtz(DataArray Udata)
 
   KHParams khParams = KHParams(configMap);
 
-  InitKelvinHelmholtzFunctor<dim,N>::apply(params,
+  InitKelvinHelmholtzFunctor<dim,N>::apply(kernel_params,
       sdm_geom,
       khParams,
       Udata);
@@ -2029,7 +2490,7 @@ void SolverHydroSDM<dim,N>::init_gresho_vortex(DataArray Udata)
 
   GreshoParams gvParams = GreshoParams(configMap);
 
-  InitGreshoVortexFunctor<dim,N>::apply(params,
+  InitGreshoVortexFunctor<dim,N>::apply(kernel_params,
                                         sdm_geom,
                                         gvParams,
                                         Udata);
@@ -2048,7 +2509,7 @@ void SolverHydroSDM<dim,N>::init_wedge(DataArray Udata)
 
   WedgeParams wparams(configMap, 0.0);
 
-  InitWedgeFunctor<dim,N>::apply(params, sdm_geom, wparams, Udata);
+  InitWedgeFunctor<dim,N>::apply(kernel_params, sdm_geom, wparams, Udata);
 
 } // init_wedge
 
@@ -2064,7 +2525,7 @@ void SolverHydroSDM<dim,N>::init_jet(DataArray Udata)
 
   JetParams jparams(configMap);
 
-  InitJetFunctor<dim,N>::apply(params, sdm_geom, jparams, Udata);
+  InitJetFunctor<dim,N>::apply(kernel_params, sdm_geom, jparams, Udata);
 
 } // init_jet
 
@@ -2081,7 +2542,7 @@ void SolverHydroSDM<dim,N>::init_isentropic_vortex(DataArray Udata)
 
   IsentropicVortexParams iparams(configMap);
 
-  InitIsentropicVortexFunctor<dim,N>::apply(params, sdm_geom, iparams, Udata);
+  InitIsentropicVortexFunctor<dim,N>::apply(kernel_params, sdm_geom, iparams, Udata);
 } // init_isentropic_vortex
 
 // =======================================================
@@ -2096,7 +2557,7 @@ template<int dim, int N>
 void SolverHydroSDM<dim,N>::init_shu_osher(DataArray Udata)
 {
 
-  InitShuOsherFunctor<dim,N>::apply(params, sdm_geom, Udata);
+  InitShuOsherFunctor<dim,N>::apply(kernel_params, sdm_geom, Udata);
 
 } // init_shu_osher
 
@@ -2107,9 +2568,12 @@ void SolverHydroSDM<dim,N>::save_solution_impl()
 {
 
   timers[TIMER_IO]->start();
+  Kokkos::Profiling::pushRegion("io");
 
+  allocate_host_mirror(U, Uhost);
   save_data(U,  Uhost, m_times_saved, m_t);
 
+  Kokkos::Profiling::popRegion();
   timers[TIMER_IO]->stop();
 
 } // SolverHydroSDM::save_solution_impl()
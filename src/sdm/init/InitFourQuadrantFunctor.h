@@ -27,7 +27,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  InitFourQuadrantFunctor(HydroParams params,
+  InitFourQuadrantFunctor(KernelParams params,
 			  SDM_Geometry<dim,N> sdm_geom,
 			  DataArray Udata,
 			  HydroState2d U0,
@@ -41,7 +41,7 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata,
                     HydroState2d        U0,
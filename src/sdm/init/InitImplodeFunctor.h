@@ -27,7 +27,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
   
-  InitImplodeFunctor(HydroParams         params,
+  InitImplodeFunctor(KernelParams        params,
 		     SDM_Geometry<dim,N> sdm_geom,
 		     ImplodeParams       iparams,
 		     DataArray           Udata) :
@@ -36,7 +36,7 @@ public:
     Udata(Udata) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     ImplodeParams       iparams,
                     DataArray           Udata)
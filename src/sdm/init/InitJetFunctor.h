@@ -39,7 +39,7 @@ public:
   
   static constexpr auto dofMap = DofMap<dim,N>;
   
-  InitJetFunctor(HydroParams params,
+  InitJetFunctor(KernelParams params,
 		 SDM_Geometry<dim,N> sdm_geom,
 		 JetParams   jparams,
 		 DataArray   Udata) :
@@ -51,7 +51,7 @@ public:
   ~InitJetFunctor() {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     JetParams           jParams,
                     DataArray           Udata)
@@ -30,7 +30,7 @@ public:
 
   static constexpr auto dofMap = DofMap<dim,N>;
 
-  InitKelvinHelmholtzFunctor(HydroParams         params,
+  InitKelvinHelmholtzFunctor(KernelParams        params,
 			     SDM_Geometry<dim,N> sdm_geom,
 			     KHParams            khParams,
 			     DataArray           Udata) :
@@ -41,7 +41,7 @@ public:
   {};
   
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     KHParams            khParams,
                     DataArray           Udata)
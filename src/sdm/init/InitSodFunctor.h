@@ -25,14 +25,14 @@ public:
   
   static constexpr auto dofMap = DofMap<dim,N>;
   
-  InitSodFunctor(HydroParams         params,
+  InitSodFunctor(KernelParams        params,
                  SDM_Geometry<dim,N> sdm_geom,
                  DataArray           Udata) :
     SDMBaseFunctor<dim,N>(params,sdm_geom),
     Udata(Udata) {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     DataArray           Udata)
   {
@@ -34,7 +34,7 @@ public:
   
   static constexpr auto dofMap = DofMap<dim,N>;
   
-  InitWedgeFunctor(HydroParams params,
+  InitWedgeFunctor(KernelParams params,
 		   SDM_Geometry<dim,N> sdm_geom,
 		   WedgeParams wparams,
 		   DataArray   Udata) :
@@ -46,7 +46,7 @@ public:
   ~InitWedgeFunctor() {};
 
   // static method which does it all: create and execute functor
-  static void apply(HydroParams         params,
+  static void apply(KernelParams        params,
                     SDM_Geometry<dim,N> sdm_geom,
                     WedgeParams         wParams,
                     DataArray           Udata)
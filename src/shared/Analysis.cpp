@@ -0,0 +1,781 @@
+#include "shared/Analysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+namespace ppkMHD
+{
+
+// =======================================================
+// =======================================================
+/**
+ * Open the output file of an analysis plugin (rank 0 only, nullptr on
+ * other ranks); a restart run appends to the existing file.
+ */
+static FILE* analysis_open_file(HydroParams& params,
+                                ConfigMap& configMap,
+                                const std::string& name)
+{
+
+  int myRank = 0;
+#ifdef USE_MPI
+  myRank = params.myRank;
+#else
+  UNUSED(params);
+#endif // USE_MPI
+
+  if (myRank != 0)
+    return nullptr;
+
+  std::string outputDir    = configMap.getString("output", "outputDir", "./");
+  std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+  std::string filename = outputDir + "/" + outputPrefix + "_" + name + ".txt";
+
+  const bool restart = configMap.getInteger("run", "restart_enabled", 0) != 0;
+
+  FILE* file = fopen(filename.c_str(), restart ? "a" : "w");
+
+  if (file == nullptr)
+    std::cerr << "Analysis: unable to open " << filename << ", no output for " << name << "\n";
+
+  return file;
+
+} // analysis_open_file
+
+// =======================================================
+// ==== CLASS AnalysisManager IMPL =======================
+// =======================================================
+
+// =======================================================
+// =======================================================
+AnalysisManager::AnalysisManager(HydroParams& params, ConfigMap& configMap) :
+  params(params),
+  m_plugins()
+{
+
+  std::string plugins = configMap.getString("analysis", "plugins", "");
+  std::istringstream stream(plugins);
+  std::string name;
+
+  while (std::getline(stream, name, ','))
+  {
+    // remove blanks
+    name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+    if (name.empty())
+      continue;
+
+    const std::string type = configMap.getString("analysis_" + name, "type", name);
+
+    auto it = types().find(type);
+    if (it == types().end())
+    {
+      std::cerr << "Analysis: unknown plugin type " << type << " (" << name << "), ignored\n";
+      continue;
+    }
+
+    add(it->second(params, configMap, name));
+  }
+
+} // AnalysisManager::AnalysisManager
+
+// =======================================================
+// =======================================================
+void
+AnalysisManager::add(std::shared_ptr<AnalysisPlugin> plugin)
+{
+
+  if (plugin)
+    m_plugins.push_back(plugin);
+
+} // AnalysisManager::add
+
+// =======================================================
+// =======================================================
+void
+AnalysisManager::add_callback(const std::string& name, int nstep,
+                              AnalysisCallback::Callback2d callback_2d,
+                              AnalysisCallback::Callback3d callback_3d)
+{
+
+  add(std::make_shared<AnalysisCallback>(name, nstep, callback_2d, callback_3d));
+
+} // AnalysisManager::add_callback
+
+// =======================================================
+// =======================================================
+template<class DataArray>
+void
+AnalysisManager::run_impl(DataArray Udata, int iteration, double time)
+{
+
+  AnalysisContext context {iteration, time, params
+#ifdef USE_MPI
+      , params.communicator
+#endif // USE_MPI
+      };
+
+  for (auto& plugin : m_plugins)
+  {
+    if (!plugin->is_due(iteration))
+      continue;
+
+    Kokkos::Profiling::pushRegion("analysis_" + plugin->name());
+    plugin->apply(Udata, context);
+    Kokkos::Profiling::popRegion();
+  }
+
+} // AnalysisManager::run_impl
+
+// =======================================================
+// =======================================================
+void
+AnalysisManager::run(DataArray2d Udata, int iteration, double time)
+{
+
+  run_impl(Udata, iteration, time);
+
+} // AnalysisManager::run
+
+// =======================================================
+// =======================================================
+void
+AnalysisManager::run(DataArray3d Udata, int iteration, double time)
+{
+
+  run_impl(Udata, iteration, time);
+
+} // AnalysisManager::run
+
+// =======================================================
+// =======================================================
+void
+AnalysisManager::register_type(const std::string& type, Creator creator)
+{
+
+  types()[type] = creator;
+
+} // AnalysisManager::register_type
+
+// =======================================================
+// =======================================================
+std::map<std::string, AnalysisManager::Creator>&
+AnalysisManager::types()
+{
+
+  // built-in plugins
+  static std::map<std::string, Creator> registry =
+    {
+      {"pdf",      &AnalysisPDF::create},
+      {"spectrum", &AnalysisSpectrum::create}
+    };
+
+  return registry;
+
+} // AnalysisManager::types
+
+// =======================================================
+// ==== CLASS AnalysisPDF IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+AnalysisPDF::AnalysisPDF(HydroParams& params,
+                         ConfigMap& configMap,
+                         const std::string& name) :
+  AnalysisPlugin(name, configMap.getInteger("analysis_" + name, "nstep", 10)),
+  m_variable(ANALYSIS_DENSITY),
+  m_nbins(64),
+  m_log(true),
+  m_min(0),
+  m_max(0),
+  m_file(nullptr)
+{
+
+  const std::string section = "analysis_" + name;
+
+  const std::string variable = configMap.getString(section, "variable", "density");
+  if (variable == "mach")
+  {
+    m_variable = ANALYSIS_MACH;
+  }
+  else if (variable != "density")
+  {
+    std::cerr << "AnalysisPDF: unknown variable " << variable << ", using density\n";
+  }
+
+  const bool density = m_variable == ANALYSIS_DENSITY;
+
+  m_nbins = std::max(1, configMap.getInteger(section, "nbins", 64));
+  m_log   = configMap.getBool(section, "log", density);
+  m_min   = configMap.getFloat(section, "min", density ? 1e-3 : 0.0);
+  m_max   = configMap.getFloat(section, "max", density ? 1e3 : 10.0);
+
+  if (m_log)
+  {
+    m_min = log10(std::max(m_min, (real_t) 1e-30));
+    m_max = log10(std::max(m_max, (real_t) 1e-30));
+  }
+
+  if (m_max <= m_min)
+  {
+    std::cerr << "AnalysisPDF: empty range for " << name << ", using [0,1]\n";
+    m_min = 0;
+    m_max = 1;
+  }
+
+  m_hist      = AnalysisBinArray("analysis_pdf", m_nbins+1);
+  m_hist_host = Kokkos::create_mirror_view(m_hist);
+
+  m_file = analysis_open_file(params, configMap, name);
+
+} // AnalysisPDF::AnalysisPDF
+
+// =======================================================
+// =======================================================
+AnalysisPDF::~AnalysisPDF()
+{
+
+  if (m_file)
+    fclose(m_file);
+
+} // AnalysisPDF::~AnalysisPDF
+
+// =======================================================
+// =======================================================
+template<int dim>
+void
+AnalysisPDF::apply_impl(typename AnalysisHistogramFunctor<dim>::DataArray Udata,
+                        const AnalysisContext& context)
+{
+
+  HydroParams& params = context.params;
+
+  const real_t width = (m_max - m_min) / m_nbins;
+
+  Kokkos::deep_copy(m_hist, 0.0);
+  AnalysisHistogramFunctor<dim>::apply(params, Udata, m_hist, m_variable,
+                                       params.mhdEnabled, m_log, m_min, 1/width);
+  Kokkos::deep_copy(m_hist_host, m_hist);
+
+  std::vector<double> counts(m_hist_host.data(), m_hist_host.data() + m_nbins+1);
+
+#ifdef USE_MPI
+  {
+    std::vector<double> local(counts);
+    context.communicator->allReduce(local.data(), counts.data(), m_nbins+1,
+                                    hydroSimu::MpiComm::DOUBLE, hydroSimu::MpiComm::SUM);
+  }
+#endif // USE_MPI
+
+  if (m_file == nullptr)
+    return;
+
+  double total = 0;
+  for (double c : counts)
+    total += c;
+
+  fprintf(m_file, "# iteration %d time %.10e cells %.0f out_of_range %.0f\n",
+          context.iteration, context.time, total, counts[m_nbins]);
+  fprintf(m_file, "# %s%s pdf count\n",
+          m_log ? "log10_" : "",
+          m_variable == ANALYSIS_MACH ? "mach" : "density");
+
+  for (int b = 0; b < m_nbins; ++b)
+  {
+    const double center = m_min + (b + 0.5) * width;
+    const double pdf = total > 0 ? counts[b] / (total * width) : 0.0;
+    fprintf(m_file, "%.6e %.6e %.0f\n", center, pdf, counts[b]);
+  }
+
+  fprintf(m_file, "\n\n");
+  fflush(m_file);
+
+} // AnalysisPDF::apply_impl
+
+// =======================================================
+// =======================================================
+void
+AnalysisPDF::apply(DataArray2d Udata, const AnalysisContext& context)
+{
+
+  apply_impl<2>(Udata, context);
+
+} // AnalysisPDF::apply
+
+// =======================================================
+// =======================================================
+void
+AnalysisPDF::apply(DataArray3d Udata, const AnalysisContext& context)
+{
+
+  apply_impl<3>(Udata, context);
+
+} // AnalysisPDF::apply
+
+// =======================================================
+// ==== CLASS AnalysisSpectrum IMPL ======================
+// =======================================================
+
+// =======================================================
+// =======================================================
+/**
+ * Distribution of a 3D index space (sizes E, x fastest) over the MPI
+ * processes, as stored in line arrays (local index line * stride +
+ * position):
+ * - axis < 0: the cartesian sub-domains of the run (sizes n, m per
+ *   direction), lines along x;
+ * - axis >= 0: whole lines along axis, numbered with the lower of the
+ *   other two directions fastest, process r holding lines
+ *   first_line(r) to first_line(r+1)-1.
+ */
+struct AnalysisLayout
+{
+  int E[3];
+  int axis;
+  int stride;
+  int nProcs;
+
+  //! sub-domain sizes, number of sub-domains per direction
+  int n[3];
+  int m[3];
+
+  //! rank of sub-domain px + m0*(py + m1*pz), and the reverse
+  std::vector<int> rank_of_block;
+  std::vector<int> block_of_rank;
+
+  long long nLines;
+
+  long long first_line(int rank) const
+  {
+    return nLines * rank / nProcs;
+  }
+
+  long long line(const int* c) const
+  {
+    if (axis == 0)
+      return c[1] + (long long) E[1]*c[2];
+    if (axis == 1)
+      return c[0] + (long long) E[0]*c[2];
+    return c[0] + (long long) E[0]*c[1];
+  }
+
+  //! rank holding element c, and its local index there
+  int owner(const int* c, int& local) const
+  {
+
+    if (axis < 0)
+    {
+      int p[3];
+      for (int d = 0; d < 3; ++d)
+        p[d] = c[d] / n[d];
+      local = ((c[1]-p[1]*n[1]) + n[1]*(c[2]-p[2]*n[2]))*stride + c[0]-p[0]*n[0];
+      return rank_of_block[p[0] + m[0]*(p[1] + m[1]*p[2])];
+    }
+
+    const long long L = line(c);
+    int r = (int) (L * nProcs / nLines);
+    while (r > 0 and first_line(r) > L)
+      --r;
+    while (r < nProcs-1 and first_line(r+1) <= L)
+      ++r;
+
+    local = (int) (L - first_line(r))*stride + c[axis];
+    return r;
+
+  } // owner
+
+  //! call f(c) for every element c held by rank, in x fastest order
+  template<class F>
+  void for_each_local(int rank, F f) const
+  {
+
+    int c[3];
+
+    if (axis < 0)
+    {
+      const int b = block_of_rank[rank];
+      const int o[3] = {n[0]*(b % m[0]), n[1]*((b / m[0]) % m[1]), n[2]*(b / (m[0]*m[1]))};
+      for (c[2] = o[2]; c[2] < o[2]+n[2]; ++c[2])
+        for (c[1] = o[1]; c[1] < o[1]+n[1]; ++c[1])
+          for (c[0] = o[0]; c[0] < o[0]+n[0]; ++c[0])
+            f(c);
+      return;
+    }
+
+    const long long lo = first_line(rank);
+    const long long hi = first_line(rank+1);
+
+    if (lo >= hi)
+      return;
+
+    if (axis == 0)
+    {
+      for (long long L = lo; L < hi; ++L)
+      {
+        c[1] = (int) (L % E[1]);
+        c[2] = (int) (L / E[1]);
+        for (c[0] = 0; c[0] < E[0]; ++c[0])
+          f(c);
+      }
+    }
+    else if (axis == 1)
+    {
+      for (c[2] = (int) (lo / E[0]); c[2] <= (int) ((hi-1) / E[0]); ++c[2])
+        for (c[1] = 0; c[1] < E[1]; ++c[1])
+          for (c[0] = (int) std::max(0LL, lo - (long long) E[0]*c[2]);
+               c[0] < (int) std::min((long long) E[0], hi - (long long) E[0]*c[2]); ++c[0])
+            f(c);
+    }
+    else
+    {
+      for (c[2] = 0; c[2] < E[2]; ++c[2])
+        for (c[1] = (int) (lo / E[0]); c[1] <= (int) ((hi-1) / E[0]); ++c[1])
+          for (c[0] = (int) std::max(0LL, lo - (long long) E[0]*c[1]);
+               c[0] < (int) std::min((long long) E[0], hi - (long long) E[0]*c[1]); ++c[0])
+            f(c);
+    }
+
+  } // for_each_local
+
+  //! number of lines held by rank
+  int local_lines(int rank) const
+  {
+    if (axis < 0)
+      return n[1]*n[2];
+    return (int) (first_line(rank+1) - first_line(rank));
+  }
+
+}; // struct AnalysisLayout
+
+// =======================================================
+// =======================================================
+/**
+ * Build the redistribution of rank from layout "from" to layout "to"
+ * (same index space). Both sides enumerate the elements they exchange
+ * with a given process in the same (x fastest) order, so that no index
+ * has to be communicated.
+ */
+static void analysis_transpose_setup(const AnalysisLayout& from,
+                                     const AnalysisLayout& to,
+                                     int rank,
+                                     AnalysisTranspose& t)
+{
+
+  const int nProcs = from.nProcs;
+
+  t.send_counts.assign(nProcs, 0);
+  t.recv_counts.assign(nProcs, 0);
+
+  int local;
+  from.for_each_local(rank, [&](const int* c) { ++t.send_counts[to.owner(c, local)]; });
+  to.for_each_local  (rank, [&](const int* c) { ++t.recv_counts[from.owner(c, local)]; });
+
+  t.send_displs.assign(nProcs, 0);
+  t.recv_displs.assign(nProcs, 0);
+  for (int r = 1; r < nProcs; ++r)
+  {
+    t.send_displs[r] = t.send_displs[r-1] + t.send_counts[r-1];
+    t.recv_displs[r] = t.recv_displs[r-1] + t.recv_counts[r-1];
+  }
+
+  t.send_index = AnalysisIndexArray("analysis_send_index",
+                                    t.send_displs[nProcs-1] + t.send_counts[nProcs-1]);
+  t.recv_index = AnalysisIndexArray("analysis_recv_index",
+                                    t.recv_displs[nProcs-1] + t.recv_counts[nProcs-1]);
+
+  AnalysisIndexArray::HostMirror send_index = Kokkos::create_mirror_view(t.send_index);
+  AnalysisIndexArray::HostMirror recv_index = Kokkos::create_mirror_view(t.recv_index);
+
+  std::vector<int> next(t.send_displs);
+  from.for_each_local(rank, [&](const int* c)
+                      {
+                        const int r = to.owner(c, local);
+                        from.owner(c, local);
+                        send_index(next[r]++) = local;
+                      });
+
+  next = t.recv_displs;
+  to.for_each_local(rank, [&](const int* c)
+                    {
+                      const int r = from.owner(c, local);
+                      to.owner(c, local);
+                      recv_index(next[r]++) = local;
+                    });
+
+  Kokkos::deep_copy(t.send_index, send_index);
+  Kokkos::deep_copy(t.recv_index, recv_index);
+
+  t.send_buffer = AnalysisBufferArray("analysis_send_buffer", t.send_index.extent(0));
+#ifdef USE_MPI
+  t.recv_buffer = AnalysisBufferArray("analysis_recv_buffer", t.recv_index.extent(0));
+#else
+  t.recv_buffer = t.send_buffer;
+#endif // USE_MPI
+
+  // MPI counts are in reals
+  for (int r = 0; r < nProcs; ++r)
+  {
+    t.send_counts[r] *= 2;
+    t.send_displs[r] *= 2;
+    t.recv_counts[r] *= 2;
+    t.recv_displs[r] *= 2;
+  }
+
+} // analysis_transpose_setup
+
+// =======================================================
+// =======================================================
+AnalysisSpectrum::AnalysisSpectrum(HydroParams& params,
+                                   ConfigMap& configMap,
+                                   const std::string& name) :
+  AnalysisPlugin(name, configMap.getInteger("analysis_" + name, "nstep", 10)),
+  m_first_line(0),
+  m_file(nullptr)
+{
+
+  const int dim = params.dimType == THREE_D ? 3 : 2;
+
+  // sub-domain sizes, number of sub-domains
+  const int n[3] = {params.nx, params.ny, dim == 3 ? params.nz : 1};
+  int m[3] = {1, 1, 1};
+
+  int myRank = 0;
+  int nProcs = 1;
+  std::vector<int> rank_of_block(1, 0);
+  std::vector<int> block_of_rank(1, 0);
+
+#ifdef USE_MPI
+  m[0] = params.mx;
+  m[1] = params.my;
+  m[2] = dim == 3 ? params.mz : 1;
+
+  myRank = params.myRank;
+  nProcs = params.nProcs;
+
+  rank_of_block.resize(nProcs);
+  block_of_rank.resize(nProcs);
+  for (int r = 0; r < nProcs; ++r)
+  {
+    int coords[3] = {0, 0, 0};
+    params.communicator->getCoords(r, dim, coords);
+    const int b = coords[0] + m[0]*(coords[1] + m[1]*coords[2]);
+    block_of_rank[r] = b;
+    rank_of_block[b] = r;
+  }
+#endif // USE_MPI
+
+  for (int d = 0; d < 3; ++d)
+    m_N[d] = n[d] * m[d];
+
+  // x wavenumbers 0..Nx/2 only (real input)
+  const int nkx = m_N[0]/2 + 1;
+
+  // layouts of the stages (index spaces: real, then spectral along x)
+  AnalysisLayout layout;
+  layout.nProcs = nProcs;
+  for (int d = 0; d < 3; ++d)
+  {
+    layout.n[d] = n[d];
+    layout.m[d] = m[d];
+  }
+  layout.rank_of_block = rank_of_block;
+  layout.block_of_rank = block_of_rank;
+
+  auto make_layout = [&](int E0, int axis, int stride) -> AnalysisLayout
+    {
+      AnalysisLayout l = layout;
+      l.E[0] = E0;
+      l.E[1] = m_N[1];
+      l.E[2] = m_N[2];
+      l.axis = axis;
+      l.stride = stride;
+      l.nLines =
+        axis == 0 ? (long long) l.E[1]*l.E[2] :
+        axis == 1 ? (long long) l.E[0]*l.E[2] :
+        (long long) l.E[0]*l.E[1];
+      return l;
+    };
+
+  // from[s] -> to[s] is the transpose from stage s to stage s+1
+  const AnalysisLayout from[3] =
+    {
+      make_layout(m_N[0], -1, n[0]),
+      make_layout(nkx,     0, m_N[0]),
+      make_layout(nkx,     1, m_N[1])
+    };
+  const AnalysisLayout to[3] =
+    {
+      make_layout(m_N[0], 0, m_N[0]),
+      make_layout(nkx,    1, m_N[1]),
+      make_layout(nkx,    2, m_N[2])
+    };
+
+  m_lines[0] = AnalysisLineArray("analysis_w", n[1]*n[2], n[0]);
+
+  for (int s = 0; s < dim; ++s)
+  {
+    const int nLines = to[s].local_lines(myRank);
+    m_lines[s+1] = AnalysisLineArray("analysis_lines", nLines, m_N[s]);
+    m_work[s+1]  = AnalysisLineArray("analysis_work",  nLines, m_N[s]);
+
+    analysis_transpose_setup(from[s], to[s], myRank, m_transpose[s]);
+  }
+
+  m_first_line = (int) to[dim-1].first_line(myRank);
+
+  // twiddle factors exp(-2 i pi m / N), prime factors of N
+  for (int d = 0; d < 3; ++d)
+  {
+    m_twiddle[d] = AnalysisTwiddleArray("analysis_twiddle", m_N[d]);
+    AnalysisTwiddleArray::HostMirror twiddle_host = Kokkos::create_mirror_view(m_twiddle[d]);
+    for (int t = 0; t < m_N[d]; ++t)
+    {
+      const double angle = -2.0 * M_PI * t / m_N[d];
+      twiddle_host(t) = AnalysisComplex(cos(angle), sin(angle));
+    }
+    Kokkos::deep_copy(m_twiddle[d], twiddle_host);
+
+    int size = m_N[d];
+    for (int p = 2; p*p <= size; ++p)
+      while (size % p == 0)
+      {
+        m_factors[d].p[m_factors[d].count++] = p;
+        size /= p;
+      }
+    if (size > 1)
+      m_factors[d].p[m_factors[d].count++] = size;
+  }
+
+  // shells up to the largest |kappa|
+  const double kmax = sqrt(0.25 * (m_N[0]*m_N[0] + m_N[1]*m_N[1] + m_N[2]*m_N[2]));
+  m_shells      = AnalysisBinArray("analysis_shells", (int) (kmax + 0.5) + 1);
+  m_shells_host = Kokkos::create_mirror_view(m_shells);
+
+  m_file = analysis_open_file(params, configMap, name);
+
+} // AnalysisSpectrum::AnalysisSpectrum
+
+// =======================================================
+// =======================================================
+AnalysisSpectrum::~AnalysisSpectrum()
+{
+
+  if (m_file)
+    fclose(m_file);
+
+} // AnalysisSpectrum::~AnalysisSpectrum
+
+// =======================================================
+// =======================================================
+void
+AnalysisSpectrum::transpose(int s, const AnalysisContext& context)
+{
+
+  AnalysisTranspose& t = m_transpose[s];
+
+  AnalysisPackFunctor::apply(m_lines[s], t.send_buffer, t.send_index, false);
+
+#ifdef USE_MPI
+  Kokkos::fence();
+  const int data_type = sizeof(real_t) == sizeof(double) ?
+    hydroSimu::MpiComm::DOUBLE : hydroSimu::MpiComm::FLOAT;
+  context.communicator->allToAllv(t.send_buffer.data(), t.send_counts.data(),
+                                  t.send_displs.data(), data_type,
+                                  t.recv_buffer.data(), t.recv_counts.data(),
+                                  t.recv_displs.data(), data_type);
+#else
+  UNUSED(context);
+#endif // USE_MPI
+
+  AnalysisPackFunctor::apply(m_lines[s+1], t.recv_buffer, t.recv_index, true);
+
+} // AnalysisSpectrum::transpose
+
+// =======================================================
+// =======================================================
+template<int dim>
+void
+AnalysisSpectrum::apply_impl(typename AnalysisVelocityFunctor<dim>::DataArray Udata,
+                             const AnalysisContext& context)
+{
+
+  HydroParams& params = context.params;
+
+  const double nCells = 1.0 * m_N[0] * m_N[1] * m_N[2];
+
+  Kokkos::deep_copy(m_shells, 0.0);
+
+  // velocity components (vz is also present in 2D MHD)
+  const int nbComponents = (dim == 3 or params.mhdEnabled) ? 3 : 2;
+
+  for (int ivar = IU; ivar < IU + nbComponents; ++ivar)
+  {
+
+    AnalysisVelocityFunctor<dim>::apply(params, Udata, m_lines[0], ivar);
+
+    for (int d = 0; d < dim; ++d)
+    {
+      transpose(d, context);
+      AnalysisFFTFunctor::apply(m_lines[d+1], m_work[d+1], m_twiddle[d], m_factors[d]);
+    }
+
+    AnalysisShellFunctor::apply(m_lines[dim], m_shells, dim-1, m_first_line,
+                                m_N[0], m_N[1], m_N[2], 1.0 / (nCells*nCells));
+
+  }
+
+  Kokkos::deep_copy(m_shells_host, m_shells);
+
+  std::vector<double> shells(m_shells_host.data(),
+                             m_shells_host.data() + m_shells_host.extent(0));
+
+#ifdef USE_MPI
+  {
+    std::vector<double> local(shells);
+    context.communicator->allReduce(local.data(), shells.data(), (int) shells.size(),
+                                    hydroSimu::MpiComm::DOUBLE, hydroSimu::MpiComm::SUM);
+  }
+#endif // USE_MPI
+
+  if (m_file == nullptr)
+    return;
+
+  double total = 0;
+  for (double e : shells)
+    total += e;
+
+  fprintf(m_file, "# iteration %d time %.10e mean_kinetic_energy %.10e\n",
+          context.iteration, context.time, total);
+  fprintf(m_file, "# k E(k)\n");
+
+  for (int k = 0; k < (int) shells.size(); ++k)
+    fprintf(m_file, "%d %.10e\n", k, shells[k]);
+
+  fprintf(m_file, "\n\n");
+  fflush(m_file);
+
+} // AnalysisSpectrum::apply_impl
+
+// =======================================================
+// =======================================================
+void
+AnalysisSpectrum::apply(DataArray2d Udata, const AnalysisContext& context)
+{
+
+  apply_impl<2>(Udata, context);
+
+} // AnalysisSpectrum::apply
+
+// =======================================================
+// =======================================================
+void
+AnalysisSpectrum::apply(DataArray3d Udata, const AnalysisContext& context)
+{
+
+  apply_impl<3>(Udata, context);
+
+} // AnalysisSpectrum::apply
+
+} // namespace ppkMHD
@@ -0,0 +1,335 @@
+/**
+ * \file Analysis.h
+ * \brief In-situ analysis plugins: user callbacks running on the device
+ * solution at a chosen cadence (no host copy of the solution).
+ */
+#ifndef ANALYSIS_H_
+#define ANALYSIS_H_
+
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "shared/kokkos_shared.h"
+#include "shared/HydroParams.h"
+#include "shared/AnalysisFunctors.h"
+#include "shared/utils.h" // for UNUSED
+#include "utils/config/ConfigMap.h"
+
+#ifdef USE_MPI
+#include "utils/mpiUtils/MpiCommCart.h"
+#endif // USE_MPI
+
+namespace ppkMHD
+{
+
+/**
+ * What an analysis plugin receives along with the solution.
+ */
+struct AnalysisContext
+{
+  int    iteration;
+  double time;
+
+  //! parameters of the run (sizes, ghost width, MPI topology, ...)
+  HydroParams& params;
+
+#ifdef USE_MPI
+  //! communicator of the run (cartesian topology)
+  hydroSimu::MpiCommCart* communicator;
+#endif // USE_MPI
+
+}; // struct AnalysisContext
+
+/**
+ * Base class of in-situ analysis plugins.
+ *
+ * apply receives the current solution on device (conservative
+ * variables, ghost cells included, same array as the one used by the
+ * solver: U or U2 depending on the iteration parity); it may launch its
+ * own Kokkos kernels on it, but must not modify it.
+ *
+ * A plugin only overrides the apply methods of the dimensions it
+ * supports (the default ones do nothing).
+ */
+class AnalysisPlugin
+{
+
+public:
+  AnalysisPlugin(const std::string& name, int nstep) :
+    m_name(name), m_nstep(nstep < 1 ? 1 : nstep) {}
+  virtual ~AnalysisPlugin() {}
+
+  const std::string& name() const { return m_name; }
+
+  //! should the plugin run at this iteration ?
+  bool is_due(int iteration) const { return iteration % m_nstep == 0; }
+
+  virtual void apply(DataArray2d Udata, const AnalysisContext& context)
+  {
+    UNUSED(Udata);
+    UNUSED(context);
+  }
+
+  virtual void apply(DataArray3d Udata, const AnalysisContext& context)
+  {
+    UNUSED(Udata);
+    UNUSED(context);
+  }
+
+private:
+  std::string m_name;
+  int         m_nstep;
+
+}; // class AnalysisPlugin
+
+/**
+ * Plugin calling user functions (lambdas, ...); an empty function means
+ * that dimension is not supported.
+ */
+class AnalysisCallback : public AnalysisPlugin
+{
+
+public:
+  using Callback2d = std::function<void(DataArray2d, const AnalysisContext&)>;
+  using Callback3d = std::function<void(DataArray3d, const AnalysisContext&)>;
+
+  AnalysisCallback(const std::string& name, int nstep,
+		   Callback2d callback_2d, Callback3d callback_3d = Callback3d()) :
+    AnalysisPlugin(name, nstep),
+    m_callback_2d(callback_2d),
+    m_callback_3d(callback_3d) {}
+
+  void apply(DataArray2d Udata, const AnalysisContext& context) override
+  {
+    if (m_callback_2d)
+      m_callback_2d(Udata, context);
+  }
+
+  void apply(DataArray3d Udata, const AnalysisContext& context) override
+  {
+    if (m_callback_3d)
+      m_callback_3d(Udata, context);
+  }
+
+private:
+  Callback2d m_callback_2d;
+  Callback3d m_callback_3d;
+
+}; // class AnalysisCallback
+
+/**
+ * In-situ analysis manager, owned by SolverBase (m_analysis).
+ *
+ * Plugins are either added from code (add, add_callback), or listed in
+ * the parameter file: section [analysis], parameter plugins (comma
+ * separated names); each one is configured in its own section
+ * [analysis_<name>]:
+ * - type: plugin type (default: the name itself), see register_type
+ * - nstep: number of time steps between two calls (default 10)
+ * - type specific parameters (see AnalysisPDF, AnalysisSpectrum)
+ *
+ * Built-in types: pdf (density or Mach number histogram) and spectrum
+ * (kinetic energy spectrum). Other types can be made available to the
+ * parameter file with register_type, before the solver is created.
+ *
+ * Results of built-in plugins are appended (rank 0) to
+ * outputDir/outputPrefix_<name>.txt, one block per call, blocks being
+ * separated by two blank lines (gnuplot "index").
+ *
+ * Currently called by the MUSCL hydro and MHD solvers, right after the
+ * outputs.
+ */
+class AnalysisManager
+{
+
+public:
+  //! plugin creation from the parameter file (section [analysis_<name>])
+  using Creator = std::shared_ptr<AnalysisPlugin> (*)(HydroParams& params,
+						      ConfigMap& configMap,
+						      const std::string& name);
+
+  AnalysisManager(HydroParams& params, ConfigMap& configMap);
+
+  //! is there at least one plugin ?
+  bool enabled() const { return !m_plugins.empty(); }
+
+  void add(std::shared_ptr<AnalysisPlugin> plugin);
+
+  void add_callback(const std::string& name, int nstep,
+		    AnalysisCallback::Callback2d callback_2d,
+		    AnalysisCallback::Callback3d callback_3d = AnalysisCallback::Callback3d());
+
+  //! run every plugin due at this iteration
+  void run(DataArray2d Udata, int iteration, double time);
+  void run(DataArray3d Udata, int iteration, double time);
+
+  //! make a plugin type available from the parameter file
+  static void register_type(const std::string& type, Creator creator);
+
+private:
+  HydroParams& params;
+
+  std::vector<std::shared_ptr<AnalysisPlugin> > m_plugins;
+
+  //! plugin types, built-in ones included
+  static std::map<std::string, Creator>& types();
+
+  template<class DataArray>
+  void run_impl(DataArray Udata, int iteration, double time);
+
+}; // class AnalysisManager
+
+/**
+ * Probability density function of density or Mach number.
+ *
+ * Parameters (section [analysis_<name>]):
+ * - variable: density (default) or mach
+ * - nbins (default 64)
+ * - log: bins uniform in log10 of the variable (default true for
+ *   density, false for mach)
+ * - min, max: range of the variable (default 1e-3..1e3 for density,
+ *   0..10 for mach; log10 is applied when log is set)
+ *
+ * Output columns: bin center, pdf (normalized on the chosen scale),
+ * number of cells; the block header gives the number of cells outside
+ * of the range.
+ */
+class AnalysisPDF : public AnalysisPlugin
+{
+
+public:
+  AnalysisPDF(HydroParams& params, ConfigMap& configMap, const std::string& name);
+  ~AnalysisPDF();
+
+  static std::shared_ptr<AnalysisPlugin> create(HydroParams& params,
+						ConfigMap& configMap,
+						const std::string& name)
+  {
+    return std::make_shared<AnalysisPDF>(params, configMap, name);
+  }
+
+  void apply(DataArray2d Udata, const AnalysisContext& context) override;
+  void apply(DataArray3d Udata, const AnalysisContext& context) override;
+
+private:
+  int    m_variable;
+  int    m_nbins;
+  bool   m_log;
+  real_t m_min;
+  real_t m_max;
+
+  //! nbins bins plus out of range counter
+  AnalysisBinArray             m_hist;
+  AnalysisBinArray::HostMirror m_hist_host;
+
+  //! output file (rank 0 only)
+  FILE* m_file;
+
+  template<int dim>
+  void apply_impl(typename AnalysisHistogramFunctor<dim>::DataArray Udata,
+		  const AnalysisContext& context);
+
+}; // class AnalysisPDF
+
+/**
+ * Redistribution of the spectrum transform between two stages of
+ * AnalysisSpectrum: values of the source line array are packed in
+ * send_buffer in the order of send_index, exchanged between MPI
+ * processes (all-to-all, counts and displacements in reals), and
+ * unpacked from recv_buffer into the destination line array at
+ * recv_index (indexes are line * positions per line + position).
+ *
+ * Without MPI, recv_buffer is send_buffer.
+ */
+struct AnalysisTranspose
+{
+  AnalysisIndexArray  send_index;
+  AnalysisIndexArray  recv_index;
+  AnalysisBufferArray send_buffer;
+  AnalysisBufferArray recv_buffer;
+
+  std::vector<int> send_counts;
+  std::vector<int> send_displs;
+  std::vector<int> recv_counts;
+  std::vector<int> recv_displs;
+
+}; // struct AnalysisTranspose
+
+/**
+ * Kinetic energy spectrum E(k), from the Fourier transform of
+ * w = sqrt(rho) u (so that sum_k E(k) is the mean kinetic energy
+ * density).
+ *
+ * The transform is a distributed, line (pencil) decomposed fast Fourier
+ * transform, O(N^d log N) for a N^d grid with small prime factors:
+ * - stage 0: the sub-domain of each MPI process;
+ * - stage 1: whole lines along x, spread evenly over the processes;
+ *   transformed along x, keeping wavenumbers 0..Nx/2 (real input);
+ * - stage 2: whole lines along y of the result, transformed along y;
+ * - stage 3 (3D): whole lines along z, transformed along z.
+ * Each stage change is a global transpose (AnalysisTranspose, device
+ * buffers, cuda-aware MPI assumed as for border exchange); every process
+ * then bins the modes it holds into shells, and only the shells are
+ * summed over processes. Per process memory is a few times the size of
+ * its sub-domain, whatever the global grid.
+ *
+ * Shell k gathers wavenumbers (in units of 2 pi / L) with
+ * k-1/2 <= |kappa| < k+1/2. Output columns: k, E(k).
+ */
+class AnalysisSpectrum : public AnalysisPlugin
+{
+
+public:
+  AnalysisSpectrum(HydroParams& params, ConfigMap& configMap, const std::string& name);
+  ~AnalysisSpectrum();
+
+  static std::shared_ptr<AnalysisPlugin> create(HydroParams& params,
+						ConfigMap& configMap,
+						const std::string& name)
+  {
+    return std::make_shared<AnalysisSpectrum>(params, configMap, name);
+  }
+
+  void apply(DataArray2d Udata, const AnalysisContext& context) override;
+  void apply(DataArray3d Udata, const AnalysisContext& context) override;
+
+private:
+  //! global sizes
+  int m_N[3];
+
+  //! stage arrays (see above), FFT work arrays of the same shape
+  AnalysisLineArray m_lines[4];
+  AnalysisLineArray m_work[4];
+
+  //! transform along each direction
+  AnalysisTwiddleArray m_twiddle[3];
+  AnalysisFFTFactors   m_factors[3];
+
+  //! redistribution from stage s to stage s+1
+  AnalysisTranspose m_transpose[3];
+
+  //! global index of the first line of the last stage held by this process
+  int m_first_line;
+
+  AnalysisBinArray             m_shells;
+  AnalysisBinArray::HostMirror m_shells_host;
+
+  //! output file (rank 0 only)
+  FILE* m_file;
+
+  //! move the transform from stage s to stage s+1
+  void transpose(int s, const AnalysisContext& context);
+
+  template<int dim>
+  void apply_impl(typename AnalysisVelocityFunctor<dim>::DataArray Udata,
+		  const AnalysisContext& context);
+
+}; // class AnalysisSpectrum
+
+} // namespace ppkMHD
+
+#endif // ANALYSIS_H_
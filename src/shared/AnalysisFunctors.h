@@ -0,0 +1,478 @@
+/**
+ * \file AnalysisFunctors.h
+ * \brief Device functors used by the built-in in-situ analysis plugins
+ * (see Analysis.h).
+ */
+#ifndef ANALYSIS_FUNCTORS_H_
+#define ANALYSIS_FUNCTORS_H_
+
+#include <type_traits>
+
+#include <Kokkos_Complex.hpp>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/enums.h"
+#include "shared/KernelParams.h"
+#include "shared/EquationOfState.h"
+
+namespace ppkMHD
+{
+
+//! quantities available to the PDF plugin
+enum AnalysisVariable
+{
+  ANALYSIS_DENSITY = 0,
+  ANALYSIS_MACH    = 1
+}; // enum AnalysisVariable
+
+using AnalysisComplex      = Kokkos::complex<real_t>;
+//! lines of a 3D array along one direction: (line, position)
+using AnalysisLineArray    = Kokkos::View<AnalysisComplex**, Device>;
+using AnalysisBufferArray  = Kokkos::View<AnalysisComplex*,  Device>;
+using AnalysisTwiddleArray = Kokkos::View<AnalysisComplex*,  Device>;
+using AnalysisIndexArray   = Kokkos::View<int*,    Device>;
+using AnalysisBinArray     = Kokkos::View<double*, Device>;
+
+/**
+ * Histogram of density or Mach number over the interior cells of Udata.
+ *
+ * Bin b covers [vmin + b/inv_width, vmin + (b+1)/inv_width), with v the
+ * variable (or its base 10 logarithm when logscale is set); values
+ * outside of the range are counted in the extra bin nbins.
+ */
+template<int dim>
+class AnalysisHistogramFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  AnalysisHistogramFunctor(KernelParams     params,
+			   DataArray        Udata,
+			   AnalysisBinArray hist,
+			   int              variable,
+			   bool             mhdEnabled,
+			   bool             logscale,
+			   real_t           vmin,
+			   real_t           inv_width) :
+    params(params), Udata(Udata), hist(hist), variable(variable),
+    mhdEnabled(mhdEnabled), logscale(logscale),
+    vmin(vmin), inv_width(inv_width),
+    nbins(hist.extent(0)-1)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams     params,
+		    DataArray        Udata,
+		    AnalysisBinArray hist,
+		    int              variable,
+		    bool             mhdEnabled,
+		    bool             logscale,
+		    real_t           vmin,
+		    real_t           inv_width)
+  {
+    const int nbCells = params.nx*params.ny*(dim==3 ? params.nz : 1);
+
+    AnalysisHistogramFunctor<dim> functor(params, Udata, hist, variable,
+					  mhdEnabled, logscale, vmin, inv_width);
+    Kokkos::parallel_for("AnalysisHistogramFunctor", nbCells, functor);
+  }
+
+  //! conservative variable ivar of cell (i,j,k); k is ignored in 2D
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==2, int>::type i,
+	     int j, int k, int ivar) const
+  {
+    return Udata(i,j,ivar);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==3, int>::type i,
+	     int j, int k, int ivar) const
+  {
+    return Udata(i,j,k,ivar);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int nx = params.nx;
+    const int ny = params.ny;
+    const int gw = params.ghostWidth;
+
+    // interior cell
+    const int i = index % nx + gw;
+    const int j = (index / nx) % ny + gw;
+    const int k = dim==3 ? index / (nx*ny) + gw : 0;
+
+    const real_t rho = FMAX(get(i,j,k,ID), params.settings.smallr);
+
+    real_t value = rho;
+
+    if (variable == ANALYSIS_MACH) {
+
+      const real_t mx = get(i,j,k,IU);
+      const real_t my = get(i,j,k,IV);
+      // IW only exists for 3D hydro or MHD
+      const real_t mz = (dim==3 or mhdEnabled) ? get(i,j,k,IW) : 0;
+
+      const real_t ekin = HALF_F*(mx*mx+my*my+mz*mz)/rho;
+
+      real_t emag = 0;
+      if (mhdEnabled) {
+	// cell-centered magnetic field from face-centered values
+	const real_t bx = HALF_F*(get(i,j,k,IA)+get(i+1,j,k,IA));
+	const real_t by = HALF_F*(get(i,j,k,IB)+get(i,j+1,k,IB));
+	const real_t bz = dim==3 ?
+	  HALF_F*(get(i,j,k,IC)+get(i,j,k+1,IC)) :
+	  get(i,j,k,IC);
+	emag = HALF_F*(bx*bx+by*by+bz*bz);
+      }
+
+      real_t p, c;
+      eos_compute(params.settings, rho, (get(i,j,k,IP)-ekin-emag)/rho, p, c);
+
+      value = SQRT(TWO_F*ekin/rho)/c;
+
+    }
+
+    if (logscale)
+      value = log10(FMAX(value, params.settings.smallr));
+
+    const real_t x = (value - vmin) * inv_width;
+    const int bin = (x >= 0 and x < nbins) ? (int) x : nbins;
+
+    Kokkos::atomic_add(&hist(bin), 1.0);
+
+  } // operator ()
+
+  KernelParams     params;
+  DataArray        Udata;
+  AnalysisBinArray hist;
+  int              variable;
+  bool             mhdEnabled;
+  bool             logscale;
+  real_t           vmin;
+  real_t           inv_width;
+  int              nbins;
+
+}; // AnalysisHistogramFunctor
+
+/**
+ * Velocity component weighted by the square root of density,
+ * w = m_dir / sqrt(rho), on interior cells (so that |w|^2/2 is the
+ * kinetic energy density), stored as lines along x:
+ * w(j + ny*k, i) for interior cell (i,j,k).
+ */
+template<int dim>
+class AnalysisVelocityFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  AnalysisVelocityFunctor(KernelParams      params,
+			  DataArray         Udata,
+			  AnalysisLineArray w,
+			  int               ivar) :
+    params(params), Udata(Udata), w(w), ivar(ivar)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams      params,
+		    DataArray         Udata,
+		    AnalysisLineArray w,
+		    int               ivar)
+  {
+    AnalysisVelocityFunctor<dim> functor(params, Udata, w, ivar);
+    Kokkos::parallel_for("AnalysisVelocityFunctor", w.size(), functor);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==2, int>::type i,
+	     int j, int k, int iv) const
+  {
+    return Udata(i,j,iv);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==3, int>::type i,
+	     int j, int k, int iv) const
+  {
+    return Udata(i,j,k,iv);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int nx = w.extent(1);
+    const int ny = params.ny;
+    const int gw = params.ghostWidth;
+
+    const int i    = index % nx;
+    const int line = index / nx;
+    const int j    = line % ny;
+    const int k    = line / ny;
+
+    const real_t rho = FMAX(get(i+gw, j+gw, dim==3 ? k+gw : 0, ID),
+			    params.settings.smallr);
+
+    w(line,i) = AnalysisComplex(get(i+gw, j+gw, dim==3 ? k+gw : 0, ivar) / SQRT(rho), 0);
+
+  } // operator ()
+
+  KernelParams      params;
+  DataArray         Udata;
+  AnalysisLineArray w;
+  int               ivar;
+
+}; // AnalysisVelocityFunctor
+
+/**
+ * Copy between a line array and a flat buffer:
+ * buffer(i) = lines(index(i)) (pack) or lines(index(i)) = buffer(i)
+ * (unpack), index(i) being line * lines.extent(1) + position.
+ *
+ * Used to redistribute the spectrum transform between MPI processes
+ * (see AnalysisSpectrum).
+ */
+class AnalysisPackFunctor
+{
+
+public:
+  AnalysisPackFunctor(AnalysisLineArray   lines,
+		      AnalysisBufferArray buffer,
+		      AnalysisIndexArray  index,
+		      bool                unpack) :
+    lines(lines), buffer(buffer), index(index), unpack(unpack)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(AnalysisLineArray   lines,
+		    AnalysisBufferArray buffer,
+		    AnalysisIndexArray  index,
+		    bool                unpack)
+  {
+    AnalysisPackFunctor functor(lines, buffer, index, unpack);
+    Kokkos::parallel_for("AnalysisPackFunctor", index.extent(0), functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& i) const
+  {
+    const int n    = lines.extent(1);
+    const int line = index(i) / n;
+    const int pos  = index(i) % n;
+
+    if (unpack)
+      lines(line,pos) = buffer(i);
+    else
+      buffer(i) = lines(line,pos);
+
+  } // operator ()
+
+  AnalysisLineArray   lines;
+  AnalysisBufferArray buffer;
+  AnalysisIndexArray  index;
+  bool                unpack;
+
+}; // AnalysisPackFunctor
+
+/**
+ * Prime factors of a transform length, smallest first (a length below
+ * 2^31 has at most 31 of them).
+ */
+struct AnalysisFFTFactors
+{
+  int count = 0;
+  int p[32];
+}; // struct AnalysisFFTFactors
+
+/**
+ * In-place discrete Fourier transform of every line of a line array
+ * (one thread per line), positions 0..N-1 with N = twiddle.extent(0):
+ *
+ * out(line,kappa) = sum_n in(line,n) exp(-2 i pi kappa n / N)
+ *
+ * Mixed radix, self-sorting (Stockham) fast Fourier transform: one pass
+ * per prime factor p of N, ping-ponging between data and work (same
+ * shape), for a cost in O(N sum p) per line, i.e. O(N log N) for
+ * lengths with small factors (a prime length falls back to a plain DFT).
+ *
+ * Before the pass of factor p, with L the product of the factors already
+ * processed and R = N/L, position r*L+k (r < R, k < L) holds the
+ * transform of length L of the subsequence n = r + R*t; the pass merges
+ * subsequences r, r+R/p, .., r+(p-1)R/p into the transform of length L*p
+ * of subsequence r.
+ *
+ * twiddle(m) = exp(-2 i pi m / N), 0 <= m < N.
+ */
+class AnalysisFFTFunctor
+{
+
+public:
+  AnalysisFFTFunctor(AnalysisLineArray    data,
+		     AnalysisLineArray    work,
+		     AnalysisTwiddleArray twiddle,
+		     AnalysisFFTFactors   factors) :
+    data(data), work(work), twiddle(twiddle), factors(factors)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(AnalysisLineArray    data,
+		    AnalysisLineArray    work,
+		    AnalysisTwiddleArray twiddle,
+		    AnalysisFFTFactors   factors)
+  {
+    AnalysisFFTFunctor functor(data, work, twiddle, factors);
+    Kokkos::parallel_for("AnalysisFFTFunctor", data.extent(0), functor);
+  }
+
+  //! one pass (factor p, L already merged) from src to dst
+  KOKKOS_INLINE_FUNCTION
+  void pass(const AnalysisLineArray& src,
+	    const AnalysisLineArray& dst,
+	    int line, int p, int L) const
+  {
+    const int N  = twiddle.extent(0);
+    const int Rp = N / (L*p);
+
+    for (int r=0; r<Rp; ++r) {
+      for (int kappa=0; kappa<L*p; ++kappa) {
+
+	// twiddle of term q: exp(-2 i pi q kappa / (L*p))
+	const int step = Rp*kappa;
+
+	const int k = kappa % L;
+
+	AnalysisComplex sum = 0;
+	int t = 0;
+	for (int q=0; q<p; ++q) {
+	  sum += src(line,(r+Rp*q)*L+k) * twiddle(t);
+	  t += step;
+	  if (t >= N)
+	    t -= N;
+	}
+
+	dst(line,r*L*p+kappa) = sum;
+
+      }
+    }
+
+  } // pass
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& line) const
+  {
+    int L = 1;
+
+    for (int f=0; f<factors.count; ++f) {
+      if (f % 2 == 0)
+	pass(data, work, line, factors.p[f], L);
+      else
+	pass(work, data, line, factors.p[f], L);
+      L *= factors.p[f];
+    }
+
+    // odd number of passes: result is in work
+    if (factors.count % 2 == 1)
+      for (int n=0; n<L; ++n)
+	data(line,n) = work(line,n);
+
+  } // operator ()
+
+  AnalysisLineArray    data;
+  AnalysisLineArray    work;
+  AnalysisTwiddleArray twiddle;
+  AnalysisFFTFactors   factors;
+
+}; // AnalysisFFTFunctor
+
+/**
+ * Accumulate |what|^2 / 2 in wavenumber shells (shell k gathers
+ * k-1/2 <= |kappa| < k+1/2), what being the part of the full Fourier
+ * transform held by the current MPI process, with x wavenumbers 0..Nx/2
+ * only (the others are accounted for by symmetry), as lines along the
+ * last direction (dir): global line first_line+line gathers
+ * wavenumbers (kx, ky) in 3D (dir 2), kx in 2D (dir 1), kx running
+ * fastest.
+ */
+class AnalysisShellFunctor
+{
+
+public:
+  AnalysisShellFunctor(AnalysisLineArray what,
+		       AnalysisBinArray  shells,
+		       int               dir,
+		       int               first_line,
+		       int               Nx,
+		       int               Ny,
+		       int               Nz,
+		       double            scale) :
+    what(what), shells(shells), dir(dir), first_line(first_line),
+    Nx(Nx), Ny(Ny), Nz(Nz), scale(scale)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(AnalysisLineArray what,
+		    AnalysisBinArray  shells,
+		    int               dir,
+		    int               first_line,
+		    int               Nx,
+		    int               Ny,
+		    int               Nz,
+		    double            scale)
+  {
+    AnalysisShellFunctor functor(what, shells, dir, first_line, Nx, Ny, Nz, scale);
+    Kokkos::parallel_for("AnalysisShellFunctor", what.size(), functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int n    = what.extent(1);
+    const int line = index / n;
+    const int pos  = index % n;
+
+    const int nkx = Nx/2 + 1;
+
+    const int kx = (first_line + line) % nkx;
+    const int iy = dir == 2 ? (first_line + line) / nkx : pos;
+    const int iz = dir == 2 ? pos : 0;
+
+    // signed wavenumbers
+    const int ky = iy <= Ny/2 ? iy : iy-Ny;
+    const int kz = iz <= Nz/2 ? iz : iz-Nz;
+
+    // modes kx and Nx-kx are conjugate: count interior kx twice
+    const double weight = (kx == 0 or 2*kx == Nx) ? 1.0 : 2.0;
+
+    const AnalysisComplex v = what(line,pos);
+    const double energy = 0.5 * weight * scale * (v.real()*v.real() + v.imag()*v.imag());
+
+    const int shell = (int) (sqrt((double) (kx*kx + ky*ky + kz*kz)) + 0.5);
+
+    if (shell < (int) shells.extent(0))
+      Kokkos::atomic_add(&shells(shell), energy);
+
+  } // operator ()
+
+  AnalysisLineArray what;
+  AnalysisBinArray  shells;
+  int               dir;
+  int               first_line;
+  int               Nx, Ny, Nz;
+  double            scale;
+
+}; // AnalysisShellFunctor
+
+} // namespace ppkMHD
+
+#endif // ANALYSIS_FUNCTORS_H_
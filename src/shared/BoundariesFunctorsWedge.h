@@ -1,7 +1,7 @@
 #ifndef BOUNDARIES_FUNCTORS_WEDGE_H_
 #define BOUNDARIES_FUNCTORS_WEDGE_H_
 
-#include "shared/HydroParams.h"    // for HydroParams
+#include "shared/KernelParams.h"    // for KernelParams
 #include "shared/kokkos_shared.h"  // for Data arrays
 #include "shared/problems/WedgeParams.h"    // for Wedge border condition
 
@@ -22,7 +22,7 @@ class MakeBoundariesFunctor2D_wedge
 
 public:
 
-  MakeBoundariesFunctor2D_wedge(HydroParams params,
+  MakeBoundariesFunctor2D_wedge(KernelParams params,
                                 WedgeParams wparams,
                                 DataArray2d Udata) :
     params(params), wparams(wparams), Udata(Udata) {};
@@ -181,10 +181,70 @@ public:
 
   } // end operator ()
 
-  HydroParams params;
+  KernelParams params;
   WedgeParams wparams;
   DataArray2d Udata;
 
 }; // MakeBoundariesFunctor2D_wedge
 
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Wedge inflow policy for ppkMHD::FillGhostCellsFunctor (and its SDM
+ * counterpart), 2D:
+ * - xmin: post-shock inflow;
+ * - ymin: post-shock inflow for x < x_f, face fill type (reflecting)
+ *   elsewhere;
+ * - ymax: post-shock inflow for x < x_f + y/slope_f + delta_x; elsewhere
+ *   pre-shock state when preshock_ymax is set (SDM), face fill type
+ *   (absorbing) otherwise.
+ */
+struct WedgeInflow
+{
+
+  WedgeInflow(WedgeParams wparams, bool preshock_ymax) :
+    wparams(wparams), preshock_ymax(preshock_ymax) {};
+
+  KOKKOS_INLINE_FUNCTION
+  bool imposed(int face, const real_t x[3], real_t q[5]) const
+  {
+    bool post_shock = false;
+    bool pre_shock  = false;
+
+    if (face == FACE_XMIN)
+      post_shock = true;
+    else if (face == FACE_YMIN)
+      post_shock = x[IX] < wparams.x_f;
+    else if (face == FACE_YMAX)
+    {
+      post_shock = x[IX] < wparams.x_f + x[IY]/wparams.slope_f + wparams.delta_x;
+      pre_shock  = !post_shock and preshock_ymax;
+    }
+
+    if (post_shock)
+    {
+      q[ID] = wparams.rho1;
+      q[IE] = wparams.e_tot1;
+      q[IU] = wparams.rho_u1;
+      q[IV] = wparams.rho_v1;
+      q[IW] = wparams.rho_w1;
+    }
+    else if (pre_shock)
+    {
+      q[ID] = wparams.rho2;
+      q[IE] = wparams.e_tot2;
+      q[IU] = wparams.rho_u2;
+      q[IV] = wparams.rho_v2;
+      q[IW] = wparams.rho_w2;
+    }
+
+    return post_shock or pre_shock;
+  }
+
+  WedgeParams wparams;
+  bool preshock_ymax;
+
+}; // struct WedgeInflow
+
 #endif // BOUNDARIES_FUNCTORS_WEDGE_H_
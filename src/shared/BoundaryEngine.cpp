@@ -0,0 +1,139 @@
+#include "shared/BoundaryEngine.h"
+
+#include <vector>
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== STRUCT GhostFaces IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+GhostFaces
+GhostFaces::from_params(const HydroParams& params)
+{
+
+  GhostFaces faces;
+
+  const BoundaryConditionType bc[6] =
+    {
+      params.boundary_type_xmin, params.boundary_type_xmax,
+      params.boundary_type_ymin, params.boundary_type_ymax,
+      params.boundary_type_zmin, params.boundary_type_zmax
+    };
+
+  for (int face=0; face<6; ++face)
+  {
+    if (bc[face] == BC_DIRICHLET)
+      faces.type[face] = GHOST_DIRICHLET;
+    else if (bc[face] == BC_NEUMANN)
+      faces.type[face] = GHOST_NEUMANN;
+    else
+      faces.type[face] = GHOST_PERIODIC;
+
+#ifdef USE_MPI
+    if (params.neighborsBC[face] == BC_COPY or
+        params.neighborsBC[face] == BC_PERIODIC)
+      faces.type[face] = GHOST_EXCHANGED;
+#endif // USE_MPI
+
+    faces.inflow[face] = 0;
+  }
+
+  return faces;
+
+} // GhostFaces::from_params
+
+// =======================================================
+// ==== CLASS BoundaryEngine IMPL ========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+BoundaryEngine::BoundaryEngine() :
+  cells(),
+  faces()
+{
+
+  for (int d=0; d<4; ++d)
+    m_offsets[d] = 0;
+
+} // BoundaryEngine::BoundaryEngine
+
+// =======================================================
+// =======================================================
+void
+BoundaryEngine::init(const HydroParams& params, const GhostFaces& faces)
+{
+
+  this->faces = faces;
+
+  const int dim = params.dimType == TWO_D ? 2 : 3;
+  const int ghostWidth = params.ghostWidth;
+
+  const int n[3]    = {params.nx, params.ny, params.nz};
+  const int size[3] = {params.isize, params.jsize, dim==3 ? params.ksize : 1};
+
+  // one list per direction
+  std::vector<int> list[3];
+
+  for (int k=0; k<size[IZ]; ++k)
+  {
+    for (int j=0; j<size[IY]; ++j)
+    {
+      // rows with no ghost coordinate along Y or Z only have X ghost cells
+      const bool inner_row =
+        (j >= ghostWidth and j < n[IY]+ghostWidth) and
+        (dim==2 or (k >= ghostWidth and k < n[IZ]+ghostWidth));
+
+      for (int i=0; i<size[IX]; ++i)
+      {
+        if (inner_row and i == ghostWidth)
+          i = n[IX]+ghostWidth;
+
+        const int c[3] = {i, j, k};
+
+        // last ghost direction and its face
+        int last = -1;
+        int face = -1;
+        for (int d=0; d<dim; ++d)
+        {
+          if (c[d] < ghostWidth)
+          {
+            last = d;
+            face = 2*d;
+          }
+          else if (c[d] >= n[d]+ghostWidth)
+          {
+            last = d;
+            face = 2*d+1;
+          }
+        }
+
+        if (last < 0 or faces.type[face] == GHOST_EXCHANGED)
+          continue;
+
+        const int index = i + size[IX]*(j + size[IY]*k);
+        list[last].push_back( (index << 3) | face );
+      }
+    }
+  }
+
+  m_offsets[0] = 0;
+  for (int d=0; d<3; ++d)
+    m_offsets[d+1] = m_offsets[d] + list[d].size();
+
+  cells = CellList("ghost_cells", m_offsets[3]);
+  CellList::HostMirror cells_host = Kokkos::create_mirror_view(cells);
+
+  for (int d=0; d<3; ++d)
+    for (size_t ic=0; ic<list[d].size(); ++ic)
+      cells_host(m_offsets[d]+ic) = list[d][ic];
+
+  Kokkos::deep_copy(cells, cells_host);
+
+} // BoundaryEngine::init
+
+} // namespace ppkMHD
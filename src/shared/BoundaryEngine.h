@@ -0,0 +1,325 @@
+/**
+ * \file BoundaryEngine.h
+ * \brief Fill every ghost cell of a sub-domain in a single kernel launch,
+ * from a list of ghost cells built once at setup.
+ */
+#ifndef BOUNDARY_ENGINE_H_
+#define BOUNDARY_ENGINE_H_
+
+#include <utility> // for std::pair
+
+#include "shared/kokkos_shared.h"
+#include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
+
+namespace ppkMHD
+{
+
+/**
+ * How ghost cells of a face are filled.
+ */
+enum GhostFillType
+{
+  GHOST_EXCHANGED      = 0, /*!< MPI halo exchange (not filled here) */
+  GHOST_DIRICHLET      = 1, /*!< reflecting: mirror cell, normal components change sign */
+  GHOST_NEUMANN        = 2, /*!< absorbing: copy of the last inner cell */
+  GHOST_NEUMANN_MIRROR = 3, /*!< absorbing, DoFs mirrored (SDM outflow) */
+  GHOST_PERIODIC       = 4  /*!< periodic */
+};
+
+/**
+ * Per face description of the border conditions, indexed by FaceIdType.
+ *
+ * A face flagged inflow may have a state imposed by the problem (wedge,
+ * jet, ...): the inflow policy of the fill functor decides, ghost cell
+ * by ghost cell, and falls back to the face fill type when it does not
+ * impose anything.
+ */
+struct GhostFaces
+{
+
+  Kokkos::Array<int,6> type;   //!< a GhostFillType
+  Kokkos::Array<int,6> inflow; //!< 1 when the inflow policy is queried
+
+  /**
+   * Fill types read from the border conditions of the parameter file; in
+   * MPI, faces shared with a neighbor (or periodic across processes) are
+   * exchanged.
+   */
+  static GhostFaces from_params(const HydroParams& params);
+
+  //! change a face, unless it is exchanged
+  void set(FaceIdType face, GhostFillType fill_type, bool is_inflow = false)
+  {
+    if (type[face] == GHOST_EXCHANGED)
+      return;
+
+    type[face]   = fill_type;
+    inflow[face] = is_inflow ? 1 : 0;
+  }
+
+}; // struct GhostFaces
+
+/**
+ * List of the ghost cells of a sub-domain which are filled by border
+ * conditions (i.e. not by MPI exchange).
+ *
+ * A cell belongs to the direction of its last ghost coordinate (Z, then Y,
+ * then X): this is the direction whose border condition was applied last
+ * when faces were filled one after the other, X then Y then Z, so that it
+ * was the one writing corner and edge cells. Cells are sorted by direction,
+ * so that MPI runs can fill the cells of one direction right after its halo
+ * exchange.
+ *
+ * Each entry packs the flat cell index (i + isize*(j + jsize*k)) and the
+ * face of that last direction, hence the fill type of the cell:
+ * entry = (index << 3) | face.
+ */
+class BoundaryEngine
+{
+
+public:
+  using CellList = Kokkos::View<int*, Device>;
+  using Range    = std::pair<int,int>;
+
+  BoundaryEngine();
+
+  //! build the ghost cell list (host side, once at setup)
+  void init(const HydroParams& params, const GhostFaces& faces);
+
+  //! all the ghost cells
+  Range all() const { return Range(m_offsets[0], m_offsets[3]); }
+
+  //! ghost cells of direction dir (IX, IY or IZ)
+  Range direction(int dir) const { return Range(m_offsets[dir], m_offsets[dir+1]); }
+
+  CellList   cells;
+  GhostFaces faces;
+
+private:
+  int m_offsets[4];
+
+}; // class BoundaryEngine
+
+/**
+ * Coordinate (along one direction, n inner cells) of the cell a ghost cell
+ * is filled from.
+ */
+KOKKOS_INLINE_FUNCTION
+int ghost_source(int type, bool is_min, int i, int n, int ghostWidth)
+{
+
+  if (type == GHOST_DIRICHLET)
+    return is_min ? 2*ghostWidth-1-i : 2*n+2*ghostWidth-1-i;
+
+  if (type == GHOST_PERIODIC)
+    return is_min ? n+i : i-n;
+
+  // neumann
+  return is_min ? ghostWidth : n+ghostWidth-1;
+
+} // ghost_source
+
+/**
+ * Default inflow policy: no face imposes a state.
+ *
+ * An inflow policy provides
+ *   bool imposed(int face, const real_t x[3], real_t q[5]) const
+ * which, given the position x of a ghost point, returns true and fills the
+ * conservative state q (ID, IE, IU, IV, IW) when the face imposes one.
+ */
+struct NoInflow
+{
+
+  KOKKOS_INLINE_FUNCTION
+  bool imposed(int face, const real_t x[3], real_t q[5]) const
+  {
+    return false;
+  }
+
+}; // struct NoInflow
+
+/**
+ * Fill ghost cells of a cell-centered (MUSCL, MOOD) data array.
+ *
+ * For each ghost cell, ghost directions are walked from the last one down
+ * to X; the coordinate of each is replaced by the one of the cell it is
+ * filled from. The value is the one of the resulting cell, with the sign
+ * of normal velocity (and magnetic field when mhd is enabled) changed once
+ * per reflecting direction. This is the value which filling faces one at a
+ * time, X then Y then Z, used to give corners.
+ */
+template<int dim, class Inflow = NoInflow>
+class FillGhostCellsFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  FillGhostCellsFunctor(KernelParams             params,
+                        BoundaryEngine::CellList cells,
+                        GhostFaces               faces,
+                        DataArray                Udata,
+                        bool                     mhd_enabled,
+                        Inflow                   inflow) :
+    params(params), cells(cells), faces(faces), Udata(Udata),
+    mhd_enabled(mhd_enabled), inflow(inflow) {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams          params,
+                    const BoundaryEngine& engine,
+                    BoundaryEngine::Range range,
+                    DataArray             Udata,
+                    bool                  mhd_enabled,
+                    Inflow                inflow = Inflow())
+  {
+    if (range.first == range.second)
+      return;
+
+    FillGhostCellsFunctor<dim,Inflow> functor(params, engine.cells, engine.faces,
+                                              Udata, mhd_enabled, inflow);
+    Kokkos::parallel_for("FillGhostCellsFunctor",
+                         Kokkos::RangePolicy<>(range.first, range.second),
+                         functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ghostWidth = params.ghostWidth;
+    const int nbvar = params.nbvar;
+
+    const int n[3] = {params.nx, params.ny, params.nz};
+
+    const int entry = cells(index);
+    const int face  = entry & 7;
+    int cell = entry >> 3;
+
+    // ghost cell coordinates
+    int g[3];
+    g[IX] = cell % isize; cell /= isize;
+    g[IY] = cell % jsize;
+    g[IZ] = cell / jsize;
+
+    // source cell coordinates
+    int c[3] = {g[IX], g[IY], g[IZ]};
+
+    int reflected = 0;
+    bool is_imposed = false;
+    real_t q[5] = {0, 0, 0, 0, 0};
+
+    for (int dir = face/2; dir >= 0; --dir)
+    {
+      int f;
+      if (c[dir] < ghostWidth)
+        f = 2*dir;
+      else if (c[dir] >= n[dir]+ghostWidth)
+        f = 2*dir+1;
+      else
+        continue;
+
+      if (faces.inflow[f])
+      {
+        real_t x[3];
+        position(c, x);
+        if (inflow.imposed(f, x, q))
+        {
+          is_imposed = true;
+          break;
+        }
+      }
+
+      const int type = faces.type[f];
+
+      if (type == GHOST_EXCHANGED)
+        break;
+
+      if (type == GHOST_DIRICHLET)
+        reflected |= 1 << dir;
+
+      c[dir] = ghost_source(type, f==2*dir, c[dir], n[dir], ghostWidth);
+    }
+
+    for (int iVar=0; iVar<nbvar; iVar++)
+    {
+      real_t sign = 1.0;
+      for (int dir=0; dir<dim; ++dir)
+        if ( (reflected >> dir) & 1 )
+          if (iVar==IU+dir or (mhd_enabled and iVar==IA+dir))
+            sign = -sign;
+
+      const real_t value = is_imposed ? (iVar < 5 ? q[iVar] : 0) : get(c, iVar);
+
+      set(g, iVar, value*sign);
+    }
+
+  } // operator ()
+
+  //! cell center position (global, i.e. with MPI offset)
+  KOKKOS_INLINE_FUNCTION
+  void position(const int c[3], real_t x[3]) const
+  {
+    const int ghostWidth = params.ghostWidth;
+
+#ifdef USE_MPI
+    const int i_mpi = params.myMpiPos[IX];
+    const int j_mpi = params.myMpiPos[IY];
+    const int k_mpi = params.myMpiPos[IZ];
+#else
+    const int i_mpi = 0;
+    const int j_mpi = 0;
+    const int k_mpi = 0;
+#endif
+
+    x[IX] = params.xmin + params.dx/2 + (c[IX]+params.nx*i_mpi-ghostWidth)*params.dx;
+    x[IY] = params.ymin + params.dy/2 + (c[IY]+params.ny*j_mpi-ghostWidth)*params.dy;
+    x[IZ] = params.zmin + params.dz/2 + (c[IZ]+params.nz*k_mpi-ghostWidth)*params.dz;
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(const int c[3], int iVar,
+             typename std::enable_if<dim_==2, int>::type = 0) const
+  {
+    return Udata(c[IX], c[IY], iVar);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(const int c[3], int iVar,
+             typename std::enable_if<dim_==3, int>::type = 0) const
+  {
+    return Udata(c[IX], c[IY], c[IZ], iVar);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void set(const int c[3], int iVar, real_t value,
+           typename std::enable_if<dim_==2, int>::type = 0) const
+  {
+    Udata(c[IX], c[IY], iVar) = value;
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void set(const int c[3], int iVar, real_t value,
+           typename std::enable_if<dim_==3, int>::type = 0) const
+  {
+    Udata(c[IX], c[IY], c[IZ], iVar) = value;
+  }
+
+  KernelParams             params;
+  BoundaryEngine::CellList cells;
+  GhostFaces               faces;
+  DataArray                Udata;
+  bool                     mhd_enabled;
+  Inflow                   inflow;
+
+}; // FillGhostCellsFunctor
+
+} // namespace ppkMHD
+
+#endif // BOUNDARY_ENGINE_H_
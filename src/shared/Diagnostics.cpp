@@ -0,0 +1,245 @@
+#include "shared/Diagnostics.h"
+
+#include <sstream>
+#include <algorithm>
+#include <cstdlib> // for exit
+#include <iostream>
+
+#ifdef USE_MPI
+#include "utils/mpiUtils/MpiCommCart.h"
+#endif // USE_MPI
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== CLASS Diagnostics IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+Diagnostics::Diagnostics(HydroParams& params, ConfigMap& configMap) :
+  params(params),
+  m_enabled(false),
+  m_nstep(1),
+  m_jsonl(false),
+  m_selected(),
+  m_pending(false),
+  m_file(nullptr)
+{
+
+  m_enabled = configMap.getBool("diagnostics", "enabled", false);
+
+  if (!m_enabled)
+    return;
+
+  // only cell-averaged solvers store local values (see set_local_values)
+  const std::string solver_name = configMap.getString("run", "solver_name", "Unknown");
+
+  if (solver_name.find("SDM") != std::string::npos or
+      solver_name.find("AMR") != std::string::npos)
+  {
+    std::cerr << "Diagnostics: not provided by solver " << solver_name
+              << ", disable [diagnostics]\n";
+    exit(EXIT_FAILURE);
+  }
+
+  m_nstep = configMap.getInteger("diagnostics", "nstep",
+                                 configMap.getInteger("run", "nlog", 10));
+  if (m_nstep < 1)
+    m_nstep = 1;
+
+  std::string format = configMap.getString("diagnostics", "format", "csv");
+  m_jsonl = (format == "jsonl" or format == "json");
+
+  /*
+   * parse the list of diagnostics to write
+   */
+  std::string variables = configMap.getString("diagnostics", "variables", "all");
+  std::istringstream stream(variables);
+  std::string token;
+  while (std::getline(stream, token, ','))
+  {
+    // remove blanks
+    token.erase(std::remove(token.begin(), token.end(), ' '), token.end());
+
+    for (int id = 0; id < DIAG_NB; ++id)
+    {
+      if (id == DIAG_INVDT)
+        continue;
+
+      if (token == "all" or token == name(id))
+      {
+        if (std::find(m_selected.begin(), m_selected.end(), id) == m_selected.end())
+          m_selected.push_back(id);
+      }
+    }
+  }
+
+  // magnetic quantities only make sense for MHD
+  if (!params.mhdEnabled)
+  {
+    m_selected.erase(std::remove(m_selected.begin(), m_selected.end(), (int) DIAG_ENERGY_MAGNETIC),
+                     m_selected.end());
+    m_selected.erase(std::remove(m_selected.begin(), m_selected.end(), (int) DIAG_DIVB_MAX),
+                     m_selected.end());
+  }
+
+  std::sort(m_selected.begin(), m_selected.end());
+
+  for (int id = 0; id < DIAG_NB; ++id)
+    m_local[id] = 0.0;
+
+  /*
+   * open output file (rank 0 only)
+   */
+  int myRank = 0;
+#ifdef USE_MPI
+  myRank = params.myRank;
+#endif // USE_MPI
+
+  if (myRank == 0)
+  {
+
+    std::string outputDir    = configMap.getString("output", "outputDir", "./");
+    std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+    std::string filename = configMap.getString("diagnostics", "filename",
+                                               outputDir + "/" + outputPrefix + "_diagnostics" +
+                                               (m_jsonl ? ".jsonl" : ".csv"));
+
+    // a restart run appends to the existing time series
+    const bool restart = configMap.getInteger("run", "restart_enabled", 0) != 0;
+
+    m_file = fopen(filename.c_str(), restart ? "a" : "w");
+
+    if (m_file == nullptr)
+    {
+      std::cerr << "Diagnostics: unable to open " << filename << ", diagnostics disabled\n";
+    }
+    else if (!m_jsonl and !restart)
+    {
+      fprintf(m_file, "iteration,time,dt");
+      for (int id : m_selected)
+        fprintf(m_file, ",%s", name(id));
+      fprintf(m_file, "\n");
+      fflush(m_file);
+    }
+
+  }
+
+} // Diagnostics::Diagnostics
+
+// =======================================================
+// =======================================================
+Diagnostics::~Diagnostics()
+{
+
+  if (m_file)
+    fclose(m_file);
+
+} // Diagnostics::~Diagnostics
+
+// =======================================================
+// =======================================================
+void
+Diagnostics::set_local_values(const double (&values)[DIAG_NB])
+{
+
+  for (int id = 0; id < DIAG_NB; ++id)
+    m_local[id] = values[id];
+
+  m_pending = true;
+
+} // Diagnostics::set_local_values
+
+// =======================================================
+// =======================================================
+void
+Diagnostics::write(int iteration, double time, double dt)
+{
+
+  if (!m_pending)
+    return;
+
+  m_pending = false;
+
+  double global[DIAG_NB];
+
+#ifdef USE_MPI
+
+  // a single collective for both sums and maxima
+  const int nProcs = params.nProcs;
+  std::vector<double> all(nProcs*DIAG_NB);
+
+  params.communicator->allGather(m_local, DIAG_NB, hydroSimu::MpiComm::DOUBLE,
+                                 all.data(), DIAG_NB, hydroSimu::MpiComm::DOUBLE);
+
+  for (int id = 0; id < DIAG_NB; ++id)
+  {
+    global[id] = all[id];
+    for (int p = 1; p < nProcs; ++p)
+    {
+      const double v = all[p*DIAG_NB + id];
+      global[id] = id < DIAG_NB_SUM ? global[id] + v : std::max(global[id], v);
+    }
+  }
+
+#else
+
+  for (int id = 0; id < DIAG_NB; ++id)
+    global[id] = m_local[id];
+
+#endif // USE_MPI
+
+  // minimum density was max-reduced as -rho
+  global[DIAG_RHO_MIN] = -global[DIAG_RHO_MIN];
+
+  if (m_file == nullptr)
+    return;
+
+  if (m_jsonl)
+  {
+    fprintf(m_file, "{\"iteration\":%d,\"time\":%.10e,\"dt\":%.10e", iteration, time, dt);
+    for (int id : m_selected)
+      fprintf(m_file, ",\"%s\":%.10e", name(id), global[id]);
+    fprintf(m_file, "}\n");
+  }
+  else
+  {
+    fprintf(m_file, "%d,%.10e,%.10e", iteration, time, dt);
+    for (int id : m_selected)
+      fprintf(m_file, ",%.10e", global[id]);
+    fprintf(m_file, "\n");
+  }
+
+  // keep the time series readable while the run is going on
+  fflush(m_file);
+
+} // Diagnostics::write
+
+// =======================================================
+// =======================================================
+const char*
+Diagnostics::name(int id)
+{
+
+  switch (id)
+  {
+  case DIAG_MASS:            return "mass";
+  case DIAG_MOMENTUM_X:      return "momentum_x";
+  case DIAG_MOMENTUM_Y:      return "momentum_y";
+  case DIAG_MOMENTUM_Z:      return "momentum_z";
+  case DIAG_ENERGY_TOTAL:    return "energy_total";
+  case DIAG_ENERGY_KINETIC:  return "energy_kinetic";
+  case DIAG_ENERGY_MAGNETIC: return "energy_magnetic";
+  case DIAG_INVDT:           return "invdt";
+  case DIAG_RHO_MAX:         return "rho_max";
+  case DIAG_RHO_MIN:         return "rho_min";
+  case DIAG_MACH_MAX:        return "mach_max";
+  case DIAG_DIVB_MAX:        return "divb_max";
+  default:                   return "unknown";
+  }
+
+} // Diagnostics::name
+
+} // namespace ppkMHD
@@ -0,0 +1,117 @@
+/**
+ * \file Diagnostics.h
+ * \brief In-situ global diagnostics (integrated quantities and extrema),
+ * appended to a CSV or JSON-lines time series.
+ */
+#ifndef DIAGNOSTICS_H_
+#define DIAGNOSTICS_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "shared/HydroParams.h"
+#include "utils/config/ConfigMap.h"
+
+namespace ppkMHD
+{
+
+/**
+ * Global diagnostics, all computed by a single reduction kernel
+ * (see DiagnosticsFunctors.h).
+ *
+ * The first DIAG_NB_SUM values are integrated over the domain (sum
+ * reduction), the others are extrema (max reduction). The minimum density
+ * is stored as -rho so that it can be max-reduced as well.
+ */
+enum DiagnosticsId
+{
+  DIAG_MASS = 0,
+  DIAG_MOMENTUM_X,
+  DIAG_MOMENTUM_Y,
+  DIAG_MOMENTUM_Z,
+  DIAG_ENERGY_TOTAL,
+  DIAG_ENERGY_KINETIC,
+  DIAG_ENERGY_MAGNETIC,
+  DIAG_INVDT,  /*!< fused CFL reduction, not written */
+  DIAG_RHO_MAX,
+  DIAG_RHO_MIN,
+  DIAG_MACH_MAX,
+  DIAG_DIVB_MAX,
+  DIAG_NB
+}; // enum DiagnosticsId
+
+//! number of sum-reduced diagnostics (the others are max-reduced)
+constexpr int DIAG_NB_SUM = DIAG_INVDT;
+
+/**
+ * In-situ diagnostics manager.
+ *
+ * Parameters read in section [diagnostics]:
+ * - enabled (default false)
+ * - nstep: number of time steps between two records (default [run] nlog)
+ * - variables: comma separated list among mass, momentum_x, momentum_y,
+ *   momentum_z, energy_total, energy_kinetic, energy_magnetic, rho_max,
+ *   rho_min, mach_max, divb_max, or "all" (default). Magnetic quantities
+ *   are ignored for pure hydro runs.
+ * - format: csv (default) or jsonl
+ * - filename (default outputDir/outputPrefix_diagnostics.csv or .jsonl)
+ *
+ * Solvers store their local reduction results with set_local_values
+ * (usually from compute_dt_local, the diagnostics kernel also computing
+ * the CFL condition); SolverBase::compute_dt then calls write, which
+ * performs one MPI collective and lets rank 0 append a record.
+ *
+ * Currently provided by the MUSCL hydro and MHD solvers and the MOOD
+ * solver; enabling diagnostics with an SDM or AMR solver aborts the run.
+ */
+class Diagnostics
+{
+
+public:
+  Diagnostics(HydroParams& params, ConfigMap& configMap);
+  ~Diagnostics();
+
+  //! are diagnostics enabled at all ?
+  bool enabled() const { return m_enabled; }
+
+  //! should diagnostics be computed at this iteration ?
+  bool is_due(int iteration) const
+  {
+    return m_enabled and (iteration % m_nstep == 0);
+  }
+
+  //! store the reduction results of the current MPI process
+  void set_local_values(const double (&values)[DIAG_NB]);
+
+  /**
+   * Reduce local values over all MPI processes and append a record;
+   * does nothing if no local values were stored since the last call.
+   */
+  void write(int iteration, double time, double dt);
+
+  //! name used in the parameter file and in output header
+  static const char* name(int id);
+
+private:
+  HydroParams& params;
+
+  bool m_enabled;
+  int  m_nstep;
+  bool m_jsonl;
+
+  //! diagnostics to write (DiagnosticsId)
+  std::vector<int> m_selected;
+
+  //! local values waiting to be written ?
+  bool   m_pending;
+  double m_local[DIAG_NB];
+
+  //! output file (rank 0 only)
+  FILE* m_file;
+
+}; // class Diagnostics
+
+} // namespace ppkMHD
+
+#endif // DIAGNOSTICS_H_
@@ -0,0 +1,207 @@
+/**
+ * \file DiagnosticsFunctors.h
+ * \brief Device functor computing all global diagnostics (see
+ * Diagnostics.h) in a single reduction, fused with the CFL time step.
+ */
+#ifndef DIAGNOSTICS_FUNCTORS_H_
+#define DIAGNOSTICS_FUNCTORS_H_
+
+#include <limits> // for std::numeric_limits
+#include <type_traits>
+#ifdef __CUDA_ARCH__
+#include <math_constants.h>
+#endif // __CUDA_ARCH__
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/enums.h"
+#include "shared/KernelParams.h"
+#include "shared/Diagnostics.h"
+
+namespace ppkMHD
+{
+
+/**
+ * Compute the global diagnostics of Udata (conservative variables, face
+ * centered magnetic field for MHD) and the CFL condition in the same pass.
+ *
+ * DtFunctor is one of the existing time step reduce (max) functors
+ * (ComputeDtFunctor2D/3D, ComputeDtGravityFunctor2D/3D,
+ * ComputeDtFunctor2D/3D_MHD, MOOD ComputeDtFunctor2d/3d); its operator()
+ * is called on each cell so that the returned invDt is exactly the one
+ * it would compute alone.
+ */
+template<int dim, class DtFunctor>
+class ComputeDiagnosticsFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  //! array reduction: DIAG_NB values (sums first, then maxima)
+  using value_type = double[];
+  const unsigned value_count = DIAG_NB;
+
+  ComputeDiagnosticsFunctor(KernelParams params,
+			    DataArray    Udata,
+			    DtFunctor    dtFunctor,
+			    bool         mhdEnabled) :
+    params(params), Udata(Udata), dtFunctor(dtFunctor),
+    mhdEnabled(mhdEnabled)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(KernelParams params,
+		    DataArray    Udata,
+		    DtFunctor    dtFunctor,
+		    bool         mhdEnabled,
+		    int          nbCells,
+		    Diagnostics& diagnostics,
+		    real_t&      invDt)
+  {
+    double values[DIAG_NB];
+    ComputeDiagnosticsFunctor<dim,DtFunctor> functor(params, Udata, dtFunctor, mhdEnabled);
+    Kokkos::parallel_reduce("ComputeDiagnosticsFunctor", nbCells, functor, values);
+
+    invDt = values[DIAG_INVDT];
+    diagnostics.set_local_values(values);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void init (value_type dst) const
+  {
+    for (int n=0; n<DIAG_NB_SUM; ++n)
+      dst[n] = 0;
+
+    // The identity under max is -Inf.
+    for (int n=DIAG_NB_SUM; n<DIAG_NB; ++n) {
+#ifdef __CUDA_ARCH__
+      dst[n] = -CUDART_INF;
+#else
+      dst[n] = -std::numeric_limits<double>::max();
+#endif // __CUDA_ARCH__
+    }
+  } // init
+
+  //! conservative variable ivar of cell (i,j,k); k is ignored in 2D
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==2, int>::type i,
+	     int j, int k, int ivar) const
+  {
+    return Udata(i,j,ivar);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==3, int>::type i,
+	     int j, int k, int ivar) const
+  {
+    return Udata(i,j,k,ivar);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index, value_type dst) const
+  {
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+    const int ghostWidth = params.ghostWidth;
+    const real_t gamma0 = params.settings.gamma0;
+    const real_t dx = params.dx;
+    const real_t dy = params.dy;
+    const real_t dz = params.dz;
+
+    // fused time step computation
+    real_t invDt = dst[DIAG_INVDT];
+    dtFunctor(index, invDt);
+    dst[DIAG_INVDT] = invDt;
+
+    int i,j,k=0;
+    if (dim==2)
+      index2coord(index,i,j,isize,jsize);
+    else
+      index2coord(index,i,j,k,isize,jsize,ksize);
+
+    if ( (dim==2 or (k >= ghostWidth && k < ksize - ghostWidth)) &&
+	 j >= ghostWidth && j < jsize - ghostWidth &&
+	 i >= ghostWidth && i < isize - ghostWidth) {
+
+      const real_t dV = dx*dy*(dim==3 ? dz : 1);
+
+      const real_t rho = get(i,j,k,ID);
+      const real_t e   = get(i,j,k,IP);
+      const real_t mx  = get(i,j,k,IU);
+      const real_t my  = get(i,j,k,IV);
+      // IW only exists for 3D hydro or MHD
+      const real_t mz  = (dim==3 or mhdEnabled) ? get(i,j,k,IW) : 0;
+
+      const real_t ekin = HALF_F*(mx*mx+my*my+mz*mz)/rho;
+
+      real_t emag = 0;
+      real_t divB = 0;
+
+      if (mhdEnabled) {
+
+	// cell-centered magnetic field from face-centered values
+	const real_t bx = HALF_F*(get(i,j,k,IA)+get(i+1,j,k,IA));
+	const real_t by = HALF_F*(get(i,j,k,IB)+get(i,j+1,k,IB));
+	const real_t bz = dim==3 ?
+	  HALF_F*(get(i,j,k,IC)+get(i,j,k+1,IC)) :
+	  get(i,j,k,IC);
+
+	emag = HALF_F*(bx*bx+by*by+bz*bz);
+
+	divB =
+	  (get(i+1,j,k,IA)-get(i,j,k,IA))/dx +
+	  (get(i,j+1,k,IB)-get(i,j,k,IB))/dy;
+	if (dim==3)
+	  divB += (get(i,j,k+1,IC)-get(i,j,k,IC))/dz;
+
+      }
+
+      // sound speed and Mach number
+      const real_t p = FMAX((gamma0-ONE_F)*(e-ekin-emag), params.settings.smallp);
+      const real_t c = SQRT(gamma0*p/rho);
+      const real_t mach = SQRT(TWO_F*ekin/rho)/c;
+
+      dst[DIAG_MASS]            += rho*dV;
+      dst[DIAG_MOMENTUM_X]      += mx*dV;
+      dst[DIAG_MOMENTUM_Y]      += my*dV;
+      dst[DIAG_MOMENTUM_Z]      += mz*dV;
+      dst[DIAG_ENERGY_TOTAL]    += e*dV;
+      dst[DIAG_ENERGY_KINETIC]  += ekin*dV;
+      dst[DIAG_ENERGY_MAGNETIC] += emag*dV;
+
+      dst[DIAG_RHO_MAX]  = fmax(dst[DIAG_RHO_MAX],   rho);
+      dst[DIAG_RHO_MIN]  = fmax(dst[DIAG_RHO_MIN],  -rho);
+      dst[DIAG_MACH_MAX] = fmax(dst[DIAG_MACH_MAX],  mach);
+      dst[DIAG_DIVB_MAX] = fmax(dst[DIAG_DIVB_MAX],  FABS(divB));
+
+    }
+
+  } // operator ()
+
+  KOKKOS_INLINE_FUNCTION
+  void join (volatile value_type dst,
+	     const volatile value_type src) const
+  {
+    for (int n=0; n<DIAG_NB_SUM; ++n)
+      dst[n] += src[n];
+
+    for (int n=DIAG_NB_SUM; n<DIAG_NB; ++n)
+      if (dst[n] < src[n])
+	dst[n] = src[n];
+  } // join
+
+  KernelParams params;
+  DataArray    Udata;
+  DtFunctor    dtFunctor;
+  bool         mhdEnabled;
+
+}; // ComputeDiagnosticsFunctor
+
+} // namespace ppkMHD
+
+#endif // DIAGNOSTICS_FUNCTORS_H_
@@ -0,0 +1,229 @@
+#include "shared/Ensemble.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <type_traits>
+
+#include "shared/SolverFactory.h"
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== CLASS Ensemble IMPL ==============================
+// =======================================================
+
+// =======================================================
+// =======================================================
+Ensemble::Ensemble(ConfigMap& configMap) :
+  m_configs(),
+  m_params(),
+  m_solvers(),
+  m_concurrent(false),
+  m_elapsed(0.0)
+{
+
+  const std::string filename = configMap.getString("ensemble", "members", "");
+  const std::string solver_name = configMap.getString("run", "solver_name", "Unknown");
+
+  const std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+
+  std::ifstream members(filename.c_str());
+  if (!members)
+  {
+    std::cerr << "Ensemble: unable to open members file " << filename << "\n";
+    return;
+  }
+
+  std::string line;
+  while (std::getline(members, line))
+  {
+
+    // skip empty lines and comments
+    const size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos or line[first] == '#')
+      continue;
+
+    const int id = m_configs.size();
+
+    ConfigMap* config = new ConfigMap(configMap);
+    apply_overrides(line, *config);
+
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_m%04d", id);
+    config->setString("output", "outputPrefix", outputPrefix + suffix);
+
+    HydroParams* params = new HydroParams();
+    params->setup(*config);
+
+    m_configs.push_back(config);
+    m_params.push_back(params);
+    m_solvers.push_back(SolverFactory::Instance().create(solver_name, *params, *config));
+
+  } // end while getline
+
+  m_concurrent = configMap.getBool("ensemble", "concurrent", true);
+
+#if defined(USE_MPI) || !defined(KOKKOS_ENABLE_OPENMP)
+  m_concurrent = false;
+#else
+  if (!std::is_same<Device, Kokkos::OpenMP>::value)
+    m_concurrent = false;
+#endif
+
+  // concurrent members write their outputs one at a time (logs are
+  // single printf lines and are not serialised)
+  if (m_concurrent)
+    for (SolverBase* solver : m_solvers)
+      solver->set_output_mutex(&m_output_mutex);
+
+} // Ensemble::Ensemble
+
+// =======================================================
+// =======================================================
+Ensemble::~Ensemble()
+{
+
+  for (size_t m=0; m<m_solvers.size(); ++m)
+  {
+    delete m_solvers[m];
+    delete m_params[m];
+    delete m_configs[m];
+  }
+
+} // Ensemble::~Ensemble
+
+// =======================================================
+// =======================================================
+bool
+Ensemble::enabled(ConfigMap& configMap)
+{
+
+  return !configMap.getString("ensemble", "members", "").empty();
+
+} // Ensemble::enabled
+
+// =======================================================
+// =======================================================
+void
+Ensemble::apply_overrides(const std::string& line, ConfigMap& configMap)
+{
+
+  std::istringstream stream(line);
+  std::string token;
+
+  while (stream >> token)
+  {
+    const size_t dot = token.find('.');
+    const size_t eq  = token.find('=');
+
+    if (dot == std::string::npos or eq == std::string::npos or eq < dot)
+    {
+      std::cerr << "Ensemble: ignoring ill-formed override " << token
+                << " (expected section.name=value)\n";
+      continue;
+    }
+
+    configMap.setString(token.substr(0, dot),
+                        token.substr(dot+1, eq-dot-1),
+                        token.substr(eq+1));
+  }
+
+} // Ensemble::apply_overrides
+
+// =======================================================
+// =======================================================
+void
+Ensemble::run_member(SolverBase* solver)
+{
+
+  if (solver->params.nOutput != 0)
+    solver->save_solution();
+
+  solver->timers[TIMER_TOTAL]->start();
+
+  while ( ! solver->finished() )
+  {
+    solver->next_iteration();
+  }
+
+  solver->timers[TIMER_TOTAL]->stop();
+
+  if (solver->params.nOutput != 0)
+    solver->save_solution();
+
+} // Ensemble::run_member
+
+// =======================================================
+// =======================================================
+void
+Ensemble::run()
+{
+
+  const int nb = m_solvers.size();
+
+  SolverBase::Timer timer;
+  timer.start();
+
+  if (m_concurrent)
+  {
+    // each host thread advances whole members; Kokkos kernels dispatched
+    // from inside an OpenMP parallel region run on the calling thread
+#pragma omp parallel for schedule(dynamic,1)
+    for (int m=0; m<nb; ++m)
+      run_member(m_solvers[m]);
+  }
+  else
+  {
+    for (int m=0; m<nb; ++m)
+      run_member(m_solvers[m]);
+  }
+
+  timer.stop();
+  m_elapsed = timer.elapsed();
+
+} // Ensemble::run
+
+// =======================================================
+// =======================================================
+void
+Ensemble::print_monitoring_info() const
+{
+
+  int myRank = 0;
+#ifdef USE_MPI
+  if (!m_params.empty())
+    myRank = m_params[0]->myRank;
+#endif // USE_MPI
+
+  if (myRank != 0)
+    return;
+
+  long long int member_steps = 0;
+
+  printf("##########################\n");
+  printf("Ensemble of %d members (%s)\n", nb_members(),
+         m_concurrent ? "concurrent" : "sequential");
+  printf("member  iterations  final time  total time (s)\n");
+
+  for (int m=0; m<nb_members(); ++m)
+  {
+    const SolverBase* solver = m_solvers[m];
+
+    printf("%6d  %10d  %10.6f  %14.3f\n", m,
+           solver->m_iteration, solver->m_t,
+           solver->timers.at(TIMER_TOTAL)->elapsed());
+
+    member_steps += solver->m_iteration;
+  }
+
+  printf("ensemble    time : %5.3f secondes\n", m_elapsed);
+  if (m_elapsed > 0)
+    printf("Perf (ensemble)  : %5.3f member-steps/s\n", member_steps/m_elapsed);
+  printf("##########################\n");
+
+} // Ensemble::print_monitoring_info
+
+} // namespace ppkMHD
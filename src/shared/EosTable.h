@@ -0,0 +1,271 @@
+/**
+ * \file EosTable.h
+ * \brief Tabulated equation of state: compact descriptor usable inside
+ * Kokkos kernels.
+ */
+#ifndef EOS_TABLE_H_
+#define EOS_TABLE_H_
+
+#include <vector>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+
+/**
+ * Tabulated equation of state.
+ *
+ * Pressure p and squared sound speed c2 are tabulated on a log-spaced
+ * grid of density rho and specific internal energy eint:
+ * - rho_i  = rho_min  * exp(i * dlog_rho),  0 <= i < n_rho
+ * - eint_j = eint_min * exp(j * dlog_eint), 0 <= j < n_eint
+ *
+ * Nodes store (log p, log c2) interleaved, eint index running fastest:
+ * data[2*(i*n_eint+j)+0] = log(p), data[2*(i*n_eint+j)+1] = log(c2).
+ * A bilinear lookup touches 2 pairs of adjacent nodes, i.e. two
+ * contiguous chunks of 4 values.
+ *
+ * Interpolation is bilinear in (log rho, log eint); power laws such as
+ * the ideal gas are reproduced exactly. Outside of the table, values are
+ * linearly extrapolated (in log space) from the border cells.
+ *
+ * The inverse, log eint as a function of (log rho, log p), is tabulated
+ * too (inv_data, n_rho x n_p nodes, log-spaced in pressure between the
+ * extreme pressures of the table, see eos_table_fill_inverse). It only
+ * provides eint_from_pressure with a first guess of the cell, so that the
+ * exact inversion costs a few node reads rather than a bisection; its
+ * accuracy (n_p) affects speed, never the result.
+ *
+ * This structure does not own memory (data points to a device array,
+ * see EquationOfState.h), so that it can be copied into kernels.
+ */
+struct EosTable
+{
+
+  const real_t* data = nullptr;
+
+  int n_rho  = 0;
+  int n_eint = 0;
+
+  real_t log_rho_min  = 0; //!< log of the first density node
+  real_t log_eint_min = 0; //!< log of the first internal energy node
+  real_t inv_dlog_rho  = 0; //!< 1 / log spacing along density
+  real_t inv_dlog_eint = 0; //!< 1 / log spacing along internal energy
+
+  //! inverse table, log eint at (rho_i, p_j), p index running fastest
+  const real_t* inv_data = nullptr;
+  int    n_p        = 0;
+  real_t log_p_min  = 0; //!< log of the first pressure node
+  real_t inv_dlog_p = 0; //!< 1 / log spacing along pressure
+
+  //! lowest specific internal energy passed to lookup by the hydro kernels
+  real_t eint_floor = 0;
+
+  //! node value (k=0 : log p, k=1 : log c2)
+  KOKKOS_INLINE_FUNCTION
+  real_t node(int i, int j, int k) const
+  {
+    return data[2*(i*n_eint+j)+k];
+  }
+
+  //! log p at eint node j, interpolated between density nodes i and i+1
+  KOKKOS_INLINE_FUNCTION
+  real_t row(int i, real_t wr, int j) const
+  {
+    return (ONE_F-wr)*node(i,j,0) + wr*node(i+1,j,0);
+  }
+
+  /**
+   * Locate x (log space coordinate, already scaled by the inverse
+   * spacing) in a table of n nodes: cell index and weight in [0,1]
+   * inside the table, outside of [0,1] when extrapolating.
+   */
+  KOKKOS_INLINE_FUNCTION
+  static void locate(real_t x, int n, int& index, real_t& w)
+  {
+    index = (int) floor(x);
+    index = index < 0 ? 0 : (index > n-2 ? n-2 : index);
+    w = x - index;
+  }
+
+  /**
+   * Pressure and squared speed of sound.
+   *
+   * \param[in]  rho  density
+   * \param[in]  eint specific internal energy
+   * \param[out] p    pressure
+   * \param[out] c2   squared speed of sound
+   */
+  KOKKOS_INLINE_FUNCTION
+  void lookup(real_t rho, real_t eint, real_t& p, real_t& c2) const
+  {
+
+    int i, j;
+    real_t wr, we;
+    locate((log(rho)  - log_rho_min ) * inv_dlog_rho,  n_rho,  i, wr);
+    locate((log(eint) - log_eint_min) * inv_dlog_eint, n_eint, j, we);
+
+    const real_t w00 = (ONE_F-wr)*(ONE_F-we);
+    const real_t w01 = (ONE_F-wr)*we;
+    const real_t w10 = wr*(ONE_F-we);
+    const real_t w11 = wr*we;
+
+    const real_t* n0 = data + 2*(i*n_eint+j);
+    const real_t* n1 = n0 + 2*n_eint;
+
+    p  = exp(w00*n0[0] + w01*n0[2] + w10*n1[0] + w11*n1[2]);
+    c2 = exp(w00*n0[1] + w01*n0[3] + w10*n1[1] + w11*n1[3]);
+
+  } // lookup
+
+  /**
+   * Inversion: specific internal energy from density and pressure, exact
+   * inversion of the bilinear interpolant.
+   *
+   * At fixed density, log p is piecewise linear in log eint (and
+   * increasing); the cell row(lo) <= log p < row(lo+1) (clamped to the
+   * border cells) is found, then log eint is solved exactly inside it.
+   *
+   * With an inverse table, the cell search starts from the cell guessed
+   * by a bilinear lookup in it and walks to the right cell (usually zero
+   * or one step); without one, or to build it, it is a bisection. Both
+   * give the same cell, hence the same result.
+   */
+  KOKKOS_INLINE_FUNCTION
+  real_t eint_from_pressure(real_t rho, real_t p) const
+  {
+
+    int i;
+    real_t wr;
+    locate((log(rho) - log_rho_min) * inv_dlog_rho, n_rho, i, wr);
+
+    const real_t logp = log(p);
+
+    int lo;
+
+    if (inv_data) {
+
+      int j;
+      real_t wp, we;
+      locate((logp - log_p_min) * inv_dlog_p, n_p, j, wp);
+
+      const real_t* n0 = inv_data + i*n_p+j;
+      const real_t* n1 = n0 + n_p;
+
+      const real_t log_eint = (ONE_F-wr)*((ONE_F-wp)*n0[0] + wp*n0[1]) +
+	wr*((ONE_F-wp)*n1[0] + wp*n1[1]);
+
+      locate((log_eint - log_eint_min) * inv_dlog_eint, n_eint, lo, we);
+
+      while (lo > 0 and row(i,wr,lo) > logp)
+	--lo;
+      while (lo < n_eint-2 and row(i,wr,lo+1) <= logp)
+	++lo;
+
+    } else {
+
+      // bisection on cell index: row(lo) <= logp < row(hi), clamped
+      lo = 0;
+      int hi = n_eint-1;
+      while (hi-lo > 1) {
+	const int mid = (lo+hi)/2;
+	if (row(i,wr,mid) <= logp)
+	  lo = mid;
+	else
+	  hi = mid;
+      }
+
+    }
+
+    const real_t f0 = row(i,wr,lo);
+    const real_t f1 = row(i,wr,lo+1);
+    const real_t we = (logp - f0) / (f1 - f0);
+
+    return exp(log_eint_min + (lo + we) / inv_dlog_eint);
+
+  } // eint_from_pressure
+
+}; // struct EosTable
+
+/**
+ * Fill host table nodes for an ideal gas (mostly for testing the table
+ * machinery, interpolation is exact in that case).
+ *
+ * \param[out] nodes 2*n_rho*n_eint values, see EosTable
+ */
+inline void eos_table_fill_ideal_gas(std::vector<real_t>& nodes,
+				     int n_rho, int n_eint,
+				     real_t rho_min, real_t rho_max,
+				     real_t eint_min, real_t eint_max,
+				     real_t gamma0)
+{
+
+  nodes.resize(2*n_rho*n_eint);
+
+  const real_t dlog_rho  = log(rho_max/rho_min)   / (n_rho-1);
+  const real_t dlog_eint = log(eint_max/eint_min) / (n_eint-1);
+
+  for (int i=0; i<n_rho; ++i) {
+    const real_t rho = rho_min * exp(i*dlog_rho);
+    for (int j=0; j<n_eint; ++j) {
+      const real_t eint = eint_min * exp(j*dlog_eint);
+      const real_t p = (gamma0-ONE_F) * rho * eint;
+      nodes[2*(i*n_eint+j)+0] = log(p);
+      nodes[2*(i*n_eint+j)+1] = log(gamma0 * p / rho);
+    }
+  }
+
+} // eos_table_fill_ideal_gas
+
+/**
+ * Fill host inverse table nodes (log eint at density node i and pressure
+ * node j, see EosTable), from a table whose forward nodes are set and
+ * accessible on host.
+ *
+ * Pressure nodes are log-spaced between the lowest and highest pressure
+ * of the forward table; at density nodes where the pressure range is
+ * narrower, the inverse is extrapolated as eint_from_pressure does.
+ * Nodes are computed by bisection (inv_data of table is ignored).
+ *
+ * \param[in]  table      forward table (host data)
+ * \param[in]  n_p        number of pressure nodes
+ * \param[out] inv_nodes  n_rho*n_p values
+ * \param[out] log_p_min  log of the first pressure node
+ * \param[out] inv_dlog_p 1 / log spacing along pressure
+ */
+inline void eos_table_fill_inverse(const EosTable& table,
+				   int n_p,
+				   std::vector<real_t>& inv_nodes,
+				   real_t& log_p_min,
+				   real_t& inv_dlog_p)
+{
+
+  EosTable forward = table;
+  forward.inv_data = nullptr;
+
+  real_t log_p_max = table.node(0,0,0);
+  log_p_min = log_p_max;
+  for (int i=0; i<table.n_rho; ++i) {
+    for (int j=0; j<table.n_eint; ++j) {
+      log_p_min = fmin(log_p_min, table.node(i,j,0));
+      log_p_max = fmax(log_p_max, table.node(i,j,0));
+    }
+  }
+
+  const real_t dlog_p = (log_p_max - log_p_min) / (n_p-1);
+  inv_dlog_p = ONE_F / dlog_p;
+
+  const real_t dlog_rho = ONE_F / table.inv_dlog_rho;
+
+  inv_nodes.resize(table.n_rho*n_p);
+
+  for (int i=0; i<table.n_rho; ++i) {
+    const real_t rho = exp(table.log_rho_min + i*dlog_rho);
+    for (int j=0; j<n_p; ++j) {
+      const real_t p = exp(log_p_min + j*dlog_p);
+      inv_nodes[i*n_p+j] = log(forward.eint_from_pressure(rho, p));
+    }
+  }
+
+} // eos_table_fill_inverse
+
+#endif // EOS_TABLE_H_
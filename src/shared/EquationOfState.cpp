@@ -0,0 +1,191 @@
+#include "shared/EquationOfState.h"
+
+#include <algorithm>
+#include <cstdlib> // for exit
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "shared/utils.h" // for UNUSED
+
+namespace ppkMHD {
+
+#ifdef USE_TABULATED_EOS
+// =======================================================
+// =======================================================
+/**
+ * Read an ASCII table file (see EquationOfState.h) and convert it to
+ * table nodes (log p, log c2).
+ *
+ * \return false if the file can't be read or is inconsistent
+ */
+static bool eos_read_table(const std::string& filename,
+                           std::vector<real_t>& nodes,
+                           int& n_rho, int& n_eint,
+                           real_t& rho_min, real_t& rho_max,
+                           real_t& eint_min, real_t& eint_max)
+{
+
+  std::ifstream in(filename.c_str());
+  if (!in)
+    return false;
+
+  bool header = false;
+  long long int count = 0;
+  std::string line;
+
+  while (std::getline(in, line))
+  {
+
+    if (line.empty() or line[0] == '#')
+      continue;
+
+    std::istringstream iss(line);
+
+    if (!header)
+    {
+      if (!(iss >> n_rho >> n_eint >> rho_min >> rho_max >> eint_min >> eint_max))
+        return false;
+      if (n_rho < 2 or n_eint < 2 or rho_min <= 0 or eint_min <= 0 or
+          rho_max <= rho_min or eint_max <= eint_min)
+        return false;
+      nodes.resize(2*n_rho*n_eint);
+      header = true;
+      continue;
+    }
+
+    real_t p, c2;
+    if (!(iss >> p >> c2) or p <= 0 or c2 <= 0 or count >= n_rho*n_eint)
+      return false;
+
+    nodes[2*count+0] = log(p);
+    nodes[2*count+1] = log(c2);
+    ++count;
+
+  }
+
+  return header and count == n_rho*n_eint;
+
+} // eos_read_table
+#endif // USE_TABULATED_EOS
+
+// =======================================================
+// =======================================================
+void eos_setup(HydroParams& params, ConfigMap& configMap)
+{
+
+  const std::string type = configMap.getString("eos", "type", "ideal");
+
+  if (!type.compare("ideal"))
+    return;
+
+  if (type.compare("tabulated"))
+  {
+    std::cerr << "eos_setup: unknown eos type " << type << " (ideal or tabulated)\n";
+    exit(EXIT_FAILURE);
+  }
+
+  // only the MUSCL hydro kernels and the llf / hll / hllc Riemann
+  // solvers go through the table
+  const std::string solver_name = configMap.getString("run", "solver_name", "Unknown");
+
+  if (solver_name.find("MHD")  != std::string::npos or
+      solver_name.find("SDM")  != std::string::npos or
+      solver_name.find("Mood") != std::string::npos)
+  {
+    std::cerr << "eos_setup: tabulated EOS is not supported by solver " << solver_name
+              << " (ideal gas only)\n";
+    exit(EXIT_FAILURE);
+  }
+
+  if (params.riemannSolverType == RIEMANN_APPROX)
+  {
+    std::cerr << "eos_setup: tabulated EOS is not supported by riemann=approx "
+              << "(ideal gas solver), use llf, hll or hllc\n";
+    exit(EXIT_FAILURE);
+  }
+
+#ifdef USE_TABULATED_EOS
+
+  const std::string filename = configMap.getString("eos", "table_file", "");
+
+  std::vector<real_t> nodes;
+  int n_rho, n_eint;
+  real_t rho_min, rho_max, eint_min, eint_max;
+
+  if (filename.empty())
+  {
+
+    n_rho    = configMap.getInteger("eos", "n_rho",  128);
+    n_eint   = configMap.getInteger("eos", "n_eint", 128);
+    rho_min  = configMap.getFloat("eos", "rho_min",  1e-6);
+    rho_max  = configMap.getFloat("eos", "rho_max",  1e6);
+    eint_min = configMap.getFloat("eos", "eint_min", 1e-6);
+    eint_max = configMap.getFloat("eos", "eint_max", 1e6);
+
+    eos_table_fill_ideal_gas(nodes, n_rho, n_eint,
+                             rho_min, rho_max, eint_min, eint_max,
+                             params.settings.gamma0);
+
+  }
+  else if (!eos_read_table(filename, nodes, n_rho, n_eint,
+                           rho_min, rho_max, eint_min, eint_max))
+  {
+    std::cerr << "eos_setup: can't read EOS table " << filename << "\n";
+    exit(EXIT_FAILURE);
+  }
+
+  EosTable table;
+  table.data          = nodes.data();
+  table.n_rho         = n_rho;
+  table.n_eint        = n_eint;
+  table.log_rho_min   = log(rho_min);
+  table.log_eint_min  = log(eint_min);
+  table.inv_dlog_rho  = (n_rho-1)  / log(rho_max/rho_min);
+  table.inv_dlog_eint = (n_eint-1) / log(eint_max/eint_min);
+
+  table.eint_floor = configMap.getFloat("eos", "eint_floor", eint_min);
+  if (table.eint_floor <= 0)
+  {
+    std::cerr << "eos_setup: eint_floor must be positive\n";
+    exit(EXIT_FAILURE);
+  }
+
+  // inverse table eint(rho,p), built on host from the forward one
+  table.n_p = std::max(configMap.getInteger("eos", "n_p", 2*n_eint), 2);
+
+  std::vector<real_t> inv_nodes;
+  eos_table_fill_inverse(table, table.n_p, inv_nodes,
+                         table.log_p_min, table.inv_dlog_p);
+
+  // copy nodes to device: forward nodes, then inverse nodes
+  params.eos_table_data = Kokkos::View<real_t*, Device>("eos_table",
+                                                        nodes.size() + inv_nodes.size());
+  Kokkos::View<real_t*, Device>::HostMirror data_host =
+    Kokkos::create_mirror_view(params.eos_table_data);
+  for (size_t n=0; n<nodes.size(); ++n)
+    data_host(n) = nodes[n];
+  for (size_t n=0; n<inv_nodes.size(); ++n)
+    data_host(nodes.size()+n) = inv_nodes[n];
+  Kokkos::deep_copy(params.eos_table_data, data_host);
+
+  table.data     = params.eos_table_data.data();
+  table.inv_data = params.eos_table_data.data() + nodes.size();
+
+  params.settings.eos = table;
+
+#else
+
+  UNUSED(params);
+  std::cerr << "eos_setup: tabulated EOS requested, but ppkMHD was built without it "
+            << "(cmake option USE_TABULATED_EOS)\n";
+  exit(EXIT_FAILURE);
+
+#endif // USE_TABULATED_EOS
+
+} // eos_setup
+
+} // namespace ppkMHD
@@ -0,0 +1,152 @@
+/**
+ * \file EquationOfState.h
+ * \brief Equation of state used by the hydro kernels.
+ *
+ * Two implementations:
+ * - ideal gas (calorically perfect gas, \f$ p = (\gamma-1) \rho e \f$),
+ *   always available,
+ * - tabulated (see EosTable.h), only compiled when USE_TABULATED_EOS is
+ *   defined (cmake option USE_TABULATED_EOS).
+ *
+ * When USE_TABULATED_EOS is not defined, the routines below reduce to the
+ * ideal gas formulas (exactly as they were written in the kernels), so
+ * that the default build pays nothing for the EOS layer. When it is
+ * defined, the tabulated EOS is used if a table was loaded (parameter
+ * file section [eos], type=tabulated), the ideal gas otherwise.
+ *
+ * Notes on the tabulated EOS:
+ * - it is used by the MUSCL hydro kernels and the hydro Riemann
+ *   solvers; MHD, MOOD and SDM schemes are ideal gas only, and
+ *   eos_setup aborts when one of them is combined with a table,
+ * - initial conditions are defined with gamma0, then their total energy
+ *   is recomputed through the table (same pressure),
+ * - the approximate Riemann solver (riemann=approx) is an ideal gas
+ *   solver, eos_setup aborts when it is requested; use llf, hll or hllc.
+ */
+#ifndef EQUATION_OF_STATE_H_
+#define EQUATION_OF_STATE_H_
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/HydroParams.h"
+#include "shared/EosTable.h"
+#include "utils/config/ConfigMap.h"
+
+namespace ppkMHD {
+
+/**
+ * Pressure and speed of sound from density and specific internal
+ * energy; pressure is bounded below by rho*smallp, and with a table,
+ * specific internal energy by the table eint_floor.
+ *
+ * \param[in]  settings hydro settings (gamma0, smallp, table)
+ * \param[in]  rho  density
+ * \param[in]  eint specific internal energy
+ * \param[out] p    pressure
+ * \param[out] c    speed of sound
+ */
+KOKKOS_INLINE_FUNCTION
+void eos_compute(const HydroSettings& settings,
+		 real_t rho,
+		 real_t eint,
+		 real_t& p,
+		 real_t& c)
+{
+
+  const real_t gamma0 = settings.gamma0;
+  const real_t smallp = settings.smallp;
+
+#ifdef USE_TABULATED_EOS
+  if (settings.eos.data) {
+    real_t c2;
+    settings.eos.lookup(rho, FMAX(eint, settings.eos.eint_floor), p, c2);
+    p = FMAX(p, rho * smallp);
+    c = SQRT(c2);
+    return;
+  }
+#endif // USE_TABULATED_EOS
+
+  p = FMAX((gamma0 - ONE_F) * rho * eint, rho * smallp);
+  c = SQRT(gamma0 * p / rho);
+
+} // eos_compute
+
+/**
+ * Internal energy per unit volume (rho * eint) from density and
+ * pressure (ideal gas : p / (gamma0-1)).
+ */
+KOKKOS_INLINE_FUNCTION
+real_t eos_internal_energy(const HydroSettings& settings,
+			   real_t rho,
+			   real_t p)
+{
+
+#ifdef USE_TABULATED_EOS
+  if (settings.eos.data) {
+    rho = FMAX(rho, settings.smallr);
+    return rho * settings.eos.eint_from_pressure(rho, FMAX(p, rho * settings.smallp));
+  }
+#endif // USE_TABULATED_EOS
+
+  return p * (ONE_F / (settings.gamma0 - ONE_F));
+
+} // eos_internal_energy
+
+/**
+ * rho * c^2 from density and pressure (ideal gas : gamma0 * p); this is
+ * the coefficient of the velocity divergence in the pressure evolution
+ * equation, and rho times the squared speed of sound.
+ *
+ * With a table: inversion started from the inverse table (no bisection),
+ * then a forward lookup.
+ */
+KOKKOS_INLINE_FUNCTION
+real_t eos_rho_c2(const HydroSettings& settings,
+		  real_t rho,
+		  real_t p)
+{
+
+#ifdef USE_TABULATED_EOS
+  if (settings.eos.data) {
+    rho = FMAX(rho, settings.smallr);
+    p   = FMAX(p, rho * settings.smallp);
+    real_t ptab, c2;
+    settings.eos.lookup(rho, settings.eos.eint_from_pressure(rho, p), ptab, c2);
+    return rho * c2;
+  }
+#endif // USE_TABULATED_EOS
+
+  return settings.gamma0 * p;
+
+} // eos_rho_c2
+
+/**
+ * Read section [eos] of the parameter file, and when a tabulated EOS is
+ * requested, load (or build) the table on device and register it in
+ * params.settings.
+ *
+ * Parameters:
+ * - type: ideal (default) or tabulated
+ * - table_file: ASCII table (see below); when empty, an ideal gas table
+ *   with gamma0 is built (useful to check the table machinery)
+ * - n_rho, n_eint, rho_min, rho_max, eint_min, eint_max: size and bounds
+ *   of the built table (defaults 128, 128, 1e-6, 1e6, 1e-6, 1e6)
+ * - n_p: number of pressure nodes of the inverse table eint(rho,p), which
+ *   gives the first guess of the exact inversion (default 2*n_eint)
+ * - eint_floor: lowest specific internal energy seen by the table in the
+ *   hydro kernels (default: eint_min of the table, no extrapolation below
+ *   the table)
+ *
+ * A tabulated EOS can't be combined with MHD, SDM or MOOD solvers, nor
+ * with riemann=approx (the run aborts).
+ *
+ * Table file format: lines starting with # are comments; first line is
+ * "n_rho n_eint rho_min rho_max eint_min eint_max", followed by
+ * n_rho*n_eint lines "p c2" (pressure and squared sound speed), eint
+ * index running fastest. Nodes are log-spaced between the bounds.
+ */
+void eos_setup(HydroParams& params, ConfigMap& configMap);
+
+} // namespace ppkMHD
+
+#endif // EQUATION_OF_STATE_H_
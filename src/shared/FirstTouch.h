@@ -0,0 +1,100 @@
+/**
+ * \file FirstTouch.h
+ * \brief Allocation of solver arrays without zero-initialization, followed
+ * by a parallel first touch.
+ *
+ * Default Kokkos allocation zero-fills a view with a kernel of its own,
+ * whose iteration pattern has nothing to do with the one of the compute
+ * kernels. On multi-socket hosts, pages are mapped to the NUMA domain of
+ * the thread touching them first, so arrays are allocated uninitialized
+ * and then zeroed by a kernel iterating over cells with the same flat
+ * cell index as the compute kernels: each thread first touches (and later
+ * computes on) the same contiguous part of the array.
+ */
+#ifndef FIRST_TOUCH_H_
+#define FIRST_TOUCH_H_
+
+#include <string>
+
+#include "shared/kokkos_shared.h"
+
+namespace ppkMHD
+{
+
+/**
+ * Zero a view, one iteration per cell.
+ *
+ * The view memory is split into nbCells contiguous chunks (all the values
+ * attached to a cell, e.g. variables or degrees of freedom, when the last
+ * index is the fastest), chunk index being the flat cell index.
+ */
+template<class ViewType>
+class FirstTouchFunctor
+{
+
+public:
+  using value_type = typename ViewType::non_const_value_type;
+
+  FirstTouchFunctor(ViewType data, int nbCells) :
+    data(data), nbCells(nbCells)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(ViewType data, int nbCells)
+  {
+    FirstTouchFunctor<ViewType> functor(data, nbCells);
+    Kokkos::parallel_for("FirstTouchFunctor", nbCells, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const size_t span  = data.span();
+    const size_t chunk = (span + nbCells - 1) / nbCells;
+    const size_t begin = index*chunk;
+    const size_t end   = begin+chunk < span ? begin+chunk : span;
+
+    value_type* ptr = data.data();
+    for (size_t n=begin; n<end; ++n)
+      ptr[n] = 0;
+  }
+
+  ViewType data;
+  int      nbCells;
+
+}; // FirstTouchFunctor
+
+/**
+ * Allocate a view without initialization, then zero it with
+ * FirstTouchFunctor.
+ *
+ * \param[in] label view label
+ * \param[in] nbCells number of cells (ghost included) the view is defined on
+ * \param[in] dims view extents
+ */
+template<class ViewType, class... Dims>
+ViewType allocate_first_touch(const std::string& label, int nbCells, Dims... dims)
+{
+  ViewType data(Kokkos::view_alloc(Kokkos::WithoutInitializing, label), dims...);
+  FirstTouchFunctor<ViewType>::apply(data, nbCells);
+  return data;
+}
+
+/**
+ * Allocate (uninitialized) the host mirror of a device view, unless it
+ * already exists. Meant to be called right before an output or a restart,
+ * so that runs without IO never allocate host memory for the solution.
+ */
+template<class ViewType>
+void allocate_host_mirror(const ViewType& data,
+			  typename ViewType::HostMirror& data_host)
+{
+  if (data_host.span() != data.span())
+    data_host = typename ViewType::HostMirror(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+								 data.label()+"_host"),
+					      data.layout());
+}
+
+} // namespace ppkMHD
+
+#endif // FIRST_TOUCH_H_
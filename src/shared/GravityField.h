@@ -0,0 +1,177 @@
+/**
+ * \file GravityField.h
+ * \brief Gravity field provider used inside Kokkos kernels.
+ */
+#ifndef GRAVITY_FIELD_H_
+#define GRAVITY_FIELD_H_
+
+#include <type_traits>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/enums.h"
+#include "shared/HydroParams.h"
+#include "shared/problems/PointSourceGravity.h"
+
+/**
+ * Gravity field as seen by device functors.
+ *
+ * Analytic fields (uniform static, point source) are evaluated inline
+ * from cell indexes, so that no array needs to be allocated nor read
+ * from memory. Only fields without an analytic expression (e.g. computed
+ * by a Poisson solver) are stored in a VectorField array.
+ *
+ * Components are accessed the same way as in a VectorField, i.e.
+ * gravity(i,j,IX) in 2D and gravity(i,j,k,IX) in 3D.
+ *
+ * \tparam dim dimension (2 or 3)
+ */
+template<int dim>
+class GravityField
+{
+
+public:
+  //! Decide at compile-time which vector field type to use
+  using VectorField = typename std::conditional<dim==2,VectorField2d,VectorField3d>::type;
+
+  //! default is a uniform zero field
+  GravityField() :
+    type(GRAVITY_FIELD_UNIFORM),
+    field(),
+    g0(),
+    psg(),
+    x0(0.0), y0(0.0), z0(0.0),
+    dx(0.0), dy(0.0), dz(0.0)
+  {
+    g0[IX] = 0.0;
+    g0[IY] = 0.0;
+    g0[IZ] = 0.0;
+  }
+
+  //! uniform static field
+  static GravityField uniform(real_t gx, real_t gy, real_t gz)
+  {
+    GravityField g;
+    g.g0[IX] = gx;
+    g.g0[IY] = gy;
+    g.g0[IZ] = gz;
+    return g;
+  }
+
+  //! point source field (with softening, see PointSourceGravity::eval)
+  static GravityField point_source(const HydroParams& params,
+				   const PointSourceGravity& psg)
+  {
+    GravityField g;
+    g.type = GRAVITY_FIELD_POINT_SOURCE;
+    g.psg  = psg;
+
+#ifdef USE_MPI
+    const int i_mpi = params.myMpiPos[IX];
+    const int j_mpi = params.myMpiPos[IY];
+    const int k_mpi = params.myMpiPos[IZ];
+#else
+    const int i_mpi = 0;
+    const int j_mpi = 0;
+    const int k_mpi = 0;
+#endif // USE_MPI
+
+    const int ghostWidth = params.ghostWidth;
+
+    g.dx = params.dx;
+    g.dy = params.dy;
+    g.dz = params.dz;
+
+    // cell center location of cell (0,0,0), ghost included
+    g.x0 = params.xmin + params.dx/2 + (params.nx*i_mpi-ghostWidth)*params.dx;
+    g.y0 = params.ymin + params.dy/2 + (params.ny*j_mpi-ghostWidth)*params.dy;
+    g.z0 = params.zmin + params.dz/2 + (params.nz*k_mpi-ghostWidth)*params.dz;
+
+    return g;
+  }
+
+  //! field stored in memory (must be filled by the caller)
+  static GravityField stored(VectorField field)
+  {
+    GravityField g;
+    g.type  = GRAVITY_FIELD_STORED;
+    g.field = field;
+    return g;
+  }
+
+  //! is this field stored in memory ?
+  bool is_stored() const { return type == GRAVITY_FIELD_STORED; }
+
+  //! memory footprint in bytes
+  size_t memory_size() const
+  {
+    return is_stored() ? field.span()*sizeof(real_t) : 0;
+  }
+
+  /**
+   * Gravity field component in cell (i,j) - 2D.
+   *
+   * \param[in] i,j cell indexes (ghost included)
+   * \param[in] dir component (IX or IY)
+   */
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  typename std::enable_if<dim_==2, real_t>::type
+  operator()(int i, int j, int dir) const
+  {
+    if (type == GRAVITY_FIELD_STORED)
+      return field(i,j,dir);
+
+    if (type == GRAVITY_FIELD_POINT_SOURCE) {
+      real_t g[3];
+      psg.eval(x0+i*dx, y0+j*dy, 0, g[IX], g[IY], g[IZ]);
+      return g[dir];
+    }
+
+    return g0[dir];
+  }
+
+  /**
+   * Gravity field component in cell (i,j,k) - 3D.
+   *
+   * \param[in] i,j,k cell indexes (ghost included)
+   * \param[in] dir component (IX, IY or IZ)
+   */
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  typename std::enable_if<dim_==3, real_t>::type
+  operator()(int i, int j, int k, int dir) const
+  {
+    if (type == GRAVITY_FIELD_STORED)
+      return field(i,j,k,dir);
+
+    if (type == GRAVITY_FIELD_POINT_SOURCE) {
+      real_t g[3];
+      psg.eval(x0+i*dx, y0+j*dy, z0+k*dz, g[IX], g[IY], g[IZ]);
+      return g[dir];
+    }
+
+    return g0[dir];
+  }
+
+  GravityFieldType type;
+
+  //! only allocated when type is GRAVITY_FIELD_STORED
+  VectorField field;
+
+  //! uniform field value
+  Kokkos::Array<real_t,3> g0;
+
+  //! point source parameters
+  PointSourceGravity psg;
+
+  //! cell (0,0,0) center location and cell sizes (point source only)
+  real_t x0, y0, z0;
+  real_t dx, dy, dz;
+
+}; // class GravityField
+
+using GravityField2d = GravityField<2>;
+using GravityField3d = GravityField<3>;
+
+#endif // GRAVITY_FIELD_H_
@@ -7,6 +7,8 @@
 
 #include "config/inih/ini.h" // our INI file reader
 
+#include "shared/EquationOfState.h"
+
 #ifdef USE_MOOD
 #include "mood/Stencil.h"
 #include "mood/StencilUtils.h"
@@ -208,6 +210,9 @@ void HydroParams::setup(ConfigMap &configMap)
 
   init();
 
+  // equation of state (tabulated EOS)
+  ppkMHD::eos_setup(*this, configMap);
+
 #ifdef USE_MPI
   setup_mpi(configMap);
 #endif // USE_MPI
@@ -221,7 +226,8 @@ void HydroParams::setup_mpi(ConfigMap& configMap)
 {
 
   // runtime determination if we are using float ou double (for MPI communication)
-  data_type = typeid(1.0f).name() == typeid((real_t)1.0f).name() ?
+  // border buffers are data arrays, so use the storage type
+  data_type = typeid(1.0f).name() == typeid((real_storage_t)1.0f).name() ?
               hydroSimu::MpiComm::FLOAT : hydroSimu::MpiComm::DOUBLE;
 
   // MPI parameters :
@@ -495,6 +501,14 @@ void HydroParams::print()
   printf( "cp (specific heat)          : %g\n", settings.cp);
   printf( "mu (dynamic visosity)       : %g\n", settings.mu);
   printf( "kappa (thermal diffusivity) : %g\n", settings.kappa);
+#ifdef USE_TABULATED_EOS
+  if (settings.eos.data)
+    printf( "eos        : tabulated (%d x %d, inverse %d x %d)\n",
+	    settings.eos.n_rho, settings.eos.n_eint,
+	    settings.eos.n_rho, settings.eos.n_p);
+  else
+    printf( "eos        : ideal gas\n");
+#endif // USE_TABULATED_EOS
   //printf( "niter_riemann : %d\n", niter_riemann);
   printf( "iorder     : %d\n", settings.iorder);
   printf( "slope_type : %f\n", settings.slope_type);
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "shared/enums.h"
+#include "shared/EosTable.h"
 
 #ifdef USE_MPI
 #include "utils/mpiUtils/MpiCommCart.h"
@@ -40,6 +41,9 @@ struct HydroSettings
   real_t cp;          /*!< specific heat (constant pressure) */
   real_t mu;          /*!< dynamic viscosity */
   real_t kappa;       /*!< thermal diffusivity */
+#ifdef USE_TABULATED_EOS
+  EosTable eos;       /*!< tabulated EOS, ideal gas when empty */
+#endif // USE_TABULATED_EOS
 
   KOKKOS_INLINE_FUNCTION
   HydroSettings() : gamma0(1.4), gamma6(1.0), cfl(1.0), slope_type(2.0),
@@ -117,6 +121,11 @@ struct HydroParams
   // other parameters
   int implementationVersion=0; /*!< triggers which implementation to use (currently 3 versions)*/
 
+#ifdef USE_TABULATED_EOS
+  //! tabulated EOS nodes (device memory), referenced by settings.eos
+  Kokkos::View<real_t*, Device> eos_table_data;
+#endif // USE_TABULATED_EOS
+
 #ifdef USE_MPI
   //! runtime determination if we are using float ou double (for MPI communication)
   //! initialized in constructor to either MpiComm::FLOAT or MpiComm::DOUBLE
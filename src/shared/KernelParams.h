@@ -0,0 +1,124 @@
+/**
+ * \file KernelParams.h
+ * \brief Compact, trivially copyable subset of HydroParams used inside
+ * Kokkos kernels.
+ */
+#ifndef KERNEL_PARAMS_H_
+#define KERNEL_PARAMS_H_
+
+#include <type_traits>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/enums.h"
+#include "shared/HydroParams.h"
+
+/**
+ * Kernel parameters.
+ *
+ * HydroParams holds everything read from the parameter file (run control,
+ * IO flags, MPI communicator, ...) and has a virtual destructor; copying it
+ * into every functor makes kernel arguments large and prevents the compiler
+ * from treating them as plain data.
+ *
+ * KernelParams only keeps what device code actually reads (sizes, geometry,
+ * boundary types, hydro settings and solver enums). Member names are the
+ * same as in HydroParams, so that kernel bodies can use either.
+ *
+ * A KernelParams is built from a HydroParams on the host. Solvers hold
+ * one (SolverBase::kernel_params), rebuilt once per time step and passed
+ * to every functor; passing a HydroParams to a static apply method still
+ * works (implicit conversion) but converts at each call.
+ */
+struct KernelParams
+{
+
+  // geometry parameters
+  int nx;     /*!< logical size along X (without ghost cells).*/
+  int ny;     /*!< logical size along Y (without ghost cells).*/
+  int nz;     /*!< logical size along Z (without ghost cells).*/
+  int ghostWidth;
+  int nbvar;  /*!< number of variables in HydroState / MHDState. */
+  DimensionType dimType; //!< 2D or 3D.
+
+  int imin;   /*!< index minimum at X border*/
+  int imax;   /*!< index maximum at X border*/
+  int jmin;   /*!< index minimum at Y border*/
+  int jmax;   /*!< index maximum at Y border*/
+  int kmin;   /*!< index minimum at Z border*/
+  int kmax;   /*!< index maximum at Z border*/
+
+  int isize;  /*!< total size (in cell unit) along X direction with ghosts.*/
+  int jsize;  /*!< total size (in cell unit) along Y direction with ghosts.*/
+  int ksize;  /*!< total size (in cell unit) along Z direction with ghosts.*/
+
+  real_t xmin; /*!< domain bound */
+  real_t xmax; /*!< domain bound */
+  real_t ymin; /*!< domain bound */
+  real_t ymax; /*!< domain bound */
+  real_t zmin; /*!< domain bound */
+  real_t zmax; /*!< domain bound */
+  real_t dx;   /*!< x resolution */
+  real_t dy;   /*!< y resolution */
+  real_t dz;   /*!< z resolution */
+
+  BoundaryConditionType boundary_type_xmin; /*!< boundary condition */
+  BoundaryConditionType boundary_type_xmax; /*!< boundary condition */
+  BoundaryConditionType boundary_type_ymin; /*!< boundary condition */
+  BoundaryConditionType boundary_type_ymax; /*!< boundary condition */
+  BoundaryConditionType boundary_type_zmin; /*!< boundary condition */
+  BoundaryConditionType boundary_type_zmax; /*!< boundary condition */
+
+  //! hydro settings (gamma0, ...)
+  HydroSettings settings;
+
+  int niter_riemann;  /*!< number of iteration usd in quasi-exact riemann solver*/
+  int riemannSolverType;
+
+  int implementationVersion; /*!< which implementation is in use */
+
+#ifdef USE_MPI
+  //! size of the MPI cartesian grid
+  int mx,my,mz;
+
+  //! MPI cartesian coordinates inside MPI topology
+  Kokkos::Array<int,3> myMpiPos;
+#endif // USE_MPI
+
+  KernelParams() = default;
+
+  //! extract kernel parameters from the full parameter set (host only).
+  KernelParams(const HydroParams& p) :
+    nx(p.nx), ny(p.ny), nz(p.nz),
+    ghostWidth(p.ghostWidth), nbvar(p.nbvar), dimType(p.dimType),
+    imin(p.imin), imax(p.imax),
+    jmin(p.jmin), jmax(p.jmax),
+    kmin(p.kmin), kmax(p.kmax),
+    isize(p.isize), jsize(p.jsize), ksize(p.ksize),
+    xmin(p.xmin), xmax(p.xmax),
+    ymin(p.ymin), ymax(p.ymax),
+    zmin(p.zmin), zmax(p.zmax),
+    dx(p.dx), dy(p.dy), dz(p.dz),
+    boundary_type_xmin(p.boundary_type_xmin),
+    boundary_type_xmax(p.boundary_type_xmax),
+    boundary_type_ymin(p.boundary_type_ymin),
+    boundary_type_ymax(p.boundary_type_ymax),
+    boundary_type_zmin(p.boundary_type_zmin),
+    boundary_type_zmax(p.boundary_type_zmax),
+    settings(p.settings),
+    niter_riemann(p.niter_riemann),
+    riemannSolverType(p.riemannSolverType),
+    implementationVersion(p.implementationVersion)
+#ifdef USE_MPI
+    ,
+    mx(p.mx), my(p.my), mz(p.mz),
+    myMpiPos(p.myMpiPos)
+#endif // USE_MPI
+  {}
+
+}; // struct KernelParams
+
+static_assert(std::is_trivially_copyable<KernelParams>::value,
+              "KernelParams must be trivially copyable (it is a kernel argument)");
+
+#endif // KERNEL_PARAMS_H_
@@ -0,0 +1,297 @@
+#include "shared/KernelTuner.h"
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== CLASS KernelTuner IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+KernelTuner&
+KernelTuner::instance()
+{
+
+  static KernelTuner tuner;
+  return tuner;
+
+} // KernelTuner::instance
+
+// =======================================================
+// =======================================================
+KernelTuner::KernelTuner() :
+  m_enabled(false),
+  m_retune(false),
+  m_nb_samples(2),
+  m_rank(0),
+  m_cache_file(),
+  m_context(),
+  m_entries(),
+  m_cache()
+{
+} // KernelTuner::KernelTuner
+
+// =======================================================
+// =======================================================
+void
+KernelTuner::init(ConfigMap& configMap, const HydroParams& params, bool retune)
+{
+
+  m_enabled    = configMap.getBool("tuning", "enabled", false);
+  m_retune     = retune or configMap.getBool("tuning", "retune", false);
+  m_nb_samples = configMap.getInteger("tuning", "nb_samples", 2);
+  m_cache_file = configMap.getString("tuning", "cache_file", "ppkMHD_tuning.cache");
+
+  if (m_nb_samples < 1)
+    m_nb_samples = 1;
+
+#ifdef USE_MPI
+  m_rank = params.myRank;
+#endif // USE_MPI
+
+  m_entries.clear();
+  m_cache.clear();
+
+  if (!m_enabled)
+    return;
+
+  // context: solver, (sub-)domain size, backend and thread count
+  {
+    std::ostringstream context;
+    context << configMap.getString("run", "solver_name", "Unknown") << ":"
+            << params.nx << "x" << params.ny << "x" << params.nz << ":"
+            << Device::name() << ":"
+            << Device().concurrency();
+    m_context = context.str();
+  }
+
+  if (m_retune)
+    return;
+
+  // cached winners of the current context
+  std::ifstream file(m_cache_file.c_str());
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.empty() or line[0] == '#')
+      continue;
+
+    std::istringstream stream(line);
+    std::string context, key;
+    int dynamic, size;
+    if (stream >> context >> key >> dynamic >> size and context == m_context)
+      m_cache[key] = LaunchConfig{dynamic != 0, size};
+  }
+
+} // KernelTuner::init
+
+// =======================================================
+// =======================================================
+KernelTuner::Entry&
+KernelTuner::entry(const std::string& label, const char* type_name,
+                   int64_t n, bool team)
+{
+
+  // kernels sharing a label are told apart by their functor type (no
+  // blank in a key, the cache file is blank separated)
+  std::string type(type_name);
+  for (char& ch : type)
+    if (isspace((unsigned char) ch))
+      ch = '_';
+
+  std::ostringstream buf;
+  buf << label << ":" << type << ":" << n;
+  const std::string key = buf.str();
+
+  auto it = m_entries.find(key);
+  if (it != m_entries.end())
+    return it->second;
+
+  Entry& e = m_entries[key];
+
+  // first candidate is the untuned default
+  if (team)
+  {
+    const bool host =
+      Kokkos::SpaceAccessibility<Kokkos::HostSpace, Device::memory_space>::accessible;
+
+    e.candidates.push_back(LaunchConfig{false, 0});
+    for (int size = host ? 1 : 32; size <= 512; size *= 2)
+      e.candidates.push_back(LaunchConfig{false, size});
+  }
+  else
+  {
+    e.candidates.push_back(LaunchConfig{false, 0});
+    for (int chunk = 16; chunk <= 256; chunk *= 4)
+      e.candidates.push_back(LaunchConfig{false, chunk});
+    for (int chunk = 16; chunk <= 256; chunk *= 4)
+      e.candidates.push_back(LaunchConfig{true, chunk});
+  }
+
+  e.times.assign(e.candidates.size(), -1.0);
+  e.calls  = 0;
+  e.best   = -1;
+  e.cached = false;
+
+  auto cached = m_cache.find(key);
+  if (cached != m_cache.end())
+  {
+    const LaunchConfig& config = cached->second;
+
+    int c = 0;
+    while (c < (int) e.candidates.size() and
+           (e.candidates[c].dynamic != config.dynamic or
+            e.candidates[c].size    != config.size))
+      ++c;
+
+    // a winner which is not a candidate any more is kept as is
+    if (c == (int) e.candidates.size())
+    {
+      e.candidates.push_back(config);
+      e.times.push_back(-1.0);
+    }
+
+    e.best   = c;
+    e.cached = true;
+  }
+
+  return e;
+
+} // KernelTuner::entry
+
+// =======================================================
+// =======================================================
+int
+KernelTuner::select(Entry& e, bool& timed) const
+{
+
+  if (e.best >= 0)
+  {
+    timed = false;
+    return e.best;
+  }
+
+  // candidates are tried in turn, so that each one gets a sample before
+  // any gets a second one (the first calls also pay warm-up costs)
+  timed = true;
+  return e.calls % e.candidates.size();
+
+} // KernelTuner::select
+
+// =======================================================
+// =======================================================
+void
+KernelTuner::record(Entry& e, int candidate, double seconds)
+{
+
+  if (e.times[candidate] < 0 or seconds < e.times[candidate])
+    e.times[candidate] = seconds;
+
+  ++e.calls;
+
+  if (e.calls < m_nb_samples * (int) e.candidates.size())
+    return;
+
+  e.best = 0;
+  for (int c = 1; c < (int) e.candidates.size(); ++c)
+    if (e.times[c] < e.times[e.best])
+      e.best = c;
+
+  save();
+
+} // KernelTuner::record
+
+// =======================================================
+// =======================================================
+void
+KernelTuner::save() const
+{
+
+  if (m_rank != 0)
+    return;
+
+  // keep the winners of other contexts
+  std::vector<std::string> lines;
+  {
+    std::ifstream file(m_cache_file.c_str());
+    std::string line;
+    while (std::getline(file, line))
+    {
+      std::istringstream stream(line);
+      std::string context;
+      if (line.empty() or line[0] == '#' or !(stream >> context) or context == m_context)
+        continue;
+      lines.push_back(line);
+    }
+  }
+
+  // winners of the current context: freshly tuned, then cached ones
+  // which were not used (yet) in this run
+  std::map<std::string, LaunchConfig> winners;
+  if (!m_retune)
+    winners = m_cache;
+  for (const auto& it : m_entries)
+    if (it.second.best >= 0)
+      winners[it.first] = it.second.candidates[it.second.best];
+
+  std::ofstream file(m_cache_file.c_str());
+  file << "# ppkMHD kernel tuning cache\n";
+  file << "# context kernel:type:size dynamic_schedule chunk_or_team_size\n";
+  for (const std::string& line : lines)
+    file << line << "\n";
+  for (const auto& it : winners)
+    file << m_context << " " << it.first << " "
+         << (it.second.dynamic ? 1 : 0) << " " << it.second.size << "\n";
+
+} // KernelTuner::save
+
+// =======================================================
+// =======================================================
+void
+KernelTuner::report() const
+{
+
+  if (!m_enabled or m_rank != 0)
+    return;
+
+  printf("##########################\n");
+  printf("Kernel tuning (%s)\n", m_context.c_str());
+  printf("%-56s %-8s %6s %12s %8s\n", "kernel:type:size", "schedule", "size", "time (s)", "speedup");
+
+  for (const auto& it : m_entries)
+  {
+    const Entry& e = it.second;
+
+    if (e.best < 0)
+    {
+      printf("%-56s (tuning not completed, %d calls)\n", it.first.c_str(), e.calls);
+      continue;
+    }
+
+    const LaunchConfig& config = e.candidates[e.best];
+
+    if (e.cached)
+    {
+      printf("%-56s %-8s %6d %12s %8s\n", it.first.c_str(),
+             config.dynamic ? "dynamic" : "static", config.size, "cached", "-");
+    }
+    else
+    {
+      printf("%-56s %-8s %6d %12.3e %8.2f\n", it.first.c_str(),
+             config.dynamic ? "dynamic" : "static", config.size,
+             e.times[e.best], e.times[0]/e.times[e.best]);
+    }
+  }
+
+  printf("(size 0 is the Kokkos default, speedup is relative to it)\n");
+  printf("##########################\n");
+
+} // KernelTuner::report
+
+} // namespace ppkMHD
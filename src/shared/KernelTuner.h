@@ -0,0 +1,317 @@
+/**
+ * \file KernelTuner.h
+ * \brief Online autotuning of the launch configuration of heavy kernels,
+ * persisted in a cache file.
+ */
+#ifndef KERNEL_TUNER_H_
+#define KERNEL_TUNER_H_
+
+#include <map>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "shared/kokkos_shared.h"
+#include "shared/HydroParams.h"
+#include "utils/config/ConfigMap.h"
+
+namespace ppkMHD
+{
+
+/**
+ * A launch configuration candidate.
+ *
+ * For range kernels: iteration schedule (static / dynamic) and chunk size
+ * (0 means the Kokkos default). For team kernels: team size (0 means
+ * Kokkos::AUTO); the schedule is unused.
+ */
+struct LaunchConfig
+{
+  bool dynamic;
+  int  size;
+}; // struct LaunchConfig
+
+/**
+ * Kernel launch autotuner.
+ *
+ * Kernels launched through parallel_for_tuned (range) or
+ * parallel_for_tuned_team (team policy) are tuned online: the first calls
+ * of a given kernel (label, functor type and iteration count) each use the
+ * next candidate configuration and are timed (between two fences),
+ * nb_samples times per candidate. The fastest candidate is then used for
+ * all later calls. The functor type is part of the key because several
+ * kernels share a label (e.g. the per direction instances of a functor
+ * template).
+ *
+ * Range kernels are only tuned on host execution spaces, where chunk size
+ * and schedule matter; on a device they are launched with the Kokkos
+ * default policy.
+ * Every call is a genuine call of the solver, so that kernels accumulating
+ * in their output arrays can be tuned too.
+ *
+ * Winners are stored in a cache file, indexed by a context string (solver
+ * name, mesh size, Kokkos backend and thread count), and reused by later
+ * runs with the same context without timing anything.
+ *
+ * Parameters read in section [tuning]:
+ * - enabled (default false)
+ * - cache_file (default ppkMHD_tuning.cache)
+ * - nb_samples: timed calls per candidate (default 2)
+ * - retune: ignore cached winners of the current context (default false,
+ *   also set by command line option --retune)
+ *
+ * Kernels launched from inside a host parallel region (ensemble members
+ * advanced concurrently, see Ensemble) run on the calling thread and are
+ * launched untuned; the other kernels of the process are still tuned.
+ *
+ * Tile shapes of the tiled kernels are compile-time constants and are not
+ * tuned.
+ */
+class KernelTuner
+{
+
+public:
+  //! the tuner shared by all kernels of the process
+  static KernelTuner& instance();
+
+  //! read parameters and cached winners of the current context
+  void init(ConfigMap& configMap, const HydroParams& params, bool retune);
+
+  bool enabled() const { return m_enabled; }
+  void set_enabled(bool enabled) { m_enabled = enabled; }
+
+  //! launch a range kernel over [0,n[, with the tuned configuration
+  template<class Functor>
+  void parallel_for(const std::string& label, int64_t n, const Functor& functor);
+
+  //! launch a team kernel of league_size teams, with the tuned team size
+  template<class Functor>
+  void parallel_for_team(const std::string& label, int league_size,
+                         size_t scratch_size, const Functor& functor);
+
+  //! print the configuration chosen for each kernel
+  void report() const;
+
+private:
+  KernelTuner();
+
+  //! tuning state of a kernel
+  struct Entry
+  {
+    std::vector<LaunchConfig> candidates;
+    std::vector<double>       times;     //!< best time of each candidate
+    int                       calls;     //!< timed calls so far
+    int                       best;      //!< winner index, -1 while tuning
+    bool                      cached;    //!< winner read from cache file
+  };
+
+  //! get (create if needed) the entry of a kernel
+  Entry& entry(const std::string& label, const char* type_name,
+               int64_t n, bool team);
+
+  //! candidate to use for the next call, and whether the call is timed
+  int select(Entry& e, bool& timed) const;
+
+  //! record the duration of a timed call
+  void record(Entry& e, int candidate, double seconds);
+
+  /**
+   * Is the caller inside a host parallel region (concurrent ensemble
+   * members) ? Kernels then run on the calling thread only: there is no
+   * launch configuration to tune, and the tuning state is not touched.
+   */
+  static bool in_host_parallel()
+  {
+#ifdef KOKKOS_ENABLE_OPENMP
+    return Kokkos::OpenMP::in_parallel();
+#else
+    return false;
+#endif // KOKKOS_ENABLE_OPENMP
+  }
+
+  //! rewrite the cache file with winners of the current context
+  void save() const;
+
+  template<class Functor>
+  void launch(const std::string& label, int64_t n, const LaunchConfig& config,
+              const Functor& functor);
+
+  template<class Functor>
+  void launch_team(const std::string& label, int league_size, size_t scratch_size,
+                   const LaunchConfig& config, const Functor& functor);
+
+  bool m_enabled;
+  bool m_retune;
+  int  m_nb_samples;
+  int  m_rank;
+
+  std::string m_cache_file;
+  std::string m_context;
+
+  //! kernel key (label:type:n) -> tuning state
+  std::map<std::string, Entry> m_entries;
+
+  //! cached winners of the current context, kernel key -> config
+  std::map<std::string, LaunchConfig> m_cache;
+
+}; // class KernelTuner
+
+// =======================================================
+// =======================================================
+template<class Functor>
+void KernelTuner::launch(const std::string& label, int64_t n,
+                         const LaunchConfig& config, const Functor& functor)
+{
+
+  if (config.dynamic)
+  {
+    Kokkos::RangePolicy<Device, Kokkos::Schedule<Kokkos::Dynamic> > policy(0, n);
+    if (config.size > 0)
+      policy.set_chunk_size(config.size);
+    Kokkos::parallel_for(label, policy, functor);
+  }
+  else
+  {
+    Kokkos::RangePolicy<Device, Kokkos::Schedule<Kokkos::Static> > policy(0, n);
+    if (config.size > 0)
+      policy.set_chunk_size(config.size);
+    Kokkos::parallel_for(label, policy, functor);
+  }
+
+} // KernelTuner::launch
+
+// =======================================================
+// =======================================================
+template<class Functor>
+void KernelTuner::launch_team(const std::string& label, int league_size,
+                              size_t scratch_size, const LaunchConfig& config,
+                              const Functor& functor)
+{
+
+  using team_policy_t = Kokkos::TeamPolicy<Device>;
+
+  if (config.size > 0)
+  {
+    team_policy_t policy(league_size, config.size);
+    policy = policy.set_scratch_size(0, Kokkos::PerTeam(scratch_size));
+    Kokkos::parallel_for(label, policy, functor);
+  }
+  else
+  {
+    team_policy_t policy(league_size, Kokkos::AUTO);
+    policy = policy.set_scratch_size(0, Kokkos::PerTeam(scratch_size));
+    Kokkos::parallel_for(label, policy, functor);
+  }
+
+} // KernelTuner::launch_team
+
+// =======================================================
+// =======================================================
+template<class Functor>
+void KernelTuner::parallel_for(const std::string& label, int64_t n,
+                               const Functor& functor)
+{
+
+  // chunk size and schedule are only meaningful on host execution spaces
+  constexpr bool host =
+    Kokkos::SpaceAccessibility<Kokkos::HostSpace, Device::memory_space>::accessible;
+
+  if (!m_enabled or !host or in_host_parallel())
+  {
+    Kokkos::parallel_for(label, n, functor);
+    return;
+  }
+
+  Entry& e = entry(label, typeid(Functor).name(), n, false);
+
+  bool timed;
+  const int c = select(e, timed);
+
+  if (!timed)
+  {
+    launch(label, n, e.candidates[c], functor);
+    return;
+  }
+
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  launch(label, n, e.candidates[c], functor);
+  Kokkos::fence();
+  record(e, c, timer.seconds());
+
+} // KernelTuner::parallel_for
+
+// =======================================================
+// =======================================================
+template<class Functor>
+void KernelTuner::parallel_for_team(const std::string& label, int league_size,
+                                    size_t scratch_size, const Functor& functor)
+{
+
+  if (!m_enabled or in_host_parallel())
+  {
+    launch_team(label, league_size, scratch_size, LaunchConfig{false, 0}, functor);
+    return;
+  }
+
+  Entry& e = entry(label, typeid(Functor).name(), league_size, true);
+
+  // drop team sizes this kernel can't be launched with
+  if (e.calls == 0 and e.best < 0)
+  {
+    Kokkos::TeamPolicy<Device> policy(league_size, Kokkos::AUTO);
+    policy = policy.set_scratch_size(0, Kokkos::PerTeam(scratch_size));
+    const int team_size_max = policy.team_size_max(functor, Kokkos::ParallelForTag());
+
+    std::vector<LaunchConfig> candidates;
+    for (const LaunchConfig& config : e.candidates)
+      if (config.size <= team_size_max)
+        candidates.push_back(config);
+
+    e.candidates = candidates;
+    e.times.assign(candidates.size(), -1.0);
+  }
+
+  bool timed;
+  const int c = select(e, timed);
+
+  if (!timed)
+  {
+    launch_team(label, league_size, scratch_size, e.candidates[c], functor);
+    return;
+  }
+
+  Kokkos::fence();
+  Kokkos::Timer timer;
+  launch_team(label, league_size, scratch_size, e.candidates[c], functor);
+  Kokkos::fence();
+  record(e, c, timer.seconds());
+
+} // KernelTuner::parallel_for_team
+
+// =======================================================
+// =======================================================
+/**
+ * Launch a range kernel through the process autotuner (plain
+ * Kokkos::parallel_for when tuning is disabled).
+ */
+template<class Functor>
+inline void parallel_for_tuned(const std::string& label, int64_t n, const Functor& functor)
+{
+  KernelTuner::instance().parallel_for(label, n, functor);
+}
+
+/**
+ * Launch a team kernel through the process autotuner (team size
+ * Kokkos::AUTO when tuning is disabled).
+ */
+template<class Functor>
+inline void parallel_for_tuned_team(const std::string& label, int league_size,
+                                    size_t scratch_size, const Functor& functor)
+{
+  KernelTuner::instance().parallel_for_team(label, league_size, scratch_size, functor);
+}
+
+} // namespace ppkMHD
+
+#endif // KERNEL_TUNER_H_
@@ -0,0 +1,185 @@
+#include "shared/LoadBalance.h"
+#include "shared/SolverBase.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef USE_MPI
+#include "utils/mpiUtils/MpiCommCart.h"
+#endif // USE_MPI
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== CLASS LoadBalance IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+LoadBalance::LoadBalance(HydroParams& params, ConfigMap& configMap) :
+  params(params),
+  m_enabled(false),
+  m_nstep(1),
+  m_threshold(1.1),
+  m_last_compute(0.0),
+  m_steps(0),
+  m_compute(0.0),
+  m_compute_max_step(0.0),
+  m_imbalance(1.0),
+  m_file(nullptr)
+{
+
+  m_enabled = configMap.getBool("load_balance", "enabled", false);
+
+  if (!m_enabled)
+    return;
+
+  m_nstep = configMap.getInteger("load_balance", "nstep",
+                                 configMap.getInteger("run", "nlog", 10));
+  if (m_nstep < 1)
+    m_nstep = 1;
+
+  m_threshold = configMap.getFloat("load_balance", "threshold", 1.1);
+
+  /*
+   * open output file (rank 0 only)
+   */
+  int myRank = 0;
+#ifdef USE_MPI
+  myRank = params.myRank;
+#endif // USE_MPI
+
+  if (myRank == 0)
+  {
+
+    std::string outputDir    = configMap.getString("output", "outputDir", "./");
+    std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+    std::string filename = configMap.getString("load_balance", "filename",
+                                               outputDir + "/" + outputPrefix + "_load_balance.jsonl");
+
+    // a restart run appends to the existing records
+    const bool restart = configMap.getInteger("run", "restart_enabled", 0) != 0;
+
+    m_file = fopen(filename.c_str(), restart ? "a" : "w");
+
+    if (m_file == nullptr)
+      std::cerr << "LoadBalance: unable to open " << filename << ", records not written\n";
+
+  }
+
+} // LoadBalance::LoadBalance
+
+// =======================================================
+// =======================================================
+LoadBalance::~LoadBalance()
+{
+
+  if (m_file)
+    fclose(m_file);
+
+} // LoadBalance::~LoadBalance
+
+// =======================================================
+// =======================================================
+void
+LoadBalance::update(const SolverBase& solver)
+{
+
+  const double compute =
+    solver.timers.at(TIMER_NUM_SCHEME)->elapsed() +
+    solver.timers.at(TIMER_GRAVITY)->elapsed();
+
+  const double step = compute - m_last_compute;
+  m_last_compute = compute;
+
+  ++m_steps;
+  m_compute += step;
+  m_compute_max_step = std::max(m_compute_max_step, step);
+
+  if (solver.m_iteration % m_nstep == 0)
+  {
+    analyse(solver);
+
+    m_steps = 0;
+    m_compute = 0.0;
+    m_compute_max_step = 0.0;
+  }
+
+} // LoadBalance::update
+
+// =======================================================
+// =======================================================
+void
+LoadBalance::analyse(const SolverBase& solver)
+{
+
+  /*
+   * gather compute times (a single collective)
+   */
+  enum { COMPUTE = 0, MAX_STEP, NB_VALUES };
+
+  double local[NB_VALUES];
+  local[COMPUTE]  = m_compute / m_steps;
+  local[MAX_STEP] = m_compute_max_step;
+
+  int nProcs = 1;
+#ifdef USE_MPI
+  nProcs = params.nProcs;
+#endif // USE_MPI
+
+  std::vector<double> all(nProcs*NB_VALUES);
+
+#ifdef USE_MPI
+  params.communicator->allGather(local, NB_VALUES, hydroSimu::MpiComm::DOUBLE,
+                                 all.data(), NB_VALUES, hydroSimu::MpiComm::DOUBLE);
+#else
+  for (int v = 0; v < NB_VALUES; ++v)
+    all[v] = local[v];
+#endif // USE_MPI
+
+  double compute_min = all[COMPUTE], compute_max = all[COMPUTE], compute_sum = 0;
+  double max_step = 0;
+  int slowest = 0;
+
+  for (int p = 0; p < nProcs; ++p)
+  {
+    const double* values = &all[p*NB_VALUES];
+
+    compute_min  = std::min(compute_min, values[COMPUTE]);
+    compute_sum += values[COMPUTE];
+    max_step     = std::max(max_step, values[MAX_STEP]);
+    if (values[COMPUTE] > compute_max)
+    {
+      compute_max = values[COMPUTE];
+      slowest = p;
+    }
+  }
+
+  const double compute_mean = compute_sum / nProcs;
+  m_imbalance = compute_mean > 0 ? compute_max / compute_mean : 1.0;
+
+  if (m_file == nullptr)
+    return;
+
+  /*
+   * write record (rank 0)
+   */
+  fprintf(m_file,
+          "{\"iteration\":%d,\"time\":%.10e,\"steps\":%d,"
+          "\"compute_per_step\":{\"min\":%.6e,\"max\":%.6e,\"mean\":%.6e},"
+          "\"max_step\":%.6e,\"imbalance\":%.4f,\"slowest_rank\":%d}\n",
+          solver.m_iteration, solver.m_t, m_steps,
+          compute_min, compute_max, compute_mean,
+          max_step, m_imbalance, slowest);
+
+  if (m_imbalance > m_threshold)
+    printf("load imbalance %5.2f (slowest rank %d, threshold %4.2f)\n",
+           m_imbalance, slowest, m_threshold);
+
+  // keep the records readable while the run is going on
+  fflush(m_file);
+
+} // LoadBalance::analyse
+
+} // namespace ppkMHD
@@ -0,0 +1,92 @@
+/**
+ * \file LoadBalance.h
+ * \brief Load imbalance measurement of the MPI Cartesian decomposition.
+ */
+#ifndef LOAD_BALANCE_H_
+#define LOAD_BALANCE_H_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "shared/HydroParams.h"
+#include "utils/config/ConfigMap.h"
+
+namespace ppkMHD
+{
+
+class SolverBase;
+
+/**
+ * Load balance monitor, owned by SolverBase (m_load_balance) and fed by
+ * SolverBase::next_iteration at every time step.
+ *
+ * Compute time of a time step is the time spent in the numerical scheme
+ * and gravity (timers TIMER_NUM_SCHEME and TIMER_GRAVITY), i.e. excluding
+ * border exchange and the global time step reduction, where a fast
+ * process waits for the slow ones. It is measured on every MPI process,
+ * and every nstep time steps, gathered (one collective) to compute:
+ * - min, max and mean over processes of the compute time per step,
+ * - imbalance = max / mean (1 is a perfectly balanced run), and the
+ *   slowest process.
+ *
+ * Parameters read in section [load_balance]:
+ * - enabled (default false)
+ * - nstep: number of time steps of a measure window (default [run] nlog)
+ * - threshold: imbalance above which a warning is printed (default 1.1)
+ * - filename (default outputDir/outputPrefix_load_balance.jsonl)
+ *
+ * Results are appended (rank 0) as JSON lines.
+ *
+ * Measurement only: the decomposition is never rebalanced (no moving
+ * slab boundaries, no data migration). The whole code (data arrays,
+ * border buffers, initial conditions, gravity, IO, multigrid) relies on
+ * equal local sizes (params.nx, ny, nz on every process).
+ */
+class LoadBalance
+{
+
+public:
+  LoadBalance(HydroParams& params, ConfigMap& configMap);
+  ~LoadBalance();
+
+  //! is load balance monitoring enabled at all ?
+  bool enabled() const { return m_enabled; }
+
+  /**
+   * Measure the last time step; at the end of a window, gather the
+   * measures of all MPI processes (collective) and write a record.
+   */
+  void update(const SolverBase& solver);
+
+  //! imbalance (max / mean compute time) of the last complete window
+  double imbalance() const { return m_imbalance; }
+
+private:
+  HydroParams& params;
+
+  bool   m_enabled;
+  int    m_nstep;
+  double m_threshold;
+
+  //! compute timers at the previous step
+  double m_last_compute;
+
+  //! current window: number of steps, compute time, slowest step
+  int    m_steps;
+  double m_compute;
+  double m_compute_max_step;
+
+  double m_imbalance;
+
+  //! output file (rank 0 only)
+  FILE* m_file;
+
+  //! gather the window measures and write a record
+  void analyse(const SolverBase& solver);
+
+}; // class LoadBalance
+
+} // namespace ppkMHD
+
+#endif // LOAD_BALANCE_H_
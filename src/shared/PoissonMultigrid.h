@@ -0,0 +1,884 @@
+/**
+ * \file PoissonMultigrid.h
+ * \brief Matrix-free geometric multigrid solver for the Poisson equation
+ * of self-gravity.
+ */
+#ifndef POISSON_MULTIGRID_H_
+#define POISSON_MULTIGRID_H_
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <iostream>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/enums.h"
+#include "shared/utils.h"
+#include "shared/HydroParams.h"
+#include "utils/config/ConfigMap.h"
+#include "shared/PoissonMultigridFunctors.h"
+
+#ifdef USE_MPI
+#include "utils/mpiUtils/MpiCommCart.h"
+#endif // USE_MPI
+
+namespace ppkMHD
+{
+
+/**
+ * Geometric multigrid solver for
+ * \f$ \Delta \phi = 4 \pi G \rho \f$.
+ *
+ * Cell-centered, matrix-free V-cycles: red-black Gauss-Seidel smoother,
+ * average restriction and bi/tri-linear prolongation.
+ *
+ * Levels are distributed with the same MPI cartesian decomposition as
+ * the hydro grid. When a local sub-domain cannot be coarsened any more,
+ * the coarse problem is agglomerated (gathered) on a single process
+ * (rank 0), which proceeds with V-cycles on the global coarse grid down
+ * to a few cells, and scatters the correction back; other processes
+ * allocate no memory for agglomerated levels.
+ *
+ * The coarsest level is relaxed until its residual is reduced by
+ * mg_bottom_tolerance (residual checked every mg_bottom_sweeps sweeps),
+ * so that the bottom solve converges whatever the coarse grid size.
+ *
+ * Boundary conditions (section [gravity], parameter boundary):
+ * - periodic : the mean density is removed from the right hand side,
+ * - isolated : Dirichlet values given by the monopole potential of the
+ *   total mass located at the center of mass.
+ *
+ * Other parameters read in section [gravity]:
+ * - G (default 1.0)
+ * - mg_tolerance: relative residual (max norm) to reach (default 1e-8)
+ * - mg_max_cycles: maximum number of V-cycles per solve (default 20)
+ * - mg_pre_smooth / mg_post_smooth: smoothing sweeps (default 2 / 2)
+ * - mg_bottom_tolerance: relative residual to reach on the coarsest
+ *   level (default 1e-6)
+ * - mg_bottom_sweeps: sweeps between two residual checks on the coarsest
+ *   level (default 10)
+ * - mg_bottom_max_sweeps: maximum number of sweeps on the coarsest level
+ *   (default 10000)
+ * - mg_min_local_size: smallest local sub-domain size before
+ *   agglomeration (default 4)
+ *
+ * The potential of the previous solve is used as initial guess.
+ */
+template<int dim>
+class PoissonMultigrid
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray   = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+  using VectorField = typename std::conditional<dim==2,VectorField2d,VectorField3d>::type;
+
+  PoissonMultigrid(HydroParams& params, ConfigMap& configMap);
+
+  /**
+   * Solve Poisson equation for the density of Udata, and store
+   * gravity field -grad(phi) into gravity.
+   */
+  void solve(DataArray Udata, VectorField gravity);
+
+  //! number of V-cycles performed during last solve
+  int get_nb_cycles() const { return m_nb_cycles; }
+
+  //! relative residual reached during last solve
+  real_t get_residual() const { return m_residual; }
+
+  //! number of levels (including agglomerated ones)
+  int get_nb_levels() const { return (int) m_levels.size(); }
+
+  //! number of sweeps of the last coarsest level solve (agglomeration
+  //! process only)
+  int get_bottom_sweeps() const { return m_bottom_nb_sweeps; }
+
+  //! memory footprint in bytes
+  size_t memory_size() const;
+
+  //! finest level potential
+  MGArray get_potential() const { return m_levels[0].phi; }
+
+private:
+
+  //! one multigrid level
+  struct Level
+  {
+    MGLevelInfo info;
+    MGArray phi; /*!< potential (or correction on coarse levels) */
+    MGArray rhs; /*!< right hand side */
+    MGArray res; /*!< residual */
+
+    //! true when the level is split across MPI processes
+    bool distributed;
+
+    //! false for agglomerated levels on processes other than the
+    //! agglomeration one (no memory allocated)
+    bool active;
+
+    //! MPI border buffers (only allocated when distributed)
+    MGBuffer sendMin, sendMax, recvMin, recvMax;
+  };
+
+  HydroParams& params;
+
+  std::vector<Level> m_levels;
+
+  //! index of the first agglomerated level (-1 if none)
+  int m_agglo_level;
+
+  //! process holding agglomerated levels (communicator rank), and is it
+  //! the current process ?
+  int  m_agglo_root;
+  bool m_agglo_owner;
+
+  bool   m_periodic;
+  real_t m_G;
+  real_t m_tolerance;
+  int    m_max_cycles;
+  int    m_nu1, m_nu2;
+  real_t m_bottom_tolerance;
+  int    m_bottom_sweeps;
+  int    m_bottom_max_sweeps;
+  int    m_bottom_nb_sweeps;
+  int    m_min_local_size;
+
+  //! boundary values (isolated boundaries)
+  MGMonopole m_monopole;
+
+  int    m_nb_cycles;
+  real_t m_residual;
+
+  //! MPI cartesian topology sizes and coordinates
+  int m_mpi_size[3];
+  int m_mpi_pos[3];
+
+  Level make_level(int nx, int ny, int nz,
+		   real_t dx, real_t dy, real_t dz,
+		   bool distributed, bool active = true);
+
+  bool can_coarsen(const MGLevelInfo& info, int nmin) const;
+
+  void fill_ghosts(int ilevel);
+  void exchange_ghosts(Level& level, int dir);
+  void smooth(int ilevel, int nb_sweeps);
+  void vcycle(int ilevel);
+  void bottom_solve(int ilevel);
+  void remove_mean(int ilevel);
+
+  real_t norm_max(const Level& level, MGArray data) const;
+  real_t sum(const Level& level, MGArray data) const;
+
+  void gather_residual(int ilevel);
+  void scatter_correction(int ilevel);
+
+}; // class PoissonMultigrid
+
+// =======================================================
+// =======================================================
+template<int dim>
+PoissonMultigrid<dim>::PoissonMultigrid(HydroParams& params,
+					ConfigMap& configMap) :
+  params(params),
+  m_levels(),
+  m_agglo_level(-1),
+  m_agglo_root(0),
+  m_agglo_owner(true),
+  m_bottom_nb_sweeps(0),
+  m_nb_cycles(0),
+  m_residual(0)
+{
+
+  m_G              = configMap.getFloat  ("gravity", "G", 1.0);
+  m_tolerance      = configMap.getFloat  ("gravity", "mg_tolerance", 1e-8);
+  m_max_cycles     = configMap.getInteger("gravity", "mg_max_cycles", 20);
+  m_nu1            = configMap.getInteger("gravity", "mg_pre_smooth", 2);
+  m_nu2            = configMap.getInteger("gravity", "mg_post_smooth", 2);
+  m_bottom_tolerance  = configMap.getFloat  ("gravity", "mg_bottom_tolerance", 1e-6);
+  m_bottom_sweeps     = configMap.getInteger("gravity", "mg_bottom_sweeps", 10);
+  m_bottom_max_sweeps = configMap.getInteger("gravity", "mg_bottom_max_sweeps", 10000);
+  m_bottom_sweeps     = std::max(m_bottom_sweeps, 1);
+  m_min_local_size = configMap.getInteger("gravity", "mg_min_local_size", 4);
+
+  // default boundary conditions follow the hydro ones
+  const std::string default_bc =
+    params.boundary_type_xmin == BC_PERIODIC ? "periodic" : "isolated";
+  m_periodic =
+    !configMap.getString("gravity", "boundary", default_bc).compare("periodic");
+
+  m_monopole.dim = dim;
+  m_monopole.GM  = 0;
+  m_monopole.xc  = m_monopole.yc = m_monopole.zc = 0;
+
+  m_mpi_size[IX] = m_mpi_size[IY] = m_mpi_size[IZ] = 1;
+  m_mpi_pos [IX] = m_mpi_pos [IY] = m_mpi_pos [IZ] = 0;
+#ifdef USE_MPI
+  m_mpi_size[IX] = params.mx;
+  m_mpi_size[IY] = params.my;
+  m_mpi_size[IZ] = dim==3 ? params.mz : 1;
+  m_mpi_pos [IX] = params.myMpiPos[IX];
+  m_mpi_pos [IY] = params.myMpiPos[IY];
+  m_mpi_pos [IZ] = dim==3 ? params.myMpiPos[IZ] : 0;
+  m_agglo_owner = params.myRank == m_agglo_root;
+#endif // USE_MPI
+
+  const int gw = params.ghostWidth;
+
+  /*
+   * build levels hierarchy
+   */
+  bool distributed = m_mpi_size[IX]*m_mpi_size[IY]*m_mpi_size[IZ] > 1;
+
+  m_levels.push_back(make_level(params.nx, params.ny, dim==3 ? params.nz : 1,
+				params.dx, params.dy, dim==3 ? params.dz : 1,
+				distributed));
+
+  // distributed levels, then agglomeration
+  while (distributed) {
+
+    const MGLevelInfo& cur = m_levels.back().info;
+
+    if (can_coarsen(cur, std::max(m_min_local_size, gw))) {
+
+      m_levels.push_back(make_level(cur.nx/2, cur.ny/2,
+				    dim==3 ? cur.nz/2 : 1,
+				    2*cur.dx, 2*cur.dy,
+				    dim==3 ? 2*cur.dz : 1,
+				    true));
+
+    } else {
+
+      // same resolution, whole domain on the agglomeration process
+      m_agglo_level = m_levels.size();
+      m_levels.push_back(make_level(cur.nx*m_mpi_size[IX],
+				    cur.ny*m_mpi_size[IY],
+				    cur.nz*m_mpi_size[IZ],
+				    cur.dx, cur.dy, cur.dz,
+				    false, m_agglo_owner));
+      distributed = false;
+
+    }
+
+  }
+
+  // agglomerated levels (or all levels of a single process run)
+  while (can_coarsen(m_levels.back().info, std::max(2, gw))) {
+
+    const MGLevelInfo& cur = m_levels.back().info;
+
+    m_levels.push_back(make_level(cur.nx/2, cur.ny/2,
+				  dim==3 ? cur.nz/2 : 1,
+				  2*cur.dx, 2*cur.dy,
+				  dim==3 ? 2*cur.dz : 1,
+				  false, m_levels.back().active));
+
+  }
+
+  int myRank = 0;
+#ifdef USE_MPI
+  myRank = params.myRank;
+#endif // USE_MPI
+
+  if (myRank == 0) {
+    const MGLevelInfo& coarsest = m_levels.back().info;
+    std::cout << "Self-gravity multigrid: " << m_levels.size() << " levels"
+	      << ", coarsest " << coarsest.nx << "x" << coarsest.ny;
+    if (dim==3)
+      std::cout << "x" << coarsest.nz;
+    if (m_agglo_level >= 0)
+      std::cout << ", agglomeration at level " << m_agglo_level
+		<< " on rank " << m_agglo_root;
+    std::cout << ", " << (m_periodic ? "periodic" : "isolated")
+	      << " boundaries\n";
+  }
+
+} // PoissonMultigrid::PoissonMultigrid
+
+// =======================================================
+// =======================================================
+template<int dim>
+typename PoissonMultigrid<dim>::Level
+PoissonMultigrid<dim>::make_level(int nx, int ny, int nz,
+				  real_t dx, real_t dy, real_t dz,
+				  bool distributed, bool active)
+{
+
+  Level level;
+  MGLevelInfo& info = level.info;
+
+  info.dim = dim;
+  info.nx  = nx;
+  info.ny  = ny;
+  info.nz  = nz;
+  info.gw  = params.ghostWidth;
+  info.gwz = dim==3 ? params.ghostWidth : 0;
+  info.isize = nx + 2*info.gw;
+  info.jsize = ny + 2*info.gw;
+  info.ksize = nz + 2*info.gwz;
+  info.dx  = dx;
+  info.dy  = dy;
+  info.dz  = dz;
+
+  // global index of first interior cell
+  const int ox = distributed ? nx*m_mpi_pos[IX] : 0;
+  const int oy = distributed ? ny*m_mpi_pos[IY] : 0;
+  const int oz = distributed ? nz*m_mpi_pos[IZ] : 0;
+
+  info.x0 = params.xmin + dx/2 + (ox-info.gw)*dx;
+  info.y0 = params.ymin + dy/2 + (oy-info.gw)*dy;
+  info.z0 = dim==3 ? params.zmin + dz/2 + (oz-info.gwz)*dz : 0;
+
+  info.parity = ((ox+oy+oz - 2*info.gw - info.gwz) % 2 + 2) % 2;
+
+  level.distributed = distributed;
+  level.active      = active;
+
+  if (!active)
+    return level;
+
+  level.phi = MGArray("mg_phi", info.isize, info.jsize, info.ksize);
+  level.rhs = MGArray("mg_rhs", info.isize, info.jsize, info.ksize);
+  level.res = MGArray("mg_res", info.isize, info.jsize, info.ksize);
+
+  if (distributed) {
+    int bufSize = mg_face_slab_size(info, IX);
+    bufSize = std::max(bufSize, mg_face_slab_size(info, IY));
+    if (dim==3)
+      bufSize = std::max(bufSize, mg_face_slab_size(info, IZ));
+
+    level.sendMin = MGBuffer("mg_sendMin", bufSize);
+    level.sendMax = MGBuffer("mg_sendMax", bufSize);
+    level.recvMin = MGBuffer("mg_recvMin", bufSize);
+    level.recvMax = MGBuffer("mg_recvMax", bufSize);
+  }
+
+  return level;
+
+} // PoissonMultigrid::make_level
+
+// =======================================================
+// =======================================================
+template<int dim>
+bool PoissonMultigrid<dim>::can_coarsen(const MGLevelInfo& info,
+					int nmin) const
+{
+
+  bool ok =
+    info.nx % 2 == 0 and info.nx/2 >= nmin and
+    info.ny % 2 == 0 and info.ny/2 >= nmin;
+
+  if (dim==3)
+    ok = ok and info.nz % 2 == 0 and info.nz/2 >= nmin;
+
+  return ok;
+
+} // PoissonMultigrid::can_coarsen
+
+// =======================================================
+// =======================================================
+template<int dim>
+size_t PoissonMultigrid<dim>::memory_size() const
+{
+
+  size_t size = 0;
+  for (const Level& level : m_levels) {
+    size += 3 * level.phi.span() * sizeof(real_t);
+    size += 4 * level.sendMin.span() * sizeof(real_t);
+  }
+
+  return size;
+
+} // PoissonMultigrid::memory_size
+
+// =======================================================
+// =======================================================
+/**
+ * Fill ghost cells of phi, direction by direction so that corners are
+ * also filled.
+ *
+ * Finest level uses monopole values for isolated boundaries, coarse
+ * levels (corrections) use homogeneous boundary conditions.
+ */
+template<int dim>
+void PoissonMultigrid<dim>::fill_ghosts(int ilevel)
+{
+
+  Level& level = m_levels[ilevel];
+  const bool homogeneous = ilevel > 0;
+
+  for (int dir = IX; dir < dim; ++dir) {
+
+    // MPI topology is periodic, so that distributed levels always
+    // exchange along every direction
+    if (level.distributed)
+      exchange_ghosts(level, dir);
+    else if (m_periodic)
+      MGPeriodicFunctor::apply(level.info, level.phi, dir);
+
+    if (!m_periodic) {
+
+      const bool isMin = !level.distributed or m_mpi_pos[dir] == 0;
+      const bool isMax = !level.distributed or m_mpi_pos[dir] == m_mpi_size[dir]-1;
+
+      if (isMin)
+	MGDirichletFunctor::apply(level.info, level.phi, 2*dir,
+				  homogeneous, m_monopole);
+      if (isMax)
+	MGDirichletFunctor::apply(level.info, level.phi, 2*dir+1,
+				  homogeneous, m_monopole);
+
+    }
+
+  } // end for dir
+
+} // PoissonMultigrid::fill_ghosts
+
+// =======================================================
+// =======================================================
+template<int dim>
+void PoissonMultigrid<dim>::exchange_ghosts(Level& level, int dir)
+{
+
+#ifdef USE_MPI
+  using namespace hydroSimu;
+
+  const int faceMin = 2*dir;
+  const int faceMax = 2*dir+1;
+  const int count = mg_face_slab_size(level.info, dir);
+  const int data_type = sizeof(real_t) == sizeof(double) ?
+    MpiComm::DOUBLE : MpiComm::FLOAT;
+
+  const int rankMin = params.neighborsRank[faceMin];
+  const int rankMax = params.neighborsRank[faceMax];
+  const int tag = 711 + 10*dir;
+
+  MGBorderBufFunctor::apply(level.info, level.phi, level.sendMin, faceMin, true);
+  MGBorderBufFunctor::apply(level.info, level.phi, level.sendMax, faceMax, true);
+  Kokkos::fence();
+
+  params.communicator->sendrecv(level.sendMin.data(), count, data_type, rankMin, tag,
+				level.recvMax.data(), count, data_type, rankMax, tag);
+
+  params.communicator->sendrecv(level.sendMax.data(), count, data_type, rankMax, tag+1,
+				level.recvMin.data(), count, data_type, rankMin, tag+1);
+
+  MGBorderBufFunctor::apply(level.info, level.phi, level.recvMin, faceMin, false);
+  MGBorderBufFunctor::apply(level.info, level.phi, level.recvMax, faceMax, false);
+#else
+  UNUSED(level);
+  UNUSED(dir);
+#endif // USE_MPI
+
+} // PoissonMultigrid::exchange_ghosts
+
+// =======================================================
+// =======================================================
+template<int dim>
+void PoissonMultigrid<dim>::smooth(int ilevel, int nb_sweeps)
+{
+
+  Level& level = m_levels[ilevel];
+
+  for (int iter = 0; iter < nb_sweeps; ++iter) {
+    for (int color = 0; color < 2; ++color) {
+      fill_ghosts(ilevel);
+      MGSmoothFunctor::apply(level.info, level.phi, level.rhs, color);
+    }
+  }
+
+} // PoissonMultigrid::smooth
+
+// =======================================================
+// =======================================================
+template<int dim>
+void PoissonMultigrid<dim>::vcycle(int ilevel)
+{
+
+  Level& level = m_levels[ilevel];
+
+  // coarsest level
+  if (ilevel == (int) m_levels.size()-1) {
+    bottom_solve(ilevel);
+    return;
+  }
+
+  Level& coarse = m_levels[ilevel+1];
+
+  smooth(ilevel, m_nu1);
+
+  fill_ghosts(ilevel);
+  MGResidualFunctor::apply(level.info, level.phi, level.rhs, level.res);
+
+  Kokkos::deep_copy(coarse.phi, 0.0);
+
+  if (ilevel+1 == m_agglo_level) {
+
+    gather_residual(ilevel);
+    if (m_agglo_owner)
+      vcycle(ilevel+1);
+    scatter_correction(ilevel);
+
+  } else {
+
+    MGRestrictFunctor::apply(level.info, coarse.info, level.res, coarse.rhs);
+    vcycle(ilevel+1);
+    fill_ghosts(ilevel+1);
+    MGProlongFunctor::apply(level.info, coarse.info, coarse.phi, level.phi);
+
+  }
+
+  smooth(ilevel, m_nu2);
+
+} // PoissonMultigrid::vcycle
+
+// =======================================================
+// =======================================================
+/**
+ * Coarsest level: relax until the residual is reduced by
+ * m_bottom_tolerance (or m_bottom_max_sweeps sweeps were done).
+ */
+template<int dim>
+void PoissonMultigrid<dim>::bottom_solve(int ilevel)
+{
+
+  Level& level = m_levels[ilevel];
+
+  long long int nbCells = level.info.nx * level.info.ny * level.info.nz;
+  if (level.distributed)
+    nbCells *= m_mpi_size[IX]*m_mpi_size[IY]*m_mpi_size[IZ];
+
+  // periodic: the problem is only solvable for a zero mean right hand
+  // side (restriction preserves it up to round-off)
+  if (m_periodic) {
+    const real_t mean = sum(level, level.rhs) / nbCells;
+    MGAddConstantFunctor::apply(level.info, level.rhs, -mean);
+  }
+
+  const real_t rhs_norm = norm_max(level, level.rhs);
+
+  m_bottom_nb_sweeps = 0;
+
+  if (rhs_norm > 0) {
+
+    while (m_bottom_nb_sweeps < m_bottom_max_sweeps) {
+
+      smooth(ilevel, m_bottom_sweeps);
+      m_bottom_nb_sweeps += m_bottom_sweeps;
+
+      fill_ghosts(ilevel);
+      MGResidualFunctor::apply(level.info, level.phi, level.rhs, level.res);
+
+      if (norm_max(level, level.res) < m_bottom_tolerance * rhs_norm)
+	break;
+
+    }
+
+  } else {
+
+    Kokkos::deep_copy(level.phi, 0.0);
+
+  }
+
+  if (m_periodic)
+    remove_mean(ilevel);
+
+} // PoissonMultigrid::bottom_solve
+
+// =======================================================
+// =======================================================
+template<int dim>
+real_t PoissonMultigrid<dim>::norm_max(const Level& level, MGArray data) const
+{
+
+  real_t norm = 0;
+  MGNormFunctor::apply(level.info, data, norm);
+
+#ifdef USE_MPI
+  if (level.distributed) {
+    using namespace hydroSimu;
+    const int data_type = sizeof(real_t) == sizeof(double) ?
+      MpiComm::DOUBLE : MpiComm::FLOAT;
+    real_t norm_local = norm;
+    params.communicator->allReduce(&norm_local, &norm, 1, data_type, MpiComm::MAX);
+  }
+#endif // USE_MPI
+
+  return norm;
+
+} // PoissonMultigrid::norm_max
+
+// =======================================================
+// =======================================================
+template<int dim>
+real_t PoissonMultigrid<dim>::sum(const Level& level, MGArray data) const
+{
+
+  real_t sum = 0;
+  MGSumFunctor::apply(level.info, data, sum);
+
+#ifdef USE_MPI
+  if (level.distributed) {
+    using namespace hydroSimu;
+    const int data_type = sizeof(real_t) == sizeof(double) ?
+      MpiComm::DOUBLE : MpiComm::FLOAT;
+    real_t sum_local = sum;
+    params.communicator->allReduce(&sum_local, &sum, 1, data_type, MpiComm::SUM);
+  }
+#endif // USE_MPI
+
+  return sum;
+
+} // PoissonMultigrid::sum
+
+// =======================================================
+// =======================================================
+/**
+ * Periodic boundaries: potential is defined up to a constant, remove
+ * its mean value.
+ */
+template<int dim>
+void PoissonMultigrid<dim>::remove_mean(int ilevel)
+{
+
+  Level& level = m_levels[ilevel];
+
+  long long int nbCells = level.info.nx * level.info.ny * level.info.nz;
+  if (level.distributed)
+    nbCells *= m_mpi_size[IX]*m_mpi_size[IY]*m_mpi_size[IZ];
+
+  const real_t mean = sum(level, level.phi) / nbCells;
+
+  MGAddConstantFunctor::apply(level.info, level.phi, -mean);
+
+} // PoissonMultigrid::remove_mean
+
+// =======================================================
+// =======================================================
+/**
+ * Agglomeration: gather the residual of distributed level ilevel into
+ * the right hand side of level ilevel+1 (same resolution) on the
+ * agglomeration process.
+ *
+ * Coarse levels are small, so this is done on host.
+ */
+template<int dim>
+void PoissonMultigrid<dim>::gather_residual(int ilevel)
+{
+
+#ifdef USE_MPI
+  using namespace hydroSimu;
+
+  const MGLevelInfo& fine = m_levels[ilevel].info;
+  const MGLevelInfo& glob = m_levels[ilevel+1].info;
+
+  const int nx = fine.nx, ny = fine.ny, nz = fine.nz;
+  const int nbCells = nx*ny*nz;
+  const int nProcs  = params.nProcs;
+  const int data_type = sizeof(real_t) == sizeof(double) ?
+    MpiComm::DOUBLE : MpiComm::FLOAT;
+
+  auto res_h = Kokkos::create_mirror_view(m_levels[ilevel].res);
+  Kokkos::deep_copy(res_h, m_levels[ilevel].res);
+
+  std::vector<real_t> sendBuf(nbCells);
+  std::vector<real_t> recvBuf(m_agglo_owner ? nbCells*nProcs : 0);
+
+  for (int k=0; k<nz; ++k)
+    for (int j=0; j<ny; ++j)
+      for (int i=0; i<nx; ++i)
+	sendBuf[i+nx*(j+ny*k)] = res_h(i+fine.gw, j+fine.gw, k+fine.gwz);
+
+  params.communicator->gather(sendBuf.data(), nbCells, data_type,
+			      recvBuf.data(), nbCells, data_type,
+			      m_agglo_root);
+
+  if (!m_agglo_owner)
+    return;
+
+  auto rhs_h = Kokkos::create_mirror_view(m_levels[ilevel+1].rhs);
+
+  for (int rank=0; rank<nProcs; ++rank) {
+
+    int coords[3] = {0,0,0};
+    params.communicator->getCoords(rank, dim, coords);
+
+    const real_t* block = recvBuf.data() + rank*nbCells;
+
+    for (int k=0; k<nz; ++k)
+      for (int j=0; j<ny; ++j)
+	for (int i=0; i<nx; ++i)
+	  rhs_h(i + nx*coords[IX] + glob.gw,
+		j + ny*coords[IY] + glob.gw,
+		k + nz*coords[IZ] + glob.gwz) = block[i+nx*(j+ny*k)];
+
+  }
+
+  Kokkos::deep_copy(m_levels[ilevel+1].rhs, rhs_h);
+#else
+  UNUSED(ilevel);
+#endif // USE_MPI
+
+} // PoissonMultigrid::gather_residual
+
+// =======================================================
+// =======================================================
+/**
+ * Agglomeration: scatter the correction of level ilevel+1 from the
+ * agglomeration process, and add it to the distributed level ilevel.
+ */
+template<int dim>
+void PoissonMultigrid<dim>::scatter_correction(int ilevel)
+{
+
+#ifdef USE_MPI
+  using namespace hydroSimu;
+
+  const MGLevelInfo& fine = m_levels[ilevel].info;
+  const MGLevelInfo& glob = m_levels[ilevel+1].info;
+
+  const int nx = fine.nx, ny = fine.ny, nz = fine.nz;
+  const int nbCells = nx*ny*nz;
+  const int nProcs  = params.nProcs;
+  const int data_type = sizeof(real_t) == sizeof(double) ?
+    MpiComm::DOUBLE : MpiComm::FLOAT;
+
+  std::vector<real_t> sendBuf(m_agglo_owner ? nbCells*nProcs : 0);
+  std::vector<real_t> recvBuf(nbCells);
+
+  if (m_agglo_owner) {
+
+    auto phiGlob_h = Kokkos::create_mirror_view(m_levels[ilevel+1].phi);
+    Kokkos::deep_copy(phiGlob_h, m_levels[ilevel+1].phi);
+
+    for (int rank=0; rank<nProcs; ++rank) {
+
+      int coords[3] = {0,0,0};
+      params.communicator->getCoords(rank, dim, coords);
+
+      real_t* block = sendBuf.data() + rank*nbCells;
+
+      for (int k=0; k<nz; ++k)
+	for (int j=0; j<ny; ++j)
+	  for (int i=0; i<nx; ++i)
+	    block[i+nx*(j+ny*k)] = phiGlob_h(i + nx*coords[IX] + glob.gw,
+					     j + ny*coords[IY] + glob.gw,
+					     k + nz*coords[IZ] + glob.gwz);
+
+    }
+
+  }
+
+  params.communicator->scatter(sendBuf.data(), nbCells, data_type,
+			       recvBuf.data(), nbCells, data_type,
+			       m_agglo_root);
+
+  auto phi_h = Kokkos::create_mirror_view(m_levels[ilevel].phi);
+  Kokkos::deep_copy(phi_h, m_levels[ilevel].phi);
+
+  for (int k=0; k<nz; ++k)
+    for (int j=0; j<ny; ++j)
+      for (int i=0; i<nx; ++i)
+	phi_h(i+fine.gw, j+fine.gw, k+fine.gwz) += recvBuf[i+nx*(j+ny*k)];
+
+  Kokkos::deep_copy(m_levels[ilevel].phi, phi_h);
+#else
+  UNUSED(ilevel);
+#endif // USE_MPI
+
+} // PoissonMultigrid::scatter_correction
+
+// =======================================================
+// =======================================================
+template<int dim>
+void PoissonMultigrid<dim>::solve(DataArray Udata, VectorField gravity)
+{
+
+  Level& fine = m_levels[0];
+
+  /*
+   * total mass and center of mass
+   */
+  real_t moments[4] = {0, 0, 0, 0};
+  MGDensityMomentsFunctor<dim>::apply(fine.info, Udata, moments);
+
+#ifdef USE_MPI
+  if (fine.distributed) {
+    using namespace hydroSimu;
+    const int data_type = sizeof(real_t) == sizeof(double) ?
+      MpiComm::DOUBLE : MpiComm::FLOAT;
+    real_t moments_local[4] = {moments[0], moments[1], moments[2], moments[3]};
+    params.communicator->allReduce(moments_local, moments, 4, data_type, MpiComm::SUM);
+  }
+#endif // USE_MPI
+
+  const real_t mass = moments[0];
+
+  real_t volume = (params.xmax-params.xmin)*(params.ymax-params.ymin);
+  if (dim==3)
+    volume *= (params.zmax-params.zmin);
+
+  m_monopole.GM = m_G*mass;
+  if (mass > 0) {
+    m_monopole.xc = moments[1]/mass;
+    m_monopole.yc = moments[2]/mass;
+    m_monopole.zc = moments[3]/mass;
+  } else {
+    m_monopole.xc = 0.5*(params.xmin+params.xmax);
+    m_monopole.yc = 0.5*(params.ymin+params.ymax);
+    m_monopole.zc = 0.5*(params.zmin+params.zmax);
+  }
+
+  /*
+   * right hand side
+   */
+  const real_t fourPiG = 4*M_PI*m_G;
+  const real_t rho_mean = m_periodic ? mass/volume : 0;
+
+  MGDensityRhsFunctor<dim>::apply(fine.info, Udata, fine.rhs, fourPiG, rho_mean);
+
+  const real_t rhs_norm = norm_max(fine, fine.rhs);
+
+  /*
+   * V-cycles (previous potential is the initial guess)
+   */
+  m_nb_cycles = 0;
+  m_residual  = 0;
+
+  if (rhs_norm > 0) {
+
+    while (m_nb_cycles < m_max_cycles) {
+
+      vcycle(0);
+      m_nb_cycles++;
+
+      fill_ghosts(0);
+      MGResidualFunctor::apply(fine.info, fine.phi, fine.rhs, fine.res);
+      m_residual = norm_max(fine, fine.res) / rhs_norm;
+
+      if (m_residual < m_tolerance)
+	break;
+
+    }
+
+  } else {
+
+    Kokkos::deep_copy(fine.phi, 0.0);
+
+  }
+
+  if (m_periodic)
+    remove_mean(0);
+
+  /*
+   * gravity field
+   */
+  fill_ghosts(0);
+  MGGravityFunctor<dim>::apply(fine.info, fine.phi, gravity);
+
+} // PoissonMultigrid::solve
+
+} // namespace ppkMHD
+
+#endif // POISSON_MULTIGRID_H_
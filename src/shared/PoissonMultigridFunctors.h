@@ -0,0 +1,937 @@
+/**
+ * \file PoissonMultigridFunctors.h
+ * \brief Device functors used by the geometric multigrid Poisson solver
+ * (see PoissonMultigrid.h).
+ *
+ * All multigrid levels use 3D scalar arrays; in 2D the last dimension
+ * has size 1 and no ghost cells, so that the same kernels can be used
+ * for both dimensions.
+ */
+#ifndef POISSON_MULTIGRID_FUNCTORS_H_
+#define POISSON_MULTIGRID_FUNCTORS_H_
+
+#include <type_traits>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+#include "shared/enums.h"
+
+namespace ppkMHD
+{
+
+//! scalar array used on every multigrid level
+using MGArray  = Kokkos::View<real_t***, Device>;
+
+//! contiguous buffer used for MPI ghost cells exchange
+using MGBuffer = Kokkos::View<real_t*, Device>;
+
+/**
+ * Geometry of a multigrid level, as seen by device functors.
+ *
+ * Interior cells are i in [gw,gw+nx), j in [gw,gw+ny), k in [gwz,gwz+nz).
+ */
+struct MGLevelInfo
+{
+  int dim;                 //!< 2 or 3
+  int nx, ny, nz;          //!< interior sizes (nz=1 in 2D)
+  int gw;                  //!< ghost width along x and y
+  int gwz;                 //!< ghost width along z (0 in 2D)
+  int isize, jsize, ksize; //!< sizes with ghosts
+  real_t dx, dy, dz;       //!< cell sizes
+  real_t x0, y0, z0;       //!< center location of cell (0,0,0), ghost included
+  int parity;              //!< parity offset to get global red/black coloring
+};
+
+/**
+ * Potential created by a point mass, used to set boundary values with
+ * isolated boundary conditions (monopole approximation).
+ *
+ * In 2D, this is the potential of a line mass, i.e. 2 G M ln(r).
+ */
+struct MGMonopole
+{
+  int dim;
+  real_t GM;         //!< G times total mass
+  real_t xc, yc, zc; //!< center of mass
+
+  KOKKOS_INLINE_FUNCTION
+  real_t eval(real_t x, real_t y, real_t z) const
+  {
+    const real_t r2 = (x-xc)*(x-xc) + (y-yc)*(y-yc) +
+      (dim==3 ? (z-zc)*(z-zc) : 0);
+    const real_t r  = fmax(sqrt(r2), 1e-20);
+
+    return dim==3 ? -GM / r : 2*GM*log(r);
+  }
+}; // struct MGMonopole
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Red-black Gauss-Seidel relaxation of the 5/7 points Laplacian.
+ *
+ * Only cells of the given color are updated.
+ */
+class MGSmoothFunctor
+{
+
+public:
+  MGSmoothFunctor(MGLevelInfo info,
+		  MGArray     phi,
+		  MGArray     rhs,
+		  int         color) :
+    info(info), phi(phi), rhs(rhs), color(color)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     phi,
+		    MGArray     rhs,
+		    int         color)
+  {
+    MGSmoothFunctor functor(info, phi, rhs, color);
+    Kokkos::parallel_for("MGSmoothFunctor", info.nx*info.ny*info.nz, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.nx,info.ny,info.nz);
+    i += info.gw;
+    j += info.gw;
+    k += info.gwz;
+
+    if ( ((i+j+k+info.parity) & 1) != color )
+      return;
+
+    const real_t idx2 = 1.0/(info.dx*info.dx);
+    const real_t idy2 = 1.0/(info.dy*info.dy);
+
+    real_t sum  = (phi(i+1,j,k) + phi(i-1,j,k)) * idx2 +
+                  (phi(i,j+1,k) + phi(i,j-1,k)) * idy2;
+    real_t diag = 2*(idx2 + idy2);
+
+    if (info.dim == 3) {
+      const real_t idz2 = 1.0/(info.dz*info.dz);
+      sum  += (phi(i,j,k+1) + phi(i,j,k-1)) * idz2;
+      diag += 2*idz2;
+    }
+
+    phi(i,j,k) = (sum - rhs(i,j,k)) / diag;
+
+  } // operator ()
+
+  MGLevelInfo info;
+  MGArray phi, rhs;
+  int color;
+
+}; // MGSmoothFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Compute residual res = rhs - laplacian(phi) in interior cells.
+ */
+class MGResidualFunctor
+{
+
+public:
+  MGResidualFunctor(MGLevelInfo info,
+		    MGArray     phi,
+		    MGArray     rhs,
+		    MGArray     res) :
+    info(info), phi(phi), rhs(rhs), res(res)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     phi,
+		    MGArray     rhs,
+		    MGArray     res)
+  {
+    MGResidualFunctor functor(info, phi, rhs, res);
+    Kokkos::parallel_for("MGResidualFunctor", info.nx*info.ny*info.nz, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.nx,info.ny,info.nz);
+    i += info.gw;
+    j += info.gw;
+    k += info.gwz;
+
+    const real_t c = phi(i,j,k);
+
+    real_t lap =
+      (phi(i+1,j,k) - 2*c + phi(i-1,j,k)) / (info.dx*info.dx) +
+      (phi(i,j+1,k) - 2*c + phi(i,j-1,k)) / (info.dy*info.dy);
+
+    if (info.dim == 3)
+      lap += (phi(i,j,k+1) - 2*c + phi(i,j,k-1)) / (info.dz*info.dz);
+
+    res(i,j,k) = rhs(i,j,k) - lap;
+
+  } // operator ()
+
+  MGLevelInfo info;
+  MGArray phi, rhs, res;
+
+}; // MGResidualFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Restriction (average of the 4 / 8 children cells) of a fine array
+ * into a coarse array.
+ */
+class MGRestrictFunctor
+{
+
+public:
+  MGRestrictFunctor(MGLevelInfo fine,
+		    MGLevelInfo coarse,
+		    MGArray     data_fine,
+		    MGArray     data_coarse) :
+    fine(fine), coarse(coarse),
+    data_fine(data_fine), data_coarse(data_coarse)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo fine,
+		    MGLevelInfo coarse,
+		    MGArray     data_fine,
+		    MGArray     data_coarse)
+  {
+    MGRestrictFunctor functor(fine, coarse, data_fine, data_coarse);
+    Kokkos::parallel_for("MGRestrictFunctor", coarse.nx*coarse.ny*coarse.nz, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int ic,jc,kc;
+    index2coord(index,ic,jc,kc,coarse.nx,coarse.ny,coarse.nz);
+
+    const int i = fine.gw  + 2*ic;
+    const int j = fine.gw  + 2*jc;
+    const int k = fine.gwz + (fine.dim==3 ? 2*kc : 0);
+
+    real_t sum =
+      data_fine(i  ,j  ,k) + data_fine(i+1,j  ,k) +
+      data_fine(i  ,j+1,k) + data_fine(i+1,j+1,k);
+
+    if (fine.dim == 3) {
+      sum +=
+	data_fine(i  ,j  ,k+1) + data_fine(i+1,j  ,k+1) +
+	data_fine(i  ,j+1,k+1) + data_fine(i+1,j+1,k+1);
+    }
+
+    data_coarse(ic+coarse.gw, jc+coarse.gw, kc+coarse.gwz) =
+      fine.dim==3 ? sum/8 : sum/4;
+
+  } // operator ()
+
+  MGLevelInfo fine, coarse;
+  MGArray data_fine, data_coarse;
+
+}; // MGRestrictFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Prolongation (bi/tri-linear interpolation) of a coarse correction,
+ * added to a fine array.
+ *
+ * Coarse ghost cells must be up to date.
+ */
+class MGProlongFunctor
+{
+
+public:
+  MGProlongFunctor(MGLevelInfo fine,
+		   MGLevelInfo coarse,
+		   MGArray     data_coarse,
+		   MGArray     data_fine) :
+    fine(fine), coarse(coarse),
+    data_coarse(data_coarse), data_fine(data_fine)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo fine,
+		    MGLevelInfo coarse,
+		    MGArray     data_coarse,
+		    MGArray     data_fine)
+  {
+    MGProlongFunctor functor(fine, coarse, data_coarse, data_fine);
+    Kokkos::parallel_for("MGProlongFunctor", fine.nx*fine.ny*fine.nz, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,fine.nx,fine.ny,fine.nz);
+
+    // parent cell and direction of the second nearest coarse cell
+    const int ic = coarse.gw + i/2;
+    const int jc = coarse.gw + j/2;
+    const int kc = coarse.gwz + (fine.dim==3 ? k/2 : 0);
+    const int si = (i & 1) ? 1 : -1;
+    const int sj = (j & 1) ? 1 : -1;
+    const int sk = (k & 1) ? 1 : -1;
+
+    const real_t w[2] = {0.75, 0.25};
+
+    real_t value = 0;
+    if (fine.dim == 3) {
+      for (int c=0; c<2; ++c)
+	for (int b=0; b<2; ++b)
+	  for (int a=0; a<2; ++a)
+	    value += w[a]*w[b]*w[c]*data_coarse(ic+a*si, jc+b*sj, kc+c*sk);
+    } else {
+      for (int b=0; b<2; ++b)
+	for (int a=0; a<2; ++a)
+	  value += w[a]*w[b]*data_coarse(ic+a*si, jc+b*sj, kc);
+    }
+
+    data_fine(i+fine.gw, j+fine.gw, k+fine.gwz) += value;
+
+  } // operator ()
+
+  MGLevelInfo fine, coarse;
+  MGArray data_coarse, data_fine;
+
+}; // MGProlongFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Number of ghost cells in the slab of a given face (other dimensions
+ * are taken with their ghost cells, so that corners are filled when
+ * directions are processed one after the other).
+ */
+KOKKOS_INLINE_FUNCTION
+int mg_face_slab_size(const MGLevelInfo& info, int dir)
+{
+  return dir==IX ? info.gw*info.jsize*info.ksize :
+         dir==IY ? info.isize*info.gw*info.ksize :
+                   info.isize*info.jsize*info.gwz;
+}
+
+/**
+ * Retrieve (i,j,k) ghost location and mirror interior location from a
+ * slab index.
+ *
+ * \param[in]  info level geometry
+ * \param[in]  face boundary location (XMIN, ..., ZMAX)
+ * \param[in]  index slab index
+ * \param[out] i,j,k ghost cell location
+ * \param[out] im,jm,km mirror interior cell location (w.r.t. face)
+ */
+KOKKOS_INLINE_FUNCTION
+void mg_face_coord(const MGLevelInfo& info, int face, int index,
+		   int& i,  int& j,  int& k,
+		   int& im, int& jm, int& km)
+{
+  if (face == XMIN or face == XMAX) {
+    int g;
+    index2coord(index,g,j,k,info.gw,info.jsize,info.ksize);
+    i  = face==XMIN ? info.gw-1-g        : info.gw+info.nx+g;
+    im = face==XMIN ? info.gw+g          : info.gw+info.nx-1-g;
+    jm = j;
+    km = k;
+  } else if (face == YMIN or face == YMAX) {
+    int g;
+    index2coord(index,i,g,k,info.isize,info.gw,info.ksize);
+    j  = face==YMIN ? info.gw-1-g        : info.gw+info.ny+g;
+    jm = face==YMIN ? info.gw+g          : info.gw+info.ny-1-g;
+    im = i;
+    km = k;
+  } else {
+    int g;
+    index2coord(index,i,j,g,info.isize,info.jsize,info.gwz);
+    k  = face==ZMIN ? info.gwz-1-g       : info.gwz+info.nz+g;
+    km = face==ZMIN ? info.gwz+g         : info.gwz+info.nz-1-g;
+    im = i;
+    jm = j;
+  }
+} // mg_face_coord
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Periodic boundary conditions along one direction, when the whole
+ * domain along that direction is owned by the current process.
+ */
+class MGPeriodicFunctor
+{
+
+public:
+  MGPeriodicFunctor(MGLevelInfo info,
+		    MGArray     phi,
+		    int         dir) :
+    info(info), phi(phi), dir(dir)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     phi,
+		    int         dir)
+  {
+    MGPeriodicFunctor functor(info, phi, dir);
+    Kokkos::parallel_for("MGPeriodicFunctor", mg_face_slab_size(info,dir), functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k, im,jm,km;
+
+    if (dir == IX) {
+
+      const int n = info.nx;
+      mg_face_coord(info, XMIN, index, i,j,k, im,jm,km);
+      phi(i,j,k) = phi(i+n,j,k);
+      mg_face_coord(info, XMAX, index, i,j,k, im,jm,km);
+      phi(i,j,k) = phi(i-n,j,k);
+
+    } else if (dir == IY) {
+
+      const int n = info.ny;
+      mg_face_coord(info, YMIN, index, i,j,k, im,jm,km);
+      phi(i,j,k) = phi(i,j+n,k);
+      mg_face_coord(info, YMAX, index, i,j,k, im,jm,km);
+      phi(i,j,k) = phi(i,j-n,k);
+
+    } else {
+
+      const int n = info.nz;
+      mg_face_coord(info, ZMIN, index, i,j,k, im,jm,km);
+      phi(i,j,k) = phi(i,j,k+n);
+      mg_face_coord(info, ZMAX, index, i,j,k, im,jm,km);
+      phi(i,j,k) = phi(i,j,k-n);
+
+    }
+
+  } // operator ()
+
+  MGLevelInfo info;
+  MGArray phi;
+  int dir;
+
+}; // MGPeriodicFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Dirichlet boundary condition on a physical face (isolated boundaries).
+ *
+ * Ghost values are set so that the value interpolated at the face is
+ * either zero (homogeneous, i.e. coarse grid corrections) or given by the
+ * monopole potential (finest level).
+ */
+class MGDirichletFunctor
+{
+
+public:
+  MGDirichletFunctor(MGLevelInfo info,
+		     MGArray     phi,
+		     int         face,
+		     bool        homogeneous,
+		     MGMonopole  monopole) :
+    info(info), phi(phi), face(face),
+    homogeneous(homogeneous), monopole(monopole)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     phi,
+		    int         face,
+		    bool        homogeneous,
+		    MGMonopole  monopole)
+  {
+    MGDirichletFunctor functor(info, phi, face, homogeneous, monopole);
+    Kokkos::parallel_for("MGDirichletFunctor", mg_face_slab_size(info,face/2), functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k, im,jm,km;
+    mg_face_coord(info, face, index, i,j,k, im,jm,km);
+
+    real_t phi_b = 0;
+
+    if (!homogeneous) {
+
+      // face center location (half way between ghost and mirror cells)
+      const real_t x = info.x0 + 0.5*(i+im)*info.dx;
+      const real_t y = info.y0 + 0.5*(j+jm)*info.dy;
+      const real_t z = info.z0 + 0.5*(k+km)*info.dz;
+
+      phi_b = monopole.eval(x,y,z);
+
+    }
+
+    phi(i,j,k) = 2*phi_b - phi(im,jm,km);
+
+  } // operator ()
+
+  MGLevelInfo info;
+  MGArray phi;
+  int face;
+  bool homogeneous;
+  MGMonopole monopole;
+
+}; // MGDirichletFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Copy the interior cells next to a face into a MPI border buffer
+ * (pack = true) or a received border buffer into the ghost cells
+ * of that face (pack = false).
+ */
+class MGBorderBufFunctor
+{
+
+public:
+  MGBorderBufFunctor(MGLevelInfo info,
+		     MGArray     phi,
+		     MGBuffer    buf,
+		     int         face,
+		     bool        pack) :
+    info(info), phi(phi), buf(buf), face(face), pack(pack)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     phi,
+		    MGBuffer    buf,
+		    int         face,
+		    bool        pack)
+  {
+    MGBorderBufFunctor functor(info, phi, buf, face, pack);
+    Kokkos::parallel_for("MGBorderBufFunctor", mg_face_slab_size(info,face/2), functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k, im,jm,km;
+    mg_face_coord(info, face, index, i,j,k, im,jm,km);
+
+    // interior cells sent to the neighbor must be the ones its ghost
+    // cells correspond to, i.e. ordered by distance to the face
+    if (pack)
+      buf(index) = phi(im,jm,km);
+    else
+      phi(i,j,k) = buf(index);
+
+  } // operator ()
+
+  MGLevelInfo info;
+  MGArray phi;
+  MGBuffer buf;
+  int face;
+  bool pack;
+
+}; // MGBorderBufFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Add a constant to a whole array (ghost included).
+ */
+class MGAddConstantFunctor
+{
+
+public:
+  MGAddConstantFunctor(MGArray data,
+		       real_t  value) :
+    data(data), value(value)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     data,
+		    real_t      value)
+  {
+    MGAddConstantFunctor functor(data, value);
+    Kokkos::parallel_for("MGAddConstantFunctor", info.isize*info.jsize*info.ksize, functor);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int isize = data.extent(0);
+    const int jsize = data.extent(1);
+    const int ksize = data.extent(2);
+    int i,j,k;
+    index2coord(index,i,j,k,isize,jsize,ksize);
+
+    data(i,j,k) += value;
+
+  } // operator ()
+
+  MGArray data;
+  real_t value;
+
+}; // MGAddConstantFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Reduce (max of absolute value) over interior cells.
+ */
+class MGNormFunctor
+{
+
+public:
+  MGNormFunctor(MGLevelInfo info,
+		MGArray     data) :
+    info(info), data(data)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     data,
+		    real_t&     norm)
+  {
+    MGNormFunctor functor(info, data);
+    Kokkos::parallel_reduce("MGNormFunctor", info.nx*info.ny*info.nz, functor, norm);
+  }
+
+  // Tell each thread how to initialize its reduction result.
+  KOKKOS_INLINE_FUNCTION
+  void init (real_t& dst) const
+  {
+    dst = 0;
+  } // init
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index, real_t& norm) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.nx,info.ny,info.nz);
+
+    norm = fmax(norm, fabs(data(i+info.gw, j+info.gw, k+info.gwz)));
+
+  } // operator ()
+
+  // "Join" intermediate results from different threads.
+  KOKKOS_INLINE_FUNCTION
+  void join (volatile real_t& dst,
+	     const volatile real_t& src) const
+  {
+    // max reduce
+    if (dst < src) {
+      dst = src;
+    }
+  } // join
+
+  MGLevelInfo info;
+  MGArray data;
+
+}; // MGNormFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Reduce (sum) over interior cells.
+ */
+class MGSumFunctor
+{
+
+public:
+  MGSumFunctor(MGLevelInfo info,
+	       MGArray     data) :
+    info(info), data(data)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     data,
+		    real_t&     sum)
+  {
+    MGSumFunctor functor(info, data);
+    Kokkos::parallel_reduce("MGSumFunctor", info.nx*info.ny*info.nz, functor, sum);
+  }
+
+  // Tell each thread how to initialize its reduction result.
+  KOKKOS_INLINE_FUNCTION
+  void init (real_t& dst) const
+  {
+    dst = 0;
+  } // init
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index, real_t& sum) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.nx,info.ny,info.nz);
+
+    sum += data(i+info.gw, j+info.gw, k+info.gwz);
+
+  } // operator ()
+
+  // "Join" intermediate results from different threads.
+  KOKKOS_INLINE_FUNCTION
+  void join (volatile real_t& dst,
+	     const volatile real_t& src) const
+  {
+    dst += src;
+  } // join
+
+  MGLevelInfo info;
+  MGArray data;
+
+}; // MGSumFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Mass and first order moments (rho, rho x, rho y, rho z) of the
+ * density field, integrated over interior cells.
+ *
+ * Finest multigrid level and hydro arrays share the same indexing.
+ */
+template<int dim>
+class MGDensityMomentsFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  //! array reduction: 4 values
+  using value_type = real_t[];
+  const unsigned value_count = 4;
+
+  MGDensityMomentsFunctor(MGLevelInfo info,
+			  DataArray   Udata) :
+    info(info), Udata(Udata)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    DataArray   Udata,
+		    real_t      moments[4])
+  {
+    MGDensityMomentsFunctor<dim> functor(info, Udata);
+    Kokkos::parallel_reduce("MGDensityMomentsFunctor", info.nx*info.ny*info.nz, functor, moments);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void init (value_type dst) const
+  {
+    for (unsigned n=0; n<value_count; ++n)
+      dst[n] = 0;
+  } // init
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t density(typename std::enable_if<dim_==2, int>::type i,
+		 int j, int k) const
+  {
+    return Udata(i,j,ID);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t density(typename std::enable_if<dim_==3, int>::type i,
+		 int j, int k) const
+  {
+    return Udata(i,j,k,ID);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index, value_type sum) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.nx,info.ny,info.nz);
+    i += info.gw;
+    j += info.gw;
+    k += info.gwz;
+
+    const real_t dV = info.dx*info.dy*(dim==3 ? info.dz : 1);
+    const real_t dm = density(i,j,k)*dV;
+
+    sum[0] += dm;
+    sum[1] += dm * (info.x0 + i*info.dx);
+    sum[2] += dm * (info.y0 + j*info.dy);
+    sum[3] += dm * (dim==3 ? info.z0 + k*info.dz : 0);
+
+  } // operator ()
+
+  KOKKOS_INLINE_FUNCTION
+  void join (volatile value_type dst,
+	     const volatile value_type src) const
+  {
+    for (unsigned n=0; n<value_count; ++n)
+      dst[n] += src[n];
+  } // join
+
+  MGLevelInfo info;
+  DataArray Udata;
+
+}; // MGDensityMomentsFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Poisson equation right hand side: 4 pi G (rho - rho_mean).
+ */
+template<int dim>
+class MGDensityRhsFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  MGDensityRhsFunctor(MGLevelInfo info,
+		      DataArray   Udata,
+		      MGArray     rhs,
+		      real_t      fourPiG,
+		      real_t      rho_mean) :
+    info(info), Udata(Udata), rhs(rhs),
+    fourPiG(fourPiG), rho_mean(rho_mean)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    DataArray   Udata,
+		    MGArray     rhs,
+		    real_t      fourPiG,
+		    real_t      rho_mean)
+  {
+    MGDensityRhsFunctor<dim> functor(info, Udata, rhs, fourPiG, rho_mean);
+    Kokkos::parallel_for("MGDensityRhsFunctor", info.nx*info.ny*info.nz, functor);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t density(typename std::enable_if<dim_==2, int>::type i,
+		 int j, int k) const
+  {
+    return Udata(i,j,ID);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t density(typename std::enable_if<dim_==3, int>::type i,
+		 int j, int k) const
+  {
+    return Udata(i,j,k,ID);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.nx,info.ny,info.nz);
+    i += info.gw;
+    j += info.gw;
+    k += info.gwz;
+
+    rhs(i,j,k) = fourPiG * (density(i,j,k) - rho_mean);
+
+  } // operator ()
+
+  MGLevelInfo info;
+  DataArray Udata;
+  MGArray rhs;
+  real_t fourPiG, rho_mean;
+
+}; // MGDensityRhsFunctor
+
+/*************************************************/
+/*************************************************/
+/*************************************************/
+/**
+ * Gravity field g = - grad(phi) (centered differences).
+ *
+ * Computed everywhere except in the outermost ghost layer, which is never
+ * read by the hydro kernels.
+ */
+template<int dim>
+class MGGravityFunctor
+{
+
+public:
+  //! Decide at compile-time which vector field to use
+  using VectorField = typename std::conditional<dim==2,VectorField2d,VectorField3d>::type;
+
+  MGGravityFunctor(MGLevelInfo info,
+		   MGArray     phi,
+		   VectorField gravity) :
+    info(info), phi(phi), gravity(gravity)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(MGLevelInfo info,
+		    MGArray     phi,
+		    VectorField gravity)
+  {
+    MGGravityFunctor<dim> functor(info, phi, gravity);
+    Kokkos::parallel_for("MGGravityFunctor", info.isize*info.jsize*info.ksize, functor);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.isize,info.jsize,info.ksize);
+
+    if (i > 0 and i < info.isize-1 and
+	j > 0 and j < info.jsize-1) {
+      gravity(i,j,IX) = -(phi(i+1,j,0) - phi(i-1,j,0)) / (2*info.dx);
+      gravity(i,j,IY) = -(phi(i,j+1,0) - phi(i,j-1,0)) / (2*info.dy);
+    }
+
+  } // operator () - 2D
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  {
+    int i,j,k;
+    index2coord(index,i,j,k,info.isize,info.jsize,info.ksize);
+
+    if (i > 0 and i < info.isize-1 and
+	j > 0 and j < info.jsize-1 and
+	k > 0 and k < info.ksize-1) {
+      gravity(i,j,k,IX) = -(phi(i+1,j,k) - phi(i-1,j,k)) / (2*info.dx);
+      gravity(i,j,k,IY) = -(phi(i,j+1,k) - phi(i,j-1,k)) / (2*info.dy);
+      gravity(i,j,k,IZ) = -(phi(i,j,k+1) - phi(i,j,k-1)) / (2*info.dz);
+    }
+
+  } // operator () - 3D
+
+  MGLevelInfo info;
+  MGArray phi;
+  VectorField gravity;
+
+}; // MGGravityFunctor
+
+} // namespace ppkMHD
+
+#endif // POISSON_MULTIGRID_FUNCTORS_H_
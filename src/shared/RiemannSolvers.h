@@ -6,8 +6,9 @@
 
 #include <math.h>
 
-#include "HydroParams.h"
+#include "KernelParams.h"
 #include "HydroState.h"
+#include "EquationOfState.h"
 
 namespace ppkMHD
 {
@@ -21,9 +22,8 @@ template <class HydroState>
 KOKKOS_INLINE_FUNCTION
 void cmpflx(const HydroState& qgdnv,
             HydroState& flux,
-            const HydroParams& params)
+            const KernelParams& params)
 {
-  real_t gamma0 = params.settings.gamma0;
 
   // Compute fluxes
   // Mass density
@@ -39,14 +39,13 @@ void cmpflx(const HydroState& qgdnv,
     flux[IW] = flux[ID] * qgdnv[IW];
 
   // Total energy
-  real_t entho = ONE_F / (gamma0 - ONE_F);
   real_t ekin;
   ekin = HALF_F * qgdnv[ID] * (qgdnv[IU]*qgdnv[IU] +
                                qgdnv[IV]*qgdnv[IV]);
   if (std::is_same<HydroState,HydroState3d>::value)
     ekin += HALF_F * qgdnv[ID] * (qgdnv[IW]*qgdnv[IW]);
 
-  real_t etot = qgdnv[IP] * entho + ekin;
+  real_t etot = eos_internal_energy(params.settings, qgdnv[ID], qgdnv[IP]) + ekin;
   flux[IP] = qgdnv[IU] * (etot + qgdnv[IP]);
 
 } // cmpflx
@@ -66,7 +65,7 @@ void riemann_approx(const HydroState& qleft,
                     const HydroState& qright,
                     HydroState& qgdnv,
                     HydroState& flux,
-                    const HydroParams& params)
+                    const KernelParams& params)
 {
   real_t gamma0  = params.settings.gamma0;
   real_t gamma6  = params.settings.gamma6;
@@ -224,17 +223,15 @@ void riemann_llf(const HydroState& qleft,
                  const HydroState& qright,
                  HydroState& qgdnv,
                  HydroState& flux,
-                 const HydroParams& params)
+                 const KernelParams& params)
 {
 
   // 1D LLF Riemann solver
 
   // constants
-  real_t gamma0 = params.settings.gamma0;
   real_t smallr = params.settings.smallr;
   real_t smallp = params.settings.smallp;
 
-  const real_t entho = ONE_F / (gamma0 - ONE_F);
 
   //============================
   // Compute maximum wave speed
@@ -247,8 +244,8 @@ void riemann_llf(const HydroState& qleft,
   real_t ur=     qright[IU];
   real_t pr=FMAX(qright[IP],rr*smallp);
 
-  real_t cl= SQRT(gamma0*pl/rl);
-  real_t cr= SQRT(gamma0*pr/rr);
+  real_t cl= SQRT(eos_rho_c2(params.settings, rl, pl)/rl);
+  real_t cr= SQRT(eos_rho_c2(params.settings, rr, pr)/rr);
 
   real_t cmax = FMAX(FABS(ul)+cl,FABS(ur)+cr);
 
@@ -264,8 +261,8 @@ void riemann_llf(const HydroState& qleft,
   uright[ID] = qright[ID];
 
   // total energy
-  uleft [IP] = qleft [IP]*entho + HALF_F*qleft [ID]*qleft [IU]*qleft [IU];
-  uright[IP] = qright[IP]*entho + HALF_F*qright[ID]*qright[IU]*qright[IU];
+  uleft [IP] = eos_internal_energy(params.settings, qleft [ID], qleft [IP]) + HALF_F*qleft [ID]*qleft [IU]*qleft [IU];
+  uright[IP] = eos_internal_energy(params.settings, qright[ID], qright[IP]) + HALF_F*qright[ID]*qright[IU]*qright[IU];
 
   uleft [IP] += HALF_F*qleft [ID]*qleft [IV]*qleft [IV];
   uright[IP] += HALF_F*qright[ID]*qright[IV]*qright[IV];
@@ -350,19 +347,17 @@ void riemann_hll(const HydroState& qleft,
                  const HydroState& qright,
                  HydroState& qgdnv,
                  HydroState& flux,
-                 const HydroParams& params)
+                 const KernelParams& params)
 {
 
   // 1D HLL Riemann solver
 
   // constants
-  real_t gamma0 = params.settings.gamma0;
   real_t smallr = params.settings.smallr;
   real_t smallp = params.settings.smallp;
   //real_t smallc = params.settings.smallc;
 
   //const real_t smallp = smallc*smallc/gamma0;
-  const real_t entho = ONE_F / (gamma0 - ONE_F);
 
   // Maximum wave speed
   real_t rl=FMAX(qleft [ID],smallr);
@@ -373,8 +368,8 @@ void riemann_hll(const HydroState& qleft,
   real_t ur=     qright[IU];
   real_t pr=FMAX(qright[IP],rr*smallp);
 
-  real_t cl= SQRT(gamma0*pl/rl);
-  real_t cr= SQRT(gamma0*pr/rr);
+  real_t cl= SQRT(eos_rho_c2(params.settings, rl, pl)/rl);
+  real_t cr= SQRT(eos_rho_c2(params.settings, rr, pr)/rr);
 
   real_t SL = FMIN(FMIN(ul,ur)-FMAX(cl,cr),(real_t) ZERO_F);
   real_t SR = FMAX(FMAX(ul,ur)+FMAX(cl,cr),(real_t) ZERO_F);
@@ -386,8 +381,8 @@ void riemann_hll(const HydroState& qleft,
   HydroState uleft, uright;
   uleft [ID] = qleft [ID];
   uright[ID] = qright[ID];
-  uleft [IP] = qleft [IP]*entho + HALF_F*qleft [ID]*qleft [IU]*qleft [IU];
-  uright[IP] = qright[IP]*entho + HALF_F*qright[ID]*qright[IU]*qright[IU];
+  uleft [IP] = eos_internal_energy(params.settings, qleft [ID], qleft [IP]) + HALF_F*qleft [ID]*qleft [IU]*qleft [IU];
+  uright[IP] = eos_internal_energy(params.settings, qright[ID], qright[IP]) + HALF_F*qright[ID]*qright[IU]*qright[IU];
   uleft [IP] += HALF_F*qleft [ID]*qleft [IV]*qleft [IV];
   uright[IP] += HALF_F*qright[ID]*qright[IV]*qright[IV];
   if (std::is_same<HydroState,HydroState3d>::value)
@@ -453,16 +448,14 @@ void riemann_hllc(const HydroState& qleft,
                   const HydroState& qright,
                   HydroState& qgdnv,
                   HydroState& flux,
-                  const HydroParams& params)
+                  const KernelParams& params)
 {
   UNUSED(qgdnv);
 
-  real_t gamma0 = params.settings.gamma0;
   real_t smallr = params.settings.smallr;
   real_t smallp = params.settings.smallp;
   real_t smallc = params.settings.smallc;
 
-  const real_t entho = ONE_F / (gamma0 - ONE_F);
 
   // Left variables
   real_t rl = fmax(qleft[ID], smallr);
@@ -474,7 +467,7 @@ void riemann_hllc(const HydroState& qleft,
   if (std::is_same<HydroState,HydroState3d>::value)
     ecinl += HALF_F*rl*qleft[IW]*qleft[IW];
 
-  real_t etotl = pl*entho+ecinl;
+  real_t etotl = eos_internal_energy(params.settings, rl, pl)+ecinl;
   real_t ptotl = pl;
 
   // Right variables
@@ -487,12 +480,12 @@ void riemann_hllc(const HydroState& qleft,
   if (std::is_same<HydroState,HydroState3d>::value)
     ecinl += HALF_F*rr*qright[IW]*qright[IW];
 
-  real_t etotr = pr*entho+ecinr;
+  real_t etotr = eos_internal_energy(params.settings, rr, pr)+ecinr;
   real_t ptotr = pr;
 
   // Find the largest eigenvalues in the normal direction to the interface
-  real_t cfastl = SQRT(fmax(gamma0*pl/rl,smallc*smallc));
-  real_t cfastr = SQRT(fmax(gamma0*pr/rr,smallc*smallc));
+  real_t cfastl = SQRT(fmax(eos_rho_c2(params.settings, rl, pl)/rl,smallc*smallc));
+  real_t cfastr = SQRT(fmax(eos_rho_c2(params.settings, rr, pr)/rr,smallc*smallc));
 
   // Compute HLL wave speed
   real_t SL = fmin(ul,ur) - fmax(cfastl,cfastr);
@@ -580,7 +573,7 @@ void riemann_hydro(const HydroState2d& qleft,
                    const HydroState2d& qright,
                    HydroState2d& qgdnv,
                    HydroState2d& flux,
-                   const HydroParams& params)
+                   const KernelParams& params)
 {
 
   if        (params.riemannSolverType == RIEMANN_APPROX)
@@ -618,7 +611,7 @@ void riemann_hydro(const HydroState3d& qleft,
                    const HydroState3d& qright,
                    HydroState3d& qgdnv,
                    HydroState3d& flux,
-                   const HydroParams& params)
+                   const KernelParams& params)
 {
 
   if        (params.riemannSolverType == RIEMANN_APPROX)
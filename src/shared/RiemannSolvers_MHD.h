@@ -6,7 +6,7 @@
 
 #include <math.h>
 
-#include "HydroParams.h"
+#include "KernelParams.h"
 #include "HydroState.h"
 #include "mhd_utils.h"
 
@@ -29,7 +29,7 @@ KOKKOS_INLINE_FUNCTION
 void riemann_hll(MHDState &qleft,
                  MHDState &qright,
                  MHDState &flux,
-                 const HydroParams& params)
+                 const KernelParams& params)
 {
 
   // enforce continuity of normal component
@@ -90,7 +90,7 @@ KOKKOS_INLINE_FUNCTION
 void riemann_llf(MHDState &qleft,
                  MHDState &qright,
                  MHDState &flux,
-                 const HydroParams &params)
+                 const KernelParams &params)
 {
 
   // enforce continuity of normal component
@@ -143,7 +143,7 @@ KOKKOS_INLINE_FUNCTION
 void riemann_hlld(MHDState &qleft,
                   MHDState &qright,
                   MHDState &flux,
-                  const HydroParams& params)
+                  const KernelParams& params)
 {
 
   // Constants
@@ -378,7 +378,7 @@ KOKKOS_INLINE_FUNCTION
 void riemann_mhd(MHDState& qleft,
                  MHDState& qright,
                  MHDState& flux,
-                 const HydroParams& params)
+                 const KernelParams& params)
 {
   if (params.riemannSolverType == RIEMANN_HLLD)
   {
@@ -408,7 +408,7 @@ void riemann_mhd(MHDState& qleft,
 KOKKOS_INLINE_FUNCTION
 real_t mag_riemann2d_hlld(const MHDState (&qLLRR)[4],
                           real_t eLLRR[4],
-                          const HydroParams& params)
+                          const KernelParams& params)
 {
 
   // alias reference to input arrays
@@ -656,7 +656,7 @@ real_t mag_riemann2d_hlld(const MHDState (&qLLRR)[4],
 template <EmfDir emfDir>
 KOKKOS_INLINE_FUNCTION
 real_t compute_emf(MHDState (&qEdge)[4],
-                   const HydroParams& params,
+                   const KernelParams& params,
                    real_t xPos=0)
 {
 
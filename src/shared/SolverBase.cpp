@@ -1,7 +1,6 @@
 #include "SolverBase.h"
 
 #include "shared/utils.h"
-#include "shared/BoundariesFunctors.h"
 
 #ifdef USE_MPI
 #include "shared/mpiBorderUtils.h"
@@ -9,6 +8,10 @@
 #endif // USE_MPI
 
 #include "utils/io/IO_ReadWrite.h"
+#include "utils/io/IO_Products.h"
+#include "shared/Analysis.h"
+#include "shared/Telemetry.h"
+#include "shared/LoadBalance.h"
 
 namespace ppkMHD
 {
@@ -22,7 +25,10 @@ namespace ppkMHD
 SolverBase::SolverBase (HydroParams& params, ConfigMap& configMap) :
   params(params),
   configMap(configMap),
-  solver_type(SOLVER_UNDEFINED)
+  kernel_params(params),
+  solver_type(SOLVER_UNDEFINED),
+  m_workspace(configMap),
+  m_boundary_engine()
 {
 
   /*
@@ -34,6 +40,7 @@ SolverBase::SolverBase (HydroParams& params, ConfigMap& configMap) :
    * other variables initialization.
    */
   m_times_saved = 0;
+  m_output_mutex = nullptr;
   m_nCells = -1;
   m_nDofsPerCell = -1;
 
@@ -43,6 +50,15 @@ SolverBase::SolverBase (HydroParams& params, ConfigMap& configMap) :
   timers[TIMER_DT]         = std::make_shared<Timer>();
   timers[TIMER_BOUNDARIES] = std::make_shared<Timer>();
   timers[TIMER_NUM_SCHEME] = std::make_shared<Timer>();
+  timers[TIMER_GRAVITY]    = std::make_shared<Timer>();
+  timers[TIMER_BOUNDARIES_WAIT] = std::make_shared<Timer>();
+
+  // ghost cells list (solvers with problem specific border conditions
+  // rebuild it with their own faces)
+  m_boundary_engine.init(params, GhostFaces::from_params(params));
+
+  // in-situ diagnostics
+  m_diagnostics = std::make_shared<Diagnostics>(params, configMap);
 
   // init variables names
   m_variables_names[ID] = "rho";
@@ -54,6 +70,18 @@ SolverBase::SolverBase (HydroParams& params, ConfigMap& configMap) :
   m_variables_names[IB] = "by"; // mag field Y
   m_variables_names[IC] = "bz"; // mag field Z
 
+  // reduced-volume outputs
+  m_io_products = std::make_shared<io::IO_Products>(params, configMap, m_variables_names);
+
+  // in-situ analysis plugins
+  m_analysis = std::make_shared<AnalysisManager>(params, configMap);
+
+  // live telemetry
+  m_telemetry = std::make_shared<Telemetry>(params, configMap);
+
+  // load imbalance monitoring
+  m_load_balance = std::make_shared<LoadBalance>(params, configMap);
+
   // init io reader/writer is/should/must be called outside of constructor
   // right now we moved that in SolverFactory's method create
   //init_io();
@@ -133,15 +161,15 @@ SolverBase::read_config()
 
   /*
    * Gravity enabled (either static or point source or self-gravity).
-   * self-gravity requires a poisson solver (FFT-based): TODO
+   * self-gravity requires a poisson solver (see PoissonMultigrid.h).
    */
   m_static_gravity_enabled = configMap.getBool("gravity", "static", false);
   m_point_gravity_enabled = configMap.getBool("gravity", "point", false);
-  //selfGravityEnabled = configMap.getBool("gravity", "self", false);
+  m_self_gravity_enabled = configMap.getBool("gravity", "self", false);
   m_gravity_enabled =
     m_static_gravity_enabled or
-    m_point_gravity_enabled;
-  // || m_self_gravity_enabled;
+    m_point_gravity_enabled or
+    m_self_gravity_enabled;
 
 } // SolverBase::read_config
 
@@ -161,7 +189,8 @@ SolverBase::compute_dt()
 
   // perform MPI_Reduceall to get global time step
   double dt_global;
-  params.communicator->allReduce(&dt_local, &dt_global, 1, params.data_type, hydroSimu::MpiComm::MIN);
+  // dt is always a double, whatever the data arrays precision
+  params.communicator->allReduce(&dt_local, &dt_global, 1, hydroSimu::MpiComm::DOUBLE, hydroSimu::MpiComm::MIN);
 
   m_dt = dt_global;
 
@@ -177,6 +206,9 @@ SolverBase::compute_dt()
     m_dt = m_tEnd - m_t;
   }
 
+  // write diagnostics if they were computed along with dt
+  m_diagnostics->write(m_iteration, m_t, m_dt);
+
 } // SolverBase::compute_dt
 
 // =======================================================
@@ -207,17 +239,24 @@ void
 SolverBase::next_iteration()
 {
 
-  // setup a timer here (?)
+  // kernel parameters, once per time step
+  kernel_params = KernelParams(params);
 
   // genuine implementation called here
   next_iteration_impl();
 
-  // perform some stats here (?)
-
   // incremenent
   ++m_iteration;
   m_t += m_dt;
 
+  // per process compute time (collective every nstep)
+  if (m_load_balance->enabled())
+    m_load_balance->update(*this);
+
+  // live telemetry (collective)
+  if (m_telemetry->is_due(m_iteration))
+    m_telemetry->report(*this);
+
 } // SolverBase::next_iteration
 
 // =======================================================
@@ -236,6 +275,10 @@ void
 SolverBase::save_solution()
 {
 
+  std::unique_lock<std::mutex> lock;
+  if (m_output_mutex)
+    lock = std::unique_lock<std::mutex>(*m_output_mutex);
+
   // save solution to output file
   save_solution_impl();
 
@@ -244,6 +287,17 @@ SolverBase::save_solution()
 
 } // SolverBase::save_solution
 
+// =======================================================
+// =======================================================
+void
+SolverBase::set_output_mutex(std::mutex* mutex)
+{
+
+  m_output_mutex = mutex;
+  m_io_products->set_mutex(mutex);
+
+} // SolverBase::set_output_mutex
+
 // =======================================================
 // =======================================================
 void
@@ -347,221 +401,15 @@ SolverBase::load_data(DataArray3d             U,
   m_io_reader_writer->load_data(U, Uh, iStep, time);
 }
 
-// =======================================================
-// =======================================================
-void
-SolverBase::make_boundary(DataArray2d Udata, FaceIdType faceId, bool mhd_enabled)
-{
-
-  const int ghostWidth=params.ghostWidth;
-  int nbIter = ghostWidth*std::max(params.isize,params.jsize);
-
-  if (faceId == FACE_XMIN)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor2D_MHD<FACE_XMIN>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor2D<FACE_XMIN>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_XMAX)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor2D_MHD<FACE_XMAX>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor2D<FACE_XMAX>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_YMIN)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor2D_MHD<FACE_YMIN>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor2D<FACE_YMIN>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_YMAX)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor2D_MHD<FACE_YMAX>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor2D<FACE_YMAX>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-} // SolverBase::make_boundary - 2d
-
-// =======================================================
-// =======================================================
-void
-SolverBase::make_boundary(DataArray3d Udata, FaceIdType faceId, bool mhd_enabled)
-{
-
-  const int ghostWidth=params.ghostWidth;
-
-  int max_size = std::max(params.isize,params.jsize);
-  max_size = std::max(max_size,params.ksize);
-  int nbIter = ghostWidth * max_size * max_size;
-
-  if (faceId == FACE_XMIN)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor3D_MHD<FACE_XMIN>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor3D<FACE_XMIN>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_XMAX)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor3D_MHD<FACE_XMAX>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor3D<FACE_XMAX>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_YMIN)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor3D_MHD<FACE_YMIN>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor3D<FACE_YMIN>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_YMAX)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor3D_MHD<FACE_YMAX>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor3D<FACE_YMAX>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_ZMIN)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor3D_MHD<FACE_ZMIN>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor3D<FACE_ZMIN>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-  if (faceId == FACE_ZMAX)
-  {
-
-    if (mhd_enabled)
-    {
-
-      MakeBoundariesFunctor3D_MHD<FACE_ZMAX>::apply(params, Udata, nbIter);
-
-    }
-    else
-    {
-
-      MakeBoundariesFunctor3D<FACE_ZMAX>::apply(params, Udata, nbIter);
-
-    }
-
-  }
-
-} // SolverBase::make_boundary - 3d
-
 // =======================================================
 // =======================================================
 void
 SolverBase::make_boundaries_serial(DataArray2d Udata, bool mhd_enabled)
 {
 
-  make_boundary(Udata, FACE_XMIN, mhd_enabled);
-  make_boundary(Udata, FACE_XMAX, mhd_enabled);
-  make_boundary(Udata, FACE_YMIN, mhd_enabled);
-  make_boundary(Udata, FACE_YMAX, mhd_enabled);
+  // all faces at once
+  FillGhostCellsFunctor<2>::apply(kernel_params, m_boundary_engine, m_boundary_engine.all(),
+                                  Udata, mhd_enabled);
 
 } // SolverBase::make_boundaries_serial - 2d
 
@@ -571,12 +419,9 @@ void
 SolverBase::make_boundaries_serial(DataArray3d Udata, bool mhd_enabled)
 {
 
-  make_boundary(Udata, FACE_XMIN, mhd_enabled);
-  make_boundary(Udata, FACE_XMAX, mhd_enabled);
-  make_boundary(Udata, FACE_YMIN, mhd_enabled);
-  make_boundary(Udata, FACE_YMAX, mhd_enabled);
-  make_boundary(Udata, FACE_ZMIN, mhd_enabled);
-  make_boundary(Udata, FACE_ZMAX, mhd_enabled);
+  // all faces at once
+  FillGhostCellsFunctor<3>::apply(kernel_params, m_boundary_engine, m_boundary_engine.all(),
+                                  Udata, mhd_enabled);
 
 } // SolverBase::make_boundaries_serial - 3d
 
@@ -592,7 +437,8 @@ SolverBase::make_boundaries_mpi(DataArray2d Udata, bool mhd_enabled)
   // for each direction:
   // 1. copy boundary to MPI buffer
   // 2. send/recv buffer
-  // 3. test if BC is BC_PERIODIC / BC_COPY then ... else ..
+  // 3. test if BC is BC_PERIODIC / BC_COPY then copy back
+  // 4. fill the ghost cells of this direction set by border conditions
 
   // ======
   // XDIR
@@ -605,20 +451,16 @@ SolverBase::make_boundaries_mpi(DataArray2d Udata, bool mhd_enabled)
   {
     copy_boundaries_back(Udata, XMIN);
   }
-  else
-  {
-    make_boundary(Udata, FACE_XMIN, mhd_enabled);
-  }
 
   if (params.neighborsBC[X_MAX] == BC_COPY ||
       params.neighborsBC[X_MAX] == BC_PERIODIC)
   {
     copy_boundaries_back(Udata, XMAX);
   }
-  else
-  {
-    make_boundary(Udata, FACE_XMAX, mhd_enabled);
-  }
+
+  // faces of this direction filled by border conditions
+  FillGhostCellsFunctor<2>::apply(kernel_params, m_boundary_engine, m_boundary_engine.direction(IX),
+                                  Udata, mhd_enabled);
 
   params.communicator->synchronize();
 
@@ -633,20 +475,16 @@ SolverBase::make_boundaries_mpi(DataArray2d Udata, bool mhd_enabled)
   {
     copy_boundaries_back(Udata, YMIN);
   }
-  else
-  {
-    make_boundary(Udata, FACE_YMIN, mhd_enabled);
-  }
 
   if (params.neighborsBC[Y_MAX] == BC_COPY ||
       params.neighborsBC[Y_MAX] == BC_PERIODIC)
   {
     copy_boundaries_back(Udata, YMAX);
   }
-  else
-  {
-    make_boundary(Udata, FACE_YMAX, mhd_enabled);
-  }
+
+  // faces of this direction filled by border conditions
+  FillGhostCellsFunctor<2>::apply(kernel_params, m_boundary_engine, m_boundary_engine.direction(IY),
+                                  Udata, mhd_enabled);
 
   params.communicator->synchronize();
 
@@ -671,20 +509,16 @@ SolverBase::make_boundaries_mpi(DataArray3d Udata, bool mhd_enabled)
   {
     copy_boundaries_back(Udata, XMIN);
   }
-  else
-  {
-    make_boundary(Udata, FACE_XMIN, mhd_enabled);
-  }
 
   if (params.neighborsBC[X_MAX] == BC_COPY ||
       params.neighborsBC[X_MAX] == BC_PERIODIC)
   {
     copy_boundaries_back(Udata, XMAX);
   }
-  else
-  {
-    make_boundary(Udata, FACE_XMAX, mhd_enabled);
-  }
+
+  // faces of this direction filled by border conditions
+  FillGhostCellsFunctor<3>::apply(kernel_params, m_boundary_engine, m_boundary_engine.direction(IX),
+                                  Udata, mhd_enabled);
 
   params.communicator->synchronize();
 
@@ -699,20 +533,16 @@ SolverBase::make_boundaries_mpi(DataArray3d Udata, bool mhd_enabled)
   {
     copy_boundaries_back(Udata, YMIN);
   }
-  else
-  {
-    make_boundary(Udata, FACE_YMIN, mhd_enabled);
-  }
 
   if (params.neighborsBC[Y_MAX] == BC_COPY ||
       params.neighborsBC[Y_MAX] == BC_PERIODIC)
   {
     copy_boundaries_back(Udata, YMAX);
   }
-  else
-  {
-    make_boundary(Udata, FACE_YMAX, mhd_enabled);
-  }
+
+  // faces of this direction filled by border conditions
+  FillGhostCellsFunctor<3>::apply(kernel_params, m_boundary_engine, m_boundary_engine.direction(IY),
+                                  Udata, mhd_enabled);
 
   params.communicator->synchronize();
 
@@ -727,20 +557,16 @@ SolverBase::make_boundaries_mpi(DataArray3d Udata, bool mhd_enabled)
   {
     copy_boundaries_back(Udata, ZMIN);
   }
-  else
-  {
-    make_boundary(Udata, FACE_ZMIN, mhd_enabled);
-  }
 
   if (params.neighborsBC[Z_MAX] == BC_COPY ||
       params.neighborsBC[Z_MAX] == BC_PERIODIC)
   {
     copy_boundaries_back(Udata, ZMAX);
   }
-  else
-  {
-    make_boundary(Udata, FACE_ZMAX, mhd_enabled);
-  }
+
+  // faces of this direction filled by border conditions
+  FillGhostCellsFunctor<3>::apply(kernel_params, m_boundary_engine, m_boundary_engine.direction(IZ),
+                                  Udata, mhd_enabled);
 
   params.communicator->synchronize();
 
@@ -833,6 +659,9 @@ SolverBase::transfert_boundaries_2d(Direction dir)
 
   const int data_type = params.data_type;
 
+  Kokkos::Profiling::pushRegion("halo_exchange");
+  timers[TIMER_BOUNDARIES_WAIT]->start();
+
   using namespace hydroSimu;
 
   /*
@@ -877,6 +706,9 @@ SolverBase::transfert_boundaries_2d(Direction dir)
                                   data_type, params.neighborsRank[Y_MIN], 211);
   }
 
+  timers[TIMER_BOUNDARIES_WAIT]->stop();
+  Kokkos::Profiling::popRegion();
+
 } // SolverBase::transfert_boundaries_2d
 
 // =======================================================
@@ -887,6 +719,9 @@ SolverBase::transfert_boundaries_3d(Direction dir)
 
   const int data_type = params.data_type;
 
+  Kokkos::Profiling::pushRegion("halo_exchange");
+  timers[TIMER_BOUNDARIES_WAIT]->start();
+
   using namespace hydroSimu;
 
   if (dir == XDIR)
@@ -944,6 +779,9 @@ SolverBase::transfert_boundaries_3d(Direction dir)
 
   }
 
+  timers[TIMER_BOUNDARIES_WAIT]->stop();
+  Kokkos::Profiling::popRegion();
+
 } // SolverBase::transfert_boundaries_3d
 
 // =======================================================
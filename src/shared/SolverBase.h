@@ -2,11 +2,16 @@
 #define SOLVER_BASE_H_
 
 #include "shared/HydroParams.h"
+#include "shared/KernelParams.h"
 #include "utils/config/ConfigMap.h"
 #include "shared/kokkos_shared.h"
+#include "shared/Diagnostics.h"
+#include "shared/Workspace.h"
+#include "shared/BoundaryEngine.h"
 
 #include <map>
 #include <memory> // for std::unique_ptr / std::shared_ptr
+#include <mutex>
 
 // for timer
 #ifdef KOKKOS_ENABLE_CUDA
@@ -29,6 +34,7 @@ namespace ppkMHD
 namespace io
 {
 class IO_ReadWriteBase;
+class IO_Products;
 }
 }
 
@@ -38,12 +44,18 @@ enum TimerIds
   TIMER_IO = 1,
   TIMER_DT = 2,
   TIMER_BOUNDARIES = 3,
-  TIMER_NUM_SCHEME = 4
+  TIMER_NUM_SCHEME = 4,
+  TIMER_GRAVITY = 5,
+  TIMER_BOUNDARIES_WAIT = 6 /*!< MPI border exchange only (part of TIMER_BOUNDARIES) */
 }; // enum TimerIds
 
 namespace ppkMHD
 {
 
+class AnalysisManager;
+class Telemetry;
+class LoadBalance;
+
 /**
  * Abstract base class for all our actual solvers.
  */
@@ -59,6 +71,10 @@ public:
   HydroParams& params;
   ConfigMap& configMap;
 
+  //! device side subset of params, passed to all functors; rebuilt once
+  //! per time step by next_iteration
+  KernelParams kernel_params;
+
   /* some common member data */
   solver_type_t solver_type;
 
@@ -88,6 +104,7 @@ public:
   //! gravity enabled ?
   bool                 m_static_gravity_enabled;
   bool                 m_point_gravity_enabled;
+  bool                 m_self_gravity_enabled;
   bool                 m_gravity_enabled;
 
   /*
@@ -124,6 +141,13 @@ public:
   //! main routine to dump solution to file
   virtual void save_solution_impl();
 
+  /**
+   * Lock held while writing solution outputs and reduced-volume products,
+   * shared by the ensemble members advanced concurrently (see Ensemble);
+   * nullptr (the default) means no locking.
+   */
+  void set_output_mutex(std::mutex* mutex);
+
   //! read restart data
   virtual void read_restart_file();
 
@@ -132,12 +156,36 @@ public:
   //! counter incremented each time an output is written
   int m_times_saved;
 
+  //! see set_output_mutex
+  std::mutex* m_output_mutex;
+
   //! Number of variables to saved
   //int m_write_variables_number;
 
   //! names of variables to save
   std::map<int, std::string> m_variables_names;
 
+  //! in-situ global diagnostics (time series), see Diagnostics.h
+  std::shared_ptr<Diagnostics> m_diagnostics;
+
+  //! pooled transient work arrays, see Workspace.h
+  Workspace m_workspace;
+
+  //! ghost cells filled by border conditions, see BoundaryEngine.h
+  BoundaryEngine m_boundary_engine;
+
+  //! reduced-volume outputs (slices, subvolumes), see IO_Products.h
+  std::shared_ptr<io::IO_Products> m_io_products;
+
+  //! in-situ analysis plugins (PDFs, spectra, user callbacks), see Analysis.h
+  std::shared_ptr<AnalysisManager> m_analysis;
+
+  //! live run telemetry stream (JSON lines), see Telemetry.h
+  std::shared_ptr<Telemetry> m_telemetry;
+
+  //! load imbalance monitoring of the MPI decomposition, see LoadBalance.h
+  std::shared_ptr<LoadBalance> m_load_balance;
+
   //! timers
 #ifdef KOKKOS_ENABLE_CUDA
   using Timer = CudaTimer;
@@ -184,9 +232,6 @@ public:
                  real_t& time);
 
 
-  virtual void make_boundary(DataArray2d Udata, FaceIdType faceId, bool mhd_enabled);
-  virtual void make_boundary(DataArray3d Udata, FaceIdType faceId, bool mhd_enabled);
-
   virtual void make_boundaries_serial(DataArray2d Udata, bool mhd_enabled);
   virtual void make_boundaries_serial(DataArray3d Udata, bool mhd_enabled);
 
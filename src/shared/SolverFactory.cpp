@@ -4,6 +4,7 @@
 
 #include "muscl/SolverHydroMuscl.h"
 #include "muscl/SolverMHDMuscl.h"
+#include "muscl/SolverHydroMusclAMR2D.h"
 
 #ifdef USE_SDM
 #include "sdm/SolverHydroSDM.h"
@@ -25,6 +26,8 @@ SolverFactory::SolverFactory()
   registerSolver("Hydro_Muscl_2D", &muscl::SolverHydroMuscl<2>::create);
   registerSolver("Hydro_Muscl_3D", &muscl::SolverHydroMuscl<3>::create);
 
+  registerSolver("Hydro_Muscl_AMR_2D", &muscl::SolverHydroMusclAMR2D::create);
+
   registerSolver("MHD_Muscl_2D",   &muscl::SolverMHDMuscl<2>::create);
   registerSolver("MHD_Muscl_3D",   &muscl::SolverMHDMuscl<3>::create);
 
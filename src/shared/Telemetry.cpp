@@ -0,0 +1,261 @@
+#include "shared/Telemetry.h"
+#include "shared/SolverBase.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <sys/resource.h> // for getrusage
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef KOKKOS_ENABLE_CUDA
+#include <cuda_runtime.h>
+#endif // KOKKOS_ENABLE_CUDA
+
+#ifdef USE_MPI
+#include "utils/mpiUtils/MpiCommCart.h"
+#endif // USE_MPI
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== CLASS Telemetry IMPL =============================
+// =======================================================
+
+// =======================================================
+// =======================================================
+Telemetry::Telemetry(HydroParams& params, ConfigMap& configMap) :
+  params(params),
+  m_enabled(false),
+  m_nstep(1),
+  m_file(nullptr),
+  m_socket_path(),
+  m_socket(-1),
+  m_wall_start(std::chrono::steady_clock::now()),
+  m_last_wall(0.0),
+  m_last_iteration(0),
+  m_last_boundary_wait(0.0),
+  m_device_hwm(0.0)
+{
+
+  m_enabled = configMap.getBool("telemetry", "enabled", false);
+
+  if (!m_enabled)
+    return;
+
+  m_nstep = configMap.getInteger("telemetry", "nstep",
+                                 configMap.getInteger("run", "nlog", 10));
+  if (m_nstep < 1)
+    m_nstep = 1;
+
+  int myRank = 0;
+#ifdef USE_MPI
+  myRank = params.myRank;
+#endif // USE_MPI
+
+  // only rank 0 writes
+  if (myRank != 0)
+    return;
+
+  std::string outputDir    = configMap.getString("output", "outputDir", "./");
+  std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+  std::string output = configMap.getString("telemetry", "output",
+                                           outputDir + "/" + outputPrefix + "_telemetry.jsonl");
+
+  if (output.compare(0, 5, "unix:") == 0)
+  {
+    m_socket_path = output.substr(5);
+  }
+  else
+  {
+    // a restart run appends to the existing stream
+    const bool restart = configMap.getInteger("run", "restart_enabled", 0) != 0;
+
+    m_file = fopen(output.c_str(), restart ? "a" : "w");
+
+    if (m_file == nullptr)
+      std::cerr << "Telemetry: unable to open " << output << ", no telemetry written\n";
+  }
+
+} // Telemetry::Telemetry
+
+// =======================================================
+// =======================================================
+Telemetry::~Telemetry()
+{
+
+  if (m_file)
+    fclose(m_file);
+
+  if (m_socket >= 0)
+    close(m_socket);
+
+} // Telemetry::~Telemetry
+
+// =======================================================
+// =======================================================
+void
+Telemetry::report(const SolverBase& solver)
+{
+
+  const double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                    m_wall_start).count();
+
+  const SolverBase::TimerMap& timers = solver.timers;
+
+  /*
+   * local values: boundary wait time since the last record, memory
+   */
+  const double boundary_wait = timers.at(TIMER_BOUNDARIES_WAIT)->elapsed();
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+#ifdef KOKKOS_ENABLE_CUDA
+  size_t mem_free, mem_total;
+  if (cudaMemGetInfo(&mem_free, &mem_total) == cudaSuccess)
+    m_device_hwm = std::max(m_device_hwm, (double) (mem_total - mem_free));
+#endif // KOKKOS_ENABLE_CUDA
+
+  enum { WAIT = 0, MEM_HOST, MEM_DEVICE, NB_VALUES };
+
+  double local[NB_VALUES];
+  local[WAIT]       = boundary_wait - m_last_boundary_wait;
+  local[MEM_HOST]   = usage.ru_maxrss * 1024.0; // kilobytes on Linux
+  local[MEM_DEVICE] = m_device_hwm;
+
+  m_last_boundary_wait = boundary_wait;
+
+  /*
+   * gather over all MPI processes (a single collective)
+   */
+  int nProcs = 1;
+#ifdef USE_MPI
+  nProcs = params.nProcs;
+#endif // USE_MPI
+
+  std::vector<double> all(nProcs*NB_VALUES);
+
+#ifdef USE_MPI
+  params.communicator->allGather(local, NB_VALUES, hydroSimu::MpiComm::DOUBLE,
+                                 all.data(), NB_VALUES, hydroSimu::MpiComm::DOUBLE);
+#else
+  for (int v = 0; v < NB_VALUES; ++v)
+    all[v] = local[v];
+#endif // USE_MPI
+
+  double wait_min = all[WAIT], wait_max = all[WAIT], wait_sum = 0;
+  double mem_host = 0, mem_device = 0;
+  for (int p = 0; p < nProcs; ++p)
+  {
+    const double* values = &all[p*NB_VALUES];
+    wait_min   = std::min(wait_min, values[WAIT]);
+    wait_max   = std::max(wait_max, values[WAIT]);
+    wait_sum  += values[WAIT];
+    mem_host   = std::max(mem_host,   values[MEM_HOST]);
+    mem_device = std::max(mem_device, values[MEM_DEVICE]);
+  }
+
+  // performance over the last records interval
+  const int    iterations = solver.m_iteration - m_last_iteration;
+  const double interval   = wall - m_last_wall;
+  const double mcell_rate = interval > 0 ?
+    1e-6 * iterations * solver.m_nCells * nProcs / interval : 0.0;
+
+  m_last_iteration = solver.m_iteration;
+  m_last_wall      = wall;
+
+  if (m_file == nullptr and m_socket_path.empty())
+    return;
+
+  /*
+   * build and emit the record (rank 0)
+   */
+  char buffer[1024];
+  int n = snprintf(buffer, sizeof(buffer),
+                   "{\"iteration\":%d,\"time\":%.10e,\"dt\":%.10e,\"wall_time\":%.3f,"
+                   "\"timers\":{\"godunov\":%.3f,\"compute_dt\":%.3f,\"boundaries\":%.3f,"
+                   "\"boundaries_wait\":%.3f,\"io\":%.3f,\"gravity\":%.3f},"
+                   "\"mcell_updates_per_s\":%.4f,"
+                   "\"mem_host_hwm_mb\":%.1f,\"mem_device_hwm_mb\":%.1f,"
+                   "\"boundary_wait\":{\"min\":%.6f,\"max\":%.6f,\"mean\":%.6f},"
+                   "\"nprocs\":%d}\n",
+                   solver.m_iteration, solver.m_t, solver.m_dt, wall,
+                   timers.at(TIMER_NUM_SCHEME)->elapsed(),
+                   timers.at(TIMER_DT)->elapsed(),
+                   timers.at(TIMER_BOUNDARIES)->elapsed(),
+                   boundary_wait,
+                   timers.at(TIMER_IO)->elapsed(),
+                   timers.at(TIMER_GRAVITY)->elapsed(),
+                   mcell_rate,
+                   mem_host / (1024.0*1024.0), mem_device / (1024.0*1024.0),
+                   wait_min, wait_max, wait_sum / nProcs,
+                   nProcs);
+
+  if (n < 0 or n >= (int) sizeof(buffer))
+    return;
+
+  if (m_file)
+  {
+    fputs(buffer, m_file);
+    // keep the stream readable while the run is going on
+    fflush(m_file);
+  }
+  else
+  {
+    send_line(buffer);
+  }
+
+} // Telemetry::report
+
+// =======================================================
+// =======================================================
+void
+Telemetry::send_line(const std::string& line)
+{
+
+  if (m_socket < 0)
+  {
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+
+    if (m_socket_path.size() >= sizeof(address.sun_path))
+      return;
+
+    m_socket_path.copy(address.sun_path, m_socket_path.size());
+
+    m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return;
+
+    // no listener (yet): drop this record, retry at the next one
+    if (connect(m_socket, (sockaddr*) &address, sizeof(address)) != 0)
+    {
+      close(m_socket);
+      m_socket = -1;
+      return;
+    }
+
+  }
+
+  size_t sent = 0;
+  while (sent < line.size())
+  {
+    // MSG_NOSIGNAL: a listener going away must not kill the run (SIGPIPE)
+    const ssize_t n = send(m_socket, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0)
+    {
+      close(m_socket);
+      m_socket = -1;
+      return;
+    }
+    sent += n;
+  }
+
+} // Telemetry::send_line
+
+} // namespace ppkMHD
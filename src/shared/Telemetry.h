@@ -0,0 +1,95 @@
+/**
+ * \file Telemetry.h
+ * \brief Live run telemetry: a JSON-lines stream of progress, timings,
+ * performance, memory and load balance, written while the run is going on.
+ */
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "shared/HydroParams.h"
+#include "utils/config/ConfigMap.h"
+
+namespace ppkMHD
+{
+
+class SolverBase;
+
+/**
+ * Live telemetry stream, owned by SolverBase (m_telemetry) and fed by
+ * SolverBase::next_iteration, hence available for all solvers.
+ *
+ * Parameters read in section [telemetry]:
+ * - enabled (default false)
+ * - nstep: number of time steps between two records (default [run] nlog)
+ * - output: file name (default outputDir/outputPrefix_telemetry.jsonl),
+ *   or unix:<path> to send records to a local Unix domain socket (stream
+ *   socket, created by the monitoring process; when it is not there or
+ *   goes away, records are dropped and connection is retried at the next
+ *   record)
+ *
+ * One JSON object per line, with:
+ * - iteration, time, dt, wall_time (seconds since the solver creation)
+ * - timers: cumulative per-phase timers of rank 0 (see TimerIds)
+ * - mcell_updates_per_s: rate over the last nstep iterations, all
+ *   processes included
+ * - mem_host_hwm_mb: host resident memory high-water mark (max over
+ *   processes); mem_device_hwm_mb: device memory in use, highest value
+ *   sampled at records (max over processes, cuda only)
+ * - boundary_wait: min/max/mean over processes of the time spent
+ *   waiting in the MPI border exchange during the last nstep iterations
+ *
+ * A record is a collective operation: every MPI process must call report.
+ */
+class Telemetry
+{
+
+public:
+  Telemetry(HydroParams& params, ConfigMap& configMap);
+  ~Telemetry();
+
+  //! is telemetry enabled at all ?
+  bool enabled() const { return m_enabled; }
+
+  //! should a record be written at this iteration ?
+  bool is_due(int iteration) const
+  {
+    return m_enabled and (iteration % m_nstep == 0);
+  }
+
+  //! gather values over all MPI processes and emit a record (rank 0)
+  void report(const SolverBase& solver);
+
+private:
+  HydroParams& params;
+
+  bool m_enabled;
+  int  m_nstep;
+
+  //! file output (rank 0 only)
+  FILE* m_file;
+
+  //! socket output (rank 0 only), -1 when not connected
+  std::string m_socket_path;
+  int         m_socket;
+
+  //! wall clock origin, and state at the previous record
+  std::chrono::steady_clock::time_point m_wall_start;
+  double m_last_wall;
+  int    m_last_iteration;
+  double m_last_boundary_wait;
+
+  //! highest device memory usage sampled so far (bytes)
+  double m_device_hwm;
+
+  //! send one line to the socket, (re)connecting if needed
+  void send_line(const std::string& line);
+
+}; // class Telemetry
+
+} // namespace ppkMHD
+
+#endif // TELEMETRY_H_
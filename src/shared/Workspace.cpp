@@ -0,0 +1,177 @@
+#include "shared/Workspace.h"
+#include "shared/FirstTouch.h"
+
+#include "utils/config/ConfigMap.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace ppkMHD
+{
+
+// =======================================================
+// ==== CLASS Workspace IMPL =============================
+// =======================================================
+
+// =======================================================
+// =======================================================
+Workspace::Workspace(ConfigMap& configMap) :
+  m_aliasing_enabled(true),
+  m_buffers(),
+  m_pool()
+{
+
+  m_aliasing_enabled = configMap.getBool("run", "workspace_aliasing", true);
+
+} // Workspace::Workspace
+
+// =======================================================
+// =======================================================
+void
+Workspace::allocate(int nbCells)
+{
+
+  // placement order: largest buffers first
+  std::vector<int> order(m_buffers.size());
+  for (size_t ib = 0; ib < m_buffers.size(); ++ib)
+    order[ib] = ib;
+
+  std::stable_sort(order.begin(), order.end(),
+                   [this](int a, int b) { return m_buffers[a].bytes > m_buffers[b].bytes; });
+
+  size_t pool_size = 0;
+  std::vector<int> placed;
+
+  for (int ib : order)
+  {
+    Buffer& buffer = m_buffers[ib];
+
+    const size_t size = (buffer.bytes + alignment - 1) / alignment * alignment;
+
+    // buffers already placed which can't share memory with this one,
+    // sorted by offset
+    std::vector<int> conflicts;
+    for (int jb : placed)
+    {
+      const Buffer& other = m_buffers[jb];
+
+      if (!m_aliasing_enabled or
+          (other.first_phase <= buffer.last_phase and
+           buffer.first_phase <= other.last_phase))
+        conflicts.push_back(jb);
+    }
+
+    std::sort(conflicts.begin(), conflicts.end(),
+              [this](int a, int b) { return m_buffers[a].offset < m_buffers[b].offset; });
+
+    // lowest offset in a gap between conflicting buffers
+    size_t offset = 0;
+    for (int jb : conflicts)
+    {
+      const Buffer& other = m_buffers[jb];
+      const size_t other_size = (other.bytes + alignment - 1) / alignment * alignment;
+
+      if (offset + size <= other.offset)
+        break;
+
+      offset = std::max(offset, other.offset + other_size);
+    }
+
+    buffer.offset = offset;
+    pool_size = std::max(pool_size, offset + size);
+
+    placed.push_back(ib);
+  }
+
+  // buffers sharing memory
+  for (Buffer& buffer : m_buffers)
+  {
+    for (const Buffer& other : m_buffers)
+    {
+      if (&other != &buffer and
+          other.offset < buffer.offset + buffer.bytes and
+          buffer.offset < other.offset + other.bytes)
+        buffer.aliased = true;
+    }
+  }
+
+  m_pool = Kokkos::View<double*, Device>(Kokkos::view_alloc(Kokkos::WithoutInitializing, "workspace"),
+                                         pool_size / sizeof(double));
+
+  // first touch buffer after buffer, so that each buffer is touched with
+  // the cell pattern of the kernels using it
+  for (const Buffer& buffer : m_buffers)
+  {
+    const size_t begin = buffer.offset / sizeof(double);
+    const size_t end   = (buffer.offset + buffer.bytes + sizeof(double) - 1) / sizeof(double);
+
+    auto data = Kokkos::subview(m_pool, std::make_pair(begin, end));
+    FirstTouchFunctor<decltype(data)>::apply(data, nbCells);
+  }
+
+  char* base = reinterpret_cast<char*>(m_pool.data());
+  for (Buffer& buffer : m_buffers)
+    buffer.bind(base + buffer.offset);
+
+} // Workspace::allocate
+
+// =======================================================
+// =======================================================
+void
+Workspace::begin_phase(int phase)
+{
+
+  for (const Buffer& buffer : m_buffers)
+  {
+    if (buffer.aliased and buffer.first_phase == phase)
+    {
+      const size_t begin = buffer.offset / sizeof(double);
+      const size_t end   = (buffer.offset + buffer.bytes + sizeof(double) - 1) / sizeof(double);
+
+      Kokkos::deep_copy(Kokkos::subview(m_pool, std::make_pair(begin, end)), 0.0);
+    }
+  }
+
+} // Workspace::begin_phase
+
+// =======================================================
+// =======================================================
+size_t
+Workspace::requested_size() const
+{
+
+  size_t size = 0;
+  for (const Buffer& buffer : m_buffers)
+    size += buffer.bytes;
+
+  return size;
+
+} // Workspace::requested_size
+
+// =======================================================
+// =======================================================
+void
+Workspace::print_info() const
+{
+
+  if (m_buffers.empty())
+    return;
+
+  printf("Workspace : %d buffers, requested %.3f MBytes, allocated %.3f MBytes (aliasing %s)\n",
+         (int) m_buffers.size(),
+         requested_size() / 1e6,
+         allocated_size() / 1e6,
+         m_aliasing_enabled ? "enabled" : "disabled");
+
+  for (const Buffer& buffer : m_buffers)
+    printf("  %-12s %10.3f MBytes  offset %10.3f MBytes  phases [%d,%d]%s\n",
+           buffer.label.c_str(),
+           buffer.bytes / 1e6,
+           buffer.offset / 1e6,
+           buffer.first_phase,
+           buffer.last_phase,
+           buffer.aliased ? "  (aliased)" : "");
+
+} // Workspace::print_info
+
+} // namespace ppkMHD
@@ -0,0 +1,125 @@
+/**
+ * \file Workspace.h
+ * \brief Pooled allocation of transient solver work arrays, with aliasing
+ * of arrays which are never live at the same time.
+ */
+#ifndef WORKSPACE_H_
+#define WORKSPACE_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "shared/kokkos_shared.h"
+
+class ConfigMap;
+
+namespace ppkMHD
+{
+
+/**
+ * A solver workspace: one device allocation from which transient work
+ * arrays (slopes, trace states, fluxes, ...) are handed out as unmanaged
+ * views.
+ *
+ * A time step is split into phases (solver defined integers, increasing
+ * along the step). Each buffer is declared with the first and last phase
+ * during which it is live; buffers whose lifetimes do not intersect may
+ * share memory. Buffers are packed greedily: largest first, at the lowest
+ * offset not overlapping a buffer live at the same time.
+ *
+ * A buffer sharing memory with another one is zeroed at the beginning of
+ * its lifetime (see begin_phase), so that kernels see exactly what they
+ * would see in a dedicated zero-initialized array.
+ *
+ * Usage:
+ * - constructor: declare every buffer, then call allocate(), which sets
+ *   the views passed to declare;
+ * - time step: call begin_phase(p) before the first kernel of phase p.
+ *
+ * Aliasing can be disabled with [run] workspace_aliasing=false (every
+ * buffer then gets its own memory).
+ */
+class Workspace
+{
+
+public:
+  Workspace(ConfigMap& configMap);
+
+  /**
+   * Declare a buffer.
+   *
+   * \param[in] label buffer name (for reports)
+   * \param[out] view set to the buffer memory by allocate()
+   * \param[in] first_phase first phase during which the buffer is live
+   * \param[in] last_phase last phase during which the buffer is live
+   * \param[in] dims view extents
+   */
+  template<class ViewType, class... Dims>
+  void declare(const std::string& label,
+	       ViewType& view,
+	       int first_phase,
+	       int last_phase,
+	       Dims... dims)
+  {
+    Buffer buffer;
+    buffer.label       = label;
+    buffer.bytes       = ViewType::required_allocation_size(dims...);
+    buffer.first_phase = first_phase;
+    buffer.last_phase  = last_phase;
+    buffer.offset      = 0;
+    buffer.aliased     = false;
+    buffer.bind = [&view, dims...](char* ptr)
+      {
+	view = ViewType(reinterpret_cast<typename ViewType::pointer_type>(ptr), dims...);
+      };
+
+    m_buffers.push_back(buffer);
+  }
+
+  /**
+   * Compute buffer offsets, allocate the pool (with parallel first
+   * touch, over nbCells cells) and set all declared views.
+   */
+  void allocate(int nbCells);
+
+  //! zero the aliased buffers whose lifetime starts at phase
+  void begin_phase(int phase);
+
+  //! sum of the sizes of declared buffers (bytes)
+  size_t requested_size() const;
+
+  //! size of the pool (bytes), i.e. peak workspace memory
+  size_t allocated_size() const { return m_pool.span()*sizeof(double); }
+
+  //! print buffers layout and memory footprint
+  void print_info() const;
+
+private:
+  //! a buffer in the pool
+  struct Buffer
+  {
+    std::string label;
+    size_t bytes;
+    int first_phase;
+    int last_phase;
+    size_t offset;   //!< in bytes, from the beginning of the pool
+    bool aliased;    //!< shares memory with another buffer
+    std::function<void(char*)> bind;
+  };
+
+  //! alignment of buffers in the pool (bytes)
+  static const size_t alignment = 128;
+
+  bool m_aliasing_enabled;
+
+  std::vector<Buffer> m_buffers;
+
+  //! the pool (double, to ensure alignment of any scalar type)
+  Kokkos::View<double*, Device> m_pool;
+
+}; // class Workspace
+
+} // namespace ppkMHD
+
+#endif // WORKSPACE_H_
@@ -219,6 +219,14 @@ enum ImplementationVersion
   IMPL_VERSION_2
 };
 
+//! how the gravity field is provided to kernels (see GravityField)
+enum GravityFieldType
+{
+  GRAVITY_FIELD_UNIFORM,      /*!< uniform static field, evaluated inline */
+  GRAVITY_FIELD_POINT_SOURCE, /*!< point source field, evaluated inline */
+  GRAVITY_FIELD_STORED        /*!< field stored in a VectorField array */
+};
+
 //! problem type
 enum ProblemType
 {
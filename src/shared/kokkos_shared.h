@@ -21,10 +21,12 @@ enum KokkosLayout {
 
 // last index is hydro variable
 // n-1 first indexes are space (i,j,k,....)
-typedef Kokkos::View<real_t***, Device>   DataArray2d;
-typedef DataArray2d::HostMirror           DataArray2dHost;
+// data arrays use the storage type (single precision when mixed precision
+// is enabled), see real_type.h
+typedef Kokkos::View<real_storage_t***, Device>   DataArray2d;
+typedef DataArray2d::HostMirror                   DataArray2dHost;
 
-typedef Kokkos::View<real_t****, Device>  DataArray3d;
+typedef Kokkos::View<real_storage_t****, Device>  DataArray3d;
 typedef DataArray3d::HostMirror           DataArray3dHost;
 //typedef DataArray2d     DataArray3d;
 //typedef DataArray2dHost DataArray3dHost;
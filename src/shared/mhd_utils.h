@@ -71,7 +71,7 @@ real_t FMAX5(real_t a0, real_t a1, real_t a2, real_t a3, real_t a4)
 template <ComponentIndex3D dir>
 KOKKOS_INLINE_FUNCTION
 real_t find_speed_fast(const MHDState& qvar,
-                       const HydroParams& params)
+                       const KernelParams& params)
 {
 
   const real_t& gamma0  = params.settings.gamma0;
@@ -155,7 +155,7 @@ KOKKOS_INLINE_FUNCTION
 void find_mhd_flux(const MHDState& qvar,
                    MHDState &cvar,
                    MHDState &ff,
-                   const HydroParams& params)
+                   const KernelParams& params)
 {
 
   const real_t &gamma0 = params.settings.gamma0;
@@ -227,7 +227,7 @@ template<DimensionType NDIM>
 KOKKOS_INLINE_FUNCTION
 void fast_mhd_speed(const MHDState& qState,
                     real_t (&fastMagSpeed)[3],
-                    const HydroParams& params)
+                    const KernelParams& params)
 {
 
   const real_t &gamma0 = params.settings.gamma0;
@@ -305,7 +305,7 @@ template<DimensionType NDIM>
 KOKKOS_INLINE_FUNCTION
 void find_speed_info(const MHDState qState,
                      real_t (&fastInfoSpeed)[3],
-                     const HydroParams& params)
+                     const KernelParams& params)
 {
 
   const real_t& gamma0  = params.settings.gamma0;
@@ -363,7 +363,7 @@ void find_speed_info(const MHDState qState,
  */
 KOKKOS_INLINE_FUNCTION
 real_t find_speed_info(const MHDState& qState,
-                       const HydroParams& params)
+                       const KernelParams& params)
 {
 
   const real_t& gamma0  = params.settings.gamma0;
@@ -56,7 +56,7 @@ public:
                     int       nbIter)
   {
     CopyBorderBuf_To_DataArray<boundaryLoc,dimType> functor(U,b,ghostWidth);
-    Kokkos::parallel_for(nbIter, functor);
+    Kokkos::parallel_for("CopyBorderBuf_To_DataArray", nbIter, functor);
   }
 
 
@@ -210,7 +210,7 @@ public:
                     int       nbIter)
   {
     CopyDataArray_To_BorderBuf<boundaryLoc,dimType> functor(b,U,ghostWidth);
-    Kokkos::parallel_for(nbIter, functor);
+    Kokkos::parallel_for("CopyDataArray_To_BorderBuf", nbIter, functor);
   }
 
   template<DimensionType dimType_ = dimType>
@@ -21,6 +21,10 @@ struct PointSourceGravity {
 
   //! soften parameter
   real_t eps;
+
+  PointSourceGravity() :
+    xs(0.0), ys(0.0), zs(0.0), GM(0.0), eps(0.0)
+  {}
   
   PointSourceGravity(ConfigMap& configMap)
   {
@@ -13,13 +13,31 @@
 
 /**
  * \typedef real_t (alias to float or double)
+ *
+ * This is the type used for all computations (Riemann solvers, trace,
+ * ...). When mixed precision is enabled, computations are always done in
+ * double precision.
  */
-#ifdef USE_DOUBLE
+#if defined(USE_DOUBLE) || defined(USE_MIXED_PRECISION)
 using real_t = double;
 #else
 using real_t = float;
 #endif // USE_DOUBLE
 
+/**
+ * \typedef real_storage_t type used to store large data arrays (DataArray2d,
+ * DataArray3d).
+ *
+ * Same as real_t unless mixed precision is enabled; in that case data
+ * arrays are stored in single precision (halving memory footprint and
+ * bandwidth) and values are promoted to double when loaded in kernels.
+ */
+#ifdef USE_MIXED_PRECISION
+using real_storage_t = float;
+#else
+using real_storage_t = real_t;
+#endif // USE_MIXED_PRECISION
+
 // math function
 #if defined(USE_DOUBLE) ||  defined(USE_MIXED_PRECISION)
 #define FMAX(x,y) fmax(x,y)
@@ -21,6 +21,8 @@ inline void print_solver_monitoring_info(SolverBase* solver)
   real_t t_dt    = solver->timers[TIMER_DT]->elapsed();
   real_t t_bound = solver->timers[TIMER_BOUNDARIES]->elapsed();
   real_t t_io    = solver->timers[TIMER_IO]->elapsed();
+  real_t t_grav  = solver->timers[TIMER_GRAVITY]->elapsed();
+  real_t t_wait  = solver->timers[TIMER_BOUNDARIES_WAIT]->elapsed();
 
   int myRank = 0;
   int nProcs = 1;
@@ -39,7 +41,11 @@ inline void print_solver_monitoring_info(SolverBase* solver)
     printf("godunov     time : %5.3f secondes %5.2f%%\n",t_comp,100*t_comp/t_tot);
     printf("compute dt  time : %5.3f secondes %5.2f%%\n",t_dt,100*t_dt/t_tot);
     printf("boundaries  time : %5.3f secondes %5.2f%%\n",t_bound,100*t_bound/t_tot);
+    if (nProcs > 1)
+      printf("  (mpi wait) time : %5.3f secondes %5.2f%%\n",t_wait,100*t_wait/t_tot);
     printf("io          time : %5.3f secondes %5.2f%%\n",t_io,100*t_io/t_tot);
+    if (solver->m_self_gravity_enabled)
+      printf("gravity     time : %5.3f secondes %5.2f%%\n",t_grav,100*t_grav/t_tot);
 
 #ifdef USE_SDM
     if (solver->solver_type == SOLVER_SDM)
@@ -94,12 +94,12 @@ void writeXdmfForHdf5Wrapper(HydroParams& params,
   }
 #endif // USE_MPI
   
-  // get data type as a string for Xdmf
+  // get data type as a string for Xdmf (must match the datasets precision)
   std::string dataTypeName;
-  if (sizeof(real_t) == sizeof(float))
-    dataTypeName = "Float";
-  else
+  if (output_double_precision(configMap))
     dataTypeName = "Double";
+  else
+    dataTypeName = "Float";
 
   /*
    * 1. open XDMF and write header lines
@@ -36,6 +36,7 @@
 #endif // USE_MPI
 
 #include "IO_common.h"
+#include "IO_staging.h"
 
 namespace ppkMHD { namespace io {
 
@@ -59,6 +60,27 @@ void writeXdmfForHdf5Wrapper(HydroParams& params,
 			     int totalNumberOfSteps,
 			     bool singleStep);
 
+// =======================================================
+// =======================================================
+/**
+ * HDF5 datatype of host buffers (i.e. real_storage_t).
+ */
+inline hid_t hdf5_memory_datatype()
+{
+  return (sizeof(real_storage_t) == sizeof(float)) ?
+    H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+}
+
+/**
+ * HDF5 datatype used for datasets in output files
+ * (see parameter "precision" in section [output]).
+ */
+inline hid_t hdf5_file_datatype(ConfigMap& configMap)
+{
+  return output_double_precision(configMap) ?
+    H5T_NATIVE_DOUBLE : H5T_NATIVE_FLOAT;
+}
+
 // =======================================================
 // =======================================================
 /**
@@ -80,77 +102,53 @@ public:
 	    const std::map<int, std::string>& variables_names,
 	    int iStep,
 	    real_t totalTime,
-	    std::string debug_name) :
+	    std::string debug_name,
+	    StagingBuffer* staging = nullptr) :
     Udata(Udata), Uhost(Uhost), params(params), configMap(configMap),
     nbvar(nbvar), variables_names(variables_names),
-    iStep(iStep), totalTime(totalTime), debug_name(debug_name)
+    iStep(iStep), totalTime(totalTime), debug_name(debug_name),
+    staging(staging ? staging : &local_staging)
   {};
   ~Save_HDF5() {};
 
   /**
-   * Copy Uhost to buffer data (then transfered to HDF5 write route) - 2d.
+   * Pack variable nvar of the region selected for output (interior cells,
+   * or with ghost cells) on device into the staging buffer, already
+   * transposed to HDF5 order; only those bytes are copied to host.
+   *
+   * \return host address of the packed data
    */
-  template<DimensionType d_ = d>
-  void copy_buffer(typename std::enable_if<d_==TWO_D, real_t>::type *& data,
-		   int isize, int jsize, int ksize, int nvar, KokkosLayout layout)
+  real_storage_t* pack_field(int nvar)
   {
-    if (layout == KOKKOS_LAYOUT_RIGHT) { // transpose array to make data contiguous in memory
-      for (int j=0; j<jsize; ++j) {
-	for (int i=0; i<isize; ++i) {
-	  int index = i+isize*j;
-	  data[index]=Uhost(i,j,nvar);
-	}
-      }
-    } else {
-      data = Uhost.data() + isize*jsize*nvar;
-    }
+    const size_t size = (size_t) region_count[0]*region_count[1]*
+      (d==TWO_D ? 1 : region_count[2]);
 
-  } // copy_buffer
+    staging->reserve(size);
+    PackVariableFunctor<d==TWO_D ? 2 : 3>::apply(Udata, nvar,
+						 region_start, region_count,
+						 staging->data);
+    staging->copy_to_host(size);
 
-  /**
-   * Copy Uhost to buffer data (then transfered to HDF5 write route) - 3d.
-   */
-  template<DimensionType d_=d>
-  void copy_buffer(typename std::enable_if<d_==THREE_D, real_t>::type *& data,
-		   int isize, int jsize, int ksize, int nvar, KokkosLayout layout)
-  {
-    if (layout == KOKKOS_LAYOUT_RIGHT) { // transpose array to make data contiguous in memory
-      for (int k=0; k<ksize; ++k) {
-	for (int j=0; j<jsize; ++j) {
-	  for (int i=0; i<isize; ++i) {
-	    int index = i+isize*j+isize*jsize*k;
-	    data[index]=Uhost(i,j,k,nvar);
-	  }
-	}
-      }
-      
-    } else {
-      data = Uhost.data() + isize*jsize*ksize*nvar;
-    }
+    return staging->data_host.data();
 
-  } // copy_buffer / 3D
+  } // pack_field
   
   // =======================================================
   // =======================================================
-  herr_t write_field(int varId, real_t* &data, hid_t& file_id,
+  herr_t write_field(int varId, hid_t& file_id,
 		     hid_t& dataspace_memory,
-		     hid_t& dataspace_file, hid_t& propList_create_id,
-		     KokkosLayout& layout)
+		     hid_t& dataspace_file, hid_t& propList_create_id)
   {
     
-    hid_t dataType = (sizeof(real_t) == sizeof(float)) ?
-      H5T_NATIVE_FLOAT :
-      H5T_NATIVE_DOUBLE;
-    const int isize = params.isize;
-    const int jsize = params.jsize;
-    const int ksize = params.ksize;
-   
+    // file datatype may differ from memory datatype, HDF5 converts
+    hid_t dataType     = hdf5_file_datatype(configMap);
+    hid_t dataTypeMem  = hdf5_memory_datatype();
     const std::string varName = "/" + variables_names.at(varId);
     hid_t dataset_id = H5Dcreate2(file_id, varName.c_str(),
 				  dataType, dataspace_file, 
 				  H5P_DEFAULT, propList_create_id, H5P_DEFAULT);
-    copy_buffer(data, isize, jsize, ksize, varId, layout);
-    herr_t status = H5Dwrite(dataset_id, dataType,
+    real_storage_t* data = pack_field(varId);
+    herr_t status = H5Dwrite(dataset_id, dataTypeMem,
 			     dataspace_memory, dataspace_file,
 			     H5P_DEFAULT, data);
     H5Dclose(dataset_id);
@@ -177,10 +175,6 @@ public:
     const int ny = params.ny;
     const int nz = params.nz;
 
-    const int isize = params.isize;
-    const int jsize = params.jsize;
-    const int ksize = params.ksize;
-
     const int ghostWidth = params.ghostWidth;
 
     const int dimType = params.dimType;
@@ -189,15 +183,8 @@ public:
 
     const bool mhdEnabled = params.mhdEnabled;
     
-    // copy device data to host
-    Kokkos::deep_copy(Uhost, Udata);
-
-    // here we need to check Uhost memory layout
-    KokkosLayout layout;
-    if (std::is_same<typename DataArray::array_layout, Kokkos::LayoutLeft>::value)
-      layout = KOKKOS_LAYOUT_LEFT;
-    else
-      layout = KOKKOS_LAYOUT_RIGHT;
+    // data is packed on device, variable by variable (see pack_field),
+    // Uhost is not used here
 
     herr_t status = 0;
     UNUSED(status);
@@ -235,16 +222,16 @@ public:
     hsize_t  dims_file[3];
     hid_t dataspace_memory, dataspace_file;
     if (dimType == TWO_D) {
-      dims_memory[0] = jsize;
-      dims_memory[1] = isize;
+      dims_memory[0] = nyg;
+      dims_memory[1] = nxg;
       dims_file[0] = nyg;
       dims_file[1] = nxg;
       dataspace_memory = H5Screate_simple(2, dims_memory, NULL);
       dataspace_file   = H5Screate_simple(2, dims_file  , NULL);
     } else {
-      dims_memory[0] = ksize;
-      dims_memory[1] = jsize;
-      dims_memory[2] = isize;
+      dims_memory[0] = nzg;
+      dims_memory[1] = nyg;
+      dims_memory[2] = nxg;
       dims_file[0] = nzg;
       dims_file[1] = nyg;
       dims_file[2] = nxg;
@@ -260,35 +247,12 @@ public:
     //   dataType = H5T_NATIVE_DOUBLE;
     
 
-    // select data with or without ghost zones
-    if (ghostIncluded) {
-      if (dimType == TWO_D) {
-	hsize_t  start[2] = {0, 0}; // ghost zone width
-	hsize_t stride[2] = {1, 1};
-	hsize_t  count[2] = {(hsize_t) nyg, (hsize_t) nxg};
-	hsize_t  block[2] = {1, 1}; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);
-      } else {
-	hsize_t  start[3] = {0, 0, 0}; // ghost zone width
-	hsize_t stride[3] = {1, 1, 1};
-	hsize_t  count[3] = {(hsize_t) nzg, (hsize_t) nyg, (hsize_t) nxg};
-	hsize_t  block[3] = {1, 1, 1}; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);
-      }      
-    } else {
-      if (dimType == TWO_D) {
-	hsize_t  start[2] = {(hsize_t) ghostWidth, (hsize_t) ghostWidth}; // ghost zone width
-	hsize_t stride[2] = {1, 1};
-	hsize_t  count[2] = {(hsize_t) ny, (hsize_t) nx};
-	hsize_t  block[2] = {1, 1}; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);
-      } else {
-	hsize_t  start[3] = {(hsize_t) ghostWidth, (hsize_t) ghostWidth, (hsize_t) ghostWidth}; // ghost zone width
-	hsize_t stride[3] = {1, 1, 1};
-	hsize_t  count[3] = {(hsize_t) nz, (hsize_t) ny, (hsize_t) nx};
-	hsize_t  block[3] = {1, 1, 1}; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);      
-      }
+    // region of Udata to write, with or without ghost zones; it is packed
+    // on device so that memory and file dataspaces match exactly
+    {
+      const int offset = ghostIncluded ? 0 : ghostWidth;
+      region_start = {{offset, offset, offset}};
+      region_count = {{nxg, nyg, nzg}};
     }
 
     /*
@@ -319,62 +283,44 @@ public:
     /*
      * write heavy data to HDF5 file
      */
-    real_t* data;
-  
-    // Some adjustement needed to take into account that strides / layout need
-    // to be checked at runtime
-    // if memory layout is KOKKOS_LAYOUT_RIGHT, we need an extra buffer.
-    if (layout == KOKKOS_LAYOUT_RIGHT) {
-
-      if (dimType == TWO_D)
-	data = new real_t[isize*jsize];
-      else
-	data = new real_t[isize*jsize*ksize];
-
-    }      
   
     // write density
-    write_field(ID, data, file_id, dataspace_memory,
-		dataspace_file, propList_create_id, layout);
+    write_field(ID, file_id, dataspace_memory,
+		dataspace_file, propList_create_id);
 
     // write total energy
-    write_field(IE, data, file_id, dataspace_memory,
-		dataspace_file, propList_create_id, layout);
+    write_field(IE, file_id, dataspace_memory,
+		dataspace_file, propList_create_id);
     
     // write momentum X
-    write_field(IU, data, file_id, dataspace_memory,
-		dataspace_file, propList_create_id, layout);
+    write_field(IU, file_id, dataspace_memory,
+		dataspace_file, propList_create_id);
     
     // write momentum Y
-    write_field(IV, data, file_id, dataspace_memory,
-		dataspace_file, propList_create_id, layout);
+    write_field(IV, file_id, dataspace_memory,
+		dataspace_file, propList_create_id);
     
     // write momentum Z (only if 3D hydro)
     if (dimType == THREE_D and !mhdEnabled) {
-      write_field(IW, data, file_id, dataspace_memory,
-		  dataspace_file, propList_create_id, layout);      
+      write_field(IW, file_id, dataspace_memory,
+		  dataspace_file, propList_create_id);      
     }
     
     if (mhdEnabled) {
       // write momentum mz
-      write_field(IW, data, file_id, dataspace_memory,
-		  dataspace_file, propList_create_id, layout);      
+      write_field(IW, file_id, dataspace_memory,
+		  dataspace_file, propList_create_id);      
       
       // write magnetic field components
-      write_field(IA, data, file_id, dataspace_memory,
-		  dataspace_file, propList_create_id, layout);      
-      write_field(IB, data, file_id, dataspace_memory,
-		  dataspace_file, propList_create_id, layout);      
-      write_field(IC, data, file_id, dataspace_memory,
-		  dataspace_file, propList_create_id, layout);      
+      write_field(IA, file_id, dataspace_memory,
+		  dataspace_file, propList_create_id);      
+      write_field(IB, file_id, dataspace_memory,
+		  dataspace_file, propList_create_id);      
+      write_field(IC, file_id, dataspace_memory,
+		  dataspace_file, propList_create_id);      
       
     } // end mhdEnabled
 
-    // free memory if necessary
-    if (layout == KOKKOS_LAYOUT_RIGHT) {
-      delete[] data;
-    }
-  
     // write time step as an attribute to root group
     hid_t ds_id;
     hid_t attr_id;
@@ -480,6 +426,14 @@ public:
   int iStep;
   real_t totalTime;
   std::string debug_name;
+
+  //! staging buffer (device and host), reused across outputs if provided
+  StagingBuffer  local_staging;
+  StagingBuffer* staging;
+
+  //! region of Udata written to file (array indexes, ghost cells included)
+  Kokkos::Array<int,3> region_start;
+  Kokkos::Array<int,3> region_count;
   
 }; // class Save_HDF5
 
@@ -505,80 +459,56 @@ public:
 		const std::map<int, std::string>& variables_names,
 		int iStep,
 		real_t totalTime,
-		std::string debug_name) :
+		std::string debug_name,
+		StagingBuffer* staging = nullptr) :
     Udata(Udata), Uhost(Uhost), params(params), configMap(configMap),
     nbvar(nbvar), variables_names(variables_names),
-    iStep(iStep), totalTime(totalTime), debug_name(debug_name)
+    iStep(iStep), totalTime(totalTime), debug_name(debug_name),
+    staging(staging ? staging : &local_staging)
   {};
   ~Save_HDF5_mpi() {};
 
   /**
-   * Copy Uhost to buffer data (then transfered to HDF5 write route) - 2d mpi.
+   * Pack variable nvar of the region selected for output (interior cells,
+   * or with ghost cells) on device into the staging buffer, already
+   * transposed to HDF5 order; only those bytes are copied to host.
+   *
+   * \return host address of the packed data
    */
-  template<DimensionType d_ = d>
-  void copy_buffer(typename std::enable_if<d_==TWO_D, real_t>::type *& data,
-		   int isize, int jsize, int ksize, int nvar, KokkosLayout layout)
+  real_storage_t* pack_field(int nvar)
   {
-    if (layout == KOKKOS_LAYOUT_RIGHT) { // transpose array to make data contiguous in memory
-      for (int j=0; j<jsize; ++j) {
-	for (int i=0; i<isize; ++i) {
-	  int index = i+isize*j;
-	  data[index]=Uhost(i,j,nvar);
-	}
-      }
-    } else {
-      data = Uhost.data() + isize*jsize*nvar;
-    }
+    const size_t size = (size_t) region_count[0]*region_count[1]*
+      (d==TWO_D ? 1 : region_count[2]);
 
-  } // copy_buffer
+    staging->reserve(size);
+    PackVariableFunctor<d==TWO_D ? 2 : 3>::apply(Udata, nvar,
+						 region_start, region_count,
+						 staging->data);
+    staging->copy_to_host(size);
 
-  /**
-   * Copy Uhost to buffer data (then transfered to HDF5 write route) - 3d mpi.
-   */
-  template<DimensionType d_ = d>
-  void copy_buffer(typename std::enable_if<d_==THREE_D, real_t>::type *& data,
-		   int isize, int jsize, int ksize, int nvar, KokkosLayout layout)
-  {
-    if (layout == KOKKOS_LAYOUT_RIGHT) { // transpose array to make data contiguous in memory
-      for (int k=0; k<ksize; ++k) {
-	for (int j=0; j<jsize; ++j) {
-	  for (int i=0; i<isize; ++i) {
-	    int index = i+isize*j+isize*jsize*k;
-	    data[index]=Uhost(i,j,k,nvar);
-	  }
-	}
-      }
-      
-    } else {
-      data = Uhost.data() + isize*jsize*ksize*nvar;
-    }
+    return staging->data_host.data();
 
-  } // copy_buffer / 3D
+  } // pack_field
   
   // =======================================================
   // =======================================================
-  herr_t write_field(int varId, real_t* &data, hid_t& file_id,
+  herr_t write_field(int varId, hid_t& file_id,
 		     hid_t& dataspace_memory,
 		     hid_t& dataspace_file,
 		     hid_t& propList_create_id,
-		     hid_t& propList_xfer_id,
-		     KokkosLayout& layout)
+		     hid_t& propList_xfer_id)
   {
     
-    hid_t dataType = (sizeof(real_t) == sizeof(float)) ?
-      H5T_NATIVE_FLOAT :
-      H5T_NATIVE_DOUBLE;
-    const int isize = params.isize;
-    const int jsize = params.jsize;
-    const int ksize = params.ksize;
-   
+    // file datatype may differ from memory datatype, HDF5 converts
+    hid_t dataType     = hdf5_file_datatype(configMap);
+    hid_t dataTypeMem  = hdf5_memory_datatype();
     const std::string varName = "/" + variables_names.at(varId);
 
     hid_t dataset_id = H5Dcreate2(file_id, varName.c_str(),
 				  dataType, dataspace_file, 
 				  H5P_DEFAULT, propList_create_id, H5P_DEFAULT);
-    copy_buffer(data, isize, jsize, ksize, varId, layout);
-    herr_t status = H5Dwrite(dataset_id, dataType,
+    real_storage_t* data = pack_field(varId);
+    herr_t status = H5Dwrite(dataset_id, dataTypeMem,
 			     dataspace_memory, dataspace_file,
 			     propList_xfer_id, data);
     H5Dclose(dataset_id);
@@ -638,15 +568,8 @@ public:
     // verbose log ?
     bool hdf5_verbose = configMap.getBool("output","hdf5_verbose",false);
 
-    // copy device data to host
-    Kokkos::deep_copy(Uhost, Udata);
-
-    // here we need to check Uhost memory layout
-    KokkosLayout layout;
-    if (std::is_same<typename DataArray::array_layout, Kokkos::LayoutLeft>::value)
-      layout = KOKKOS_LAYOUT_LEFT;
-    else
-      layout = KOKKOS_LAYOUT_RIGHT;
+    // data is packed on device, variable by variable (see pack_field),
+    // Uhost is not used here
   
     /*
      * creation date
@@ -701,10 +624,12 @@ public:
      * write HDF5 file
      */
     // Create a new file using property list with parallel I/O access.
-    MPI_Info mpi_info     = MPI_INFO_NULL;
+    MPI_Info mpi_info     = mpi_io_hints(configMap);
     hid_t    propList_create_id = H5Pcreate(H5P_FILE_ACCESS);
     status = H5Pset_fapl_mpio(propList_create_id, /*MPI_COMM_WORLD*/ params.communicator->getComm(), mpi_info);
     HDF5_CHECK(status, "Can not access MPI IO parameters");
+    if (mpi_info != MPI_INFO_NULL)
+      MPI_Info_free(&mpi_info);
 
     hid_t    file_id  = H5Fcreate(hdf5FilenameFull.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, propList_create_id);
     H5Pclose(propList_create_id);
@@ -728,11 +653,8 @@ public:
 	  
 	  dims_file[0] = (ny+2*ghostWidth)*(mx*my);
 	  dims_file[1] = (nx+2*ghostWidth);
-	  dims_memory[0] = jsize;
-	  dims_memory[1] = isize;
 	  dims_chunk[0] = ny+2*ghostWidth;
 	  dims_chunk[1] = nx+2*ghostWidth;
-	  dataspace_memory = H5Screate_simple(2, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(2, dims_file  , NULL);
 
 	} else { // THREE_D
@@ -740,13 +662,9 @@ public:
 	  dims_file[0] = (nz+2*ghostWidth)*(mx*my*mz);
 	  dims_file[1] =  ny+2*ghostWidth;
 	  dims_file[2] =  nx+2*ghostWidth;
-	  dims_memory[0] = ksize; 
-	  dims_memory[1] = jsize;
-	  dims_memory[2] = isize;
 	  dims_chunk[0] = nz+2*ghostWidth;
 	  dims_chunk[1] = ny+2*ghostWidth;
 	  dims_chunk[2] = nx+2*ghostWidth;
-	  dataspace_memory = H5Screate_simple(3, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(3, dims_file  , NULL);
 	  
 	} // end THREE_D
@@ -757,11 +675,8 @@ public:
 	  
 	  dims_file[0] = (ny)*(mx*my);
 	  dims_file[1] = nx;
-	  dims_memory[0] = jsize; 
-	  dims_memory[1] = isize;
 	  dims_chunk[0] = ny;
 	  dims_chunk[1] = nx;
-	  dataspace_memory = H5Screate_simple(2, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(2, dims_file  , NULL);
 
 	} else {
@@ -769,13 +684,9 @@ public:
 	  dims_file[0] = (nz)*(mx*my*mz);
 	  dims_file[1] = ny;
 	  dims_file[2] = nx;
-	  dims_memory[0] = ksize; 
-	  dims_memory[1] = jsize;
-	  dims_memory[2] = isize;
 	  dims_chunk[0] = nz;
 	  dims_chunk[1] = ny;
 	  dims_chunk[2] = nx;
-	  dataspace_memory = H5Screate_simple(3, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(3, dims_file  , NULL);
 	  
 	} // end THREE_D
@@ -793,11 +704,8 @@ public:
 	  
 	  dims_file[0] = my*(ny+2*ghostWidth);
 	  dims_file[1] = mx*(nx+2*ghostWidth);
-	  dims_memory[0] = jsize; 
-	  dims_memory[1] = isize;
 	  dims_chunk[0] = ny+2*ghostWidth;
 	  dims_chunk[1] = nx+2*ghostWidth;
-	  dataspace_memory = H5Screate_simple(2, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(2, dims_file  , NULL);
 
 	} else {
@@ -805,13 +713,9 @@ public:
 	  dims_file[0] = mz*(nz+2*ghostWidth);
 	  dims_file[1] = my*(ny+2*ghostWidth);
 	  dims_file[2] = mx*(nx+2*ghostWidth);
-	  dims_memory[0] = ksize; 
-	  dims_memory[1] = jsize;
-	  dims_memory[2] = isize;
 	  dims_chunk[0] = nz+2*ghostWidth;
 	  dims_chunk[1] = ny+2*ghostWidth;
 	  dims_chunk[2] = nx+2*ghostWidth;
-	  dataspace_memory = H5Screate_simple(3, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(3, dims_file  , NULL);
 	  
 	}
@@ -822,11 +726,8 @@ public:
 	  
 	  dims_file[0] = ny*my+2*ghostWidth;
 	  dims_file[1] = nx*mx+2*ghostWidth;
-	  dims_memory[0] = jsize; 
-	  dims_memory[1] = isize;
 	  dims_chunk[0] = ny+2*ghostWidth;
 	  dims_chunk[1] = nx+2*ghostWidth;
-	  dataspace_memory = H5Screate_simple(2, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(2, dims_file  , NULL);
 
 	} else {
@@ -834,13 +735,9 @@ public:
 	  dims_file[0] = nz*mz+2*ghostWidth;
 	  dims_file[1] = ny*my+2*ghostWidth;
 	  dims_file[2] = nx*mx+2*ghostWidth;
-	  dims_memory[0] = ksize;
-	  dims_memory[1] = jsize;
-	  dims_memory[2] = isize;
 	  dims_chunk[0] = nz+2*ghostWidth;
 	  dims_chunk[1] = ny+2*ghostWidth;
 	  dims_chunk[2] = nx+2*ghostWidth;
-	  dataspace_memory = H5Screate_simple(3, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(3, dims_file  , NULL);
 
 	}
@@ -851,11 +748,8 @@ public:
 
 	  dims_file[0] = ny*my;
 	  dims_file[1] = nx*mx;
-	  dims_memory[0] = jsize;
-	  dims_memory[1] = isize;
 	  dims_chunk[0] = ny;
 	  dims_chunk[1] = nx;
-	  dataspace_memory = H5Screate_simple(2, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(2, dims_file  , NULL);
 
 	} else {
@@ -863,13 +757,9 @@ public:
 	  dims_file[0] = nz*mz;
 	  dims_file[1] = ny*my;
 	  dims_file[2] = nx*mx;
-	  dims_memory[0] = ksize;
-	  dims_memory[1] = jsize;
-	  dims_memory[2] = isize;
 	  dims_chunk[0] = nz;
 	  dims_chunk[1] = ny;
 	  dims_chunk[2] = nx;
-	  dataspace_memory = H5Screate_simple(3, dims_memory, NULL);
 	  dataspace_file   = H5Screate_simple(3, dims_file  , NULL);
 	  
 	}
@@ -879,42 +769,21 @@ public:
     } // end reassembleInFile is true
     
     /*
-     * Memory space hyperslab :
-     * select data with or without ghost zones
+     * Memory space: the region of Udata to write (with or without ghost
+     * zones) is packed on device (see pack_field), so that it matches
+     * exactly the file hyperslab below.
      */
+    for (int n=0; n<3; ++n)
+      dims_memory[n] = dims_chunk[n];
+    dataspace_memory = H5Screate_simple(dimType == TWO_D ? 2 : 3, dims_memory, NULL);
+
     if (ghostIncluded or allghostIncluded) {
-      
-      if (dimType == TWO_D) {
-	hsize_t  start[2] = { 0, 0 }; // no start offset
-	hsize_t stride[2] = { 1, 1 };
-	hsize_t  count[2] = { 1, 1 };
-	hsize_t  block[2] = { dims_chunk[0], dims_chunk[1] }; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);
-      } else {
-	hsize_t  start[3] = { 0, 0, 0 }; // no start offset
-	hsize_t stride[3] = { 1, 1, 1 };
-	hsize_t  count[3] = { 1, 1, 1 };
-	hsize_t  block[3] = { dims_chunk[0], dims_chunk[1], dims_chunk[2] }; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);      
-      }
-      
-    } else { // no ghost zones
-      
-      if (dimType == TWO_D) {
-	hsize_t  start[2] = { (hsize_t) ghostWidth,  (hsize_t) ghostWidth }; // ghost zone width
-	hsize_t stride[2] = {                    1,                     1 };
-	hsize_t  count[2] = {                    1,                     1 };
-	hsize_t  block[2] = {(hsize_t)           ny, (hsize_t)         nx }; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);
-      } else {
-	hsize_t  start[3] = { (hsize_t) ghostWidth,  (hsize_t) ghostWidth, (hsize_t) ghostWidth }; // ghost zone width
-	hsize_t stride[3] = { 1,  1,  1 };
-	hsize_t  count[3] = { 1,  1,  1 };
-	hsize_t  block[3] = {(hsize_t) nz, (hsize_t) ny, (hsize_t) nx }; // row-major instead of column-major here
-	status = H5Sselect_hyperslab(dataspace_memory, H5S_SELECT_SET, start, stride, count, block);      
-      }
-      
-    } // end ghostIncluded or allghostIncluded
+      region_start = {{0, 0, 0}};
+      region_count = {{nx+2*ghostWidth, ny+2*ghostWidth, nz+2*ghostWidth}};
+    } else {
+      region_start = {{ghostWidth, ghostWidth, ghostWidth}};
+      region_count = {{nx, ny, nz}};
+    }
     
     /*
      * File space hyperslab :
@@ -1030,19 +899,6 @@ public:
      * write heavy data to HDF5 file
      *
      */
-    real_t* data;
-
-    // Some adjustement needed to take into account that strides / layout need
-    // to be checked at runtime
-    // if memory layout is KOKKOS_LAYOUT_RIGHT, we need an extra buffer.
-    if (layout == KOKKOS_LAYOUT_RIGHT) {
-
-      if (dimType == TWO_D)
-	data = new real_t[isize*jsize];
-      else
-	data = new real_t[isize*jsize*ksize];
-
-    }
 
     propList_create_id = H5Pcreate(H5P_DATASET_CREATE);
     if (dimType == TWO_D)
@@ -1063,55 +919,50 @@ public:
     /*
      * write density    
      */
-    write_field(ID, data, file_id, dataspace_memory,
-    		dataspace_file, propList_create_id, propList_xfer_id, layout);
+    write_field(ID, file_id, dataspace_memory,
+    		dataspace_file, propList_create_id, propList_xfer_id);
 
     
     /*
      * write energy
      */
-    write_field(IE, data, file_id, dataspace_memory,
-    		dataspace_file, propList_create_id, propList_xfer_id, layout);
+    write_field(IE, file_id, dataspace_memory,
+    		dataspace_file, propList_create_id, propList_xfer_id);
     
     /*
      * write momentum X
      */
-    write_field(IU, data, file_id, dataspace_memory,
-    		dataspace_file, propList_create_id, propList_xfer_id, layout);    
+    write_field(IU, file_id, dataspace_memory,
+    		dataspace_file, propList_create_id, propList_xfer_id);    
     /*
      * write momentum Y
      */
-    write_field(IV, data, file_id, dataspace_memory,
-    		dataspace_file, propList_create_id, propList_xfer_id, layout);
+    write_field(IV, file_id, dataspace_memory,
+    		dataspace_file, propList_create_id, propList_xfer_id);
     
     /*
      * write momentum Z (only if 3D or MHD enabled)
      */
     if (dimType == THREE_D and !mhdEnabled) {
-      write_field(IW, data, file_id, dataspace_memory,
-    		  dataspace_file, propList_create_id, propList_xfer_id, layout);
+      write_field(IW, file_id, dataspace_memory,
+    		  dataspace_file, propList_create_id, propList_xfer_id);
     }
     
     if (mhdEnabled) {
       // write momentum z
-      write_field(IW, data, file_id, dataspace_memory,
-    		  dataspace_file, propList_create_id, propList_xfer_id, layout);
+      write_field(IW, file_id, dataspace_memory,
+    		  dataspace_file, propList_create_id, propList_xfer_id);
       
       // write magnetic field components
-      write_field(IA, data, file_id, dataspace_memory,
-    		  dataspace_file, propList_create_id, propList_xfer_id, layout);
-      write_field(IB, data, file_id, dataspace_memory,
-    		  dataspace_file, propList_create_id, propList_xfer_id, layout);
-      write_field(IC, data, file_id, dataspace_memory,
-    		  dataspace_file, propList_create_id, propList_xfer_id, layout);
+      write_field(IA, file_id, dataspace_memory,
+    		  dataspace_file, propList_create_id, propList_xfer_id);
+      write_field(IB, file_id, dataspace_memory,
+    		  dataspace_file, propList_create_id, propList_xfer_id);
+      write_field(IC, file_id, dataspace_memory,
+    		  dataspace_file, propList_create_id, propList_xfer_id);
 
     }
 
-    // free memory if necessary
-    if (layout == KOKKOS_LAYOUT_RIGHT) {
-      delete[] data;
-    }
-
     // write time step number
     hid_t ds_id   = H5Screate(H5S_SCALAR);
     hid_t attr_id;
@@ -1266,9 +1117,9 @@ public:
       write_timing = MPI_Wtime() - write_timing;
       
       if (dimType == TWO_D)
-	write_size = nbvar * isize * jsize * sizeof(real_t);
+	write_size = nbvar * isize * jsize * sizeof(real_storage_t);
       else
-	write_size = nbvar * isize * jsize * ksize * sizeof(real_t);
+	write_size = nbvar * isize * jsize * ksize * sizeof(real_storage_t);
       //write_size = U.sizeBytes();
       sum_write_size = write_size *  params.nProcs;
       
@@ -1282,14 +1133,14 @@ public:
 	       nx+2*ghostWidth,
 	       ny+2*ghostWidth,
 	       nz+2*ghostWidth,
-	       sizeof(real_t),
+	       sizeof(real_storage_t),
 	       1.0*write_size/1048576.0);
 	sum_write_size /= 1048576.0;
 	printf("Global array size %d x %d x %d reals(%zu bytes), write size = %.2f GB\n",
 	       mx*nx+2*ghostWidth,
 	       my*ny+2*ghostWidth,
 	       mz*nz+2*ghostWidth,
-	       sizeof(real_t),
+	       sizeof(real_storage_t),
 	       1.0*sum_write_size/1024);
 	
 	write_bw = sum_write_size/max_write_timing;
@@ -1316,6 +1167,14 @@ public:
   int iStep;
   real_t totalTime;
   std::string debug_name;
+
+  //! staging buffer (device and host), reused across outputs if provided
+  StagingBuffer  local_staging;
+  StagingBuffer* staging;
+
+  //! region of Udata written to file (array indexes, ghost cells included)
+  Kokkos::Array<int,3> region_start;
+  Kokkos::Array<int,3> region_count;
   
 }; // class Save_HDF5_mpi
 
@@ -1387,7 +1246,7 @@ public:
    * copy buffered data (read from file with HDF5 API) to host array - 2d.
    */
   template<DimensionType d_ = d>
-  void copy_buffer(typename std::enable_if<d_==TWO_D, real_t>::type *& data,
+  void copy_buffer(typename std::enable_if<d_==TWO_D, real_storage_t>::type *& data,
 		   int isize, int jsize, int ksize, int nvar, KokkosLayout layout)
   {
     bool halfResolution = configMap.getBool("run","restart_upscale",false);
@@ -1448,8 +1307,8 @@ public:
 	}
       } else {
 	// simple copy
-	real_t* tmp = Uhost.data() + isize*jsize*nvar;
-	memcpy(tmp,data,isize*jsize*sizeof(real_t));
+	real_storage_t* tmp = Uhost.data() + isize*jsize*nvar;
+	memcpy(tmp,data,isize*jsize*sizeof(real_storage_t));
       }
     }
 
@@ -1459,7 +1318,7 @@ public:
    * copy buffered data (read from file with HDF5 API) to host array - 3d.
    */
   template<DimensionType d_=d>
-  void copy_buffer(typename std::enable_if<d_==THREE_D, real_t>::type *& data,
+  void copy_buffer(typename std::enable_if<d_==THREE_D, real_storage_t>::type *& data,
 		   int isize, int jsize, int ksize, int nvar, KokkosLayout layout)
   {
     bool halfResolution = configMap.getBool("run","restart_upscale",false);
@@ -1538,8 +1397,8 @@ public:
 	
       } else {
 	// simple copy
-	real_t* tmp = Uhost.data() + isize*jsize*ksize*nvar;
-	memcpy(tmp,data,isize*jsize*ksize*sizeof(real_t));
+	real_storage_t* tmp = Uhost.data() + isize*jsize*ksize*nvar;
+	memcpy(tmp,data,isize*jsize*ksize*sizeof(real_storage_t));
       }
 
     } // end halfResolution
@@ -1564,7 +1423,7 @@ public:
    * \param[in] dataspace_file hdf5 dataspace file
    * \param[in] layout Kokkos layout parameter passed to copy_buffer
    */
-  herr_t read_field(int varId, real_t* &data, hid_t& file_id,
+  herr_t read_field(int varId, real_storage_t* &data, hid_t& file_id,
 		    hid_t& dataspace_memory,
 		    hid_t& dataspace_file, 
 		    KokkosLayout& layout)
@@ -1580,15 +1439,15 @@ public:
     // cross check dataType
     hid_t        dataType   = H5Dget_type(dataset_id);
     H5T_class_t t_class = H5Tget_class(dataType);
-    hid_t        expectedDataType = (sizeof(real_t) == sizeof(float)) ?
-      H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+    hid_t        expectedDataType = hdf5_memory_datatype();
     H5T_class_t t_class_expected = H5Tget_class(expectedDataType);
     if (t_class != t_class_expected) {
       std::cerr << "Wrong HDF5 datatype !!\n";
       std::cerr << "expected     : " << t_class_expected << std::endl;
       std::cerr << "but received : " << t_class          << std::endl;
     }
-    herr_t status = H5Dread(dataset_id, dataType, dataspace_memory, dataspace_file,
+    // read into the storage precision, whatever the file precision
+    herr_t status = H5Dread(dataset_id, expectedDataType, dataspace_memory, dataspace_file,
 			    H5P_DEFAULT, data);
     HDF5_CHECK(status, "Problem reading field");
 
@@ -1784,15 +1643,15 @@ public:
     
     // pointer to data in memory buffer
     // must be allocated (TODO)
-    real_t* data;
+    real_storage_t* data;
     
     // here for simplicity, we don't care if the restart is done
     // with upscaling; actually the sizes used here are necessary
     // for a regular restart (and thus sufficient for an upscaled restart)
     if (dimType == TWO_D)
-      data = new real_t[isize*jsize];
+      data = new real_storage_t[isize*jsize];
     else
-      data = new real_t[isize*jsize*ksize];
+      data = new real_storage_t[isize*jsize*ksize];
     
     /*
      * open data set and perform read
@@ -1954,7 +1813,7 @@ public:
    * \param[in] propList_xfer_id hdf5 related parameter
    * \param[in] layout Kokkos layout parameter passed to copy_buffer
    */
-  herr_t read_field(int varId, real_t* &data, hid_t& file_id,
+  herr_t read_field(int varId, real_storage_t* &data, hid_t& file_id,
 		    hid_t& dataspace_memory,
 		    hid_t& dataspace_file,
 		    hid_t& propList_xfer_id,
@@ -1964,8 +1823,7 @@ public:
     const int isize = this->params.isize;
     const int jsize = this->params.jsize;
     const int ksize = this->params.ksize;
-    hid_t dataType = (sizeof(real_t) == sizeof(float)) ?
-      H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE;
+    hid_t dataType = hdf5_memory_datatype();
     
     const std::string varName = "/" + this->variables_names.at(varId);
     hid_t dataset_id = H5Dopen2(file_id, varName.c_str(), H5P_DEFAULT);
@@ -2055,7 +1913,7 @@ public:
 
     read_size = dimType == TWO_D ? nx_rg*ny_rg : nx_rg*ny_rg*nz_rg;
     read_size *= nbvar;
-    read_size *= sizeof(real_t);
+    read_size *= sizeof(real_storage_t);
     
     // get MPI coords corresponding to MPI rank iPiece
     int coords[3];
@@ -2331,15 +2189,15 @@ public:
     
     // pointer to data in memory buffer
     // must be allocated (TODO)
-    real_t* data;
+    real_storage_t* data;
 
     // here for simplicity, we don't care if the restart is done
     // with upscaling; actually the sizes used here are necessary
     // for a regular restart (and thus sufficient for an upscaled restart)
     if (dimType == TWO_D)
-      data = new real_t[isize*jsize];
+      data = new real_storage_t[isize*jsize];
     else
-      data = new real_t[isize*jsize*ksize];
+      data = new real_storage_t[isize*jsize*ksize];
 
     hid_t propList_create_id = H5Pcreate(H5P_DATASET_CREATE);
     if (dimType == TWO_D)
@@ -2442,14 +2300,14 @@ public:
 	       nx+2*ghostWidth,
 	       ny+2*ghostWidth,
 	       nz+2*ghostWidth,
-	       sizeof(real_t),
+	       sizeof(real_storage_t),
 	       1.0*read_size/1048576.0);
 	sum_read_size /= 1048576.0;
 	printf("Global array size %d x %d x %d reals(%zu bytes), read size = %.2f GB\n",
 	       mx*nx+2*ghostWidth,
 	       my*ny+2*ghostWidth,
 	       mz*nz+2*ghostWidth,
-	       sizeof(real_t),
+	       sizeof(real_storage_t),
 	       1.0*sum_read_size/1024);
 	
 	read_bw = sum_read_size/max_read_timing;
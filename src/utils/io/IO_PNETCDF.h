@@ -6,6 +6,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <shared/kokkos_shared.h>
 //class HydroParams;
@@ -27,9 +28,31 @@
 }
 
 #include "IO_common.h"
+#include "IO_staging.h"
 
 namespace ppkMHD { namespace io {
 
+// =======================================================
+// =======================================================
+/**
+ * Name of variable ivar in PnetCDF files.
+ */
+inline const char* pnetcdf_variable_name(int ivar)
+{
+  static const char* names[8] = {"rho", "E", "rho_vx", "rho_vy", "rho_vz", "Bx", "By", "Bz"};
+  return names[ivar];
+}
+
+// =======================================================
+// =======================================================
+/**
+ * MPI datatype of staging buffers (i.e. real_storage_t).
+ */
+inline MPI_Datatype pnetcdf_memory_datatype()
+{
+  return (sizeof(real_storage_t) == sizeof(float)) ? MPI_FLOAT : MPI_DOUBLE;
+}
+
 // =======================================================
 // =======================================================
 /**
@@ -51,63 +74,15 @@ public:
 	       const std::map<int, std::string>& variables_names,
 	       int iStep,
 	       real_t totalTime,
-	       std::string debug_name) :
+	       std::string debug_name,
+	       StagingBuffer* staging = nullptr) :
     Udata(Udata), Uhost(Uhost), params(params), configMap(configMap),
     nbvar(nbvar), variables_names(variables_names),
-    iStep(iStep), totalTime(totalTime), debug_name(debug_name)
+    iStep(iStep), totalTime(totalTime), debug_name(debug_name),
+    staging(staging ? staging : &local_staging)
   {};
   ~Save_PNETCDF() {};
 
-  template<DimensionType d_ = d>
-  void copy_buffer(typename std::enable_if<d_==TWO_D, real_t>::type *&data,
-		   int iStop, int jStop, int kStop, int iVar, KokkosLayout layout)
-  {
-    if (layout == KOKKOS_LAYOUT_RIGHT) { // transpose array to make data contiguous in memory
-      int dI=0;
-      for (int j= 0; j < jStop; j++) {
-	for(int i = 0; i < iStop; i++) {
-	  data[dI] = Uhost(i,j,iVar);
-	  dI++;
-	}
-      }
-    } else {
-      //data = Uhost.data() + isize*jsize*nvar;
-      int dI=0;
-      for(int i = 0; i < iStop; i++) {
-	for (int j= 0; j < jStop; j++) {
-	  data[dI] = Uhost(i,j,iVar);
-	  dI++;
-	}
-      }
-    }
-
-  } // copy_buffer
-
-  template<DimensionType d_=d>
-  void copy_buffer(typename std::enable_if<d_==THREE_D, real_t>::type *&data,
-		   int iStop, int jStop, int kStop, int iVar, KokkosLayout layout)
-  {
-    if (layout == KOKKOS_LAYOUT_RIGHT) { // transpose array to make data contiguous in memory
- 
-      int dI=0;
-      for (int k= 0; k < kStop; k++)
-	for (int j= 0; j < jStop; j++)
-	  for(int i = 0; i < iStop; i++) {
-	    data[dI] = Uhost(i,j,k,iVar);
-	    dI++;
-	  }
-    } else {
-      //data = Uhost.data() + isize*jsize*ksize*nvar;
-      int dI=0;
-      for(int i = 0; i < iStop; i++)
-	for (int j= 0; j < jStop; j++)
-	  for (int k= 0; k < kStop; k++) {
-	    data[dI] = Uhost(i,j,k,iVar);
-	    dI++;
-	  }
-    }
-
-  } // copy_buffer / 3D
   
   // =======================================================
   // =======================================================
@@ -126,6 +101,12 @@ public:
    * All MPI pieces are written in the same file with parallel
    * IO (MPI pieces are directly re-assembled by Parallel-netCDF library).
    *
+   * All variables are packed on device into a single staging buffer,
+   * copied to host at once, and posted as non-blocking requests
+   * (ncmpi_iput_vara, or ncmpi_bput_vara if [output] pnetcdf_bput is
+   * true) flushed by a single collective ncmpi_wait_all. MPI-IO hints
+   * are read from section [output], see mpi_io_hints.
+   *
    * \param[in] U A reference to a hydro simulation HostArray
    * \param[in] nStep The current time step, used to label results filename. 
    *
@@ -145,11 +126,6 @@ public:
     const int my = params.my;
     const int mz = params.mz;
 
-    // sub-domaine sizes with ghost cells
-    const int isize = params.isize;
-    const int jsize = params.jsize;
-    const int ksize = params.ksize;
-
     const int ghostWidth = params.ghostWidth;
 
     const int dimType = params.dimType;
@@ -226,17 +202,9 @@ public:
     std::string ncFilename     = outputPrefix+"_"+outNum.str()+".nc";
     std::string ncFilenameFull = outputDir+"/"+ncFilename;
 
-    // copy device data to host
-    Kokkos::deep_copy(Uhost, Udata);
+    // use buffered non-blocking writes ?
+    const bool use_bput = configMap.getBool("output","pnetcdf_bput",false);
 
-    // here we need to check Uhost memory layout
-    KokkosLayout layout;
-    if (std::is_same<typename DataArray::array_layout, Kokkos::LayoutLeft>::value)
-      layout = KOKKOS_LAYOUT_LEFT;
-    else
-      layout = KOKKOS_LAYOUT_RIGHT;
-
-    
     // measure time ??
     if (pnetcdf_verbose) {
       MPI_Barrier(params.communicator->getComm());
@@ -246,9 +214,12 @@ public:
     /* 
      * Create NetCDF file
      */
+    MPI_Info mpi_info = mpi_io_hints(configMap);
     err = ncmpi_create(params.communicator->getComm(), ncFilenameFull.c_str(), 
 		       ncCreationMode,
-                       MPI_INFO_NULL, &ncFileId);
+                       mpi_info, &ncFileId);
+    if (mpi_info != MPI_INFO_NULL)
+      MPI_Info_free(&mpi_info);
     if (err != NC_NOERR) {
       printf("Error: ncmpi_create() file %s (%s)\n",ncFilenameFull.c_str(),ncmpi_strerror(err));
       MPI_Abort(params.communicator->getComm(), -1);
@@ -290,58 +261,15 @@ public:
     nc_type ncDataType;
     MPI_Datatype mpiDataType;
 
-    if (sizeof(real_t) == sizeof(float)) {
-      ncDataType  = NC_FLOAT;
-      mpiDataType = MPI_FLOAT;
-    } else {
-      ncDataType  = NC_DOUBLE;
-      mpiDataType = MPI_DOUBLE;
-    }
-    
-    if (dimType==TWO_D) {
-      err = ncmpi_def_var(ncFileId, "rho", ncDataType, 2, dimIds, &varIds[ID]);
-      PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "E", ncDataType, 2, dimIds, &varIds[IP]);
-      PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "rho_vx", ncDataType, 2, dimIds, &varIds[IU]);
-      PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "rho_vy", ncDataType, 2, dimIds, &varIds[IV]);
-      PNETCDF_HANDLE_ERROR;
-
-      if (mhdEnabled) {
-	err = ncmpi_def_var(ncFileId, "rho_vz", ncDataType, 2, dimIds, &varIds[IW]);
-	PNETCDF_HANDLE_ERROR;
-	err = ncmpi_def_var(ncFileId, "Bx", ncDataType, 2, dimIds, &varIds[IA]);
-	PNETCDF_HANDLE_ERROR;
-	err = ncmpi_def_var(ncFileId, "By", ncDataType, 2, dimIds, &varIds[IB]);
-	PNETCDF_HANDLE_ERROR;
-	err = ncmpi_def_var(ncFileId, "Bz", ncDataType, 2, dimIds, &varIds[IC]);
-	PNETCDF_HANDLE_ERROR;
-      }
-      
-    } else { // THREE_D
+    // memory type is real_storage_t (staging buffer), file type may differ
+    mpiDataType = pnetcdf_memory_datatype();
+    ncDataType = output_double_precision(configMap) ? NC_DOUBLE : NC_FLOAT;
 
-      err = ncmpi_def_var(ncFileId, "rho", ncDataType, 3, dimIds, &varIds[ID]);
-      PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "E", ncDataType, 3, dimIds, &varIds[IP]);
-      PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "rho_vx", ncDataType, 3, dimIds, &varIds[IU]);
+    for (int iVar=0; iVar<nbvar; iVar++) {
+      err = ncmpi_def_var(ncFileId, pnetcdf_variable_name(iVar), ncDataType,
+			  dimType==TWO_D ? 2 : 3, dimIds, &varIds[iVar]);
       PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "rho_vy", ncDataType, 3, dimIds, &varIds[IV]);
-      PNETCDF_HANDLE_ERROR;
-      err = ncmpi_def_var(ncFileId, "rho_vz", ncDataType, 3, dimIds, &varIds[IW]);
-      PNETCDF_HANDLE_ERROR;
-
-      if (mhdEnabled) {
-	err = ncmpi_def_var(ncFileId, "Bx", ncDataType, 3, dimIds, &varIds[IA]);
-	PNETCDF_HANDLE_ERROR;
-	err = ncmpi_def_var(ncFileId, "By", ncDataType, 3, dimIds, &varIds[IB]);
-	PNETCDF_HANDLE_ERROR;
-	err = ncmpi_def_var(ncFileId, "Bz", ncDataType, 3, dimIds, &varIds[IC]);
-	PNETCDF_HANDLE_ERROR;
-      }
-
-    } // end THREE_D
+    }
 
     /*
      * global attributes
@@ -449,11 +377,7 @@ public:
     if (dimType==THREE_D)
       nItems *= counts[IZ];
 
-    { // data need to be allocated and copied from U
-      
-      real_t* data;
-      
-      data = (real_t *) malloc(nItems*sizeof(real_t));
+    {
       
       int iStop=nx, jStop=ny, kStop=nz;
 
@@ -461,19 +385,54 @@ public:
       if (coords[IY]== my-1) jStop=ny+2*ghostWidth;
       if (coords[IZ]== mz-1) kStop=nz+2*ghostWidth;
 
+      // pack all variables on device (transposed to file order), then a
+      // single device to host copy
+      const Kokkos::Array<int,3> region_start = {{0, 0, 0}};
+      const Kokkos::Array<int,3> region_count = {{iStop, jStop, kStop}};
+
+      staging->reserve((size_t) nbvar*nItems);
+      for (int iVar=0; iVar<nbvar; iVar++)
+	PackVariableFunctor<d==TWO_D ? 2 : 3>::apply(Udata, iVar,
+						     region_start, region_count,
+						     staging->slice((size_t) iVar*nItems, nItems));
+      staging->copy_to_host((size_t) nbvar*nItems);
+
+      real_storage_t* data = staging->data_host.data();
+
+      // post one non-blocking request per variable ...
+      std::vector<int> requests(nbvar), statuses(nbvar);
+
+      if (use_bput) {
+	err = ncmpi_buffer_attach(ncFileId, (MPI_Offset) nbvar*nItems*sizeof(real_storage_t));
+	PNETCDF_HANDLE_ERROR;
+      }
+
       for (int iVar=0; iVar<nbvar; iVar++) {
-	
-	// copy needed data into data !
-	copy_buffer(data,iStop,jStop,kStop,iVar,layout);
+	if (use_bput)
+	  err = ncmpi_bput_vara(ncFileId, varIds[iVar], starts, counts,
+				data + (size_t) iVar*nItems, nItems, mpiDataType,
+				&requests[iVar]);
+	else
+	  err = ncmpi_iput_vara(ncFileId, varIds[iVar], starts, counts,
+				data + (size_t) iVar*nItems, nItems, mpiDataType,
+				&requests[iVar]);
+	PNETCDF_HANDLE_ERROR;
+      }
+
+      // ... and flush them all with a single collective operation
+      err = ncmpi_wait_all(ncFileId, nbvar, requests.data(), statuses.data());
+      PNETCDF_HANDLE_ERROR;
 
-	// write on disk
-	err = ncmpi_put_vara_all(ncFileId, varIds[iVar], starts, counts, data, nItems, mpiDataType);
+      for (int iVar=0; iVar<nbvar; iVar++) {
+	err = statuses[iVar];
 	PNETCDF_HANDLE_ERROR;
-	
-      } // end for iVar
+      }
+
+      if (use_bput) {
+	err = ncmpi_buffer_detach(ncFileId);
+	PNETCDF_HANDLE_ERROR;
+      }
 
-      free(data);
-      
     } // end non-overlap mode
     
     /* 
@@ -487,7 +446,7 @@ public:
 
       write_timing = MPI_Wtime() - write_timing;
 
-      write_size = nbvar * isize * jsize * ksize * sizeof(real_t);
+      write_size = nbvar * nItems * sizeof(real_storage_t);
       //write_size = nbvar * U.section() * sizeof(real_t);
       //write_size = U.sizeBytes();
       sum_write_size = write_size *  params.nProcs;
@@ -502,14 +461,14 @@ public:
 	       nx+2*ghostWidth,
 	       ny+2*ghostWidth,
 	       nz+2*ghostWidth,
-	       sizeof(real_t),
+	       sizeof(real_storage_t),
 	       1.0*write_size/1048576.0);
 	sum_write_size /= 1048576.0;
 	printf("Global array size %d x %d x %d reals(%zu bytes), write size = %.2f GB\n",
 	       mx*nx+2*ghostWidth,
 	       my*ny+2*ghostWidth,
 	       mz*nz+2*ghostWidth,
-	       sizeof(real_t),
+	       sizeof(real_storage_t),
 	       1.0*sum_write_size/1024);
 	
 	write_bw = sum_write_size/max_write_timing;
@@ -571,9 +530,147 @@ public:
   int iStep;
   real_t totalTime;
   std::string debug_name;
+
+  //! staging buffer (device and host), reused across outputs if provided
+  StagingBuffer  local_staging;
+  StagingBuffer* staging;
   
 }; // class Save_PNETCDF
 
+// =======================================================
+// =======================================================
+/**
+ * Load data from a Parallel-netCDF file written by Save_PNETCDF
+ * (restart).
+ *
+ * The file must have been written with the same global domain sizes;
+ * the MPI decomposition may differ. Each process reads its whole local
+ * sub-domain (ghost cells included, neighbors' ghost cells overlap), with
+ * one non-blocking request per variable flushed by a single collective
+ * ncmpi_wait_all; data is unpacked on device.
+ */
+template<DimensionType d>
+class Load_PNETCDF
+{
+public:
+  //! Decide at compile-time which data array type to use
+  using DataArray  = typename std::conditional<d==TWO_D,DataArray2d,DataArray3d>::type;
+
+  Load_PNETCDF(DataArray     Udata,
+	       HydroParams& params,
+	       ConfigMap& configMap,
+	       int nbvar,
+	       const std::map<int, std::string>& variables_names,
+	       StagingBuffer* staging = nullptr) :
+    Udata(Udata), params(params), configMap(configMap),
+    nbvar(nbvar), variables_names(variables_names),
+    iStep(0), totalTime(0),
+    staging(staging ? staging : &local_staging)
+  {};
+  ~Load_PNETCDF() {};
+
+  // =======================================================
+  // =======================================================
+  void load(std::string filename)
+  {
+
+    const int nx = params.nx;
+    const int ny = params.ny;
+    const int nz = params.nz;
+
+    const int isize = params.isize;
+    const int jsize = params.jsize;
+    const int ksize = params.ksize;
+
+    const int dimType = params.dimType;
+
+    int ncFileId;
+    int err;
+
+    int coords[3] = {0, 0, 0};
+    params.communicator->getCoords(params.myRank, dimType == TWO_D ? 2 : 3, coords);
+
+    MPI_Info mpi_info = mpi_io_hints(configMap);
+    err = ncmpi_open(params.communicator->getComm(), filename.c_str(),
+		     NC_NOWRITE, mpi_info, &ncFileId);
+    if (mpi_info != MPI_INFO_NULL)
+      MPI_Info_free(&mpi_info);
+    if (err != NC_NOERR) {
+      printf("Error: ncmpi_open() file %s (%s)\n",filename.c_str(),ncmpi_strerror(err));
+      MPI_Abort(params.communicator->getComm(), -1);
+      exit(1);
+    }
+
+    // time step and total time
+    err = ncmpi_get_att_int(ncFileId, NC_GLOBAL, "time step", &iStep);
+    PNETCDF_HANDLE_ERROR;
+    {
+      double timeValue;
+      err = ncmpi_get_att_double(ncFileId, NC_GLOBAL, "total time", &timeValue);
+      PNETCDF_HANDLE_ERROR;
+      totalTime = (real_t) timeValue;
+    }
+
+    // local sub-domain in file (dimensions are slowest first)
+    MPI_Offset starts[3], counts[3];
+    if (dimType == TWO_D) {
+      starts[0] = coords[IY]*ny; counts[0] = jsize;
+      starts[1] = coords[IX]*nx; counts[1] = isize;
+    } else {
+      starts[0] = coords[IZ]*nz; counts[0] = ksize;
+      starts[1] = coords[IY]*ny; counts[1] = jsize;
+      starts[2] = coords[IX]*nx; counts[2] = isize;
+    }
+
+    const int nItems = dimType == TWO_D ? isize*jsize : isize*jsize*ksize;
+
+    staging->reserve((size_t) nbvar*nItems);
+    real_storage_t* data = staging->data_host.data();
+
+    // post all reads, then a single collective wait
+    std::vector<int> requests(nbvar), statuses(nbvar);
+    for (int iVar=0; iVar<nbvar; iVar++) {
+      int varId;
+      err = ncmpi_inq_varid(ncFileId, pnetcdf_variable_name(iVar), &varId);
+      PNETCDF_HANDLE_ERROR;
+      err = ncmpi_iget_vara(ncFileId, varId, starts, counts,
+			    data + (size_t) iVar*nItems, nItems,
+			    pnetcdf_memory_datatype(), &requests[iVar]);
+      PNETCDF_HANDLE_ERROR;
+    }
+
+    err = ncmpi_wait_all(ncFileId, nbvar, requests.data(), statuses.data());
+    PNETCDF_HANDLE_ERROR;
+
+    err = ncmpi_close(ncFileId);
+    PNETCDF_HANDLE_ERROR;
+
+    // upload and scatter into Udata
+    staging->copy_to_device((size_t) nbvar*nItems);
+
+    const Kokkos::Array<int,3> region_start = {{0, 0, 0}};
+    const Kokkos::Array<int,3> region_count = {{isize, jsize, ksize}};
+    for (int iVar=0; iVar<nbvar; iVar++)
+      UnpackVariableFunctor<d==TWO_D ? 2 : 3>::apply(Udata, iVar,
+						     region_start, region_count,
+						     staging->slice((size_t) iVar*nItems, nItems));
+
+  } // load
+
+  DataArray     Udata;
+  HydroParams& params;
+  ConfigMap& configMap;
+  int nbvar;
+  const std::map<int, std::string>& variables_names;
+  int iStep;
+  real_t totalTime;
+
+  //! staging buffer (device and host), reused if provided
+  StagingBuffer  local_staging;
+  StagingBuffer* staging;
+
+}; // class Load_PNETCDF
+
 } // namespace io
 
 } // namespace ppkMHD
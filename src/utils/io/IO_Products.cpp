@@ -0,0 +1,497 @@
+#include "IO_Products.h"
+#include "IO_common.h"
+
+#include "shared/HydroParams.h"
+#include "utils/config/ConfigMap.h"
+
+#ifdef USE_MPI
+#include "utils/mpiUtils/MpiCommCart.h"
+#endif // USE_MPI
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace ppkMHD { namespace io {
+
+// =======================================================
+// =======================================================
+static bool isBigEndian()
+{
+  const int i = 1;
+  return ( (*(char*)&i) == 0 );
+}
+
+// =======================================================
+// =======================================================
+static std::string format_number(int value, int width)
+{
+  std::ostringstream format;
+  format.width(width);
+  format.fill('0');
+  format << value;
+  return format.str();
+}
+
+// =======================================================
+// ==== CLASS IO_Products IMPL ===========================
+// =======================================================
+
+// =======================================================
+// =======================================================
+IO_Products::IO_Products(HydroParams& params,
+			 ConfigMap& configMap,
+			 std::map<int, std::string>& variables_names) :
+  params(params),
+  configMap(configMap),
+  variables_names(variables_names),
+  m_products(),
+  m_mutex(nullptr)
+{
+
+  const int dim = params.dimType == THREE_D ? 3 : 2;
+
+  int myRank = 0;
+#ifdef USE_MPI
+  myRank = params.myRank;
+#endif // USE_MPI
+
+  // global domain sizes (interior cells)
+  int gn[3] = {params.nx, params.ny, dim==3 ? params.nz : 1};
+#ifdef USE_MPI
+  gn[0] *= params.mx;
+  gn[1] *= params.my;
+  if (dim==3)
+    gn[2] *= params.mz;
+#endif // USE_MPI
+
+  const real_t xmin[3] = {params.xmin, params.ymin, params.zmin};
+  const real_t xmax[3] = {params.xmax, params.ymax, params.zmax};
+  const real_t dx[3]   = {params.dx,   params.dy,   params.dz};
+
+  std::string products = configMap.getString("output", "products", "");
+  std::istringstream stream(products);
+  std::string name;
+  while (std::getline(stream, name, ','))
+  {
+    // remove blanks
+    name.erase(std::remove(name.begin(), name.end(), ' '), name.end());
+    if (name.empty())
+      continue;
+
+    const std::string section = "product_" + name;
+
+    Product p;
+    p.name  = name;
+    p.count = 0;
+    p.nstep  = std::max(1, configMap.getInteger(section, "nstep", 10));
+    p.stride = std::max(1, configMap.getInteger(section, "stride", 1));
+    p.average = configMap.getString(section, "downsampling", "sample") == "average";
+
+    // physical bounds to global cell indexes
+    const char* axis[3] = {"x", "y", "z"};
+    for (int d=0; d<3; ++d) {
+      p.gmin[d] = 0;
+      p.gmax[d] = gn[d];
+      if (d >= dim)
+	continue;
+
+      const real_t lo = configMap.getFloat(section, std::string(axis[d])+"min", xmin[d]);
+      const real_t hi = configMap.getFloat(section, std::string(axis[d])+"max", xmax[d]);
+      p.gmin[d] = std::max(0,     (int) std::floor((lo-xmin[d])/dx[d]));
+      p.gmax[d] = std::min(gn[d], (int) std::ceil ((hi-xmin[d])/dx[d]));
+    }
+
+    if (configMap.getString(section, "type", "subvolume") == "slice") {
+
+      const std::string normal = configMap.getString(section, "normal", "z");
+      const int d = normal == "x" ? 0 : (normal == "y" ? 1 : 2);
+
+      if (d < dim) {
+	const real_t position = configMap.getFloat(section, "position",
+						   0.5*(xmin[d]+xmax[d]));
+	int g = (int) std::floor((position-xmin[d])/dx[d]);
+	g = std::min(std::max(g, 0), gn[d]-1);
+	p.gmin[d] = g;
+	p.gmax[d] = g+1;
+      }
+    }
+
+    // selected variables
+    std::istringstream vstream(configMap.getString(section, "variables", "all"));
+    std::string token;
+    while (std::getline(vstream, token, ','))
+    {
+      token.erase(std::remove(token.begin(), token.end(), ' '), token.end());
+
+      for (int ivar=0; ivar<params.nbvar; ++ivar) {
+	if ( (token == "all" or token == variables_names[ivar]) and
+	     std::find(p.vars.begin(), p.vars.end(), ivar) == p.vars.end() )
+	  p.vars.push_back(ivar);
+      }
+    }
+    std::sort(p.vars.begin(), p.vars.end());
+
+    bool empty = p.vars.empty();
+    for (int d=0; d<dim; ++d)
+      empty = empty or (p.gmax[d] <= p.gmin[d]);
+
+    if (empty) {
+      if (myRank == 0)
+	std::cerr << "IO_Products: product " << name << " is empty, ignored\n";
+      continue;
+    }
+
+    // variable list used by the extraction kernel
+    p.vars_device = ExtractProductFunctor<3>::IndexArray("product_vars", p.vars.size());
+    auto vars_host = Kokkos::create_mirror_view(p.vars_device);
+    for (size_t v=0; v<p.vars.size(); ++v)
+      vars_host(v) = p.vars[v];
+    Kokkos::deep_copy(p.vars_device, vars_host);
+
+    m_products.push_back(p);
+
+  } // end while products
+
+} // IO_Products::IO_Products
+
+// =======================================================
+// =======================================================
+bool IO_Products::local_extent(const Product& p,
+			       const int coords[3],
+			       ProductExtent& ext) const
+{
+
+  const int dim = params.dimType == THREE_D ? 3 : 2;
+  const int gw = params.ghostWidth;
+  const int stride = p.stride;
+
+  // local sub-domain sizes
+  const int nloc[3] = {params.nx, params.ny, params.nz};
+
+  ext.stride  = stride;
+  ext.average = p.average ? 1 : 0;
+
+  for (int d=0; d<3; ++d) {
+
+    if (d >= dim) {
+      ext.n[d] = 1;
+      ext.offset[d] = 0;
+      ext.first[d] = 0;
+      ext.last[d] = 1;
+      continue;
+    }
+
+    // global interior indexes owned by this sub-domain
+    const int lo = coords[d]*nloc[d];
+    const int hi = lo + nloc[d];
+
+    // number of output cells, and the range of those whose first fine
+    // cell lies in [lo,hi)
+    const int N    = (p.gmax[d]-p.gmin[d]+stride-1)/stride;
+    const int c_lo = lo <= p.gmin[d] ? 0 : (lo-p.gmin[d]+stride-1)/stride;
+    const int c_hi = hi <= p.gmin[d] ? 0 : std::min(N, (hi-p.gmin[d]+stride-1)/stride);
+
+    if (c_hi <= c_lo)
+      return false;
+
+    ext.n[d]      = c_hi - c_lo;
+    ext.offset[d] = c_lo;
+    ext.first[d]  = p.gmin[d] + c_lo*stride - lo + gw;
+    ext.last[d]   = std::min(p.gmax[d], hi) - lo + gw;
+  }
+
+  return true;
+
+} // IO_Products::local_extent
+
+// =======================================================
+// =======================================================
+void IO_Products::save(DataArray2d Udata, int iteration, real_t time)
+{
+
+  std::unique_lock<std::mutex> lock;
+  if (m_mutex)
+    lock = std::unique_lock<std::mutex>(*m_mutex);
+
+  for (auto& p : m_products)
+    if (iteration % p.nstep == 0)
+      save_product<2>(p, Udata, time);
+
+} // IO_Products::save
+
+// =======================================================
+// =======================================================
+void IO_Products::save(DataArray3d Udata, int iteration, real_t time)
+{
+
+  std::unique_lock<std::mutex> lock;
+  if (m_mutex)
+    lock = std::unique_lock<std::mutex>(*m_mutex);
+
+  for (auto& p : m_products)
+    if (iteration % p.nstep == 0)
+      save_product<3>(p, Udata, time);
+
+} // IO_Products::save
+
+// =======================================================
+// =======================================================
+template<int dim>
+void IO_Products::save_product(Product& p,
+			       typename ExtractProductFunctor<dim>::DataArray Udata,
+			       real_t time)
+{
+
+  std::string outputDir    = configMap.getString("output", "outputDir", "./");
+  std::string outputPrefix = configMap.getString("output", "outputPrefix", "output");
+
+  int coords[3] = {0, 0, 0};
+#ifdef USE_MPI
+  coords[0] = params.myMpiPos[0];
+  coords[1] = params.myMpiPos[1];
+  coords[2] = dim==3 ? params.myMpiPos[2] : 0;
+#endif // USE_MPI
+
+#ifdef USE_MPI
+  const std::string pieceBase = outputPrefix + "_" + p.name + "_time" + format_number(p.count, 7);
+
+  if (params.myRank == 0)
+    write_header(p, outputDir + "/" + pieceBase + ".pvti", pieceBase);
+
+  const std::string filename = outputDir + "/" + pieceBase +
+    "_mpi" + format_number(params.myRank, 5) + ".vti";
+#else
+  const std::string filename = outputDir + "/" + outputPrefix + "_" + p.name +
+    "_" + format_number(p.count, 7) + ".vti";
+#endif // USE_MPI
+
+  p.count++;
+
+  // processes not intersecting the product have nothing to do
+  ProductExtent ext;
+  if (!local_extent(p, coords, ext))
+    return;
+
+  // staging buffer is only reallocated when growing
+  const size_t size = p.vars.size()*ext.n[0]*ext.n[1]*ext.n[2];
+  if (m_buffer.extent(0) < size) {
+    m_buffer      = ExtractProductFunctor<3>::BufferArray("product_buffer", size);
+    m_buffer_host = Kokkos::create_mirror_view(m_buffer);
+  }
+
+  ExtractProductFunctor<dim>::apply(Udata, ext, p.vars_device, m_buffer);
+
+  // only the reduced data is transferred to host
+  const auto range = std::make_pair((size_t) 0, size);
+  Kokkos::deep_copy(Kokkos::subview(m_buffer_host, range),
+		    Kokkos::subview(m_buffer,      range));
+
+  write_piece(p, ext, coords, filename, time);
+
+} // IO_Products::save_product
+
+// =======================================================
+// =======================================================
+void IO_Products::write_piece(const Product& p,
+			      const ProductExtent& ext,
+			      const int coords[3],
+			      std::string filename,
+			      real_t time)
+{
+
+  const int dim = params.dimType == THREE_D ? 3 : 2;
+
+  // check scalar data type
+  const bool useDouble = output_double_precision(configMap);
+  const size_t wordSize = useDouble ? sizeof(double) : sizeof(float);
+
+  const int nCells = ext.n[0]*ext.n[1]*ext.n[2];
+  const int nbvar = p.vars.size();
+
+  const real_t xmin[3] = {params.xmin, params.ymin, params.zmin};
+  const real_t dx[3]   = {params.dx,   params.dy,   params.dz};
+
+  // whole product extent, origin and spacing
+  int    N[3];
+  real_t origin[3];
+  real_t spacing[3];
+  for (int d=0; d<3; ++d) {
+    N[d]       = (p.gmax[d]-p.gmin[d]+p.stride-1)/p.stride;
+    origin[d]  = d<dim ? xmin[d] + p.gmin[d]*dx[d] : 0;
+    spacing[d] = d<dim ? dx[d]*(p.gmax[d]-p.gmin[d] > 1 ? p.stride : 1) : ZERO_F;
+  }
+  if (dim==2)
+    N[2] = 0;
+
+  std::fstream outFile;
+  outFile.open(filename.c_str(), std::ios_base::out);
+
+  // write xml data header
+  if (isBigEndian()) {
+    outFile << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+  } else {
+    outFile << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+  }
+
+  // write mesh extent
+  outFile << "  <ImageData WholeExtent=\""
+	  << 0 << " " << N[0] << " "
+	  << 0 << " " << N[1] << " "
+	  << 0 << " " << N[2] << "\" "
+	  << "Origin=\""
+	  << origin[0] << " " << origin[1] << " " << origin[2] << "\" "
+	  << "Spacing=\""
+	  << spacing[0] << " " << spacing[1] << " " << spacing[2] << "\">\n";
+
+  outFile << "  <FieldData>\n";
+  outFile << "    <DataArray type=\"Float64\" Name=\"TIME\" NumberOfTuples=\"1\" format=\"ascii\">"
+	  << time << "</DataArray>\n";
+  outFile << "  </FieldData>\n";
+
+  outFile << "  <Piece Extent=\""
+	  << ext.offset[0] << " " << ext.offset[0]+ext.n[0] << " "
+	  << ext.offset[1] << " " << ext.offset[1]+ext.n[1] << " "
+	  << ext.offset[2] << " " << (dim==3 ? ext.offset[2]+ext.n[2] : 0)
+	  << "\">\n";
+
+  outFile << "    <PointData>\n";
+  outFile << "    </PointData>\n";
+
+  outFile << "    <CellData>" << std::endl;
+
+  for (int v=0; v<nbvar; v++) {
+    if (useDouble) {
+      outFile << "     <DataArray type=\"Float64\" Name=\"" ;
+    } else {
+      outFile << "     <DataArray type=\"Float32\" Name=\"" ;
+    }
+    outFile << variables_names.at(p.vars[v])
+	    << "\" format=\"appended\" offset=\""
+	    << v*nCells*wordSize+v*sizeof(unsigned int)
+	    <<"\" />" << std::endl;
+  }
+
+  outFile << "    </CellData>" << std::endl;
+  outFile << "  </Piece>" << std::endl;
+  outFile << "  </ImageData>" << std::endl;
+
+  outFile << "  <AppendedData encoding=\"raw\">" << std::endl;
+
+  // write the leading undescore
+  outFile << "_";
+
+  // then write heavy data, already in VTK order in the staging buffer
+  {
+    unsigned int nbOfWords = nCells*wordSize;
+    std::vector<double> tmp_d(useDouble ? nCells : 0);
+    std::vector<float>  tmp_f(useDouble ? 0 : nCells);
+
+    for (int v=0; v<nbvar; v++) {
+      outFile.write((char *)&nbOfWords,sizeof(unsigned int));
+      if (useDouble) {
+	for (int index=0; index<nCells; ++index)
+	  tmp_d[index] = m_buffer_host(v*nCells+index);
+	outFile.write((char *)tmp_d.data(), nbOfWords);
+      } else {
+	for (int index=0; index<nCells; ++index)
+	  tmp_f[index] = m_buffer_host(v*nCells+index);
+	outFile.write((char *)tmp_f.data(), nbOfWords);
+      }
+    }
+  }
+
+  outFile << "  </AppendedData>" << std::endl;
+  outFile << "</VTKFile>" << std::endl;
+
+  outFile.close();
+
+} // IO_Products::write_piece
+
+#ifdef USE_MPI
+// =======================================================
+// =======================================================
+void IO_Products::write_header(const Product& p,
+			       std::string filename,
+			       std::string pieceBase)
+{
+
+  const int dim = params.dimType == THREE_D ? 3 : 2;
+  const int nProcs = params.nProcs;
+
+  // check scalar data type
+  const bool useDouble = output_double_precision(configMap);
+
+  const real_t xmin[3] = {params.xmin, params.ymin, params.zmin};
+  const real_t dx[3]   = {params.dx,   params.dy,   params.dz};
+
+  int    N[3];
+  real_t origin[3];
+  real_t spacing[3];
+  for (int d=0; d<3; ++d) {
+    N[d]       = (p.gmax[d]-p.gmin[d]+p.stride-1)/p.stride;
+    origin[d]  = d<dim ? xmin[d] + p.gmin[d]*dx[d] : 0;
+    spacing[d] = d<dim ? dx[d]*(p.gmax[d]-p.gmin[d] > 1 ? p.stride : 1) : ZERO_F;
+  }
+  if (dim==2)
+    N[2] = 0;
+
+  std::fstream outHeader;
+  outHeader.open (filename.c_str(), std::ios_base::out);
+
+  outHeader << "<?xml version=\"1.0\"?>" << std::endl;
+  if (isBigEndian())
+    outHeader << "<VTKFile type=\"PImageData\" version=\"0.1\" byte_order=\"BigEndian\">" << std::endl;
+  else
+    outHeader << "<VTKFile type=\"PImageData\" version=\"0.1\" byte_order=\"LittleEndian\">" << std::endl;
+  outHeader << "  <PImageData WholeExtent=\"";
+  outHeader << 0 << " " << N[0] << " ";
+  outHeader << 0 << " " << N[1] << " ";
+  outHeader << 0 << " " << N[2] << "\" GhostLevel=\"0\" "
+	    << "Origin=\""
+	    << origin[0] << " " << origin[1] << " " << origin[2] << "\" "
+	    << "Spacing=\""
+	    << spacing[0] << " " << spacing[1] << " " << spacing[2] << "\">"
+	    << std::endl;
+  outHeader << "    <PCellData Scalars=\"Scalars_\">" << std::endl;
+  for (size_t v=0; v<p.vars.size(); v++) {
+    if (useDouble)
+      outHeader << "      <PDataArray type=\"Float64\" Name=\""<< variables_names.at(p.vars[v])<<"\"/>" << std::endl;
+    else
+      outHeader << "      <PDataArray type=\"Float32\" Name=\""<< variables_names.at(p.vars[v])<<"\"/>" << std::endl;
+  }
+  outHeader << "    </PCellData>" << std::endl;
+
+  // one piece per MPI process intersecting the product
+  for (int iPiece=0; iPiece<nProcs; ++iPiece) {
+
+    int coords[3] = {0, 0, 0};
+    params.communicator->getCoords(iPiece,dim,coords);
+
+    ProductExtent ext;
+    if (!local_extent(p, coords, ext))
+      continue;
+
+    outHeader << "    <Piece Extent=\""
+	      << ext.offset[0] << " " << ext.offset[0]+ext.n[0] << " "
+	      << ext.offset[1] << " " << ext.offset[1]+ext.n[1] << " "
+	      << ext.offset[2] << " " << (dim==3 ? ext.offset[2]+ext.n[2] : 0)
+	      << "\" Source=\""
+	      << pieceBase << "_mpi" << format_number(iPiece, 5) << ".vti"
+	      << "\"/>" << std::endl;
+  }
+
+  outHeader << "  </PImageData>" << std::endl;
+  outHeader << "</VTKFile>" << std::endl;
+
+  outHeader.close();
+
+} // IO_Products::write_header
+#endif // USE_MPI
+
+} // namespace io
+
+} // namespace ppkMHD
@@ -0,0 +1,235 @@
+/**
+ * \file IO_Products.h
+ * \brief Reduced-volume outputs (slices, subvolumes, downsampling, subset
+ * of variables), extracted on device and written as VTK image data.
+ */
+#ifndef IO_PRODUCTS_H_
+#define IO_PRODUCTS_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <type_traits>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+
+struct HydroParams;
+class ConfigMap;
+
+namespace ppkMHD { namespace io {
+
+/**
+ * Part of a product owned by the current MPI process, as seen by device
+ * code.
+ *
+ * The product is a grid of n[0] x n[1] x n[2] output cells; output cell c
+ * along direction d starts at local array index first[d] + c*stride
+ * (ghost cells included) and covers fine cells up to last[d] (excluded).
+ */
+struct ProductExtent
+{
+  int n[3];
+  int offset[3]; //!< global index of the first output cell (host side only)
+  int first[3];
+  int last[3];
+  int stride;
+  int average; //!< 1: average fine cells of each block, 0: take the first one
+}; // struct ProductExtent
+
+/**
+ * Copy the selected variables of a product from Udata into a compact
+ * device buffer: variable after variable, i index fastest (VTK order).
+ */
+template<int dim>
+class ExtractProductFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  using IndexArray  = Kokkos::View<int*, Device>;
+  using BufferArray = Kokkos::View<real_t*, Device>;
+
+  ExtractProductFunctor(DataArray     Udata,
+			ProductExtent ext,
+			IndexArray    vars,
+			BufferArray   buffer) :
+    Udata(Udata), ext(ext), vars(vars), buffer(buffer)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(DataArray     Udata,
+		    ProductExtent ext,
+		    IndexArray    vars,
+		    BufferArray   buffer)
+  {
+    ExtractProductFunctor<dim> functor(Udata, ext, vars, buffer);
+    Kokkos::parallel_for("ExtractProductFunctor", ext.n[0]*ext.n[1]*ext.n[2], functor);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==2, int>::type i,
+	     int j, int k, int ivar) const
+  {
+    return Udata(i,j,ivar);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  real_t get(typename std::enable_if<dim_==3, int>::type i,
+	     int j, int k, int ivar) const
+  {
+    return Udata(i,j,k,ivar);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const int& index) const
+  {
+    const int nCells = ext.n[0]*ext.n[1]*ext.n[2];
+
+    const int ci = index % ext.n[0];
+    const int cj = (index / ext.n[0]) % ext.n[1];
+    const int ck = index / (ext.n[0]*ext.n[1]);
+
+    // first fine cell of the block
+    const int i0 = ext.first[0] + ci*ext.stride;
+    const int j0 = ext.first[1] + cj*ext.stride;
+    const int k0 = ext.first[2] + ck*ext.stride;
+
+    // last fine cell of the block (excluded)
+    int i1 = i0+1, j1 = j0+1, k1 = k0+1;
+    if (ext.average) {
+      i1 = i0+ext.stride < ext.last[0] ? i0+ext.stride : ext.last[0];
+      j1 = j0+ext.stride < ext.last[1] ? j0+ext.stride : ext.last[1];
+      k1 = k0+ext.stride < ext.last[2] ? k0+ext.stride : ext.last[2];
+    }
+
+    const real_t scale = ONE_F / ((i1-i0)*(j1-j0)*(k1-k0));
+
+    for (int v=0; v<(int) vars.extent(0); ++v) {
+
+      const int ivar = vars(v);
+
+      real_t value = 0;
+      for (int k=k0; k<k1; ++k)
+	for (int j=j0; j<j1; ++j)
+	  for (int i=i0; i<i1; ++i)
+	    value += get(i,j,k,ivar);
+
+      buffer(v*nCells + index) = value*scale;
+
+    }
+
+  } // operator ()
+
+  DataArray     Udata;
+  ProductExtent ext;
+  IndexArray    vars;
+  BufferArray   buffer;
+
+}; // ExtractProductFunctor
+
+/**
+ * Reduced-volume output products.
+ *
+ * Products are listed in section [output], parameter products (comma
+ * separated names); each product is configured in its own section
+ * [product_<name>]:
+ * - nstep: number of time steps between two outputs (default 10)
+ * - type: subvolume (default) or slice
+ * - slice: normal (x, y or z, default z) and position (physical
+ *   coordinate, default domain center)
+ * - subvolume: xmin, xmax, ymin, ymax, zmin, zmax (physical coordinates,
+ *   default whole domain)
+ * - stride: downsampling factor (default 1)
+ * - downsampling: sample (default, first cell of each block) or average
+ * - variables: comma separated variable names (default all)
+ *
+ * Each product is extracted on device into a compact buffer; only that
+ * buffer is copied to host. With MPI, each process writes the part of the
+ * product it owns (a block belongs to the process owning its first cell),
+ * processes that do not intersect the product skip IO entirely, and rank
+ * 0 writes a pvti header. Averaged blocks straddling an MPI sub-domain
+ * boundary only average the cells owned by that process.
+ *
+ * Output file: outputDir/outputPrefix_<name>_<count>.vti (serial) or
+ * outputDir/outputPrefix_<name>_time<count>.pvti (MPI).
+ */
+class IO_Products
+{
+
+public:
+  IO_Products(HydroParams& params,
+	      ConfigMap& configMap,
+	      std::map<int, std::string>& variables_names);
+
+  //! is there at least one product ?
+  bool enabled() const { return !m_products.empty(); }
+
+  //! write every product due at this iteration
+  void save(DataArray2d Udata, int iteration, real_t time);
+  void save(DataArray3d Udata, int iteration, real_t time);
+
+  //! lock held while writing (nullptr, the default, for no locking)
+  void set_mutex(std::mutex* mutex) { m_mutex = mutex; }
+
+private:
+  //! a single output product
+  struct Product
+  {
+    std::string name;
+    int nstep;
+    int stride;
+    bool average;
+    int gmin[3]; //!< first global cell (interior indexes)
+    int gmax[3]; //!< last global cell (excluded)
+    std::vector<int> vars;
+    ExtractProductFunctor<3>::IndexArray vars_device;
+    int count; //!< number of outputs already written
+  };
+
+  HydroParams& params;
+  ConfigMap& configMap;
+
+  //! names of variables (inherited from Solver)
+  std::map<int, std::string>& variables_names;
+
+  std::vector<Product> m_products;
+
+  //! see set_mutex
+  std::mutex* m_mutex;
+
+  //! device staging buffer and its host mirror, reused across outputs
+  ExtractProductFunctor<3>::BufferArray m_buffer;
+  ExtractProductFunctor<3>::BufferArray::HostMirror m_buffer_host;
+
+  //! compute the part of product p owned by MPI process of coordinates
+  //! coords; returns false if empty
+  bool local_extent(const Product& p, const int coords[3], ProductExtent& ext) const;
+
+  template<int dim>
+  void save_product(Product& p,
+		    typename ExtractProductFunctor<dim>::DataArray Udata,
+		    real_t time);
+
+  void write_piece(const Product& p,
+		   const ProductExtent& ext,
+		   const int coords[3],
+		   std::string filename,
+		   real_t time);
+
+#ifdef USE_MPI
+  void write_header(const Product& p, std::string filename, std::string pieceBase);
+#endif // USE_MPI
+
+}; // class IO_Products
+
+} // namespace io
+
+} // namespace ppkMHD
+
+#endif // IO_PRODUCTS_H_
@@ -88,10 +88,10 @@ void IO_ReadWrite::save_data_impl(DataArray2d             Udata,
   if (hdf5_enabled) {
     
 #ifdef USE_MPI
-    ppkMHD::io::Save_HDF5_mpi<TWO_D> writer(Udata, Uhost, params, configMap, HYDRO_2D_NBVAR, variables_names, iStep, time, debug_name);
+    ppkMHD::io::Save_HDF5_mpi<TWO_D> writer(Udata, Uhost, params, configMap, HYDRO_2D_NBVAR, variables_names, iStep, time, debug_name, &staging_buffer);
     writer.save();
 #else
-    ppkMHD::io::Save_HDF5<TWO_D> writer(Udata, Uhost, params, configMap, HYDRO_2D_NBVAR, variables_names, iStep, time, debug_name);
+    ppkMHD::io::Save_HDF5<TWO_D> writer(Udata, Uhost, params, configMap, HYDRO_2D_NBVAR, variables_names, iStep, time, debug_name, &staging_buffer);
     writer.save();
 #endif // USE_MPI
     
@@ -100,7 +100,7 @@ void IO_ReadWrite::save_data_impl(DataArray2d             Udata,
 
 #ifdef USE_PNETCDF
   if (pnetcdf_enabled) {
-    ppkMHD::io::Save_PNETCDF<TWO_D> writer(Udata, Uhost, params, configMap, HYDRO_2D_NBVAR, variables_names, iStep, time, debug_name);
+    ppkMHD::io::Save_PNETCDF<TWO_D> writer(Udata, Uhost, params, configMap, params.nbvar, variables_names, iStep, time, debug_name, &staging_buffer);
     writer.save();    
   }
 #endif // USE_PNETCDF
@@ -130,10 +130,10 @@ void IO_ReadWrite::save_data_impl(DataArray3d             Udata,
   if (hdf5_enabled) {
 
 #ifdef USE_MPI
-    ppkMHD::io::Save_HDF5_mpi<THREE_D> writer(Udata, Uhost, params, configMap, HYDRO_3D_NBVAR, variables_names, iStep, time, debug_name);
+    ppkMHD::io::Save_HDF5_mpi<THREE_D> writer(Udata, Uhost, params, configMap, HYDRO_3D_NBVAR, variables_names, iStep, time, debug_name, &staging_buffer);
     writer.save();
 #else
-    ppkMHD::io::Save_HDF5<THREE_D> writer(Udata, Uhost, params, configMap, HYDRO_3D_NBVAR, variables_names, iStep, time, debug_name);
+    ppkMHD::io::Save_HDF5<THREE_D> writer(Udata, Uhost, params, configMap, HYDRO_3D_NBVAR, variables_names, iStep, time, debug_name, &staging_buffer);
     writer.save();
 #endif // USE_MPI
     
@@ -142,7 +142,7 @@ void IO_ReadWrite::save_data_impl(DataArray3d             Udata,
 
 #ifdef USE_PNETCDF
   if (pnetcdf_enabled) {
-    ppkMHD::io::Save_PNETCDF<THREE_D> writer(Udata, Uhost, params, configMap, HYDRO_2D_NBVAR, variables_names, iStep, time, debug_name);
+    ppkMHD::io::Save_PNETCDF<THREE_D> writer(Udata, Uhost, params, configMap, params.nbvar, variables_names, iStep, time, debug_name, &staging_buffer);
     writer.save();    
   }
 #endif // USE_PNETCDF
@@ -214,6 +214,18 @@ void IO_ReadWrite::load_data_impl(DataArray2d             Udata,
     
   }
 #endif // USE_HDF5
+
+#ifdef USE_PNETCDF
+  if (pnetcdf_enabled and isNcdf) {
+
+    ppkMHD::io::Load_PNETCDF<TWO_D> reader(Udata, params, configMap, params.nbvar, variables_names, &staging_buffer);
+    reader.load(inputFilename);
+
+    iStep = reader.iStep;
+    time = reader.totalTime;
+
+  }
+#endif // USE_PNETCDF
   
 } // IO_ReadWrite::load_data_impl - 2d
 
@@ -261,6 +273,18 @@ void IO_ReadWrite::load_data_impl(DataArray3d             Udata,
   }
 #endif // USE_HDF5
 
+#ifdef USE_PNETCDF
+  if (pnetcdf_enabled and isNcdf) {
+
+    ppkMHD::io::Load_PNETCDF<THREE_D> reader(Udata, params, configMap, params.nbvar, variables_names, &staging_buffer);
+    reader.load(inputFilename);
+
+    iStep = reader.iStep;
+    time = reader.totalTime;
+
+  }
+#endif // USE_PNETCDF
+
 } // IO_ReadWrite::load_data_impl - 3d
 
 
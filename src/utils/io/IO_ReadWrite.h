@@ -11,6 +11,7 @@
 #include <utils/config/ConfigMap.h>
 
 #include "IO_ReadWriteBase.h"
+#include "IO_staging.h"
 
 namespace ppkMHD { namespace io {
 
@@ -89,6 +90,9 @@ public:
   bool vtk_enabled;
   bool hdf5_enabled;
   bool pnetcdf_enabled;
+
+  //! device/host staging buffer reused by HDF5 and PnetCDF IO
+  StagingBuffer staging_buffer;
   
 }; // class IO_ReadWrite
 
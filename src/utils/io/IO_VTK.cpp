@@ -1,9 +1,14 @@
 #include "IO_VTK.h"
+#include "IO_common.h"
 
 #include "shared/HydroParams.h"
 #include "utils/config/ConfigMap.h"
 
 #include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring> // for memcpy
+#include <algorithm> // for std::min
 
 namespace ppkMHD { namespace io {
 
@@ -58,11 +63,8 @@ void save_VTK_2D(DataArray2d             Udata,
   bool outputVtkAscii = configMap.getBool("output", "outputVtkAscii", false);
 
   // check scalar data type
-  bool useDouble = false;
-
-  if (sizeof(real_t) == sizeof(double)) {
-    useDouble = true;
-  }
+  const bool useDouble = output_double_precision(configMap);
+  const size_t wordSize = useDouble ? sizeof(double) : sizeof(float);
   
   // write iStep in string stepNum
   std::ostringstream stepNum;
@@ -160,7 +162,7 @@ void save_VTK_2D(DataArray2d             Udata,
       }
       outFile << variables_names.at(iVar)
 	      << "\" format=\"appended\" offset=\""
-	      << iVar*nx*ny*sizeof(real_t)+iVar*sizeof(unsigned int)
+	      << iVar*nx*ny*wordSize+iVar*sizeof(unsigned int)
 	      <<"\" />" << std::endl;
     }
 
@@ -174,13 +176,18 @@ void save_VTK_2D(DataArray2d             Udata,
     outFile << "_";
     // then write heavy data (column major format)
     {
-      unsigned int nbOfWords = nx*ny*sizeof(real_t);
+      unsigned int nbOfWords = nx*ny*wordSize;
       for (int iVar=0; iVar<nbvar; iVar++) {
 	outFile.write((char *)&nbOfWords,sizeof(unsigned int));
 	for (int j=jmin+ghostWidth; j<=jmax-ghostWidth; j++)
 	  for (int i=imin+ghostWidth; i<=imax-ghostWidth; i++) {
-	    real_t tmp = Uhost(i, j, iVar);
-	    outFile.write((char *)&tmp,sizeof(real_t));
+	    if (useDouble) {
+	      double tmp = Uhost(i, j, iVar);
+	      outFile.write((char *)&tmp,sizeof(double));
+	    } else {
+	      float tmp = Uhost(i, j, iVar);
+	      outFile.write((char *)&tmp,sizeof(float));
+	    }
 	  }
       }
     }
@@ -248,11 +255,8 @@ void save_VTK_3D(DataArray3d             Udata,
   bool outputVtkAscii = configMap.getBool("output", "outputVtkAscii", false);
 
   // check scalar data type
-  bool useDouble = false;
-
-  if (sizeof(real_t) == sizeof(double)) {
-    useDouble = true;
-  }
+  const bool useDouble = output_double_precision(configMap);
+  const size_t wordSize = useDouble ? sizeof(double) : sizeof(float);
   
   // write iStep in string stepNum
   std::ostringstream stepNum;
@@ -352,7 +356,7 @@ void save_VTK_3D(DataArray3d             Udata,
       }
       outFile << variables_names.at(iVar)
 	      << "\" format=\"appended\" offset=\""
-	      << iVar*nx*ny*nz*sizeof(real_t)+iVar*sizeof(unsigned int)
+	      << iVar*nx*ny*nz*wordSize+iVar*sizeof(unsigned int)
 	      <<"\" />" << std::endl;
     }
 
@@ -367,14 +371,19 @@ void save_VTK_3D(DataArray3d             Udata,
 
     // then write heavy data (column major format)
     {
-      unsigned int nbOfWords = nx*ny*nz*sizeof(real_t);
+      unsigned int nbOfWords = nx*ny*nz*wordSize;
       for (int iVar=0; iVar<nbvar; iVar++) {
 	outFile.write((char *)&nbOfWords,sizeof(unsigned int));
 	 for (int k=kmin+ghostWidth; k<=kmax-ghostWidth; k++)
 	   for (int j=jmin+ghostWidth; j<=jmax-ghostWidth; j++)
 	     for (int i=imin+ghostWidth; i<=imax-ghostWidth; i++) {
-	       real_t tmp = Uhost(i, j, k, iVar);
-	       outFile.write((char *)&tmp,sizeof(real_t));
+	       if (useDouble) {
+	         double tmp = Uhost(i, j, k, iVar);
+	         outFile.write((char *)&tmp,sizeof(double));
+	       } else {
+	         float tmp = Uhost(i, j, k, iVar);
+	         outFile.write((char *)&tmp,sizeof(float));
+	       }
 	     }
       }
     }
@@ -389,6 +398,189 @@ void save_VTK_3D(DataArray3d             Udata,
 } // end save_VTK_3D
 
 #ifdef USE_MPI
+// =======================================================
+// =======================================================
+/**
+ * Number of MPI processes sharing a single aggregated .vti file.
+ *
+ * Aggregation is enabled with [output] vtk_aggregate_writers = M (number
+ * of files per output, 0 means one file per process). Processes are
+ * grouped by consecutive rank; only binary output is aggregated.
+ *
+ * \return 1 when aggregation is disabled
+ */
+static int vtk_aggregation_group_size(HydroParams& params, ConfigMap& configMap)
+{
+  const int nProcs = params.nProcs;
+  const int nWriters = configMap.getInteger("output", "vtk_aggregate_writers", 0);
+
+  if (nWriters <= 0 or nWriters >= nProcs or
+      configMap.getBool("output", "outputVtkAscii", false))
+    return 1;
+
+  return (nProcs + nWriters - 1) / nWriters;
+
+} // vtk_aggregation_group_size
+
+// =======================================================
+// =======================================================
+/**
+ * Write the pieces of a group of MPI processes into a single .vti file.
+ *
+ * Each process provides its interior data already converted to the output
+ * scalar type (variable after variable, i index fastest). The first rank of
+ * the group writes the file : one Piece element per process of the group,
+ * then the appended data, receiving the other pieces one after the other,
+ * so that memory usage never exceeds one extra piece. Other ranks only send.
+ *
+ * \param[in] piece local interior data (raw bytes)
+ * \param[in] filename aggregated file name
+ * \param[in] groupSize number of MPI processes per file
+ */
+static void write_vti_aggregated(std::vector<char>& piece,
+				 HydroParams& params,
+				 ConfigMap& configMap,
+				 int nbvar,
+				 const std::map<int, std::string>& variables_names,
+				 std::string filename,
+				 int groupSize)
+{
+
+  const int tag = 317;
+
+  const int myRank = params.myRank;
+  const int first  = (myRank / groupSize) * groupSize;
+  const int last   = std::min(first + groupSize, params.nProcs);
+
+  if (myRank != first) {
+    params.communicator->send(piece.data(), piece.size(), hydroSimu::MpiComm::CHAR,
+			      first, tag);
+    return;
+  }
+
+  const int dimType = params.dimType;
+  const int nDim = dimType == TWO_D ? 2 : 3;
+
+  const int nx = params.nx;
+  const int ny = params.ny;
+  const int nz = dimType == THREE_D ? params.nz : 0;
+
+  const real_t dx = params.dx;
+  const real_t dy = params.dy;
+  const real_t dz = dimType == THREE_D ? params.dz : 0.0;
+
+  const bool useDouble = output_double_precision(configMap);
+
+  // every piece has the same size
+  const unsigned int nbOfWords = piece.size() / nbvar;
+
+  std::fstream outFile;
+  outFile.open(filename.c_str(), std::ios_base::out);
+
+  if (isBigEndian()) {
+    outFile << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+  } else {
+    outFile << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+  }
+
+  // the whole extent is the global domain, each piece lists its own extent
+  outFile << "  <ImageData WholeExtent=\""
+	  << 0 << " " << params.mx*nx << " "
+	  << 0 << " " << params.my*ny << " "
+	  << 0 << " " << (dimType == THREE_D ? params.mz*nz : 0) << "\" "
+	  << "Origin=\""
+	  << params.xmin << " " << params.ymin << " " << params.zmin << "\" "
+	  << "Spacing=\""
+	  << dx << " " << dy << " " << dz << "\">\n";
+
+  for (int rank=first; rank<last; ++rank) {
+
+    int coords[3] = {0, 0, 0};
+    params.communicator->getCoords(rank,nDim,coords);
+
+    outFile << "  <Piece Extent=\""
+	    << coords[0]*nx << " " << coords[0]*nx+nx << " "
+	    << coords[1]*ny << " " << coords[1]*ny+ny << " "
+	    << coords[2]*nz << " " << coords[2]*nz+nz << "\">\n";
+
+    outFile << "    <CellData>" << std::endl;
+
+    for (int iVar=0; iVar<nbvar; iVar++) {
+      if (useDouble) {
+	outFile << "     <DataArray type=\"Float64\" Name=\"" ;
+      } else {
+	outFile << "     <DataArray type=\"Float32\" Name=\"" ;
+      }
+      outFile << variables_names.at(iVar)
+	      << "\" format=\"appended\" offset=\""
+	      << ((size_t) (rank-first)*nbvar+iVar)*(nbOfWords+sizeof(unsigned int))
+	      <<"\" />" << std::endl;
+    }
+
+    outFile << "    </CellData>" << std::endl;
+    outFile << "  </Piece>" << std::endl;
+
+  } // end for rank
+
+  outFile << "  </ImageData>" << std::endl;
+
+  outFile << "  <AppendedData encoding=\"raw\">" << std::endl;
+
+  // write the leading undescore
+  outFile << "_";
+
+  // then write heavy data, piece after piece
+  std::vector<char> remote;
+  for (int rank=first; rank<last; ++rank) {
+
+    char* data = piece.data();
+
+    if (rank != first) {
+      remote.resize(piece.size());
+      params.communicator->recv(remote.data(), remote.size(), hydroSimu::MpiComm::CHAR,
+				rank, tag);
+      data = remote.data();
+    }
+
+    for (int iVar=0; iVar<nbvar; iVar++) {
+      outFile.write((char *)&nbOfWords,sizeof(unsigned int));
+      outFile.write(data + (size_t) iVar*nbOfWords, nbOfWords);
+    }
+
+  } // end for rank
+
+  outFile << "  </AppendedData>" << std::endl;
+  outFile << "</VTKFile>" << std::endl;
+
+  outFile.close();
+
+} // write_vti_aggregated
+
+// =======================================================
+// =======================================================
+/**
+ * Aggregated file name of the group of MPI processes rank belongs to.
+ */
+static std::string vtk_aggregated_filename(std::string outputPrefix,
+					   int iStep,
+					   int rank,
+					   int groupSize)
+{
+
+  std::ostringstream timeFormat;
+  timeFormat.width(7);
+  timeFormat.fill('0');
+  timeFormat << iStep;
+
+  std::ostringstream groupFormat;
+  groupFormat.width(5);
+  groupFormat.fill('0');
+  groupFormat << rank / groupSize;
+
+  return outputPrefix+"_time"+timeFormat.str()+"_agg"+groupFormat.str()+".vti";
+
+} // vtk_aggregated_filename
+
 // =======================================================
 // =======================================================
 void save_VTK_2D_mpi(DataArray2d             Udata,
@@ -438,11 +630,8 @@ void save_VTK_2D_mpi(DataArray2d             Udata,
   bool outputVtkAscii = configMap.getBool("output", "outputVtkAscii", false);
 
   // check scalar data type
-  bool useDouble = false;
-
-  if (sizeof(real_t) == sizeof(double)) {
-    useDouble = true;
-  }
+  const bool useDouble = output_double_precision(configMap);
+  const size_t wordSize = useDouble ? sizeof(double) : sizeof(float);
   
   // write iStep in string timeFormat
   std::ostringstream timeFormat;
@@ -467,6 +656,49 @@ void save_VTK_2D_mpi(DataArray2d             Udata,
   std::string headerFilename   = outputDir+"/"+outputPrefix+"_time"+timeFormat.str()+".pvti";
 
   
+  // aggregated output: groups of MPI processes share a single file
+  const int groupSize = vtk_aggregation_group_size(params, configMap);
+  if (groupSize > 1) {
+
+    if (params.myRank == 0) {
+      write_pvti_header(headerFilename,
+			outputPrefix,
+			params,
+			configMap,
+			nbvar,
+			variables_names,
+			iStep,
+			groupSize);
+    }
+
+    // local interior data, already in the output scalar type
+    std::vector<char> piece(nbvar*nx*ny*wordSize);
+    char* ptr = piece.data();
+    for (int iVar=0; iVar<nbvar; iVar++)
+      for (int j=jmin+ghostWidth; j<=jmax-ghostWidth; j++)
+	for (int i=imin+ghostWidth; i<=imax-ghostWidth; i++) {
+	  if (useDouble) {
+	    double tmp = Uhost(i, j, iVar);
+	    memcpy(ptr, &tmp, sizeof(double));
+	  } else {
+	    float tmp = Uhost(i, j, iVar);
+	    memcpy(ptr, &tmp, sizeof(float));
+	  }
+	  ptr += wordSize;
+	}
+
+    std::string aggPrefix = debug_name.empty() ? outputPrefix : outputPrefix+"_"+debug_name;
+    write_vti_aggregated(piece,
+			 params,
+			 configMap,
+			 nbvar,
+			 variables_names,
+			 outputDir+"/"+vtk_aggregated_filename(aggPrefix, iStep, params.myRank, groupSize),
+			 groupSize);
+    return;
+
+  }
+
   // open file 
   std::fstream outFile;
   outFile.open(filename.c_str(), std::ios_base::out);
@@ -476,6 +708,7 @@ void save_VTK_2D_mpi(DataArray2d             Udata,
     write_pvti_header(headerFilename,
 		      outputPrefix,
 		      params,
+		      configMap,
 		      nbvar,
 		      variables_names,
 		      iStep);
@@ -560,7 +793,7 @@ void save_VTK_2D_mpi(DataArray2d             Udata,
       }
       outFile << variables_names.at(iVar)
 	      << "\" format=\"appended\" offset=\""
-	      << iVar*nx*ny*sizeof(real_t)+iVar*sizeof(unsigned int)
+	      << iVar*nx*ny*wordSize+iVar*sizeof(unsigned int)
 	      <<"\" />" << std::endl;
     }
 
@@ -574,13 +807,18 @@ void save_VTK_2D_mpi(DataArray2d             Udata,
     outFile << "_";
     // then write heavy data (column major format)
     {
-      unsigned int nbOfWords = nx*ny*sizeof(real_t);
+      unsigned int nbOfWords = nx*ny*wordSize;
       for (int iVar=0; iVar<nbvar; iVar++) {
 	outFile.write((char *)&nbOfWords,sizeof(unsigned int));
 	for (int j=jmin+ghostWidth; j<=jmax-ghostWidth; j++)
 	  for (int i=imin+ghostWidth; i<=imax-ghostWidth; i++) {
-	    real_t tmp = Uhost(i, j, iVar);
-	    outFile.write((char *)&tmp,sizeof(real_t));
+	    if (useDouble) {
+	      double tmp = Uhost(i, j, iVar);
+	      outFile.write((char *)&tmp,sizeof(double));
+	    } else {
+	      float tmp = Uhost(i, j, iVar);
+	      outFile.write((char *)&tmp,sizeof(float));
+	    }
 	  }
       }
     }
@@ -654,11 +892,8 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
   bool outputVtkAscii = configMap.getBool("output", "outputVtkAscii", false);
 
   // check scalar data type
-  bool useDouble = false;
-
-  if (sizeof(real_t) == sizeof(double)) {
-    useDouble = true;
-  }
+  const bool useDouble = output_double_precision(configMap);
+  const size_t wordSize = useDouble ? sizeof(double) : sizeof(float);
   
   // write iStep in string timeFormat
   std::ostringstream timeFormat;
@@ -683,6 +918,50 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
   std::string headerFilename   = outputDir+"/"+outputPrefix+"_time"+timeFormat.str()+".pvti";
 
   
+  // aggregated output: groups of MPI processes share a single file
+  const int groupSize = vtk_aggregation_group_size(params, configMap);
+  if (groupSize > 1) {
+
+    if (params.myRank == 0) {
+      write_pvti_header(headerFilename,
+			outputPrefix,
+			params,
+			configMap,
+			nbvar,
+			variables_names,
+			iStep,
+			groupSize);
+    }
+
+    // local interior data, already in the output scalar type
+    std::vector<char> piece(nbvar*nx*ny*nz*wordSize);
+    char* ptr = piece.data();
+    for (int iVar=0; iVar<nbvar; iVar++)
+      for (int k=kmin+ghostWidth; k<=kmax-ghostWidth; k++)
+	for (int j=jmin+ghostWidth; j<=jmax-ghostWidth; j++)
+	  for (int i=imin+ghostWidth; i<=imax-ghostWidth; i++) {
+	    if (useDouble) {
+	      double tmp = Uhost(i, j, k, iVar);
+	      memcpy(ptr, &tmp, sizeof(double));
+	    } else {
+	      float tmp = Uhost(i, j, k, iVar);
+	      memcpy(ptr, &tmp, sizeof(float));
+	    }
+	    ptr += wordSize;
+	  }
+
+    std::string aggPrefix = debug_name.empty() ? outputPrefix : outputPrefix+"_"+debug_name;
+    write_vti_aggregated(piece,
+			 params,
+			 configMap,
+			 nbvar,
+			 variables_names,
+			 outputDir+"/"+vtk_aggregated_filename(aggPrefix, iStep, params.myRank, groupSize),
+			 groupSize);
+    return;
+
+  }
+
   // open file 
   std::fstream outFile;
   outFile.open(filename.c_str(), std::ios_base::out);
@@ -692,6 +971,7 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
     write_pvti_header(headerFilename,
 		      outputPrefix,
 		      params,
+		      configMap,
 		      nbvar,
 		      variables_names,
 		      iStep);
@@ -778,7 +1058,7 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
       }
       outFile << variables_names.at(iVar)
 	      << "\" format=\"appended\" offset=\""
-	      << iVar*nx*ny*nz*sizeof(real_t)+iVar*sizeof(unsigned int)
+	      << iVar*nx*ny*nz*wordSize+iVar*sizeof(unsigned int)
 	      <<"\" />" << std::endl;
     }
 
@@ -792,14 +1072,19 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
     outFile << "_";
     // then write heavy data (column major format)
     {
-      unsigned int nbOfWords = nx*ny*nz*sizeof(real_t);
+      unsigned int nbOfWords = nx*ny*nz*wordSize;
       for (int iVar=0; iVar<nbvar; iVar++) {
 	outFile.write((char *)&nbOfWords,sizeof(unsigned int));
 	for (int k=kmin+ghostWidth; k<=kmax-ghostWidth; k++) {
 	  for (int j=jmin+ghostWidth; j<=jmax-ghostWidth; j++) {
 	    for (int i=imin+ghostWidth; i<=imax-ghostWidth; i++) {
-	      real_t tmp = Uhost(i, j, k, iVar);
-	      outFile.write((char *)&tmp,sizeof(real_t));
+	      if (useDouble) {
+	        double tmp = Uhost(i, j, k, iVar);
+	        outFile.write((char *)&tmp,sizeof(double));
+	      } else {
+	        float tmp = Uhost(i, j, k, iVar);
+	        outFile.write((char *)&tmp,sizeof(float));
+	      }
 	    } // for i
 	  } // for j
 	} // for k
@@ -823,9 +1108,11 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
 void write_pvti_header(std::string headerFilename,
 		       std::string outputPrefix,
 		       HydroParams& params,
+		       ConfigMap& configMap,
 		       int nbvar,
 		       const std::map<int, std::string>& varNames,
-		       int iStep)
+		       int iStep,
+		       int aggregateGroupSize)
 {
   // file handler
   std::fstream outHeader;
@@ -835,11 +1122,7 @@ void write_pvti_header(std::string headerFilename,
   std::string compressor("");
   
   // check scalar data type
-  bool useDouble = false;
-  
-  if (sizeof(real_t) == sizeof(double)) {
-    useDouble = true;
-  }
+  const bool useDouble = output_double_precision(configMap);
   
   const int dimType = params.dimType;
   const int nProcs = params.nProcs;
@@ -897,7 +1180,9 @@ void write_pvti_header(std::string headerFilename,
       pieceFormat.width(5);
       pieceFormat.fill('0');
       pieceFormat << iPiece;
-      std::string pieceFilename   = outputPrefix+"_time"+timeFormat.str()+"_mpi"+pieceFormat.str()+".vti";
+      std::string pieceFilename   = aggregateGroupSize > 1 ?
+	vtk_aggregated_filename(outputPrefix, iStep, iPiece, aggregateGroupSize) :
+	outputPrefix+"_time"+timeFormat.str()+"_mpi"+pieceFormat.str()+".vti";
       // get MPI coords corresponding to MPI rank iPiece
       int coords[2];
       params.communicator->getCoords(iPiece,2,coords);
@@ -922,7 +1207,9 @@ void write_pvti_header(std::string headerFilename,
       pieceFormat.width(5);
       pieceFormat.fill('0');
       pieceFormat << iPiece;
-      std::string pieceFilename   = outputPrefix+"_time"+timeFormat.str()+"_mpi"+pieceFormat.str()+".vti";
+      std::string pieceFilename   = aggregateGroupSize > 1 ?
+	vtk_aggregated_filename(outputPrefix, iStep, iPiece, aggregateGroupSize) :
+	outputPrefix+"_time"+timeFormat.str()+"_mpi"+pieceFormat.str()+".vti";
       // get MPI coords corresponding to MPI rank iPiece
       int coords[3];
       params.communicator->getCoords(iPiece,3,coords);
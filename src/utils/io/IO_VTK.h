@@ -76,13 +76,18 @@ void save_VTK_3D_mpi(DataArray3d             Udata,
  * Write Parallel VTI header. 
  * Must be done by a single MPI process.
  *
+ * \param[in] aggregateGroupSize number of MPI processes per aggregated
+ * .vti file (see [output] vtk_aggregate_writers); 1 means one file per
+ * process.
  */
 void write_pvti_header(std::string headerFilename,
 		       std::string outputPrefix,
 		       HydroParams& params,
+		       ConfigMap& configMap,
 		       int nbvar,
 		       const std::map<int, std::string>& varNames,
-		       int iStep);
+		       int iStep,
+		       int aggregateGroupSize = 1);
 #endif // USE_MPI
 
 } // namespace io
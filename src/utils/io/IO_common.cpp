@@ -1,9 +1,14 @@
 #include <ctime>   // for std::time_t, std::tm, std::localtime
+#include <cstdlib> // for exit
+#include <iostream>
 #include <sstream>
 #include <iomanip> // for std::put_time (only g++ >= 5)
 
 #include "IO_common.h"
 
+#include "shared/real_type.h"
+#include "utils/config/ConfigMap.h"
+
 namespace ppkMHD { namespace io {
 
 // =======================================================
@@ -37,6 +42,64 @@ std::string current_date()
 
 } // current_date
 
+// =======================================================
+// =======================================================
+bool output_double_precision(ConfigMap& configMap)
+{
+
+  const std::string default_precision =
+    sizeof(real_storage_t) == sizeof(double) ? "double" : "float";
+
+  const std::string precision =
+    configMap.getString("output", "precision", default_precision);
+
+  if (precision != "float" and precision != "double")
+  {
+    std::cerr << "[output] precision must be float or double, not "
+              << precision << "\n";
+    exit(EXIT_FAILURE);
+  }
+
+  return precision == "double";
+
+} // output_double_precision
+
+#ifdef USE_MPI
+// =======================================================
+// =======================================================
+MPI_Info mpi_io_hints(ConfigMap& configMap)
+{
+
+  // ini parameter name, MPI-IO hint name
+  const char* hints[5][2] = {
+    {"mpiio_cb_nodes",        "cb_nodes"},
+    {"mpiio_cb_buffer_size",  "cb_buffer_size"},
+    {"mpiio_romio_cb_write",  "romio_cb_write"},
+    {"mpiio_striping_factor", "striping_factor"},
+    {"mpiio_striping_unit",   "striping_unit"}
+  };
+
+  MPI_Info info = MPI_INFO_NULL;
+
+  for (int n=0; n<5; ++n) {
+
+    const std::string value = configMap.getString("output", hints[n][0], "");
+
+    if (value.empty())
+      continue;
+
+    if (info == MPI_INFO_NULL)
+      MPI_Info_create(&info);
+
+    MPI_Info_set(info, const_cast<char*>(hints[n][1]), const_cast<char*>(value.c_str()));
+
+  }
+
+  return info;
+
+} // mpi_io_hints
+#endif // USE_MPI
+
 } // namespace io
 
 } // namespace ppkMHD
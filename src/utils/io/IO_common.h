@@ -3,6 +3,12 @@
 
 #include <string>
 
+#ifdef USE_MPI
+#include <mpi.h>
+#endif // USE_MPI
+
+class ConfigMap;
+
 namespace ppkMHD { namespace io {
 
 // =======================================================
@@ -12,6 +18,39 @@ namespace ppkMHD { namespace io {
  */
 std::string current_date();
 
+// =======================================================
+// =======================================================
+/**
+ * Floating point precision used in output files.
+ *
+ * Read parameter "precision" in section [output] ("float" or "double").
+ * Default is the precision used to store data arrays (real_storage_t).
+ * Any other value aborts the run.
+ *
+ * \return true if data must be written in double precision.
+ */
+bool output_double_precision(ConfigMap& configMap);
+
+#ifdef USE_MPI
+// =======================================================
+// =======================================================
+/**
+ * MPI-IO hints used by parallel writers/readers (HDF5, PnetCDF).
+ *
+ * Read in section [output] (all optional, MPI-IO defaults are used when
+ * not set):
+ * - mpiio_cb_nodes:        number of collective buffering aggregators
+ * - mpiio_cb_buffer_size:  collective buffer size in bytes
+ * - mpiio_romio_cb_write:  enable, disable or automatic
+ * - mpiio_striping_factor: file stripe count (Lustre / GPFS)
+ * - mpiio_striping_unit:   file stripe size in bytes
+ *
+ * \return MPI_INFO_NULL if no hint is given, else a new MPI_Info object
+ * that must be released with MPI_Info_free by the caller.
+ */
+MPI_Info mpi_io_hints(ConfigMap& configMap);
+#endif // USE_MPI
+
 } // namespace io
 
 } // namespace ppkMHD
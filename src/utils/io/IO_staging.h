@@ -0,0 +1,202 @@
+/**
+ * \file IO_staging.h
+ * \brief Device-side packing (unpacking) of output (input) data through
+ * a reusable staging buffer, so that only the bytes actually written
+ * (read) cross the host/device boundary.
+ */
+#ifndef IO_STAGING_H_
+#define IO_STAGING_H_
+
+#include <type_traits>
+
+#include "shared/kokkos_shared.h"
+#include "shared/real_type.h"
+
+namespace ppkMHD { namespace io {
+
+/**
+ * A contiguous device buffer and its host mirror.
+ *
+ * Meant to be owned by a long-lived object (e.g. IO_ReadWrite) and
+ * handed to writers, so that it is only reallocated when an output
+ * needs more room than the previous one.
+ */
+struct StagingBuffer
+{
+  using Array     = Kokkos::View<real_storage_t*, Device>;
+  using ArrayHost = Array::HostMirror;
+
+  Array     data;
+  ArrayHost data_host;
+
+  //! make sure the buffer can hold at least size values
+  void reserve(size_t size)
+  {
+    if (data.extent(0) < size) {
+      data      = Array("io_staging_buffer", size);
+      data_host = Kokkos::create_mirror_view(data);
+    }
+  }
+
+  //! copy the first size values from device to host
+  void copy_to_host(size_t size)
+  {
+    const auto range = std::make_pair((size_t) 0, size);
+    Kokkos::deep_copy(Kokkos::subview(data_host, range),
+		      Kokkos::subview(data,      range));
+  }
+
+  //! copy the first size values from host to device
+  void copy_to_device(size_t size)
+  {
+    const auto range = std::make_pair((size_t) 0, size);
+    Kokkos::deep_copy(Kokkos::subview(data,      range),
+		      Kokkos::subview(data_host, range));
+  }
+
+  //! device view on values [offset, offset+size)
+  Array slice(size_t offset, size_t size) const
+  {
+    return Kokkos::subview(data, std::make_pair(offset, offset+size));
+  }
+
+}; // struct StagingBuffer
+
+/**
+ * Pack one variable of a sub-block of Udata into a contiguous buffer,
+ * i index fastest (i.e. C order for dimensions (k,j,i) as used by HDF5
+ * and PnetCDF), whatever the memory layout of Udata.
+ *
+ * The sub-block starts at array index start[] (ghost cells included)
+ * and has count[] cells along each direction; start[2] and count[2] are
+ * ignored in 2D.
+ */
+template<int dim>
+class PackVariableFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  PackVariableFunctor(DataArray            Udata,
+		      int                  ivar,
+		      Kokkos::Array<int,3> start,
+		      Kokkos::Array<int,3> count,
+		      StagingBuffer::Array buffer) :
+    Udata(Udata), ivar(ivar), start(start), count(count), buffer(buffer)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(DataArray            Udata,
+		    int                  ivar,
+		    Kokkos::Array<int,3> start,
+		    Kokkos::Array<int,3> count,
+		    StagingBuffer::Array buffer)
+  {
+    if (dim==2)
+      count[2] = 1;
+
+    PackVariableFunctor<dim> functor(Udata, ivar, start, count, buffer);
+    Kokkos::parallel_for("PackVariableFunctor", count[0]*count[1]*count[2], functor);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  {
+    const int j = index / count[0];
+    const int i = index - j*count[0];
+
+    buffer(index) = Udata(start[0]+i, start[1]+j, ivar);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  {
+    const int ij = count[0]*count[1];
+    const int k  = index / ij;
+    const int j  = (index - k*ij) / count[0];
+    const int i  = index - j*count[0] - k*ij;
+
+    buffer(index) = Udata(start[0]+i, start[1]+j, start[2]+k, ivar);
+  }
+
+  DataArray            Udata;
+  int                  ivar;
+  Kokkos::Array<int,3> start;
+  Kokkos::Array<int,3> count;
+  StagingBuffer::Array buffer;
+
+}; // PackVariableFunctor
+
+/**
+ * Reverse of PackVariableFunctor: scatter a contiguous buffer (i index
+ * fastest) into one variable of a sub-block of Udata.
+ */
+template<int dim>
+class UnpackVariableFunctor
+{
+
+public:
+  //! Decide at compile-time which data array to use
+  using DataArray = typename std::conditional<dim==2,DataArray2d,DataArray3d>::type;
+
+  UnpackVariableFunctor(DataArray            Udata,
+			int                  ivar,
+			Kokkos::Array<int,3> start,
+			Kokkos::Array<int,3> count,
+			StagingBuffer::Array buffer) :
+    Udata(Udata), ivar(ivar), start(start), count(count), buffer(buffer)
+  {};
+
+  // static method which does it all: create and execute functor
+  static void apply(DataArray            Udata,
+		    int                  ivar,
+		    Kokkos::Array<int,3> start,
+		    Kokkos::Array<int,3> count,
+		    StagingBuffer::Array buffer)
+  {
+    if (dim==2)
+      count[2] = 1;
+
+    UnpackVariableFunctor<dim> functor(Udata, ivar, start, count, buffer);
+    Kokkos::parallel_for("UnpackVariableFunctor", count[0]*count[1]*count[2], functor);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==2, int>::type& index) const
+  {
+    const int j = index / count[0];
+    const int i = index - j*count[0];
+
+    Udata(start[0]+i, start[1]+j, ivar) = buffer(index);
+  }
+
+  template<int dim_ = dim>
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const typename std::enable_if<dim_==3, int>::type& index) const
+  {
+    const int ij = count[0]*count[1];
+    const int k  = index / ij;
+    const int j  = (index - k*ij) / count[0];
+    const int i  = index - j*count[0] - k*ij;
+
+    Udata(start[0]+i, start[1]+j, start[2]+k, ivar) = buffer(index);
+  }
+
+  DataArray            Udata;
+  int                  ivar;
+  Kokkos::Array<int,3> start;
+  Kokkos::Array<int,3> count;
+  StagingBuffer::Array buffer;
+
+}; // UnpackVariableFunctor
+
+} // namespace io
+
+} // namespace ppkMHD
+
+#endif // IO_STAGING_H_
@@ -214,6 +214,32 @@ namespace hydroSimu {
     //mutex_.unlock();
   }
 
+  // =======================================================
+  // =======================================================
+  void MpiComm::scatter(void* sendBuf, int sendCount, int sendType,
+			void* recvBuf, int recvCount, int recvType,
+			int root) const
+  {
+    //mutex_.lock();
+    {
+      MPI_Datatype mpiSendType = getDataType(sendType);
+      MPI_Datatype mpiRecvType = getDataType(recvType);
+
+      if (mpiIsRunning())
+	{
+	  /* test whether errors have been detected on another proc before
+	   * doing the collective operation. */
+	  POLL_FOR_FAILURES(*this);
+	  /* if we're to this point, all processors are OK */
+
+	  errCheck(::MPI_Scatter(sendBuf, sendCount, mpiSendType,
+				 recvBuf, recvCount, mpiRecvType,
+				 root, comm_), "Scatter");
+	}
+    }
+    //mutex_.unlock();
+  }
+
   // =======================================================
   // =======================================================
   void MpiComm::gatherv(void* sendBuf, int sendCount, int sendType,
@@ -120,6 +120,11 @@ namespace hydroSimu
                   void* recvBuf, int recvCount, int recvType,
                   int root) const ;
 
+      //! Scatter from root
+      void scatter(void* sendBuf, int sendCount, int sendType,
+                   void* recvBuf, int recvCount, int recvType,
+                   int root) const ;
+
       //! Gather variable-sized arrays to root 
       void gatherv(void* sendBuf, int sendCount, int sendType,
                    void* recvBuf, int* recvCount, int* displacements, 
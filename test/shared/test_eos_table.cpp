@@ -0,0 +1,215 @@
+/**
+ * This executable is used to test and benchmark the tabulated equation
+ * of state (struct EosTable, see shared/EosTable.h).
+ *
+ * An ideal gas table is built (bilinear interpolation in log space is
+ * exact in that case), then:
+ * - lookup and inversion errors are measured against the analytic ideal
+ *   gas on random states (inside and outside of the table bounds); the
+ *   inversion guided by the inverse table must match the bisection,
+ * - lookup and inversion throughput is compared to the ideal gas
+ *   formulas.
+ *
+ * Usage: test_eos_table [n_states] [table_size]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "shared/real_type.h"
+#include "shared/kokkos_shared.h"
+#include "shared/EosTable.h"
+
+using DataArray1d = Kokkos::View<real_t*, Device>;
+
+constexpr real_t gamma0 = 1.4;
+
+/*
+ * random log-uniform value in [10^lmin, 10^lmax] (hash of the index)
+ */
+KOKKOS_INLINE_FUNCTION
+real_t random_value(int index, int seed, real_t lmin, real_t lmax)
+{
+  unsigned int h = index * 2654435761u + seed * 40503u;
+  h ^= h >> 15; h *= 2246822519u; h ^= h >> 13;
+  const real_t x = (h & 0xFFFFFF) / (real_t) 0xFFFFFF;
+  return pow(10.0, lmin + x*(lmax-lmin));
+}
+
+/*
+ * run a kernel nrepeat times, return the number of states processed per
+ * second
+ */
+template<class Kernel>
+double benchmark(const char* name, int n, int nrepeat, Kernel kernel)
+{
+
+  real_t sum = 0;
+
+  // warm up
+  Kokkos::parallel_reduce(name, n, kernel, sum);
+
+  Kokkos::Timer timer;
+  for (int r=0; r<nrepeat; ++r)
+    Kokkos::parallel_reduce(name, n, kernel, sum);
+  Kokkos::fence();
+  const double rate = 1.0 * n * nrepeat / timer.seconds();
+
+  printf("%-24s : %10.2f Mstates/s (checksum %g)\n", name, rate*1e-6, sum);
+
+  return rate;
+
+} // benchmark
+
+// =======================================================
+// =======================================================
+int main(int argc, char* argv[])
+{
+
+  Kokkos::initialize(argc, argv);
+
+  int status = EXIT_SUCCESS;
+
+  {
+
+    const int n          = argc > 1 ? atoi(argv[1]) : 1<<22;
+    const int table_size = argc > 2 ? atoi(argv[2]) : 128;
+    const int nrepeat    = 10;
+
+    std::cout << "##########################\n";
+    std::cout << "Tabulated EOS test : " << n << " states, table "
+              << table_size << "x" << table_size << "\n";
+    std::cout << "##########################\n";
+
+    /*
+     * ideal gas table, rho and eint in [1e-3,1e3]
+     */
+    const real_t rho_min  = 1e-3, rho_max  = 1e3;
+    const real_t eint_min = 1e-3, eint_max = 1e3;
+
+    std::vector<real_t> nodes;
+    eos_table_fill_ideal_gas(nodes, table_size, table_size,
+                             rho_min, rho_max, eint_min, eint_max, gamma0);
+
+    EosTable table;
+    table.data          = nodes.data();
+    table.n_rho         = table_size;
+    table.n_eint        = table_size;
+    table.log_rho_min   = log(rho_min);
+    table.log_eint_min  = log(eint_min);
+    table.inv_dlog_rho  = (table_size-1) / log(rho_max/rho_min);
+    table.inv_dlog_eint = (table_size-1) / log(eint_max/eint_min);
+
+    // inverse table, built on host
+    table.n_p = 2*table_size;
+    std::vector<real_t> inv_nodes;
+    eos_table_fill_inverse(table, table.n_p, inv_nodes,
+                           table.log_p_min, table.inv_dlog_p);
+
+    DataArray1d table_data("table_data", nodes.size() + inv_nodes.size());
+    DataArray1d::HostMirror table_data_host = Kokkos::create_mirror_view(table_data);
+    for (size_t k=0; k<nodes.size(); ++k)
+      table_data_host(k) = nodes[k];
+    for (size_t k=0; k<inv_nodes.size(); ++k)
+      table_data_host(nodes.size()+k) = inv_nodes[k];
+    Kokkos::deep_copy(table_data, table_data_host);
+
+    table.data     = table_data.data();
+    table.inv_data = table_data.data() + nodes.size();
+
+    // same table, inversion by bisection only
+    EosTable table_bisection = table;
+    table_bisection.inv_data = nullptr;
+
+    /*
+     * random states, one decade beyond the table bounds (extrapolation)
+     */
+    DataArray1d rho("rho", n), eint("eint", n), pres("pres", n);
+    Kokkos::parallel_for("init_states", n, KOKKOS_LAMBDA(const int& i) {
+        rho(i)  = random_value(i, 1, -4.0, 4.0);
+        eint(i) = random_value(i, 2, -4.0, 4.0);
+        pres(i) = (gamma0-1) * rho(i) * eint(i);
+      });
+
+    /*
+     * accuracy
+     */
+    real_t err_p = 0, err_c = 0, err_e = 0, err_x = 0;
+    Kokkos::parallel_reduce("eos_errors", n, KOKKOS_LAMBDA(const int& i,
+                                                           real_t& ep,
+                                                           real_t& ec,
+                                                           real_t& ee,
+                                                           real_t& ex) {
+        real_t p, c2;
+        table.lookup(rho(i), eint(i), p, c2);
+        const real_t e  = table.eint_from_pressure(rho(i), pres(i));
+        const real_t ez = table_bisection.eint_from_pressure(rho(i), pres(i));
+
+        const real_t c2_exact = gamma0 * pres(i) / rho(i);
+
+        ep = fmax(ep, fabs(p  - pres(i)) / pres(i));
+        ec = fmax(ec, fabs(c2 - c2_exact) / c2_exact);
+        ee = fmax(ee, fabs(e  - eint(i)) / eint(i));
+        ex = fmax(ex, fabs(ez - e) / e);
+      }, Kokkos::Max<real_t>(err_p), Kokkos::Max<real_t>(err_c),
+         Kokkos::Max<real_t>(err_e), Kokkos::Max<real_t>(err_x));
+
+    printf("max relative error : p %g, c2 %g, eint(rho,p) %g (vs bisection %g)\n",
+           err_p, err_c, err_e, err_x);
+
+#if defined(USE_DOUBLE) || defined(USE_MIXED_PRECISION)
+    const real_t tolerance = 1e-10;
+#else
+    const real_t tolerance = 1e-3;
+#endif
+    if (err_p > tolerance or err_c > tolerance or err_e > tolerance or err_x > tolerance)
+    {
+      printf("FAILED : error above tolerance %g\n", tolerance);
+      status = EXIT_FAILURE;
+    }
+
+    /*
+     * throughput
+     */
+    const double rate_ideal = benchmark("ideal gas (p,c)", n, nrepeat,
+                                        KOKKOS_LAMBDA(const int& i, real_t& sum) {
+        const real_t p = (gamma0-1) * rho(i) * eint(i);
+        const real_t c = sqrt(gamma0 * p / rho(i));
+        sum += p + c;
+      });
+
+    const double rate_table = benchmark("table lookup (p,c)", n, nrepeat,
+                                        KOKKOS_LAMBDA(const int& i, real_t& sum) {
+        real_t p, c2;
+        table.lookup(rho(i), eint(i), p, c2);
+        sum += p + sqrt(c2);
+      });
+
+    const double rate_ideal_inv = benchmark("ideal gas eint(rho,p)", n, nrepeat,
+                                            KOKKOS_LAMBDA(const int& i, real_t& sum) {
+        sum += pres(i) / ((gamma0-1) * rho(i));
+      });
+
+    const double rate_table_inv = benchmark("table eint(rho,p)", n, nrepeat,
+                                            KOKKOS_LAMBDA(const int& i, real_t& sum) {
+        sum += table.eint_from_pressure(rho(i), pres(i));
+      });
+
+    const double rate_exact_inv = benchmark("bisection eint(rho,p)", n, nrepeat,
+                                            KOKKOS_LAMBDA(const int& i, real_t& sum) {
+        sum += table_bisection.eint_from_pressure(rho(i), pres(i));
+      });
+
+    printf("table / ideal gas throughput : lookup %5.2f, inversion %5.2f (bisection %5.2f)\n",
+           rate_table/rate_ideal, rate_table_inv/rate_ideal_inv,
+           rate_exact_inv/rate_ideal_inv);
+
+  }
+
+  Kokkos::finalize();
+
+  return status;
+
+} // main
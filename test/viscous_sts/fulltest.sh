@@ -0,0 +1,59 @@
+#!/bin/bash
+
+########################################################################################
+########################################################################################
+# (REQUIRED) Edit the following variables to reflect your local environment
+########################################################################################
+
+# Target run directory (must include the shear_layer_2D.ini.skel file)
+TARGETDIR=$(pwd)
+
+# Full path to ppkMHD executable
+BIN=$HOME/ppkMHD/build/src/ppkMHD
+
+export OMP_PROC_BIND=spread
+export OMP_PLACES=threads
+
+########################################################################################
+########################################################################################
+# (Optional) Edit the following variables to change viscosity and resolutions
+########################################################################################
+
+# dynamic viscosity
+MU=1e-2
+
+# linear resolutions
+RESOLUTIONS="64 128 256"
+
+########################################################################################
+########################################################################################
+
+cd $TARGETDIR
+
+printf "%6s %14s %14s %8s\n" "nx" "explicit (s)" "rkl2 (s)" "speedup"
+
+for NX in $RESOLUTIONS; do
+
+  for RKL2 in false true; do
+
+    mkdir -p $NX/$RKL2
+    cd $NX/$RKL2
+
+    cp $TARGETDIR/shear_layer_2D.ini.skel shear_layer_2D.ini
+
+    sed -i "s/NX/$NX/" shear_layer_2D.ini
+    sed -i "s/MU/$MU/" shear_layer_2D.ini
+    sed -i "s/RKL2/$RKL2/" shear_layer_2D.ini
+
+    $BIN shear_layer_2D.ini > run.out
+
+    cd $TARGETDIR
+
+  done
+
+  T_EXPLICIT=$(grep "total       time" $NX/false/run.out | awk '{print $4}')
+  T_RKL2=$(grep "total       time" $NX/true/run.out | awk '{print $4}')
+
+  printf "%6d %14s %14s %8.2f\n" $NX $T_EXPLICIT $T_RKL2 $(echo "$T_EXPLICIT / $T_RKL2" | bc -l)
+
+done